@@ -46,6 +46,8 @@ CopyContext::SharedPtr CopyContext::create(std::shared_ptr<Device> pDevice, Comm
 }
 
 void CopyContext::flush(bool wait) {
+    submitTexturePageUploads();
+
     if (mCommandsPending) {
         mpLowLevelData->flush();
         mCommandsPending = false;
@@ -54,6 +56,12 @@ void CopyContext::flush(bool wait) {
         mpLowLevelData->getFence()->gpuSignal(mpLowLevelData->getCommandQueue());
     }
 
+    // Texture page staging slots written so far can be reused once this submission is finished
+    if (mTexturePageStagingSubmitted != mTexturePageStagingHead) {
+        mTexturePageStagingInFlight.emplace_back(mTexturePageStagingHead, mpLowLevelData->getFence()->getCpuValue() - 1);
+        mTexturePageStagingSubmitted = mTexturePageStagingHead;
+    }
+
     bindDescriptorHeaps();
     
     if (wait) {
@@ -28,6 +28,7 @@
 #ifndef SRC_FALCOR_CORE_API_COPYCONTEXT_H_
 #define SRC_FALCOR_CORE_API_COPYCONTEXT_H_
 
+#include <deque>
 #include <memory>
 
 #include "Resource.h"
@@ -133,10 +134,15 @@ class dlldecl CopyContext {
     */
     void updateTextureData(const Texture* pTexture, const void* pData);
 
-    /** Update texture page data
+    /** Update texture page data. Page data is copied into a persistent staging ring and the actual copy is recorded on flush
+        or on submitTexturePageUploads() call, batched per texture.
     */
     void updateTexturePage(const VirtualTexturePage* pPage, const void* pData);
 
+    /** Record all queued texture page copies into the command list.
+    */
+    void submitTexturePageUploads();
+
     /** Fill sparse texture mip tail data
     */
     void fillMipTail(Texture* pTexture, const void* pData, bool tailDataInOnePage);
@@ -183,11 +189,33 @@ class dlldecl CopyContext {
     void apiSubresourceBarrier(const Texture* pTexture, Resource::State newState, Resource::State oldState, uint32_t arraySlice, uint32_t mipLevel);
     void updateTextureSubresources(const Texture* pTexture, uint32_t firstSubresource, uint32_t subresourceCount, const void* pData, const uint3& offset = uint3(0), const uint3& size = uint3(-1));
 
-    /** Update texture page data
+    /** Queue texture page update from the staging buffer data at the given offset
     */
-    void updateTexturePage(const VirtualTexturePage* pPage, Buffer::SharedPtr pStagingBuffer);
+    void updateTexturePage(const VirtualTexturePage* pPage, Buffer::SharedPtr pStagingBuffer, uint64_t stagingOffset = 0);
+
+    /** Allocate texture page sized slot in the staging ring. Blocks only if all slots are still used by the GPU.
+        \return Slot offset in the staging ring buffer.
+    */
+    uint64_t allocateTexturePageStagingSlot();
 
     bool mCommandsPending = false;
+
+#if defined(FALCOR_GFX)
+    struct PendingTexturePageCopies {
+        std::shared_ptr<const Texture>              pTexture;
+        Buffer::SharedPtr                           pStagingBuffer;
+        std::vector<gfx::TexturePageCopyRegion>     regions;
+    };
+
+    std::vector<PendingTexturePageCopies> mPendingTexturePageCopies;
+#endif
+
+    Buffer::SharedPtr mpTexturePageStagingBuffer;
+    uint8_t* mpTexturePageStagingData = nullptr;
+    uint64_t mTexturePageStagingHead = 0;                                   ///< Monotonic write position in the staging ring.
+    uint64_t mTexturePageStagingTail = 0;                                   ///< Monotonic position of the oldest slot that may still be read by the GPU.
+    uint64_t mTexturePageStagingSubmitted = 0;                              ///< Monotonic position up to which slots were submitted.
+    std::deque<std::pair<uint64_t, uint64_t>> mTexturePageStagingInFlight;  ///< Submitted ring positions and fence values guarding them.
     LowLevelContextData::SharedPtr mpLowLevelData;
 
  //private:
@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "stdafx.h"
 
+#include <cstring>
 #include <random>
 #include <chrono>
 
@@ -56,6 +57,10 @@ static inline std::string to_string(gfx::ITextureResource::Extents extent) {
 	return std::to_string(extent.width) + " " + std::to_string(extent.height) + " " + std::to_string(extent.depth);
 }
 
+// Sparse texture pages are 64KiB. Ring holds 1024 of them
+static constexpr uint64_t kTexturePageStagingSlotSize = 65536;
+static constexpr uint64_t kTexturePageStagingRingSize = kTexturePageStagingSlotSize * 1024;
+
 uint32_t getMipLevelPackedDataSize(const Texture* pTexture, uint32_t w, uint32_t h, uint32_t d, ResourceFormat format) {
 	uint32_t perW = getFormatWidthCompressionRatio(format);
 	uint32_t bw = align_to(perW, w) / perW;
@@ -437,41 +442,107 @@ void CopyContext::fillMipTail(Texture* pTexture, const void* pData, bool tailDat
 }
 
 void CopyContext::updateTexturePage(const VirtualTexturePage* pPage, const void* pData) {
-  assert(pPage);
-  
-  if(!pData) return;
+	assert(pPage);
 
-  if(!pPage->isResident()) {
-    LLOG_ERR << "Unable to update non-resident texture page !!!";
-    return;
-  }
+	if(!pData) return;
+
+	if(!pPage->isResident()) {
+		LLOG_ERR << "Unable to update non-resident texture page !!!";
+		return;
+	}
+
+	const Texture* pTexture = pPage->texture().get();
 
-  const Texture* pTexture = pPage->texture().get();
-  
-	uint8_t* dataPtr = (uint8_t*)pData;
-	auto resourceEncoder = getLowLevelData()->getApiData()->getResourceCommandEncoder();
-	gfx::ITextureResource::Offset3D gfxOffset = pPage->offsetGFX();
-	gfx::ITextureResource::Extents gfxSize = pPage->extentGFX();
 	gfx::FormatInfo formatInfo = {};
 	gfx::gfxGetFormatInfo(getGFXFormat(pTexture->getFormat()), &formatInfo);
 
-	gfx::SubresourceRange subresourceRange = {};
-	subresourceRange.baseArrayLayer = 0;
-	subresourceRange.mipLevel = pPage->mipLevel();
-	subresourceRange.layerCount = 1;
-	subresourceRange.mipLevelCount = 1;
+	const size_t rowSize = static_cast<size_t>(pPage->width()) / formatInfo.blockWidth * formatInfo.blockSizeInBytes;
+	const size_t pageDataSize = rowSize * (pPage->height() / formatInfo.blockHeight) * pPage->depth();
+	if(pageDataSize > kTexturePageStagingSlotSize) {
+		LLOG_ERR << "Texture page data size " << std::to_string(pageDataSize) << " exceeds staging slot size !!!";
+		return;
+	}
+
+	const uint64_t stagingOffset = allocateTexturePageStagingSlot();
+	std::memcpy(mpTexturePageStagingData + stagingOffset, pData, pageDataSize);
+	updateTexturePage(pPage, mpTexturePageStagingBuffer, stagingOffset);
+}
+
+void CopyContext::updateTexturePage(const VirtualTexturePage* pPage, Buffer::SharedPtr pStagingBuffer, uint64_t stagingOffset) {
+	assert(pPage);
+	assert(pStagingBuffer);
+
+	const auto& pTexture = pPage->texture();
+
+	// Pages usually come in per texture runs, so search from the back
+	auto it = std::find_if(mPendingTexturePageCopies.rbegin(), mPendingTexturePageCopies.rend(), [&](const PendingTexturePageCopies& copies) {
+		return copies.pTexture == pTexture && copies.pStagingBuffer == pStagingBuffer;
+	});
+
+	if(it == mPendingTexturePageCopies.rend()) {
+		mPendingTexturePageCopies.push_back({pTexture, pStagingBuffer, {}});
+		it = mPendingTexturePageCopies.rbegin();
+	}
+
+	gfx::TexturePageCopyRegion region = {};
+	region.bufferOffset = pStagingBuffer->getGpuAddressOffset() + stagingOffset;
+	region.offset = pPage->offsetGFX();
+	region.extent = pPage->extentGFX();
+	region.mipLevel = pPage->mipLevel();
+	it->regions.push_back(region);
+}
+
+void CopyContext::submitTexturePageUploads() {
+	if(mPendingTexturePageCopies.empty()) return;
+
+	for(const auto& copies: mPendingTexturePageCopies) {
+		const Texture* pTexture = copies.pTexture.get();
+
+		auto oldState = pTexture->getGlobalState();
+		const bool stateChanged = resourceBarrier(pTexture, Resource::State::CopyDest);
+
+		auto resourceEncoder = getLowLevelData()->getApiData()->getResourceCommandEncoder();
+		resourceEncoder->copyBufferToTexturePages(
+			static_cast<gfx::ITextureResource*>(pTexture->getApiHandle().get()),
+			static_cast<gfx::IBufferResource*>(copies.pStagingBuffer->getApiHandle().get()),
+			static_cast<gfx::GfxCount>(copies.regions.size()),
+			copies.regions.data());
 
-	gfx::ITextureResource::SubresourceData data = {};
-	data.data = (uint8_t*)pData;
-	data.strideY = (int64_t)(gfxSize.width) / formatInfo.blockWidth * formatInfo.blockSizeInBytes;
-	data.strideZ = data.strideY * (gfxSize.height / formatInfo.blockHeight);
+		if(stateChanged) resourceBarrier(pTexture, oldState);
+	}
 
-	resourceEncoder->uploadTexturePageData(static_cast<gfx::ITextureResource*>(pTexture->getApiHandle().get()), gfxOffset, gfxSize, pPage->mipLevel(), &data);
+	mPendingTexturePageCopies.clear();
 	mCommandsPending = true;
 }
 
-void CopyContext::updateTexturePage(const VirtualTexturePage* pPage, Buffer::SharedPtr pStagingBuffer) {
-	return;
+uint64_t CopyContext::allocateTexturePageStagingSlot() {
+	if(!mpTexturePageStagingBuffer) {
+		mpTexturePageStagingBuffer = Buffer::create(mpDevice, kTexturePageStagingRingSize, Resource::BindFlags::None, Buffer::CpuAccess::Write, nullptr);
+		mpTexturePageStagingData = reinterpret_cast<uint8_t*>(mpTexturePageStagingBuffer->map(Buffer::MapType::Write));
+	}
+
+	// Reclaim slots of finished submissions
+	auto pFence = mpLowLevelData->getFence();
+	const uint64_t completedValue = pFence->getGpuValue();
+	while(!mTexturePageStagingInFlight.empty() && mTexturePageStagingInFlight.front().second <= completedValue) {
+		mTexturePageStagingTail = mTexturePageStagingInFlight.front().first;
+		mTexturePageStagingInFlight.pop_front();
+	}
+
+	while((mTexturePageStagingHead + kTexturePageStagingSlotSize - mTexturePageStagingTail) > kTexturePageStagingRingSize) {
+		if(mTexturePageStagingInFlight.empty()) {
+			// Whole ring is filled with not yet submitted pages
+			flush(false);
+			continue;
+		}
+		pFence->syncCpu(mTexturePageStagingInFlight.front().second);
+		mTexturePageStagingTail = mTexturePageStagingInFlight.front().first;
+		mTexturePageStagingInFlight.pop_front();
+	}
+
+	const uint64_t offset = mTexturePageStagingHead % kTexturePageStagingRingSize;
+	mTexturePageStagingHead += kTexturePageStagingSlotSize;
+	return offset;
 }
 
 }  // namespace Falcor
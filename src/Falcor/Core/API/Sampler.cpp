@@ -108,6 +108,22 @@ bool Sampler::Desc::operator==(const Sampler::Desc& other) const {
     return true;
 }
 
+size_t Sampler::Desc::getHash() const {
+    // Floating point fields are left out, so descs equal by operator== (e.g. -0.0 and 0.0 lod) hash the same.
+    size_t hash = 0;
+    auto combine = [&hash](size_t value) { hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2); };
+    combine((size_t)mMagFilter);
+    combine((size_t)mMinFilter);
+    combine((size_t)mMipFilter);
+    combine((size_t)mMaxAnisotropy);
+    combine((size_t)mComparisonMode);
+    combine((size_t)mReductionMode);
+    combine((size_t)mModeU);
+    combine((size_t)mModeV);
+    combine((size_t)mModeW);
+    return hash;
+}
+
 #ifdef SCRIPTING
 SCRIPT_BINDING(Sampler) {
     pybind11::class_<Sampler, Sampler::SharedPtr>(m, "Sampler");
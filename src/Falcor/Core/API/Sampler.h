@@ -133,6 +133,10 @@ class dlldecl Sampler : public std::enable_shared_from_this<Sampler> {
         */
         bool operator!=(const Desc& other) const { return !(*this == other); }
 
+        /** Returns hash of the desc. Identical descs have the same hash.
+        */
+        size_t getHash() const;
+
      protected:
         Filter mMagFilter = Filter::Linear;
         Filter mMinFilter = Filter::Linear;
@@ -0,0 +1,146 @@
+/***************************************************************************
+ # Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "stdafx.h"
+
+#include <cstring>
+#include <fstream>
+
+#include "EnvMapImportanceCache.h"
+
+namespace Falcor {
+
+namespace {
+    const char kMagic[4] = { 'I', 'M', 'A', 'P' };
+    const uint32_t kVersion = 1;
+
+    struct CacheHeader {
+        char        magic[4];
+        uint32_t    version;
+        uint8_t     key[20];
+        uint32_t    dimension;
+        uint32_t    reserved;
+    };
+
+    static_assert(sizeof(EnvMapImportanceCache::Key) == sizeof(CacheHeader::key));
+}
+
+bool EnvMapImportanceCache::computeKey(const fs::path& envMapPath, const Params& params, Key& key) {
+    boost::system::error_code ec;
+    const uint64_t fileSize = fs::file_size(envMapPath, ec);
+    if (ec) return false;
+
+    std::ifstream file(envMapPath.string(), std::ios::binary);
+    if (!file) return false;
+
+    SHA1 sha;
+    sha.update(&kVersion, sizeof(kVersion));
+    sha.update(&params.dimension, sizeof(params.dimension));
+    sha.update(&params.samples, sizeof(params.samples));
+    sha.update(&params.sourceMip, sizeof(params.sourceMip));
+    sha.update(&fileSize, sizeof(fileSize));
+
+    std::vector<char> block(kSampleBlockSize);
+    auto hashRange = [&](uint64_t offset, uint64_t size) {
+        file.seekg(offset);
+        while (size > 0) {
+            const size_t count = (size_t)std::min<uint64_t>(size, block.size());
+            if (!file.read(block.data(), count)) return false;
+            sha.update(block.data(), count);
+            size -= count;
+        }
+        return true;
+    };
+
+    if (fileSize <= kFullHashSize) {
+        if (!hashRange(0, fileSize)) return false;
+    } else {
+        const int64_t writeTime = (int64_t)fs::last_write_time(envMapPath, ec);
+        if (ec) return false;
+        sha.update(&writeTime, sizeof(writeTime));
+
+        for (uint32_t b = 0; b < kSampleBlockCount; b++) {
+            const uint64_t offset = (fileSize - kSampleBlockSize) * b / (kSampleBlockCount - 1);
+            if (!hashRange(offset, kSampleBlockSize)) return false;
+        }
+    }
+
+    key = sha.final();
+    return true;
+}
+
+bool EnvMapImportanceCache::load(const fs::path& cachePath, const Key& key, uint32_t dimension, std::vector<float>& data) {
+    std::ifstream file(cachePath.string(), std::ios::binary);
+    if (!file) return false;
+
+    CacheHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) return false;
+    if (std::memcmp(header.key, key.data(), key.size()) != 0 || header.dimension != dimension) return false;
+
+    data.resize((size_t)dimension * dimension);
+    if (!file.read(reinterpret_cast<char*>(data.data()), data.size() * sizeof(float))) {
+        data.clear();
+        return false;
+    }
+    return true;
+}
+
+bool EnvMapImportanceCache::store(const fs::path& cachePath, const Key& key, uint32_t dimension, const std::vector<float>& data) {
+    if (data.size() != (size_t)dimension * dimension) return false;
+
+    CacheHeader header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    std::memcpy(header.key, key.data(), key.size());
+    header.dimension = dimension;
+
+    boost::system::error_code ec;
+    const fs::path tempPath = fs::unique_path(cachePath.string() + ".%%%%%%", ec);
+    if (ec) return false;
+
+    {
+        std::ofstream file(tempPath.string(), std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+        if (!file) {
+            file.close();
+            fs::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    fs::rename(tempPath, cachePath, ec);
+    if (ec) {
+        fs::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace Falcor
@@ -0,0 +1,94 @@
+/***************************************************************************
+ # Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#ifndef SRC_FALCOR_EXPERIMENTAL_SCENE_LIGHTS_ENVMAPIMPORTANCECACHE_H_
+#define SRC_FALCOR_EXPERIMENTAL_SCENE_LIGHTS_ENVMAPIMPORTANCECACHE_H_
+
+#include <vector>
+
+#include "Falcor/Core/Framework.h"
+#include "Falcor/Utils/CryptoUtils.h"
+#include "Falcor/Utils/StringUtils.h"
+
+namespace Falcor {
+
+/** Persistent cache of environment map importance maps.
+    Importance map base mips are stored in a sidecar file next to the environment map (<file>.imap), keyed by the
+    environment map content and the importance map build parameters. Renders reusing the same environment map skip
+    the importance map build and don't need the full resolution map to be resident.
+*/
+class dlldecl EnvMapImportanceCache {
+  public:
+    using Key = SHA1::MD;
+
+    /** Build parameters of the cached importance map.
+    */
+    struct Params {
+        uint32_t dimension = 0;     ///< Importance map base mip resolution.
+        uint32_t samples = 0;       ///< Samples per importance map texel.
+        uint32_t sourceMip = 0;     ///< Environment map mip level sampled by the build.
+    };
+
+    /** Compute cache key of an importance map built from the given environment map file.
+        Files up to kFullHashSize are hashed entirely. Larger files are keyed by their size, modification time and
+        kSampleBlockCount evenly spaced content blocks (first and last included), so keying a multi gigabyte map doesn't
+        read it all.
+        \param[in] envMapPath Environment map file.
+        \param[in] params Importance map build parameters.
+        \param[out] key Cache key.
+        \return True if the file could be read.
+    */
+    static bool computeKey(const fs::path& envMapPath, const Params& params, Key& key);
+
+    /** Get sidecar cache file path of an environment map.
+    */
+    static fs::path getCachePath(const fs::path& envMapPath) { return appendExtension(envMapPath, kCacheExtension); }
+
+    /** Load importance map base mip from a cache file.
+        \param[in] cachePath Cache file.
+        \param[in] key Expected cache key.
+        \param[in] dimension Expected base mip resolution.
+        \param[out] data dimension x dimension importance values.
+        \return True if the cache file exists and matches the key.
+    */
+    static bool load(const fs::path& cachePath, const Key& key, uint32_t dimension, std::vector<float>& data);
+
+    /** Store importance map base mip into a cache file. The file is replaced atomically so concurrent renders
+        never read partially written caches.
+        \return True on success.
+    */
+    static bool store(const fs::path& cachePath, const Key& key, uint32_t dimension, const std::vector<float>& data);
+
+    static constexpr char kCacheExtension[] = ".imap";
+    static constexpr size_t kFullHashSize = 16 * 1024 * 1024;
+    static constexpr size_t kSampleBlockSize = 64 * 1024;
+    static constexpr uint32_t kSampleBlockCount = 64;
+};
+
+}  // namespace Falcor
+
+#endif  // SRC_FALCOR_EXPERIMENTAL_SCENE_LIGHTS_ENVMAPIMPORTANCECACHE_H_
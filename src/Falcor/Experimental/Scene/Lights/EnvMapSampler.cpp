@@ -27,10 +27,13 @@
  **************************************************************************/
 #include "stdafx.h"
 
+#include <cstring>
+
 #include "glm/gtc/integer.hpp"
 
 #include "Falcor/Core/API/RenderContext.h"
 #include "EnvMapSampler.h"
+#include "EnvMapImportanceCache.h"
 
 namespace Falcor {
 
@@ -124,6 +127,26 @@ bool EnvMapSampler::createImportanceMap(RenderContext* pRenderContext, uint32_t
     mpImportanceMap = Texture::create2D(mpDevice, dimension, dimension, ResourceFormat::R32Float, 1, mips, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::RenderTarget | Resource::BindFlags::UnorderedAccess);
     assert(mpImportanceMap);
 
+    // Sparse maps are sampled at the most detailed resident mip level.
+    EnvMapImportanceCache::Params cacheParams;
+    cacheParams.dimension = dimension;
+    cacheParams.samples = samples;
+    cacheParams.sourceMip = mpEnvMap->getMostDetailedMip();
+
+    // Reuse the base mip built by a previous render of the same environment map.
+    const std::string& envMapFilename = mpEnvMap->getFilename();
+    EnvMapImportanceCache::Key cacheKey;
+    const bool cacheable = !envMapFilename.empty() && EnvMapImportanceCache::computeKey(envMapFilename, cacheParams, cacheKey);
+    const fs::path cachePath = cacheable ? EnvMapImportanceCache::getCachePath(envMapFilename) : fs::path();
+
+    std::vector<float> importanceData;
+    if (cacheable && EnvMapImportanceCache::load(cachePath, cacheKey, dimension, importanceData)) {
+        LLOG_DBG << "Using cached importance map " << cachePath.string();
+        pRenderContext->updateSubresourceData(mpImportanceMap.get(), mpImportanceMap->getSubresourceIndex(0, 0), importanceData.data());
+        mpImportanceMap->generateMips(pRenderContext);
+        return true;
+    }
+
     mpSetupPass["gEnvMap"] =  mpEnvMap->getEnvMap();
     mpSetupPass["gImportanceMap"] = mpImportanceMap;
 
@@ -135,6 +158,7 @@ bool EnvMapSampler::createImportanceMap(RenderContext* pRenderContext, uint32_t
     mpSetupPass["CB"]["outputDimInSamples"] = uint2(dimension * samplesX, dimension * samplesY);
     mpSetupPass["CB"]["numSamples"] = uint2(samplesX, samplesY);
     mpSetupPass["CB"]["invSamples"] = 1.f / (samplesX * samplesY);
+    mpSetupPass["CB"]["sourceMip"] = (float)cacheParams.sourceMip;
 
     // Execute setup pass to compute the square importance map (base mip).
     mpSetupPass->execute(pRenderContext, dimension, dimension);
@@ -142,6 +166,17 @@ bool EnvMapSampler::createImportanceMap(RenderContext* pRenderContext, uint32_t
     // Populate mip hierarchy. We rely on the default mip generation for this.
     mpImportanceMap->generateMips(pRenderContext);
 
+    if (cacheable) {
+        const std::vector<uint8_t> baseMip = pRenderContext->readTextureSubresource(mpImportanceMap.get(), mpImportanceMap->getSubresourceIndex(0, 0));
+        importanceData.resize((size_t)dimension * dimension);
+        if (baseMip.size() == importanceData.size() * sizeof(float)) {
+            std::memcpy(importanceData.data(), baseMip.data(), baseMip.size());
+            if (!EnvMapImportanceCache::store(cachePath, cacheKey, dimension, importanceData)) {
+                LLOG_WRN << "Unable to write importance map cache " << cachePath.string();
+            }
+        }
+    }
+
     //mpImportanceMap->captureToFile(0, 0, "/home/max/Desktop/imp_test.png", Bitmap::FileFormat::PngFile, Bitmap::ExportFlags::None);
     return true;
     }
@@ -28,6 +28,13 @@
 #include "stdafx.h"
 #include "LightBVHBuilder.h"
 #include <algorithm>
+#include <future>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LIGHT_BVH_USE_SSE 1
+#endif
 
 #include "Falcor/Utils/Timing/Profiler.h"
 
@@ -43,6 +50,9 @@ const uint32_t kMaxBVHDepth = 64;
 const uint32_t kMaxLeafTriangleCount = 1 << PackedNode::kTriangleCountBits;
 const uint32_t kMaxLeafTriangleOffset = 1 << PackedNode::kTriangleOffsetBits;
 
+// Number of bits per axis used by Morton codes.
+const uint32_t kMortonBitsPerAxis = 10;
+
 inline float safeACos(float v)
 {
 	return std::acos(glm::clamp(v, -1.0f, 1.0f));
@@ -211,6 +221,26 @@ float aabbVolume(const AABB& bb, float epsilon) {
 	return dims.x * dims.y * dims.z;
 }
 
+/** Spreads the lower 10 bits of v so that there are two zero bits between each of them.
+*/
+inline uint32_t expandMortonBits(uint32_t v)
+{
+	v = (v * 0x00010001u) & 0xFF0000FFu;
+	v = (v * 0x00000101u) & 0x0F00F00Fu;
+	v = (v * 0x00000011u) & 0xC30C30C3u;
+	v = (v * 0x00000005u) & 0x49249249u;
+	return v;
+}
+
+/** Returns 30-bit Morton code for a point normalized to the unit cube.
+*/
+inline uint32_t computeMortonCode(const float3& p)
+{
+	const float scale = (float)(1u << kMortonBitsPerAxis);
+	const float3 q = glm::clamp(p * scale, float3(0.f), float3(scale - 1.f));
+	return (expandMortonBits((uint32_t)q.x) << 2) | (expandMortonBits((uint32_t)q.y) << 1) | expandMortonBits((uint32_t)q.z);
+}
+
 }
 
 namespace Falcor {
@@ -231,13 +261,34 @@ void LightBVHBuilder::build(LightBVH& bvh) {
 	// Get global list of emissive triangles.
 	assert(bvh.mpLightCollection);
 	const auto& triangles = bvh.mpLightCollection->getMeshLightTriangles();
-	if (triangles.empty()) return;
+
+	std::vector<uint32_t> triangleIndices;
+	std::vector<uint64_t> triangleBitmasks;
+	if (!buildCPU(triangles, bvh.mNodes, triangleIndices, triangleBitmasks)) return;
+
+	// The BVH is ready, mark it as valid and upload the data.
+	bvh.mIsValid = true;
+	bvh.mMaxTriangleCountPerLeaf = mOptions.maxTriangleCountPerLeaf;
+	bvh.uploadCPUBuffers(triangleIndices, triangleBitmasks);
+
+	// Computate metadata.
+	bvh.finalize();
+}
+
+bool LightBVHBuilder::buildCPU(const std::vector<LightCollection::MeshLightTriangle>& triangles, std::vector<PackedNode>& nodes, std::vector<uint32_t>& triangleIndices, std::vector<uint64_t>& triangleBitmasks) {
+	nodes.clear();
+	triangleIndices.clear();
+	triangleBitmasks.clear();
+
+	if (triangles.empty()) return false;
 
 	// Create list of triangles that should be included in BVH.
 	// For each triangle, precompute data we need for the build.
-	BuildingData data(bvh.mNodes);
+	std::vector<TriangleSortData> trianglesData;
+	BuildingData data(nodes, trianglesData, triangleIndices, triangleBitmasks);
 	data.trianglesData.reserve(triangles.size());
 
+	AABB centerBounds;
 	for (size_t i = 0; i < triangles.size(); i++) {
 		if (!mOptions.usePreintegration || triangles[i].flux > 0.f) {
 			LightBVHBuilder::TriangleSortData tri;
@@ -250,12 +301,13 @@ void LightBVHBuilder::build(LightBVH& bvh) {
 			tri.flux = triangles[i].flux;
 			tri.triangleIndex = static_cast<uint32_t>(i);
 
+			centerBounds |= tri.bounds.center();
 			data.trianglesData.push_back(tri);
 		}
 	}
 
 	// If there are no non-culled triangles, we're done.
-	if (data.trianglesData.empty()) return;
+	if (data.trianglesData.empty()) return false;
 
 	// Validate options.
 	if (mOptions.maxTriangleCountPerLeaf > kMaxLeafTriangleCount) {
@@ -265,17 +317,31 @@ void LightBVHBuilder::build(LightBVH& bvh) {
 		throw std::runtime_error(("Emissive triangle count exceeds the maximum supported (" + std::to_string(kMaxLeafTriangleOffset + kMaxLeafTriangleCount) + ")").c_str());
 	}
 
+	// Pre-sort triangles along the Morton curve. Top levels of the tree are then split at Morton code boundaries
+	// without any sorting, and each resulting subrange remains sorted for its own children.
+	if (mOptions.useMortonTopLevel && data.trianglesData.size() > mOptions.mortonTopLevelThreshold) {
+		const float3 extent = centerBounds.extent();
+		const float3 invExtent = float3(extent.x > 0.f ? 1.f / extent.x : 0.f, extent.y > 0.f ? 1.f / extent.y : 0.f, extent.z > 0.f ? 1.f / extent.z : 0.f);
+		for (auto& tri : data.trianglesData) {
+			tri.mortonCode = computeMortonCode((tri.bounds.center() - centerBounds.minPoint) * invExtent);
+		}
+		std::stable_sort(data.trianglesData.begin(), data.trianglesData.end(), [](const TriangleSortData& a, const TriangleSortData& b) { return a.mortonCode < b.mortonCode; });
+	}
+
 	// Allocate temporary memory for the BVH build.
 	// To be grossly conservative, assume each triangle requires two nodes.
 	// This is only system RAM and shouldn't be that much, so it's not worth being more careful about it.
 	// TODO: Better estimate of how many nodes we will need.
-	data.nodes.clear();
 	data.nodes.reserve(2 * data.trianglesData.size());
 	data.triangleIndices.reserve(data.trianglesData.size());
 
 	const uint64_t invalidBitmask = std::numeric_limits<uint64_t>::max();
 	data.triangleBitmasks.resize(triangles.size(), invalidBitmask); // This is sized based on input triangle count, as it's indexed by global triangle index.
 
+	// Each parallel level doubles the number of threads, so stop spawning once all hardware threads are busy.
+	mMaxParallelBuildDepth = 0;
+	while ((1u << mMaxParallelBuildDepth) < std::max(1u, std::thread::hardware_concurrency())) mMaxParallelBuildDepth++;
+
 	// Build the tree.
 	SplitHeuristicFunction splitFunc = getSplitFunction(mOptions.splitHeuristicSelection);
 	buildInternal(mOptions, splitFunc, 0ull, 0, Range(0, static_cast<uint32_t>(data.trianglesData.size())), data);
@@ -290,13 +356,7 @@ void LightBVHBuilder::build(LightBVH& bvh) {
 	float cosConeAngle;
 	computeLightingConesInternal(0, data, cosConeAngle);
 
-	// The BVH is ready, mark it as valid and upload the data.
-	bvh.mIsValid = true;
-	bvh.mMaxTriangleCountPerLeaf = mOptions.maxTriangleCountPerLeaf;
-	bvh.uploadCPUBuffers(data.triangleIndices, data.triangleBitmasks);
-
-	// Computate metadata.
-	bvh.finalize();
+	return true;
 }
 
 LightBVHBuilder::LightBVHBuilder(const Options& options) : mOptions(options)
@@ -316,18 +376,25 @@ uint32_t LightBVHBuilder::buildInternal(const Options& options, const SplitHeuri
 	}
 	assert(nodeBounds.valid());
 
-	data.currentNodeFlux = nodeFlux;
-
 	bool trySplitting = triangleRange.length() > (options.createLeavesASAP ? options.maxTriangleCountPerLeaf : 1);
-	const SplitResult splitResult = trySplitting ? splitHeuristic(data, triangleRange, nodeBounds, options) : SplitResult();
+
+	SplitResult splitResult;
+	if (trySplitting && options.useMortonTopLevel && triangleRange.length() > options.mortonTopLevelThreshold) {
+		splitResult = computeSplitWithMorton(data, triangleRange);
+	}
+	if (trySplitting && !splitResult.isValid()) {
+		splitResult = splitHeuristic(data, triangleRange, nodeBounds, options);
+	}
 
 	// If we should split, then create an internal node and split.
 	if (splitResult.isValid()) {
 		assert(triangleRange.begin < splitResult.triangleIndex && splitResult.triangleIndex < triangleRange.end);
 
 		// Sort the centroids and update the lists accordingly.
-		auto comp = [dim = splitResult.axis](const TriangleSortData& d1, const TriangleSortData& d2) { return d1.bounds.center()[dim] < d2.bounds.center()[dim]; };
-		std::nth_element(std::begin(data.trianglesData) + triangleRange.begin, std::begin(data.trianglesData) + splitResult.triangleIndex, std::begin(data.trianglesData) + triangleRange.end, comp);
+		if (!splitResult.isPresorted) {
+			auto comp = [dim = splitResult.axis](const TriangleSortData& d1, const TriangleSortData& d2) { return d1.bounds.center()[dim] < d2.bounds.center()[dim]; };
+			std::nth_element(std::begin(data.trianglesData) + triangleRange.begin, std::begin(data.trianglesData) + splitResult.triangleIndex, std::begin(data.trianglesData) + triangleRange.end, comp);
+		}
 
 		// Allocate internal node.
 		assert(data.nodes.size() < std::numeric_limits<uint32_t>::max());
@@ -345,8 +412,29 @@ uint32_t LightBVHBuilder::buildInternal(const Options& options, const SplitHeuri
 			throw std::runtime_error(("BVH depth of " + std::to_string(depth + 1) + " reached; maximum of " + std::to_string(kMaxBVHDepth) + " allowed.").c_str());
 		}
 
-		uint32_t leftIndex = buildInternal(options, splitHeuristic, bitmask | (0ull << depth), depth + 1, Range(triangleRange.begin, splitResult.triangleIndex), data);
-		uint32_t rightIndex = buildInternal(options, splitHeuristic, bitmask | (1ull << depth), depth + 1, Range(splitResult.triangleIndex, triangleRange.end), data);
+		const Range leftRange(triangleRange.begin, splitResult.triangleIndex);
+		const Range rightRange(splitResult.triangleIndex, triangleRange.end);
+
+		uint32_t leftIndex, rightIndex;
+		if (options.useParallelBuild && depth < mMaxParallelBuildDepth && triangleRange.length() >= options.parallelBuildThreshold) {
+			// Build the right subtree into its own arrays on another thread while this thread builds the left one.
+			// The right subtree is then appended after the left one, so the node layout matches the serial build.
+			std::vector<PackedNode> rightNodes;
+			std::vector<uint32_t> rightTriangleIndices;
+			rightNodes.reserve(2 * rightRange.length());
+			rightTriangleIndices.reserve(rightRange.length());
+			BuildingData rightData(rightNodes, data.trianglesData, rightTriangleIndices, data.triangleBitmasks);
+
+			auto rightTask = std::async(std::launch::async, [&]() {
+				buildInternal(options, splitHeuristic, bitmask | (1ull << depth), depth + 1, rightRange, rightData);
+			});
+			leftIndex = buildInternal(options, splitHeuristic, bitmask | (0ull << depth), depth + 1, leftRange, data);
+			rightTask.get();
+			rightIndex = appendSubtree(rightData, data);
+		} else {
+			leftIndex = buildInternal(options, splitHeuristic, bitmask | (0ull << depth), depth + 1, leftRange, data);
+			rightIndex = buildInternal(options, splitHeuristic, bitmask | (1ull << depth), depth + 1, rightRange, data);
+		}
 
 		assert(leftIndex == nodeIndex + 1); // The left node should always be placed immediately after the current node.
 		node.rightChildIdx = rightIndex;
@@ -387,6 +475,27 @@ uint32_t LightBVHBuilder::buildInternal(const Options& options, const SplitHeuri
 	}
 }
 
+uint32_t LightBVHBuilder::appendSubtree(const BuildingData& subtree, BuildingData& data) {
+	assert(!subtree.nodes.empty());
+	const uint32_t nodeOffset = (uint32_t)data.nodes.size();
+	const uint32_t triangleOffset = (uint32_t)data.triangleIndices.size();
+
+	// Node references are stored in the lower bits of the first dword for both node types (right child index
+	// for internal nodes, triangle offset for leaves). Patch them in place, as repacking the node is lossy.
+	for (PackedNode node : subtree.nodes) {
+		if (node.isLeaf()) {
+			assert(node.getLeafNode().triangleOffset + triangleOffset < kMaxLeafTriangleOffset);
+			node.data[0].x += triangleOffset;
+		} else {
+			node.data[0].x += nodeOffset;
+		}
+		data.nodes.push_back(node);
+	}
+	data.triangleIndices.insert(data.triangleIndices.end(), subtree.triangleIndices.begin(), subtree.triangleIndices.end());
+
+	return nodeOffset;
+}
+
 float3 LightBVHBuilder::computeLightingConesInternal(const uint32_t nodeIndex, BuildingData& data, float& cosConeAngle) {
 	if (!data.nodes[nodeIndex].isLeaf()) {
 		auto node = data.nodes[nodeIndex].getInternalNode();
@@ -484,8 +593,15 @@ LightBVHBuilder::SplitResult LightBVHBuilder::computeSplitWithBinnedSAH(const Bu
 	};
 
 	assert(parameters.binCount > 1);
-	std::vector<Bin> bins(parameters.binCount);
-	std::vector<float> costs(parameters.binCount - 1);
+
+	// Scratch storage is kept per thread and reused across splits, so that only growing it ever hits the heap.
+	// The references are needed as thread_local variables can't be captured by the lambda below.
+	static thread_local std::vector<Bin> tlBins;
+	static thread_local std::vector<float> tlCosts;
+	std::vector<Bin>& bins = tlBins;
+	std::vector<float>& costs = tlCosts;
+	bins.resize(parameters.binCount);
+	costs.resize(parameters.binCount - 1);
 
 	/** Helper function that computes the best split along the given dimension using the SAH metric.
 		The triangles are binned to n bins, storing only the aggregate parameters (triangle count and bounds).
@@ -631,8 +747,33 @@ LightBVHBuilder::SplitResult LightBVHBuilder::computeSplitWithBinnedSAOH(const B
 	};
 
 	assert(parameters.binCount > 1);
-	std::vector<Bin> bins(parameters.binCount);
-	std::vector<float> costs(parameters.binCount - 1);
+
+	// Per thread scratch storage, see computeSplitWithBinnedSAH().
+	static thread_local std::vector<Bin> tlBins;
+	static thread_local std::vector<float> tlCosts;
+	static thread_local std::vector<uint3> tlBinIds;
+	std::vector<Bin>& bins = tlBins;
+	std::vector<float>& costs = tlCosts;
+	std::vector<uint3>& binIds = tlBinIds;
+	bins.resize(parameters.binCount);
+	costs.resize(parameters.binCount - 1);
+
+	// Compute the bin ids along all three dimensions in a single pass over the triangles.
+	// The ids are reused by both binning passes below instead of being recomputed per triangle, pass and dimension.
+	float3 binScale;
+	for (uint32_t dimension = 0; dimension < 3; ++dimension) {
+		float w = dimensions[dimension];
+		assert(w >= 0.f); // The node bounds can be zero if all primitives are axis-aligned and coplanar
+		binScale[dimension] = w > FLT_MIN ? (float)parameters.binCount / w : 0.f;
+	}
+
+	const uint3 maxBinId = uint3(parameters.binCount - 1);
+	binIds.resize(triangleRange.length());
+	for (uint32_t i = triangleRange.begin; i < triangleRange.end; ++i) {
+		const float3 p = data.trianglesData[i].bounds.center();
+		assert(glm::all(glm::lessThanEqual(nodeBounds.minPoint, p)) && glm::all(glm::lessThanEqual(p, nodeBounds.maxPoint)));
+		binIds[i - triangleRange.begin] = glm::min(uint3((p - nodeBounds.minPoint) * binScale), maxBinId);
+	}
 
 	/** Helper function that computes the best split along the given dimension using the SAOH metric.
 		The triangles are binned to n bins, storing only the aggregate parameters (triangle count, bounds, flux, and cone direction).
@@ -641,26 +782,52 @@ LightBVHBuilder::SplitResult LightBVHBuilder::computeSplitWithBinnedSAOH(const B
 		the bounding cones are approximates based on the bins' bounding cones. This is less expensive,
 		but also less precise than computing them directly from the triangles.
 	*/
-	const auto binAlongDimension = [&bins, &costs, &triangleRange, &data, &parameters, &overallBestSplit, &nodeBounds, largestDimension, dimensions](uint32_t dimension) {
-		// Helper to compute the bin id for a given triangle.
-		auto getBinId = [&](const TriangleSortData& td) {
-			float bmin = nodeBounds.minPoint[dimension], bmax = nodeBounds.maxPoint[dimension];
-			float w = bmax - bmin;
-			assert(w >= 0.f); // The node bounds can be zero if all primitives are axis-aligned and coplanar
-			float scale = w > FLT_MIN ? (float)parameters.binCount / w : 0.f;
-			float p = td.bounds.center()[dimension];
-			assert(bmin <= p && p <= bmax);
-			return std::min((uint32_t)((p - bmin) * scale), parameters.binCount - 1);
-		};
-
+	const auto binAlongDimension = [&bins, &costs, &binIds, &triangleRange, &data, &parameters, &overallBestSplit, largestDimension, dimensions](uint32_t dimension) {
 		// Reset the bins.
 		for (Bin& bin : bins) bin = Bin();
 
 		// Fill the bins with all triangles.
+#ifdef LIGHT_BVH_USE_SSE
+		// Bounds and cone direction are accumulated four lanes at a time. The 4th lane picks up whatever follows the float3
+		// in TriangleSortData (maxPoint.x, center.x and cosConeAngle) and is simply ignored. The lane operations are the same
+		// as glm::min/max and float addition, so the bins come out bit-identical to the scalar path.
+		static_assert(offsetof(TriangleSortData, bounds) + offsetof(AABB, maxPoint) + 4 * sizeof(float) <= sizeof(TriangleSortData), "Unexpected TriangleSortData layout");
+		static_assert(offsetof(TriangleSortData, coneDirection) + 4 * sizeof(float) <= sizeof(TriangleSortData), "Unexpected TriangleSortData layout");
+
+		struct BinAccumulator {
+			__m128 minPoint;
+			__m128 maxPoint;
+			__m128 coneDirection;
+		};
+		static thread_local std::vector<BinAccumulator> tlAccumulators;
+		std::vector<BinAccumulator>& accumulators = tlAccumulators;
+		accumulators.assign(bins.size(), { _mm_set1_ps(std::numeric_limits<float>::infinity()), _mm_set1_ps(-std::numeric_limits<float>::infinity()), _mm_setzero_ps() });
+
 		for (uint32_t i = triangleRange.begin; i < triangleRange.end; ++i) {
 			const auto& td = data.trianglesData[i];
-			bins[getBinId(td)] |= td;
+			const uint32_t binId = binIds[i - triangleRange.begin][dimension];
+			BinAccumulator& acc = accumulators[binId];
+			acc.minPoint = _mm_min_ps(_mm_loadu_ps(&td.bounds.minPoint.x), acc.minPoint);
+			acc.maxPoint = _mm_max_ps(_mm_loadu_ps(&td.bounds.maxPoint.x), acc.maxPoint);
+			acc.coneDirection = _mm_add_ps(acc.coneDirection, _mm_loadu_ps(&td.coneDirection.x));
+			bins[binId].triangleCount++;
+			bins[binId].flux += td.flux;
+		}
+
+		for (size_t i = 0; i < bins.size(); ++i) {
+			alignas(16) float minPoint[4], maxPoint[4], coneDirection[4];
+			_mm_store_ps(minPoint, accumulators[i].minPoint);
+			_mm_store_ps(maxPoint, accumulators[i].maxPoint);
+			_mm_store_ps(coneDirection, accumulators[i].coneDirection);
+			bins[i].bounds = AABB(float3(minPoint[0], minPoint[1], minPoint[2]), float3(maxPoint[0], maxPoint[1], maxPoint[2]));
+			bins[i].coneDirection = float3(coneDirection[0], coneDirection[1], coneDirection[2]);
+		}
+#else
+		for (uint32_t i = triangleRange.begin; i < triangleRange.end; ++i) {
+			const auto& td = data.trianglesData[i];
+			bins[binIds[i - triangleRange.begin][dimension]] |= td;
 		}
+#endif
 
 		// Compute the lighting cones for each bin.
 		// The cone direction is the average direction over all lights in the bin and the cone angle is grown to include all.
@@ -673,7 +840,7 @@ LightBVHBuilder::SplitResult LightBVHBuilder::computeSplitWithBinnedSAOH(const B
 
 		for (uint32_t i = triangleRange.begin; i < triangleRange.end; ++i) {
 			const auto& td = data.trianglesData[i];
-			Bin& bin = bins[getBinId(td)];
+			Bin& bin = bins[binIds[i - triangleRange.begin][dimension]];
 			bin.cosConeAngle = computeCosConeAngle(bin.coneDirection, bin.cosConeAngle, td.coneDirection, td.cosConeAngle);
 		}
 
@@ -759,13 +926,35 @@ LightBVHBuilder::SplitResult LightBVHBuilder::computeSplitWithBinnedSAOH(const B
 		// Evaluate the cost metric for the node. This requires us to first compute the cone angle.
 		float cosTheta = kInvalidCosConeAngle;
 		computeLightingCone(triangleRange, data, cosTheta);
-		float leafCost = evalSAOH(nodeBounds, data.currentNodeFlux, cosTheta, parameters);
+		float nodeFlux = 0.f;
+		for (uint32_t i = triangleRange.begin; i < triangleRange.end; ++i) nodeFlux += data.trianglesData[i].flux;
+		float leafCost = evalSAOH(nodeBounds, nodeFlux, cosTheta, parameters);
 		if (leafCost <= overallBestSplit.first) return SplitResult();
 	}
 
 	return overallBestSplit.second;
 }
 
+LightBVHBuilder::SplitResult LightBVHBuilder::computeSplitWithMorton(const BuildingData& data, const Range& triangleRange) {
+	const uint32_t firstCode = data.trianglesData[triangleRange.begin].mortonCode;
+	const uint32_t lastCode = data.trianglesData[triangleRange.end - 1].mortonCode;
+	if (firstCode == lastCode) return SplitResult();
+
+	// Find the highest differing bit and the first triangle that has it set.
+	// The range is sorted by Morton code, so both halves stay sorted.
+	const uint32_t splitBit = 1u << glm::findMSB(firstCode ^ lastCode);
+	auto first = std::begin(data.trianglesData) + triangleRange.begin;
+	auto last = std::begin(data.trianglesData) + triangleRange.end;
+	auto split = std::partition_point(first, last, [splitBit](const TriangleSortData& td) { return (td.mortonCode & splitBit) == 0; });
+
+	SplitResult result;
+	result.axis = 0;
+	result.triangleIndex = (uint32_t)(split - std::begin(data.trianglesData));
+	result.isPresorted = true;
+	assert(triangleRange.begin < result.triangleIndex && result.triangleIndex < triangleRange.end);
+	return result;
+}
+
 LightBVHBuilder::SplitHeuristicFunction LightBVHBuilder::getSplitFunction(SplitHeuristic heuristic) {
 	switch (heuristic) {
 		case SplitHeuristic::Equal:
@@ -801,6 +990,10 @@ SCRIPT_BINDING(LightBVHBuilder) {
 	options.field(allowRefitting);
 	options.field(usePreintegration);
 	options.field(useLightingCones);
+	options.field(useParallelBuild);
+	options.field(parallelBuildThreshold);
+	options.field(useMortonTopLevel);
+	options.field(mortonTopLevelThreshold);
 #undef field
 }
 #endif
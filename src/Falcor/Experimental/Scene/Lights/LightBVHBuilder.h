@@ -72,6 +72,10 @@ public:
         bool           allowRefitting = true;                                ///< Rather than always rebuilding the BVH from scratch, keep the hierarchy but update the bounds and lighting cones.
         bool           usePreintegration = true;                             ///< Use pre-integration for culling out emissive triangles and use their flux when computing the splits. Only valid when using the BinnedSAOH split heuristic.
         bool           useLightingCones = true;                              ///< Use lighting cones when computing the splits. Only valid when using the BinnedSAOH split heuristic.
+        bool           useParallelBuild = true;                              ///< Build subtrees of large nodes on separate threads. The resulting BVH is identical to the serial build.
+        uint32_t       parallelBuildThreshold = 16384;                       ///< Minimum number of triangles in a node for its subtrees to be built in parallel. Only used when 'useParallelBuild' is enabled.
+        bool           useMortonTopLevel = false;                            ///< Pre-sort triangles along a Morton curve and split the top levels of the tree at Morton code boundaries (LBVH) instead of evaluating the split heuristic.
+        uint32_t       mortonTopLevelThreshold = 4096;                       ///< Nodes with more triangles than this are split using Morton codes. Only used when 'useMortonTopLevel' is enabled.
     };
 
     /** Creates a new object.
@@ -84,6 +88,16 @@ public:
     */
     void build(LightBVH& bvh);
 
+    /** Build the BVH nodes on the CPU only, without touching the GPU resources of a LightBVH.
+        This is what build() uses internally. It is exposed for testing and benchmarking the builder.
+        \param[in] triangles Global list of emissive triangles.
+        \param[out] nodes BVH nodes, including the lighting cones.
+        \param[out] triangleIndices Triangle indices sorted by leaf node.
+        \param[out] triangleBitmasks Per triangle bit pattern retracing the tree traversal to reach the triangle. Indexed by global triangle index.
+        \return False if there are no (non-culled) triangles to build the BVH from.
+    */
+    bool buildCPU(const std::vector<LightCollection::MeshLightTriangle>& triangles, std::vector<PackedNode>& nodes, std::vector<uint32_t>& triangleIndices, std::vector<uint64_t>& triangleBitmasks);
+
     const Options& getOptions() const { return mOptions; }
 
 protected:
@@ -101,6 +115,7 @@ protected:
     {
         uint32_t axis = std::numeric_limits<uint32_t>::max();
         uint32_t triangleIndex = std::numeric_limits<uint32_t>::max();
+        bool isPresorted = false;                       ///< True if the triangle range is already partitioned at triangleIndex (Morton split), so no sorting is needed.
 
         bool isValid() const
         {
@@ -117,17 +132,21 @@ protected:
         float cosConeAngle = 1.f;                       ///< Cosine normal bounding cone (half) angle.
         float flux = 0.f;                               ///< Precomputed triangle flux (note, this takes doublesidedness into account).
         uint32_t triangleIndex = MeshLightData::kInvalidIndex; ///< Index into global triangle list.
+        uint32_t mortonCode = 0;                        ///< Morton code of the bounds center. Only computed when 'useMortonTopLevel' is enabled.
     };
 
+    /** Data used by a (sub)tree build. Subtrees built in parallel have their own node and triangle index arrays,
+        but share the triangle data and bitmasks as they only ever touch their own triangle range.
+    */
     struct BuildingData
     {
         std::vector<PackedNode>& nodes;                 ///< BVH nodes generated by the builder.
-        std::vector<TriangleSortData> trianglesData;    ///< Compact list of triangles to include in build.
-        std::vector<uint32_t> triangleIndices;          ///< Triangle indices sorted by leaf node. Each leaf node refers to a contiguous array of triangle indices.
-        std::vector<uint64_t> triangleBitmasks;         ///< Array containing the per triangle bit pattern retracing the tree traversal to reach the triangle: 0=left child, 1=right child; this array gets filled in during the build process. Indexed by global triangle index.
-        float currentNodeFlux = 0.f;                    ///< Used by computeSAOHSplit() as the leaf creation cost.
+        std::vector<TriangleSortData>& trianglesData;   ///< Compact list of triangles to include in build.
+        std::vector<uint32_t>& triangleIndices;         ///< Triangle indices sorted by leaf node. Each leaf node refers to a contiguous array of triangle indices.
+        std::vector<uint64_t>& triangleBitmasks;        ///< Array containing the per triangle bit pattern retracing the tree traversal to reach the triangle: 0=left child, 1=right child; this array gets filled in during the build process. Indexed by global triangle index.
 
-        BuildingData(std::vector<PackedNode>& bvhNodes) : nodes(bvhNodes) {}
+        BuildingData(std::vector<PackedNode>& bvhNodes, std::vector<TriangleSortData>& triangles, std::vector<uint32_t>& indices, std::vector<uint64_t>& bitmasks)
+            : nodes(bvhNodes), trianglesData(triangles), triangleIndices(indices), triangleBitmasks(bitmasks) {}
     };
 
     /** Compute the split according to a specified heuristic.
@@ -150,6 +169,13 @@ protected:
     */
     uint32_t buildInternal(const Options& options, const SplitHeuristicFunction& splitHeuristic, uint64_t bitmask, uint32_t depth, const Range& triangleRange, BuildingData& data);
 
+    /** Append nodes and triangle indices of a separately built subtree, patching its node and triangle offsets.
+        \param[in] subtree Subtree data.
+        \param[in,out] data Data the subtree is appended to.
+        \return Index of the subtree root node in data.nodes.
+    */
+    static uint32_t appendSubtree(const BuildingData& subtree, BuildingData& data);
+
     /** Recursive computation of lighting cones for all internal nodes.
         \param[in] nodeIndex Index of the current node.
         \param[in,out] data Updated node data.
@@ -171,10 +197,16 @@ protected:
     static SplitResult computeSplitWithBinnedSAH(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, const Options& parameters);
     static SplitResult computeSplitWithBinnedSAOH(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, const Options& parameters);
 
+    /** Split a range of Morton sorted triangles at the highest bit where the Morton codes of the range differ.
+        \return Presorted split, or invalid split if all triangles in the range share the same Morton code.
+    */
+    static SplitResult computeSplitWithMorton(const BuildingData& data, const Range& triangleRange);
+
     static SplitHeuristicFunction getSplitFunction(SplitHeuristic heuristic);
 
     // Configuration
     Options mOptions;
+    uint32_t mMaxParallelBuildDepth = 0;                ///< Tree depth up to which subtrees are built in parallel. Limits the number of threads spawned.
 };
 
 }  // namespace Falcor
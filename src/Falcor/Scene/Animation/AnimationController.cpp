@@ -30,6 +30,8 @@
 #include "Falcor/Core/API/RenderContext.h"
 
 #include "Falcor/Utils/Timing/Profiler.h"
+#include "Falcor/Utils/Math/MatrixSIMD.h"
+#include "Falcor/Utils/TaskScheduler.h"
 #include "Falcor/Scene/SceneBuilder.h"
 #include <fstream>
 
@@ -43,6 +45,9 @@ namespace
     const std::string kInverseTransposeWorldMatrices = "inverseTransposeWorldMatrices";
     const std::string kPrevWorldMatrices = "prevWorldMatrices";
     const std::string kPrevInverseTransposeWorldMatrices = "prevInverseTransposeWorldMatrices";
+
+    // Scene graph levels with fewer nodes are updated on the calling thread.
+    const uint32_t kMinParallelLevelSize = 1024;
 }
 
 AnimationController::AnimationController(Scene* pScene, const StaticVertexVector& staticVertexData, const SkinningVertexVector& skinningVertexData, uint32_t prevVertexCount, const std::vector<Animation::SharedPtr>& animations)
@@ -57,6 +62,8 @@ AnimationController::AnimationController(Scene* pScene, const StaticVertexVector
     mpDevice = pScene->device();
     assert(mpDevice);
 
+    buildWorldMatrixSchedule();
+
     // Create GPU resources.
     assert(mLocalMatrices.size() * 4 <= std::numeric_limits<uint32_t>::max());
     uint32_t float4Count = (uint32_t)mLocalMatrices.size() * 4;
@@ -236,6 +243,8 @@ bool AnimationController::animate(RenderContext* pContext, double currentTime)
         }
         updateWorldMatrices(true);
         uploadWorldMatrices(true);
+        // All matrices were reinitialized, report them as changed so dependent instance data is refreshed too.
+        std::fill(mMatricesChanged.begin(), mMatricesChanged.end(), true);
 
         if (!sceneGraph.empty())
         {
@@ -307,11 +316,53 @@ void AnimationController::updateLocalMatrices(double time)
     }
 }
 
+void AnimationController::buildWorldMatrixSchedule()
+{
+    const auto& sceneGraph = mpScene->mSceneGraph;
+    const size_t nodeCount = sceneGraph.size();
+    assert(nodeCount <= std::numeric_limits<uint32_t>::max());
+
+    // Compute the depth of every node. Parents are resolved first so that deep chains need no recursion.
+    const uint32_t kUnknownDepth = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> depths(nodeCount, kUnknownDepth);
+    std::vector<uint32_t> chain;
+    uint32_t maxDepth = 0;
+    for (uint32_t i = 0; i < (uint32_t)nodeCount; i++)
+    {
+        uint32_t nodeID = i;
+        while (depths[nodeID] == kUnknownDepth && sceneGraph[nodeID].parent != SceneBuilder::kInvalidNode)
+        {
+            chain.push_back(nodeID);
+            nodeID = sceneGraph[nodeID].parent;
+            assert(nodeID < nodeCount);
+        }
+        if (depths[nodeID] == kUnknownDepth) depths[nodeID] = 0;
+
+        uint32_t depth = depths[nodeID];
+        while (!chain.empty())
+        {
+            depths[chain.back()] = ++depth;
+            chain.pop_back();
+        }
+        maxDepth = std::max(maxDepth, depths[i]);
+    }
+
+    // Counting sort of nodes by depth, nodes within a level stay in ascending order.
+    mLevelOffsets.assign(nodeCount > 0 ? maxDepth + 2 : 1, 0);
+    for (uint32_t depth : depths) mLevelOffsets[depth + 1]++;
+    for (size_t level = 1; level < mLevelOffsets.size(); level++) mLevelOffsets[level] += mLevelOffsets[level - 1];
+
+    mLevelNodes.resize(nodeCount);
+    std::vector<uint32_t> cursor(mLevelOffsets.begin(), mLevelOffsets.end() - 1);
+    for (uint32_t i = 0; i < (uint32_t)nodeCount; i++) mLevelNodes[cursor[depths[i]]++] = i;
+}
+
 void AnimationController::updateWorldMatrices(bool updateAll)
 {
     const auto& sceneGraph = mpScene->mSceneGraph;
+    assert(mLevelNodes.size() == mGlobalMatrices.size());
 
-    for (size_t i = 0; i < mGlobalMatrices.size(); i++)
+    auto updateNode = [&](uint32_t i)
     {
         // Propagate matrix change flag to children.
         if (sceneGraph[i].parent != SceneBuilder::kInvalidNode)
@@ -319,22 +370,42 @@ void AnimationController::updateWorldMatrices(bool updateAll)
             mMatricesChanged[i] = mMatricesChanged[i] || mMatricesChanged[sceneGraph[i].parent];
         }
 
-        if (!mMatricesChanged[i] && !updateAll) continue;
+        if (!mMatricesChanged[i] && !updateAll) return;
 
         mGlobalMatrices[i] = mLocalMatrices[i];
 
-        if (mpScene->mSceneGraph[i].parent != SceneBuilder::kInvalidNode)
+        if (sceneGraph[i].parent != SceneBuilder::kInvalidNode)
         {
             mGlobalMatrices[i] = mGlobalMatrices[sceneGraph[i].parent] * mGlobalMatrices[i];
         }
 
-        mInvTransposeGlobalMatrices[i] = transpose(inverse(mGlobalMatrices[i]));
+        mInvTransposeGlobalMatrices[i] = inverseTransposeSIMD(mGlobalMatrices[i]);
 
         if (mpSkinningPass)
         {
             mSkinningMatrices[i] = mGlobalMatrices[i] * sceneGraph[i].localToBindSpace;
-            mInvTransposeSkinningMatrices[i] = transpose(inverse(mSkinningMatrices[i]));
+            mInvTransposeSkinningMatrices[i] = inverseTransposeSIMD(mSkinningMatrices[i]);
         }
+    };
+
+    // Nodes only depend on their parent, which lives in the previous level. Every node is written by exactly
+    // one task, so the result does not depend on how levels are split between threads.
+    TaskScheduler& scheduler = TaskScheduler::instance();
+    for (size_t level = 0; level + 1 < mLevelOffsets.size(); level++)
+    {
+        const uint32_t levelStart = mLevelOffsets[level];
+        const uint32_t levelEnd = mLevelOffsets[level + 1];
+
+        if (levelEnd - levelStart < kMinParallelLevelSize)
+        {
+            for (uint32_t n = levelStart; n < levelEnd; n++) updateNode(mLevelNodes[n]);
+            continue;
+        }
+
+        scheduler.parallelFor(levelStart, levelEnd, [&](const uint32_t start, const uint32_t end)
+        {
+            for (uint32_t n = start; n < end; n++) updateNode(mLevelNodes[n]);
+        });
     }
 }
 
@@ -358,8 +429,8 @@ void AnimationController::uploadWorldMatrices(bool uploadAll)
         {
             // Detect ranges of consecutive matrices that have all changed or not.
             size_t offset = i;
-            bool changed = mMatricesChanged[i];
-            while (i < mGlobalMatrices.size() && mMatricesChanged[i] == changed) ++i;
+            bool changed = mMatricesChanged[i] != 0;
+            while (i < mGlobalMatrices.size() && (mMatricesChanged[i] != 0) == changed) ++i;
 
             // Upload range of changed matrices.
             if (changed)
@@ -116,7 +116,7 @@ public:
 
     /** Check if a matrix changed since last frame.
     */
-    bool isMatrixChanged(size_t matrixID) const { return mMatricesChanged[matrixID]; }
+    bool isMatrixChanged(size_t matrixID) const { return mMatricesChanged[matrixID] != 0; }
 
     /** Get the local matrices.
         These represent the current local transform for each scene graph node.
@@ -148,6 +148,7 @@ private:
 
     void initLocalMatrices();
     void updateLocalMatrices(double time);
+    void buildWorldMatrixSchedule();
     void updateWorldMatrices(bool updateAll = false);
     void uploadWorldMatrices(bool uploadAll = false);
 
@@ -162,7 +163,9 @@ private:
     std::vector<float4x4> mLocalMatrices;
     std::vector<float4x4> mGlobalMatrices;
     std::vector<float4x4> mInvTransposeGlobalMatrices;
-    std::vector<bool> mMatricesChanged;         ///< Flag per matrix, true if matrix changed since last frame.
+    std::vector<uint8_t> mMatricesChanged;      ///< Flag per matrix, true if matrix changed since last frame. Bytes (not std::vector<bool>) so levels can be updated in parallel.
+    std::vector<uint32_t> mLevelNodes;          ///< Scene graph node IDs sorted by depth in the scene graph.
+    std::vector<uint32_t> mLevelOffsets;        ///< Offset of each depth level into mLevelNodes, level count + 1 entries.
 
     bool mFirstUpdate = true;       ///< True if this is the first update.
     bool mEnabled = true;           ///< True if animations are enabled.
@@ -0,0 +1,80 @@
+/***************************************************************************
+ # Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "GeometryInstanceTracker.h"
+
+namespace Falcor {
+
+namespace {
+
+// Up to this many unchanged instances (48 bytes each) are re-uploaded to save a separate copy.
+const uint32_t kMaxInstanceUploadGap = 32;
+
+}
+
+void GeometryInstanceTracker::init(const std::vector<GeometryInstanceData>& instances, size_t matrixCount) {
+    assert(instances.size() <= std::numeric_limits<uint32_t>::max());
+    mInstanceCount = (uint32_t)instances.size();
+
+    // Counting sort of instance IDs by matrix ID keeps instances of each matrix in ascending order.
+    mMatrixInstanceOffsets.assign(matrixCount + 1, 0);
+    for (const auto& instance : instances) {
+        assert(instance.globalMatrixID < matrixCount);
+        mMatrixInstanceOffsets[instance.globalMatrixID + 1]++;
+    }
+    for (size_t i = 0; i < matrixCount; i++) mMatrixInstanceOffsets[i + 1] += mMatrixInstanceOffsets[i];
+
+    mMatrixInstances.resize(instances.size());
+    std::vector<uint32_t> cursor(mMatrixInstanceOffsets.begin(), mMatrixInstanceOffsets.end() - 1);
+    for (uint32_t i = 0; i < mInstanceCount; i++) mMatrixInstances[cursor[instances[i].globalMatrixID]++] = i;
+
+    mDirtyInstances.clear();
+    mDirtyInstances.setMaxGap(kMaxInstanceUploadGap);
+}
+
+bool GeometryInstanceTracker::updateTransformFlags(GeometryInstanceData& instance, const glm::mat4& transform, bool isObjectFrontFaceCW) {
+    if (instance.getType() != GeometryType::TriangleMesh && instance.getType() != GeometryType::DisplacedTriangleMesh) return false;
+
+    const uint32_t prevFlags = instance.flags;
+
+    // Checks if the transform flips the coordinate system handedness (its determinant is negative).
+    const bool isTransformFlipped = glm::determinant((glm::mat3)transform) < 0.f;
+    const bool isWorldFrontFaceCW = isObjectFrontFaceCW ^ isTransformFlipped;
+
+    if (isTransformFlipped) instance.flags |= (uint32_t)GeometryInstanceFlags::TransformFlipped;
+    else instance.flags &= ~(uint32_t)GeometryInstanceFlags::TransformFlipped;
+
+    if (isObjectFrontFaceCW) instance.flags |= (uint32_t)GeometryInstanceFlags::IsObjectFrontFaceCW;
+    else instance.flags &= ~(uint32_t)GeometryInstanceFlags::IsObjectFrontFaceCW;
+
+    if (isWorldFrontFaceCW) instance.flags |= (uint32_t)GeometryInstanceFlags::IsWorldFrontFaceCW;
+    else instance.flags &= ~(uint32_t)GeometryInstanceFlags::IsWorldFrontFaceCW;
+
+    return instance.flags != prevFlags;
+}
+
+}  // namespace Falcor
@@ -0,0 +1,93 @@
+/***************************************************************************
+ # Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#ifndef SRC_FALCOR_SCENE_GEOMETRYINSTANCETRACKER_H_
+#define SRC_FALCOR_SCENE_GEOMETRYINSTANCETRACKER_H_
+
+#include <vector>
+
+#include "Falcor/Core/Framework.h"
+#include "Falcor/Utils/Algorithm/DirtyRangeTracker.h"
+#include "SceneTypes.slang"
+
+namespace Falcor {
+
+/** CPU-side bookkeeping for incremental geometry instance updates.
+
+    Keeps a reverse mapping from global matrix ID to the geometry instances using it, so that only
+    instances referencing changed matrices are revisited, and records which instances actually changed
+    so that only those ranges of the instance buffer are uploaded.
+*/
+class dlldecl GeometryInstanceTracker {
+  public:
+    /** Build the matrix to instance mapping.
+        \param[in] instances Geometry instances.
+        \param[in] matrixCount Number of global matrices (scene graph nodes).
+    */
+    void init(const std::vector<GeometryInstanceData>& instances, size_t matrixCount);
+
+    size_t getMatrixCount() const { return mMatrixInstanceOffsets.empty() ? 0 : mMatrixInstanceOffsets.size() - 1; }
+
+    /** Get the number of instances using a global matrix.
+    */
+    uint32_t getInstanceCount(uint32_t matrixID) const { return mMatrixInstanceOffsets[matrixID + 1] - mMatrixInstanceOffsets[matrixID]; }
+
+    /** Get the instances using a global matrix, in ascending order.
+    */
+    const uint32_t* getInstances(uint32_t matrixID) const { return mMatrixInstances.data() + mMatrixInstanceOffsets[matrixID]; }
+
+    /** Refresh the transform dependent flags of a mesh instance.
+        \param[in,out] instance Geometry instance. Non triangle mesh instances are left untouched.
+        \param[in] transform Global transform of the instance.
+        \param[in] isObjectFrontFaceCW True if the mesh front face is clockwise in object space.
+        \return True if the instance flags changed.
+    */
+    static bool updateTransformFlags(GeometryInstanceData& instance, const glm::mat4& transform, bool isObjectFrontFaceCW);
+
+    /** Mark an instance as modified on the CPU.
+    */
+    void markInstanceDirty(uint32_t instanceID) { mDirtyInstances.markDirty(instanceID); }
+
+    void markAllInstancesDirty() { mDirtyInstances.markDirty(0, mInstanceCount); }
+
+    /** Get the coalesced instance ranges that need uploading. Call clearDirtyInstances() once uploaded.
+    */
+    DirtyRangeTracker& getDirtyInstances() { return mDirtyInstances; }
+
+    void clearDirtyInstances() { mDirtyInstances.clear(); }
+
+  private:
+    std::vector<uint32_t> mMatrixInstanceOffsets;   ///< Per matrix offset into mMatrixInstances, matrixCount + 1 entries.
+    std::vector<uint32_t> mMatrixInstances;         ///< Instance IDs grouped by global matrix.
+    uint32_t mInstanceCount = 0;
+
+    DirtyRangeTracker mDirtyInstances;
+};
+
+}  // namespace Falcor
+
+#endif  // SRC_FALCOR_SCENE_GEOMETRYINSTANCETRACKER_H_
@@ -0,0 +1,434 @@
+/***************************************************************************
+ # Copyright (c) 2015-21, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "stdafx.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+#include "Falcor/Utils/Image/Bitmap.h"
+#include "Falcor/Utils/Math/MathConstants.slangh"
+#include "Falcor/Utils/Color/ColorHelpers.slang"
+#include "Falcor/Scene/Scene.h"
+
+#include "EmissiveIntegratorCPU.h"
+
+namespace Falcor {
+
+namespace {
+    // Larger emissive textures are left to the GPU integrator. The CPU copy of the mip chain takes 16 bytes per texel.
+    const uint64_t kMaxTexelCount = 4096ull * 4096ull;
+
+    int64_t resolveAddress(int64_t i, uint32_t size, Sampler::AddressMode mode) {
+        const int64_t n = size;
+        switch (mode) {
+            case Sampler::AddressMode::Wrap:
+                return ((i % n) + n) % n;
+            case Sampler::AddressMode::Mirror: {
+                const int64_t j = ((i % (2 * n)) + 2 * n) % (2 * n);
+                return j < n ? j : 2 * n - 1 - j;
+            }
+            case Sampler::AddressMode::MirrorOnce:
+                return std::min(i < 0 ? -i - 1 : i, n - 1);
+            default:
+                // Clamp. Border color is approximated by the edge texels.
+                return std::clamp(i, int64_t(0), n - 1);
+        }
+    }
+
+    /** Clip a convex polygon against the half plane sign * (p[axis] - value) >= 0.
+    */
+    uint32_t clipPolygon(const float2* src, uint32_t count, float2* dst, int axis, float value, float sign) {
+        uint32_t dstCount = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            const float2& a = src[i];
+            const float2& b = src[(i + 1) % count];
+            const float da = sign * (a[axis] - value);
+            const float db = sign * (b[axis] - value);
+            if (da >= 0.f) dst[dstCount++] = a;
+            if ((da >= 0.f) != (db >= 0.f)) dst[dstCount++] = a + (b - a) * (da / (da - db));
+        }
+        return dstCount;
+    }
+
+    /** Decode texels of an uncompressed bitmap to linear RGB. Missing channels read as zero, like texture sampling does.
+    */
+    bool decodeTexels(const Bitmap& bitmap, bool srgb, std::vector<float3>& texels) {
+        enum class ChannelType { Unorm8, Float16, Float32 };
+
+        uint32_t channelCount = 0;
+        ChannelType type = ChannelType::Unorm8;
+        bool bgr = false;
+        switch (bitmap.getFormat()) {
+            case ResourceFormat::RGBA32Float:   channelCount = 4; type = ChannelType::Float32; break;
+            case ResourceFormat::RGB32Float:    channelCount = 3; type = ChannelType::Float32; break;
+            case ResourceFormat::R32Float:      channelCount = 1; type = ChannelType::Float32; break;
+            case ResourceFormat::RGBA16Float:   channelCount = 4; type = ChannelType::Float16; break;
+            case ResourceFormat::RGB16Float:    channelCount = 3; type = ChannelType::Float16; break;
+            case ResourceFormat::R16Float:      channelCount = 1; type = ChannelType::Float16; break;
+            case ResourceFormat::RGBA8Unorm:    channelCount = 4; break;
+            case ResourceFormat::BGRA8Unorm:
+            case ResourceFormat::BGRX8Unorm:    channelCount = 4; bgr = true; break;
+            case ResourceFormat::RG8Unorm:      channelCount = 2; break;
+            case ResourceFormat::R8Unorm:       channelCount = 1; break;
+            default:
+                return false;
+        }
+
+        const size_t channelSize = type == ChannelType::Unorm8 ? 1 : (type == ChannelType::Float16 ? 2 : 4);
+        const size_t texelCount = size_t(bitmap.getWidth()) * bitmap.getHeight();
+        if (bitmap.getDataSize() < texelCount * channelCount * channelSize) return false;
+
+        texels.resize(texelCount);
+        const uint8_t* pData = bitmap.getData();
+        for (size_t i = 0; i < texelCount; i++) {
+            float3 texel(0.f);
+            for (uint32_t c = 0; c < std::min(channelCount, 3u); c++) {
+                const uint8_t* pChannel = pData + (i * channelCount + c) * channelSize;
+                switch (type) {
+                    case ChannelType::Unorm8:
+                        texel[c] = float(*pChannel) / 255.f;
+                        break;
+                    case ChannelType::Float16:
+                        texel[c] = f16tof32(uint32_t(*reinterpret_cast<const uint16_t*>(pChannel)));
+                        break;
+                    case ChannelType::Float32:
+                        texel[c] = *reinterpret_cast<const float*>(pChannel);
+                        break;
+                }
+            }
+            if (bgr) std::swap(texel.x, texel.z);
+            texels[i] = srgb ? sRGBToLinear(texel) : texel;
+        }
+        return true;
+    }
+}  // namespace
+
+EmissiveIntegratorCPU::TexelData::SharedConstPtr EmissiveIntegratorCPU::TexelData::create(uint32_t width, uint32_t height, std::vector<float3>&& texels, Sampler::AddressMode addressModeU, Sampler::AddressMode addressModeV) {
+    assert(texels.size() == size_t(width) * height);
+
+    auto pData = std::make_shared<TexelData>();
+    pData->addressModeU = addressModeU;
+    pData->addressModeV = addressModeV;
+    pData->mips.push_back({ width, height, std::move(texels) });
+
+    // Box filter the chain down to 1x1. Odd trailing rows and columns are clamped into the last 2x2 footprint.
+    while (pData->mips.back().width > 1 || pData->mips.back().height > 1) {
+        const Mip& src = pData->mips.back();
+        Mip dst;
+        dst.width = std::max(1u, src.width / 2);
+        dst.height = std::max(1u, src.height / 2);
+        dst.texels.resize(size_t(dst.width) * dst.height);
+        for (uint32_t y = 0; y < dst.height; y++) {
+            const uint32_t y0 = std::min(2 * y, src.height - 1);
+            const uint32_t y1 = std::min(2 * y + 1, src.height - 1);
+            for (uint32_t x = 0; x < dst.width; x++) {
+                const uint32_t x0 = std::min(2 * x, src.width - 1);
+                const uint32_t x1 = std::min(2 * x + 1, src.width - 1);
+                dst.texels[size_t(y) * dst.width + x] = 0.25f * (src.texels[size_t(y0) * src.width + x0] + src.texels[size_t(y0) * src.width + x1] +
+                                                                 src.texels[size_t(y1) * src.width + x0] + src.texels[size_t(y1) * src.width + x1]);
+            }
+        }
+        pData->mips.push_back(std::move(dst));
+    }
+
+    return pData;
+}
+
+EmissiveIntegratorCPU::TexelData::SharedConstPtr EmissiveIntegratorCPU::TexelData::createFromTexture(const Texture::SharedPtr& pTexture, const Sampler::SharedPtr& pSampler) {
+    if (!pTexture || pTexture->isUDIMTexture()) return nullptr;
+    if (uint64_t(pTexture->getWidth()) * pTexture->getHeight() > kMaxTexelCount) return nullptr;
+
+    // Sparse textures are loaded from LTX files converted from the image next to them (see TextureManager).
+    fs::path path = pTexture->getSourceFilename();
+    if (path.empty()) return nullptr;
+    if (pTexture->isSparse()) {
+        if (path.extension() != ".ltx") return nullptr;
+        path.replace_extension();
+        if (!fs::exists(path)) return nullptr;
+    }
+
+    // Textures are created from top-down bitmaps (see Texture::createFromFile() and LTX_Bitmap::convertToLtxFile()).
+    auto pBitmap = Bitmap::createFromFile(pTexture->device(), path, true);
+    if (!pBitmap || pBitmap->getWidth() != pTexture->getWidth() || pBitmap->getHeight() != pTexture->getHeight()) return nullptr;
+
+    std::vector<float3> texels;
+    if (!decodeTexels(*pBitmap, isSrgbFormat(pTexture->getFormat()), texels)) return nullptr;
+
+    const auto addressModeU = pSampler ? pSampler->getAddressModeU() : Sampler::AddressMode::Wrap;
+    const auto addressModeV = pSampler ? pSampler->getAddressModeV() : Sampler::AddressMode::Wrap;
+    return create(pBitmap->getWidth(), pBitmap->getHeight(), std::move(texels), addressModeU, addressModeV);
+}
+
+float3 EmissiveIntegratorCPU::TexelData::fetch(uint32_t mipLevel, int64_t x, int64_t y) const {
+    const Mip& mip = mips[mipLevel];
+    x = resolveAddress(x, mip.width, addressModeU);
+    y = resolveAddress(y, mip.height, addressModeV);
+    return mip.texels[size_t(y) * mip.width + size_t(x)];
+}
+
+float EmissiveIntegratorCPU::computeClippedTriangleArea(const float2 p[3], const float2& minPos, const float2& maxPos) {
+    // Sutherland-Hodgman clipping against the four box edges. Each edge adds at most one vertex.
+    float2 polygon[2][7];
+    uint32_t count = 3;
+    std::copy(p, p + 3, polygon[0]);
+    count = clipPolygon(polygon[0], count, polygon[1], 0, minPos.x, 1.f);
+    count = clipPolygon(polygon[1], count, polygon[0], 0, maxPos.x, -1.f);
+    count = clipPolygon(polygon[0], count, polygon[1], 1, minPos.y, 1.f);
+    count = clipPolygon(polygon[1], count, polygon[0], 1, maxPos.y, -1.f);
+    if (count < 3) return 0.f;
+
+    float area = 0.f;
+    for (uint32_t i = 0; i < count; i++) {
+        const float2& a = polygon[0][i];
+        const float2& b = polygon[0][(i + 1) % count];
+        area += a.x * b.y - b.x * a.y;
+    }
+    return std::abs(0.5f * area);
+}
+
+float3 EmissiveIntegratorCPU::integrateTriangle(const TexelData& texels, const float2 texCoords[3]) {
+    assert(!texels.mips.empty());
+    const TexelData::Mip& base = texels.mips[0];
+
+    const float2 uvMin = glm::min(glm::min(texCoords[0], texCoords[1]), texCoords[2]);
+    const float2 uvMax = glm::max(glm::max(texCoords[0], texCoords[1]), texCoords[2]);
+    const float2 uvOffset = glm::floor(uvMin);
+
+    // Pick the most detailed mip level keeping the covered texel count within budget.
+    uint32_t mipLevel = 0;
+    float2 extent = (uvMax - uvMin) * float2(base.width, base.height);
+    while (mipLevel + 1 < texels.mips.size() && (extent.x + 1.f) * (extent.y + 1.f) > float(kMaxTexelsPerTriangle)) {
+        mipLevel++;
+        extent *= 0.5f;
+    }
+
+    // Rasterize the triangle in texel space of the mip, offset so that texel positions are positive (same as EmissiveIntegrator.3d.slang).
+    const TexelData::Mip& mip = texels.mips[mipLevel];
+    const float2 dim(mip.width, mip.height);
+    const float2 p[3] = { (texCoords[0] - uvOffset) * dim, (texCoords[1] - uvOffset) * dim, (texCoords[2] - uvOffset) * dim };
+    const int64_t offsetX = int64_t(uvOffset.x) * mip.width;
+    const int64_t offsetY = int64_t(uvOffset.y) * mip.height;
+
+    const float2 pMin = glm::min(glm::min(p[0], p[1]), p[2]);
+    const float2 pMax = glm::max(glm::max(p[0], p[1]), p[2]);
+    const int64_t x0 = int64_t(std::floor(pMin.x)), x1 = std::max(x0 + 1, int64_t(std::ceil(pMax.x)));
+    const int64_t y0 = int64_t(std::floor(pMin.y)), y1 = std::max(y0 + 1, int64_t(std::ceil(pMax.y)));
+
+    float3 texelSum(0.f);
+    float weight = 0.f;
+    for (int64_t y = y0; y < y1; y++) {
+        for (int64_t x = x0; x < x1; x++) {
+            const float2 texelMin = float2(float(x), float(y));
+            const float area = std::min(computeClippedTriangleArea(p, texelMin, texelMin + float2(1.f)), 1.f);
+            if (area <= 0.f) continue;
+            texelSum += texels.fetch(mipLevel, x + offsetX, y + offsetY) * area;
+            weight += area;
+        }
+    }
+    if (weight > 0.f) return texelSum / weight;
+
+    // The triangle is degenerate in texture space. Approximate its emission by the texels at the vertices.
+    float3 average(0.f);
+    for (uint32_t i = 0; i < 3; i++) {
+        average += texels.fetch(0, int64_t(std::floor(texCoords[i].x * base.width)), int64_t(std::floor(texCoords[i].y * base.height)));
+    }
+    return average / 3.f;
+}
+
+EmissiveIntegratorCPU::SharedPtr EmissiveIntegratorCPU::create(const Scene& scene, std::vector<uint32_t>&& indexData, std::vector<PackedStaticVertexData>&& staticData) {
+    // Everything the integration needs is copied here, the scene keeps changing while the task runs.
+    struct MeshLight {
+        GeometryInstanceData    instance;
+        MeshDesc                mesh;
+        float3                  emissive;
+        float                   emissiveFactor;
+        int32_t                 textureIndex;       ///< Index into textures, or -1 if not textured.
+    };
+
+    struct SharedData {
+        std::vector<uint32_t>               indexData;
+        std::vector<PackedStaticVertexData> staticData;
+        std::vector<MeshLight>              meshLights;
+        std::vector<uint32_t>               triangleOffsets;
+        std::vector<Texture::SharedPtr>     textures;
+        Sampler::SharedPtr                  pSampler;
+    };
+
+    auto pShared = std::make_shared<SharedData>();
+    auto pResult = std::make_shared<Result>();
+
+    // Collect mesh lights the same way as LightCollection::setupMeshLights().
+    const auto& globalMatrices = scene.getAnimationController()->getGlobalMatrices();
+    std::unordered_map<const Texture*, int32_t> textureIndices;
+    uint32_t triangleCount = 0;
+    for (uint32_t instanceID = 0; instanceID < scene.getGeometryInstanceCount(); instanceID++) {
+        const GeometryInstanceData& instance = scene.getGeometryInstance(instanceID);
+        if (instance.getType() != GeometryType::TriangleMesh) continue;
+
+        auto pMaterial = scene.getMaterial(instance.materialID)->toBasicMaterial();
+        if (!pMaterial || !pMaterial->isEmissive()) continue;
+
+        const MeshDesc& mesh = scene.getMesh(instance.geometryID);
+
+        // Vertices of dynamic meshes only exist on the GPU.
+        if (instance.isDynamic() || mesh.isDynamic()) return nullptr;
+
+        const size_t indexWords = mesh.indexCount == 0 ? 0 : (mesh.use16BitIndices() ? (size_t(mesh.indexCount) + 1) / 2 : mesh.indexCount);
+        if (size_t(instance.ibOffset) + indexWords > indexData.size() || size_t(instance.vbOffset) + mesh.vertexCount > staticData.size()) return nullptr;
+
+        MeshLight meshLight;
+        meshLight.instance = instance;
+        meshLight.mesh = mesh;
+        meshLight.emissive = float3(pMaterial->getData().emissive);
+        meshLight.emissiveFactor = float(pMaterial->getData().emissiveFactor);
+        meshLight.textureIndex = -1;
+
+        if (const auto& pTexture = pMaterial->getEmissiveTexture()) {
+            auto it = textureIndices.emplace(pTexture.get(), (int32_t)pShared->textures.size()).first;
+            if (it->second == (int32_t)pShared->textures.size()) pShared->textures.push_back(pTexture);
+            meshLight.textureIndex = it->second;
+            if (!pShared->pSampler) pShared->pSampler = pMaterial->getDefaultTextureSampler();
+        }
+
+        pShared->meshLights.push_back(meshLight);
+        pShared->triangleOffsets.push_back(triangleCount);
+        pResult->instanceIDs.push_back(instanceID);
+        pResult->transforms.push_back(globalMatrices[instance.globalMatrixID]);
+        triangleCount += mesh.getTriangleCount();
+    }
+
+    if (triangleCount == 0) return nullptr;
+
+    pShared->indexData = std::move(indexData);
+    pShared->staticData = std::move(staticData);
+
+    auto pIntegrator = SharedPtr(new EmissiveIntegratorCPU());
+    pIntegrator->mResult = TaskScheduler::instance().submit([pShared, pResult, triangleCount]() -> std::shared_ptr<const Result> {
+        auto& scheduler = TaskScheduler::instance();
+
+        // Texture reads are IO bound, start them while triangles are fetched.
+        std::vector<TaskScheduler::Future<TexelData::SharedConstPtr>> textureTasks;
+        for (const auto& pTexture : pShared->textures) {
+            textureTasks.push_back(scheduler.submit([pTexture, pSampler = pShared->pSampler]() { return TexelData::createFromTexture(pTexture, pSampler); }, TaskScheduler::Lane::IO));
+        }
+
+        pResult->packedTriangles.resize(triangleCount);
+        pResult->fluxData.resize(triangleCount);
+        pResult->triangles.resize(triangleCount);
+
+        const auto& offsets = pShared->triangleOffsets;
+        auto findLight = [&offsets](uint32_t triIdx) {
+            return uint32_t(std::upper_bound(offsets.begin(), offsets.end(), triIdx) - offsets.begin() - 1);
+        };
+
+        // Fetch world space triangles (same as BuildTriangleList.cs.slang).
+        scheduler.parallelFor(0, triangleCount, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t triIdx = begin, lightIdx = findLight(begin); triIdx < end; triIdx++) {
+                while (lightIdx + 1 < offsets.size() && triIdx >= offsets[lightIdx + 1]) lightIdx++;
+                const MeshLight& meshLight = pShared->meshLights[lightIdx];
+                const uint32_t triangleIndex = triIdx - offsets[lightIdx];
+
+                uint32_t indices[3] = { triangleIndex * 3, triangleIndex * 3 + 1, triangleIndex * 3 + 2 };
+                if (meshLight.mesh.indexCount > 0) {
+                    for (uint32_t j = 0; j < 3; j++) {
+                        indices[j] = meshLight.mesh.use16BitIndices()
+                            ? uint32_t(reinterpret_cast<const uint16_t*>(pShared->indexData.data() + meshLight.instance.ibOffset)[triangleIndex * 3 + j])
+                            : pShared->indexData[meshLight.instance.ibOffset + triangleIndex * 3 + j];
+                    }
+                }
+
+                EmissiveTriangle tri;
+                const glm::mat4& transform = pResult->transforms[lightIdx];
+                for (uint32_t j = 0; j < 3; j++) {
+                    const PackedStaticVertexData& vertex = pShared->staticData[meshLight.instance.vbOffset + indices[j]];
+                    tri.posW[j] = float3(transform * float4(vertex.position, 1.f));
+                    tri.texCoords[j] = float2(vertex.texU, vertex.texV);
+                }
+
+                float3 N = glm::cross(tri.posW[1] - tri.posW[0], tri.posW[2] - tri.posW[0]);
+                tri.area = 0.5f * glm::length(N);
+                if (meshLight.instance.isWorldFrontFaceCW()) N = -N;
+                tri.normal = glm::normalize(N);
+                tri.materialID = meshLight.instance.materialID;
+                tri.lightIdx = lightIdx;
+
+                pResult->packedTriangles[triIdx].pack(tri);
+            }
+        });
+
+        // Geometry is not needed anymore.
+        std::vector<uint32_t>().swap(pShared->indexData);
+        std::vector<PackedStaticVertexData>().swap(pShared->staticData);
+
+        std::vector<TexelData::SharedConstPtr> textures;
+        for (size_t i = 0; i < textureTasks.size(); i++) {
+            textures.push_back(textureTasks[i].get());
+            if (!textures.back()) {
+                LLOG_INF << "Emissive texture " << pShared->textures[i]->getSourceFilename() << " can't be integrated on the CPU. Using the GPU integrator";
+                return nullptr;
+            }
+        }
+
+        // Integrate emission (same as FinalizeIntegration.cs.slang). Triangles are integrated from their packed data, as on the GPU.
+        scheduler.parallelFor(0, triangleCount, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t triIdx = begin; triIdx < end; triIdx++) {
+                const EmissiveTriangle tri = pResult->packedTriangles[triIdx].unpack();
+                const MeshLight& meshLight = pShared->meshLights[tri.lightIdx];
+
+                const float3 averageEmissiveColor = meshLight.textureIndex < 0 ? meshLight.emissive : integrateTriangle(*textures[meshLight.textureIndex], tri.texCoords);
+                const float3 averageRadiance = averageEmissiveColor * meshLight.emissiveFactor;
+                const float flux = luminance(averageRadiance) * tri.area * (float)M_PI;
+
+                pResult->fluxData[triIdx].flux = flux;
+                pResult->fluxData[triIdx].averageRadiance = averageRadiance;
+
+                auto& meshLightTri = pResult->triangles[triIdx];
+                meshLightTri.lightIdx = tri.lightIdx;
+                meshLightTri.normal = tri.normal;
+                meshLightTri.area = tri.area;
+                for (uint32_t j = 0; j < 3; j++) {
+                    meshLightTri.vtx[j].pos = tri.posW[j];
+                    meshLightTri.vtx[j].uv = tri.texCoords[j];
+                }
+                meshLightTri.flux = flux;
+                meshLightTri.averageRadiance = averageRadiance;
+            }
+        });
+
+        return pResult;
+    });
+
+    return pIntegrator;
+}
+
+std::shared_ptr<const EmissiveIntegratorCPU::Result> EmissiveIntegratorCPU::getResult() const {
+    return mResult.valid() ? mResult.get() : nullptr;
+}
+
+}  // namespace Falcor
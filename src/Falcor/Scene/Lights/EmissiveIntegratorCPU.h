@@ -0,0 +1,139 @@
+/***************************************************************************
+ # Copyright (c) 2015-21, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#ifndef SRC_FALCOR_SCENE_LIGHTS_EMISSIVEINTEGRATORCPU_H_
+#define SRC_FALCOR_SCENE_LIGHTS_EMISSIVEINTEGRATORCPU_H_
+
+#include <memory>
+#include <vector>
+
+#include "Falcor/Core/Framework.h"
+#include "Falcor/Core/API/Sampler.h"
+#include "Falcor/Core/API/Texture.h"
+#include "Falcor/Utils/TaskScheduler.h"
+#include "Falcor/Scene/SceneTypes.slang"
+#include "LightCollection.h"
+#include "LightCollectionShared.slang"
+
+namespace Falcor {
+
+class Scene;
+
+/** CPU integrator of emissive mesh light triangles.
+
+    Computes the same per-triangle data as the LightCollection GPU passes (BuildTriangleList.cs.slang,
+    EmissiveIntegrator.3d.slang and FinalizeIntegration.cs.slang) from the scene's CPU-side vertex data, so the light
+    collection doesn't have to read the results back from the GPU. Textured emission is integrated over the texels
+    of the emissive texture with partially covered texels weighted by their analytic coverage. Triangles spanning
+    many texels are integrated at a coarser level of a box-filtered mip chain.
+
+    Integration runs on the TaskScheduler and is started at scene creation, overlapping with acceleration structure
+    builds. Scenes with dynamic emissive meshes, UDIM emissive textures or emissive textures without a readable
+    uncompressed source image are left to the GPU integrator.
+*/
+class dlldecl EmissiveIntegratorCPU {
+  public:
+    using SharedPtr = std::shared_ptr<EmissiveIntegratorCPU>;
+
+    /** Linear RGB texels of an emissive texture with a box-filtered mip chain.
+    */
+    struct TexelData {
+        using SharedConstPtr = std::shared_ptr<const TexelData>;
+
+        struct Mip {
+            uint32_t            width = 0;
+            uint32_t            height = 0;
+            std::vector<float3> texels;
+        };
+
+        std::vector<Mip>        mips;
+        Sampler::AddressMode    addressModeU = Sampler::AddressMode::Wrap;
+        Sampler::AddressMode    addressModeV = Sampler::AddressMode::Wrap;
+
+        /** Create texel data from base level texels. The mip chain is generated down to 1x1.
+        */
+        static SharedConstPtr create(uint32_t width, uint32_t height, std::vector<float3>&& texels, Sampler::AddressMode addressModeU, Sampler::AddressMode addressModeV);
+
+        /** Load texel data from the source image of a texture. Sparse textures are read from the image they were converted from.
+            \return Texel data, or nullptr if the texture can't be read on the CPU.
+        */
+        static SharedConstPtr createFromTexture(const Texture::SharedPtr& pTexture, const Sampler::SharedPtr& pSampler);
+
+        /** Fetch a texel. Coordinates outside of the mip are resolved using the address modes.
+        */
+        float3 fetch(uint32_t mipLevel, int64_t x, int64_t y) const;
+    };
+
+    /** Integration results, ordered as the light collection's mesh light triangles.
+    */
+    struct Result {
+        std::vector<uint32_t>                           instanceIDs;        ///< Geometry instance ID of each mesh light.
+        std::vector<glm::mat4>                          transforms;         ///< Instance transform of each mesh light at the time of integration.
+        std::vector<PackedEmissiveTriangle>             packedTriangles;    ///< GPU triangle data.
+        std::vector<EmissiveFlux>                       fluxData;           ///< GPU flux data.
+        std::vector<LightCollection::MeshLightTriangle> triangles;          ///< CPU triangle data, as read back from the GPU buffers.
+    };
+
+    /** Start integrating the emissive mesh instances of a scene.
+        Must be called after the scene is finalized, i.e. once instance flags and transforms are valid.
+        \param[in] scene The scene.
+        \param[in] indexData Scene mesh index data. Released once triangles are fetched.
+        \param[in] staticData Scene static vertex data. Released once triangles are fetched.
+        \return Integrator, or nullptr if the scene has no emissive mesh instances or they can't be integrated on the CPU.
+    */
+    static SharedPtr create(const Scene& scene, std::vector<uint32_t>&& indexData, std::vector<PackedStaticVertexData>&& staticData);
+
+    /** Wait for the integration to finish.
+        \return Integration results, or nullptr if the integration failed and the GPU integrator has to be used instead.
+    */
+    std::shared_ptr<const Result> getResult() const;
+
+    /** Compute the average radiance of the emissive texture over a triangle.
+        Matches the GPU integrator when integrating at mip 0. Triangles covering more than kMaxTexelsPerTriangle
+        texels are integrated at the first mip level below that budget.
+        \param[in] texels Emissive texture texels.
+        \param[in] texCoords Triangle texture coordinates.
+        \return Average radiance, or the average of the texels at the vertices if the triangle is degenerate in texture space.
+    */
+    static float3 integrateTriangle(const TexelData& texels, const float2 texCoords[3]);
+
+    /** Compute the area of a 2D triangle clipped to an axis-aligned box.
+        \return Clipped area. Always positive, independent of the triangle winding.
+    */
+    static float computeClippedTriangleArea(const float2 p[3], const float2& minPos, const float2& maxPos);
+
+    static const uint32_t kMaxTexelsPerTriangle = 64 * 64;
+
+  private:
+    EmissiveIntegratorCPU() = default;
+
+    TaskScheduler::Future<std::shared_ptr<const Result>> mResult;
+};
+
+}  // namespace Falcor
+
+#endif  // SRC_FALCOR_SCENE_LIGHTS_EMISSIVEINTEGRATORCPU_H_
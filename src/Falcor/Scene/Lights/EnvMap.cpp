@@ -103,6 +103,20 @@ EnvMap::EnvMap(Device::SharedPtr pDevice, const Texture::SharedPtr& pTexture) {
     samplerDesc.setFilterMode(Sampler::Filter::Linear, Sampler::Filter::Linear, Sampler::Filter::Linear);
     samplerDesc.setAddressingMode(Sampler::AddressMode::Wrap, Sampler::AddressMode::Clamp, Sampler::AddressMode::Clamp);
     mpEnvSampler = Sampler::create(mpDevice, samplerDesc);
+
+    // Sparse maps have the mip tail and (partially) resident mips above it. Clamp evaluation to the most detailed
+    // level that is fully resident together with all coarser levels.
+    if (mpEnvMap && mpEnvMap->isSparse()) {
+        const uint32_t mipTailStart = std::min(mpEnvMap->getMipTailStart(), mpEnvMap->getMipCount());
+        std::vector<bool> incompleteMips(mipTailStart, false);
+        for (const auto& pPage : mpEnvMap->sparseDataPages()) {
+            if (pPage->mipLevel() < mipTailStart && !pPage->isResident()) incompleteMips[pPage->mipLevel()] = true;
+        }
+
+        uint32_t mostDetailedMip = mipTailStart;
+        while (mostDetailedMip > 0 && !incompleteMips[mostDetailedMip - 1]) mostDetailedMip--;
+        mData.minLod = (float)std::min(mostDetailedMip, mpEnvMap->getMipCount() - 1);
+    }
 }
 
 #ifdef SCRIPTING
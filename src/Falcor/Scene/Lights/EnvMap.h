@@ -102,6 +102,11 @@ class dlldecl EnvMap : public std::enable_shared_from_this<EnvMap> {
     const Texture::SharedPtr& getTexture() const { return mpEnvMap; }
     const Sampler::SharedPtr& getEnvSampler() const { return mpEnvSampler; }
 
+    /** Get the most detailed mip level evaluated. Sparse (LTX) maps are only evaluated from the mip levels resident
+        at creation time, non sparse maps from mip 0.
+    */
+    uint32_t getMostDetailedMip() const { return (uint32_t)mData.minLod; }
+
     /** Bind the environment map to a given shader variable.
         \param[in] var Shader variable.
     */
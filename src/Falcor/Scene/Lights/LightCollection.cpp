@@ -38,6 +38,7 @@
 
 #include <sstream>
 
+#include "EmissiveIntegratorCPU.h"
 #include "LightCollection.h"
 
 namespace Falcor {
@@ -55,11 +56,11 @@ namespace {
     const char kFinalizeIntegrationFile[] = "Scene/Lights/FinalizeIntegration.cs.slang";
 }  // namespace
 
-LightCollection::SharedPtr LightCollection::create(RenderContext* pRenderContext, const std::shared_ptr<Scene>& pScene) {
-    return SharedPtr(new LightCollection(pRenderContext, pScene));
+LightCollection::SharedPtr LightCollection::create(RenderContext* pRenderContext, const std::shared_ptr<Scene>& pScene, const std::shared_ptr<EmissiveIntegratorCPU>& pCPUIntegrator) {
+    return SharedPtr(new LightCollection(pRenderContext, pScene, pCPUIntegrator));
 }
 
-LightCollection::LightCollection(RenderContext* pRenderContext, const std::shared_ptr<Scene>& pScene):mTriangleCount(0) {
+LightCollection::LightCollection(RenderContext* pRenderContext, const std::shared_ptr<Scene>& pScene, const std::shared_ptr<EmissiveIntegratorCPU>& pCPUIntegrator):mTriangleCount(0) {
     mpDevice = pRenderContext->device();
 
     assert(pScene);
@@ -68,10 +69,6 @@ LightCollection::LightCollection(RenderContext* pRenderContext, const std::share
     // Setup the lights.
     setupMeshLights(*pScene);
 
-    // Create program for integrating emissive textures.
-    // This should be done after lights are setup, so that we know which sampler state etc. to use.
-    initIntegrator(*pScene);
-
     // Create programs for building/updating the mesh lights.
     Shader::DefineList defines = pScene->getSceneDefines();
     mpTriangleListBuilder = ComputePass::create(mpDevice, kBuildTriangleListFile, "buildTriangleList", defines);
@@ -81,7 +78,7 @@ LightCollection::LightCollection(RenderContext* pRenderContext, const std::share
     mpStagingFence = GpuFence::create(mpDevice);
 
     // Now build the mesh light data.
-    build(pRenderContext, *pScene);
+    build(pRenderContext, *pScene, pCPUIntegrator.get());
 }
 
 bool LightCollection::update(RenderContext* pRenderContext, UpdateStatus* pUpdateStatus) {
@@ -216,7 +213,7 @@ void LightCollection::setupMeshLights(const Scene& scene) {
     }
 }
 
-void LightCollection::build(RenderContext* pRenderContext, const Scene& scene) {
+void LightCollection::build(RenderContext* pRenderContext, const Scene& scene, const EmissiveIntegratorCPU* pCPUIntegrator) {
     prepareMeshData(scene);
 
     if (mTriangleCount == 0) {
@@ -227,6 +224,10 @@ void LightCollection::build(RenderContext* pRenderContext, const Scene& scene) {
         mCPUInvalidData = CPUOutOfDateFlags::None;
         mStagingBufferValid = true;
         mStatsValid = true;
+    } else if (pCPUIntegrator && buildFromCPUIntegration(pRenderContext, scene, *pCPUIntegrator)) {
+        mIntegratedOnCPU = true;
+        mStatsValid = false;
+        updateActiveTriangleList();
     } else {
         TimeReport timeReport;
 
@@ -253,20 +254,64 @@ void LightCollection::build(RenderContext* pRenderContext, const Scene& scene) {
     }
 }
 
-void LightCollection::prepareTriangleData(RenderContext* pRenderContext, const Scene& scene) {
+bool LightCollection::buildFromCPUIntegration(RenderContext* pRenderContext, const Scene& scene, const EmissiveIntegratorCPU& integrator) {
+    TimeReport timeReport;
+
+    // Wait for the integration started at scene creation.
+    auto pResult = integrator.getResult();
+    timeReport.measure("LightCollection::build wait for CPU integration");
+    if (!pResult) return false;
+
+    if (pResult->triangles.size() != mTriangleCount || pResult->instanceIDs.size() != mMeshLights.size()) {
+        LLOG_WRN << "LightCollection::build() CPU integration doesn't match the scene mesh lights. Using the GPU integrator";
+        return false;
+    }
+    for (size_t lightIdx = 0; lightIdx < mMeshLights.size(); ++lightIdx) {
+        if (pResult->instanceIDs[lightIdx] != mMeshLights[lightIdx].instanceID) {
+            LLOG_WRN << "LightCollection::build() CPU integration doesn't match the scene mesh lights. Using the GPU integrator";
+            return false;
+        }
+    }
+
+    // Upload the results. The CPU copy is up to date, so there is nothing to read back.
+    prepareTriangleData(pRenderContext, scene, pResult->packedTriangles.data(), pResult->fluxData.data());
+    mMeshLightTriangles = pResult->triangles;
+    mCPUInvalidData = CPUOutOfDateFlags::None;
+    mStagingBufferValid = true;
+
+    // Instances may have moved since the integration was started. Move their triangles like update() does.
+    // As with the GPU integrator, flux is not updated for the new transforms.
+    std::vector<uint32_t> movedLights;
+    const auto& globalMatrices = scene.getAnimationController()->getGlobalMatrices();
+    for (uint32_t lightIdx = 0; lightIdx < mMeshLights.size(); ++lightIdx) {
+        const GeometryInstanceData& instanceData = scene.getGeometryInstance(mMeshLights[lightIdx].instanceID);
+        if (globalMatrices[instanceData.globalMatrixID] != pResult->transforms[lightIdx]) movedLights.push_back(lightIdx);
+    }
+    if (!movedLights.empty()) {
+        updateTrianglePositions(pRenderContext, scene, movedLights);
+        prepareSyncCPUData(pRenderContext);
+    }
+
+    timeReport.measure("LightCollection::build upload CPU integration");
+    timeReport.printToLog();
+    return true;
+}
+
+void LightCollection::prepareTriangleData(RenderContext* pRenderContext, const Scene& scene, const void* pTriangleData, const void* pFluxData) {
     assert(mTriangleCount > 0);
+    assert((pTriangleData == nullptr) == (pFluxData == nullptr));
 
     // Create GPU buffers.
-    mpTriangleData = Buffer::createStructured(mpDevice, mpTriangleListBuilder["gTriangleData"], mTriangleCount, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+    mpTriangleData = Buffer::createStructured(mpDevice, mpTriangleListBuilder["gTriangleData"], mTriangleCount, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, pTriangleData, false);
     mpTriangleData->setName("LightCollection::mpTriangleData");
     if (mpTriangleData->getStructSize() != sizeof(PackedEmissiveTriangle)) throw std::runtime_error("Struct PackedEmissiveTriangle size mismatch between CPU/GPU");
 
-    mpFluxData = Buffer::createStructured(mpDevice, mpFinalizeIntegration["gFluxData"], mTriangleCount, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+    mpFluxData = Buffer::createStructured(mpDevice, mpFinalizeIntegration["gFluxData"], mTriangleCount, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, pFluxData, false);
     mpFluxData->setName("LightCollection::mpFluxData");
     if (mpFluxData->getStructSize() != sizeof(EmissiveFlux)) throw std::runtime_error("Struct EmissiveFlux size mismatch between CPU/GPU");
 
-    // Compute triangle data (vertices, uv-coordinates, materialID) for all mesh lights.
-    buildTriangleList(pRenderContext, scene);
+    // Compute triangle data (vertices, uv-coordinates, materialID) for all mesh lights, unless it was computed on the CPU.
+    if (!pTriangleData) buildTriangleList(pRenderContext, scene);
 }
 
 
@@ -306,6 +351,10 @@ void LightCollection::integrateEmissive(RenderContext* pRenderContext, const Sce
     assert(mTriangleCount > 0);
     assert(mMeshLights.size() > 0);
 
+    // Create program for integrating emissive textures.
+    // This is done after lights are setup, so that we know which sampler state etc. to use.
+    if (!mIntegrator.pProgram) initIntegrator(scene);
+
     // Prepare program vars.
     mIntegrator.pVars = GraphicsVars::create(mpDevice, mIntegrator.pProgram.get());
     mIntegrator.pVars["gScene"] = scene.getParameterBlock();
@@ -39,6 +39,7 @@
 namespace Falcor {
 
 class Scene;
+class EmissiveIntegratorCPU;
 
 /** Class that holds a collection of mesh lights for a scene.
 
@@ -116,9 +117,10 @@ class dlldecl LightCollection : public std::enable_shared_from_this<LightCollect
         Note that update() must be called before the collection is ready to use.
         \param[in] pRenderContext The render context.
         \param[in] pScene The scene.
+        \param[in] pCPUIntegrator Emissive triangles integrated on the CPU. When available the GPU integration passes and the readback of their results are skipped.
         \return Ptr to the created object, or nullptr if an error occured.
     */
-    static SharedPtr create(RenderContext* pRenderContext, const std::shared_ptr<Scene>& pScene);
+    static SharedPtr create(RenderContext* pRenderContext, const std::shared_ptr<Scene>& pScene, const std::shared_ptr<EmissiveIntegratorCPU>& pCPUIntegrator = nullptr);
 
     /** Updates the light collection to the current state of the scene.
         \param[in] pRenderContext The render context.
@@ -163,6 +165,10 @@ class dlldecl LightCollection : public std::enable_shared_from_this<LightCollect
     */
     void prepareSyncCPUData(RenderContext* pRenderContext) const { copyDataToStagingBuffer(pRenderContext); }
 
+    /** Returns true if the emissive triangles were integrated on the CPU (see EmissiveIntegratorCPU) instead of the GPU passes.
+    */
+    bool isIntegratedOnCPU() const { return mIntegratedOnCPU; }
+
     /** Get the total GPU memory usage in bytes.
     */
     uint64_t getMemoryUsageInBytes() const;
@@ -178,12 +184,13 @@ class dlldecl LightCollection : public std::enable_shared_from_this<LightCollect
     };
 
 protected:
-    LightCollection(RenderContext* pRenderContext, const std::shared_ptr<Scene>& pScene);
+    LightCollection(RenderContext* pRenderContext, const std::shared_ptr<Scene>& pScene, const std::shared_ptr<EmissiveIntegratorCPU>& pCPUIntegrator);
 
     void initIntegrator(const Scene& scene);
     void setupMeshLights(const Scene& scene);
-    void build(RenderContext* pRenderContext, const Scene& scene);
-    void prepareTriangleData(RenderContext* pRenderContext, const Scene& scene);
+    void build(RenderContext* pRenderContext, const Scene& scene, const EmissiveIntegratorCPU* pCPUIntegrator);
+    bool buildFromCPUIntegration(RenderContext* pRenderContext, const Scene& scene, const EmissiveIntegratorCPU& integrator);
+    void prepareTriangleData(RenderContext* pRenderContext, const Scene& scene, const void* pTriangleData = nullptr, const void* pFluxData = nullptr);
     void prepareMeshData(const Scene& scene);
     void integrateEmissive(RenderContext* pRenderContext, const Scene& scene);
     void computeStats() const;
@@ -237,6 +244,7 @@ protected:
 
     mutable CPUOutOfDateFlags               mCPUInvalidData = CPUOutOfDateFlags::None;  ///< Flags indicating which CPU data is valid.
     mutable bool                            mStagingBufferValid = true;                 ///< Flag to indicate if the contents of the staging buffer is up-to-date.
+    bool                                    mIntegratedOnCPU = false;                   ///< True if the triangles were integrated on the CPU.
 };
 
 enum_class_operators(LightCollection::CPUOutOfDateFlags);
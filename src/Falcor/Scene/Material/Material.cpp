@@ -55,6 +55,12 @@ bool operator==(const MaterialHeader& lhs, const MaterialHeader& rhs) {
     return lhs.packedData == rhs.packedData;
 }
 
+namespace {
+    inline void hashCombine(size_t& seed, size_t value) {
+        seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+    }
+}
+
 Material::Material(Device::SharedPtr pDevice, const std::string& name, MaterialType type): mpDevice(pDevice), mName(name) {
     mHeader.setMaterialType(type);
     mHeader.setAlphaMode(AlphaMode::Opaque);
@@ -274,6 +280,19 @@ bool Material::isBaseEqual(const Material& other) const {
     return true;
 }
 
+size_t Material::getHash() const {
+    // Only fields compared bitwise by isBaseEqual() are hashed, so equal materials always land in the same bucket.
+    size_t hash = std::hash<uint32_t>()(static_cast<uint32_t>(getType()));
+    for (uint32_t i = 0; i < 4; i++) hashCombine(hash, std::hash<uint32_t>()(mHeader.packedData[i]));
+
+    for (size_t i = 0; i < mTextureSlotData.size(); i++) {
+        if (!hasTextureSlot((TextureSlot)i)) continue;
+        hashCombine(hash, i);
+        hashCombine(hash, std::hash<const Texture*>()(mTextureSlotData[i].pTexture.get()));
+    }
+    return hash;
+}
+
 #ifdef SCRIPTING
 SCRIPT_BINDING(Material) {
     SCRIPT_BINDING_DEPENDENCY(Transform)
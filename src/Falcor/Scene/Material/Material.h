@@ -139,6 +139,11 @@ class dlldecl Material : public std::enable_shared_from_this<Material> {
 		*/
 		virtual bool isEqual(const Material::SharedPtr& pOther) const = 0;
 
+		/** Compute material content hash. Materials that compare equal with isEqual() are guaranteed to have the same hash.
+			The name is not included.
+		*/
+		virtual size_t getHash() const;
+
 		/**
 		*/
 		virtual bool hasUDIMTextures() const { return false; }
@@ -125,13 +125,13 @@ void MaterialSystem::setDefaultTextureSampler(const Sampler::SharedPtr& pSampler
 
 uint32_t MaterialSystem::addTextureSampler(const Sampler::SharedPtr& pSampler) {
 	assert(pSampler);
-	auto isEqual = [&pSampler](const Sampler::SharedPtr& pOther) {
-		return pSampler->getDesc() == pOther->getDesc();
-	};
+	const auto& desc = pSampler->getDesc();
+	const size_t descHash = desc.getHash();
 
 	// Reuse previously added samplers. We compare by sampler desc.
-	if (auto it = std::find_if(mTextureSamplers.begin(), mTextureSamplers.end(), isEqual); it != mTextureSamplers.end()) {
-		return (uint32_t)std::distance(mTextureSamplers.begin(), it);
+	auto range = mTextureSamplerIDs.equal_range(descHash);
+	for (auto it = range.first; it != range.second; ++it) {
+		if (mTextureSamplers[it->second]->getDesc() == desc) return it->second;
 	}
 
 	// Add sampler.
@@ -141,6 +141,7 @@ uint32_t MaterialSystem::addTextureSampler(const Sampler::SharedPtr& pSampler) {
 	const uint32_t samplerID = static_cast<uint32_t>(mTextureSamplers.size());
 
 	mTextureSamplers.push_back(pSampler);
+	mTextureSamplerIDs.emplace(descHash, samplerID);
 	mSamplersChanged = true;
 
 	return samplerID;
@@ -173,8 +174,8 @@ uint32_t MaterialSystem::addMaterial(const Material::SharedPtr& pMaterial) {
     std::scoped_lock lock(g_materials_mutex);
 
 		// Reuse previously added materials.
-		if (auto it = std::find(mMaterials.begin(), mMaterials.end(), pMaterial); it != mMaterials.end()) {
-			return (uint32_t)std::distance(mMaterials.begin(), it);
+		if (auto it = mMaterialIDs.find(pMaterial.get()); it != mMaterialIDs.end()) {
+			return it->second;
 		}
 
 		// Add material.
@@ -189,6 +190,7 @@ uint32_t MaterialSystem::addMaterial(const Material::SharedPtr& pMaterial) {
 
 		pMaterial->registerUpdateCallback([this](auto flags) { mMaterialUpdates |= flags; });
 		mMaterials.push_back(pMaterial);
+		mMaterialIDs[pMaterial.get()] = materialID;
 		mMaterialsChanged = true;
 
 		// Update metadata.
@@ -233,16 +235,23 @@ size_t MaterialSystem::removeDuplicateMaterials(std::vector<uint32_t>& idMap) {
 	std::vector<Material::SharedPtr> uniqueMaterials;
 	idMap.resize(mMaterials.size());
 
+	// Unique material IDs bucketed by content hash. Equal materials always share a bucket and each bucket
+	// keeps insertion order, so the first equal unique material found is the same one a linear search finds.
+	std::unordered_map<size_t, std::vector<uint32_t>> uniqueMaterialBuckets;
+	uniqueMaterialBuckets.reserve(mMaterials.size());
+
 	// Find unique set of materials.
 	for (uint32_t id = 0; id < mMaterials.size(); ++id) {
 		const auto& pMaterial = mMaterials[id];
-		auto it = std::find_if(uniqueMaterials.begin(), uniqueMaterials.end(), [&pMaterial](const auto& m) { return m->isEqual(pMaterial); });
-		if (it == uniqueMaterials.end()) {
+		auto& bucket = uniqueMaterialBuckets[pMaterial->getHash()];
+		auto it = std::find_if(bucket.begin(), bucket.end(), [&](uint32_t uniqueID) { return uniqueMaterials[uniqueID]->isEqual(pMaterial); });
+		if (it == bucket.end()) {
 			idMap[id] = (uint32_t)uniqueMaterials.size();
+			bucket.push_back(idMap[id]);
 			uniqueMaterials.push_back(pMaterial);
 		} else {
-			LLOG_INF << "Removing duplicate material '" << pMaterial->getName() << "' (duplicate of '" << (*it)->getName() << "').";
-			idMap[id] = (uint32_t)std::distance(uniqueMaterials.begin(), it);
+			LLOG_INF << "Removing duplicate material '" << pMaterial->getName() << "' (duplicate of '" << uniqueMaterials[*it]->getName() << "').";
+			idMap[id] = *it;
 
 			// Update metadata.
 			if (isSpecGloss(pMaterial)) mSpecGlossMaterialCount--;
@@ -252,6 +261,8 @@ size_t MaterialSystem::removeDuplicateMaterials(std::vector<uint32_t>& idMap) {
 	size_t removed = mMaterials.size() - uniqueMaterials.size();
 	if (removed > 0) {
 		mMaterials = uniqueMaterials;
+		mMaterialIDs.clear();
+		for (uint32_t id = 0; id < mMaterials.size(); ++id) mMaterialIDs[mMaterials[id].get()] = id;
 		mMaterialsChanged = true;
 	}
 
@@ -29,6 +29,7 @@
 #define SRC_FALCOR_SCENE_MATERIAL_MATERIALSYSTEM_H_
 
 #include <set>
+#include <unordered_map>
 
 #include "Material.h"
 
@@ -208,6 +209,7 @@ class dlldecl MaterialSystem {
 		Device::SharedPtr mpDevice = nullptr;
 
 		std::vector<Material::SharedPtr> mMaterials;                ///< List of all materials.
+		std::unordered_map<const Material*, uint32_t> mMaterialIDs; ///< Material ID by material pointer. Kept in sync with mMaterials.
 		std::vector<uint32_t> mMaterialCountByType;                 ///< Number of materials of each type, indexed by MaterialType.
 		std::set<MaterialType> mMaterialTypes;                      ///< Set of all material types used.
 		uint32_t mSpecGlossMaterialCount = 0;                       ///< Number of standard materials using the SpecGloss shading model.
@@ -230,6 +232,7 @@ class dlldecl MaterialSystem {
 		Sampler::SharedPtr mpUDIMTileSampler;                       ///< Texture sampler used to sample individual UDIM texture tiles.
 
 		std::vector<Sampler::SharedPtr> mTextureSamplers;           ///< Texture sampler states. These are indexed by ID in the materials.
+		std::unordered_multimap<size_t, uint32_t> mTextureSamplerIDs; ///< Texture sampler IDs by sampler desc hash.
 		std::vector<Buffer::SharedPtr> mBuffers;                    ///< Buffers used by the materials. These are indexed by ID in the materials.
 
 		// UI variables
@@ -4,7 +4,7 @@
 #include <map>
 #include <bitset>
 
-#include "Falcor/Utils/ThreadPool.h"
+#include "Falcor/Utils/TaskScheduler.h"
 #include "Falcor/Scene/SceneBuilder.h"
 
 namespace Falcor {
@@ -20,7 +20,7 @@ class dlldecl MeshletBuilder {
 	protected:
 		MeshletBuilder();
 
-		BS::multi_future<uint32_t> mTasks;
+		std::vector<TaskScheduler::Future<uint32_t>> mTasks;
 
 };
 
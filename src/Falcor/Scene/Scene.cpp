@@ -112,11 +112,6 @@ namespace {
     const std::string kAddViewpoint = "addViewpoint";
     const std::string kRemoveViewpoint = "kRemoveViewpoint";
     const std::string kSelectViewpoint = "selectViewpoint";
-
-    // Checks if the transform flips the coordinate system handedness (its determinant is negative).
-    bool doesTransformFlip(const glm::mat4& m) {
-        return glm::determinant((glm::mat3)m) < 0.f;
-    }
 }
 
 static inline VkTransformMatrixKHR toTransformMatrixKHR(const glm::mat4& m) {
@@ -244,6 +239,10 @@ Scene::Scene(std::shared_ptr<Device> pDevice, SceneData&& sceneData): mpDevice(p
     // Finalize scene.
     finalize();
 
+    // Start integrating emissive triangles on the CPU. It runs while acceleration structures are built and spares the
+    // light collection the GPU integration and readback. Vertex data is not used by the scene past this point.
+    mpEmissiveIntegrator = EmissiveIntegratorCPU::create(*this, std::move(sceneData.meshIndexData), std::move(sceneData.meshStaticData));
+
     // Init ray tracing. 
     // TODO: Init only if needed...
     initRayTracing();
@@ -364,7 +363,8 @@ Program::TypeConformanceList Scene::getTypeConformances() const {
 
 const LightCollection::SharedPtr& Scene::getLightCollection(RenderContext* pContext) {
     if (!mpLightCollection) {
-        mpLightCollection = LightCollection::create(pContext, shared_from_this());
+        mpLightCollection = LightCollection::create(pContext, shared_from_this(), mpEmissiveIntegrator);
+        mpEmissiveIntegrator = nullptr;
         mpLightCollection->setShaderData(mpSceneBlock["lightCollection"]);
 
         mSceneStats.emissiveMemoryInBytes = mpLightCollection->getMemoryUsageInBytes();
@@ -931,36 +931,36 @@ Scene::UpdateFlags Scene::updateSDFGrids(RenderContext* pRenderContext) {
 void Scene::updateGeometryInstances(bool forceUpdate) {
     if (mGeometryInstanceData.empty()) return;
 
-    bool dataChanged = false;
     const auto& globalMatrices = mpAnimationController->getGlobalMatrices();
 
-    for (auto& inst : mGeometryInstanceData) {
-        if (inst.getType() == GeometryType::TriangleMesh || inst.getType() == GeometryType::DisplacedTriangleMesh) {
-            uint32_t prevFlags = inst.flags;
-
-            assert(inst.globalMatrixID < globalMatrices.size());
-            const glm::mat4& transform = globalMatrices[inst.globalMatrixID];
-            bool isTransformFlipped = doesTransformFlip(transform);
-            bool isObjectFrontFaceCW = getMesh(inst.geometryID).isFrontFaceCW();
-            bool isWorldFrontFaceCW = isObjectFrontFaceCW ^ isTransformFlipped;
-
-            if (isTransformFlipped) inst.flags |= (uint32_t)GeometryInstanceFlags::TransformFlipped;
-            else inst.flags &= ~(uint32_t)GeometryInstanceFlags::TransformFlipped;
-
-            if (isObjectFrontFaceCW) inst.flags |= (uint32_t)GeometryInstanceFlags::IsObjectFrontFaceCW;
-            else inst.flags &= ~(uint32_t)GeometryInstanceFlags::IsObjectFrontFaceCW;
+    auto updateInstance = [&](uint32_t instanceID) {
+        auto& inst = mGeometryInstanceData[instanceID];
+        if (inst.getType() != GeometryType::TriangleMesh && inst.getType() != GeometryType::DisplacedTriangleMesh) return;
 
-            if (isWorldFrontFaceCW) inst.flags |= (uint32_t)GeometryInstanceFlags::IsWorldFrontFaceCW;
-            else inst.flags &= ~(uint32_t)GeometryInstanceFlags::IsWorldFrontFaceCW;
+        assert(inst.globalMatrixID < globalMatrices.size());
+        bool isObjectFrontFaceCW = getMesh(inst.geometryID).isFrontFaceCW();
+        if (GeometryInstanceTracker::updateTransformFlags(inst, globalMatrices[inst.globalMatrixID], isObjectFrontFaceCW)) {
+            mGeometryInstanceTracker.markInstanceDirty(instanceID);
+        }
+    };
 
-            dataChanged |= (inst.flags != prevFlags);
+    if (forceUpdate) {
+        for (uint32_t i = 0; i < (uint32_t)mGeometryInstanceData.size(); i++) updateInstance(i);
+        mGeometryInstanceTracker.markAllInstancesDirty();
+    } else {
+        // Only instances referencing a changed matrix can have changed flags.
+        for (uint32_t matrixID = 0; matrixID < (uint32_t)mGeometryInstanceTracker.getMatrixCount(); matrixID++) {
+            if (!mpAnimationController->isMatrixChanged(matrixID)) continue;
+            const uint32_t* pInstances = mGeometryInstanceTracker.getInstances(matrixID);
+            for (uint32_t i = 0; i < mGeometryInstanceTracker.getInstanceCount(matrixID); i++) updateInstance(pInstances[i]);
         }
     }
 
-    if (forceUpdate || dataChanged) {
-        uint32_t byteSize = (uint32_t)(mGeometryInstanceData.size() * sizeof(GeometryInstanceData));
-        mpGeometryInstancesBuffer->setBlob(mGeometryInstanceData.data(), 0, byteSize);
+    auto& dirtyInstances = mGeometryInstanceTracker.getDirtyInstances();
+    for (const auto& range : dirtyInstances.getRanges()) {
+        mpGeometryInstancesBuffer->setBlob(&mGeometryInstanceData[range.offset], range.offset * sizeof(GeometryInstanceData), range.count * sizeof(GeometryInstanceData));
     }
+    mGeometryInstanceTracker.clearDirtyInstances();
 }
 
 
@@ -1192,6 +1192,7 @@ void Scene::finalize() {
     initResources(); // Requires scene defines
     mpAnimationController->animate(mpDevice->getRenderContext(), 0); // Requires Scene block to exist
     updateGeometry(true);
+    mGeometryInstanceTracker.init(mGeometryInstanceData, mSceneGraph.size());
     updateGeometryInstances(true);
 
     if (mpLightProfile) {
@@ -1685,9 +1686,10 @@ Scene::UpdateFlags Scene::update(RenderContext* pContext, double currentTime) {
         mUpdates |= UpdateFlags::SceneGraphChanged;
         if (mpAnimationController->hasSkinnedMeshes()) mUpdates |= UpdateFlags::MeshesChanged;
 
-        for (const auto& inst : mGeometryInstanceData) {
-            if (mpAnimationController->isMatrixChanged(inst.globalMatrixID)) {
+        for (uint32_t matrixID = 0; matrixID < (uint32_t)mGeometryInstanceTracker.getMatrixCount(); matrixID++) {
+            if (mpAnimationController->isMatrixChanged(matrixID) && mGeometryInstanceTracker.getInstanceCount(matrixID) > 0) {
                 mUpdates |= UpdateFlags::GeometryMoved;
+                break;
             }
         }
 
@@ -58,10 +58,12 @@
 
 #include "Falcor/Scene/Camera/CameraController.h"
 #include "Falcor/Scene/Lights/LightCollection.h"
+#include "Falcor/Scene/Lights/EmissiveIntegratorCPU.h"
 #include "Falcor/Scene/Lights/EnvMap.h"
 #include "Displacement/DisplacementUpdateTask.slang"
 #include "SceneTypes.slang"
 #include "Falcor/Scene/HitInfo.h"
+#include "Falcor/Scene/GeometryInstanceTracker.h"
 
 #include "Falcor/Scene/Material/MaterialSystem.h"
 
@@ -1211,6 +1213,7 @@ public:
 
     GeometryTypeFlags mGeometryTypes;                           ///< Set of geometry types that exist in the scene.
     std::vector<GeometryInstanceData> mGeometryInstanceData;    ///< Geometry instance data (for all types of geometry).
+    GeometryInstanceTracker mGeometryInstanceTracker;           ///< Matrix to instance mapping and dirty instance ranges for incremental uploads.
     std::vector<std::string> mGeometryInstanceNamesData;        ///< List of geometry instances names exported from DCC software.
 
     bool mUseCompressedHitInfo = false;                         ///< True if scene should used compressed HitInfo (on scenes with triangles meshes only).
@@ -1291,6 +1294,7 @@ public:
     std::vector<Grid::SharedPtr> mGrids;                        ///< All loaded volume grids.
     std::unordered_map<Grid::SharedPtr, uint32_t> mGridIDs;     ///< Lookup table for grid IDs.
     LightCollection::SharedPtr mpLightCollection;               ///< Class for managing emissive geometry. This is created lazily upon first use.
+    EmissiveIntegratorCPU::SharedPtr mpEmissiveIntegrator;      ///< Emissive triangle integration started at scene creation. Handed over to the light collection.
     EnvMap::SharedPtr mpEnvMap;                                 ///< Environment map or nullptr if not loaded.
     bool mEnvMapChanged = false;                                ///< Flag indicating that the environment map has changed since last frame.
     LightProfile::SharedPtr mpLightProfile;                     ///< Global light profile.
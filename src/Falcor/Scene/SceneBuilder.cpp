@@ -227,7 +227,7 @@ bool SceneBuilder::import(const std::string& filename, const InstanceMatrices& i
 Scene::SharedPtr SceneBuilder::getScene() {
     if (mpScene) return mpScene;
 
-    mAddGeoTasks.wait();
+    for (const auto& task : mAddGeoTasks) task.wait();
 
     // Finish loading textures. This blocks until all textures are loaded and assigned.
     mpMaterialTextureLoader.reset();
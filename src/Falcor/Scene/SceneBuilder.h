@@ -34,7 +34,7 @@
 #include <unordered_map>
 
 #include "Falcor/Utils/Scripting/Dictionary.h"
-#include "Falcor/Utils/ThreadPool.h"
+#include "Falcor/Utils/TaskScheduler.h"
 
 #include "Scene.h"
 #include "SceneCache.h"
@@ -793,7 +793,7 @@ protected:
     std::vector<MaterialX::SharedPtr> mMaterialXs;
     std::unordered_map<const Material*, uint32_t> mMaterialToId;
 
-    BS::multi_future<uint32_t> mAddGeoTasks;
+    std::vector<TaskScheduler::Future<uint32_t>> mAddGeoTasks;
 
 
     // Mesh helpers
@@ -41,7 +41,7 @@ namespace {
 /** Specfies the current cache file version.
     This needs to be incremented every time the file format changes!
 */
-const uint32_t kVersion = 14;
+const uint32_t kVersion = 15;
 
 /** Scene cache directory (subdirectory in the application data directory).
 */
@@ -711,7 +711,9 @@ void SceneCache::writeEnvMap(OutputStream& stream, const EnvMap::SharedPtr& pEnv
 EnvMap::SharedPtr SceneCache::readEnvMap(Device::SharedPtr pDevice, InputStream& stream) {
     auto filename = stream.read<std::string>();
     auto pEnvMap = EnvMap::create(pDevice, filename);
+    const float minLod = pEnvMap->mData.minLod;  // depends on the reloaded texture residency
     stream.read(pEnvMap->mData);
+    pEnvMap->mData.minLod = minLod;
     stream.read(pEnvMap->mRotation);
     return pEnvMap;
 }
@@ -98,6 +98,32 @@ namespace Falcor
         }
     }
 
+    Grid::SharedPtr Grid::createFromDenseData(Device::SharedPtr pDevice, const int3& resolution, const float* pData, const std::string& gridname)
+    {
+        if (!pData || resolution.x <= 0 || resolution.y <= 0 || resolution.z <= 0)
+        {
+            LLOG_ERR << "Error when creating grid '" << gridname << "'. Invalid dense data.";
+            return nullptr;
+        }
+
+        const size_t yStride = (size_t)resolution.x;
+        const size_t zStride = (size_t)resolution.x * (size_t)resolution.y;
+
+        nanovdb::GridBuilder<float> builder(0.f);
+        builder([&](const nanovdb::Coord& ijk) { return pData[ijk[0] + ijk[1] * yStride + ijk[2] * zStride]; },
+            nanovdb::CoordBBox(nanovdb::Coord(0), nanovdb::Coord(resolution.x - 1, resolution.y - 1, resolution.z - 1)));
+
+        auto handle = builder.getHandle(1.0, nanovdb::Vec3d(0.0), gridname, nanovdb::GridClass::FogVolume);
+        auto floatGrid = handle.grid<float>();
+        if (!floatGrid || floatGrid->isEmpty())
+        {
+            LLOG_WRN << "Grid '" << gridname << "' is empty.";
+            return nullptr;
+        }
+
+        return SharedPtr(new Grid(pDevice, std::move(handle)));
+    }
+
     void Grid::setShaderData(const ShaderVar& var)
     {
         var["buf"] = mpBuffer;
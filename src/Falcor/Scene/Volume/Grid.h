@@ -77,6 +77,16 @@ namespace Falcor
         */
         static SharedPtr createFromFile(Device::SharedPtr pDevice, const fs::path& path, const std::string& gridname);
 
+        /** Create a grid from dense voxel data.
+            Voxel (i, j, k) is stored at index i + j * resolution.x + k * resolution.x * resolution.y and is placed
+            at the same index-space position in the grid, using a unit voxel size. Voxels with value 0 are left inactive.
+            \param[in] resolution Number of voxels along each axis.
+            \param[in] pData Voxel values.
+            \param[in] gridname Name of the grid.
+            \return A new grid, or nullptr if the data has no active voxels.
+        */
+        static SharedPtr createFromDenseData(Device::SharedPtr pDevice, const int3& resolution, const float* pData, const std::string& gridname);
+
         /** Bind the grid to a given shader var.
             \param[in] var The shader variable to set the data into.
         */
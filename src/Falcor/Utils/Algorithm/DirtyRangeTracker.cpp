@@ -0,0 +1,85 @@
+/***************************************************************************
+ # Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include <algorithm>
+
+#include "DirtyRangeTracker.h"
+
+namespace Falcor {
+
+void DirtyRangeTracker::markDirty(uint32_t offset, uint32_t count) {
+    if (count == 0) return;
+
+    // Fast path for the common case of ascending marks: extend the last range in place.
+    if (!mRanges.empty()) {
+        Range& last = mRanges.back();
+        if (offset >= last.offset && offset <= last.end() + mMaxGap) {
+            last.count = std::max(last.end(), offset + count) - last.offset;
+            return;
+        }
+        mCoalesced = false;
+    }
+
+    mRanges.push_back({offset, count});
+}
+
+void DirtyRangeTracker::coalesce() {
+    if (mCoalesced) return;
+
+    std::sort(mRanges.begin(), mRanges.end(), [](const Range& a, const Range& b) { return a.offset < b.offset; });
+
+    size_t dst = 0;
+    for (size_t i = 1; i < mRanges.size(); i++) {
+        Range& current = mRanges[dst];
+        const Range& next = mRanges[i];
+        if (next.offset <= current.end() + mMaxGap) {
+            current.count = std::max(current.end(), next.end()) - current.offset;
+        } else {
+            mRanges[++dst] = next;
+        }
+    }
+    mRanges.resize(dst + 1);
+    mCoalesced = true;
+}
+
+const std::vector<DirtyRangeTracker::Range>& DirtyRangeTracker::getRanges() {
+    coalesce();
+    return mRanges;
+}
+
+uint64_t DirtyRangeTracker::getDirtyElementCount() {
+    uint64_t count = 0;
+    for (const auto& range : getRanges()) count += range.count;
+    return count;
+}
+
+void DirtyRangeTracker::clear() {
+    mRanges.clear();
+    mCoalesced = true;
+}
+
+}  // namespace Falcor
@@ -0,0 +1,93 @@
+/***************************************************************************
+ # Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#ifndef SRC_FALCOR_UTILS_ALGORITHM_DIRTYRANGETRACKER_H_
+#define SRC_FALCOR_UTILS_ALGORITHM_DIRTYRANGETRACKER_H_
+
+#include <vector>
+
+#include "Falcor/Core/Framework.h"
+
+namespace Falcor {
+
+/** Collects dirty element indices of an array and coalesces them into a minimal set of contiguous ranges.
+
+    Used to upload only the modified parts of a CPU-side array to its GPU buffer. Ranges separated by at most
+    maxGap clean elements are merged, trading a few redundant bytes for fewer copy commands.
+    This class does not touch the device and can be used (and tested) on the CPU only.
+*/
+class dlldecl DirtyRangeTracker {
+  public:
+    struct Range {
+        uint32_t offset = 0;    ///< First dirty element.
+        uint32_t count = 0;     ///< Number of elements.
+
+        uint32_t end() const { return offset + count; }
+        bool operator==(const Range& other) const { return offset == other.offset && count == other.count; }
+    };
+
+    /** Constructor.
+        \param[in] maxGap Maximum number of clean elements between two dirty ranges that still get merged into one.
+    */
+    DirtyRangeTracker(uint32_t maxGap = 0) : mMaxGap(maxGap) {}
+
+    void setMaxGap(uint32_t maxGap) { mMaxGap = maxGap; }
+    uint32_t getMaxGap() const { return mMaxGap; }
+
+    /** Mark a single element dirty.
+    */
+    void markDirty(uint32_t index) { markDirty(index, 1); }
+
+    /** Mark a range of elements dirty. Ranges may be marked in any order and may overlap.
+    */
+    void markDirty(uint32_t offset, uint32_t count);
+
+    /** Check if anything was marked dirty since the last clear().
+    */
+    bool isDirty() const { return !mRanges.empty(); }
+
+    /** Get sorted, non-overlapping ranges covering all dirty elements.
+    */
+    const std::vector<Range>& getRanges();
+
+    /** Get the total number of elements covered by the coalesced ranges.
+    */
+    uint64_t getDirtyElementCount();
+
+    void clear();
+
+  private:
+    void coalesce();
+
+    std::vector<Range> mRanges;
+    uint32_t mMaxGap = 0;
+    bool mCoalesced = true;
+};
+
+}  // namespace Falcor
+
+#endif  // SRC_FALCOR_UTILS_ALGORITHM_DIRTYRANGETRACKER_H_
@@ -0,0 +1,152 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include <algorithm>
+
+#include "SparseBindBatcher.h"
+
+namespace Falcor {
+
+namespace {
+
+bool isSameImageBindTarget(const VkSparseImageMemoryBind& a, const VkSparseImageMemoryBind& b) {
+	return a.subresource.aspectMask == b.subresource.aspectMask && a.subresource.mipLevel == b.subresource.mipLevel && 
+		a.subresource.arrayLayer == b.subresource.arrayLayer && a.offset.x == b.offset.x && a.offset.y == b.offset.y && a.offset.z == b.offset.z;
+}
+
+bool imageBindTargetLess(const VkSparseImageMemoryBind& a, const VkSparseImageMemoryBind& b) {
+	if (a.subresource.aspectMask != b.subresource.aspectMask) return a.subresource.aspectMask < b.subresource.aspectMask;
+	if (a.subresource.arrayLayer != b.subresource.arrayLayer) return a.subresource.arrayLayer < b.subresource.arrayLayer;
+	if (a.subresource.mipLevel != b.subresource.mipLevel) return a.subresource.mipLevel < b.subresource.mipLevel;
+	if (a.offset.z != b.offset.z) return a.offset.z < b.offset.z;
+	if (a.offset.y != b.offset.y) return a.offset.y < b.offset.y;
+	return a.offset.x < b.offset.x;
+}
+
+}  // namespace
+
+void SparseBindBatcher::addImageBinds(VkImage image, const std::vector<VkSparseImageMemoryBind>& imageBinds, const std::vector<VkSparseMemoryBind>& opaqueBinds) {
+	if (image == VK_NULL_HANDLE || (imageBinds.empty() && opaqueBinds.empty())) return;
+
+	auto it = std::find_if(mImageEntries.begin(), mImageEntries.end(), [image](const ImageEntry& entry) { return entry.image == image; });
+	if (it == mImageEntries.end()) {
+		mImageEntries.push_back({});
+		it = std::prev(mImageEntries.end());
+		it->image = image;
+	}
+
+	it->imageBinds.insert(it->imageBinds.end(), imageBinds.begin(), imageBinds.end());
+	it->opaqueBinds.insert(it->opaqueBinds.end(), opaqueBinds.begin(), opaqueBinds.end());
+
+	// Collapse binds with the same target. Stable sort keeps insertion order within equal targets, so the last one wins
+	auto& binds = it->imageBinds;
+	std::stable_sort(binds.begin(), binds.end(), imageBindTargetLess);
+	auto dst = binds.begin();
+	for (auto src = binds.begin(); src != binds.end(); ++src) {
+		auto next = std::next(src);
+		if (next != binds.end() && isSameImageBindTarget(*src, *next)) continue;
+		*dst++ = *src;
+	}
+	binds.erase(dst, binds.end());
+
+	// Same for opaque (mip tail) binds targeting the same resource range
+	auto& opaque = it->opaqueBinds;
+	std::stable_sort(opaque.begin(), opaque.end(), [](const VkSparseMemoryBind& a, const VkSparseMemoryBind& b) { return a.resourceOffset < b.resourceOffset; });
+	auto opaqueDst = opaque.begin();
+	for (auto src = opaque.begin(); src != opaque.end(); ++src) {
+		auto next = std::next(src);
+		if (next != opaque.end() && next->resourceOffset == src->resourceOffset) continue;
+		*opaqueDst++ = *src;
+	}
+	opaque.erase(opaqueDst, opaque.end());
+}
+
+const VkBindSparseInfo& SparseBindBatcher::getBindSparseInfo(VkSemaphore signalSemaphore, uint64_t signalValue) {
+	mImageBindInfos.clear();
+	mOpaqueBindInfos.clear();
+
+	for (const auto& entry: mImageEntries) {
+		if (!entry.imageBinds.empty()) {
+			VkSparseImageMemoryBindInfo bindInfo = {};
+			bindInfo.image = entry.image;
+			bindInfo.bindCount = static_cast<uint32_t>(entry.imageBinds.size());
+			bindInfo.pBinds = entry.imageBinds.data();
+			mImageBindInfos.push_back(bindInfo);
+		}
+		if (!entry.opaqueBinds.empty()) {
+			VkSparseImageOpaqueMemoryBindInfo bindInfo = {};
+			bindInfo.image = entry.image;
+			bindInfo.bindCount = static_cast<uint32_t>(entry.opaqueBinds.size());
+			bindInfo.pBinds = entry.opaqueBinds.data();
+			mOpaqueBindInfos.push_back(bindInfo);
+		}
+	}
+
+	mBindSparseInfo = {};
+	mBindSparseInfo.sType = VK_STRUCTURE_TYPE_BIND_SPARSE_INFO;
+	mBindSparseInfo.imageBindCount = static_cast<uint32_t>(mImageBindInfos.size());
+	mBindSparseInfo.pImageBinds = mImageBindInfos.data();
+	mBindSparseInfo.imageOpaqueBindCount = static_cast<uint32_t>(mOpaqueBindInfos.size());
+	mBindSparseInfo.pImageOpaqueBinds = mOpaqueBindInfos.data();
+
+	if (signalSemaphore != VK_NULL_HANDLE) {
+		mSignalSemaphore = signalSemaphore;
+		mSignalValue = signalValue;
+
+		mTimelineSubmitInfo = {};
+		mTimelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		mTimelineSubmitInfo.signalSemaphoreValueCount = 1;
+		mTimelineSubmitInfo.pSignalSemaphoreValues = &mSignalValue;
+
+		mBindSparseInfo.pNext = &mTimelineSubmitInfo;
+		mBindSparseInfo.signalSemaphoreCount = 1;
+		mBindSparseInfo.pSignalSemaphores = &mSignalSemaphore;
+	}
+
+	return mBindSparseInfo;
+}
+
+void SparseBindBatcher::clear() {
+	mImageEntries.clear();
+	mImageBindInfos.clear();
+	mOpaqueBindInfos.clear();
+	mBindSparseInfo = {};
+}
+
+size_t SparseBindBatcher::imageBindCount() const {
+	size_t count = 0;
+	for (const auto& entry: mImageEntries) count += entry.imageBinds.size();
+	return count;
+}
+
+size_t SparseBindBatcher::opaqueBindCount() const {
+	size_t count = 0;
+	for (const auto& entry: mImageEntries) count += entry.opaqueBinds.size();
+	return count;
+}
+
+}  // namespace Falcor
@@ -0,0 +1,85 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#ifndef SRC_FALCOR_UTILS_IMAGE_SPARSEBINDBATCHER_H_
+#define SRC_FALCOR_UTILS_IMAGE_SPARSEBINDBATCHER_H_
+
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "Falcor/Core/Framework.h"
+
+namespace Falcor {
+
+/** Collects sparse memory binds of many images and turns them into a single VkBindSparseInfo.
+
+	Binds of the same image added more than once are merged. Image binds targeting the same
+	subresource and offset (and opaque binds with the same resource offset) are collapsed to the most recently added one. The resulting bind info
+	optionally signals a timeline semaphore, so the whole residency update is one queue submission.
+
+	This class does not touch the device and can be used (and tested) on the CPU only.
+*/
+class dlldecl SparseBindBatcher {
+public:
+	/** Add sparse binds of an image.
+	*/
+	void addImageBinds(VkImage image, const std::vector<VkSparseImageMemoryBind>& imageBinds, const std::vector<VkSparseMemoryBind>& opaqueBinds = {});
+
+	/** Build bind info referencing the collected binds. Returned structure stays valid until the next addImageBinds() or clear() call.
+		\param[in] signalSemaphore Timeline semaphore to signal or VK_NULL_HANDLE.
+		\param[in] signalValue Timeline semaphore value to signal.
+	*/
+	const VkBindSparseInfo& getBindSparseInfo(VkSemaphore signalSemaphore = VK_NULL_HANDLE, uint64_t signalValue = 0);
+
+	void clear();
+
+	bool empty() const { return mImageEntries.empty(); }
+	size_t imageCount() const { return mImageEntries.size(); }
+	size_t imageBindCount() const;
+	size_t opaqueBindCount() const;
+
+private:
+	struct ImageEntry {
+		VkImage image = VK_NULL_HANDLE;
+		std::vector<VkSparseImageMemoryBind> imageBinds;
+		std::vector<VkSparseMemoryBind> opaqueBinds;
+	};
+
+	std::vector<ImageEntry> mImageEntries;
+
+	std::vector<VkSparseImageMemoryBindInfo> mImageBindInfos;
+	std::vector<VkSparseImageOpaqueMemoryBindInfo> mOpaqueBindInfos;
+	VkTimelineSemaphoreSubmitInfo mTimelineSubmitInfo = {};
+	VkSemaphore mSignalSemaphore = VK_NULL_HANDLE;
+	uint64_t mSignalValue = 0;
+	VkBindSparseInfo mBindSparseInfo = {};
+};
+
+}  // namespace Falcor
+
+#endif  // SRC_FALCOR_UTILS_IMAGE_SPARSEBINDBATCHER_H_
@@ -40,6 +40,7 @@
 #include "Falcor/Utils/StringUtils.h"
 #include "Falcor/Utils/ConfigStore.h"
 #include "Falcor/Utils/Image/LTX_Bitmap.h"
+#include "Falcor/Utils/Timing/TraceRecorder.h"
 
 #include "Scene/Material/TextureHandle.slang"
 
@@ -286,125 +287,142 @@ Texture::SharedPtr TextureManager::loadSparseTexture(const fs::path& path, bool
 }
 
 void TextureManager::loadPages(const Texture::SharedPtr& pTexture, const std::vector<uint32_t>& pageIds) {
-	if(!mHasSparseTextures || !pTexture || !pTexture->isSparse()) return;
+	loadPages({std::make_pair(pTexture, pageIds)});
+}
 
-  assert(pTexture.get());
-  if(!pTexture) return;
+void TextureManager::loadPages(const std::vector<std::pair<Texture::SharedPtr, std::vector<uint32_t>>>& texturesToPageIDsList) {
+	if(!mHasSparseTextures) return;
+	TRACE_SCOPE("LTX load pages");
 
-  uint32_t textureID = pTexture->id();
+	struct TexturePages {
+		Texture* pTexture;
+		LTX_Bitmap::SharedConstPtr pLtxBitmap;
+		std::vector<uint32_t> pageIds;
+		bool allocationChanged;
+	};
 
-  auto it = mTextureLTXBitmapsMap.find(textureID);
-  if (it == mTextureLTXBitmapsMap.end()) {
-    LLOG_ERR << "No LTX_Bitmap stored for texture " <<  pTexture->getSourceFilename();
-    return;
-  }
+	std::vector<TexturePages> texturesPages;
+	texturesPages.reserve(texturesToPageIDsList.size());
 
-  auto pLtxBitmap = mTextureLTXBitmapsMap[textureID];
-  auto pContext = pTexture->device()->getRenderContext();
+	for(const auto& textureToPagesPair: texturesToPageIDsList) {
+		const auto& pTexture = textureToPagesPair.first;
+		if(!pTexture || !pTexture->isSparse()) continue;
 
-  std::vector<uint32_t> _pageIds = pageIds;
-  std::sort(_pageIds.begin(), _pageIds.end());
+		auto it = mTextureLTXBitmapsMap.find(pTexture->id());
+		if (it == mTextureLTXBitmapsMap.end()) {
+			LLOG_ERR << "No LTX_Bitmap stored for texture " <<  pTexture->getSourceFilename();
+			continue;
+		}
 
-  // read data and fill pages
-  std::string ltxFilename = pLtxBitmap->getFileName();
-  auto pFile = fopen(ltxFilename.c_str(), "rb");
-  
-  std::array<uint8_t, kLtxPageSize> tmpPage;
-  auto pTmpPageData = tmpPage.data();
+		TexturePages texturePages = {pTexture.get(), it->second, textureToPagesPair.second, false};
+		std::sort(texturePages.pageIds.begin(), texturePages.pageIds.end());
+		texturesPages.push_back(std::move(texturePages));
+	}
 
-  std::array<uint8_t, kLtxPageSize> scratchBuffer;
-  auto pScratchBufferData = scratchBuffer.data();
+	if(texturesPages.empty()) return;
 
-  bool loadTailData = true; // always load texture tail data
-  bool allocationChanged = false;
+	// Allocate pages memory of all textures and bind it with a single sparse binding submission. Rendering waits for it on the
+	// timeline fence, so there is no host side wait
+	bool allocationChanged = false;
+	for(auto& texturePages: texturesPages) {
+		const auto& pages = texturePages.pTexture->sparseDataPages();
 
-  const auto& texturePages = pTexture->sparseDataPages();
+		for(uint32_t pageIndex: texturePages.pageIds) {
+			if(pageIndex >= pages.size()) {
+				LLOG_ERR << "Page index " << std::to_string(pageIndex) << " exceeds number of texturePages " << std::to_string(pages.size());
+				continue;
+			}
 
-  for( uint32_t pageIndex: _pageIds ) {
-  	if(pageIndex >= texturePages.size()) {
-			LLOG_ERR << "Page index " << std::to_string(pageIndex) << " exceeds number of texturePages " << std::to_string(texturePages.size());
-			continue;
+			const auto& pPage = pages[pageIndex];
+			if(pPage->mipLevel() >= texturePages.pTexture->getMipTailStart()) continue;
+			if(pPage->allocate()) texturePages.allocationChanged = true;
 		}
 
-    const auto& pPage = texturePages[pageIndex];
-    if(pPage->mipLevel() >= pTexture->getMipTailStart()) continue;
-    if(pPage->allocate()) allocationChanged = true;
-  }
+		if(texturePages.allocationChanged) {
+			texturePages.pTexture->updateSparseBindInfo();
+			mSparseBindBatcher.addImageBinds(texturePages.pTexture->mImage, texturePages.pTexture->mSparseImageMemoryBinds, texturePages.pTexture->mOpaqueMemoryBinds);
+			allocationChanged = true;
+		}
+	}
 
+	if(allocationChanged) submitSparseBinds();
 
-  if(allocationChanged) {
-	  {
-	  	auto pRendererBase = static_cast<gfx::RendererBase*>(mpDevice->getApiHandle().get());
-			auto pDevice = static_cast<gfx::vk::DeviceImpl*>(pRendererBase);
-			auto& vk_api = pDevice->vkAPI();
-			VkDevice device = pDevice->vkDevice();
-			VkQueue  queue = pDevice->vkQueue();
-	  	vk_api.vkDeviceWaitIdle(device);
-
-		  pTexture->updateSparseBindInfo();
-		  
-		  VkFenceCreateInfo fenceCreateInfo {};
-			fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-			fenceCreateInfo.flags = 0;//VK_FLAGS_NONE;
-
-			VkFence fence;
-			vk_api.vkCreateFence(device, &fenceCreateInfo, nullptr, &fence);
-			vk_api.vkQueueBindSparse(queue, 1, &pTexture->mBindSparseInfo, fence);
-			vk_api.vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX);
-			vk_api.vkDestroyFence(device, fence, nullptr);
-		}
+	std::array<uint8_t, kLtxPageSize> tmpPage;
+	auto pTmpPageData = tmpPage.data();
 
-		auto oldState = pTexture->getGlobalState();
-		const bool state_changed = pContext->resourceBarrier(pTexture.get(), Resource::State::CopyDest);
+	std::array<uint8_t, kLtxPageSize> scratchBuffer;
+	auto pScratchBufferData = scratchBuffer.data();
 
-		for( uint32_t pageIndex: _pageIds ) {
-	  	if(pageIndex >= texturePages.size()) {
-				LLOG_ERR << "Page index " << std::to_string(pageIndex) << " exceeds number of texturePages " << std::to_string(texturePages.size());
-				continue;
-			}
+	bool loadTailData = true; // always load texture tail data
 
-	    const auto& pPage = texturePages[pageIndex];
-	    if(pPage->mipLevel() >= pTexture->getMipTailStart()) continue;
+	auto pContext = mpDevice->getRenderContext();
 
-	    if(pLtxBitmap->readPageData(pageIndex, pTmpPageData, pFile, pScratchBufferData)) {	
-	    	// Load non-tail texture data page
-	    	pContext->updateTexturePage(pPage.get(), pTmpPageData);
-	    	
-	    	LLOG_TRC << "Loaded page mip level " << std::to_string(pPage->mipLevel());
-	  	} else {
-	  		LLOG_ERR << "Error updating texture page " << std::to_string(pPage->index());
-	  	}
-	  }
+	for(const auto& texturePages: texturesPages) {
+		Texture* pTexture = texturePages.pTexture;
+		const auto& pLtxBitmap = texturePages.pLtxBitmap;
+		const auto& pages = pTexture->sparseDataPages();
 
-	  pContext->resourceBarrier(pTexture.get(), oldState);
-	}
+		std::string ltxFilename = pLtxBitmap->getFileName();
+		auto pFile = fopen(ltxFilename.c_str(), "rb");
+
+		// Page copies are batched by the context and recorded (with proper texture barriers) on flush
+		for(uint32_t pageIndex: texturePages.pageIds) {
+			if(!texturePages.allocationChanged || pageIndex >= pages.size()) continue;
+
+			const auto& pPage = pages[pageIndex];
+			if(pPage->mipLevel() >= pTexture->getMipTailStart()) continue;
 
-  if(loadTailData || pageIds.empty()) {
-		LLOG_TRC << "Loading tail data for texture " << ltxFilename;
-		std::vector<uint8_t> tailData(kLtxPageSize);
-		pLtxBitmap->readTailData(pFile, tailData, pScratchBufferData);
-		LLOG_TRC << "Loaded " << tailData.size() << " bytes of tail data for " << ltxFilename;
-		if(!tailData.empty()) {
-			auto oldState = pTexture->getGlobalState();
-			const bool state_changed = pContext->resourceBarrier(pTexture.get(), Resource::State::CopyDest);
-			pContext->fillMipTail(pTexture.get(), tailData.data(), is_set(pLtxBitmap->getFlags(), LTX_Header::Flags::ONE_PAGE_MIP_TAIL));
-			pContext->resourceBarrier(pTexture.get(), oldState);
+			if(pLtxBitmap->readPageData(pageIndex, pTmpPageData, pFile, pScratchBufferData)) {
+				// Load non-tail texture data page
+				pContext->updateTexturePage(pPage.get(), pTmpPageData);
+
+				LLOG_TRC << "Loaded page mip level " << std::to_string(pPage->mipLevel());
+			} else {
+				LLOG_ERR << "Error updating texture page " << std::to_string(pPage->index());
+			}
 		}
+
+		if(loadTailData || texturePages.pageIds.empty()) {
+			LLOG_TRC << "Loading tail data for texture " << ltxFilename;
+			std::vector<uint8_t> tailData(kLtxPageSize);
+			pLtxBitmap->readTailData(pFile, tailData, pScratchBufferData);
+			LLOG_TRC << "Loaded " << tailData.size() << " bytes of tail data for " << ltxFilename;
+			if(!tailData.empty()) {
+				auto oldState = pTexture->getGlobalState();
+				pContext->resourceBarrier(pTexture, Resource::State::CopyDest);
+				pContext->fillMipTail(pTexture, tailData.data(), is_set(pLtxBitmap->getFlags(), LTX_Header::Flags::ONE_PAGE_MIP_TAIL));
+				pContext->resourceBarrier(pTexture, oldState);
+			}
+		}
+
+		fclose(pFile);
 	}
 
+	// Single flush for all the textures
 	pContext->flush(true);
-
-  fclose(pFile);
 }
 
 
+void TextureManager::loadMipLevels(const Texture::SharedPtr& pTexture, uint32_t mostDetailedMip) {
+	if(!pTexture || !pTexture->isSparse()) return;
+
+	std::vector<uint32_t> pageIds;
+	const auto& texturePages = pTexture->sparseDataPages();
+	for(uint32_t pageIndex = 0; pageIndex < texturePages.size(); pageIndex++) {
+		if(texturePages[pageIndex]->mipLevel() >= mostDetailedMip) pageIds.push_back(pageIndex);
+	}
+
+	loadPages(pTexture, pageIds);
+}
+
 void TextureManager::loadPagesAsync(const std::vector<std::pair<Texture::SharedPtr, std::vector<uint32_t>>>& texturesToPageIDsList) {
 	if(!mHasSparseTextures) return;
+	TRACE_SCOPE("TextureManager::loadPagesAsync");
 
 	bool loadTailData = true; // always load texture tail data
 
-	ThreadPool& pool = ThreadPool::instance();
-	BS::multi_future<Texture*> texturePagesLoadingTasks;
+	TaskScheduler& scheduler = TaskScheduler::instance();
+	std::vector<TaskScheduler::Future<Texture*>> texturePagesLoadingTasks;
 
 
 	for(auto& textureToPagesPair: std::move(texturesToPageIDsList)) {
@@ -424,9 +442,10 @@ void TextureManager::loadPagesAsync(const std::vector<std::pair<Texture::SharedP
 
 	  auto pLtxBitmap = mTextureLTXBitmapsMap[textureID];
 
-		// Push pages loading job into ThreadPool
-		texturePagesLoadingTasks.push_back(pool.submit([this, pLtxBitmap, pTexture = pTexture.get(), pageIds = textureToPagesPair.second, pContext, loadTailData] {
+		// Push pages loading job into scheduler IO lane. Frame rendering waits on these so they go first
+		texturePagesLoadingTasks.push_back(scheduler.submit([this, pLtxBitmap, pTexture = pTexture.get(), pageIds = textureToPagesPair.second, pContext, loadTailData] {
 	  	if(!pTexture || pageIds.empty()) return (Texture*)nullptr;
+	  	TRACE_SCOPE("LTX load pages");
 
 	  	std::unique_lock<std::mutex> texture_lock(pTexture->getMutex());
 
@@ -478,12 +497,12 @@ void TextureManager::loadPagesAsync(const std::vector<std::pair<Texture::SharedP
 
 			fclose(pFile);
 	    return pTexture;
-	  }));
+	  }, TaskScheduler::Lane::IO, TaskScheduler::Priority::High));
 	}
 
 	std::set<Texture*> pTextures;
 
-	// Join texture pages data loading tasks
+	// Join texture pages data loading tasks. Tasks not started yet are loaded by this thread
 	for(size_t i = 0; i < texturePagesLoadingTasks.size(); i++) {
 		Texture* pTexture = texturePagesLoadingTasks[i].get();
 		if(pTexture) pTextures.insert(pTexture);
@@ -499,39 +518,20 @@ void TextureManager::loadPagesAsync(const std::vector<std::pair<Texture::SharedP
   	}
   }
 
+	// Bind memory of all touched textures at once
 	for(Texture* pTexture: pTextures) {
 	  pTexture->updateSparseBindInfo();
-	  VkFenceCreateInfo fenceCreateInfo {};
-		fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-		fenceCreateInfo.flags = 0;//VK_FLAGS_NONE;
-  	VkFence fence;
-
-		auto pRendererBase = static_cast<gfx::RendererBase*>(mpDevice->getApiHandle().get());
-		auto pDevice = static_cast<gfx::vk::DeviceImpl*>(pRendererBase);
-		auto& vk_api = pDevice->vkAPI();
-		VkDevice device = pDevice->vkDevice();
-		VkQueue  queue = pDevice->vkQueue();
-
-		vk_api.vkCreateFence(device, &fenceCreateInfo, nullptr, &fence);
-		vk_api.vkQueueBindSparse(queue, 1, &pTexture->mBindSparseInfo, fence);
-		vk_api.vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX);
-		vk_api.vkDestroyFence(device, fence, nullptr);
+	  mSparseBindBatcher.addImageBinds(pTexture->mImage, pTexture->mSparseImageMemoryBinds, pTexture->mOpaqueMemoryBinds);
 	}
+	submitSparseBinds();
 
 	// Load texture pages data to GPU
   for(auto& simpleCachePageItem: mSimplePagesDataCache) {
   	auto& pPage = simpleCachePageItem.first;
   	if(!pPage) continue;
 
-  	auto pTexture = pPage->texture().get();
-  	auto pContext = pTexture->device()->getRenderContext();
-
-  	auto oldState = pTexture->getGlobalState();
-		const bool state_changed = pContext->resourceBarrier(pTexture, Resource::State::CopyDest);
-
-  	pContext->updateTexturePage(pPage, simpleCachePageItem.second.data());
-  	
-  	if(state_changed) pContext->resourceBarrier(pTexture, oldState);
+  	// Pages are packed into the context staging ring and copied with one region list per texture on flush
+  	mpDevice->getRenderContext()->updateTexturePage(pPage, simpleCachePageItem.second.data());
   }
 
   // Load texture tail data to GPU
@@ -544,10 +544,34 @@ void TextureManager::loadPagesAsync(const std::vector<std::pair<Texture::SharedP
     pContext->fillMipTail(pTexture, simpleTailCacheItem.second.data(), is_set(pLtxBitmap->getFlags(), LTX_Header::Flags::ONE_PAGE_MIP_TAIL));
   }
 
-  for(Texture* pTexture: pTextures) {
-  	auto pContext = pTexture->device()->getRenderContext();
-		pContext->flush(true);
-  }
+  if(!pTextures.empty()) mpDevice->getRenderContext()->flush(true);
+}
+
+void TextureManager::submitSparseBinds() {
+	if(mSparseBindBatcher.empty()) return;
+
+	if(!mpSparseBindFence) mpSparseBindFence = GpuFence::create(mpDevice);
+
+	gfx::InteropHandle semaphoreHandle = {};
+	if(SLANG_FAILED(mpSparseBindFence->getApiHandle()->getNativeHandle(&semaphoreHandle))) {
+		LLOG_ERR << "Unable to get sparse binding timeline semaphore !!!";
+		mSparseBindBatcher.clear();
+		return;
+	}
+
+	auto pRendererBase = static_cast<gfx::RendererBase*>(mpDevice->getApiHandle().get());
+	auto pDevice = static_cast<gfx::vk::DeviceImpl*>(pRendererBase);
+
+	LLOG_DBG << "Sparse binding " << std::to_string(mSparseBindBatcher.imageBindCount()) << " pages of " << std::to_string(mSparseBindBatcher.imageCount()) << " textures";
+
+	const uint64_t signalValue = mpSparseBindFence->externalSignal();
+	const auto& bindSparseInfo = mSparseBindBatcher.getBindSparseInfo((VkSemaphore)semaphoreHandle.handleValue, signalValue);
+	pDevice->vkAPI().vkQueueBindSparse(pDevice->vkQueue(), 1, &bindSparseInfo, VK_NULL_HANDLE);
+
+	// Subsequent render context submissions wait for the binding on device, no host side wait
+	mpSparseBindFence->syncGpu(mpDevice->getRenderContext()->getLowLevelData()->getCommandQueue());
+
+	mSparseBindBatcher.clear();
 }
 
 void TextureManager::updateSparseBindInfo() {
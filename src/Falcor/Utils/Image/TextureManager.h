@@ -28,11 +28,13 @@
 #ifndef SRC_FALCOR_UTILS_IMAGE_TEXTUREMANAGER_H_
 #define SRC_FALCOR_UTILS_IMAGE_TEXTUREMANAGER_H_
 
+#include "Falcor/Core/API/GpuFence.h"
 #include "Falcor/Core/Program/ShaderVar.h"
 #include "Falcor/Utils/Image/LTX_Bitmap.h"
-#include "Falcor/Utils/ThreadPool.h"
+#include "Falcor/Utils/TaskScheduler.h"
 
 #include "TextureDataCacheLRU.h"
+#include "SparseBindBatcher.h"
 #include "AsyncTextureLoader.h"
 
 #include "Scene/Material/VirtualTextureData.slang"
@@ -206,8 +208,20 @@ public:
 	void finalize();
 
 	void loadPages(const Texture::SharedPtr& pTexture, const std::vector<uint32_t>& pageIds);
+
+	/** Load pages of multiple sparse textures. Memory of all the textures is bound with a single sparse binding submission
+		and page data is uploaded with a single render context flush.
+	*/
+	void loadPages(const std::vector<std::pair<Texture::SharedPtr, std::vector<uint32_t>>>& texturesToPageIDsList);
 	void loadPagesAsync(const std::vector<std::pair<Texture::SharedPtr, std::vector<uint32_t>>>& texturesToPageIDsList);
 
+	/** Make all pages of a sparse texture resident from the given mip level down to the mip tail.
+		Used for textures sampled outside of the sparse texture resolve pass (e.g. environment maps).
+		\param[in] pTexture Sparse texture.
+		\param[in] mostDetailedMip Most detailed mip level to load.
+	*/
+	void loadMipLevels(const Texture::SharedPtr& pTexture, uint32_t mostDetailedMip);
+
 	void updateSparseBindInfo();
 
 	bool getTextureHandle(const Texture* pTexture, TextureHandle& handle) const;
@@ -226,6 +240,10 @@ private:
 	*/
 	void buildSparseResidencyData();
 
+	/** Submits all collected sparse memory binds in a single queue operation.
+	*/
+	void submitSparseBinds();
+
 	/** Key to uniquely identify a managed texture.
 	*/
 	struct TextureKey {
@@ -263,7 +281,7 @@ private:
 	std::condition_variable mCondition;                         ///< Condition variable to wait on for loading to finish.
 
 	// Internal state. Do not access outside of critical section.
-	BS::multi_future<Texture*> mTextureLoadingTasks;
+	std::vector<TaskScheduler::Future<Texture*>> mTextureLoadingTasks;
 
 	std::vector<TextureDesc> mTextureDescs;                     ///< Array of all texture descs, indexed by handle ID.
 	std::vector<TextureHandle> mFreeList;                       ///< List of unused handles.
@@ -281,6 +299,9 @@ private:
 
 	Buffer::SharedPtr mpUDIMTextureTilesTableBuffer;
 
+	SparseBindBatcher mSparseBindBatcher;
+	GpuFence::SharedPtr mpSparseBindFence;                      ///< Timeline semaphore signaled by sparse binding and waited by rendering.
+
 	bool mSparseTexturesEnabled = false;
 	bool mHasSparseTextures = false;
 	bool mHasUDIMTextures = false;
@@ -0,0 +1,136 @@
+/***************************************************************************
+ # Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MatrixSIMD.h"
+#include "glm/matrix.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FALCOR_MATRIX_SIMD 1
+#include <emmintrin.h>
+#endif
+
+// Note: this file is built with -ffp-contract=off (see CMakeLists.txt), otherwise the multiply/add pairs below may be
+// fused into FMAs and no longer match glm.
+
+namespace Falcor
+{
+#ifdef FALCOR_MATRIX_SIMD
+    namespace detail
+    {
+        template<int P, int Q>
+        inline __m128 inverseFactor(__m128 c1, __m128 c2, __m128 c3)
+        {
+            // (c2[P] * c3[Q] - c3[P] * c2[Q], <same>, c1[P] * c3[Q] - c3[P] * c1[Q], c1[P] * c2[Q] - c2[P] * c1[Q])
+            const __m128 a = _mm_shuffle_ps(c2, c1, _MM_SHUFFLE(P, P, P, P));
+            const __m128 d = _mm_shuffle_ps(c2, c1, _MM_SHUFFLE(Q, Q, Q, Q));
+            const __m128 tq = _mm_shuffle_ps(c3, c2, _MM_SHUFFLE(Q, Q, Q, Q));
+            const __m128 tp = _mm_shuffle_ps(c3, c2, _MM_SHUFFLE(P, P, P, P));
+            const __m128 b = _mm_shuffle_ps(tq, tq, _MM_SHUFFLE(2, 0, 0, 0));
+            const __m128 c = _mm_shuffle_ps(tp, tp, _MM_SHUFFLE(2, 0, 0, 0));
+            return _mm_sub_ps(_mm_mul_ps(a, b), _mm_mul_ps(c, d));
+        }
+
+        template<int R>
+        inline __m128 inverseVec(__m128 c0, __m128 c1)
+        {
+            // (c1[R], c0[R], c0[R], c0[R])
+            const __m128 t = _mm_shuffle_ps(c1, c0, _MM_SHUFFLE(R, R, R, R));
+            return _mm_shuffle_ps(t, t, _MM_SHUFFLE(2, 2, 2, 0));
+        }
+
+        inline void inverseColumns(const glm::mat4& m, __m128 out[4])
+        {
+            const __m128 c0 = _mm_loadu_ps(&m[0][0]);
+            const __m128 c1 = _mm_loadu_ps(&m[1][0]);
+            const __m128 c2 = _mm_loadu_ps(&m[2][0]);
+            const __m128 c3 = _mm_loadu_ps(&m[3][0]);
+
+            const __m128 fac0 = inverseFactor<2, 3>(c1, c2, c3);
+            const __m128 fac1 = inverseFactor<1, 3>(c1, c2, c3);
+            const __m128 fac2 = inverseFactor<1, 2>(c1, c2, c3);
+            const __m128 fac3 = inverseFactor<0, 3>(c1, c2, c3);
+            const __m128 fac4 = inverseFactor<0, 2>(c1, c2, c3);
+            const __m128 fac5 = inverseFactor<0, 1>(c1, c2, c3);
+
+            const __m128 vec0 = inverseVec<0>(c0, c1);
+            const __m128 vec1 = inverseVec<1>(c0, c1);
+            const __m128 vec2 = inverseVec<2>(c0, c1);
+            const __m128 vec3 = inverseVec<3>(c0, c1);
+
+            const __m128 signA = _mm_set_ps(-1.f, 1.f, -1.f, 1.f);
+            const __m128 signB = _mm_set_ps(1.f, -1.f, 1.f, -1.f);
+
+            const __m128 inv0 = _mm_mul_ps(_mm_add_ps(_mm_sub_ps(_mm_mul_ps(vec1, fac0), _mm_mul_ps(vec2, fac1)), _mm_mul_ps(vec3, fac2)), signA);
+            const __m128 inv1 = _mm_mul_ps(_mm_add_ps(_mm_sub_ps(_mm_mul_ps(vec0, fac0), _mm_mul_ps(vec2, fac3)), _mm_mul_ps(vec3, fac4)), signB);
+            const __m128 inv2 = _mm_mul_ps(_mm_add_ps(_mm_sub_ps(_mm_mul_ps(vec0, fac1), _mm_mul_ps(vec1, fac3)), _mm_mul_ps(vec3, fac5)), signA);
+            const __m128 inv3 = _mm_mul_ps(_mm_add_ps(_mm_sub_ps(_mm_mul_ps(vec0, fac2), _mm_mul_ps(vec1, fac4)), _mm_mul_ps(vec2, fac5)), signB);
+
+            const __m128 row0 = _mm_shuffle_ps(_mm_shuffle_ps(inv0, inv1, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(inv2, inv3, _MM_SHUFFLE(0, 0, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+
+            alignas(16) float dot0[4];
+            _mm_store_ps(dot0, _mm_mul_ps(c0, row0));
+            const float dot1 = (dot0[0] + dot0[1]) + (dot0[2] + dot0[3]);
+            const __m128 oneOverDeterminant = _mm_set1_ps(1.f / dot1);
+
+            out[0] = _mm_mul_ps(inv0, oneOverDeterminant);
+            out[1] = _mm_mul_ps(inv1, oneOverDeterminant);
+            out[2] = _mm_mul_ps(inv2, oneOverDeterminant);
+            out[3] = _mm_mul_ps(inv3, oneOverDeterminant);
+        }
+    }
+#endif
+
+    glm::mat4 inverseSIMD(const glm::mat4& m)
+    {
+#ifdef FALCOR_MATRIX_SIMD
+        __m128 cols[4];
+        detail::inverseColumns(m, cols);
+
+        glm::mat4 result;
+        for (int i = 0; i < 4; i++) _mm_storeu_ps(&result[i][0], cols[i]);
+        return result;
+#else
+        return glm::inverse(m);
+#endif
+    }
+
+    glm::mat4 inverseTransposeSIMD(const glm::mat4& m)
+    {
+#ifdef FALCOR_MATRIX_SIMD
+        __m128 cols[4];
+        detail::inverseColumns(m, cols);
+        _MM_TRANSPOSE4_PS(cols[0], cols[1], cols[2], cols[3]);
+
+        glm::mat4 result;
+        for (int i = 0; i < 4; i++) _mm_storeu_ps(&result[i][0], cols[i]);
+        return result;
+#else
+        return glm::transpose(glm::inverse(m));
+#endif
+    }
+}
+
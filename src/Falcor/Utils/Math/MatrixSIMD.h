@@ -0,0 +1,50 @@
+/***************************************************************************
+ # Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#ifndef SRC_FALCOR_UTILS_MATH_MATRIXSIMD_H_
+#define SRC_FALCOR_UTILS_MATH_MATRIXSIMD_H_
+
+#include "Falcor/Core/Framework.h"
+#include "glm/mat4x4.hpp"
+
+namespace Falcor
+{
+    /** SSE versions of the glm::mat4 operations used on hot CPU paths (scene graph updates).
+        They evaluate the same IEEE operations in the same order as the scalar glm code. MatrixSIMD.cpp is built without
+        FMA contraction, so results are bit identical to glm code built the same way. Without SSE2 they fall back to glm.
+    */
+
+    /** Matrix inverse, same as glm::inverse().
+    */
+    dlldecl glm::mat4 inverseSIMD(const glm::mat4& m);
+
+    /** Inverse transpose, same as glm::transpose(glm::inverse()).
+    */
+    dlldecl glm::mat4 inverseTransposeSIMD(const glm::mat4& m);
+}
+
+#endif  // SRC_FALCOR_UTILS_MATH_MATRIXSIMD_H_
@@ -0,0 +1,131 @@
+/***************************************************************************
+ # Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TaskScheduler.h"
+
+namespace Falcor {
+
+namespace {
+
+// Idle waiters re-check for new work at this interval.
+const std::chrono::microseconds kHelpWaitInterval(200);
+
+}  // namespace
+
+TaskScheduler& TaskScheduler::instance() {
+    static TaskScheduler instance;
+    return instance;
+}
+
+TaskScheduler::TaskScheduler() : TaskScheduler(Desc()) {}
+
+TaskScheduler::TaskScheduler(const Desc& desc) {
+    const uint32_t cpuThreadCount = desc.cpuThreadCount > 0 ? desc.cpuThreadCount : std::max(2u, std::thread::hardware_concurrency()) - 1;
+    const uint32_t threadCounts[(uint32_t)Lane::Count] = { cpuThreadCount, desc.ioThreadCount };
+
+    for (uint32_t l = 0; l < (uint32_t)Lane::Count; l++) {
+        LaneData& lane = mLanes[l];
+        lane.threads.reserve(threadCounts[l]);
+        for (uint32_t i = 0; i < threadCounts[l]; i++) {
+            lane.threads.emplace_back([this, &lane]() { workerLoop(lane); });
+        }
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    mStop = true;
+
+    // Workers drain their queues before leaving.
+    for (auto& lane : mLanes) {
+        { std::lock_guard<std::mutex> lock(lane.mutex); }
+        lane.condition.notify_all();
+        for (auto& thread : lane.threads) thread.join();
+    }
+}
+
+void TaskScheduler::enqueue(std::shared_ptr<TaskBase> pTask, Lane lane, Priority priority) {
+    LaneData& laneData = mLanes[(uint32_t)lane];
+    {
+        std::lock_guard<std::mutex> lock(laneData.mutex);
+        laneData.queues[(uint32_t)priority].push_back(std::move(pTask));
+        laneData.pendingCount++;
+    }
+    laneData.condition.notify_one();
+}
+
+std::shared_ptr<TaskScheduler::TaskBase> TaskScheduler::popTask(LaneData& lane) {
+    for (auto& queue : lane.queues) {
+        if (queue.empty()) continue;
+        std::shared_ptr<TaskBase> pTask = std::move(queue.front());
+        queue.pop_front();
+        lane.pendingCount--;
+        return pTask;
+    }
+    return nullptr;
+}
+
+void TaskScheduler::workerLoop(LaneData& lane) {
+    while (true) {
+        std::shared_ptr<TaskBase> pTask;
+        {
+            std::unique_lock<std::mutex> lock(lane.mutex);
+            lane.condition.wait(lock, [this, &lane]() { return mStop || lane.pendingCount > 0; });
+            if (lane.pendingCount == 0) return;
+            pTask = popTask(lane);
+        }
+        // Tasks already run by a waiting thread are simply dropped here.
+        pTask->tryRun();
+    }
+}
+
+bool TaskScheduler::runPendingTask(Lane lane) {
+    LaneData& laneData = mLanes[(uint32_t)lane];
+    while (true) {
+        std::shared_ptr<TaskBase> pTask;
+        {
+            std::lock_guard<std::mutex> lock(laneData.mutex);
+            pTask = popTask(laneData);
+        }
+        if (!pTask) return false;
+        if (pTask->tryRun()) return true;
+    }
+}
+
+void TaskScheduler::helpWhileWaiting(const std::function<bool(std::chrono::microseconds)>& isReady) {
+    while (!isReady(std::chrono::microseconds(0))) {
+        if (runPendingTask(Lane::CPU)) continue;
+        if (isReady(kHelpWaitInterval)) return;
+    }
+}
+
+size_t TaskScheduler::getPendingTaskCount(Lane lane) const {
+    const LaneData& laneData = mLanes[(uint32_t)lane];
+    std::lock_guard<std::mutex> lock(laneData.mutex);
+    return laneData.pendingCount;
+}
+
+}  // namespace Falcor
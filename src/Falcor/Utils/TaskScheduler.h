@@ -0,0 +1,254 @@
+/***************************************************************************
+ # Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#ifndef SRC_FALCOR_UTILS_TASKSCHEDULER_H_
+#define SRC_FALCOR_UTILS_TASKSCHEDULER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "Falcor/Core/Framework.h"
+
+namespace Falcor {
+
+/** Task scheduler with separate worker lanes and task priorities.
+
+    CPU bound work (geometry conversion, parallel loops) and I/O bound work (texture page reads) run on separate
+    thread sets, so tasks blocked on disk never starve computation and vice versa. Within a lane higher priority tasks
+    are always dequeued first.
+    Waiting on a Future never idles: a task that has not started yet runs on the waiting thread, otherwise the
+    waiting thread runs pending CPU lane tasks until the result is ready. This also makes nested waits from inside
+    tasks deadlock free.
+*/
+class dlldecl TaskScheduler {
+  public:
+    enum class Lane : uint32_t {
+        CPU = 0,
+        IO = 1,
+        Count
+    };
+
+    enum class Priority : uint32_t {
+        High = 0,
+        Normal = 1,
+        Low = 2,
+        Count
+    };
+
+    struct Desc {
+        uint32_t cpuThreadCount = 0;    ///< Number of CPU lane threads. 0 selects hardware concurrency - 1.
+        uint32_t ioThreadCount = 4;     ///< Number of IO lane threads. Lanes without threads only run tasks when waited on.
+    };
+
+    /** Type erased task. Runs at most once, either on a worker or on a thread waiting for it.
+    */
+    class TaskBase {
+      public:
+        virtual ~TaskBase() = default;
+
+        /** Run the task unless it has already been claimed by another thread.
+            \return True if the task was run by this call.
+        */
+        bool tryRun() {
+            if (mClaimed.exchange(true, std::memory_order_acq_rel)) return false;
+            execute();
+            return true;
+        }
+
+        bool isClaimed() const { return mClaimed.load(std::memory_order_acquire); }
+
+      protected:
+        virtual void execute() = 0;
+
+      private:
+        std::atomic<bool> mClaimed = false;
+    };
+
+    template<typename T>
+    class Future {
+      public:
+        Future() = default;
+
+        bool valid() const { return mFuture.valid(); }
+        bool isReady() const { return mFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+
+        /** Wait for the task to finish. Runs the task on the calling thread if it has not started yet, helps with
+            other pending tasks otherwise.
+        */
+        void wait() const {
+            if (!mpTask || isReady()) return;
+            if (mpTask->tryRun()) return;
+            mpScheduler->helpWhileWaiting([this](std::chrono::microseconds timeout) {
+                return mFuture.wait_for(timeout) == std::future_status::ready;
+            });
+        }
+
+        /** Get the task result, see wait(). Rethrows exceptions thrown by the task.
+        */
+        decltype(auto) get() const {
+            wait();
+            return mFuture.get();
+        }
+
+      private:
+        std::shared_future<T> mFuture;
+        std::shared_ptr<TaskBase> mpTask;
+        TaskScheduler* mpScheduler = nullptr;
+
+        friend class TaskScheduler;
+    };
+
+    /** Global scheduler instance.
+    */
+    static TaskScheduler& instance();
+
+    TaskScheduler();
+    TaskScheduler(const Desc& desc);
+    ~TaskScheduler();
+
+    /** Submit a task.
+        \param[in] func Callable without arguments.
+        \param[in] lane Lane to run the task on.
+        \param[in] priority Task priority within the lane.
+        \return Future of the callable result.
+    */
+    template<typename F>
+    auto submit(F&& func, Lane lane = Lane::CPU, Priority priority = Priority::Normal) -> Future<std::invoke_result_t<std::decay_t<F>&>>;
+
+    /** Run func(start, end) over sub-ranges of [begin, end) on the CPU lane. The calling thread takes part and the
+        call returns once all sub-ranges are done.
+    */
+    template<typename F>
+    void parallelFor(uint32_t begin, uint32_t end, F&& func, Priority priority = Priority::High);
+
+    /** Run one pending task of the lane on the calling thread.
+        \return True if a task was run.
+    */
+    bool runPendingTask(Lane lane);
+
+    /** Run pending CPU lane tasks until isReady returns true. isReady is called with the time it may block for.
+    */
+    void helpWhileWaiting(const std::function<bool(std::chrono::microseconds)>& isReady);
+
+    uint32_t getThreadCount(Lane lane) const { return (uint32_t)mLanes[(uint32_t)lane].threads.size(); }
+
+    /** Get the number of queued tasks not started yet.
+    */
+    size_t getPendingTaskCount(Lane lane) const;
+
+  private:
+    template<typename R>
+    class Task : public TaskBase {
+      public:
+        template<typename F>
+        Task(F&& func) : mTask(std::forward<F>(func)) {}
+
+        std::shared_future<R> getFuture() { return mTask.get_future().share(); }
+
+      protected:
+        void execute() override { mTask(); }
+
+      private:
+        std::packaged_task<R()> mTask;
+    };
+
+    struct LaneData {
+        mutable std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<std::shared_ptr<TaskBase>> queues[(uint32_t)Priority::Count];
+        size_t pendingCount = 0;
+        std::vector<std::thread> threads;
+    };
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    void enqueue(std::shared_ptr<TaskBase> pTask, Lane lane, Priority priority);
+    std::shared_ptr<TaskBase> popTask(LaneData& lane);
+    void workerLoop(LaneData& lane);
+
+    LaneData mLanes[(uint32_t)Lane::Count];
+    std::atomic<bool> mStop = false;
+};
+
+template<typename F>
+auto TaskScheduler::submit(F&& func, Lane lane, Priority priority) -> Future<std::invoke_result_t<std::decay_t<F>&>> {
+    using R = std::invoke_result_t<std::decay_t<F>&>;
+
+    auto pTask = std::make_shared<Task<R>>(std::forward<F>(func));
+
+    Future<R> future;
+    future.mFuture = pTask->getFuture();
+    future.mpTask = pTask;
+    future.mpScheduler = this;
+
+    enqueue(std::move(pTask), lane, priority);
+    return future;
+}
+
+template<typename F>
+void TaskScheduler::parallelFor(uint32_t begin, uint32_t end, F&& func, Priority priority) {
+    if (begin >= end) return;
+
+    const uint64_t count = end - begin;
+    const uint32_t blockCount = (uint32_t)std::min<uint64_t>(count, getThreadCount(Lane::CPU) + 1);
+
+    std::vector<Future<void>> blocks;
+    blocks.reserve(blockCount);
+    for (uint32_t b = 0; b < blockCount; b++) {
+        const uint32_t blockStart = begin + (uint32_t)(count * b / blockCount);
+        const uint32_t blockEnd = begin + (uint32_t)(count * (b + 1) / blockCount);
+        blocks.push_back(submit([&func, blockStart, blockEnd]() { func(blockStart, blockEnd); }, Lane::CPU, priority));
+    }
+
+    // Blocks not picked up by workers yet run right here. All blocks have to finish before an exception is rethrown,
+    // they reference func.
+    std::exception_ptr pException;
+    for (auto& block : blocks) {
+        try {
+            block.get();
+        } catch (...) {
+            if (!pException) pException = std::current_exception();
+        }
+    }
+    if (pException) std::rethrow_exception(pException);
+}
+
+}  // namespace Falcor
+
+#endif  // SRC_FALCOR_UTILS_TASKSCHEDULER_H_
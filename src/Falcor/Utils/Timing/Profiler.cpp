@@ -45,6 +45,7 @@
 // #endif
 
 #include "Profiler.h"
+#include "TraceRecorder.h"
 
 using namespace pybind11::literals;
 
@@ -110,7 +111,7 @@ Profiler::Stats Profiler::Stats::compute(const float* data, size_t len) {
 
 // Profiler::Event
 
-Profiler::Event::Event(const std::string& name): mName(name), mCpuTimeHistory(kMaxHistorySize, 0.f), mGpuTimeHistory(kMaxHistorySize, 0.f) {}
+Profiler::Event::Event(const std::string& name): mName(name), mTraceName(name.substr(name.find_last_of('/') + 1)), mCpuTimeHistory(kMaxHistorySize, 0.f), mGpuTimeHistory(kMaxHistorySize, 0.f) {}
 
 Profiler::Stats Profiler::Event::computeCpuTimeStats() const {
     return Stats::compute(mCpuTimeHistory.data(), mHistorySize);
@@ -135,6 +136,7 @@ void Profiler::Event::start(std::shared_ptr<Device> pDevice, uint32_t frameIndex
     assert(frameData.pActiveTimer == nullptr);
     assert(frameData.currentTimer <= frameData.pTimers.size());
 
+    if (frameData.currentTimer == 0) frameData.gpuTraceTime = frameData.cpuStartTime;
     if (frameData.currentTimer == frameData.pTimers.size()) {
         frameData.pTimers.push_back(GpuTimer::create(pDevice));
     }
@@ -149,7 +151,9 @@ void Profiler::Event::end(uint32_t frameIndex) {
     auto& frameData = mFrameData[frameIndex % 2];
 
     // Update CPU time.
-    frameData.cpuTotalTime += (float)CpuTimer::calcDuration(frameData.cpuStartTime, CpuTimer::getCurrentTimePoint());
+    const auto cpuEndTime = CpuTimer::getCurrentTimePoint();
+    frameData.cpuTotalTime += (float)CpuTimer::calcDuration(frameData.cpuStartTime, cpuEndTime);
+    TraceRecorder::instance().recordEvent(mTraceName.c_str(), frameData.cpuStartTime, cpuEndTime);
 
     // Update GPU time.
     assert(frameData.pActiveTimer != nullptr);
@@ -177,6 +181,7 @@ void Profiler::Event::endFrame(uint32_t frameIndex) {
     mCpuTime = frameData.cpuTotalTime;
     mGpuTime = 0.f;
     for (size_t i = 0; i < frameData.currentTimer; ++i) mGpuTime += (float)frameData.pTimers[i]->getElapsedTime();
+    if (frameData.currentTimer > 0) TraceRecorder::instance().recordGpuEvent(mTraceName.c_str(), frameData.gpuTraceTime, mGpuTime);
     frameData.cpuTotalTime = 0.f;
     frameData.currentTimer = 0;
 
@@ -96,6 +96,7 @@ class dlldecl Profiler {
 				void endFrame(uint32_t frameIndex);
 
 				std::string mName;                              ///< Nested event name.
+				std::string mTraceName;                         ///< Event name without parent events, used for trace recording.
 
 				float mCpuTime = 0.0;                           ///< CPU time (previous frame).
 				float mGpuTime = 0.0;                           ///< GPU time (previous frame).
@@ -112,6 +113,7 @@ class dlldecl Profiler {
 
 				struct FrameData {
 					CpuTimer::TimePoint cpuStartTime;           ///< Last event CPU start time.
+					CpuTimer::TimePoint gpuTraceTime;           ///< CPU time the first GPU timer of the frame was started at.
 					float cpuTotalTime = 0.0;                   ///< Total accumulated CPU time.
 
 					std::vector<GpuTimer::SharedPtr> pTimers;   ///< Pool of GPU timers.
@@ -0,0 +1,224 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "stdafx.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+#include "lava_utils_lib/logging.h"
+
+#include "TraceRecorder.h"
+
+namespace Falcor {
+
+namespace {
+    const uint32_t kProcessID = 1;
+
+    void writeJsonString(std::ostream& os, const char* str) {
+        os << '"';
+        for (const char* c = str; *c; ++c) {
+            switch (*c) {
+                case '"':  os << "\\\""; break;
+                case '\\': os << "\\\\"; break;
+                case '\n': os << "\\n"; break;
+                case '\r': os << "\\r"; break;
+                case '\t': os << "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(*c) < 0x20) {
+                        os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)*c << std::dec << std::setfill(' ');
+                    } else {
+                        os << *c;
+                    }
+                    break;
+            }
+        }
+        os << '"';
+    }
+
+    const char* categoryName(TraceRecorder::Category category) {
+        switch (category) {
+            case TraceRecorder::Category::Cpu: return "cpu";
+            case TraceRecorder::Category::Gpu: return "gpu";
+            case TraceRecorder::Category::Frame: return "frame";
+            default: return "";
+        }
+    }
+
+    thread_local void* tpThreadBuffer = nullptr;
+}
+
+void TraceRecorder::ThreadBuffer::push(const char* name, int64_t start, int64_t duration, Category category) {
+    // Single writer per buffer. Readers see the record once the write count is published.
+    uint64_t index = writeCount.load(std::memory_order_relaxed);
+    Record& record = records[index % records.size()];
+    record.start = start;
+    record.duration = duration;
+    record.category = category;
+    std::strncpy(record.name, name, kMaxNameLength);
+    record.name[kMaxNameLength] = '\0';
+    writeCount.store(index + 1, std::memory_order_release);
+}
+
+TraceRecorder& TraceRecorder::instance() {
+    // Never destroyed, worker threads may still record while static objects get destroyed at exit.
+    static TraceRecorder* pInstance = new TraceRecorder();
+    return *pInstance;
+}
+
+TraceRecorder::TraceRecorder(): mEpoch(CpuTimer::getCurrentTimePoint()) {
+    mpGpuBuffer = createThreadBuffer("GPU");
+}
+
+void TraceRecorder::setEnabled(bool enabled) {
+    mEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void TraceRecorder::setCapacity(size_t eventsPerThread) {
+    if (isEnabled()) {
+        LLOG_WRN << "Changing trace recorder capacity while recording is enabled. Recorded events may be lost.";
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mCapacity = std::max<size_t>(eventsPerThread, 1);
+    for (auto& pBuffer : mBuffers) {
+        pBuffer->records.assign(mCapacity, Record());
+        pBuffer->writeCount.store(0, std::memory_order_relaxed);
+    }
+}
+
+void TraceRecorder::setThreadName(const std::string& name) {
+    if (tpThreadBuffer) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        static_cast<ThreadBuffer*>(tpThreadBuffer)->threadName = name;
+        return;
+    }
+    tpThreadBuffer = createThreadBuffer(name);
+}
+
+TraceRecorder::ThreadBuffer* TraceRecorder::createThreadBuffer(const std::string& threadName) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto pBuffer = std::make_unique<ThreadBuffer>();
+    pBuffer->threadID = static_cast<uint32_t>(mBuffers.size());
+    pBuffer->threadName = threadName.empty() ? ("Thread " + std::to_string(pBuffer->threadID)) : threadName;
+    pBuffer->records.resize(mCapacity);
+    mBuffers.push_back(std::move(pBuffer));
+    return mBuffers.back().get();
+}
+
+TraceRecorder::ThreadBuffer& TraceRecorder::getThreadBuffer() {
+    if (!tpThreadBuffer) tpThreadBuffer = createThreadBuffer("");
+    return *static_cast<ThreadBuffer*>(tpThreadBuffer);
+}
+
+int64_t TraceRecorder::toNanoseconds(CpuTimer::TimePoint time) const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time - mEpoch).count();
+}
+
+void TraceRecorder::recordEvent(const char* name, CpuTimer::TimePoint start, CpuTimer::TimePoint end) {
+    if (!isEnabled()) return;
+    int64_t startNs = toNanoseconds(start);
+    getThreadBuffer().push(name, startNs, toNanoseconds(end) - startNs, Category::Cpu);
+}
+
+void TraceRecorder::recordGpuEvent(const char* name, CpuTimer::TimePoint start, double durationMs) {
+    if (!isEnabled()) return;
+    mpGpuBuffer->push(name, toNanoseconds(start), static_cast<int64_t>(durationMs * 1.0e6), Category::Gpu);
+}
+
+void TraceRecorder::markFrame(uint32_t frameIndex) {
+    if (!isEnabled()) return;
+    std::string name = "Frame " + std::to_string(frameIndex);
+    getThreadBuffer().push(name.c_str(), toNanoseconds(CpuTimer::getCurrentTimePoint()), 0, Category::Frame);
+}
+
+void TraceRecorder::clear() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (auto& pBuffer : mBuffers) {
+        pBuffer->writeCount.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t TraceRecorder::getEventCount() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    size_t count = 0;
+    for (const auto& pBuffer : mBuffers) {
+        count += std::min<uint64_t>(pBuffer->writeCount.load(std::memory_order_acquire), pBuffer->records.size());
+    }
+    return count;
+}
+
+void TraceRecorder::write(std::ostream& os) const {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    os << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << kProcessID << ",\"tid\":0,\"args\":{\"name\":\"lava\"}}";
+
+    const auto oldFlags = os.flags();
+    os << std::fixed << std::setprecision(3);
+
+    for (const auto& pBuffer : mBuffers) {
+        const uint32_t tid = pBuffer->threadID;
+        os << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << kProcessID << ",\"tid\":" << tid << ",\"args\":{\"name\":";
+        writeJsonString(os, pBuffer->threadName.c_str());
+        os << "}}";
+        os << ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":" << kProcessID << ",\"tid\":" << tid << ",\"args\":{\"sort_index\":" << tid << "}}";
+
+        // Oldest surviving record first
+        const uint64_t writeCount = pBuffer->writeCount.load(std::memory_order_acquire);
+        const uint64_t capacity = pBuffer->records.size();
+        const uint64_t count = std::min(writeCount, capacity);
+        for (uint64_t i = writeCount - count; i < writeCount; ++i) {
+            const Record& record = pBuffer->records[i % capacity];
+            os << ",\n{\"name\":";
+            writeJsonString(os, record.name);
+            os << ",\"cat\":\"" << categoryName(record.category) << "\",\"pid\":" << kProcessID << ",\"tid\":" << tid
+               << ",\"ts\":" << record.start * 1.0e-3;
+            if (record.category == Category::Frame) {
+                os << ",\"ph\":\"i\",\"s\":\"g\"}";
+            } else {
+                os << ",\"ph\":\"X\",\"dur\":" << record.duration * 1.0e-3 << "}";
+            }
+        }
+    }
+
+    os.flags(oldFlags);
+    os << "\n]}\n";
+}
+
+bool TraceRecorder::writeToFile(const fs::path& path) const {
+    std::ofstream ofs(path.string());
+    if (!ofs) {
+        LLOG_ERR << "Unable to open trace file " << path.string() << " for writing !";
+        return false;
+    }
+    write(ofs);
+    return static_cast<bool>(ofs);
+}
+
+}  // namespace Falcor
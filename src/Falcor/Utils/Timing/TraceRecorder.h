@@ -0,0 +1,178 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#ifndef SRC_FALCOR_UTILS_TIMING_TRACERECORDER_H_
+#define SRC_FALCOR_UTILS_TIMING_TRACERECORDER_H_
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+namespace fs = boost::filesystem;
+
+#include "Falcor/Core/Framework.h"
+#include "CpuTimer.h"
+
+namespace Falcor {
+
+/** Low overhead recorder of timed events from any thread, written out in Chrome trace event format
+    (chrome://tracing, ui.perfetto.dev).
+
+    Every thread records into its own fixed size ring buffer, so recording takes no locks and the oldest events
+    get overwritten when a thread records more than the buffer capacity. Recording is a single relaxed atomic load
+    while the recorder is disabled. GPU times reported by the Profiler are recorded on a separate "GPU" track.
+    Traces are meant to be written once the traced work is done, events recorded while writing may be dropped.
+*/
+class dlldecl TraceRecorder {
+  public:
+    enum class Category : uint8_t {
+        Cpu,
+        Gpu,
+        Frame,
+    };
+
+    static const size_t kDefaultCapacity = 16384;   ///< Default ring buffer capacity in events per thread.
+    static const size_t kMaxNameLength = 63;        ///< Longer event names are truncated.
+
+    struct Record {
+        int64_t start = 0;                          ///< Start time in nanoseconds since recorder epoch.
+        int64_t duration = 0;                       ///< Duration in nanoseconds. Frame markers have none.
+        Category category = Category::Cpu;
+        char name[kMaxNameLength + 1] = {};
+    };
+
+    static TraceRecorder& instance();
+
+    /** Enable/disable recording. Enabling does not clear previously recorded events.
+    */
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return mEnabled.load(std::memory_order_relaxed); }
+
+    /** Set ring buffer capacity in events per thread. Clears all recorded events. Call while the recorder is disabled.
+    */
+    void setCapacity(size_t eventsPerThread);
+    size_t getCapacity() const { return mCapacity; }
+
+    /** Set the name of the calling thread shown in the trace.
+    */
+    void setThreadName(const std::string& name);
+
+    /** Record a CPU event of the calling thread.
+    */
+    void recordEvent(const char* name, CpuTimer::TimePoint start, CpuTimer::TimePoint end);
+
+    /** Record a GPU event. GPU timestamps are not calibrated against the CPU clock, so the event is placed at the CPU time
+        its work was recorded at. Must be called from one thread only (the one ending Profiler frames).
+        \param[in] durationMs Event GPU duration in milliseconds.
+    */
+    void recordGpuEvent(const char* name, CpuTimer::TimePoint start, double durationMs);
+
+    /** Record a frame boundary marker visible across all tracks.
+    */
+    void markFrame(uint32_t frameIndex);
+
+    /** Drop all recorded events. Thread names are kept.
+    */
+    void clear();
+
+    /** Get number of events currently held in all ring buffers.
+    */
+    size_t getEventCount() const;
+
+    /** Write recorded events as Chrome trace JSON.
+    */
+    void write(std::ostream& os) const;
+    bool writeToFile(const fs::path& path) const;
+
+  private:
+    struct ThreadBuffer {
+        uint32_t threadID = 0;
+        std::string threadName;
+        std::vector<Record> records;
+        std::atomic<uint64_t> writeCount = 0;
+
+        void push(const char* name, int64_t start, int64_t duration, Category category);
+    };
+
+    TraceRecorder();
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    ThreadBuffer& getThreadBuffer();
+    ThreadBuffer* createThreadBuffer(const std::string& threadName);
+    int64_t toNanoseconds(CpuTimer::TimePoint time) const;
+
+    std::atomic<bool> mEnabled = false;
+    size_t mCapacity = kDefaultCapacity;
+    CpuTimer::TimePoint mEpoch;
+
+    mutable std::mutex mMutex;                              ///< Guards thread buffers list.
+    std::vector<std::unique_ptr<ThreadBuffer>> mBuffers;
+    ThreadBuffer* mpGpuBuffer = nullptr;
+};
+
+/** Helper class recording a CPU trace event for its lifetime. Use TRACE_SCOPE macro instead of creating it directly.
+*/
+class TraceScope {
+  public:
+    TraceScope(const char* name) {
+        if (TraceRecorder::instance().isEnabled()) begin(name);
+    }
+
+    TraceScope(const std::string& name) {
+        if (TraceRecorder::instance().isEnabled()) begin(name.c_str());
+    }
+
+    ~TraceScope() {
+        if (mActive) TraceRecorder::instance().recordEvent(mName, mStart, CpuTimer::getCurrentTimePoint());
+    }
+
+  private:
+    void begin(const char* name) {
+        std::strncpy(mName, name, TraceRecorder::kMaxNameLength);
+        mName[TraceRecorder::kMaxNameLength] = '\0';
+        mStart = CpuTimer::getCurrentTimePoint();
+        mActive = true;
+    }
+
+    bool mActive = false;
+    CpuTimer::TimePoint mStart;
+    char mName[TraceRecorder::kMaxNameLength + 1];
+};
+
+}  // namespace Falcor
+
+#define TRACE_SCOPE_CONCAT_(_a, _b) _a##_b
+#define TRACE_SCOPE_CONCAT(_a, _b) TRACE_SCOPE_CONCAT_(_a, _b)
+#define TRACE_SCOPE(_name) Falcor::TraceScope TRACE_SCOPE_CONCAT(_traceScope, __LINE__)(_name)
+
+#endif  // SRC_FALCOR_UTILS_TIMING_TRACERECORDER_H_
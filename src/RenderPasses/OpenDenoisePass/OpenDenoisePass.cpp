@@ -50,6 +50,9 @@ namespace {
     const std::string kUseAlbedo = "useAlbedo";
     const std::string kUseNormal = "useNormal";
     const std::string kQuality   = "quality";
+    const std::string kAsync     = "async";
+    const std::string kTileSize  = "tileSize";
+    const std::string kTileOverlap = "tileOverlap";
 
     const ChannelList kExtraInputChannels = {
         { kAlbedoInput,           "gTextureAlbedo",            "Albedo auxiliary texture", true /* optional */, ResourceFormat::Unknown },
@@ -77,6 +80,30 @@ namespace {
         return oidn::Format::Undefined;
     }
 
+    // OIDN filters only use first three channels, alpha is skipped with pixel stride
+    inline oidn::Format toOIDNColorFormat(ResourceFormat format) {
+        oidn::Format oidnFormat = toOIDNFormat(format);
+        if(oidnFormat == oidn::Format::Half4) return oidn::Format::Half3;
+        if(oidnFormat == oidn::Format::Float4) return oidn::Format::Float3;
+        return oidnFormat;
+    }
+
+    inline size_t getOIDNFormatByteSize(oidn::Format format) {
+        switch (format) {
+            case oidn::Format::Float:  return 4;
+            case oidn::Format::Float2: return 8;
+            case oidn::Format::Float3: return 12;
+            case oidn::Format::Float4: return 16;
+            case oidn::Format::Half:   return 2;
+            case oidn::Format::Half2:  return 4;
+            case oidn::Format::Half3:  return 6;
+            case oidn::Format::Half4:  return 8;
+            default:
+                break;
+        }
+        return 0;
+    }
+
 #define str(a) case oidn::Format::a: return #a
     inline std::string to_string(oidn::Format type) {
         switch (type) {
@@ -111,6 +138,10 @@ OpenDenoisePass::OpenDenoisePass(Device::SharedPtr pDevice, ResourceFormat outpu
     mOidnDevice.commit();
 }
 
+OpenDenoisePass::~OpenDenoisePass() {
+    waitForPendingTask();
+}
+
 OpenDenoisePass::SharedPtr OpenDenoisePass::create(RenderContext* pRenderContext, const Dictionary& dict) {
     // outputFormat can only be set on construction
     ResourceFormat outputFormat = ResourceFormat::Unknown;
@@ -134,6 +165,9 @@ void OpenDenoisePass::parseDictionary(const Dictionary& dict) {
         else if (key == kUseAlbedo) useAlbedo(static_cast<bool>(value));
         else if (key == kUseNormal) useNormal(static_cast<bool>(value));
         else if (key == kQuality) setQuality(static_cast<OpenDenoisePass::Quality>(value));
+        else if (key == kAsync) setAsync(static_cast<bool>(value));
+        else if (key == kTileSize) setTileSize(static_cast<uint32_t>(value));
+        else if (key == kTileOverlap) setTileOverlap(static_cast<uint32_t>(value));
     }
 }
 
@@ -151,6 +185,10 @@ RenderPassReflection OpenDenoisePass::reflect(const CompileData& compileData) {
 }
 
 void OpenDenoisePass::compile(RenderContext* pRenderContext, const CompileData& compileData) {
+    if(mFrameDim != compileData.defaultTexDims) {
+        resetAsyncState();
+        mFilters.clear();
+    }
     mFrameDim = compileData.defaultTexDims;
 }
 
@@ -171,117 +209,260 @@ void OpenDenoisePass::execute(RenderContext* pRenderContext, const RenderData& r
         bypass(pRenderContext, renderData);
         return;
     }
-    
-    auto pAlbedoTex = renderData[kAlbedoInput]->asTexture();
-    auto pNormalTex = renderData[kNormalInput]->asTexture();
-
-    auto inputImageFormat = pInputTex->getFormat();
-    auto outputImageFormat = pOutputTex->getFormat();
-    oidn::Format inputImageOIDNFormat = toOIDNFormat(inputImageFormat);
-    oidn::Format outputImageOIDNFormat = toOIDNFormat(outputImageFormat);
-    uint32_t inputImageDataSize = pInputTex->getWidth(0) * pInputTex->getHeight(0) * getFormatBytesPerBlock(inputImageFormat);
-    uint32_t outputImageDataSize = pOutputTex->getWidth(0) * pOutputTex->getHeight(0) * getFormatBytesPerBlock(outputImageFormat);
-    
-    mMainImageData.resize(inputImageDataSize);
-    mOutputImageData.resize(outputImageDataSize);
-
-    auto auxAlbedoImageFormat = ResourceFormat::Unknown;
-    oidn::Format auxAlbedoOIDNFormat = oidn::Format::Undefined;
-    if(pAlbedoTex && mUseAlbedo) {
-        if(pInputTex->getWidth() != pAlbedoTex->getWidth() || pInputTex->getHeight() != pAlbedoTex->getHeight()) {
-            LLOG_ERR << "OpenDenoisePass input and albedo images dimensions mismatch!";
-            bypass(pRenderContext, renderData);
+
+    const bool syncDenoise = mSyncDenoiseRequested;
+    mSyncDenoiseRequested = false;
+
+    if(mAsync) {
+        if(!syncDenoise) {
+            executeAsync(pRenderContext, renderData);
             return;
         }
+        // Drop in flight work, it's based on an older accumulation than the one denoised below
+        resetAsyncState();
+    }
 
-        auxAlbedoOIDNFormat = toOIDNFormat(auxAlbedoImageFormat);
-        mAlbedoImageData.resize(pAlbedoTex->getWidth(0) * pAlbedoTex->getHeight(0) * getFormatBytesPerBlock(auxAlbedoImageFormat));
-        pRenderContext->readTextureSubresource(pAlbedoTex.get(), pAlbedoTex->getSubresourceIndex(0, 0), mAlbedoImageData.data());
+    auto& job = mJobs[0];
+    if(!prepareJob(pRenderContext, renderData, job, false)) {
+        bypass(pRenderContext, renderData);
+        return;
     }
 
-    auto auxNormalImageFormat = ResourceFormat::Unknown;
-    oidn::Format auxNormalOIDNFormat = oidn::Format::Undefined;
-    if(pNormalTex && mUseNormal) {
-        if(pInputTex->getWidth() != pNormalTex->getWidth() || pInputTex->getHeight() != pNormalTex->getHeight()) {
-            LLOG_ERR << "OpenDenoisePass input and normal images dimensions mismatch!";
-            bypass(pRenderContext, renderData);
-            return;
+    finishJobReadback(job);
+
+    if(!denoise(job)) {
+        bypass(pRenderContext, renderData);
+        return;
+    }
+
+    LLOG_DBG << "OpenDenoisePass filter executed. Uploading denoised data.";
+
+    // Upload denoised image back to GPU
+    pRenderContext->updateTextureData(pOutputTex.get(), (const void*)job.output.data.data());
+    mHasDenoisedOutput = true;
+}
+
+void OpenDenoisePass::executeAsync(RenderContext* pRenderContext, const RenderData& renderData) {
+    auto pOutputTex = renderData[kOutput]->asTexture();
+
+    // Upload result of the finished denoise task
+    if(mDenoiseTask.valid() && mDenoiseTask.isReady()) {
+        if(mDenoiseTask.get()) {
+            LLOG_DBG << "OpenDenoisePass async filter executed. Uploading denoised data.";
+            pRenderContext->updateTextureData(pOutputTex.get(), (const void*)mJobs[mRunningJobIdx].output.data.data());
+            mHasDenoisedOutput = true;
         }
+        mRunningJobIdx = kNoJob;
+    }
 
-        auxNormalOIDNFormat = toOIDNFormat(auxNormalImageFormat);
-        mNormalImageData.resize(pNormalTex->getWidth(0) * pNormalTex->getHeight(0) * getFormatBytesPerBlock(auxNormalImageFormat));
-        pRenderContext->readTextureSubresource(pNormalTex.get(), pNormalTex->getSubresourceIndex(0, 0), mNormalImageData.data());
+    // Readback issued on previous frame should be complete by now, hand it over to the worker
+    if(mReadbackJobIdx != kNoJob && mRunningJobIdx == kNoJob) {
+        DenoiseJob* pJob = &mJobs[mReadbackJobIdx];
+        finishJobReadback(*pJob);
+        mRunningJobIdx = mReadbackJobIdx;
+        mReadbackJobIdx = kNoJob;
+        mDenoiseTask = TaskScheduler::instance().submit([this, pJob] { return denoise(*pJob); }, TaskScheduler::Lane::CPU, TaskScheduler::Priority::Low);
     }
 
-    if(!mFilter) {
-        mFilter = mOidnDevice.newFilter("RT");
-        mFilter.set("quality", (mQuality == Quality::High) ? OIDN_QUALITY_HIGH : OIDN_QUALITY_BALANCED);
+    // Issue readback into the free job. While worker is busy we keep refreshing it, so the next denoise
+    // task picks up the latest accumulated image instead of a stale one.
+    const uint32_t jobIdx = (mRunningJobIdx == 0) ? 1 : 0;
+    if(!prepareJob(pRenderContext, renderData, mJobs[jobIdx], true)) {
+        mReadbackJobIdx = kNoJob;
+        bypass(pRenderContext, renderData);
+        return;
     }
+    mReadbackJobIdx = jobIdx;
 
-    size_t inputImageDataByteOffset = 0;
-    size_t inputImageBytePixelStride = getFormatBytesPerBlock(inputImageFormat);
+    // Until the first denoised image is ready output is just a copy of the input
+    if(!mHasDenoisedOutput) bypass(pRenderContext, renderData);
+}
 
-    if(inputImageOIDNFormat == oidn::Format::Half4) inputImageOIDNFormat = oidn::Format::Half3;
-    if(inputImageOIDNFormat == oidn::Format::Float4) inputImageOIDNFormat = oidn::Format::Float3;
+bool OpenDenoisePass::prepareJob(RenderContext* pRenderContext, const RenderData& renderData, DenoiseJob& job, bool async) {
+    auto pInputTex = renderData[kInput]->asTexture();
+    auto pOutputTex = renderData[kOutput]->asTexture();
 
-    pRenderContext->readTextureSubresource(pInputTex.get(), pInputTex->getSubresourceIndex(0, 0), mMainImageData.data());
-    
-    // Copy input data to output vector. We need this to keep our source image alpha channel;
-    // TODO: find a better faster way without full copy
-    memcpy(&mOutputImageData[0], &mMainImageData[0], mMainImageData.size());
+    auto pAlbedoResource = renderData[kAlbedoInput];
+    auto pNormalResource = renderData[kNormalInput];
+    auto pAlbedoTex = (mUseAlbedo && pAlbedoResource) ? pAlbedoResource->asTexture() : nullptr;
+    auto pNormalTex = (mUseNormal && pNormalResource) ? pNormalResource->asTexture() : nullptr;
 
-    mFilter.setImage("color",  mMainImageData.data(),  inputImageOIDNFormat, mFrameDim.x, mFrameDim.y, 
-        inputImageDataByteOffset, inputImageBytePixelStride); // beauty
-    
-    if(pAlbedoTex && mUseAlbedo) {
-        LLOG_DBG << "Denosing image using \"albedo\" auxiliary channel";
-        size_t albedoImageDataByteOffset = 0;
-        size_t albedoImageBytePixelStride = getFormatBytesPerBlock(auxAlbedoImageFormat);
-        mFilter.setImage("albedo", mAlbedoImageData.data(), auxAlbedoOIDNFormat, mFrameDim.x, mFrameDim.y, 
-            albedoImageDataByteOffset, albedoImageBytePixelStride); // auxiliary
+    if(pAlbedoTex && (pInputTex->getWidth() != pAlbedoTex->getWidth() || pInputTex->getHeight() != pAlbedoTex->getHeight())) {
+        LLOG_ERR << "OpenDenoisePass input and albedo images dimensions mismatch!";
+        return false;
     }
 
-    if(pNormalTex && mUseNormal) {
-        LLOG_DBG << "Denosing image using \"normal\" auxiliary channel";
-        size_t normalImageDataByteOffset = 0;
-        size_t normalImageBytePixelStride = getFormatBytesPerBlock(auxNormalImageFormat);
-        mFilter.setImage("normal", mNormalImageData.data(), auxNormalOIDNFormat, mFrameDim.x, mFrameDim.y, 
-            normalImageDataByteOffset, normalImageBytePixelStride); // auxiliary
+    if(pNormalTex && (pInputTex->getWidth() != pNormalTex->getWidth() || pInputTex->getHeight() != pNormalTex->getHeight())) {
+        LLOG_ERR << "OpenDenoisePass input and normal images dimensions mismatch!";
+        return false;
     }
 
-    size_t outputImageDataByteOffset = 0;
-    size_t outputImageBytePixelStride = getFormatBytesPerBlock(outputImageFormat);
+    const auto inputImageFormat = pInputTex->getFormat();
+
+    job.frameDim = { pInputTex->getWidth(0), pInputTex->getHeight(0) };
+    job.hdr = !mDisableHDRInput && (isFloatFormat(inputImageFormat) || isHalfFloatFormat(inputImageFormat));
+    job.quality = mQuality;
+    job.tileSize = mTileSize;
+    job.tileOverlap = mTileOverlap;
 
-    if(outputImageOIDNFormat == oidn::Format::Half4) outputImageOIDNFormat = oidn::Format::Half3;
-    if(outputImageOIDNFormat == oidn::Format::Float4) outputImageOIDNFormat = oidn::Format::Float3;
+    auto readImage = [&](const Texture::SharedPtr& pTex, DenoiseImage& image) {
+        image.pReadTask = nullptr;
+        if(!pTex) {
+            image.format = oidn::Format::Undefined;
+            image.data.clear();
+            return;
+        }
 
-    mFilter.setImage("output", mOutputImageData.data(), outputImageOIDNFormat, mFrameDim.x, mFrameDim.y, 
-        outputImageDataByteOffset, outputImageBytePixelStride); // denoised beauty
+        const auto format = pTex->getFormat();
+        image.format = toOIDNColorFormat(format);
+        image.bytePixelStride = getFormatBytesPerBlock(format);
+        image.data.resize((size_t)pTex->getWidth(0) * pTex->getHeight(0) * image.bytePixelStride);
 
-    if(!mDisableHDRInput && (isFloatFormat(inputImageFormat) || isHalfFloatFormat(inputImageFormat))) {
-        mFilter.set("hdr", true); // MAIN (beauty) image is HDR
+        if(image.format == oidn::Format::Undefined) {
+            LLOG_WRN << "OpenDenoisePass unsupported texture format " << to_string(format);
+            return;
+        }
+
+        if(async) {
+            image.pReadTask = pRenderContext->asyncReadTextureSubresource(pTex.get(), pTex->getSubresourceIndex(0, 0));
+        } else {
+            pRenderContext->readTextureSubresource(pTex.get(), pTex->getSubresourceIndex(0, 0), image.data.data());
+        }
+    };
+
+    readImage(pInputTex, job.color);
+    readImage(pAlbedoTex, job.albedo);
+    readImage(pNormalTex, job.normal);
+
+    const auto outputImageFormat = pOutputTex->getFormat();
+    job.output.format = toOIDNColorFormat(outputImageFormat);
+    job.output.bytePixelStride = getFormatBytesPerBlock(outputImageFormat);
+    job.output.data.resize((size_t)pOutputTex->getWidth(0) * pOutputTex->getHeight(0) * job.output.bytePixelStride);
+
+    return job.color.format != oidn::Format::Undefined && job.output.format != oidn::Format::Undefined;
+}
+
+void OpenDenoisePass::finishJobReadback(DenoiseJob& job) {
+    for(DenoiseImage* pImage : {&job.color, &job.albedo, &job.normal}) {
+        if(!pImage->pReadTask) continue;
+        pImage->pReadTask->getData(pImage->data.data());
+        pImage->pReadTask = nullptr;
     }
 
-    mFilter.commit();
+    // Copy input data to output vector. We need this to keep our source image alpha channel;
+    // TODO: find a better faster way without full copy
+    memcpy(job.output.data.data(), job.color.data.data(), std::min(job.output.data.size(), job.color.data.size()));
+}
 
-    // Filter the image
-    mFilter.execute();
+oidn::FilterRef& OpenDenoisePass::getFilter(const DenoiseJob& job, uint32_t width, uint32_t height) {
+    const bool useAlbedo = job.albedo.format != oidn::Format::Undefined;
+    const bool useNormal = job.normal.format != oidn::Format::Undefined;
 
-    // Check for errors
-    bool hasErrors = false;
-    const char* errorMessage;
-    if (mOidnDevice.getError(errorMessage) != oidn::Error::None) {
-        bool hasErrors = true;
-        LLOG_ERR << "OpenDenoisePass error: " << std::string(errorMessage);
-        
-        bypass(pRenderContext, renderData);
-        return;
+    const uint64_t key = (uint64_t(width) << 40) | (uint64_t(height) << 16) | (uint64_t(job.quality) << 3) |
+        (uint64_t(useNormal) << 2) | (uint64_t(useAlbedo) << 1) | uint64_t(job.hdr);
+
+    auto it = mFilters.find(key);
+    if(it != mFilters.end()) return it->second;
+
+    LLOG_DBG << "OpenDenoisePass creating filter for " << width << "x" << height << " tile";
+
+    oidn::FilterRef filter = mOidnDevice.newFilter("RT");
+    filter.set("quality", (job.quality == Quality::High) ? OIDN_QUALITY_HIGH : OIDN_QUALITY_BALANCED);
+    filter.set("hdr", job.hdr); // MAIN (beauty) image is HDR
+
+    return mFilters.emplace(key, std::move(filter)).first->second;
+}
+
+bool OpenDenoisePass::denoise(DenoiseJob& job) {
+    const uint32_t width = job.frameDim.x;
+    const uint32_t height = job.frameDim.y;
+    const uint32_t tileSize = (job.tileSize == 0) ? std::max(width, height) : job.tileSize;
+    const uint32_t overlap = (tileSize >= width && tileSize >= height) ? 0 : job.tileOverlap;
+    const size_t outputTexelSize = getOIDNFormatByteSize(job.output.format);
+
+    const bool useAlbedo = job.albedo.format != oidn::Format::Undefined;
+    const bool useNormal = job.normal.format != oidn::Format::Undefined;
+
+    auto setTileImage = [width](oidn::FilterRef& filter, const char* name, DenoiseImage& image, uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+        const size_t byteRowStride = (size_t)width * image.bytePixelStride;
+        const size_t byteOffset = (size_t)y * byteRowStride + (size_t)x * image.bytePixelStride;
+        filter.setImage(name, image.data.data(), image.format, w, h, byteOffset, image.bytePixelStride, byteRowStride);
+    };
+
+    for(uint32_t tileY = 0; tileY < height; tileY += tileSize) {
+        for(uint32_t tileX = 0; tileX < width; tileX += tileSize) {
+            // Tile region that ends up in the output image
+            const uint32_t x1 = std::min(width, tileX + tileSize);
+            const uint32_t y1 = std::min(height, tileY + tileSize);
+
+            // Filtered region. Extended by overlap to avoid seams on tile borders
+            const uint32_t px0 = (tileX > overlap) ? tileX - overlap : 0;
+            const uint32_t py0 = (tileY > overlap) ? tileY - overlap : 0;
+            const uint32_t px1 = std::min(width, x1 + overlap);
+            const uint32_t py1 = std::min(height, y1 + overlap);
+            const uint32_t pw = px1 - px0;
+            const uint32_t ph = py1 - py0;
+            const bool singleTile = (pw == width) && (ph == height);
+
+            auto& filter = getFilter(job, pw, ph);
+
+            setTileImage(filter, "color", job.color, px0, py0, pw, ph); // beauty
+            if(useAlbedo) setTileImage(filter, "albedo", job.albedo, px0, py0, pw, ph); // auxiliary
+            if(useNormal) setTileImage(filter, "normal", job.normal, px0, py0, pw, ph); // auxiliary
+
+            if(singleTile) {
+                setTileImage(filter, "output", job.output, 0, 0, width, height); // denoised beauty
+            } else {
+                mTileOutputData.resize((size_t)pw * ph * outputTexelSize);
+                filter.setImage("output", mTileOutputData.data(), job.output.format, pw, ph, 0, outputTexelSize, pw * outputTexelSize);
+            }
+
+            filter.commit();
+
+            // Filter the image
+            filter.execute();
+
+            // Check for errors
+            const char* errorMessage;
+            if (mOidnDevice.getError(errorMessage) != oidn::Error::None) {
+                LLOG_ERR << "OpenDenoisePass error: " << std::string(errorMessage);
+                return false;
+            }
+
+            if(singleTile) continue;
+
+            // Copy tile without overlap border to the output image. Output alpha is left untouched.
+            for(uint32_t y = tileY; y < y1; ++y) {
+                const uint8_t* pSrc = mTileOutputData.data() + ((size_t)(y - py0) * pw + (tileX - px0)) * outputTexelSize;
+                uint8_t* pDst = job.output.data.data() + ((size_t)y * width + tileX) * job.output.bytePixelStride;
+                for(uint32_t x = tileX; x < x1; ++x) {
+                    memcpy(pDst, pSrc, outputTexelSize);
+                    pSrc += outputTexelSize;
+                    pDst += job.output.bytePixelStride;
+                }
+            }
+        }
     }
 
-    LLOG_DBG << "OpenDenoisePass filter executed. Uploading denoised data.";
+    return true;
+}
 
-    // Upload denoised image back to GPU
-    pRenderContext->updateTextureData(pOutputTex.get(), (const void*)mOutputImageData.data());
+void OpenDenoisePass::waitForPendingTask() {
+    if(mDenoiseTask.valid()) mDenoiseTask.wait();
+}
+
+void OpenDenoisePass::resetAsyncState() {
+    waitForPendingTask();
+    mDenoiseTask = {};
+    mReadbackJobIdx = kNoJob;
+    mRunningJobIdx = kNoJob;
+    mHasDenoisedOutput = false;
+
+    for(auto& job: mJobs) {
+        job.color.pReadTask = nullptr;
+        job.albedo.pReadTask = nullptr;
+        job.normal.pReadTask = nullptr;
+    }
 }
 
 void OpenDenoisePass::bypass(RenderContext* pRenderContext, const RenderData& renderData) {
@@ -321,4 +502,23 @@ void OpenDenoisePass::setQuality(Quality quality) {
     if(mQuality == quality) return;
     mQuality = quality;
     mPassChangedCB();
-}
\ No newline at end of file
+}
+
+void OpenDenoisePass::setAsync(bool state) {
+    if(mAsync == state) return;
+    resetAsyncState();
+    mAsync = state;
+    mPassChangedCB();
+}
+
+void OpenDenoisePass::setTileSize(uint32_t tileSize) {
+    if(mTileSize == tileSize) return;
+    mTileSize = tileSize;
+    mPassChangedCB();
+}
+
+void OpenDenoisePass::setTileOverlap(uint32_t tileOverlap) {
+    if(mTileOverlap == tileOverlap) return;
+    mTileOverlap = tileOverlap;
+    mPassChangedCB();
+}
@@ -31,6 +31,10 @@
 #include "Falcor/Falcor.h"
 #include "FalcorExperimental.h"
 #include "Falcor/RenderGraph/RenderPass.h"
+#include "Falcor/Utils/TaskScheduler.h"
+
+#include <array>
+#include <map>
 
 #include <OpenImageDenoise/oidn.hpp>
 
@@ -50,6 +54,8 @@ class PASS_API OpenDenoisePass : public RenderPass {
 
 		static SharedPtr create(RenderContext* pRenderContext, const Dictionary& dict = {});
 
+		virtual ~OpenDenoisePass();
+
 		virtual Dictionary getScriptingDictionary() override;
 		virtual RenderPassReflection reflect(const CompileData& compileData) override;
 		virtual void compile(RenderContext* pRenderContext, const CompileData& compileData) override;
@@ -63,34 +69,105 @@ class PASS_API OpenDenoisePass : public RenderPass {
         void useAlbedo(bool state);
         void useNormal(bool state);
 
+        /** Enable asynchronous denoising. In async mode textures are read back one frame late and filtered on a worker thread,
+            output keeps the last denoised image (or a copy of the input until the first one is ready).
+        */
+        void setAsync(bool state);
+
+        /** Set tile size in pixels (0 means the whole image is filtered at once) and tile overlap used to hide tile seams.
+        */
+        void setTileSize(uint32_t tileSize);
+        void setTileOverlap(uint32_t tileOverlap);
+
         bool enabledAlbedo() const { return mUseAlbedo; }
         bool enabledNormal() const { return mUseNormal; }
         bool enabledHDRInput() const { return !mDisableHDRInput; }
+        bool isAsync() const { return mAsync; }
+        uint32_t getTileSize() const { return mTileSize; }
+        uint32_t getTileOverlap() const { return mTileOverlap; }
+
+        /** Block until currently running asynchronous denoise task finishes.
+        */
+        void waitForPendingTask();
+
+        /** Make next execute() denoise synchronously even in async mode, so the final image of a frame is a denoise of the
+            finished accumulation. Pending asynchronous task is waited for and it's result dropped.
+        */
+        void requestSyncDenoise() { mSyncDenoiseRequested = true; }
+
+        /** Drop asynchronous state when a new image starts accumulating, so earlier image denoise is never shown for it.
+        */
+        void reset() { resetAsyncState(); }
 
   private:
 		OpenDenoisePass(Device::SharedPtr pDevice, ResourceFormat outputFormat);
 
         void parseDictionary(const Dictionary& dict);
         
+        struct DenoiseImage {
+            std::vector<uint8_t> data;
+            oidn::Format format = oidn::Format::Undefined;
+            size_t bytePixelStride = 0;
+            CopyContext::ReadTextureTask::SharedPtr pReadTask;
+        };
+
+        // Everything worker needs to denoise a single frame. Two of these are used to double buffer readback in async mode.
+        struct DenoiseJob {
+            uint2 frameDim = { 0, 0 };
+            bool hdr = false;
+            Quality quality = Quality::High;
+            uint32_t tileSize = 0;
+            uint32_t tileOverlap = 0;
+            DenoiseImage color;
+            DenoiseImage albedo;
+            DenoiseImage normal;
+            DenoiseImage output;
+        };
+
         // Bypasses denoising by just copying input image to output
         void bypass(RenderContext* pRenderContext, const RenderData& renderData);
 
+        // Fills job image descriptions and issues (async) texture readbacks. Returns false on inputs mismatch.
+        bool prepareJob(RenderContext* pRenderContext, const RenderData& renderData, DenoiseJob& job, bool async);
+
+        // Waits for readbacks issued by prepareJob and copies source alpha to output
+        void finishJobReadback(DenoiseJob& job);
+
+        // Runs OIDN filter(s) over the job images. Safe to call from a worker thread. Returns false on OIDN error.
+        bool denoise(DenoiseJob& job);
+
+        oidn::FilterRef& getFilter(const DenoiseJob& job, uint32_t width, uint32_t height);
+
+        void executeAsync(RenderContext* pRenderContext, const RenderData& renderData);
+        void resetAsyncState();
+
 		ResourceFormat mOutputFormat;       // Output format (uses default when set to ResourceFormat::Unknown).
 		uint2 mFrameDim = { 0, 0 };
 
         bool  mDisableHDRInput = false;
 
 		oidn::DeviceRef mOidnDevice;
-        oidn::FilterRef mFilter;
 
-		std::vector<uint8_t> mMainImageData;
-		std::vector<uint8_t> mAlbedoImageData;
-		std::vector<uint8_t> mNormalImageData;
-		std::vector<uint8_t> mOutputImageData;
+        // Committed filters cached by tile dimensions and filter parameters. Accessed only by the thread running denoise().
+        std::map<uint64_t, oidn::FilterRef> mFilters;
+        std::vector<uint8_t> mTileOutputData;
+
+        std::array<DenoiseJob, 2> mJobs;
+
+        static constexpr uint32_t kNoJob = uint32_t(-1);
+        uint32_t mReadbackJobIdx = kNoJob;  // Job waiting for its readback to complete
+        uint32_t mRunningJobIdx = kNoJob;   // Job being denoised on a worker thread
+        TaskScheduler::Future<bool> mDenoiseTask;
+        bool mHasDenoisedOutput = false;
+        bool mSyncDenoiseRequested = false;
 
         bool mUseAlbedo = false;
         bool mUseNormal = false;
 
+        bool mAsync = false;
+        uint32_t mTileSize = 0;
+        uint32_t mTileOverlap = 32;
+
         Quality mQuality = Quality::High;
 };
 
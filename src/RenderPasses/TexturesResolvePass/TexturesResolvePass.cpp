@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <chrono>
+#include <limits>
 #include <unordered_set>
 
 #include "Falcor/Core/API/RenderContext.h"
@@ -37,6 +38,10 @@ namespace {
 	const std::string kRayDiffuseLimit = "rayDiffuseLimit";
 
 	const std::string kAsyncLtxLoading = "asyncLtxLoading";
+	const std::string kFeedbackLatency = "feedbackLatency";
+
+	// Max number of page requests gathered by a single resolve execution
+	const uint32_t kMaxRequestedPagesCount = 1u << 18;
 
 }  // namespace
 
@@ -46,6 +51,7 @@ void TexturesResolvePass::parseDictionary(const Dictionary& dict) {
         else if (key == kRayRefractLimit) setRayRefractLimit(value);
         else if (key == kRayDiffuseLimit) setRayDiffuseLimit(value);
         else if (key == kAsyncLtxLoading) setAsyncLoading(static_cast<bool>(value));
+        else if (key == kFeedbackLatency) setFeedbackLatency(static_cast<uint32_t>(value));
     }
 }
 
@@ -205,6 +211,12 @@ void TexturesResolvePass::execute(RenderContext* pContext, const RenderData& ren
 	mpVars["PerFrameCB"]["resolvedTexturesCount"] = resolvedTexturesCount;
 	mpVars["PerFrameCB"]["numberOfMipCalibrationTextures"] = (int32_t)mMipCalibrationTextures.size();
 
+	auto pPagesBuffer = pTextureManager->getPagesResidencyBuffer();
+	createFeedbackBuffers(pPagesBuffer ? static_cast<uint32_t>(pPagesBuffer->getSize()) : 0u);
+	mpVars["PerFrameCB"]["requestedPagesCapacity"] = mRequestedPagesCapacity;
+	mpVars["requestedPagesBuffer"] = mpRequestedPagesBuffer;
+	mpVars["requestedPagesCounterBuffer"] = mpRequestedPagesCounterBuffer;
+
 	mpVars["mipCalibrationTexture"] = mpMipCalibrationTexture;
 	mpVars["ltxCalibrationTexture"] = mpLtxCalibrationTexture;
 
@@ -217,74 +229,153 @@ void TexturesResolvePass::execute(RenderContext* pContext, const RenderData& ren
 	mpVars["gCalibrationMaxSampler"] = mpMaxSampler;
 
 	mpScene->rasterize(pContext, mpState.get(), mpVars.get(), RasterizerState::CullMode::None);
-	pContext->flush(true);
-
-	// Test resolved data
-	auto pPagesBuffer = pTextureManager->getPagesResidencyBuffer();
-	
-	const int8_t* pOutPagesData = pPagesBuffer ? reinterpret_cast<const int8_t*>(pPagesBuffer->map(Buffer::MapType::Read)) : nullptr;
 
 	// Load texture pages
 	auto started = std::chrono::high_resolution_clock::now();
 
-	std::unordered_set<Texture::SharedPtr> textures;
+	std::unordered_set<Texture::SharedPtr> texturesSet;
 	
 	for (auto const& pTexture : materialTextures) {
 		if(pTexture->isUDIMTexture()) {
 			for( const auto& tileInfo: pTexture->getUDIMTileInfos()) {
-				if( tileInfo.pTileTexture && tileInfo.pTileTexture->isSparse()) textures.insert(tileInfo.pTileTexture);
+				if( tileInfo.pTileTexture && tileInfo.pTileTexture->isSparse()) texturesSet.insert(tileInfo.pTileTexture);
 			}
 		} else if(pTexture->isSparse()) {
-			textures.insert(pTexture);
+			texturesSet.insert(pTexture);
+		}
+
+	}
+
+	mResolvedTextures.assign(texturesSet.begin(), texturesSet.end());
+
+	// Queue compacted requested pages readback and consume finished ones. No GPU queue stall here
+	submitFeedbackReadback(pContext);
+	processFeedbackReadbacks();
+
+	auto done = std::chrono::high_resolution_clock::now();
+	LLOG_DBG << "Pages loading done in: " << std::chrono::duration_cast<std::chrono::milliseconds>(done-started).count() << " ms.";
+	LLOG_INF << "TexturesResolvePass done in: " << std::setprecision(6) 
+			 << (.001f * (float)std::chrono::duration_cast<std::chrono::milliseconds>(done-exec_started).count()) << " s";
+
+	mDirty = false;
+}
+
+void TexturesResolvePass::createFeedbackBuffers(uint32_t residencyPagesCount) {
+	if(mpRequestedPagesBuffer && (mResidencyPagesCount == residencyPagesCount)) return;
+
+	// Residency data changed. Requests still in flight refer to the old pages layout
+	for(auto& readback: mFeedbackRing) readback = {};
+
+	mResidencyPagesCount = residencyPagesCount;
+	mRequestedPagesCapacity = std::max(1u, std::min(residencyPagesCount, kMaxRequestedPagesCount));
+
+	mpRequestedPagesBuffer = Buffer::createStructured(mpDevice, sizeof(uint32_t), mRequestedPagesCapacity, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+	
+	const uint32_t zero = 0;
+	mpRequestedPagesCounterBuffer = Buffer::create(mpDevice, sizeof(uint32_t), Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, &zero);
+
+	for(auto& readback: mFeedbackRing) {
+		readback.pStagingBuffer = Buffer::create(mpDevice, (mRequestedPagesCapacity + 1) * sizeof(uint32_t), Resource::BindFlags::None, Buffer::CpuAccess::Read);
+	}
+
+	if(!mpFeedbackFence) mpFeedbackFence = GpuFence::create(mpDevice);
+}
+
+void TexturesResolvePass::submitFeedbackReadback(RenderContext* pContext) {
+	auto& readback = mFeedbackRing[mFeedbackFrame % kFeedbackRingSize];
+	
+	// Ring is full. This only happens when GPU is more than kFeedbackRingSize resolves behind
+	if(readback.pending) {
+		LLOG_DBG << "Textures resolve feedback ring is full. Waiting for the oldest readback";
+		processFeedbackReadbacks();
+	}
+
+	pContext->copyBufferRegion(readback.pStagingBuffer.get(), 0, mpRequestedPagesCounterBuffer.get(), 0, sizeof(uint32_t));
+	pContext->copyBufferRegion(readback.pStagingBuffer.get(), sizeof(uint32_t), mpRequestedPagesBuffer.get(), 0, mRequestedPagesCapacity * sizeof(uint32_t));
+	pContext->clearUAV(mpRequestedPagesCounterBuffer->getUAV().get(), uint4(0));
+
+	// Submit command list and insert signal
+	pContext->flush(false);
+	readback.fenceValue = mpFeedbackFence->gpuSignal(pContext->getLowLevelData()->getCommandQueue());
+	readback.pending = true;
+
+	mFeedbackFrame++;
+}
+
+void TexturesResolvePass::processFeedbackReadbacks() {
+	const uint32_t latency = std::min(mFeedbackLatency, kFeedbackRingSize - 1);
+
+	// Walk pending readbacks from the oldest one
+	for(uint32_t i = kFeedbackRingSize; i > 0; --i) {
+		if(mFeedbackFrame < i) continue;
+		auto& readback = mFeedbackRing[(mFeedbackFrame - i) % kFeedbackRingSize];
+		if(!readback.pending) continue;
+
+		// Readbacks younger than requested latency are only consumed when already finished on GPU
+		if(mpFeedbackFence->getGpuValue() < readback.fenceValue) {
+			if((i - 1) < latency) break;
+			mpFeedbackFence->syncCpu(readback.fenceValue);
 		}
 
+		const uint32_t* pData = reinterpret_cast<const uint32_t*>(readback.pStagingBuffer->map(Buffer::MapType::Read));
+		const uint32_t requestedPagesCount = pData[0];
+		if(requestedPagesCount > mRequestedPagesCapacity) {
+			LLOG_DBG << std::to_string(requestedPagesCount - mRequestedPagesCapacity) << " page requests postponed due to feedback buffer overflow";
+		}
+		loadRequestedPages(pData + 1, std::min(requestedPagesCount, mRequestedPagesCapacity));
+		readback.pStagingBuffer->unmap();
+		readback.pending = false;
 	}
+}
 
-	if(mLoadPagesAsync) mpDevice->flushAndSync();
+void TexturesResolvePass::loadRequestedPages(const uint32_t* pPageIDs, uint32_t pageIDsCount) {
+	const auto& textures = mResolvedTextures;
+	if(pageIDsCount == 0 || textures.empty()) return;
+
+	auto pTextureManager = mpScene->materialSystem()->textureManager();
+
+	// Textures sorted by their first page in residency buffer
+	std::vector<std::pair<uint32_t, size_t>> texturePagesRanges;
+	texturePagesRanges.reserve(textures.size());
+	for(size_t i = 0; i < textures.size(); ++i) {
+		texturePagesRanges.emplace_back(static_cast<uint32_t>(pTextureManager->getVirtualTexturePagesStartIndex(textures[i].get())), i);
+	}
+	std::sort(texturePagesRanges.begin(), texturePagesRanges.end());
 
 	std::vector<std::pair<Texture::SharedPtr, std::vector<uint32_t>>> texturesToPageIDsList;
-	texturesToPageIDsList.reserve(textures.size()); 
-
-	for ( auto const& pTex: textures) {
-		uint32_t pagesStartOffset = pTextureManager->getVirtualTexturePagesStartIndex(pTex.get());
-		uint32_t texturePagesCount = pTex->sparseDataPagesCount();
-		LLOG_DBG << "Analyzing " << std::to_string(texturePagesCount) << " pages for texture: " << pTex->getSourceFilename();
-		LLOG_DBG << "Virtual texture " << pTex->getSourceFilename() << " pages start offset is " << std::to_string(pagesStartOffset);
-
-		texturesToPageIDsList.emplace_back(std::make_pair(pTex,  std::vector<uint32_t>()));
-		auto& texturePageIDs = texturesToPageIDsList.back().second;
-
-		// index 'i' is a page index relative to the texture. starts with 0
-		if(pOutPagesData) {
-			for(uint32_t i = 0; i < texturePagesCount; ++i) {
-				if (pOutPagesData[i + pagesStartOffset] != 0) {
-					texturePageIDs.push_back(i);
-				}
-			}
-			LLOG_DBG << std::to_string(texturePageIDs.size()) << " pages need to be loaded for texture " << pTex->getSourceFilename();
+	std::vector<int32_t> textureToListIndex(textures.size(), -1);
+
+	// index 'pageIndex' is a page index relative to the texture. starts with 0
+	for(uint32_t i = 0; i < pageIDsCount; ++i) {
+		const uint32_t pageID = pPageIDs[i];
+		auto it = std::upper_bound(texturePagesRanges.begin(), texturePagesRanges.end(), std::make_pair(pageID, std::numeric_limits<size_t>::max()));
+		if(it == texturePagesRanges.begin()) continue;
+		--it;
+
+		const auto& pTexture = textures[it->second];
+		const uint32_t pageIndex = pageID - it->first;
+		if(pageIndex >= pTexture->sparseDataPagesCount()) continue;
+
+		auto& listIndex = textureToListIndex[it->second];
+		if(listIndex < 0) {
+			listIndex = static_cast<int32_t>(texturesToPageIDsList.size());
+			texturesToPageIDsList.emplace_back(std::make_pair(pTexture, std::vector<uint32_t>()));
 		}
+		texturesToPageIDsList[listIndex].second.push_back(pageIndex);
 	}
 
+	for(const auto& textureToPagesPair: texturesToPageIDsList) {
+		LLOG_DBG << std::to_string(textureToPagesPair.second.size()) << " pages need to be loaded for texture " << textureToPagesPair.first->getSourceFilename();
+	}
+
+	// No host side wait before loading. Sparse binds are ordered against rendering by TextureManager timeline fence
 	if(mLoadPagesAsync) {
 		pTextureManager->loadPagesAsync(texturesToPageIDsList); 
+		// In async mode we have to call updateSparseBindInfo on TextureManager as it triggers wait() function on pages loading multi-future
+		pTextureManager->updateSparseBindInfo();
 	} else {
-		for(auto& textureToPagesPair: texturesToPageIDsList) {
-			pTextureManager->loadPages(textureToPagesPair.first, textureToPagesPair.second); 
-		} 
+		pTextureManager->loadPages(texturesToPageIDsList);
 	}
-
-	
-	if(pPagesBuffer) pPagesBuffer->unmap();
-
-	// In async mode we have to call updateSparseBindInfo on TextureManager as it triggers wait() function on pages loading multi-future
-	if(mLoadPagesAsync) pTextureManager->updateSparseBindInfo();
-
-	auto done = std::chrono::high_resolution_clock::now();
-	LLOG_DBG << "Pages loading done in: " << std::chrono::duration_cast<std::chrono::milliseconds>(done-started).count() << " ms.";
-	LLOG_INF << "TexturesResolvePass done in: " << std::setprecision(6) 
-			 << (.001f * (float)std::chrono::duration_cast<std::chrono::milliseconds>(done-exec_started).count()) << " s";
-
-	mDirty = false;
 }
 
 TexturesResolvePass& TexturesResolvePass::setDepthStencilState(const DepthStencilState::SharedPtr& pDsState) {
@@ -388,6 +479,11 @@ TexturesResolvePass& TexturesResolvePass::setAsyncLoading(bool mode) {
 	return *this;
 }
 
+TexturesResolvePass& TexturesResolvePass::setFeedbackLatency(uint32_t latency) {
+	mFeedbackLatency = std::min(latency, kFeedbackRingSize - 1);
+	return *this;
+}
+
 TexturesResolvePass& TexturesResolvePass::setRayReflectLimit(int limit) {
     uint32_t _limit = std::max(0u, std::min(10u, static_cast<uint32_t>(limit)));
     if(mRayReflectLimit == _limit) return *this;
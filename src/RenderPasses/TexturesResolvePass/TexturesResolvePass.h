@@ -34,6 +34,8 @@
 #include "Falcor/RenderGraph/RenderPass.h"
 #include "Falcor/Utils/Math/Vector.h"
 
+#include <array>
+
 #include <slang/slang.h>
 
 using namespace Falcor;
@@ -72,6 +74,12 @@ class dllpassdecl TexturesResolvePass : public RenderPass {
 		TexturesResolvePass&  	setRayDiffuseLimit(int limit);
 		
 		TexturesResolvePass&  	setAsyncLoading(bool mode);
+
+		/** Set number of frames the requested pages readback lags behind the resolve rasterization.
+		    0 means pages requested by this execution are loaded right away (CPU waits for the readback copy only),
+		    1 or more never stalls on the GPU. Clamped to kFeedbackRingSize - 1.
+		*/
+		TexturesResolvePass&  	setFeedbackLatency(uint32_t latency);
 		
 	private:
 		TexturesResolvePass(Device::SharedPtr pDevice, const Dictionary& dict);
@@ -85,6 +93,19 @@ class dllpassdecl TexturesResolvePass : public RenderPass {
 
 		void setDefaultSampler();
 
+		void createFeedbackBuffers(uint32_t residencyPagesCount);
+		void submitFeedbackReadback(RenderContext* pContext);
+		void processFeedbackReadbacks();
+		void loadRequestedPages(const uint32_t* pPageIDs, uint32_t pageIDsCount);
+
+		static constexpr uint32_t kFeedbackRingSize = 3;
+
+		struct FeedbackReadback {
+			Buffer::SharedPtr pStagingBuffer;   ///< Requested pages counter followed by page IDs
+			uint64_t          fenceValue = 0;
+			bool              pending = false;
+		};
+
 		Fbo::SharedPtr              mpFbo;
 		GraphicsState::SharedPtr    mpState;
 		GraphicsVars::SharedPtr     mpVars;
@@ -106,6 +127,17 @@ class dllpassdecl TexturesResolvePass : public RenderPass {
 		Buffer::SharedPtr           mpTexResolveDataBuffer;
 		bool                        mUsePreGenDepth = false;
 
+		Buffer::SharedPtr           mpRequestedPagesBuffer;
+		Buffer::SharedPtr           mpRequestedPagesCounterBuffer;
+		uint32_t                    mRequestedPagesCapacity = 0;
+		uint32_t                    mResidencyPagesCount = 0;
+
+		std::array<FeedbackReadback, kFeedbackRingSize> mFeedbackRing;
+		GpuFence::SharedPtr         mpFeedbackFence;
+		uint32_t                    mFeedbackFrame = 0;
+		uint32_t                    mFeedbackLatency = 1;
+		std::vector<Texture::SharedPtr> mResolvedTextures;  ///< Sparse textures (and UDIM tiles) requested pages are mapped to
+
 		bool                        mLoadPagesAsync = false; //true;
 		bool 								 mDirty = true;
 
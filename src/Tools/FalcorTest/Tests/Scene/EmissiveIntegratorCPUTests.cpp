@@ -0,0 +1,189 @@
+/***************************************************************************
+ # Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include <random>
+
+#include "Testing/UnitTest.h"
+#include "Scene/Lights/EmissiveIntegratorCPU.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/Material/StandardMaterial.h"
+#include "Utils/Image/Bitmap.h"
+
+namespace Falcor
+{
+    namespace
+    {
+        float maxAbsDiff(const float3& a, const float3& b)
+        {
+            const float3 d = glm::abs(a - b);
+            return std::max(d.x, std::max(d.y, d.z));
+        }
+
+        /** Creates a scene with a single emissive grid mesh using a random texture. Texture coordinates span a few
+            texture periods, so wrapping and triangles covering partial texels are exercised.
+        */
+        Scene::SharedPtr createEmissiveScene(Device::SharedPtr pDevice, const fs::path& texturePath)
+        {
+            const uint32_t texDim = 32;
+            std::mt19937 rng(7);
+            std::uniform_int_distribution<uint32_t> dist(0, 255);
+            std::vector<uint8_t> texels(texDim * texDim * 4);
+            for (auto& t : texels) t = (uint8_t)dist(rng);
+            Bitmap::saveImage(texturePath.string(), texDim, texDim, Bitmap::FileFormat::PngFile, Bitmap::ExportFlags::None, ResourceFormat::RGBA8Unorm, true, texels.data());
+
+            auto pTexture = Texture::createFromFile(pDevice, texturePath.string(), true, false);
+            if (!pTexture) return nullptr;
+
+            auto pMaterial = StandardMaterial::create(pDevice, "Emissive");
+            pMaterial->setEmissiveTexture(pTexture);
+            pMaterial->setEmissiveFactor(2.f);
+
+            const uint32_t gridDim = 6;
+            std::uniform_real_distribution<float> jitter(-0.2f, 0.2f);
+            auto pMesh = TriangleMesh::create();
+            for (uint32_t y = 0; y <= gridDim; y++)
+            {
+                for (uint32_t x = 0; x <= gridDim; x++)
+                {
+                    const float2 uv = float2(x + jitter(rng), y + jitter(rng)) * (2.5f / gridDim) - 0.75f;
+                    pMesh->addVertex(float3(x, y, 0.f) * 0.5f, float3(0.f, 0.f, 1.f), uv);
+                }
+            }
+            for (uint32_t y = 0; y < gridDim; y++)
+            {
+                for (uint32_t x = 0; x < gridDim; x++)
+                {
+                    const uint32_t i = y * (gridDim + 1) + x;
+                    pMesh->addTriangle(i, i + 1, i + gridDim + 2);
+                    pMesh->addTriangle(i, i + gridDim + 2, i + gridDim + 1);
+                }
+            }
+
+            auto pBuilder = SceneBuilder::create(pDevice);
+            const uint32_t meshID = pBuilder->addTriangleMesh(pMesh, pMaterial);
+            SceneBuilder::Node node;
+            node.name = "EmissiveGrid";
+            node.transform = glm::scale(float4x4(1.f), float3(1.f, 2.f, 1.f));
+            pBuilder->addMeshInstance(pBuilder->addNode(node), meshID);
+            return pBuilder->getScene();
+        }
+    }
+
+    CPU_TEST(EmissiveIntegratorCPUClippedArea)
+    {
+        const float2 tri[3] = { float2(0.f, 0.f), float2(4.f, 0.f), float2(0.f, 4.f) };
+
+        // Box fully inside, fully outside, and cut by the hypotenuse.
+        EXPECT_EQ(EmissiveIntegratorCPU::computeClippedTriangleArea(tri, float2(0.f), float2(1.f)), 1.f);
+        EXPECT_EQ(EmissiveIntegratorCPU::computeClippedTriangleArea(tri, float2(3.f), float2(4.f)), 0.f);
+        EXPECT_LE(std::abs(EmissiveIntegratorCPU::computeClippedTriangleArea(tri, float2(1.f, 2.f), float2(2.f, 3.f)) - 0.5f), 1e-6f);
+
+        // Triangle inside the box, area is independent of winding.
+        const float2 flipped[3] = { tri[0], tri[2], tri[1] };
+        EXPECT_EQ(EmissiveIntegratorCPU::computeClippedTriangleArea(flipped, float2(-1.f), float2(5.f)), 8.f);
+    }
+
+    CPU_TEST(EmissiveIntegratorCPUTexels)
+    {
+        // 2x1 texture, red on the left and green on the right.
+        std::vector<float3> texels = { float3(1.f, 0.f, 0.f), float3(0.f, 1.f, 0.f) };
+        auto pTexels = EmissiveIntegratorCPU::TexelData::create(2, 1, std::move(texels), Sampler::AddressMode::Wrap, Sampler::AddressMode::Wrap);
+        EXPECT_EQ(pTexels->mips.size(), size_t(2));
+        EXPECT(pTexels->mips[1].texels[0] == float3(0.5f, 0.5f, 0.f));
+
+        // The triangle covers 3/4 of the left texel and 1/4 of the right one.
+        const float2 uv[3] = { float2(0.f, 0.f), float2(1.f, 0.f), float2(0.f, 1.f) };
+        EXPECT_LE(maxAbsDiff(EmissiveIntegratorCPU::integrateTriangle(*pTexels, uv), float3(0.75f, 0.25f, 0.f)), 1e-6f);
+
+        // Same triangle moved by whole texture periods.
+        const float2 uvWrapped[3] = { uv[0] + float2(3.f, -2.f), uv[1] + float2(3.f, -2.f), uv[2] + float2(3.f, -2.f) };
+        EXPECT_LE(maxAbsDiff(EmissiveIntegratorCPU::integrateTriangle(*pTexels, uvWrapped), float3(0.75f, 0.25f, 0.f)), 1e-5f);
+
+        // Degenerate triangles fall back to the texels at the vertices.
+        const float2 uvLine[3] = { float2(0.25f, 0.5f), float2(0.25f, 0.5f), float2(0.75f, 0.5f) };
+        EXPECT_LE(maxAbsDiff(EmissiveIntegratorCPU::integrateTriangle(*pTexels, uvLine), float3(2.f / 3.f, 1.f / 3.f, 0.f)), 1e-6f);
+    }
+
+    CPU_TEST(EmissiveIntegratorCPUMipLevels)
+    {
+        // Triangles too large for the texel budget are integrated at a coarser mip. Compare against mip 0 only.
+        const uint32_t dim = 256;
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> dist(0.f, 4.f);
+        std::vector<float3> texels(dim * dim);
+        for (auto& t : texels) t = float3(dist(rng), dist(rng), dist(rng));
+
+        auto pTexels = EmissiveIntegratorCPU::TexelData::create(dim, dim, std::vector<float3>(texels), Sampler::AddressMode::Wrap, Sampler::AddressMode::Wrap);
+        EmissiveIntegratorCPU::TexelData baseOnly;
+        baseOnly.mips.push_back(pTexels->mips[0]);
+
+        const float2 uv[3] = { float2(0.1f, 0.05f), float2(0.95f, 0.2f), float2(0.3f, 0.9f) };
+        const float3 reference = EmissiveIntegratorCPU::integrateTriangle(baseOnly, uv);
+        const float3 result = EmissiveIntegratorCPU::integrateTriangle(*pTexels, uv);
+        EXPECT_LE(maxAbsDiff(result, reference), 0.02f);
+
+        // Constant textures integrate exactly at any level.
+        std::vector<float3> constant(dim * dim, float3(2.f, 1.f, 0.5f));
+        auto pConstant = EmissiveIntegratorCPU::TexelData::create(dim, dim, std::move(constant), Sampler::AddressMode::Clamp, Sampler::AddressMode::Clamp);
+        EXPECT_LE(maxAbsDiff(EmissiveIntegratorCPU::integrateTriangle(*pConstant, uv), float3(2.f, 1.f, 0.5f)), 1e-5f);
+    }
+
+    GPU_TEST(EmissiveIntegratorCPUMatchesGPU)
+    {
+        const fs::path texturePath = fs::temp_directory_path() / "EmissiveIntegratorCPUTest.png";
+        Scene::SharedPtr pScene = createEmissiveScene(ctx.getRenderContext()->device(), texturePath);
+        EXPECT(pScene != nullptr);
+        if (!pScene) return;
+
+        // Scene light collection takes the triangles integrated on the CPU at scene creation, the other one runs the GPU passes.
+        RenderContext* pRenderContext = ctx.getRenderContext();
+        const auto& pCPUCollection = pScene->getLightCollection(pRenderContext);
+        auto pGPUCollection = LightCollection::create(pRenderContext, pScene);
+        EXPECT(pCPUCollection->isIntegratedOnCPU());
+        EXPECT(!pGPUCollection->isIntegratedOnCPU());
+
+        const auto& cpuTriangles = pCPUCollection->getMeshLightTriangles();
+        const auto& gpuTriangles = pGPUCollection->getMeshLightTriangles();
+        EXPECT_EQ(cpuTriangles.size(), size_t(72));
+        EXPECT_EQ(cpuTriangles.size(), gpuTriangles.size());
+
+        for (size_t i = 0; i < std::min(cpuTriangles.size(), gpuTriangles.size()); i++)
+        {
+            const auto& cpu = cpuTriangles[i];
+            const auto& gpu = gpuTriangles[i];
+            for (uint32_t j = 0; j < 3; j++) EXPECT_LE(maxAbsDiff(cpu.vtx[j].pos, gpu.vtx[j].pos), 1e-5f) << "triangle " << i;
+            EXPECT_LE(std::abs(cpu.area - gpu.area), 1e-5f * gpu.area) << "triangle " << i;
+
+            // Radiance is summed with atomics in fp32 on the GPU, so only rounding level differences are expected.
+            const float radianceScale = std::max(1.f, std::max(gpu.averageRadiance.x, std::max(gpu.averageRadiance.y, gpu.averageRadiance.z)));
+            EXPECT_LE(maxAbsDiff(cpu.averageRadiance, gpu.averageRadiance), 1e-3f * radianceScale) << "triangle " << i;
+            EXPECT_LE(std::abs(cpu.flux - gpu.flux), 1e-3f * std::max(gpu.flux, 1e-6f)) << "triangle " << i;
+        }
+
+        fs::remove(texturePath);
+    }
+}
@@ -0,0 +1,118 @@
+/***************************************************************************
+ # Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include <fstream>
+
+#include "Testing/UnitTest.h"
+#include "Experimental/Scene/Lights/EnvMapImportanceCache.h"
+
+namespace Falcor
+{
+    namespace
+    {
+        void writeFile(const fs::path& path, const std::vector<char>& content)
+        {
+            std::ofstream file(path.string(), std::ios::binary | std::ios::trunc);
+            file.write(content.data(), content.size());
+        }
+    }
+
+    CPU_TEST(EnvMapImportanceCacheKey)
+    {
+        const fs::path dir = fs::temp_directory_path() / fs::unique_path("EnvMapImportanceCacheKey-%%%%%%");
+        fs::create_directories(dir);
+        const fs::path envMapPath = dir / "env.exr";
+
+        std::vector<char> content(100000);
+        for (size_t i = 0; i < content.size(); i++) content[i] = (char)(i * 31);
+        writeFile(envMapPath, content);
+
+        EnvMapImportanceCache::Params params;
+        params.dimension = 512;
+        params.samples = 64;
+
+        EnvMapImportanceCache::Key key, otherKey;
+        EXPECT(EnvMapImportanceCache::computeKey(envMapPath, params, key));
+        EXPECT(EnvMapImportanceCache::computeKey(envMapPath, params, otherKey));
+        EXPECT(key == otherKey);
+
+        // Build parameters are part of the key.
+        EnvMapImportanceCache::Params otherParams = params;
+        otherParams.sourceMip = 2;
+        EXPECT(EnvMapImportanceCache::computeKey(envMapPath, otherParams, otherKey));
+        EXPECT(key != otherKey);
+
+        // So is the content.
+        content[content.size() / 2]++;
+        writeFile(envMapPath, content);
+        EXPECT(EnvMapImportanceCache::computeKey(envMapPath, params, otherKey));
+        EXPECT(key != otherKey);
+
+        EXPECT(!EnvMapImportanceCache::computeKey(dir / "missing.exr", params, otherKey));
+        EXPECT(EnvMapImportanceCache::getCachePath(envMapPath) == dir / "env.exr.imap");
+
+        fs::remove_all(dir);
+    }
+
+    CPU_TEST(EnvMapImportanceCacheStoreLoad)
+    {
+        const fs::path dir = fs::temp_directory_path() / fs::unique_path("EnvMapImportanceCacheStoreLoad-%%%%%%");
+        fs::create_directories(dir);
+        const fs::path cachePath = dir / "env.exr.imap";
+
+        const uint32_t dimension = 16;
+        std::vector<float> data(dimension * dimension);
+        for (size_t i = 0; i < data.size(); i++) data[i] = (float)i * 0.25f;
+
+        EnvMapImportanceCache::Key key = {};
+        key[0] = 1;
+        EXPECT(!EnvMapImportanceCache::store(cachePath, key, dimension + 1, data));
+        EXPECT(EnvMapImportanceCache::store(cachePath, key, dimension, data));
+
+        std::vector<float> loaded;
+        EXPECT(EnvMapImportanceCache::load(cachePath, key, dimension, loaded));
+        EXPECT(loaded == data);
+
+        // Stale or mismatching caches are rejected.
+        EnvMapImportanceCache::Key otherKey = key;
+        otherKey[19] = 7;
+        EXPECT(!EnvMapImportanceCache::load(cachePath, otherKey, dimension, loaded));
+        EXPECT(!EnvMapImportanceCache::load(cachePath, key, dimension * 2, loaded));
+
+        // Truncated files too.
+        fs::resize_file(cachePath, fs::file_size(cachePath) - 4);
+        EXPECT(!EnvMapImportanceCache::load(cachePath, key, dimension, loaded));
+
+        // Only the cache file is left behind.
+        EXPECT(EnvMapImportanceCache::store(cachePath, key, dimension, data));
+        size_t fileCount = 0;
+        for (fs::directory_iterator it(dir); it != fs::directory_iterator(); ++it) fileCount++;
+        EXPECT_EQ(fileCount, 1);
+
+        fs::remove_all(dir);
+    }
+}
@@ -0,0 +1,173 @@
+/***************************************************************************
+ # Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include <algorithm>
+#include <random>
+
+#include "Testing/UnitTest.h"
+#include "Scene/GeometryInstanceTracker.h"
+
+namespace Falcor
+{
+    namespace
+    {
+        using Range = DirtyRangeTracker::Range;
+
+        GeometryInstanceData meshInstance(uint32_t matrixID)
+        {
+            GeometryInstanceData instance(GeometryType::TriangleMesh);
+            instance.globalMatrixID = matrixID;
+            return instance;
+        }
+    }
+
+    CPU_TEST(DirtyRangeTrackerCoalesce)
+    {
+        DirtyRangeTracker tracker;
+        EXPECT(!tracker.isDirty());
+        EXPECT(tracker.getRanges().empty());
+
+        // Unordered and overlapping marks, adjacent ranges merge even without a gap allowance.
+        tracker.markDirty(10);
+        tracker.markDirty(2, 3);
+        tracker.markDirty(11, 4);
+        tracker.markDirty(5);
+        tracker.markDirty(3);
+        tracker.markDirty(20, 0);
+        tracker.markDirty(40);
+        EXPECT(tracker.isDirty());
+
+        std::vector<Range> expected = { {2, 4}, {10, 5}, {40, 1} };
+        EXPECT(tracker.getRanges() == expected);
+        EXPECT_EQ(tracker.getDirtyElementCount(), 10);
+
+        // Marking after coalescing keeps the result sorted.
+        tracker.markDirty(0);
+        expected = { {0, 1}, {2, 4}, {10, 5}, {40, 1} };
+        EXPECT(tracker.getRanges() == expected);
+
+        tracker.clear();
+        EXPECT(!tracker.isDirty());
+        EXPECT(tracker.getRanges().empty());
+    }
+
+    CPU_TEST(DirtyRangeTrackerMaxGap)
+    {
+        DirtyRangeTracker tracker(4);
+        tracker.markDirty(20);
+        tracker.markDirty(0);
+        tracker.markDirty(5);
+        tracker.markDirty(11);
+        tracker.markDirty(16);
+
+        // 0 and 5 are separated by 4 clean elements, 5 and 11 by 5.
+        std::vector<Range> expected = { {0, 6}, {11, 10} };
+        EXPECT(tracker.getRanges() == expected);
+
+        // Randomized marks: every marked element is covered, ranges are sorted and separated by more than the gap.
+        std::mt19937 rng;
+        std::uniform_int_distribution<uint32_t> dist(0, 9999);
+        std::vector<bool> marked(10000, false);
+        tracker.clear();
+        for (uint32_t i = 0; i < 2000; i++)
+        {
+            uint32_t index = dist(rng);
+            marked[index] = true;
+            tracker.markDirty(index);
+        }
+
+        const auto& ranges = tracker.getRanges();
+        for (size_t i = 1; i < ranges.size(); i++) EXPECT_GT(ranges[i].offset, ranges[i - 1].end() + tracker.getMaxGap());
+        for (uint32_t index = 0; index < marked.size(); index++)
+        {
+            if (!marked[index]) continue;
+            auto it = std::find_if(ranges.begin(), ranges.end(), [index](const Range& r) { return index >= r.offset && index < r.end(); });
+            EXPECT(it != ranges.end());
+        }
+        for (const auto& range : ranges)
+        {
+            EXPECT(marked[range.offset]);
+            EXPECT(marked[range.end() - 1]);
+        }
+    }
+
+    CPU_TEST(GeometryInstanceTrackerMatrixMapping)
+    {
+        std::vector<GeometryInstanceData> instances = { meshInstance(2), meshInstance(0), meshInstance(2), meshInstance(3), meshInstance(2) };
+
+        GeometryInstanceTracker tracker;
+        tracker.init(instances, 5);
+        EXPECT_EQ(tracker.getMatrixCount(), 5);
+
+        EXPECT_EQ(tracker.getInstanceCount(0), 1);
+        EXPECT_EQ(tracker.getInstanceCount(1), 0);
+        EXPECT_EQ(tracker.getInstanceCount(2), 3);
+        EXPECT_EQ(tracker.getInstanceCount(3), 1);
+        EXPECT_EQ(tracker.getInstanceCount(4), 0);
+
+        EXPECT_EQ(tracker.getInstances(0)[0], 1);
+        EXPECT_EQ(tracker.getInstances(2)[0], 0);
+        EXPECT_EQ(tracker.getInstances(2)[1], 2);
+        EXPECT_EQ(tracker.getInstances(2)[2], 4);
+        EXPECT_EQ(tracker.getInstances(3)[0], 3);
+
+        tracker.markAllInstancesDirty();
+        std::vector<Range> expected = { {0, 5} };
+        EXPECT(tracker.getDirtyInstances().getRanges() == expected);
+        tracker.clearDirtyInstances();
+        EXPECT(!tracker.getDirtyInstances().isDirty());
+    }
+
+    CPU_TEST(GeometryInstanceTrackerTransformFlags)
+    {
+        GeometryInstanceData instance = meshInstance(0);
+        const glm::mat4 identity(1.f);
+        const glm::mat4 mirror = glm::scale(glm::mat4(1.f), float3(-1.f, 1.f, 1.f));
+
+        EXPECT(!GeometryInstanceTracker::updateTransformFlags(instance, identity, false));
+        EXPECT(!instance.isWorldFrontFaceCW());
+
+        // Flipping handedness changes the world space winding.
+        EXPECT(GeometryInstanceTracker::updateTransformFlags(instance, mirror, false));
+        EXPECT((instance.flags & (uint32_t)GeometryInstanceFlags::TransformFlipped) != 0);
+        EXPECT(instance.isWorldFrontFaceCW());
+        EXPECT(instance.getType() == GeometryType::TriangleMesh);
+
+        // Same transform again is not a change.
+        EXPECT(!GeometryInstanceTracker::updateTransformFlags(instance, mirror, false));
+
+        EXPECT(GeometryInstanceTracker::updateTransformFlags(instance, mirror, true));
+        EXPECT(!instance.isWorldFrontFaceCW());
+
+        // Non mesh instances are never modified.
+        GeometryInstanceData curve(GeometryType::Curve);
+        curve.globalMatrixID = 0;
+        const uint32_t curveFlags = curve.flags;
+        EXPECT(!GeometryInstanceTracker::updateTransformFlags(curve, mirror, true));
+        EXPECT_EQ(curve.flags, curveFlags);
+    }
+}
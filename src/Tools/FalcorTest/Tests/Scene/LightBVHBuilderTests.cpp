@@ -0,0 +1,165 @@
+#include <random>
+#include <cstring>
+
+#include "Testing/UnitTest.h"
+#include "Experimental/Scene/Lights/LightBVHBuilder.h"
+#include "Utils/Timing/CpuTimer.h"
+
+namespace Falcor
+{
+    namespace
+    {
+        using MeshLightTriangle = LightCollection::MeshLightTriangle;
+
+        /** Generates emissive triangles clustered into a number of "panels", similar to LED walls made of many small emitters.
+        */
+        std::vector<MeshLightTriangle> generateTriangles(uint32_t triangleCount, uint32_t clusterCount)
+        {
+            std::mt19937 rng;
+            std::uniform_real_distribution<float> u(0.f, 1.f);
+
+            std::vector<float3> clusterCenters(clusterCount);
+            for (auto& c : clusterCenters) c = float3(u(rng), u(rng), u(rng)) * 100.f;
+
+            std::vector<MeshLightTriangle> triangles(triangleCount);
+            for (uint32_t i = 0; i < triangleCount; i++)
+            {
+                const float3 p = clusterCenters[i % clusterCount] + float3(u(rng), u(rng), u(rng)) * 5.f;
+                auto& tri = triangles[i];
+                tri.vtx[0].pos = p;
+                tri.vtx[1].pos = p + float3(u(rng), u(rng), 0.f) * 0.1f;
+                tri.vtx[2].pos = p + float3(0.f, u(rng), u(rng)) * 0.1f;
+                tri.normal = glm::normalize(glm::cross(tri.vtx[1].pos - tri.vtx[0].pos, tri.vtx[2].pos - tri.vtx[0].pos));
+                tri.flux = u(rng) + 0.01f;
+                tri.lightIdx = 0;
+            }
+            return triangles;
+        }
+
+        struct BuildOutput
+        {
+            std::vector<PackedNode> nodes;
+            std::vector<uint32_t> triangleIndices;
+            std::vector<uint64_t> triangleBitmasks;
+            double buildTimeMs = 0.0;
+        };
+
+        BuildOutput build(const std::vector<MeshLightTriangle>& triangles, const LightBVHBuilder::Options& options)
+        {
+            BuildOutput output;
+            auto pBuilder = LightBVHBuilder::create(options);
+            auto start = CpuTimer::getCurrentTimePoint();
+            pBuilder->buildCPU(triangles, output.nodes, output.triangleIndices, output.triangleBitmasks);
+            output.buildTimeMs = CpuTimer::calcDuration(start, CpuTimer::getCurrentTimePoint());
+            return output;
+        }
+
+        /** Orientation cost of a bounding cone with half angle theta_o, see Eqn 1 in Conty & Kulla 2018.
+        */
+        float computeOrientationCost(float theta_o)
+        {
+            const float theta_w = std::min(theta_o + glm::half_pi<float>(), glm::pi<float>());
+            const float sin_theta_o = std::sin(theta_o);
+            const float cos_theta_o = std::cos(theta_o);
+            return glm::two_pi<float>() * (1.f - cos_theta_o) + glm::half_pi<float>() * (2.f * theta_w * sin_theta_o - std::cos(theta_o - 2.f * theta_w) - 2.f * theta_o * sin_theta_o + cos_theta_o);
+        }
+
+        /** Tree quality metric: SAOH cost (flux * surface area * orientation cost) summed over all internal nodes
+            relative to the root. Lower is better.
+        */
+        double computeTreeCost(const std::vector<PackedNode>& nodes)
+        {
+            auto nodeCost = [](const PackedNode& node) {
+                const SharedNodeAttributes attribs = node.getNodeAttributes();
+                const float3 e = attribs.extent;
+                const float area = e.x * e.y + e.y * e.z + e.z * e.x;
+                const float theta = attribs.cosConeAngle != kInvalidCosConeAngle ? std::acos(glm::clamp(attribs.cosConeAngle, -1.f, 1.f)) : glm::pi<float>();
+                return (double)attribs.flux * area * computeOrientationCost(theta);
+            };
+
+            const double rootCost = nodeCost(nodes[0]);
+            if (rootCost <= 0.0) return 0.0;
+
+            double cost = 0.0;
+            for (const auto& node : nodes)
+            {
+                if (!node.isLeaf()) cost += nodeCost(node) / rootCost;
+            }
+            return cost;
+        }
+
+        bool isSameTree(const BuildOutput& a, const BuildOutput& b)
+        {
+            return a.nodes.size() == b.nodes.size() &&
+                std::memcmp(a.nodes.data(), b.nodes.data(), a.nodes.size() * sizeof(PackedNode)) == 0 &&
+                a.triangleIndices == b.triangleIndices &&
+                a.triangleBitmasks == b.triangleBitmasks;
+        }
+
+        void checkTree(CPUUnitTestContext& ctx, const BuildOutput& output, size_t triangleCount)
+        {
+            EXPECT(!output.nodes.empty());
+            EXPECT_EQ(output.triangleIndices.size(), triangleCount);
+            EXPECT_EQ(output.triangleBitmasks.size(), triangleCount);
+
+            // Every triangle must be referenced by exactly one leaf.
+            std::vector<uint32_t> refCount(triangleCount, 0);
+            for (const auto& node : output.nodes)
+            {
+                if (!node.isLeaf()) continue;
+                const LeafNode leaf = node.getLeafNode();
+                for (uint32_t i = 0; i < leaf.triangleCount; i++) refCount[output.triangleIndices[leaf.triangleOffset + i]]++;
+            }
+            for (uint32_t count : refCount) EXPECT_EQ(count, 1);
+        }
+    }
+
+    CPU_TEST(LightBVHBuilderParallel)
+    {
+        const auto triangles = generateTriangles(200000, 64);
+
+        LightBVHBuilder::Options options;
+        options.useParallelBuild = false;
+        BuildOutput serial = build(triangles, options);
+        checkTree(ctx, serial, triangles.size());
+
+        // Parallel build must produce exactly the same tree as the serial one.
+        options.useParallelBuild = true;
+        options.parallelBuildThreshold = 1024;
+        BuildOutput parallel = build(triangles, options);
+        EXPECT(isSameTree(serial, parallel));
+
+        options.splitHeuristicSelection = LightBVHBuilder::SplitHeuristic::BinnedSAH;
+        options.useParallelBuild = false;
+        BuildOutput serialSAH = build(triangles, options);
+        options.useParallelBuild = true;
+        BuildOutput parallelSAH = build(triangles, options);
+        EXPECT(isSameTree(serialSAH, parallelSAH));
+    }
+
+    CPU_TEST(LightBVHBuilderMortonTopLevel)
+    {
+        const auto triangles = generateTriangles(200000, 64);
+
+        LightBVHBuilder::Options options;
+        options.useParallelBuild = false;
+        BuildOutput reference = build(triangles, options);
+
+        options.useParallelBuild = true;
+        BuildOutput parallel = build(triangles, options);
+        EXPECT(isSameTree(reference, parallel));
+
+        options.useMortonTopLevel = true;
+        BuildOutput morton = build(triangles, options);
+        checkTree(ctx, morton, triangles.size());
+
+        // Morton top levels trade some tree quality for build time. The SAOH cost must stay close to the full SAOH build.
+        const double referenceCost = computeTreeCost(reference.nodes);
+        const double mortonCost = computeTreeCost(morton.nodes);
+        EXPECT_GT(referenceCost, 0.0);
+        EXPECT_LE(mortonCost, referenceCost * 1.25);
+
+        LLOG_INF << "LightBVHBuilder " << triangles.size() << " triangles: serial SAOH " << reference.buildTimeMs << " ms (cost " << referenceCost << "), "
+            << "parallel SAOH " << parallel.buildTimeMs << " ms, Morton + SAOH " << morton.buildTimeMs << " ms (cost " << mortonCost << ")";
+    }
+}
@@ -0,0 +1,67 @@
+/***************************************************************************
+ # Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include <cstring>
+#include <random>
+
+#include "Testing/UnitTest.h"
+#include "Utils/Math/MatrixSIMD.h"
+
+namespace Falcor
+{
+    namespace
+    {
+        glm::mat4 randomTransform(std::mt19937& rng)
+        {
+            std::uniform_real_distribution<float> u(-4.f, 4.f);
+            glm::mat4 m = glm::translate(glm::mat4(1.f), float3(u(rng), u(rng), u(rng)));
+            m = glm::rotate(m, u(rng), glm::normalize(float3(u(rng), u(rng), u(rng)) + float3(0.f, 0.f, 8.f)));
+            return glm::scale(m, float3(u(rng), u(rng), u(rng)) + float3(5.f, 5.f, -5.f));
+        }
+
+        // Both this file and MatrixSIMD.cpp are built with -ffp-contract=off, so results must match glm bit for bit.
+        void expectSameMatrix(CPUUnitTestContext& ctx, const glm::mat4& expected, const glm::mat4& result)
+        {
+            EXPECT(std::memcmp(&expected, &result, sizeof(glm::mat4)) == 0);
+        }
+    }
+
+    CPU_TEST(MatrixSIMDInverse)
+    {
+        std::mt19937 rng;
+        for (uint32_t i = 0; i < 10000; i++)
+        {
+            const glm::mat4 m = randomTransform(rng);
+            expectSameMatrix(ctx, glm::inverse(m), inverseSIMD(m));
+            expectSameMatrix(ctx, glm::transpose(glm::inverse(m)), inverseTransposeSIMD(m));
+        }
+
+        const glm::mat4 identity(1.f);
+        EXPECT(inverseSIMD(identity) == identity);
+        EXPECT(inverseTransposeSIMD(identity) == identity);
+    }
+}
@@ -0,0 +1,126 @@
+/***************************************************************************
+ # Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/SparseBindBatcher.h"
+
+namespace Falcor
+{
+    namespace
+    {
+        VkImage fakeImage(uint64_t id) { return (VkImage)(uintptr_t)id; }
+        VkDeviceMemory fakeMemory(uint64_t id) { return (VkDeviceMemory)(uintptr_t)id; }
+        VkSemaphore fakeSemaphore(uint64_t id) { return (VkSemaphore)(uintptr_t)id; }
+
+        VkSparseImageMemoryBind imageBind(uint32_t mipLevel, int32_t x, int32_t y, uint64_t memory)
+        {
+            VkSparseImageMemoryBind bind = {};
+            bind.subresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            bind.subresource.mipLevel = mipLevel;
+            bind.offset = { x, y, 0 };
+            bind.extent = { 128, 128, 1 };
+            bind.memory = fakeMemory(memory);
+            return bind;
+        }
+
+        VkSparseMemoryBind opaqueBind(VkDeviceSize resourceOffset, uint64_t memory)
+        {
+            VkSparseMemoryBind bind = {};
+            bind.resourceOffset = resourceOffset;
+            bind.size = 65536;
+            bind.memory = fakeMemory(memory);
+            return bind;
+        }
+    }
+
+    CPU_TEST(SparseBindBatcherCollate)
+    {
+        SparseBindBatcher batcher;
+        EXPECT(batcher.empty());
+
+        batcher.addImageBinds(fakeImage(1), { imageBind(0, 0, 0, 10), imageBind(0, 128, 0, 11) }, { opaqueBind(0, 12) });
+        batcher.addImageBinds(fakeImage(2), { imageBind(1, 0, 0, 20) });
+        batcher.addImageBinds(fakeImage(3), {});
+
+        // Same image again. Bind at (0, 0) is replaced, bind at (0, 128) added, mip tail bind replaced.
+        batcher.addImageBinds(fakeImage(1), { imageBind(0, 0, 0, 13), imageBind(0, 0, 128, 14) }, { opaqueBind(0, 15) });
+
+        EXPECT_EQ(batcher.imageCount(), 2);
+        EXPECT_EQ(batcher.imageBindCount(), 4);
+        EXPECT_EQ(batcher.opaqueBindCount(), 1);
+
+        const VkBindSparseInfo& info = batcher.getBindSparseInfo();
+        EXPECT_EQ(info.sType, VK_STRUCTURE_TYPE_BIND_SPARSE_INFO);
+        EXPECT(info.pNext == nullptr);
+        EXPECT_EQ(info.signalSemaphoreCount, 0);
+        EXPECT_EQ(info.imageBindCount, 2);
+        EXPECT_EQ(info.imageOpaqueBindCount, 1);
+
+        const VkSparseImageMemoryBindInfo& image1 = info.pImageBinds[0];
+        EXPECT(image1.image == fakeImage(1));
+        EXPECT_EQ(image1.bindCount, 3);
+
+        uint32_t replacedCount = 0;
+        for (uint32_t i = 0; i < image1.bindCount; i++)
+        {
+            const auto& bind = image1.pBinds[i];
+            if (bind.offset.x == 0 && bind.offset.y == 0)
+            {
+                EXPECT(bind.memory == fakeMemory(13));
+                replacedCount++;
+            }
+        }
+        EXPECT_EQ(replacedCount, 1);
+
+        EXPECT(info.pImageBinds[1].image == fakeImage(2));
+        EXPECT_EQ(info.pImageBinds[1].bindCount, 1);
+
+        EXPECT(info.pImageOpaqueBinds[0].image == fakeImage(1));
+        EXPECT_EQ(info.pImageOpaqueBinds[0].bindCount, 1);
+        EXPECT(info.pImageOpaqueBinds[0].pBinds[0].memory == fakeMemory(15));
+
+        batcher.clear();
+        EXPECT(batcher.empty());
+        EXPECT_EQ(batcher.imageBindCount(), 0);
+    }
+
+    CPU_TEST(SparseBindBatcherTimelineSignal)
+    {
+        SparseBindBatcher batcher;
+        batcher.addImageBinds(fakeImage(1), { imageBind(0, 0, 0, 10) });
+
+        const VkBindSparseInfo& info = batcher.getBindSparseInfo(fakeSemaphore(7), 42);
+        EXPECT_EQ(info.signalSemaphoreCount, 1);
+        EXPECT(info.pSignalSemaphores[0] == fakeSemaphore(7));
+        EXPECT(info.pNext != nullptr);
+
+        const auto* pTimelineInfo = reinterpret_cast<const VkTimelineSemaphoreSubmitInfo*>(info.pNext);
+        EXPECT_EQ(pTimelineInfo->sType, VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO);
+        EXPECT_EQ(pTimelineInfo->signalSemaphoreValueCount, 1);
+        EXPECT_EQ(pTimelineInfo->pSignalSemaphoreValues[0], 42);
+    }
+}
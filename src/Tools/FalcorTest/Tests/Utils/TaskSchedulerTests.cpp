@@ -0,0 +1,196 @@
+/***************************************************************************
+ # Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/TaskScheduler.h"
+
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <vector>
+
+namespace Falcor
+{
+    namespace
+    {
+        /** Blocks all threads calling wait() until open() is called.
+        */
+        class Gate
+        {
+        public:
+            void open() { mPromise.set_value(); }
+            void wait() { mFuture.wait(); }
+
+        private:
+            std::promise<void> mPromise;
+            std::shared_future<void> mFuture = mPromise.get_future().share();
+        };
+    }
+
+    CPU_TEST(TaskSchedulerPriorities)
+    {
+        TaskScheduler::Desc desc;
+        desc.cpuThreadCount = 1;
+        desc.ioThreadCount = 0;
+        TaskScheduler scheduler(desc);
+
+        // Keep the only worker busy while the prioritized tasks are queued.
+        Gate gate;
+        auto blocker = scheduler.submit([&]() { gate.wait(); });
+        while (scheduler.getPendingTaskCount(TaskScheduler::Lane::CPU) > 0) std::this_thread::yield();
+
+        std::mutex mutex;
+        std::vector<uint32_t> order;
+        auto record = [&](uint32_t value) { return [&, value]() { std::lock_guard<std::mutex> lock(mutex); order.push_back(value); }; };
+
+        std::vector<TaskScheduler::Future<void>> futures;
+        futures.push_back(scheduler.submit(record(2), TaskScheduler::Lane::CPU, TaskScheduler::Priority::Low));
+        futures.push_back(scheduler.submit(record(1), TaskScheduler::Lane::CPU, TaskScheduler::Priority::Normal));
+        futures.push_back(scheduler.submit(record(0), TaskScheduler::Lane::CPU, TaskScheduler::Priority::High));
+        futures.push_back(scheduler.submit(record(3), TaskScheduler::Lane::CPU, TaskScheduler::Priority::Low));
+
+        gate.open();
+        blocker.get();
+        // Wait without helping so the worker alone decides the order.
+        while (scheduler.getPendingTaskCount(TaskScheduler::Lane::CPU) > 0 || !futures.back().isReady()) std::this_thread::yield();
+        for (auto& f : futures) f.get();
+
+        EXPECT_EQ(order.size(), 4);
+        for (uint32_t i = 0; i < order.size(); i++) EXPECT_EQ(order[i], i);
+    }
+
+    CPU_TEST(TaskSchedulerLanes)
+    {
+        TaskScheduler::Desc desc;
+        desc.cpuThreadCount = 1;
+        desc.ioThreadCount = 1;
+        TaskScheduler scheduler(desc);
+
+        // A stalled IO task must not hold back CPU work.
+        Gate gate;
+        auto io = scheduler.submit([&]() { gate.wait(); return 1; }, TaskScheduler::Lane::IO);
+        auto cpu = scheduler.submit([]() { return 2; }, TaskScheduler::Lane::CPU);
+        while (!cpu.isReady()) std::this_thread::yield();
+        EXPECT_EQ(cpu.get(), 2);
+        EXPECT(!io.isReady());
+
+        gate.open();
+        EXPECT_EQ(io.get(), 1);
+    }
+
+    CPU_TEST(TaskSchedulerHelpWhileWaiting)
+    {
+        TaskScheduler::Desc desc;
+        desc.cpuThreadCount = 1;
+        desc.ioThreadCount = 0;
+        TaskScheduler scheduler(desc);
+
+        // With the only worker blocked, waiting runs queued tasks on the calling thread.
+        Gate gate;
+        auto blocker = scheduler.submit([&]() { gate.wait(); });
+        auto task = scheduler.submit([]() { return std::this_thread::get_id(); });
+        EXPECT(task.get() == std::this_thread::get_id());
+
+        // A lane without threads runs tasks when they are waited on.
+        auto io = scheduler.submit([]() { return 7; }, TaskScheduler::Lane::IO);
+        EXPECT_EQ(io.get(), 7);
+
+        gate.open();
+        blocker.get();
+
+        // Tasks waiting on nested tasks don't deadlock a single worker.
+        std::vector<TaskScheduler::Future<uint32_t>> outer;
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            outer.push_back(scheduler.submit([&scheduler, i]()
+            {
+                auto inner = scheduler.submit([i]() { return i * 2; });
+                return inner.get() + 1;
+            }));
+        }
+        for (uint32_t i = 0; i < outer.size(); i++) EXPECT_EQ(outer[i].get(), i * 2 + 1);
+    }
+
+    CPU_TEST(TaskSchedulerExceptions)
+    {
+        TaskScheduler scheduler;
+
+        auto task = scheduler.submit([]() -> uint32_t { throw std::runtime_error("task failure"); });
+        bool caught = false;
+        try
+        {
+            task.get();
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+        EXPECT(caught);
+    }
+
+    CPU_TEST(TaskSchedulerParallelFor)
+    {
+        TaskScheduler::Desc desc;
+        desc.cpuThreadCount = 3;
+        TaskScheduler scheduler(desc);
+
+        const uint32_t count = 10007;
+        std::vector<std::atomic<uint32_t>> hits(count);
+        for (auto& h : hits) h = 0;
+
+        scheduler.parallelFor(0, count, [&](uint32_t start, uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++) hits[i]++;
+        });
+        for (uint32_t i = 0; i < count; i++) EXPECT_EQ(hits[i].load(), 1);
+
+        // Fewer items than threads and empty ranges.
+        std::atomic<uint32_t> sum = 0;
+        scheduler.parallelFor(5, 7, [&](uint32_t start, uint32_t end) { for (uint32_t i = start; i < end; i++) sum += i; });
+        scheduler.parallelFor(3, 3, [&](uint32_t, uint32_t) { sum += 100; });
+        EXPECT_EQ(sum.load(), 11);
+
+        // Exception is rethrown only after all the other blocks are done.
+        std::atomic<uint32_t> finished = 0;
+        bool caught = false;
+        try
+        {
+            scheduler.parallelFor(0, 4, [&](uint32_t start, uint32_t)
+            {
+                if (start == 0) throw std::runtime_error("block failure");
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                finished++;
+            });
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+        EXPECT(caught);
+        EXPECT_EQ(finished.load(), 3);
+    }
+}
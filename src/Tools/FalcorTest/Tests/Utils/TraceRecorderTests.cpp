@@ -0,0 +1,112 @@
+/***************************************************************************
+ # Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Timing/TraceRecorder.h"
+
+#include <sstream>
+#include <thread>
+
+namespace Falcor
+{
+    namespace
+    {
+        size_t countOccurrences(const std::string& str, const std::string& pattern)
+        {
+            size_t count = 0;
+            for (size_t pos = str.find(pattern); pos != std::string::npos; pos = str.find(pattern, pos + pattern.size())) count++;
+            return count;
+        }
+    }
+
+    CPU_TEST(TraceRecorderThreads)
+    {
+        auto& recorder = TraceRecorder::instance();
+        const size_t capacity = recorder.getCapacity();
+        recorder.setCapacity(64);
+        recorder.setEnabled(true);
+
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < 4; t++)
+        {
+            threads.emplace_back([t]()
+            {
+                TraceRecorder::instance().setThreadName("TraceRecorderTests " + std::to_string(t));
+                for (uint32_t i = 0; i < 100; i++)
+                {
+                    TRACE_SCOPE("TraceRecorderTests event");
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+
+        recorder.markFrame(7);
+        recorder.setEnabled(false);
+        {
+            TRACE_SCOPE("TraceRecorderTests disabled");
+        }
+
+        // Ring buffers keep the last 64 events of every thread.
+        std::ostringstream os;
+        recorder.write(os);
+        const std::string trace = os.str();
+
+        EXPECT_EQ(countOccurrences(trace, "\"TraceRecorderTests event\""), 4 * 64);
+        EXPECT_EQ(countOccurrences(trace, "\"TraceRecorderTests disabled\""), 0);
+        EXPECT_EQ(countOccurrences(trace, "\"Frame 7\""), 1);
+        for (uint32_t t = 0; t < 4; t++)
+        {
+            EXPECT_EQ(countOccurrences(trace, "\"TraceRecorderTests " + std::to_string(t) + "\""), 1);
+        }
+        EXPECT(trace.rfind("{\"displayTimeUnit\"", 0) == 0);
+
+        recorder.clear();
+        EXPECT_EQ(recorder.getEventCount(), 0);
+        recorder.setCapacity(capacity);
+    }
+
+    CPU_TEST(TraceRecorderLongNames)
+    {
+        auto& recorder = TraceRecorder::instance();
+        recorder.clear();
+        recorder.setEnabled(true);
+        {
+            TRACE_SCOPE(std::string(200, 'x') + "\"quoted\"");
+        }
+        recorder.setEnabled(false);
+
+        std::ostringstream os;
+        recorder.write(os);
+        const std::string trace = os.str();
+
+        // Names are truncated to kMaxNameLength characters.
+        EXPECT_EQ(countOccurrences(trace, std::string(TraceRecorder::kMaxNameLength, 'x')), 1);
+        EXPECT_EQ(countOccurrences(trace, "quoted"), 0);
+        EXPECT_EQ(recorder.getEventCount(), 1);
+        recorder.clear();
+    }
+}
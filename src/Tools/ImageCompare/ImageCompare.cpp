@@ -26,6 +26,8 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include <iostream>
+#include <fstream>
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -37,207 +39,147 @@
 
 #include "args.h"
 #include "FreeImage.h"
+#include <OpenImageIO/imageio.h>
 
-template<typename T>
-T sqr(T x) { return x * x; }
+#include "ImageComparison.h"
 
-template<typename T>
-T lerp(T a, T b, T t) { return a + t * (b - a); }
-
-template<typename T>
-T clamp(T x, T lo, T hi) { return std::max(lo, std::min(hi, x)); }
-
-class Image
+Image::SharedPtr Image::loadFromFile(const std::string& filename)
 {
-public:
-    using SharedPtr = std::shared_ptr<Image>;
+    // OpenImageIO keeps all channels of multi-channel files (e.g. EXR AOV layers).
+    if (auto in = OIIO::ImageInput::open(filename))
+    {
+        const OIIO::ImageSpec& spec = in->spec();
+        std::vector<std::string> channelNames(spec.channelnames.begin(), spec.channelnames.end());
+        channelNames.resize(spec.nchannels);
+        for (size_t c = 0; c < channelNames.size(); ++c)
+        {
+            if (channelNames[c].empty()) channelNames[c] = "channel" + std::to_string(c);
+        }
 
-    uint32_t getWidth() const { return mWidth; }
-    uint32_t getHeight() const { return mHeight; }
-    const float* getData() const { return mData.get(); }
-    float* getData() { return mData.get(); }
+        auto image = create(spec.width, spec.height, channelNames);
+        std::vector<float> pixels(image->getPixelCount() * spec.nchannels);
+        const bool success = in->read_image(OIIO::TypeDesc::FLOAT, pixels.data());
+        in->close();
+        if (!success) throw std::runtime_error("Cannot read image");
 
-    static SharedPtr create(uint32_t width, uint32_t height) { return SharedPtr(new Image(width, height)); }
+        for (uint32_t c = 0; c < image->getChannelCount(); ++c)
+        {
+            float* dst = image->getChannel(c);
+            const float* src = pixels.data() + c;
+            for (size_t i = 0; i < image->getPixelCount(); ++i) dst[i] = src[i * spec.nchannels];
+        }
+        return image;
+    }
 
-    static SharedPtr loadFromFile(const std::string& filename)
-    {
-        FREE_IMAGE_FORMAT fifFormat = FIF_UNKNOWN;
+    FREE_IMAGE_FORMAT fifFormat = FIF_UNKNOWN;
 
-        // Determine file format.
-        fifFormat = FreeImage_GetFileType(filename.c_str(), 0);
-        if (fifFormat == FIF_UNKNOWN) fifFormat = FreeImage_GetFIFFromFilename(filename.c_str());
-        if (fifFormat == FIF_UNKNOWN) throw std::runtime_error("Unknown image format");
-        if (!FreeImage_FIFSupportsReading(fifFormat)) throw std::runtime_error("Unsupported image format");
+    // Determine file format.
+    fifFormat = FreeImage_GetFileType(filename.c_str(), 0);
+    if (fifFormat == FIF_UNKNOWN) fifFormat = FreeImage_GetFIFFromFilename(filename.c_str());
+    if (fifFormat == FIF_UNKNOWN) throw std::runtime_error("Unknown image format");
+    if (!FreeImage_FIFSupportsReading(fifFormat)) throw std::runtime_error("Unsupported image format");
 
-        // Read image.
-        FIBITMAP* srcBitmap = FreeImage_Load(fifFormat, filename.c_str());
-        if (!srcBitmap) throw std::runtime_error("Cannot read image");
+    // Read image.
+    FIBITMAP* srcBitmap = FreeImage_Load(fifFormat, filename.c_str());
+    if (!srcBitmap) throw std::runtime_error("Cannot read image");
 
-        // Convert to RGBA32F.
-        FIBITMAP* floatBitmap = FreeImage_ConvertToRGBAF(srcBitmap);
-        FreeImage_Unload(srcBitmap);
-        if (!floatBitmap) throw std::runtime_error("Cannot convert to RGBA float format");
+    // Convert to RGBA32F.
+    FIBITMAP* floatBitmap = FreeImage_ConvertToRGBAF(srcBitmap);
+    FreeImage_Unload(srcBitmap);
+    if (!floatBitmap) throw std::runtime_error("Cannot convert to RGBA float format");
 
-        // Create image.
-        auto image = create(FreeImage_GetWidth(floatBitmap), FreeImage_GetHeight(floatBitmap));
-        int bytesPerPixel = 4 * sizeof(float);
-        FreeImage_ConvertToRawBits(reinterpret_cast<BYTE*>(image->getData()), floatBitmap, bytesPerPixel * image->getWidth(), bytesPerPixel * 8, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, true);
-        FreeImage_Unload(floatBitmap);
+    // Create image.
+    auto image = create(FreeImage_GetWidth(floatBitmap), FreeImage_GetHeight(floatBitmap), { "R", "G", "B", "A" });
+    std::vector<float> pixels(image->getPixelCount() * 4);
+    int bytesPerPixel = 4 * sizeof(float);
+    FreeImage_ConvertToRawBits(reinterpret_cast<BYTE*>(pixels.data()), floatBitmap, bytesPerPixel * image->getWidth(), bytesPerPixel * 8, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, true);
+    FreeImage_Unload(floatBitmap);
 
-        return image;
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        float* dst = image->getChannel(c);
+        for (size_t i = 0; i < image->getPixelCount(); ++i) dst[i] = pixels[i * 4 + c];
     }
 
-    void saveToFile(const std::string& filename, bool writeAlpha = true) const
-    {
-        FREE_IMAGE_FORMAT fifFormat = FIF_UNKNOWN;
+    return image;
+}
 
-        // Determine file format.
-        fifFormat = FreeImage_GetFIFFromFilename(filename.c_str());
-        if (fifFormat == FIF_UNKNOWN) throw std::runtime_error("Unknown image format");
-        if (!FreeImage_FIFSupportsWriting(fifFormat)) throw std::runtime_error("Unsupported image format");
+void Image::saveToFile(const std::string& filename, bool writeAlpha) const
+{
+    FREE_IMAGE_FORMAT fifFormat = FIF_UNKNOWN;
+
+    // Determine file format.
+    fifFormat = FreeImage_GetFIFFromFilename(filename.c_str());
+    if (fifFormat == FIF_UNKNOWN) throw std::runtime_error("Unknown image format");
+    if (!FreeImage_FIFSupportsWriting(fifFormat)) throw std::runtime_error("Unsupported image format");
+    if (getChannelCount() < 3) throw std::runtime_error("Image has less than 3 channels");
 
-        bool writeFloat = fifFormat == FIF_EXR || fifFormat == FIF_PFM || fifFormat == FIF_HDR;
-        if (fifFormat != FIF_EXR || fifFormat != FIF_PNG) writeAlpha = false;
+    bool writeFloat = fifFormat == FIF_EXR || fifFormat == FIF_PFM || fifFormat == FIF_HDR;
+    if (fifFormat != FIF_EXR || fifFormat != FIF_PNG) writeAlpha = false;
+    if (getChannelCount() < 4) writeAlpha = false;
 
-        // Create bitmap.
-        FIBITMAP* bitmap;
-        const float* src = getData();
-        if (writeFloat)
+    const float* src[4] = { getChannel(0), getChannel(1), getChannel(2), writeAlpha ? getChannel(3) : nullptr };
+
+    // Create bitmap.
+    FIBITMAP* bitmap;
+    if (writeFloat)
+    {
+        bitmap = FreeImage_AllocateT(writeAlpha ? FIT_RGBAF : FIT_RGBF, mWidth, mHeight);
+        for (uint32_t y = 0; y < mHeight; y++)
         {
-            bitmap = FreeImage_AllocateT(writeAlpha ? FIT_RGBAF : FIT_RGBF, mWidth, mHeight);
-            for (uint32_t y = 0; y < mHeight; y++)
+            float* dst = reinterpret_cast<float*>(FreeImage_GetScanLine(bitmap, mHeight - y - 1));
+            for (uint32_t x = 0; x < mWidth; ++x)
             {
-                float* dst = reinterpret_cast<float*>(FreeImage_GetScanLine(bitmap, mHeight - y - 1));
-                if (writeAlpha)
-                {
-                    std::memcpy(dst, src, mWidth * 4 * sizeof(float));
-                    src += mWidth * 4;
-                }
-                else
-                {
-                    for (uint32_t x = 0; x < mWidth; ++x)
-                    {
-                        dst[0] = src[0];
-                        dst[1] = src[1];
-                        dst[2] = src[2];
-                        dst += 3;
-                        src += 4;
-                    }
-                }
+                const size_t i = size_t(y) * mWidth + x;
+                dst[0] = src[0][i];
+                dst[1] = src[1][i];
+                dst[2] = src[2][i];
+                if (writeAlpha) dst[3] = src[3][i];
+                dst += writeAlpha ? 4 : 3;
             }
         }
-        else
+    }
+    else
+    {
+        bitmap = FreeImage_Allocate(mWidth, mHeight, writeAlpha ? 32 : 24);
+        for (uint32_t y = 0; y < mHeight; y++)
         {
-            bitmap = FreeImage_Allocate(mWidth, mHeight, writeAlpha ? 32 : 24);
-            for (uint32_t y = 0; y < mHeight; y++)
+            uint8_t* dst = reinterpret_cast<uint8_t*>(FreeImage_GetScanLine(bitmap, mHeight - y - 1));
+            for (uint32_t x = 0; x < mWidth; ++x)
             {
-                uint8_t* dst = reinterpret_cast<uint8_t*>(FreeImage_GetScanLine(bitmap, mHeight - y - 1));
-                for (uint32_t x = 0; x < mWidth; ++x)
-                {
-                    dst[2] = clamp(int(src[0] * 255.f), 0, 255);
-                    dst[1] = clamp(int(src[1] * 255.f), 0, 255);
-                    dst[0] = clamp(int(src[2] * 255.f), 0, 255);
-                    if (writeAlpha) dst[3] = clamp(int(src[3] * 255.f), 0, 255);
-                    dst += writeAlpha ? 4 : 3;
-                    src += 4;
-                }
+                const size_t i = size_t(y) * mWidth + x;
+                dst[2] = clamp(int(src[0][i] * 255.f), 0, 255);
+                dst[1] = clamp(int(src[1][i] * 255.f), 0, 255);
+                dst[0] = clamp(int(src[2][i] * 255.f), 0, 255);
+                if (writeAlpha) dst[3] = clamp(int(src[3][i] * 255.f), 0, 255);
+                dst += writeAlpha ? 4 : 3;
             }
         }
-
-        // Write image.
-        FreeImage_Save(fifFormat, bitmap, filename.c_str());
-        FreeImage_Unload(bitmap);
-    }
-
-private:
-    uint32_t mWidth;
-    uint32_t mHeight;
-    std::unique_ptr<float[]> mData;
-
-    Image(uint32_t width, uint32_t height)
-        : mWidth(width)
-        , mHeight(height)
-        , mData(std::make_unique<float[]>(width * height * 4))
-    {}
-};
-
-struct MSE
-{
-    double operator()(const float* a, const float* b, size_t count) const
-    {
-        double error = 0.0;
-        for (size_t i = 0; i < count; ++i) { error += sqr(a[i] - b[i]); }
-        return error / count;
-    }
-};
-
-struct RMSE
-{
-    double operator()(const float* a, const float* b, size_t count) const
-    {
-        double error = 0.0;
-        for (size_t i = 0; i < count; ++i) { error += sqr(a[i] - b[i]) / (sqr(a[i]) + 1e-3); }
-        return error / count;
-    }
-};
-
-struct MAE
-{
-    double operator()(const float* a, const float* b, size_t count) const
-    {
-        double error = 0.0;
-        for (size_t i = 0; i < count; ++i) { error += std::fabs(sqr(a[i] - b[i])); }
-        return error / count;
-    }
-};
-
-struct MAPE
-{
-    double operator()(const float* a, const float* b, size_t count) const
-    {
-        double error = 0.0;
-        for (size_t i = 0; i < count; ++i) { error += std::fabs((a[i] - b[i]) / (a[i] + 1e-3)); }
-        return 100.0 * error / count;
     }
-};
 
-template<typename Metric>
-double compare(const Image& imageA, const Image& imageB, bool alpha, float* errorMap)
-{
-    Metric metric;
-    double sum = 0.0;
-    const float* a = imageA.getData();
-    const float* b = imageB.getData();
-    size_t count = imageA.getWidth() * imageA.getHeight();
-    for (size_t i = 0; i < count; ++i)
-    {
-        double error = metric(a, b, alpha ? 4 : 3);
-        if (errorMap) *errorMap++ = float(error);
-        sum += error;
-        a += 4;
-        b += 4;
-    }
-    return sum / count;
+    // Write image.
+    FreeImage_Save(fifFormat, bitmap, filename.c_str());
+    FreeImage_Unload(bitmap);
 }
 
 struct ErrorMetric
 {
     std::string name;
     std::string desc;
-    std::function<double(const Image& imageA, const Image& imageB, bool alpha, float* errorMap)> compare;
+    Metric metric;
 };
 
 static const std::vector<ErrorMetric> errorMetrics =
 {
-    { "mse", "Mean Squared Error", compare<MSE> },
-    { "rmse", "Relative Mean Squared Error", compare<RMSE> },
-    { "mae", "Mean Absolute Error", compare<MAE> },
-    { "mape", "Mean Absolute Percentage Error", compare<MAPE> },
+    { "mse", "Mean Squared Error", Metric::MSE },
+    { "rmse", "Relative Mean Squared Error", Metric::RMSE },
+    { "mae", "Mean Absolute Error", Metric::MAE },
+    { "mape", "Mean Absolute Percentage Error", Metric::MAPE },
 };
 
 static Image::SharedPtr generateHeatMap(uint32_t width, uint32_t height, const float* errorMap)
 {
-    auto writeColor = [] (float t, float* dst)
+    auto writeColor = [] (float t, float* dst[4], size_t i)
     {
         static const float colors[5][3] = {
             { 0.f, 0.f, 1.f },
@@ -248,25 +190,25 @@ static Image::SharedPtr generateHeatMap(uint32_t width, uint32_t height, const f
         };
 
         int c = clamp(int(std::floor(t * 4.f)), 0, 3);
-        for (size_t i = 0; i < 3; ++i) *dst++ = lerp(colors[c][i], colors[c + 1][i], t * 4.f - c);
-        *dst++ = 1.f;
+        for (size_t j = 0; j < 3; ++j) dst[j][i] = lerp(colors[c][j], colors[c + 1][j], t * 4.f - c);
+        dst[3][i] = 1.f;
     };
 
-    const auto [minValue, maxValue] = std::minmax_element(errorMap, errorMap + width * height);
+    const auto [minValue, maxValue] = std::minmax_element(errorMap, errorMap + size_t(width) * height);
     const float range = std::max(1e-5f, *maxValue - *minValue);
-    auto image = Image::create(width, height);
-    float* dst = image->getData();
-    for (size_t i = 0; i < width * height; ++i)
+    auto image = Image::create(width, height, { "R", "G", "B", "A" });
+    float* dst[4] = { image->getChannel(0), image->getChannel(1), image->getChannel(2), image->getChannel(3) };
+    for (size_t i = 0; i < image->getPixelCount(); ++i)
     {
         float t = clamp((errorMap[i] - *minValue) / range, 0.f, 1.f);
-        writeColor(t, dst);
-        dst += 4;
+        writeColor(t, dst, i);
     }
 
     return image;
 }
 
-static bool compareImages(const std::string& filenameA, const std::string& filenameB, ErrorMetric metric, float threshold, bool alpha, const std::string& heatMapFilename)
+static bool compareImages(const std::string& filenameA, const std::string& filenameB, const ErrorMetric& metric, const ComparisonDesc& desc, bool alpha,
+    const std::vector<std::string>& aovNames, bool allAovs, const std::string& heatMapFilename, const std::string& jsonFilename)
 {
     auto loadImage = [] (const std::string& filename)
     {
@@ -293,11 +235,11 @@ static bool compareImages(const std::string& filenameA, const std::string& filen
         }
     };
 
-    // Load images.
-    auto imageA = loadImage(filenameA);
-    if (!imageA) return false;
+    // Load images. Decoding is mostly single threaded, so both files are loaded at once.
+    auto futureA = std::async(std::launch::async, loadImage, filenameA);
     auto imageB = loadImage(filenameB);
-    if (!imageB) return false;
+    auto imageA = futureA.get();
+    if (!imageA || !imageB) return false;
 
     // Check resolution.
     if (imageA->getWidth() != imageB->getWidth() || imageA->getHeight() != imageB->getHeight())
@@ -309,23 +251,71 @@ static bool compareImages(const std::string& filenameA, const std::string& filen
     uint32_t width = imageA->getWidth();
     uint32_t height = imageB->getHeight();
 
+    // Select AOVs. The main (or first) AOV is compared by default.
+    std::vector<Aov> aovs = getImageAovs(*imageA, alpha);
+    if (!aovNames.empty())
+    {
+        std::vector<Aov> selected;
+        for (const auto& name : aovNames)
+        {
+            auto it = std::find_if(aovs.begin(), aovs.end(), [&name] (const Aov& aov) { return aov.name == name; });
+            if (it == aovs.end())
+            {
+                std::cerr << "Image '" << filenameA << "' has no AOV '" << name << "'." << std::endl;
+                return false;
+            }
+            selected.push_back(*it);
+        }
+        aovs = selected;
+    }
+    else if (!allAovs && aovs.size() > 1)
+    {
+        aovs.resize(1);
+    }
+
     // Compare images.
-    std::unique_ptr<float[]> errorMap = heatMapFilename.empty() ? nullptr : std::make_unique<float[]>(width * height);
-    double error = metric.compare(*imageA, *imageB, alpha, errorMap.get());
+    std::unique_ptr<float[]> errorMap = heatMapFilename.empty() ? nullptr : std::make_unique<float[]>(size_t(width) * height);
+    std::vector<AovComparison> results;
+    for (const auto& aov : aovs)
+    {
+        // The heat map shows the first compared AOV.
+        results.push_back(compareAov(*imageA, *imageB, aov, desc, results.empty() ? errorMap.get() : nullptr));
+        if (std::any_of(aov.channels.begin(), aov.channels.end(), [&imageB] (const std::string& channel) { return imageB->findChannel(channel) < 0; }))
+        {
+            std::cerr << "Image '" << filenameB << "' has no AOV '" << aov.name << "'." << std::endl;
+        }
+    }
 
     // Generate heat map.
-    if (errorMap)
+    if (errorMap && !results.empty())
     {
         auto heatMap = generateHeatMap(width, height, errorMap.get());
         saveImage(*heatMap, heatMapFilename);
     }
 
-    std::cout << error << std::endl;
+    // Print errors. Machine readable results go to stdout alone if requested there.
+    if (jsonFilename != "-")
+    {
+        for (const auto& result : results)
+        {
+            if (results.size() > 1) std::cout << result.name << ": ";
+            std::cout << result.error << (result.earlyExit ? " (early exit)" : "") << std::endl;
+        }
+    }
+
+    if (jsonFilename == "-")
+    {
+        writeJson(std::cout, filenameA, filenameB, metric.name, desc, width, height, results);
+    }
+    else if (!jsonFilename.empty())
+    {
+        std::ofstream stream(jsonFilename);
+        if (stream) writeJson(stream, filenameA, filenameB, metric.name, desc, width, height, results);
+        else std::cerr << "Cannot write results to '" << jsonFilename << "'." << std::endl;
+    }
 
     // Treat nans and infs as errors.
-    if (std::isnan(error) || std::isinf(error)) return false;
-
-    return error <= threshold;
+    return !results.empty() && std::all_of(results.begin(), results.end(), [] (const AovComparison& result) { return result.passed; });
 }
 
 static void printMetrics(std::ostream &stream = std::cout)
@@ -347,6 +337,14 @@ int main(int argc, char** argv)
     args::ValueFlag<float> thresholdFlag(parser, "threshold", "The error threshold.", {'t'});
     args::Flag alphaFlag(parser, "", "Include alpha channel.", {'a'});
     args::ValueFlag<std::string> heatMapFlag(parser, "filename", "Generate error heat map.", {'e'});
+    args::ValueFlagList<std::string> aovFlag(parser, "aov", "Compare the AOV (channel layer, 'rgba' for unprefixed channels). Can be repeated.", {"aov"});
+    args::Flag allAovsFlag(parser, "", "Compare all AOVs.", {"all-aovs"});
+    args::ValueFlag<uint32_t> tileSizeFlag(parser, "size", "Tile size in pixels (default 64).", {"tile-size"});
+    args::ValueFlag<float> tileThresholdFlag(parser, "threshold", "Per-tile error threshold.", {"tile-threshold"});
+    args::Flag allTilesFlag(parser, "", "Report errors of all tiles.", {"all-tiles"});
+    args::Flag earlyExitFlag(parser, "", "Stop comparing as soon as a threshold is exceeded.", {"early-exit"});
+    args::ValueFlag<uint32_t> threadsFlag(parser, "count", "Number of threads (default all cores).", {"threads"});
+    args::ValueFlag<std::string> jsonFlag(parser, "filename", "Write results as JSON ('-' for stdout).", {'j', "json"});
     args::Positional<std::string> image1(parser, "image1", "The first image.", args::Options::Required);
     args::Positional<std::string> image2(parser, "image2", "The second image.", args::Options::Required);
     args::CompletionFlag completionFlag(parser, {"complete"});
@@ -398,12 +396,24 @@ int main(int argc, char** argv)
         metric = *it;
     }
 
+    ComparisonDesc desc;
+    desc.metric = metric.metric;
+    desc.threshold = thresholdFlag ? args::get(thresholdFlag) : 0.f;
+    desc.tileThreshold = tileThresholdFlag ? args::get(tileThresholdFlag) : -1.f;
+    desc.tileSize = tileSizeFlag ? std::max(1u, args::get(tileSizeFlag)) : desc.tileSize;
+    desc.threadCount = threadsFlag ? args::get(threadsFlag) : 0;
+    desc.earlyExit = earlyExitFlag;
+    desc.reportAllTiles = allTilesFlag;
+
     return compareImages(
         args::get(image1),
         args::get(image2),
         metric,
-        thresholdFlag ? args::get(thresholdFlag) : 0.f,
+        desc,
         alphaFlag ? args::get(alphaFlag) : false,
-        heatMapFlag ? args::get(heatMapFlag) : ""
+        args::get(aovFlag),
+        allAovsFlag,
+        heatMapFlag ? args::get(heatMapFlag) : "",
+        jsonFlag ? args::get(jsonFlag) : ""
     ) ? 0 : 1;
 }
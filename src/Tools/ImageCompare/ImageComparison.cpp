@@ -0,0 +1,334 @@
+/***************************************************************************
+ # Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <thread>
+
+#include "ImageComparison.h"
+
+namespace
+{
+    // Per channel error kernels. Rows of a tile are accumulated channel plane by channel plane, which keeps the
+    // inner loops over contiguous floats and lets the compiler vectorize them.
+    struct MSE
+    {
+        static float eval(float a, float b) { return sqr(a - b); }
+        static constexpr double kScale = 1.0;
+    };
+
+    struct RMSE
+    {
+        static float eval(float a, float b) { return sqr(a - b) / (sqr(a) + 1e-3f); }
+        static constexpr double kScale = 1.0;
+    };
+
+    struct MAE
+    {
+        static float eval(float a, float b) { return std::fabs(a - b); }
+        static constexpr double kScale = 1.0;
+    };
+
+    struct MAPE
+    {
+        static float eval(float a, float b) { return std::fabs((a - b) / (a + 1e-3f)); }
+        static constexpr double kScale = 100.0;
+    };
+
+    template<typename M>
+    void accumulateRow(const float* a, const float* b, float* error, uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; ++i) error[i] += M::eval(a[i], b[i]);
+    }
+
+    using AccumulateRowFunc = void(*)(const float* a, const float* b, float* error, uint32_t count);
+
+    void getMetricKernel(Metric metric, AccumulateRowFunc& func, double& scale)
+    {
+        switch (metric)
+        {
+        case Metric::MSE: func = accumulateRow<MSE>; scale = MSE::kScale; break;
+        case Metric::RMSE: func = accumulateRow<RMSE>; scale = RMSE::kScale; break;
+        case Metric::MAE: func = accumulateRow<MAE>; scale = MAE::kScale; break;
+        case Metric::MAPE: func = accumulateRow<MAPE>; scale = MAPE::kScale; break;
+        }
+    }
+
+    void atomicAdd(std::atomic<double>& value, double delta)
+    {
+        double current = value.load();
+        while (!value.compare_exchange_weak(current, current + delta)) {}
+    }
+
+    void writeJsonString(std::ostream& stream, const std::string& str)
+    {
+        stream << '"';
+        for (char c : str)
+        {
+            switch (c)
+            {
+            case '"': stream << "\\\""; break;
+            case '\\': stream << "\\\\"; break;
+            case '\n': stream << "\\n"; break;
+            case '\r': stream << "\\r"; break;
+            case '\t': stream << "\\t"; break;
+            default:
+                if (uint8_t(c) < 0x20) stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec << std::setfill(' ');
+                else stream << c;
+            }
+        }
+        stream << '"';
+    }
+
+    // JSON has no representation of nan and inf.
+    void writeJsonNumber(std::ostream& stream, double value)
+    {
+        if (std::isfinite(value)) stream << value;
+        else stream << "null";
+    }
+
+    void writeJsonTile(std::ostream& stream, const TileError& tile)
+    {
+        stream << "{ \"x\": " << tile.x << ", \"y\": " << tile.y << ", \"error\": ";
+        writeJsonNumber(stream, tile.error);
+        stream << " }";
+    }
+}
+
+Image::Image(uint32_t width, uint32_t height, const std::vector<std::string>& channelNames)
+    : mWidth(width)
+    , mHeight(height)
+    , mChannelNames(channelNames)
+{
+    for (size_t i = 0; i < channelNames.size(); ++i) mPlanes.push_back(std::make_unique<float[]>(getPixelCount()));
+}
+
+Image::SharedPtr Image::create(uint32_t width, uint32_t height, const std::vector<std::string>& channelNames)
+{
+    return SharedPtr(new Image(width, height, channelNames));
+}
+
+int Image::findChannel(const std::string& name) const
+{
+    auto it = std::find(mChannelNames.begin(), mChannelNames.end(), name);
+    return it == mChannelNames.end() ? -1 : int(it - mChannelNames.begin());
+}
+
+std::vector<Aov> getImageAovs(const Image& image, bool alpha)
+{
+    std::vector<Aov> aovs;
+    for (const auto& channel : image.getChannelNames())
+    {
+        const size_t separator = channel.rfind('.');
+        const std::string layer = separator == std::string::npos ? "rgba" : channel.substr(0, separator);
+        const std::string component = separator == std::string::npos ? channel : channel.substr(separator + 1);
+        if (!alpha && (component == "A" || component == "a")) continue;
+
+        auto it = std::find_if(aovs.begin(), aovs.end(), [&layer](const Aov& aov) { return aov.name == layer; });
+        if (it == aovs.end())
+        {
+            aovs.push_back({ layer, {} });
+            it = aovs.end() - 1;
+        }
+        it->channels.push_back(channel);
+    }
+    return aovs;
+}
+
+AovComparison compareAov(const Image& imageA, const Image& imageB, const Aov& aov, const ComparisonDesc& desc, float* errorMap)
+{
+    AovComparison result;
+    result.name = aov.name;
+    result.channels = aov.channels;
+
+    const uint32_t width = imageA.getWidth();
+    const uint32_t height = imageA.getHeight();
+
+    std::vector<const float*> planesA, planesB;
+    for (const auto& channel : aov.channels)
+    {
+        const int channelA = imageA.findChannel(channel);
+        const int channelB = imageB.findChannel(channel);
+        if (channelA < 0 || channelB < 0)
+        {
+            result.error = std::numeric_limits<double>::infinity();
+            return result;
+        }
+        planesA.push_back(imageA.getChannel(channelA));
+        planesB.push_back(imageB.getChannel(channelB));
+    }
+
+    const size_t pixelCount = imageA.getPixelCount();
+    if (planesA.empty() || pixelCount == 0)
+    {
+        result.passed = true;
+        return result;
+    }
+
+    AccumulateRowFunc accumulate = nullptr;
+    double scale = 1.0;
+    getMetricKernel(desc.metric, accumulate, scale);
+    const float pixelScale = float(scale / planesA.size());
+
+    const uint32_t tileSize = std::max(1u, desc.tileSize);
+    const uint32_t tilesX = (width + tileSize - 1) / tileSize;
+    const uint32_t tileCount = tilesX * ((height + tileSize - 1) / tileSize);
+    const bool tileChecks = desc.tileThreshold >= 0.0;
+    const bool earlyExit = desc.earlyExit && !errorMap;
+
+    // Tile error sums are combined in tile order at the end, so the result doesn't depend on thread scheduling.
+    std::vector<double> tileSums(tileCount, 0.0);
+    std::vector<uint8_t> tileDone(tileCount, 0);
+    std::atomic<uint32_t> nextTile = 0;
+    std::atomic<double> runningSum = 0.0;
+    std::atomic<bool> stop = false;
+
+    auto worker = [&]()
+    {
+        std::vector<float> rowError(tileSize);
+        for (uint32_t tile = nextTile++; tile < tileCount && !stop; tile = nextTile++)
+        {
+            const uint32_t x0 = (tile % tilesX) * tileSize;
+            const uint32_t y0 = (tile / tilesX) * tileSize;
+            const uint32_t tileWidth = std::min(tileSize, width - x0);
+            const uint32_t tileHeight = std::min(tileSize, height - y0);
+
+            double tileSum = 0.0;
+            for (uint32_t y = y0; y < y0 + tileHeight; ++y)
+            {
+                const size_t rowOffset = size_t(y) * width + x0;
+                std::fill(rowError.begin(), rowError.begin() + tileWidth, 0.f);
+                for (size_t c = 0; c < planesA.size(); ++c) accumulate(planesA[c] + rowOffset, planesB[c] + rowOffset, rowError.data(), tileWidth);
+
+                float rowSum = 0.f;
+                for (uint32_t x = 0; x < tileWidth; ++x)
+                {
+                    rowError[x] *= pixelScale;
+                    rowSum += rowError[x];
+                }
+                if (errorMap) std::copy(rowError.begin(), rowError.begin() + tileWidth, errorMap + rowOffset);
+                tileSum += rowSum;
+            }
+
+            tileSums[tile] = tileSum;
+            tileDone[tile] = 1;
+
+            if (earlyExit)
+            {
+                // Errors are non negative, the final mean can only grow.
+                atomicAdd(runningSum, tileSum);
+                const double tileError = tileSum / (double(tileWidth) * tileHeight);
+                if (!std::isfinite(tileSum) || runningSum.load() / pixelCount > desc.threshold || (tileChecks && tileError > desc.tileThreshold)) stop = true;
+            }
+        }
+    };
+
+    const uint32_t threadCount = std::min(desc.threadCount > 0 ? desc.threadCount : std::max(1u, std::thread::hardware_concurrency()), tileCount);
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < threadCount; ++i) threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads) thread.join();
+
+    double sum = 0.0;
+    bool tilesPassed = true;
+    result.worstTile.error = -1.0;
+    for (uint32_t tile = 0; tile < tileCount; ++tile)
+    {
+        if (!tileDone[tile])
+        {
+            result.earlyExit = true;
+            continue;
+        }
+
+        TileError tileError;
+        tileError.x = (tile % tilesX) * tileSize;
+        tileError.y = (tile / tilesX) * tileSize;
+        tileError.error = tileSums[tile] / (double(std::min(tileSize, width - tileError.x)) * std::min(tileSize, height - tileError.y));
+        sum += tileSums[tile];
+
+        const bool tileFailed = tileChecks && !(tileError.error <= desc.tileThreshold);
+        if (tileFailed) tilesPassed = false;
+        if (tileFailed || desc.reportAllTiles) result.tiles.push_back(tileError);
+        if (!std::isnan(result.worstTile.error) && !(tileError.error <= result.worstTile.error)) result.worstTile = tileError;
+    }
+
+    result.error = sum / pixelCount;
+    result.passed = !result.earlyExit && tilesPassed && std::isfinite(result.error) && result.error <= desc.threshold;
+    return result;
+}
+
+void writeJson(std::ostream& stream, const std::string& filenameA, const std::string& filenameB, const std::string& metricName,
+    const ComparisonDesc& desc, uint32_t width, uint32_t height, const std::vector<AovComparison>& results)
+{
+    const bool passed = std::all_of(results.begin(), results.end(), [](const AovComparison& r) { return r.passed; });
+
+    const auto precision = stream.precision(std::numeric_limits<double>::max_digits10);
+    stream << "{\n";
+    stream << "  \"imageA\": "; writeJsonString(stream, filenameA); stream << ",\n";
+    stream << "  \"imageB\": "; writeJsonString(stream, filenameB); stream << ",\n";
+    stream << "  \"metric\": "; writeJsonString(stream, metricName); stream << ",\n";
+    stream << "  \"threshold\": "; writeJsonNumber(stream, desc.threshold); stream << ",\n";
+    if (desc.tileThreshold >= 0.0) { stream << "  \"tileThreshold\": "; writeJsonNumber(stream, desc.tileThreshold); stream << ",\n"; }
+    stream << "  \"tileSize\": " << desc.tileSize << ",\n";
+    stream << "  \"width\": " << width << ",\n";
+    stream << "  \"height\": " << height << ",\n";
+    stream << "  \"passed\": " << (passed ? "true" : "false") << ",\n";
+    stream << "  \"aovs\": [";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const auto& r = results[i];
+        stream << (i > 0 ? "," : "") << "\n    {\n";
+        stream << "      \"name\": "; writeJsonString(stream, r.name); stream << ",\n";
+        stream << "      \"channels\": [";
+        for (size_t c = 0; c < r.channels.size(); ++c)
+        {
+            if (c > 0) stream << ", ";
+            writeJsonString(stream, r.channels[c]);
+        }
+        stream << "],\n";
+        stream << "      \"error\": "; writeJsonNumber(stream, r.error); stream << ",\n";
+        stream << "      \"passed\": " << (r.passed ? "true" : "false") << ",\n";
+        stream << "      \"earlyExit\": " << (r.earlyExit ? "true" : "false") << ",\n";
+        stream << "      \"worstTile\": ";
+        if (r.worstTile.error >= 0.0 || std::isnan(r.worstTile.error)) writeJsonTile(stream, r.worstTile);
+        else stream << "null";
+        stream << ",\n";
+        stream << "      \"tiles\": [";
+        for (size_t t = 0; t < r.tiles.size(); ++t)
+        {
+            stream << (t > 0 ? ",\n        " : "\n        ");
+            writeJsonTile(stream, r.tiles[t]);
+        }
+        stream << (r.tiles.empty() ? "]\n" : "\n      ]\n");
+        stream << "    }";
+    }
+    stream << (results.empty() ? "]\n" : "\n  ]\n");
+    stream << "}\n";
+    stream.precision(precision);
+}
@@ -0,0 +1,150 @@
+/***************************************************************************
+ # Copyright (c) 2020, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#ifndef SRC_TOOLS_IMAGECOMPARE_IMAGECOMPARISON_H_
+#define SRC_TOOLS_IMAGECOMPARE_IMAGECOMPARISON_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+template<typename T>
+T sqr(T x) { return x * x; }
+
+template<typename T>
+T lerp(T a, T b, T t) { return a + t * (b - a); }
+
+template<typename T>
+T clamp(T x, T lo, T hi) { return std::max(lo, std::min(hi, x)); }
+
+/** Multi-channel float image. Channels are stored as separate planes so metric loops run over contiguous data.
+*/
+class Image
+{
+public:
+    using SharedPtr = std::shared_ptr<Image>;
+
+    uint32_t getWidth() const { return mWidth; }
+    uint32_t getHeight() const { return mHeight; }
+    size_t getPixelCount() const { return size_t(mWidth) * mHeight; }
+
+    uint32_t getChannelCount() const { return uint32_t(mChannelNames.size()); }
+    const std::vector<std::string>& getChannelNames() const { return mChannelNames; }
+
+    /** Get channel index by name, or -1 if the image has no such channel.
+    */
+    int findChannel(const std::string& name) const;
+
+    const float* getChannel(uint32_t channel) const { return mPlanes[channel].get(); }
+    float* getChannel(uint32_t channel) { return mPlanes[channel].get(); }
+
+    static SharedPtr create(uint32_t width, uint32_t height, const std::vector<std::string>& channelNames);
+
+    /** Load image from file. Multi-channel (e.g. multi-layer EXR) files keep all their channels.
+    */
+    static SharedPtr loadFromFile(const std::string& filename);
+
+    /** Save the first 3 (4 with alpha) channels as RGB(A) image.
+    */
+    void saveToFile(const std::string& filename, bool writeAlpha = true) const;
+
+private:
+    Image(uint32_t width, uint32_t height, const std::vector<std::string>& channelNames);
+
+    uint32_t mWidth;
+    uint32_t mHeight;
+    std::vector<std::string> mChannelNames;
+    std::vector<std::unique_ptr<float[]>> mPlanes;
+};
+
+/** AOV of an image: channels sharing the same layer name, e.g. "diffuse.R", "diffuse.G" and "diffuse.B".
+    Channels without a layer prefix (R, G, B, A) make the unnamed main AOV.
+*/
+struct Aov
+{
+    std::string name;
+    std::vector<std::string> channels;      ///< Full channel names.
+};
+
+/** Group image channels into AOVs, in order of appearance. Channels are grouped by their layer prefix
+    ("diffuse.R" belongs to "diffuse"), unprefixed channels form the "rgba" AOV.
+    \param[in] alpha Include alpha (A) channels.
+*/
+std::vector<Aov> getImageAovs(const Image& image, bool alpha);
+
+enum class Metric
+{
+    MSE,
+    RMSE,
+    MAE,
+    MAPE,
+};
+
+struct ComparisonDesc
+{
+    Metric metric = Metric::MSE;
+    double threshold = 0.0;             ///< Mean error threshold.
+    double tileThreshold = -1.0;        ///< Per-tile mean error threshold, negative disables tile checks.
+    uint32_t tileSize = 64;
+    uint32_t threadCount = 0;           ///< 0 selects hardware concurrency.
+    bool earlyExit = false;             ///< Stop as soon as the result is known to fail.
+    bool reportAllTiles = false;        ///< Report errors of all tiles, not only the failing ones.
+};
+
+struct TileError
+{
+    uint32_t x = 0;                     ///< Tile origin in pixels.
+    uint32_t y = 0;
+    double error = 0.0;
+};
+
+struct AovComparison
+{
+    std::string name;
+    std::vector<std::string> channels;
+    double error = 0.0;                 ///< Mean error. A lower bound when earlyExit is set.
+    bool passed = false;
+    bool earlyExit = false;             ///< Comparison stopped before processing all tiles.
+    TileError worstTile;
+    std::vector<TileError> tiles;       ///< Failing tiles, or all tiles with reportAllTiles.
+};
+
+/** Compare one AOV of two images of the same resolution.
+    Tiles are processed in parallel. The per-pixel error (metric averaged over channels) is written to errorMap
+    if not null, early exit is disabled in that case.
+*/
+AovComparison compareAov(const Image& imageA, const Image& imageB, const Aov& aov, const ComparisonDesc& desc, float* errorMap = nullptr);
+
+/** Write comparison results as JSON.
+*/
+void writeJson(std::ostream& stream, const std::string& filenameA, const std::string& filenameB, const std::string& metricName,
+    const ComparisonDesc& desc, uint32_t width, uint32_t height, const std::vector<AovComparison>& results);
+
+#endif  // SRC_TOOLS_IMAGECOMPARE_IMAGECOMPARISON_H_
@@ -67,6 +67,14 @@
         ResourceCommandEncoderBase::uploadTexturePageData(                                              \
             dst, offset, extent, mipLevel, subResourceData);                                            \
     }                                                                                                   \
+    virtual SLANG_NO_THROW void SLANG_MCALL copyBufferToTexturePages(                                   \
+        ITextureResource* dst,                                                                          \
+        IBufferResource* src,                                                                           \
+        GfxCount regionCount,                                                                           \
+        const TexturePageCopyRegion* regions) override                                                  \
+    {                                                                                                   \
+        ResourceCommandEncoderBase::copyBufferToTexturePages(dst, src, regionCount, regions);           \
+    }                                                                                                   \
     virtual SLANG_NO_THROW void SLANG_MCALL uploadBufferData(                                           \
         IBufferResource* dst, Offset offset, Size size, void* data) override                            \
     {                                                                                                   \
@@ -1429,6 +1429,16 @@ void DebugResourceCommandEncoderImpl::uploadTexturePageData(
 		getInnerObj(dst), offset, extent, mipLevel, subResourceData);	
 }
 
+void DebugResourceCommandEncoderImpl::copyBufferToTexturePages(
+	ITextureResource* dst,
+	IBufferResource* src,
+	GfxCount regionCount,
+	const TexturePageCopyRegion* regions)
+{
+	SLANG_GFX_API_FUNC;
+	getBaseResourceEncoder()->copyBufferToTexturePages(getInnerObj(dst), getInnerObj(src), regionCount, regions);
+}
+
 void DebugResourceCommandEncoderImpl::clearResourceView(
 	IResourceView* view, ClearValue* clearValue, ClearResourceViewFlags::Enum flags)
 {
@@ -423,6 +423,12 @@ public:
         ITextureResource::Extents extent,
         uint32_t mipLevel,
         ITextureResource::SubresourceData* subResourceData);
+
+    virtual SLANG_NO_THROW void SLANG_MCALL copyBufferToTexturePages(
+        ITextureResource* dst,
+        IBufferResource* src,
+        GfxCount regionCount,
+        const TexturePageCopyRegion* regions);
         
     virtual SLANG_NO_THROW void SLANG_MCALL clearResourceView(
         IResourceView* view, ClearValue* clearValue, ClearResourceViewFlags::Enum flags);
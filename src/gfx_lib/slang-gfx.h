@@ -1601,6 +1601,15 @@ struct ClearResourceViewFlags
 	};
 };
 
+/// Describes a copy of one sparse texture page from a buffer.
+struct TexturePageCopyRegion
+{
+	Offset bufferOffset = 0;
+	ITextureResource::Offset3D offset;
+	ITextureResource::Extents extent;
+	uint32_t mipLevel = 0;
+};
+
 class IResourceCommandEncoder : public ICommandEncoder
 {
 public:
@@ -1649,6 +1658,12 @@ public:
 		ITextureResource::Extents extent,
 		uint32_t mipLevel,
 		ITextureResource::SubresourceData* subResourceData) = 0;
+	/// Copies many tightly packed pages from a buffer into a texture with a single command.
+	virtual SLANG_NO_THROW void SLANG_MCALL copyBufferToTexturePages(
+		ITextureResource* dst,
+		IBufferResource* src,
+		GfxCount regionCount,
+		const TexturePageCopyRegion* regions) = 0;
 	virtual SLANG_NO_THROW void SLANG_MCALL
 		uploadBufferData(IBufferResource* dst, Offset offset, Size size, void* data) = 0;
 	virtual SLANG_NO_THROW void SLANG_MCALL textureBarrier(
@@ -471,6 +471,46 @@ void ResourceCommandEncoder::uploadTexturePageData(
 	}
 }
 
+void ResourceCommandEncoder::copyBufferToTexturePages(
+	ITextureResource* dst,
+	IBufferResource* src,
+	GfxCount regionCount,
+	const TexturePageCopyRegion* regions)
+{
+	// VALIDATION: dst must be in TransferDst state.
+	if (regionCount <= 0) return;
+
+	auto& vkApi = m_commandBuffer->m_renderer->m_api;
+	auto dstImpl = static_cast<TextureResourceImpl*>(dst);
+	auto srcImpl = static_cast<BufferResourceImpl*>(src);
+
+	List<VkBufferImageCopy> copyRegions;
+	copyRegions.setCount(regionCount);
+	for (GfxIndex i = 0; i < regionCount; ++i)
+	{
+		const auto& region = regions[i];
+		auto& copyRegion = copyRegions[i];
+		copyRegion = {};
+		copyRegion.bufferOffset = region.bufferOffset;
+		copyRegion.bufferRowLength = 0;
+		copyRegion.bufferImageHeight = 0;
+		copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		copyRegion.imageSubresource.mipLevel = region.mipLevel;
+		copyRegion.imageSubresource.baseArrayLayer = 0;
+		copyRegion.imageSubresource.layerCount = 1;
+		copyRegion.imageOffset = {region.offset.x, region.offset.y, region.offset.z};
+		copyRegion.imageExtent = {static_cast<uint32_t>(region.extent.width), static_cast<uint32_t>(region.extent.height), static_cast<uint32_t>(region.extent.depth)};
+	}
+
+	vkApi.vkCmdCopyBufferToImage(
+		m_commandBuffer->m_commandBuffer,
+		srcImpl->m_buffer.m_buffer,
+		dstImpl->m_image,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		(uint32_t)copyRegions.getCount(),
+		copyRegions.getBuffer());
+}
+
 ////////////////////////////////////////////////////////////
 
 void ResourceCommandEncoder::uploadTextureData(
@@ -103,6 +103,12 @@ public:
         uint32_t mipLevel,
         ITextureResource::SubresourceData* subResourceData) override;
 
+    virtual SLANG_NO_THROW void SLANG_MCALL copyBufferToTexturePages(
+        ITextureResource* dst,
+        IBufferResource* src,
+        GfxCount regionCount,
+        const TexturePageCopyRegion* regions) override;
+
     void _clearColorImage(TextureResourceViewImpl* viewImpl, ClearValue* clearValue);
 
     void _clearDepthImage(
@@ -97,8 +97,9 @@ Result FenceImpl::getSharedHandle(InteropHandle* outHandle)
 
 Result FenceImpl::getNativeHandle(InteropHandle* outNativeHandle)
 {
-    outNativeHandle->handleValue = 0;
-    return SLANG_FAIL;
+    outNativeHandle->api = InteropHandleAPI::Vulkan;
+    outNativeHandle->handleValue = (uint64_t)m_semaphore;
+    return SLANG_OK;
 }
 
 } // namespace vk
@@ -36,6 +36,10 @@ def add_light_lava_parameters(node, rebuild=True):
 	addParmTemplate(node, common_folder, hou.ToggleParmTemplate('lv_contribute_indirect_diffuse','Contribute Indirect Diffuse', True))
 	addParmTemplate(node, common_folder, hou.ToggleParmTemplate('lv_contribute_indirect_specular','Contribute Indirect Specular', True))
 
+	if is_env_light:
+		addParmTemplate(node, common_folder, hou.IntParmTemplate('lv_envmaxres','Max Map Resolution', 1, (8192,), min=1, max=16384, min_is_strict=True, 
+			help='Environment map mip levels wider than this are not loaded into memory when virtual texturing is enabled'))
+
 
 	# Lava environment light folder
 	if is_env_light:
@@ -319,6 +319,7 @@ def initializeFeatures(settings):
     Light("indirect_specular_color", "float", "lv_indirect_specular_color", skipdefault=True)
 
     Light("physical_sky", "bool", "lv_enable_physical_sky", skipdefault=True)
+    Light("envmaxres", "int", "lv_envmaxres", skipdefault=True)
 
     # -- Fog --
     Fog("name", "string", "object:name")
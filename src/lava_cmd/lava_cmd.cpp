@@ -34,6 +34,7 @@ namespace po = boost::program_options;
 #include "Falcor/Core/Platform/OS.h"
 #include "Falcor/Utils/Scripting/Scripting.h"
 #include "Falcor/Utils/Timing/Profiler.h"
+#include "Falcor/Utils/Timing/TraceRecorder.h"
 
 #include "lava_lib/version.h"
 #include "lava_lib/renderer.h"
@@ -110,6 +111,15 @@ static void writeProfilerStatsToFile(const std::string& outputFilename) {
 #endif
 }
 
+static void writeTraceToFile(const std::string& outputFilename) {
+  if(outputFilename.empty()) return;
+  auto& traceRecorder = Falcor::TraceRecorder::instance();
+  traceRecorder.setEnabled(false);
+  if(traceRecorder.writeToFile(outputFilename)) {
+    std::cout << "Trace of " << traceRecorder.getEventCount() << " events is written to file \'" << outputFilename << "\'\n";
+  }
+}
+
 
 int main(int argc, char** argv){
 
@@ -181,10 +191,14 @@ int main(int argc, char** argv){
     const std::string profilerCaptureDefaultFilename = "lava_profiling_stats.json";
     std::string vkValidationFilename;
     std::string profilerCaptureFilename;
+    std::string traceFilename;
+    size_t traceBufferSize = Falcor::TraceRecorder::kDefaultCapacity;
     po::options_description profiling("Profiling");
     profiling.add_options()
-      ("vk-validate", po::value<std::string>(&vkValidationFilename)->default_value(vkValidationFilename), "Output Vulkan validation info");
+      ("vk-validate", po::value<std::string>(&vkValidationFilename)->default_value(vkValidationFilename), "Output Vulkan validation info")
       ("perf-file", po::value<std::string>(&profilerCaptureFilename)->default_value(profilerCaptureDefaultFilename), "Output profiling file")
+      ("trace-file", po::value<std::string>(&traceFilename), "Output per thread CPU/GPU events trace file (Chrome trace format)")
+      ("trace-buffer-size", po::value<size_t>(&traceBufferSize)->default_value(traceBufferSize), "Number of trace events kept per thread")
       ;
 
     po::options_description cmdline_options;
@@ -219,7 +233,7 @@ int main(int argc, char** argv){
     // Set up logging 
     lava::ut::log::init_log();
     if(logFilename != "") lava::ut::log::init_file_log(logFilename);
-    boost::log::core::get()->set_filter(  boost::log::trivial::severity >= logSeverity );
+    lava::ut::log::set_severity_threshold(logSeverity);
 
     /** --help option 
      */ 
@@ -228,9 +242,7 @@ int main(int argc, char** argv){
       std::cout << config << "\n";
       std::cout << input << "\n";
       std::cout << logging << "\n";
-#ifdef FALCOR_ENABLE_PROFILER
       std::cout << profiling << "\n";
-#endif
       exit(EXIT_SUCCESS);
     }
 
@@ -257,6 +269,13 @@ int main(int argc, char** argv){
 
     // ---------------------
 
+    if(!traceFilename.empty()) {
+      auto& traceRecorder = Falcor::TraceRecorder::instance();
+      traceRecorder.setCapacity(traceBufferSize);
+      traceRecorder.setThreadName("Main");
+      traceRecorder.setEnabled(true);
+    }
+
     std::cout << "Lava version " << lava::versionString() << "\n";
     LLOG_INF << "Lava mode: " << (isDevelopmentMode() ? "development" : "production");
     
@@ -333,6 +352,8 @@ int main(int argc, char** argv){
         writeProfilerStatsToFile(profilerCaptureFilename);
       }
 
+      writeTraceToFile(traceFilename);
+
       // Shutdown scripting system before destroying renderer !
       Falcor::Scripting::shutdown();
     }
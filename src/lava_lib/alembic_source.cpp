@@ -0,0 +1,294 @@
+#include <thread>
+#include <cstring>
+#include <algorithm>
+
+#include "glm/gtc/type_ptr.hpp"
+
+#ifdef LAVA_USE_ALEMBIC
+#include <Alembic/AbcGeom/All.h>
+#include <Alembic/AbcCoreFactory/All.h>
+#endif
+
+#include "Falcor/Utils/TaskScheduler.h"
+#include "Falcor/Utils/Timing/TraceRecorder.h"
+
+#include "alembic_source.h"
+#include "lava_utils_lib/logging.h"
+
+namespace lava {
+
+using namespace Falcor;
+
+#ifdef LAVA_USE_ALEMBIC
+
+namespace Abc = Alembic::Abc;
+namespace AbcGeom = Alembic::AbcGeom;
+namespace AbcFactory = Alembic::AbcCoreFactory;
+
+struct AlembicSource::Archive {
+    Abc::IArchive archive;
+};
+
+namespace {
+
+// Index of the attribute value used by the face vertex (corner) of the given face
+inline size_t attributeValueIndex(AbcGeom::GeometryScope scope, size_t corner, size_t point, size_t face) {
+    switch(scope) {
+        case AbcGeom::kFacevaryingScope: return corner;
+        case AbcGeom::kVertexScope:
+        case AbcGeom::kVaryingScope: return point;
+        case AbcGeom::kUniformScope: return face;
+        default: return 0;
+    }
+}
+
+// Expand geometry parameter sample to face vertices. Returns false (and leaves output empty) if the sample doesn't fit the mesh.
+template<typename GeomParam, typename T>
+bool expandGeomParam(GeomParam& param, const Abc::ISampleSelector& selector, const Abc::Int32ArraySample& faceIndices, const Abc::Int32ArraySample& faceCounts, std::vector<T>& output) {
+    output.clear();
+    if(!param.valid()) return false;
+
+    const typename GeomParam::Sample sample = param.getExpandedValue(selector);
+    const auto pValues = sample.getVals();
+    if(!pValues || pValues->size() == 0) return false;
+
+    const size_t valueCount = pValues->size();
+    const AbcGeom::GeometryScope scope = sample.getScope();
+
+    output.resize(faceIndices.size());
+    size_t corner = 0;
+    for(size_t face = 0; face < faceCounts.size(); face++) {
+        const size_t count = static_cast<size_t>(faceCounts[face]);
+        for(size_t i = 0; i < count; i++, corner++) {
+            const size_t index = attributeValueIndex(scope, corner, static_cast<size_t>(faceIndices[corner]), face);
+            if(index >= valueCount) {
+                output.clear();
+                return false;
+            }
+            std::memcpy(&output[corner], &(*pValues)[index], sizeof(T));
+        }
+    }
+    return true;
+}
+
+template<typename Schema>
+bool readMeshSample(Schema& schema, AbcGeom::IN3fGeomParam normalsParam, const Abc::ISampleSelector& selector, const std::string& name, AlembicSource::MeshData& data) {
+    typename Schema::Sample sample;
+    schema.get(sample, selector);
+
+    const Abc::P3fArraySamplePtr pPositions = sample.getPositions();
+    const Abc::Int32ArraySamplePtr pFaceIndices = sample.getFaceIndices();
+    const Abc::Int32ArraySamplePtr pFaceCounts = sample.getFaceCounts();
+    if(!pPositions || !pFaceIndices || !pFaceCounts || pFaceIndices->size() == 0) {
+        LLOG_ERR << "Alembic object " << name << " has no faces";
+        return false;
+    }
+
+    const auto& P = *pPositions;
+    const auto& faceIndices = *pFaceIndices;
+    const auto& faceCounts = *pFaceCounts;
+
+    size_t cornerCount = 0;
+    for(size_t face = 0; face < faceCounts.size(); face++) cornerCount += static_cast<size_t>(std::max(faceCounts[face], 0));
+    if(cornerCount != faceIndices.size()) {
+        LLOG_ERR << "Alembic object " << name << " face counts don't match it's face indices";
+        return false;
+    }
+
+    data.positions.resize(cornerCount);
+    for(size_t corner = 0; corner < cornerCount; corner++) {
+        const int32_t point = faceIndices[corner];
+        if(point < 0 || static_cast<size_t>(point) >= P.size()) {
+            LLOG_ERR << "Alembic object " << name << " face index " << point << " is out of range";
+            return false;
+        }
+        data.positions[corner] = float3(P[point].x, P[point].y, P[point].z);
+    }
+
+    expandGeomParam(normalsParam, selector, faceIndices, faceCounts, data.normals);
+
+    AbcGeom::IV2fGeomParam uvsParam = schema.getUVsParam();
+    if(!expandGeomParam(uvsParam, selector, faceIndices, faceCounts, data.texCrds)) {
+        data.texCrds.assign(cornerCount, float2(0.f));
+    }
+
+    const bool computeNormals = data.normals.empty();
+    if(computeNormals) data.normals.resize(cornerCount);
+
+    // Alembic faces are clockwise as in Houdini, so triangle fans are emitted in reverse order just like bgeo polygons
+    data.indices.clear();
+    data.indices.reserve((cornerCount - std::min(cornerCount, faceCounts.size() * 2)) * 3);
+    data.faceCount = 0;
+
+    uint32_t start = 0;
+    for(size_t face = 0; face < faceCounts.size(); face++) {
+        const uint32_t count = static_cast<uint32_t>(std::max(faceCounts[face], 0));
+        if(count >= 3) {
+            for(uint32_t i = 1; i + 1 < count; i++) {
+                data.indices.push_back(start + i + 1);
+                data.indices.push_back(start + i);
+                data.indices.push_back(start);
+            }
+            data.faceCount += count - 2;
+
+            if(computeNormals) {
+                // Newell's method, negated for clockwise winding
+                float3 normal(0.f);
+                for(uint32_t i = 0; i < count; i++) {
+                    const float3& a = data.positions[start + i];
+                    const float3& b = data.positions[start + (i + 1) % count];
+                    normal += float3((a.y - b.y) * (a.z + b.z), (a.z - b.z) * (a.x + b.x), (a.x - b.x) * (a.y + b.y));
+                }
+                const float length = glm::length(normal);
+                normal = (length > 0.f) ? -normal / length : float3(0.f, 1.f, 0.f);
+                std::fill(data.normals.begin() + start, data.normals.begin() + start + count, normal);
+            }
+        }
+        start += count;
+    }
+
+    if(data.faceCount == 0) {
+        LLOG_ERR << "Alembic object " << name << " has no valid polygons";
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+#else
+
+struct AlembicSource::Archive {};
+
+#endif  // LAVA_USE_ALEMBIC
+
+AlembicSource::SharedPtr AlembicSource::create() {
+    return SharedPtr(new AlembicSource());
+}
+
+AlembicSource::~AlembicSource() {}
+
+bool AlembicSource::isAvailable() {
+#ifdef LAVA_USE_ALEMBIC
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::shared_ptr<AlembicSource::Archive> AlembicSource::getArchive(const std::string& archivePath) {
+    std::promise<std::shared_ptr<Archive>> archivePromise;
+    std::shared_future<std::shared_ptr<Archive>> archiveFuture;
+    bool isOpening = false;
+    {
+        std::scoped_lock lock(mArchivesMutex);
+        auto it = mArchives.find(archivePath);
+        if(it != mArchives.end()) {
+            archiveFuture = it->second;
+        } else {
+            archiveFuture = archivePromise.get_future().share();
+            mArchives[archivePath] = archiveFuture;
+            isOpening = true;
+        }
+    }
+
+    if(!isOpening) {
+        // Another thread may still be opening the archive. Run pending work meanwhile instead of idling.
+        TaskScheduler::instance().helpWhileWaiting([&archiveFuture](std::chrono::microseconds timeout) {
+            return archiveFuture.wait_for(timeout) == std::future_status::ready;
+        });
+        return archiveFuture.get();
+    }
+
+    std::shared_ptr<Archive> pArchive;
+#ifdef LAVA_USE_ALEMBIC
+    TRACE_SCOPE("AlembicSource::openArchive");
+    try {
+        // Ogawa archives are read through a stream per thread, so objects can be read concurrently from a single reader
+        AbcFactory::IFactory factory;
+        factory.setPolicy(Abc::ErrorHandler::kThrowPolicy);
+        factory.setOgawaNumStreams(std::max(1u, std::thread::hardware_concurrency()));
+
+        AbcFactory::IFactory::CoreType coreType;
+        Abc::IArchive archive = factory.getArchive(archivePath, coreType);
+        if(archive.valid()) {
+            pArchive = std::make_shared<Archive>();
+            pArchive->archive = archive;
+            LLOG_DBG << "Alembic archive " << archivePath << " opened";
+        } else {
+            LLOG_ERR << "Unable to open Alembic archive " << archivePath;
+        }
+    } catch (const std::exception& e) {
+        LLOG_ERR << "Error opening Alembic archive " << archivePath << " : " << e.what();
+    }
+#endif
+
+    // Failed archives stay cached as nullptr so they are not reopened by every reference
+    archivePromise.set_value(pArchive);
+    return pArchive;
+}
+
+bool AlembicSource::readMesh(const std::string& archivePath, const std::string& objectPath, double time, MeshData& data) {
+#ifdef LAVA_USE_ALEMBIC
+    TRACE_SCOPE("AlembicSource::readMesh");
+
+    auto pArchive = getArchive(archivePath);
+    if(!pArchive) return false;
+
+    const std::string name = archivePath + ":" + objectPath;
+    try {
+        const Abc::ISampleSelector selector(time);
+
+        // Walk down the object path accumulating transforms of the xforms above the object
+        Abc::IObject object = pArchive->archive.getTop();
+        glm::mat4 transform(1.f);
+
+        size_t begin = 0;
+        while(begin < objectPath.size()) {
+            size_t end = objectPath.find('/', begin);
+            if(end == std::string::npos) end = objectPath.size();
+            if(end > begin) {
+                object = object.getChild(objectPath.substr(begin, end - begin));
+                if(!object.valid()) {
+                    LLOG_ERR << "Alembic object " << name << " not found";
+                    return false;
+                }
+
+                if(AbcGeom::IXform::matches(object.getHeader())) {
+                    AbcGeom::IXform xform(object, Abc::kWrapExisting);
+                    AbcGeom::XformSample xformSample;
+                    xform.getSchema().get(xformSample, selector);
+
+                    // Row-major row-vector matrix reads as column-major column-vector one
+                    const Abc::M44d m = xformSample.getMatrix();
+                    const glm::mat4 local = glm::mat4(glm::make_mat4(m.getValue()));
+                    transform = xformSample.getInheritsXforms() ? transform * local : local;
+                }
+            }
+            begin = end + 1;
+        }
+
+        data.transform = transform;
+
+        if(AbcGeom::IPolyMesh::matches(object.getHeader())) {
+            AbcGeom::IPolyMesh mesh(object, Abc::kWrapExisting);
+            auto& schema = mesh.getSchema();
+            return readMeshSample(schema, schema.getNormalsParam(), selector, name, data);
+        } else if(AbcGeom::ISubD::matches(object.getHeader())) {
+            AbcGeom::ISubD subd(object, Abc::kWrapExisting);
+            return readMeshSample(subd.getSchema(), AbcGeom::IN3fGeomParam(), selector, name, data);
+        }
+
+        LLOG_ERR << "Alembic object " << name << " is not a polygon mesh. Only PolyMesh and SubD objects are supported";
+    } catch (const std::exception& e) {
+        LLOG_ERR << "Error reading Alembic object " << name << " : " << e.what();
+    }
+    return false;
+#else
+    static std::once_flag warned;
+    std::call_once(warned, [] { LLOG_ERR << "Lava is built without Alembic support. Alembic packed primitives are skipped"; });
+    return false;
+#endif
+}
+
+}  // namespace lava
@@ -0,0 +1,64 @@
+#ifndef SRC_LAVA_LIB_ALEMBIC_SOURCE_H_
+#define SRC_LAVA_LIB_ALEMBIC_SOURCE_H_
+
+#include <memory>
+#include <mutex>
+#include <future>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "Falcor/Utils/Math/Vector.h"
+#include "glm/mat4x4.hpp"
+
+namespace lava {
+
+/** Reads polygon mesh samples straight from Alembic archives referenced by AlembicRef packed primitives.
+ *  Each archive is opened once and it's reader is shared by all threads reading objects from it.
+ *  Without Alembic support compiled in (LAVA_USE_ALEMBIC) every read fails with an error.
+ */
+class AlembicSource {
+	public:
+		using SharedPtr = std::shared_ptr<AlembicSource>;
+
+		/** Triangulated mesh sample. Attributes are stored per face vertex and indexed by triangles.
+		 */
+		struct MeshData {
+			std::vector<Falcor::float3> positions;
+			std::vector<Falcor::float3> normals;	// Object normals or flat face normals if it has none
+			std::vector<Falcor::float2> texCrds;	// Object uvs or zeroes if it has none
+			std::vector<uint32_t> indices;
+			uint32_t faceCount = 0;
+			glm::mat4 transform = glm::mat4(1.f);	// Object to archive space transform at the sample time
+		};
+
+		static SharedPtr create();
+		~AlembicSource();
+
+		/** True if lava is built with Alembic support.
+		 */
+		static bool isAvailable();
+
+		/** Read PolyMesh or SubD object sample nearest to the given time (in seconds).
+		 *  \param[in] archivePath Alembic archive file path.
+		 *  \param[in] objectPath Full object path inside the archive, e.g. "/root/geo/shape".
+		 *  \param[in] time Sample time in seconds.
+		 *  \param[out] data Triangulated mesh sample.
+		 *  \return True on success.
+		 */
+		bool readMesh(const std::string& archivePath, const std::string& objectPath, double time, MeshData& data);
+
+	private:
+		AlembicSource() = default;
+
+		struct Archive;
+		std::shared_ptr<Archive> getArchive(const std::string& archivePath);
+
+	private:
+		std::mutex mArchivesMutex;
+		std::unordered_map<std::string, std::shared_future<std::shared_ptr<Archive>>> mArchives; // archive path to it's shared reader
+};
+
+}  // namespace lava
+
+#endif  // SRC_LAVA_LIB_ALEMBIC_SOURCE_H_
@@ -194,7 +194,7 @@ class LAVA_API AOVPlane: public std::enable_shared_from_this<AOVPlane> {
     bool getAOVPlaneGeometry(AOVPlaneGeometry& aov_plane_geometry) const;
 
     void setFormat(Falcor::ResourceFormat format);
-    inline void reset() { if (mpAccumulatePass) mpAccumulatePass->reset(); }; // reset associated accumulator
+    inline void reset() { if (mpAccumulatePass) mpAccumulatePass->reset(); if (mpDenoiserPass) mpDenoiserPass->reset(); }; // reset associated accumulator and denoiser
 
     inline bool isBound() const;
 
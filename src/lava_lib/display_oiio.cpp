@@ -6,6 +6,7 @@
 #include <boost/format.hpp>
 
 #include "display_oiio.h"
+#include "Falcor/Utils/Timing/TraceRecorder.h"
 #include "lava_utils_lib/logging.h"
 
 namespace lava {
@@ -326,6 +327,8 @@ bool DisplayOIIO::closeImage(uint imageHandle) {
 }
 
 bool DisplayOIIO::sendImageRegion(uint imageHandle, uint x, uint y, uint width, uint height, const uint8_t *pData) {
+	TRACE_SCOPE("DisplayOIIO::sendImageRegion");
+
 	auto const& imData = mImages[imageHandle];
 
 	if(!imData.opened) {
@@ -355,6 +358,8 @@ bool DisplayOIIO::sendImageRegion(uint imageHandle, uint x, uint y, uint width,
 }
 
 bool DisplayOIIO::sendImage(uint imageHandle, uint width, uint height, const uint8_t *pData) {
+	TRACE_SCOPE("DisplayOIIO::sendImage");
+
 	auto const& imData = mImages[imageHandle];
 
 	//if(!imData.opened) {
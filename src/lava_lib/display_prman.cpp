@@ -9,6 +9,7 @@
 #include <boost/format.hpp>
 
 #include "display_prman.h"
+#include "Falcor/Utils/Timing/TraceRecorder.h"
 #include "lava_utils_lib/logging.h"
 
 // Make sure that we've got the correct sizes for the PtDspy* integral constants
@@ -357,6 +358,8 @@ bool DisplayPrman::closeImage(uint imageHandle) {
 }
 
 bool DisplayPrman::sendImageRegion(uint imageHandle, uint x, uint y, uint width, uint height, const uint8_t *pData) {
+    TRACE_SCOPE("DisplayPrman::sendImageRegion");
+
     auto const& image_data = mImages[imageHandle];
 
     if(!image_data.opened) {
@@ -391,6 +394,8 @@ bool DisplayPrman::sendImageRegion(uint imageHandle, uint x, uint y, uint width,
 }
 
 bool DisplayPrman::sendImage(uint imageHandle, uint width, uint height, const uint8_t *pData) {
+    TRACE_SCOPE("DisplayPrman::sendImage");
+
     auto const& image_data = mImages[imageHandle];
 
     if(!image_data.opened) {
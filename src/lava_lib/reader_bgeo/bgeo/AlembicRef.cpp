@@ -0,0 +1,44 @@
+/*
+ *  Copyright 2018 Laika, LLC. Authored by Peter Stuart
+ *
+ *  Licensed under the Apache License, Version 2.0, <LICENSE-APACHE or
+ *  http://apache.org/licenses/LICENSE-2.0> or the MIT license <LICENSE-MIT or
+ *  http://opensource.org/licenses/MIT>, at your option. This file may not be
+ *  copied, modified, or distributed except according to those terms.
+ */
+
+#include "AlembicRef.h"
+
+#include "parser/AlembicRef.h"
+#include "PrimType.h"
+#include "Bgeo.h"
+
+namespace ika {
+namespace bgeo {
+
+RTTI_DEFINE(AlembicRef, PackedGeometry, PrimType::AlembicPrimType)
+
+AlembicRef::AlembicRef(const parser::AlembicRef& ref)
+    : PackedGeometry(ref, std::shared_ptr<Bgeo>()),
+      m_ref(ref)
+{
+}
+
+std::string AlembicRef::getFilename() const {
+    return m_ref.getFilename();
+}
+
+std::string AlembicRef::getObjectPath() const {
+    return m_ref.getObjectPath();
+}
+
+double AlembicRef::getFrame() const {
+    return m_ref.getFrame();
+}
+
+bool AlembicRef::getUseTransform() const {
+    return m_ref.getUseTransform();
+}
+
+} // namespace ika
+} // namespace bgeo
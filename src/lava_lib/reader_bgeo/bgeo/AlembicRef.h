@@ -0,0 +1,46 @@
+/*
+ *  Copyright 2018 Laika, LLC. Authored by Peter Stuart
+ *
+ *  Licensed under the Apache License, Version 2.0, <LICENSE-APACHE or
+ *  http://apache.org/licenses/LICENSE-2.0> or the MIT license <LICENSE-MIT or
+ *  http://opensource.org/licenses/MIT>, at your option. This file may not be
+ *  copied, modified, or distributed except according to those terms.
+ */
+
+#ifndef BGEO_ALEMBIC_REF_H
+#define BGEO_ALEMBIC_REF_H
+
+#include <string>
+
+#include "rtti.h"
+#include "PackedGeometry.h"
+
+namespace ika
+{
+namespace bgeo
+{
+
+namespace parser
+{
+class AlembicRef;
+}
+
+class AlembicRef : public PackedGeometry {
+    RTTI_DECLARE(AlembicRef, PackedGeometry)
+
+public:
+    AlembicRef(const parser::AlembicRef& ref);
+
+    std::string getFilename() const;
+    std::string getObjectPath() const;
+    double getFrame() const;
+    bool getUseTransform() const;
+
+private:
+    const parser::AlembicRef& m_ref;
+};
+
+} // namespace ika
+} // namespace bgeo
+
+#endif // BGEO_ALEMBIC_REF_H
@@ -29,7 +29,7 @@ Attribute::Attribute(const parser::Attribute& attribute)
 
 const char* Attribute::getSubType() const
 {
-    return m_attribute.subtype ? m_attribute.subtype.buffer() : "";
+    return m_attribute.subtype.c_str();
 }
 
 int32_t Attribute::getTupleSize() const
@@ -44,12 +44,12 @@ parser::storage::Storage Attribute::getFundamentalType() const
 
 const char* Attribute::getName() const
 {
-    return m_attribute.name.buffer();
+    return m_attribute.name.c_str();
 }
 
 const char* Attribute::getType() const
 {
-    return m_attribute.type.buffer();
+    return m_attribute.type.c_str();
 }
 
 void Attribute::getStrings(std::vector<std::string>& data) const
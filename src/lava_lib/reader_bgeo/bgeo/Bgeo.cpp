@@ -9,9 +9,6 @@
 
 #include "Bgeo.h"
 
-#include <UT/UT_IStream.h>
-#include <UT/UT_JSONParser.h>
-
 #include "parser/ReadError.h"
 #include "parser/Detail.h"
 #include "parser/Attribute.h"
@@ -19,6 +16,8 @@
 #include "parser/PrimitiveGroup.h"
 #include "parser/compression.h"
 #include "parser/Info.h"
+#include "parser/JSONParser.h"
+#include "parser/util.h"
 
 #include "Primitive.h"
 #include "Poly.h"
@@ -42,43 +41,30 @@ class Bgeo::Impl {
     std::shared_ptr<parser::Detail> detail;
     factory::EmbeddedGeoMap embeddedGeoMap;
 
-    void parseStream(UT_IStream& stream);
+    void parseContent(const char* data, size_t size);
 };
 
 Bgeo::Impl::Impl(const std::string& bgeoString, bool checkVersion): detail(new parser::Detail(checkVersion)) {
-    UT_IStream stream(bgeoString.data(), bgeoString.size(), UT_ISTREAM_BINARY);
-    if (stream.isError()) {
-        UT_String message;
-        message.sprintf("Unable to read bgeo string");
-        throw parser::ReadError(message);
-    }
-
-    parseStream(stream);
+    parseContent(bgeoString.data(), bgeoString.size());
 }
 
 Bgeo::Impl::Impl(const char *bgeoPath, bool checkVersion): detail(new parser::Detail(checkVersion)) {
-    UT_IFStream stream(bgeoPath, UT_ISTREAM_BINARY);
-    if (stream.isError()) {
-        UT_String message;
-        message.sprintf("Unable to read file: %s", bgeoPath);
-        throw parser::ReadError(message);
+    // uncompressed, blosc (.sc) and gzip (.gz) files are decoded whole
+    parser::ContentReader reader;
+    if (!reader.open(bgeoPath) || !reader.grow(0)) {
+        throw parser::ReadError(parser::formatMessage("Unable to read file: %s", bgeoPath));
     }
 
-    auto decompStream = ika::bgeo::parser::getDecompressionStream(bgeoPath, stream);
-    if (decompStream) {
-        parseStream(*decompStream);
-    } else {
-        parseStream(stream);
-    }
+    parseContent(reader.content().data(), reader.content().size());
 }
 
 Bgeo::Impl::Impl(std::shared_ptr<parser::Detail> detail): detail(detail) {}
 
 void
- Bgeo::Impl::parseStream(UT_IStream& stream) {
-    UT_AutoJSONParser parserLoader(stream);
+ Bgeo::Impl::parseContent(const char* data, size_t size) {
+    parser::JSONParser parser(data, size);
     assert(detail);
-    detail->loadGeometry(parserLoader.parser());
+    detail->loadGeometry(parser);
 }
 
 // Bgeo class
@@ -222,6 +208,22 @@ void Bgeo::getVertexUV(std::vector<float>& uv) const {
     attribute->data.copyTo(uv.data(), 2, vertexCount, 0, vertexCount);
 }
 
+bool Bgeo::getPointFloatAttribute(const char* name, int32_t tupleSize, std::vector<float>& data) const {
+    const bgeo::parser::Attribute* attribute = m_pimpl->detail->getPointAttributeByName(name);
+    if (!attribute || attribute->data.tupleSize < tupleSize) {
+        return false;
+    }
+    // double precision attributes are narrowed to float
+    if (attribute->data.storage != parser::storage::Fpreal32 && attribute->data.storage != parser::storage::Fpreal64) {
+        return false;
+    }
+
+    int64_t pointCount = getPointCount();
+    data.resize(tupleSize * pointCount);
+    attribute->data.copyTo(data.data(), tupleSize, pointCount, 0, pointCount);
+    return true;
+}
+
 Bgeo::PrimitivePtr Bgeo::getPrimitive(int64_t index) const {
     if (index >= m_primitiveCache.size()) {
         m_primitiveCache.resize(index + 1);
@@ -324,7 +326,7 @@ int64_t Bgeo::getPrimitiveGroupCount() const {
 std::string Bgeo::getPrimitiveGroupName(int64_t index) const {
     assert(index < m_pimpl->detail->primitiveGroups.size());
     const parser::PrimitiveGroup& group = *m_pimpl->detail->primitiveGroups[index];
-    return group.name.buffer();
+    return group.name;
 }
 
 void Bgeo::getPrimitiveGroup(int64_t index, std::vector<int32_t>& groupIndices) const {
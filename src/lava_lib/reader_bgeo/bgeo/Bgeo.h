@@ -69,6 +69,11 @@ class Bgeo: public std::enable_shared_from_this<Bgeo> {
     void getVertexN(std::vector<float>& N) const;
     void getVertexUV(std::vector<float>& uv) const;
 
+    // copies first tupleSize components of float point attribute. 64 bit float
+    // attributes are narrowed to float. returns false if attribute doesn't exist,
+    // isn't float or has smaller tuple size.
+    bool getPointFloatAttribute(const char* name, int32_t tupleSize, std::vector<float>& data) const;
+
     int64_t getPointAttributeCount() const;
     typedef std::shared_ptr<Attribute> AttributePtr;
     AttributePtr getPointAttribute(int64_t index) const;
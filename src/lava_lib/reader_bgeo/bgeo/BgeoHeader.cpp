@@ -9,14 +9,14 @@
 
 #include "BgeoHeader.h"
 
-#include "UT/UT_IStream.h"
-#include "UT/UT_JSONParser.h"
+#include <cstring>
 
 #include "parser/ReadError.h"
 #include "parser/FileVersion.h"
 #include "parser/util.h"
 #include "parser/Info.h"
 #include "parser/compression.h"
+#include "parser/JSONTokenizer.h"
 
 namespace ika {
 namespace bgeo {
@@ -29,45 +29,76 @@ class BgeoHeader::Impl {
     parser::FileVersion fileVersion;
     parser::Info info;
 
-    void parseStream(UT_IStream& stream);
+    bool parseContent(const std::vector<char>& content);
 };
 
+namespace {
+
+// header is normally within the first few kilobytes of the file
+const size_t kHeaderReadSize = 64 * 1024;
+
+} // anonymous namespace
+
 BgeoHeader::Impl::Impl(const char* bgeoPath) {
-    UT_IFStream stream(bgeoPath, UT_ISTREAM_BINARY);
-    if (stream.isError()) {
-        UT_String message;
-        message.sprintf("Unable to read file: %s", bgeoPath);
-        throw parser::ReadError(message);
+    // File is read once and only a prefix of the content is decoded, it grows
+    // until the info map is complete.
+    parser::ContentReader reader;
+    if (!reader.open(bgeoPath)) {
+        throw parser::ReadError(parser::formatMessage("Unable to read file: %s", bgeoPath));
     }
 
-    auto decompStream = ika::bgeo::parser::getDecompressionStream(bgeoPath, stream);
-    if (decompStream) {
-        parseStream(*decompStream);
-    } else {
-        parseStream(stream);
+    for (size_t readSize = kHeaderReadSize; ; readSize *= 2) {
+        if (!reader.grow(readSize)) {
+            throw parser::ReadError(parser::formatMessage("Unable to read file: %s", bgeoPath));
+        }
+
+        try {
+            if (parseContent(reader.content())) {
+                return;
+            }
+        } catch (const parser::JSONTokenizer::Error& error) {
+            if (reader.complete()) {
+                throw parser::ReadError(parser::formatMessage("Unable to read header of %s: %s",
+                                                              bgeoPath, error.what()));
+            }
+        }
+
+        if (reader.complete()) {
+            throw parser::ReadError(parser::formatMessage("Missing info in header of %s", bgeoPath));
+        }
     }
 }
 
-void BgeoHeader::Impl::parseStream(UT_IStream& stream) {
-    UT_AutoJSONParser parserLoader(stream);
-    UT_JSONParser parser = parserLoader.parser();
+bool BgeoHeader::Impl::parseContent(const std::vector<char>& content) {
+    using parser::JSONTokenizer;
 
-    parser::parseBeginArray(parser);
-    {
-        fileVersion.load(parser);
+    JSONTokenizer tokenizer(content.data(), content.size());
+    JSONTokenizer::Token token;
+    if (!tokenizer.next(token) || token.type != JSONTokenizer::BeginArrayToken) {
+        throw JSONTokenizer::Error("Expected geometry array");
+    }
 
-        if (fileVersion.major > 13)
-        {
-            parser::parseSkipKeyAndValue(parser); // skip hasindex
+    while (tokenizer.next(token) && token.type == JSONTokenizer::StringToken) {
+        std::string key = token.stringValue;
+        tokenizer.next(token);
+
+        if (key == "fileversion") {
+            if (token.type != JSONTokenizer::StringToken) {
+                throw JSONTokenizer::Error("Expected file version string");
+            }
+            fileVersion.parse(token.stringValue);
+        } else if (key == "info") {
+            info.load(tokenizer, token);
+            return true;
+        } else {
+            tokenizer.skipValue(token);
         }
+    }
 
-        parser::parseSkipKeyAndValue(parser); // skip pointcount
-        parser::parseSkipKeyAndValue(parser); // skip vertexcount
-        parser::parseSkipKeyAndValue(parser); // skip primitivecount
-
-        parser::parseArrayKey(parser, "info");
-        info.load(parser);
+    if (token.type == JSONTokenizer::EndToken) {
+        throw JSONTokenizer::Error("Unexpected end of geometry header");
     }
+    return false;
 }
 
 BgeoHeader::BgeoHeader(const char* bgeoPath): m_pimpl(new Impl(bgeoPath)) {}
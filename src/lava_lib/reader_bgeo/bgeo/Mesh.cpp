@@ -21,7 +21,7 @@ void Mesh::getStartIndices(std::vector<int32_t>& startIndices) const {
     startIndices.resize(m_mesh.sides.size() + 1);
     startIndices[0] = 0;
 
-    int64 current = 0;
+    int64_t current = 0;
     for (int i = 0; i < m_mesh.sides.size(); ++i)
     {
         current += m_mesh.sides[i];
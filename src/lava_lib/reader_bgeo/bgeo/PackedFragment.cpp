@@ -34,7 +34,7 @@ std::string PackedFragment::getName() const {
 }
 
 std::string PackedFragment::getEmbeddedKey() const {
-    return m_fragment.getEmbeddedKey().c_str();
+    return m_fragment.getEmbeddedKey();
 }
 
 } // namespace ika
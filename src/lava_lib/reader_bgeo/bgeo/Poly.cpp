@@ -44,7 +44,7 @@ void Poly::getStartIndices(std::vector<int32_t>& startIndices) const {
     startIndices.resize(m_poly.sides.size() + 1);
     startIndices[0] = 0;
 
-    int64 current = 0;
+    int64_t current = 0;
     for (int i = 0; i < m_poly.sides.size(); ++i) {
         current += m_poly.sides[i];
         startIndices[i + 1] = current;
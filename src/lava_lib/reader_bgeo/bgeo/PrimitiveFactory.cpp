@@ -11,6 +11,7 @@
 
 #include <cassert>
 
+#include "parser/AlembicRef.h"
 #include "parser/PackedDisk.h"
 #include "parser/PackedFragment.h"
 #include "parser/PackedGeometry.h"
@@ -24,6 +25,7 @@
 #include "parser/Volume.h"
 #include "parser/Mesh.h"
 
+#include "AlembicRef.h"
 #include "PackedDisk.h"
 #include "PackedFragment.h"
 #include "PackedGeometry.h"
@@ -67,6 +69,13 @@ Bgeo::PrimitivePtr create(const Bgeo& bgeo, const parser::Primitive& parserPrimi
         assert(parserDisk);
         return Bgeo::PrimitivePtr(new PackedDisk(*parserDisk));
     }
+    case parser::Primitive::AlembicRefType:
+    {
+        const parser::AlembicRef* parserRef =
+                reinterpret_cast<const parser::AlembicRef*>(&parserPrimitive);
+        assert(parserRef);
+        return Bgeo::PrimitivePtr(new AlembicRef(*parserRef));
+    }
     case parser::Primitive::PackedFragmentType:
     {
         const parser::PackedFragment* parserFragment =
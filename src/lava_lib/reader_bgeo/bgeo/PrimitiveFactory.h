@@ -11,8 +11,7 @@
 #define BGEO_PRIMITIVE_FACTORY_H
 
 #include <map>
-
-#include <UT/UT_String.h>
+#include <string>
 
 #include "Bgeo.h"
 
@@ -25,7 +24,7 @@ class Primitive;
 
 namespace factory {
 
-typedef std::map<UT_String, std::shared_ptr<Bgeo>> EmbeddedGeoMap;
+typedef std::map<std::string, std::shared_ptr<Bgeo>> EmbeddedGeoMap;
 Bgeo::PrimitivePtr create(const Bgeo& bgeo, const parser::Primitive& parserPrimitive, EmbeddedGeoMap& embeddedGeoMap, size_t index);
 
 }
@@ -9,6 +9,8 @@
 
 #include "Volume.h"
 
+#include <cstring>
+
 #include "parser/Volume.h"
 
 namespace ika {
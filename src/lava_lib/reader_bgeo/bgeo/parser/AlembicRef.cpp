@@ -9,10 +9,6 @@
 
 #include "AlembicRef.h"
 
-#include <cassert>
-
-#include <UT/UT_JSONHandle.h>
-
 #include "Detail.h"
 #include "ReadError.h"
 #include "util.h"
@@ -25,7 +21,18 @@ namespace parser
 {
 
 AlembicRef::AlembicRef(const Detail& detail)
-    : Primitive(detail)
+    : PackedGeometry(detail),
+      frame(0.0),
+      useTransform(true)
+{
+}
+
+AlembicRef::AlembicRef(const AlembicRef& ref)
+    : PackedGeometry(ref),
+      filename(ref.filename),
+      objectPath(ref.objectPath),
+      frame(ref.frame),
+      useTransform(ref.useTransform)
 {
 }
 
@@ -34,27 +41,77 @@ AlembicRef* AlembicRef::clone() const
     return new AlembicRef(*this);
 }
 
-/*virtual*/ void AlembicRef::loadData(UT_JSONParser &parser)
+bool AlembicRef::parseParametersWithKey(JSONParser& parser,
+                                        const std::string& key)
 {
-    parseBeginArray(parser);
+    if (PackedGeometry::parseParametersWithKey(parser, key))
     {
-        parseArrayKey(parser, "parameters");
-        VertexArrayBuilder vertexBuilder(vertices, sides);
-        BGEO_CHECK(parser.parseObject(vertexBuilder));
-
-        closed.resize(1);
-        bool closedValue = true;
-        parseArrayValueForKey(parser, "closed", closedValue);
-        closed[0] = closedValue;
+        return true;
     }
-    parseEndArray(parser);
+
+    if (key == "filename" || key == "abcfilename")
+    {
+        std::string buffer;
+        BGEO_CHECK(parser.parseValue(buffer));
+        filename = buffer;
+    }
+    else if (key == "object" || key == "abcobjectpath")
+    {
+        std::string buffer;
+        BGEO_CHECK(parser.parseValue(buffer));
+        objectPath = buffer;
+    }
+    else if (key == "frame" || key == "abcframe")
+    {
+        BGEO_CHECK(parser.parseValue(frame));
+    }
+    else if (key == "usetransform" || key == "abcusetransform")
+    {
+        BGEO_CHECK(parser.parseValue(useTransform));
+    }
+    else
+    {
+        // Viewport, visibility and attribute loading options don't affect
+        // the referenced geometry.
+        BGEO_CHECK(parser.skipNextObject());
+    }
+
+    return true;
 }
 
-/*virtual*/ std::ostream& AlembicRef::encode(std::ostream& co) const
+std::ostream& AlembicRef::encode(std::ostream& co) const
 {
+    PackedGeometry::encode(co);
+
+    co << "\n"
+       << "    filename = " << filename << "\n"
+       << "    object = " << objectPath << "\n"
+       << "    frame = " << frame << "\n"
+       << "    usetransform = " << (useTransform ? "true" : "false");
+
     return co;
 }
 
+std::string AlembicRef::getFilename() const
+{
+    return filename;
+}
+
+std::string AlembicRef::getObjectPath() const
+{
+    return objectPath;
+}
+
+double AlembicRef::getFrame() const
+{
+    return frame;
+}
+
+bool AlembicRef::getUseTransform() const
+{
+    return useTransform;
+}
+
 } // namespace parser
-} // namespace ika
 } // namespace bgeo
+} // namespace ika
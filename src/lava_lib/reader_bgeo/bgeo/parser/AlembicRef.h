@@ -10,10 +10,10 @@
 #ifndef BGEO_PARSER_ALEMBIC_REF_H
 #define BGEO_PARSER_ALEMBIC_REF_H
 
-#include <vector>
+#include <string>
 
-#include "Primitive.h"
-#include "VertexArrayBuilder.h"
+
+#include "PackedGeometry.h"
 
 namespace ika
 {
@@ -22,11 +22,13 @@ namespace bgeo
 namespace parser
 {
 
-class AlembicRef : public Primitive
+// Alembic packed primitive. It references an object in an archive on disk,
+// the geometry itself isn't stored in the bgeo.
+class AlembicRef : public PackedGeometry
 {
 public:
-    AlembicRef(const Detail& detail);
-    AlembicRef(const AlembicRef& poly) = default;
+    explicit AlembicRef(const Detail& detail);
+    AlembicRef(const AlembicRef& ref);
 
     /*virtual*/ AlembicRef* clone() const;
 
@@ -35,19 +37,27 @@ public:
         return AlembicRefType;
     }
 
-    /*virtual*/ void loadData(UT_JSONParser &parser);
+    /*virtual*/ bool parseParametersWithKey(JSONParser& parser,
+                                            const std::string& key);
 
     /*virtual*/ std::ostream& encode(std::ostream& co) const;
 
-    VertexArrayBuilder::VertexArray vertices;
-    VertexArrayBuilder::VertexArray sides;
+    std::string getFilename() const;
+    std::string getObjectPath() const;
+
+    // Sample time in seconds (Houdini stores frame / fps as "frame")
+    double getFrame() const;
+    bool getUseTransform() const;
 
-    typedef std::vector<bool> ClosedArray;
-    ClosedArray closed;
+private:
+    std::string filename;
+    std::string objectPath;
+    double frame;
+    bool useTransform;
 };
 
 } // namespace parser
-} // namespace ika
 } // namespace bgeo
+} // namespace ika
 
 #endif // BGEO_PARSER_ALEMBIC_REF_H
@@ -11,8 +11,6 @@
 
 #include <cassert>
 
-#include <UT/UT_JSONHandle.h>
-
 #include "util.h"
 #include "ReadError.h"
 
@@ -25,7 +23,7 @@ namespace parser
 
 // FIXME move into common location since it is used by Run as well
 
-class StringListHandle : public UT_JSONHandleError
+class StringListHandle : public JSONHandle
 {
 public:
     StringListHandle(std::vector<std::string>& strings)
@@ -33,18 +31,18 @@ public:
     {
     }
 
-    /*virtual*/ bool jsonString(UT_JSONParser &p, const char *value, int64 len)
+    /*virtual*/ bool jsonString(JSONParser &p, const char *value, int64 len)
     {
         strings.push_back(value);
         return true;
     }
 
-    /*virtual*/ bool jsonBeginArray(UT_JSONParser &p)
+    /*virtual*/ bool jsonBeginArray(JSONParser &p)
     {
         return true;
     }
 
-    /*virtual*/ bool jsonEndArray(UT_JSONParser &p)
+    /*virtual*/ bool jsonEndArray(JSONParser &p)
     {
         return true;
     }
@@ -59,7 +57,7 @@ Attribute::Attribute(int64 elementCount)
 {
 }
 
-void Attribute::load(UT_JSONParser& parser)
+void Attribute::load(JSONParser& parser)
 {
     parseBeginArray(parser);
     {
@@ -70,12 +68,12 @@ void Attribute::load(UT_JSONParser& parser)
             parseArrayValueForKey(parser, "name", name);
             parseArrayKey(parser, "options");
 
-            UT_WorkBuffer buffer;
-            UT_String key;
+            std::string buffer;
+            std::string key;
             for (auto it = parser.beginMap(); !it.atEnd(); ++it)
             {
                 it.getLowerKey(buffer);
-                key = buffer.buffer();
+                key = buffer;
                 if (key == "type")
                 {
                     parseBeginMap(parser);
@@ -95,13 +93,13 @@ void Attribute::load(UT_JSONParser& parser)
         }
         parseEndArray(parser);
 
-        UT_WorkBuffer buffer;
-        UT_String key;
+        std::string buffer;
+        std::string key;
         storage::Storage storage;
         for (auto it = parser.beginArray(); !it.atEnd(); ++it)
         {
             it.getLowerKey(buffer);
-            key = buffer.buffer();
+            key = buffer;
             if (key == "size")
             {
                 BGEO_CHECK(parser.skipNextObject());
@@ -109,7 +107,7 @@ void Attribute::load(UT_JSONParser& parser)
             else if (key == "storage")
             {
                 BGEO_CHECK(parser.parseString(buffer));
-                storage = storage::toStorage(buffer.buffer());
+                storage = storage::toStorage(buffer.c_str());
             }
             else if (key == "defaults")
             {
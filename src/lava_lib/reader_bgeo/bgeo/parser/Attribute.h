@@ -10,7 +10,7 @@
 #ifndef BGEO_PARSER_ATTRIBUTE_H
 #define BGEO_PARSER_ATTRIBUTE_H
 
-#include <UT/UT_JSONParser.h>
+#include "JSONParser.h"
 
 #include "ByteBuffer.h"
 #include "NumericData.h"
@@ -27,22 +27,22 @@ class Attribute
 public:
     Attribute(int64 elementCount);
 
-    void load(UT_JSONParser& parser);
+    void load(JSONParser& parser);
 
     friend std::ostream& operator << (std::ostream& co, const Attribute& attribute);
 
     int64 elementCount;
 
-    UT_String scope;
-    UT_String type;
-    UT_String name;
-    UT_String subtype;
+    std::string scope;
+    std::string type;
+    std::string name;
+    std::string subtype;
 
     std::vector<std::string> strings;
     NumericData data;
 
 private:
-    void parseData(UT_JSONParser& parser);
+    void parseData(JSONParser& parser);
 };
 
 } // namespace parser
@@ -14,7 +14,7 @@
 #include <cassert>
 #include <iostream>
 
-#include <UT/UT_String.h>
+#include "types.h"
 
 namespace ika
 {
@@ -7,11 +7,10 @@
  *  copied, modified, or distributed except according to those terms.
  */
 
-#include <UT/UT_JSONParser.h>
-#include <UT/UT_String.h>
-
 #include "Detail.h"
 
+#include <string>
+
 #include "Info.h"
 #include "Attribute.h"
 #include "PrimitiveGroup.h"
@@ -51,7 +50,7 @@ Detail::~Detail() {
     }
 }
 
-void Detail::loadHeaderAndInfo(UT_JSONParser& parser) {
+void Detail::loadHeaderAndInfo(JSONParser& parser) {
     parseBeginArray(parser); 
     {
         fileVersion.load(parser);
@@ -69,7 +68,7 @@ void Detail::loadHeaderAndInfo(UT_JSONParser& parser) {
     }
 }
 
-static void loadAttributes(UT_JSONParser& parser, std::vector<Attribute*>& attributes, int64 count) {
+static void loadAttributes(JSONParser& parser, std::vector<Attribute*>& attributes, int64 count) {
     for (auto it = parser.beginArray(); !it.atEnd(); ++it) {
         Attribute* attribute = new Attribute(count);
         attribute->load(parser);
@@ -77,18 +76,18 @@ static void loadAttributes(UT_JSONParser& parser, std::vector<Attribute*>& attri
     }
 }
 
-void Detail::loadGeometry(UT_JSONParser &parser) {
-    UT_WorkBuffer buffer;
-    UT_String key;
+void Detail::loadGeometry(JSONParser &parser) {
+    std::string buffer;
+    std::string key;
     for (auto geoit = parser.beginArray(); !geoit.atEnd(); ++geoit) {
         
         geoit.getLowerKey(buffer);        
-        key = buffer.buffer();
+        key = buffer;
         
         if (key == "fileversion") {
-            UT_WorkBuffer version;
+            std::string version;
             BGEO_CHECK(parser.parseString(version));
-            fileVersion.parse(version.buffer());
+            fileVersion.parse(version);
             if (checkVersion) {
                 FileVersion::checkVersion(fileVersion);
             }
@@ -114,7 +113,7 @@ void Detail::loadGeometry(UT_JSONParser &parser) {
         else if (key == "attributes") {
             for (auto attrit = parser.beginArray(); !attrit.atEnd(); ++attrit) {
                 attrit.getLowerKey(buffer);
-                key = buffer.buffer();
+                key = buffer;
                 if (key == "vertexattributes") {
                     loadAttributes(parser, vertexAttributes, vertexCount);
                 }
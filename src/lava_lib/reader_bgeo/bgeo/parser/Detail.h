@@ -12,20 +12,16 @@
 
 #include <memory>
 
-//#include <UT/UT_JSONParser.h>
-//#include <UT/UT_String.h>
-
 #include "VertexMap.h"
 #include "Primitives.h"
 #include "FileVersion.h"
 #include "types.h"
 
-class UT_JSONParser;
-
 namespace ika {
 namespace bgeo {
 namespace parser {
 
+class JSONParser;
 class Info;
 class Attribute;
 class PrimitiveGroup;
@@ -35,8 +31,8 @@ class Detail {
     Detail(bool checkVersion = true);
     ~Detail();
 
-    void loadHeaderAndInfo(UT_JSONParser& parser);
-    void loadGeometry(UT_JSONParser& parser);
+    void loadHeaderAndInfo(JSONParser& parser);
+    void loadGeometry(JSONParser& parser);
 
     std::shared_ptr<Info> info() const { return mpInfo; };
 
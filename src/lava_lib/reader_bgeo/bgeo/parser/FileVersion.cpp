@@ -10,9 +10,7 @@
 #include "FileVersion.h"
 
 #include <sstream>
-
-#include <UT/UT_JSONParser.h>
-#include <UT/UT_String.h>
+#include <string>
 
 #include "util.h"
 #include "VersionError.h"
@@ -59,21 +57,21 @@ std::ostream& operator << (std::ostream& co, const FileVersion& version) {
         version.major != 15 &&
         version.major != 16)
     {
-        UT_String message("Unsupported file version: ");
-        message += UT_String(version.toString());
+        std::string message("Unsupported file version: ");
+        message += version.toString();
         throw VersionError(message);
     }
 }
 
-void FileVersion::load(UT_JSONParser& parser) {
-    UT_String fileVersion;
+void FileVersion::load(JSONParser& parser) {
+    std::string fileVersion;
     parseArrayValueForKey(parser, "fileversion", fileVersion);
     parse(fileVersion);
 }
 
-void FileVersion::parse(UT_String version) {
+void FileVersion::parse(std::string version) {
     char period;
-    std::stringstream versionStream(std::string(version.c_str()));
+    std::stringstream versionStream(version);
     versionStream >> major >> period >> minor >> period >>
             micro >> period >> patch;
 }
@@ -14,14 +14,14 @@
 #undef minor
 
 #include <iostream>
-
-class UT_JSONParser;
-class UT_String;
+#include <string>
 
 namespace ika {
 namespace bgeo {
 namespace parser {
 
+class JSONParser;
+
 class FileVersion {
  public:
     FileVersion();
@@ -29,8 +29,8 @@ class FileVersion {
     std::string toString() const;
     friend std::ostream& operator << (std::ostream& co, const FileVersion& version);
 
-    void load(UT_JSONParser& parser);
-    void parse(UT_String version);
+    void load(JSONParser& parser);
+    void parse(std::string version);
 
     int major;
     int minor;
@@ -7,42 +7,39 @@
  *  copied, modified, or distributed except according to those terms.
  */
 
+#include <algorithm>
+#include <cctype>
 #include <iostream>
 
 #include "Info.h"
 
 #include "util.h"
 
-#include "UT/UT_JSONHandle.h"
-#include <UT/UT_JSONParser.h>
-
 namespace ika {
 namespace bgeo {
 namespace parser {
 
 Info::Info() { }
 
-void parseMapValue(UT_JSONParser& parser, UT_String& value)
+void parseMapValue(JSONParser& parser, std::string& value)
 {
-    UT_WorkBuffer buffer;
-    BGEO_CHECK(parser.parseString(buffer));
-    value.harden(buffer.buffer());
+    BGEO_CHECK(parser.parseString(value));
 }
 
 template <typename T>
-void parseMapValue(UT_JSONParser& parser, T* data, int64 len)
+void parseMapValue(JSONParser& parser, T* data, int64 len)
 {
     BGEO_CHECK(len == parser.parseUniformArray(data, len));
 }
 
-void Info::load(UT_JSONParser& parser)
+void Info::load(JSONParser& parser)
 {
-    UT_WorkBuffer buffer;
-    UT_String key;
+    std::string buffer;
+    std::string key;
     for (auto it = parser.beginMap(); !it.atEnd(); ++it)
     {
         it.getLowerKey(buffer);
-        key = buffer.buffer();
+        key = buffer;
 
         if (key == "software")
         {
@@ -101,6 +98,99 @@ void Info::load(UT_JSONParser& parser)
     }
 }
 
+void parseMapValue(JSONTokenizer& tokenizer, std::string& value)
+{
+    JSONTokenizer::Token token;
+    if (!tokenizer.next(token) || token.type != JSONTokenizer::StringToken)
+    {
+        throw JSONTokenizer::Error("Expected string info value");
+    }
+    value = token.stringValue;
+}
+
+void Info::load(JSONTokenizer& tokenizer, const JSONTokenizer::Token& mapToken)
+{
+    if (mapToken.type != JSONTokenizer::BeginMapToken)
+    {
+        throw JSONTokenizer::Error("Expected info map");
+    }
+
+    JSONTokenizer::Token token;
+    while (tokenizer.next(token) && token.type != JSONTokenizer::EndMapToken)
+    {
+        if (token.type != JSONTokenizer::StringToken)
+        {
+            throw JSONTokenizer::Error("Expected info map key");
+        }
+
+        std::string key = token.stringValue;
+        std::transform(key.begin(), key.end(), key.begin(),
+                       [](unsigned char c) { return std::tolower(c); });
+
+        if (key == "software")
+        {
+            parseMapValue(tokenizer, software);
+        }
+        else if (key == "date")
+        {
+            parseMapValue(tokenizer, date);
+        }
+        else if (key == "hostname")
+        {
+            parseMapValue(tokenizer, hostname);
+        }
+        else if (key == "artist")
+        {
+            parseMapValue(tokenizer, artist);
+        }
+        else if (key == "bounds")
+        {
+            std::vector<double> values;
+            tokenizer.next(token);
+            tokenizer.readNumberArray(token, values);
+            if (values.size() != 6)
+            {
+                throw JSONTokenizer::Error("Expected 6 info bounds values");
+            }
+            std::copy(values.begin(), values.end(), bounds);
+        }
+        else if (key == "primcount_summary")
+        {
+            parseMapValue(tokenizer, primcountSummary);
+        }
+        else if (key == "attribute_summary")
+        {
+            parseMapValue(tokenizer, attributeSummary);
+        }
+        else if (key == "volume_summary")
+        {
+            parseMapValue(tokenizer, volumeSummary);
+        }
+        else if (key == "group_summary")
+        {
+            parseMapValue(tokenizer, groupSummary);
+        }
+        else if (key == "attribute_ranges")
+        {
+            parseMapValue(tokenizer, attributeRanges);
+        }
+        else
+        {
+            if (key != "time" && key != "timetocook")
+            {
+                std::cerr << "Warning: Unknown info member: " << key << std::endl;
+            }
+            tokenizer.next(token);
+            tokenizer.skipValue(token);
+        }
+    }
+
+    if (token.type != JSONTokenizer::EndMapToken)
+    {
+        throw JSONTokenizer::Error("Unexpected end of info map");
+    }
+}
+
 std::ostream& operator << (std::ostream& co, const Info& info)
 {
     co << "software  = " << info.software << "\n"
@@ -10,30 +10,35 @@
 #ifndef BGEO_PARSER_INFO_H
 #define BGEO_PARSER_INFO_H
 
-#include <UT/UT_String.h>
+#include <string>
 
-class UT_JSONParser;
+#include "JSONTokenizer.h"
 
 namespace ika {
 namespace bgeo {
 namespace parser {
 
+class JSONParser;
+
 class Info {
  public:
     Info();
 
-    void load(UT_JSONParser& parser);
+    void load(JSONParser& parser);
+
+    // load info map starting with mapToken straight from the tokenizer
+    void load(JSONTokenizer& tokenizer, const JSONTokenizer::Token& mapToken);
 
-    UT_String software;
-    UT_String date;
-    UT_String hostname;
-    UT_String artist;
+    std::string software;
+    std::string date;
+    std::string hostname;
+    std::string artist;
     double bounds[6];
-    UT_String primcountSummary;
-    UT_String attributeSummary;
-    UT_String volumeSummary;
-    UT_String groupSummary;
-    UT_String attributeRanges;
+    std::string primcountSummary;
+    std::string attributeSummary;
+    std::string volumeSummary;
+    std::string groupSummary;
+    std::string attributeRanges;
 
     friend std::ostream& operator << (std::ostream& co, const Info& info);
 };
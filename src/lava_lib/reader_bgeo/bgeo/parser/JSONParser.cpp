@@ -0,0 +1,754 @@
+/*
+ *  Copyright 2018 Laika, LLC. Authored by Peter Stuart
+ *
+ *  Licensed under the Apache License, Version 2.0, <LICENSE-APACHE or
+ *  http://apache.org/licenses/LICENSE-2.0> or the MIT license <LICENSE-MIT or
+ *  http://opensource.org/licenses/MIT>, at your option. This file may not be
+ *  copied, modified, or distributed except according to those terms.
+ */
+
+#include "JSONParser.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <memory>
+
+namespace ika {
+namespace bgeo {
+namespace parser {
+
+namespace {
+
+std::string unexpected(const char* what, int64 position)
+{
+    char message[128];
+    std::snprintf(message, sizeof(message), "Unexpected JSON %s at byte 0x%08llx",
+                  what, static_cast<unsigned long long>(position));
+    return message;
+}
+
+bool isRealElement(JSONTokenizer::ElementType type)
+{
+    return type == JSONTokenizer::Real16Element ||
+           type == JSONTokenizer::Real32Element ||
+           type == JSONTokenizer::Real64Element;
+}
+
+} // namespace
+
+bool JSONHandle::jsonNull(JSONParser& parser)
+{
+    parser.addError(unexpected("null", parser.getStreamPosition()));
+    return false;
+}
+
+bool JSONHandle::jsonBool(JSONParser& parser, bool /*value*/)
+{
+    parser.addError(unexpected("bool", parser.getStreamPosition()));
+    return false;
+}
+
+bool JSONHandle::jsonInt(JSONParser& parser, int64 /*value*/)
+{
+    parser.addError(unexpected("integer", parser.getStreamPosition()));
+    return false;
+}
+
+bool JSONHandle::jsonReal(JSONParser& parser, fpreal64 /*value*/)
+{
+    parser.addError(unexpected("real", parser.getStreamPosition()));
+    return false;
+}
+
+bool JSONHandle::jsonString(JSONParser& parser, const char* /*value*/, int64 /*length*/)
+{
+    parser.addError(unexpected("string", parser.getStreamPosition()));
+    return false;
+}
+
+bool JSONHandle::jsonKey(JSONParser& parser, const char* /*key*/, int64 /*length*/)
+{
+    parser.addError(unexpected("map key", parser.getStreamPosition()));
+    return false;
+}
+
+bool JSONHandle::jsonBeginMap(JSONParser& parser)
+{
+    parser.addError(unexpected("map", parser.getStreamPosition()));
+    return false;
+}
+
+bool JSONHandle::jsonEndMap(JSONParser& parser)
+{
+    parser.addError(unexpected("map end", parser.getStreamPosition()));
+    return false;
+}
+
+bool JSONHandle::jsonBeginArray(JSONParser& parser)
+{
+    parser.addError(unexpected("array", parser.getStreamPosition()));
+    return false;
+}
+
+bool JSONHandle::jsonEndArray(JSONParser& parser)
+{
+    parser.addError(unexpected("array end", parser.getStreamPosition()));
+    return false;
+}
+
+JSONParser::iterator::iterator()
+    : m_parser(nullptr)
+    , m_map(false)
+    , m_atEnd(true)
+{
+}
+
+JSONParser::iterator::iterator(JSONParser* parser, bool map)
+    : m_parser(parser)
+    , m_map(map)
+    , m_atEnd(false)
+{
+}
+
+bool JSONParser::iterator::atEnd()
+{
+    if (m_atEnd)
+    {
+        return true;
+    }
+
+    const Token& token = m_parser->peek();
+    if (token.type == (m_map ? JSONTokenizer::EndMapToken : JSONTokenizer::EndArrayToken))
+    {
+        m_parser->consume();
+        m_atEnd = true;
+    }
+    else if (token.type == JSONTokenizer::EndToken)
+    {
+        m_parser->addError(unexpected("end of data", m_parser->getStreamPosition()));
+        m_atEnd = true;
+    }
+    return m_atEnd;
+}
+
+bool JSONParser::iterator::getKey(std::string& key)
+{
+    return m_parser && m_parser->parseString(key);
+}
+
+bool JSONParser::iterator::getLowerKey(std::string& key)
+{
+    if (!getKey(key))
+    {
+        return false;
+    }
+    std::transform(key.begin(), key.end(), key.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return true;
+}
+
+JSONParser::JSONParser(const char* data, size_t size)
+    : m_tokenizer(data, size)
+    , m_peeked(false)
+    , m_failed(false)
+    , m_inUniformArray(false)
+    , m_uniformType(JSONTokenizer::IntToken)
+    , m_uniformIndex(0)
+    , m_tokenCount(0)
+{
+}
+
+const JSONParser::Token& JSONParser::peek()
+{
+    if (m_peeked)
+    {
+        return m_peekedToken;
+    }
+
+    if (m_inUniformArray)
+    {
+        size_t size = m_uniformType == JSONTokenizer::RealToken ?
+                      m_uniformReals.size() : m_uniformInts.size();
+        if (m_uniformIndex < size)
+        {
+            m_peekedToken.type = m_uniformType;
+            if (m_uniformType == JSONTokenizer::RealToken)
+            {
+                m_peekedToken.realValue = m_uniformReals[m_uniformIndex];
+            }
+            else
+            {
+                m_peekedToken.intValue = m_uniformInts[m_uniformIndex];
+                m_peekedToken.boolValue = m_peekedToken.intValue != 0;
+            }
+        }
+        else
+        {
+            m_peekedToken.type = JSONTokenizer::EndArrayToken;
+        }
+    }
+    else if (m_failed)
+    {
+        m_peekedToken.type = JSONTokenizer::EndToken;
+    }
+    else
+    {
+        try
+        {
+            m_tokenizer.next(m_peekedToken);
+        }
+        catch (const JSONTokenizer::Error& error)
+        {
+            addError(error.what());
+            m_failed = true;
+            m_peekedToken.type = JSONTokenizer::EndToken;
+        }
+    }
+
+    m_peeked = true;
+    return m_peekedToken;
+}
+
+void JSONParser::consume()
+{
+    if (m_inUniformArray)
+    {
+        if (m_peekedToken.type == JSONTokenizer::EndArrayToken)
+        {
+            m_inUniformArray = false;
+        }
+        ++m_uniformIndex;
+    }
+    m_peeked = false;
+    ++m_tokenCount;
+}
+
+bool JSONParser::readUniform(const Token& token, std::vector<int64_t>& ints,
+                             std::vector<double>& reals, JSONTokenizer::TokenType& type)
+{
+    try
+    {
+        if (isRealElement(token.elementType))
+        {
+            type = JSONTokenizer::RealToken;
+            reals.resize(static_cast<size_t>(token.length));
+            m_tokenizer.readUniformArray(token, reals.data());
+        }
+        else
+        {
+            type = token.elementType == JSONTokenizer::BoolElement ?
+                   JSONTokenizer::BoolToken : JSONTokenizer::IntToken;
+            ints.resize(static_cast<size_t>(token.length));
+            m_tokenizer.readUniformArray(token, ints.data());
+        }
+    }
+    catch (const JSONTokenizer::Error& error)
+    {
+        addError(error.what());
+        m_failed = true;
+        return false;
+    }
+    return true;
+}
+
+bool JSONParser::openArray()
+{
+    const Token& token = peek();
+    if (token.type == JSONTokenizer::BeginArrayToken)
+    {
+        consume();
+        return true;
+    }
+    if (token.type != JSONTokenizer::UniformArrayToken)
+    {
+        return false;
+    }
+
+    // the tokenizer is left right before the elements, read them all
+    Token uniform = token;
+    consume();
+    if (!readUniform(uniform, m_uniformInts, m_uniformReals, m_uniformType))
+    {
+        return false;
+    }
+    m_inUniformArray = true;
+    m_uniformIndex = 0;
+    return true;
+}
+
+JSONParser::iterator JSONParser::beginArray()
+{
+    if (!openArray())
+    {
+        addError(unexpected("value, expecting '['", getStreamPosition()));
+        return iterator();
+    }
+    return iterator(this, false);
+}
+
+JSONParser::iterator JSONParser::beginMap()
+{
+    if (peek().type != JSONTokenizer::BeginMapToken)
+    {
+        addError(unexpected("value, expecting '{'", getStreamPosition()));
+        return iterator();
+    }
+    consume();
+    return iterator(this, true);
+}
+
+bool JSONParser::parseBeginArray(bool& error)
+{
+    if (openArray())
+    {
+        return true;
+    }
+    error = m_failed;
+    return false;
+}
+
+bool JSONParser::parseEndArray(bool& error)
+{
+    JSONTokenizer::TokenType type = peek().type;
+    if (type == JSONTokenizer::EndArrayToken)
+    {
+        consume();
+        return true;
+    }
+    if (type == JSONTokenizer::EndToken || !skipNextObject())
+    {
+        error = true;
+    }
+    return false;
+}
+
+bool JSONParser::parseBeginMap(bool& error)
+{
+    JSONTokenizer::TokenType type = peek().type;
+    if (type == JSONTokenizer::BeginMapToken)
+    {
+        consume();
+        return true;
+    }
+    error = m_failed;
+    return false;
+}
+
+bool JSONParser::parseEndMap(bool& error)
+{
+    JSONTokenizer::TokenType type = peek().type;
+    if (type == JSONTokenizer::EndMapToken)
+    {
+        consume();
+        return true;
+    }
+    if (type == JSONTokenizer::EndToken || !skipNextObject())
+    {
+        error = true;
+    }
+    return false;
+}
+
+bool JSONParser::parseKey(std::string& key)
+{
+    return parseString(key);
+}
+
+bool JSONParser::parseString(std::string& value)
+{
+    const Token& token = peek();
+    if (token.type != JSONTokenizer::StringToken)
+    {
+        addError(unexpected("value, expecting a string", getStreamPosition()));
+        return false;
+    }
+    value = token.stringValue;
+    consume();
+    return true;
+}
+
+bool JSONParser::parseValue(std::string& value)
+{
+    return parseString(value);
+}
+
+bool JSONParser::parseValue(bool& value)
+{
+    const Token& token = peek();
+    if (token.type == JSONTokenizer::BoolToken)
+    {
+        value = token.boolValue;
+    }
+    else if (token.type == JSONTokenizer::IntToken)
+    {
+        value = token.intValue != 0;
+    }
+    else
+    {
+        addError(unexpected("value, expecting a bool", getStreamPosition()));
+        return false;
+    }
+    consume();
+    return true;
+}
+
+bool JSONParser::parseValue(int32& value)
+{
+    int64 value64;
+    if (!parseValue(value64))
+    {
+        return false;
+    }
+    value = static_cast<int32>(value64);
+    return true;
+}
+
+bool JSONParser::parseValue(int64& value)
+{
+    const Token& token = peek();
+    if (token.type == JSONTokenizer::IntToken || token.type == JSONTokenizer::BoolToken)
+    {
+        value = token.intValue;
+        if (token.type == JSONTokenizer::BoolToken)
+        {
+            value = token.boolValue ? 1 : 0;
+        }
+    }
+    else if (token.type == JSONTokenizer::RealToken)
+    {
+        value = static_cast<int64>(token.realValue);
+    }
+    else
+    {
+        addError(unexpected("value, expecting an integer", getStreamPosition()));
+        return false;
+    }
+    consume();
+    return true;
+}
+
+bool JSONParser::parseValue(fpreal32& value)
+{
+    fpreal64 value64;
+    if (!parseValue(value64))
+    {
+        return false;
+    }
+    value = static_cast<fpreal32>(value64);
+    return true;
+}
+
+bool JSONParser::parseValue(fpreal64& value)
+{
+    const Token& token = peek();
+    if (!token.isNumber())
+    {
+        addError(unexpected("value, expecting a number", getStreamPosition()));
+        return false;
+    }
+    value = token.numberValue();
+    consume();
+    return true;
+}
+
+template <typename T>
+int64 JSONParser::parseUniformArray(T* data, int64 len)
+{
+    const Token& token = peek();
+    if (token.type == JSONTokenizer::UniformArrayToken)
+    {
+        Token uniform = token;
+        consume();
+        try
+        {
+            if (uniform.length <= len)
+            {
+                m_tokenizer.readUniformArray(uniform, data);
+            }
+            else
+            {
+                std::unique_ptr<T[]> values(new T[uniform.length]);
+                m_tokenizer.readUniformArray(uniform, values.get());
+                std::copy_n(values.get(), len, data);
+            }
+        }
+        catch (const JSONTokenizer::Error& error)
+        {
+            addError(error.what());
+            m_failed = true;
+            return 0;
+        }
+        return uniform.length;
+    }
+
+    if (token.type != JSONTokenizer::BeginArrayToken)
+    {
+        addError(unexpected("value, expecting a number array", getStreamPosition()));
+        return 0;
+    }
+    consume();
+
+    int64 count = 0;
+    for (;;)
+    {
+        const Token& element = peek();
+        if (element.type == JSONTokenizer::EndArrayToken)
+        {
+            consume();
+            return count;
+        }
+        if (!element.isNumber() && element.type != JSONTokenizer::BoolToken)
+        {
+            addError(unexpected("value in number array", getStreamPosition()));
+            return 0;
+        }
+        if (count < len)
+        {
+            data[count] = element.type == JSONTokenizer::BoolToken ?
+                          static_cast<T>(element.boolValue) :
+                          element.type == JSONTokenizer::IntToken ?
+                          static_cast<T>(element.intValue) :
+                          static_cast<T>(element.realValue);
+        }
+        ++count;
+        consume();
+    }
+}
+
+template <typename T>
+int64 JSONParser::parseArrayValues(iterator& /*it*/, T* data, int64 len)
+{
+    int64 count = 0;
+
+    // elements of an expanded uniform array are copied in bulk, a peeked
+    // element is still at m_uniformIndex
+    if (m_inUniformArray)
+    {
+        m_peeked = false;
+        if (m_uniformType == JSONTokenizer::RealToken)
+        {
+            count = std::min<int64>(len, m_uniformReals.size() - m_uniformIndex);
+            std::copy_n(m_uniformReals.begin() + m_uniformIndex, count, data);
+        }
+        else
+        {
+            count = std::min<int64>(len, m_uniformInts.size() - m_uniformIndex);
+            std::copy_n(m_uniformInts.begin() + m_uniformIndex, count, data);
+        }
+        m_uniformIndex += count;
+        m_tokenCount += count;
+        return count;
+    }
+
+    while (count < len)
+    {
+        const Token& element = peek();
+        if (element.type == JSONTokenizer::BoolToken)
+        {
+            data[count] = static_cast<T>(element.boolValue);
+        }
+        else if (element.type == JSONTokenizer::IntToken)
+        {
+            data[count] = static_cast<T>(element.intValue);
+        }
+        else if (element.type == JSONTokenizer::RealToken)
+        {
+            data[count] = static_cast<T>(element.realValue);
+        }
+        else
+        {
+            // the iterator handles the end of the array
+            break;
+        }
+        ++count;
+        consume();
+    }
+    return count;
+}
+
+bool JSONParser::skipNextObject()
+{
+    Token token = peek();
+    switch (token.type)
+    {
+    case JSONTokenizer::EndToken:
+    case JSONTokenizer::EndArrayToken:
+    case JSONTokenizer::EndMapToken:
+        addError(unexpected("end of value", getStreamPosition()));
+        return false;
+    default:
+        break;
+    }
+    consume();
+
+    if (m_inUniformArray)
+    {
+        // scalar element
+        return true;
+    }
+
+    try
+    {
+        m_tokenizer.skipValue(token);
+    }
+    catch (const JSONTokenizer::Error& error)
+    {
+        addError(error.what());
+        m_failed = true;
+        return false;
+    }
+    return true;
+}
+
+bool JSONParser::parseObject(JSONHandle& handle)
+{
+    Token token = peek();
+    consume();
+    return parseObject(handle, token);
+}
+
+bool JSONParser::parseObject(JSONHandle& handle, const Token& token)
+{
+    size_t errorCount = m_errors.size();
+    bool ok = true;
+
+    switch (token.type)
+    {
+    case JSONTokenizer::NullToken:
+        ok = handle.jsonNull(*this);
+        break;
+    case JSONTokenizer::BoolToken:
+        ok = handle.jsonBool(*this, token.boolValue);
+        break;
+    case JSONTokenizer::IntToken:
+        ok = handle.jsonInt(*this, token.intValue);
+        break;
+    case JSONTokenizer::RealToken:
+        ok = handle.jsonReal(*this, token.realValue);
+        break;
+    case JSONTokenizer::StringToken:
+        ok = handle.jsonString(*this, token.stringValue.c_str(), token.stringValue.size());
+        break;
+
+    case JSONTokenizer::BeginMapToken:
+        ok = handle.jsonBeginMap(*this);
+        while (ok)
+        {
+            const Token& key = peek();
+            if (key.type == JSONTokenizer::EndMapToken)
+            {
+                consume();
+                ok = handle.jsonEndMap(*this);
+                break;
+            }
+            if (key.type != JSONTokenizer::StringToken)
+            {
+                addError(unexpected("value, expecting a map key", getStreamPosition()));
+                return false;
+            }
+            std::string name = key.stringValue;
+            consume();
+
+            // the handle may have parsed the value itself
+            int64 tokenCount = m_tokenCount;
+            ok = handle.jsonKey(*this, name.c_str(), name.size());
+            if (ok && tokenCount == m_tokenCount)
+            {
+                ok = parseObject(handle);
+            }
+        }
+        break;
+
+    case JSONTokenizer::BeginArrayToken:
+        ok = handle.jsonBeginArray(*this);
+        while (ok)
+        {
+            const Token& element = peek();
+            if (element.type == JSONTokenizer::EndArrayToken)
+            {
+                consume();
+                ok = handle.jsonEndArray(*this);
+                break;
+            }
+            if (element.type == JSONTokenizer::EndToken)
+            {
+                addError(unexpected("end of data", getStreamPosition()));
+                return false;
+            }
+            ok = parseObject(handle);
+        }
+        break;
+
+    case JSONTokenizer::UniformArrayToken:
+    {
+        std::vector<int64_t> ints;
+        std::vector<double> reals;
+        JSONTokenizer::TokenType type;
+        if (!readUniform(token, ints, reals, type))
+        {
+            return false;
+        }
+
+        ok = handle.jsonBeginArray(*this);
+        if (type == JSONTokenizer::RealToken)
+        {
+            for (size_t i = 0; ok && i < reals.size(); ++i)
+            {
+                ok = handle.jsonReal(*this, reals[i]);
+            }
+        }
+        else if (type == JSONTokenizer::BoolToken)
+        {
+            for (size_t i = 0; ok && i < ints.size(); ++i)
+            {
+                ok = handle.jsonBool(*this, ints[i] != 0);
+            }
+        }
+        else
+        {
+            for (size_t i = 0; ok && i < ints.size(); ++i)
+            {
+                ok = handle.jsonInt(*this, ints[i]);
+            }
+        }
+        ok = ok && handle.jsonEndArray(*this);
+        break;
+    }
+
+    default:
+        addError(unexpected("end of value", getStreamPosition()));
+        return false;
+    }
+
+    if (!ok && m_errors.size() == errorCount)
+    {
+        addError(unexpected("value", getStreamPosition()));
+    }
+    return ok;
+}
+
+int64 JSONParser::getStreamPosition() const
+{
+    return static_cast<int64>(m_tokenizer.getPosition());
+}
+
+void JSONParser::addError(const std::string& message)
+{
+    m_errors.push_back(message);
+}
+
+template int64 JSONParser::parseUniformArray<bool>(bool*, int64);
+template int64 JSONParser::parseUniformArray<int32>(int32*, int64);
+template int64 JSONParser::parseUniformArray<int64>(int64*, int64);
+template int64 JSONParser::parseUniformArray<fpreal32>(fpreal32*, int64);
+template int64 JSONParser::parseUniformArray<fpreal64>(fpreal64*, int64);
+
+template int64 JSONParser::parseArrayValues<int32>(iterator&, int32*, int64);
+template int64 JSONParser::parseArrayValues<int64>(iterator&, int64*, int64);
+template int64 JSONParser::parseArrayValues<fpreal32>(iterator&, fpreal32*, int64);
+template int64 JSONParser::parseArrayValues<fpreal64>(iterator&, fpreal64*, int64);
+
+} // namespace parser
+} // namespace bgeo
+} // namespace ika
@@ -0,0 +1,160 @@
+/*
+ *  Copyright 2018 Laika, LLC. Authored by Peter Stuart
+ *
+ *  Licensed under the Apache License, Version 2.0, <LICENSE-APACHE or
+ *  http://apache.org/licenses/LICENSE-2.0> or the MIT license <LICENSE-MIT or
+ *  http://opensource.org/licenses/MIT>, at your option. This file may not be
+ *  copied, modified, or distributed except according to those terms.
+ */
+
+#ifndef BGEO_PARSER_JSON_PARSER_H
+#define BGEO_PARSER_JSON_PARSER_H
+
+#include <string>
+#include <vector>
+
+#include "JSONTokenizer.h"
+#include "types.h"
+
+namespace ika
+{
+namespace bgeo
+{
+namespace parser
+{
+
+class JSONParser;
+
+// Callbacks for JSONParser::parseObject(). The defaults reject the value,
+// which fails the parse. jsonKey() may parse the map value itself, if it
+// doesn't the value is passed on to this handle.
+class JSONHandle
+{
+public:
+    virtual ~JSONHandle() = default;
+
+    virtual bool jsonNull(JSONParser& parser);
+    virtual bool jsonBool(JSONParser& parser, bool value);
+    virtual bool jsonInt(JSONParser& parser, int64 value);
+    virtual bool jsonReal(JSONParser& parser, fpreal64 value);
+    virtual bool jsonString(JSONParser& parser, const char* value, int64 length);
+    virtual bool jsonKey(JSONParser& parser, const char* key, int64 length);
+    virtual bool jsonBeginMap(JSONParser& parser);
+    virtual bool jsonEndMap(JSONParser& parser);
+    virtual bool jsonBeginArray(JSONParser& parser);
+    virtual bool jsonEndArray(JSONParser& parser);
+};
+
+// Houdini geometry JSON parser on top of JSONTokenizer. Mirrors the subset of
+// UT_JSONParser the loaders use. Binary uniform arrays read like regular
+// arrays, parseUniformArray() and parseArrayValues() copy them in bulk.
+// Failures return false and are recorded in getErrors().
+class JSONParser
+{
+public:
+    JSONParser(const char* data, size_t size);
+
+    // Iterates the values of an array or the keys of a map. Values have to
+    // be parsed by the caller on every step.
+    class iterator
+    {
+    public:
+        iterator();
+
+        iterator& operator ++ () { return *this; }
+
+        // Consumes the closing bracket once the array or map is done.
+        bool atEnd();
+
+        // Map key, or string value of an array of key value pairs.
+        bool getKey(std::string& key);
+        bool getLowerKey(std::string& key);
+
+    private:
+        friend class JSONParser;
+        iterator(JSONParser* parser, bool map);
+
+        JSONParser* m_parser;
+        bool m_map;
+        bool m_atEnd;
+    };
+
+    iterator beginArray();
+    iterator beginMap();
+
+    // The next token is consumed, a nested value is skipped entirely.
+    // error is set when the stream can't be read.
+    bool parseBeginArray(bool& error);
+    bool parseEndArray(bool& error);
+    bool parseBeginMap(bool& error);
+    bool parseEndMap(bool& error);
+
+    bool parseKey(std::string& key);
+    bool parseString(std::string& value);
+
+    bool parseValue(std::string& value);
+    bool parseValue(bool& value);
+    bool parseValue(int32& value);
+    bool parseValue(int64& value);
+    bool parseValue(fpreal32& value);
+    bool parseValue(fpreal64& value);
+
+    bool parseInt(int64& value) { return parseValue(value); }
+    bool parseBool(bool& value) { return parseValue(value); }
+
+    // Read an array of numbers, uniform or not, into data. Returns the
+    // number of array elements, only the first len of them are stored.
+    // Returns 0 if the value isn't a number array.
+    template <typename T>
+    int64 parseUniformArray(T* data, int64 len);
+
+    // Read up to len values of the array iterated by it.
+    template <typename T>
+    int64 parseArrayValues(iterator& it, T* data, int64 len);
+
+    bool skipNextObject();
+    bool parseObject(JSONHandle& handle);
+
+    int64 getStreamPosition() const;
+
+    void addError(const std::string& message);
+    const std::vector<std::string>& getErrors() const { return m_errors; }
+
+private:
+    typedef JSONTokenizer::Token Token;
+
+    // Next token, elements of an opened uniform array are served one by
+    // one. Returns EndToken once the data is exhausted or unreadable.
+    const Token& peek();
+    void consume();
+
+    // Open an array value, uniform arrays are read in elements.
+    bool openArray();
+    bool readUniform(const Token& token, std::vector<int64_t>& ints,
+                     std::vector<double>& reals, JSONTokenizer::TokenType& type);
+    bool parseObject(JSONHandle& handle, const Token& token);
+
+    JSONTokenizer m_tokenizer;
+
+    Token m_peekedToken;
+    bool m_peeked;
+    bool m_failed;
+
+    // elements of the uniform array being iterated
+    bool m_inUniformArray;
+    JSONTokenizer::TokenType m_uniformType;
+    std::vector<int64_t> m_uniformInts;
+    std::vector<double> m_uniformReals;
+    size_t m_uniformIndex;
+
+    // counts consumed tokens, tells if a handle parsed a map value
+    int64 m_tokenCount;
+
+    std::vector<std::string> m_errors;
+};
+
+} // namespace parser
+} // namespace bgeo
+} // namespace ika
+
+#endif // BGEO_PARSER_JSON_PARSER_H
@@ -0,0 +1,559 @@
+/*
+ *  Copyright 2018 Laika, LLC. Authored by Peter Stuart
+ *
+ *  Licensed under the Apache License, Version 2.0, <LICENSE-APACHE or
+ *  http://apache.org/licenses/LICENSE-2.0> or the MIT license <LICENSE-MIT or
+ *  http://opensource.org/licenses/MIT>, at your option. This file may not be
+ *  copied, modified, or distributed except according to those terms.
+ */
+
+#include "JSONTokenizer.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace ika {
+namespace bgeo {
+namespace parser {
+
+namespace {
+
+// Houdini binary JSON token ids
+enum BinaryId : uint8_t
+{
+    JID_NULL = 0x00,
+    JID_MAP_BEGIN = 0x7b,
+    JID_MAP_END = 0x7d,
+    JID_ARRAY_BEGIN = 0x5b,
+    JID_ARRAY_END = 0x5d,
+    JID_BOOL = 0x10,
+    JID_INT8 = 0x11,
+    JID_INT16 = 0x12,
+    JID_INT32 = 0x13,
+    JID_INT64 = 0x14,
+    JID_REAL16 = 0x18,
+    JID_REAL32 = 0x19,
+    JID_REAL64 = 0x1a,
+    JID_UINT8 = 0x21,
+    JID_UINT16 = 0x22,
+    JID_STRING = 0x27,
+    JID_FALSE = 0x30,
+    JID_TRUE = 0x31,
+    JID_TOKENDEF = 0x2b,
+    JID_TOKENREF = 0x26,
+    JID_TOKENUNDEF = 0x2d,
+    JID_UNIFORM_ARRAY = 0x40,
+    JID_KEY_SEPARATOR = 0x3a,
+    JID_VALUE_SEPARATOR = 0x2c,
+    JID_MAGIC = 0x7f
+};
+
+const uint32_t BINARY_MAGIC = 0x624a534e;
+
+float halfToFloat(uint16_t half) {
+    uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1f;
+    uint32_t mantissa = half & 0x3ff;
+
+    uint32_t bits;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            // denormal, renormalize it
+            exponent = 127 - 15 + 1;
+            while ((mantissa & 0x400) == 0) {
+                mantissa <<= 1;
+                --exponent;
+            }
+            mantissa &= 0x3ff;
+            bits = sign | (exponent << 23) | (mantissa << 13);
+        }
+    } else if (exponent == 0x1f) {
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+bool isAsciiSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool isAsciiDelimiter(char c) {
+    return isAsciiSpace(c) || c == ',' || c == ':' || c == '[' || c == ']' ||
+           c == '{' || c == '}' || c == '"';
+}
+
+} // anonymous namespace
+
+JSONTokenizer::JSONTokenizer(const char* data, size_t size)
+    : m_data(data),
+      m_size(size),
+      m_position(0),
+      m_binary(false),
+      m_pendingBytes(0)
+{
+    if (m_size >= 5 && static_cast<uint8_t>(m_data[0]) == JID_MAGIC) {
+        uint32_t magic;
+        std::memcpy(&magic, m_data + 1, sizeof(magic));
+        if (magic != BINARY_MAGIC) {
+            throw Error("Invalid binary JSON magic number");
+        }
+        m_binary = true;
+        m_position = 5;
+    }
+}
+
+template <typename T>
+T JSONTokenizer::read() {
+    if (m_position + sizeof(T) > m_size) {
+        throw Error("Unexpected end of JSON data");
+    }
+    T value;
+    std::memcpy(&value, m_data + m_position, sizeof(T));
+    m_position += sizeof(T);
+    return value;
+}
+
+int64_t JSONTokenizer::readLength() {
+    uint8_t size = read<uint8_t>();
+    if (size < 0xf1) {
+        return size;
+    }
+
+    switch (size) {
+    case 0xf2:
+        return read<uint16_t>();
+    case 0xf4:
+        return read<uint32_t>();
+    case 0xf8:
+        return read<int64_t>();
+    default:
+        throw Error("Invalid binary JSON length encoding");
+    }
+}
+
+std::string JSONTokenizer::readBinaryString(int64_t length) {
+    if (length < 0 || m_position + static_cast<size_t>(length) > m_size) {
+        throw Error("Unexpected end of JSON data reading string");
+    }
+    std::string value(m_data + m_position, static_cast<size_t>(length));
+    m_position += static_cast<size_t>(length);
+    return value;
+}
+
+/*static*/ size_t JSONTokenizer::elementSize(ElementType type) {
+    switch (type) {
+    case Int8Element:
+    case UInt8Element:
+        return 1;
+    case Int16Element:
+    case UInt16Element:
+    case Real16Element:
+        return 2;
+    case Int32Element:
+    case Real32Element:
+        return 4;
+    case Int64Element:
+    case Real64Element:
+        return 8;
+    case BoolElement:
+        break;
+    }
+    return 0;
+}
+
+void JSONTokenizer::skipPendingElements() {
+    m_position += m_pendingBytes;
+    m_pendingBytes = 0;
+}
+
+bool JSONTokenizer::next(Token& token) {
+    skipPendingElements();
+
+    token.stringValue.clear();
+    token.length = 0;
+
+    bool found = m_binary ? nextBinary(token) : nextAscii(token);
+    if (!found) {
+        token.type = EndToken;
+    }
+    return found;
+}
+
+bool JSONTokenizer::nextBinary(Token& token) {
+    while (m_position < m_size) {
+        uint8_t id = read<uint8_t>();
+
+        switch (id) {
+        case JID_TOKENDEF: {
+            int64_t stringId = readLength();
+            m_strings[stringId] = readBinaryString(readLength());
+            break;
+        }
+        case JID_TOKENUNDEF:
+            m_strings.erase(readLength());
+            break;
+        case JID_KEY_SEPARATOR:
+        case JID_VALUE_SEPARATOR:
+            break;
+        case JID_NULL:
+            token.type = NullToken;
+            return true;
+        case JID_MAP_BEGIN:
+            token.type = BeginMapToken;
+            return true;
+        case JID_MAP_END:
+            token.type = EndMapToken;
+            return true;
+        case JID_ARRAY_BEGIN:
+            token.type = BeginArrayToken;
+            return true;
+        case JID_ARRAY_END:
+            token.type = EndArrayToken;
+            return true;
+        case JID_TRUE:
+        case JID_FALSE:
+            token.type = BoolToken;
+            token.boolValue = id == JID_TRUE;
+            return true;
+        case JID_BOOL:
+            token.type = BoolToken;
+            token.boolValue = read<int8_t>() != 0;
+            return true;
+        case JID_INT8:
+            token.type = IntToken;
+            token.intValue = read<int8_t>();
+            return true;
+        case JID_INT16:
+            token.type = IntToken;
+            token.intValue = read<int16_t>();
+            return true;
+        case JID_INT32:
+            token.type = IntToken;
+            token.intValue = read<int32_t>();
+            return true;
+        case JID_INT64:
+            token.type = IntToken;
+            token.intValue = read<int64_t>();
+            return true;
+        case JID_UINT8:
+            token.type = IntToken;
+            token.intValue = read<uint8_t>();
+            return true;
+        case JID_UINT16:
+            token.type = IntToken;
+            token.intValue = read<uint16_t>();
+            return true;
+        case JID_REAL16:
+            token.type = RealToken;
+            token.realValue = halfToFloat(read<uint16_t>());
+            return true;
+        case JID_REAL32:
+            token.type = RealToken;
+            token.realValue = read<float>();
+            return true;
+        case JID_REAL64:
+            token.type = RealToken;
+            token.realValue = read<double>();
+            return true;
+        case JID_STRING:
+            token.type = StringToken;
+            token.stringValue = readBinaryString(readLength());
+            return true;
+        case JID_TOKENREF: {
+            auto it = m_strings.find(readLength());
+            if (it == m_strings.end()) {
+                throw Error("Undefined binary JSON string reference");
+            }
+            token.type = StringToken;
+            token.stringValue = it->second;
+            return true;
+        }
+        case JID_UNIFORM_ARRAY: {
+            uint8_t elementId = read<uint8_t>();
+            switch (elementId) {
+            case JID_BOOL: token.elementType = BoolElement; break;
+            case JID_INT8: token.elementType = Int8Element; break;
+            case JID_INT16: token.elementType = Int16Element; break;
+            case JID_INT32: token.elementType = Int32Element; break;
+            case JID_INT64: token.elementType = Int64Element; break;
+            case JID_UINT8: token.elementType = UInt8Element; break;
+            case JID_UINT16: token.elementType = UInt16Element; break;
+            case JID_REAL16: token.elementType = Real16Element; break;
+            case JID_REAL32: token.elementType = Real32Element; break;
+            case JID_REAL64: token.elementType = Real64Element; break;
+            default:
+                throw Error("Unsupported binary JSON uniform array type");
+            }
+
+            token.type = UniformArrayToken;
+            token.length = readLength();
+            if (token.length < 0) {
+                throw Error("Invalid binary JSON uniform array length");
+            }
+
+            // bools are packed in 32 bit words
+            size_t count = static_cast<size_t>(token.length);
+            m_pendingBytes = token.elementType == BoolElement
+                    ? ((count + 31) / 32) * sizeof(uint32_t)
+                    : count * elementSize(token.elementType);
+            if (m_position + m_pendingBytes > m_size) {
+                throw Error("Unexpected end of JSON data reading uniform array");
+            }
+            return true;
+        }
+        default:
+            throw Error("Unknown binary JSON token id " + std::to_string(id));
+        }
+    }
+
+    return false;
+}
+
+bool JSONTokenizer::nextAscii(Token& token) {
+    while (m_position < m_size) {
+        char c = m_data[m_position];
+
+        if (isAsciiSpace(c) || c == ',' || c == ':') {
+            ++m_position;
+            continue;
+        }
+
+        // // style comments
+        if (c == '/' && m_position + 1 < m_size && m_data[m_position + 1] == '/') {
+            while (m_position < m_size && m_data[m_position] != '\n') {
+                ++m_position;
+            }
+            continue;
+        }
+
+        switch (c) {
+        case '{':
+            ++m_position;
+            token.type = BeginMapToken;
+            return true;
+        case '}':
+            ++m_position;
+            token.type = EndMapToken;
+            return true;
+        case '[':
+            ++m_position;
+            token.type = BeginArrayToken;
+            return true;
+        case ']':
+            ++m_position;
+            token.type = EndArrayToken;
+            return true;
+        case '"':
+            token.type = StringToken;
+            readAsciiString(token.stringValue);
+            return true;
+        default:
+            readAsciiLiteral(token);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JSONTokenizer::readAsciiString(std::string& value) {
+    ++m_position; // opening quote
+
+    while (m_position < m_size) {
+        char c = m_data[m_position++];
+        if (c == '"') {
+            return;
+        }
+        if (c != '\\') {
+            value += c;
+            continue;
+        }
+
+        if (m_position >= m_size) {
+            break;
+        }
+        c = m_data[m_position++];
+        switch (c) {
+        case 'b': value += '\b'; break;
+        case 'f': value += '\f'; break;
+        case 'n': value += '\n'; break;
+        case 'r': value += '\r'; break;
+        case 't': value += '\t'; break;
+        case 'u': {
+            if (m_position + 4 > m_size) {
+                throw Error("Unexpected end of JSON data reading string escape");
+            }
+            std::string hex(m_data + m_position, 4);
+            m_position += 4;
+            unsigned long code = std::strtoul(hex.c_str(), nullptr, 16);
+            // utf-8 encode the basic multilingual plane code point
+            if (code < 0x80) {
+                value += static_cast<char>(code);
+            } else if (code < 0x800) {
+                value += static_cast<char>(0xc0 | (code >> 6));
+                value += static_cast<char>(0x80 | (code & 0x3f));
+            } else {
+                value += static_cast<char>(0xe0 | (code >> 12));
+                value += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+                value += static_cast<char>(0x80 | (code & 0x3f));
+            }
+            break;
+        }
+        default:
+            value += c;
+            break;
+        }
+    }
+
+    throw Error("Unterminated JSON string");
+}
+
+void JSONTokenizer::readAsciiLiteral(Token& token) {
+    size_t start = m_position;
+    while (m_position < m_size && !isAsciiDelimiter(m_data[m_position])) {
+        ++m_position;
+    }
+    std::string literal(m_data + start, m_position - start);
+
+    if (literal == "null") {
+        token.type = NullToken;
+    } else if (literal == "true" || literal == "false") {
+        token.type = BoolToken;
+        token.boolValue = literal == "true";
+    } else if (literal.find_first_of(".eE") != std::string::npos) {
+        char* end = nullptr;
+        token.type = RealToken;
+        token.realValue = std::strtod(literal.c_str(), &end);
+        if (end != literal.c_str() + literal.size()) {
+            throw Error("Invalid JSON number: " + literal);
+        }
+    } else {
+        char* end = nullptr;
+        token.type = IntToken;
+        token.intValue = std::strtoll(literal.c_str(), &end, 10);
+        if (literal.empty() || end != literal.c_str() + literal.size()) {
+            throw Error("Invalid JSON token: " + literal);
+        }
+    }
+}
+
+template <typename T>
+void JSONTokenizer::readUniformArray(const Token& token, T* values) {
+    if (token.type != UniformArrayToken) {
+        throw Error("Expected binary JSON uniform array");
+    }
+
+    size_t count = static_cast<size_t>(token.length);
+    const char* data = m_data + m_position;
+    if (m_pendingBytes == 0 && count > 0) {
+        throw Error("Uniform array elements were already consumed");
+    }
+
+    switch (token.elementType) {
+    case BoolElement:
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t bits;
+            std::memcpy(&bits, data + (i / 32) * sizeof(uint32_t), sizeof(bits));
+            values[i] = static_cast<T>((bits >> (i % 32)) & 1);
+        }
+        break;
+    case Real16Element:
+        for (size_t i = 0; i < count; ++i) {
+            uint16_t half;
+            std::memcpy(&half, data + i * sizeof(half), sizeof(half));
+            values[i] = static_cast<T>(halfToFloat(half));
+        }
+        break;
+
+#define BGEO_READ_UNIFORM_ELEMENTS(ELEMENT, TYPE) \
+    case ELEMENT: \
+        for (size_t i = 0; i < count; ++i) { \
+            TYPE value; \
+            std::memcpy(&value, data + i * sizeof(TYPE), sizeof(TYPE)); \
+            values[i] = static_cast<T>(value); \
+        } \
+        break;
+
+    BGEO_READ_UNIFORM_ELEMENTS(Int8Element, int8_t)
+    BGEO_READ_UNIFORM_ELEMENTS(Int16Element, int16_t)
+    BGEO_READ_UNIFORM_ELEMENTS(Int32Element, int32_t)
+    BGEO_READ_UNIFORM_ELEMENTS(Int64Element, int64_t)
+    BGEO_READ_UNIFORM_ELEMENTS(UInt8Element, uint8_t)
+    BGEO_READ_UNIFORM_ELEMENTS(UInt16Element, uint16_t)
+    BGEO_READ_UNIFORM_ELEMENTS(Real32Element, float)
+    BGEO_READ_UNIFORM_ELEMENTS(Real64Element, double)
+
+#undef BGEO_READ_UNIFORM_ELEMENTS
+    }
+
+    skipPendingElements();
+}
+
+template void JSONTokenizer::readUniformArray<bool>(const Token&, bool*);
+template void JSONTokenizer::readUniformArray<int32_t>(const Token&, int32_t*);
+template void JSONTokenizer::readUniformArray<long>(const Token&, long*);
+template void JSONTokenizer::readUniformArray<long long>(const Token&, long long*);
+template void JSONTokenizer::readUniformArray<float>(const Token&, float*);
+template void JSONTokenizer::readUniformArray<double>(const Token&, double*);
+
+void JSONTokenizer::skipValue(const Token& token) {
+    if (token.type == UniformArrayToken) {
+        skipPendingElements();
+        return;
+    }
+    if (token.type != BeginArrayToken && token.type != BeginMapToken) {
+        return;
+    }
+
+    int depth = 1;
+    Token child;
+    while (depth > 0) {
+        if (!next(child)) {
+            throw Error("Unexpected end of JSON data skipping value");
+        }
+        if (child.type == BeginArrayToken || child.type == BeginMapToken) {
+            ++depth;
+        } else if (child.type == EndArrayToken || child.type == EndMapToken) {
+            --depth;
+        }
+    }
+}
+
+void JSONTokenizer::readNumberArray(const Token& token, std::vector<double>& values) {
+    values.clear();
+
+    if (token.type == UniformArrayToken) {
+        values.resize(static_cast<size_t>(token.length));
+        readUniformArray(token, values.data());
+        return;
+    }
+
+    if (token.type != BeginArrayToken) {
+        throw Error("Expected JSON number array");
+    }
+
+    Token element;
+    while (next(element) && element.type != EndArrayToken) {
+        if (element.isNumber()) {
+            values.push_back(element.numberValue());
+        } else if (element.type == BoolToken) {
+            values.push_back(element.boolValue ? 1.0 : 0.0);
+        } else {
+            throw Error("Expected number in JSON number array");
+        }
+    }
+    if (element.type != EndArrayToken) {
+        throw Error("Unexpected end of JSON data reading number array");
+    }
+}
+
+} // namespace parser
+} // namespace bgeo
+} // namespace ika
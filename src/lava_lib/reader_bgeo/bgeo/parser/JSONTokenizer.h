@@ -0,0 +1,142 @@
+/*
+ *  Copyright 2018 Laika, LLC. Authored by Peter Stuart
+ *
+ *  Licensed under the Apache License, Version 2.0, <LICENSE-APACHE or
+ *  http://apache.org/licenses/LICENSE-2.0> or the MIT license <LICENSE-MIT or
+ *  http://opensource.org/licenses/MIT>, at your option. This file may not be
+ *  copied, modified, or distributed except according to those terms.
+ */
+
+#ifndef BGEO_PARSER_JSON_TOKENIZER_H
+#define BGEO_PARSER_JSON_TOKENIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ika
+{
+namespace bgeo
+{
+namespace parser
+{
+
+// Pull tokenizer of Houdini JSON geometry streams, both binary (.bgeo) and
+// ascii (.geo). It works on an in-memory buffer and doesn't depend on Houdini
+// UT classes, so it can run wherever the data comes from. JSONParser builds
+// the structured parsing the loaders use on top of it.
+class JSONTokenizer
+{
+public:
+    enum TokenType
+    {
+        NullToken,
+        BeginMapToken,
+        EndMapToken,
+        BeginArrayToken,
+        EndArrayToken,
+        BoolToken,
+        IntToken,
+        RealToken,
+        StringToken,
+        UniformArrayToken, // binary only, elements follow the token
+        EndToken
+    };
+
+    enum ElementType
+    {
+        BoolElement,
+        Int8Element,
+        Int16Element,
+        Int32Element,
+        Int64Element,
+        UInt8Element,
+        UInt16Element,
+        Real16Element,
+        Real32Element,
+        Real64Element
+    };
+
+    struct Token
+    {
+        TokenType type = NullToken;
+        bool boolValue = false;
+        int64_t intValue = 0;
+        double realValue = 0.0;
+        std::string stringValue;
+
+        // uniform array element type and count
+        ElementType elementType = Real32Element;
+        int64_t length = 0;
+
+        bool isNumber() const { return type == IntToken || type == RealToken; }
+        double numberValue() const { return type == IntToken ? static_cast<double>(intValue) : realValue; }
+    };
+
+    class Error : public std::runtime_error
+    {
+    public:
+        explicit Error(const std::string& message)
+            : std::runtime_error(message)
+        {
+        }
+    };
+
+    JSONTokenizer(const char* data, size_t size);
+
+    bool isBinary() const { return m_binary; }
+    size_t getPosition() const { return m_position; }
+
+    // Read the next token. Ascii key and value separators are consumed
+    // silently, so map keys are plain string tokens in both encodings.
+    // Elements of a uniform array not read with readUniformArray() are
+    // skipped. Returns false (and EndToken) once data is exhausted.
+    bool next(Token& token);
+
+    // Read token.length elements of the uniform array token converted to T.
+    // Must be called right after next() returned the uniform array token.
+    template <typename T>
+    void readUniformArray(const Token& token, T* values);
+
+    // Skip the value starting with token. Arrays and maps are skipped
+    // entirely.
+    void skipValue(const Token& token);
+
+    // Read a numeric array value starting with token, either a uniform array
+    // or a regular array of numbers.
+    void readNumberArray(const Token& token, std::vector<double>& values);
+
+private:
+    template <typename T>
+    T read();
+
+    int64_t readLength();
+    std::string readBinaryString(int64_t length);
+    void skipPendingElements();
+
+    bool nextBinary(Token& token);
+    bool nextAscii(Token& token);
+    void readAsciiString(std::string& value);
+    void readAsciiLiteral(Token& token);
+
+    static size_t elementSize(ElementType type);
+
+    const char* m_data;
+    size_t m_size;
+    size_t m_position;
+    bool m_binary;
+
+    // uniform array elements not consumed by readUniformArray() yet
+    size_t m_pendingBytes;
+
+    std::unordered_map<int64_t, std::string> m_strings;
+};
+
+} // namespace parser
+} // namespace bgeo
+} // namespace ika
+
+#endif // BGEO_PARSER_JSON_TOKENIZER_H
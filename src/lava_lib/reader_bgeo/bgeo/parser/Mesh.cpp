@@ -12,8 +12,6 @@
 #include <cassert>
 #include <iostream>
 
-#include <UT/UT_JSONHandle.h>
-
 #include "Detail.h"
 #include "ReadError.h"
 #include "util.h"
@@ -24,18 +22,18 @@ namespace parser {
 
 namespace {
 
-class UniformDataHandle : public UT_JSONHandleError {
+class UniformDataHandle : public JSONHandle {
  public:
     UniformDataHandle(Mesh& mesh): mesh(mesh) { }
 
-    /*virtual*/ bool jsonKey(UT_JSONParser& parser, const char *v, int64 len) {
-        UT_String key(v);
+    /*virtual*/ bool jsonKey(JSONParser& parser, const char *v, int64 len) {
+        std::string key(v);
         if (key == "surface") {
-            //UT_String surfaceType;
+            //std::string surfaceType;
 
-            UT_WorkBuffer buffer;
+            std::string buffer;
             //BGEO_CHECK(parser.parseString(buffer));
-            //value.harden(buffer.buffer());
+            //value = buffer;
 
             BGEO_CHECK(parser.parseString(buffer));
             if(buffer == "quads") {
@@ -54,15 +52,14 @@ class UniformDataHandle : public UT_JSONHandleError {
             return true;
         }
 
-
         return false;
     }
 
-    /*virtual*/ bool jsonBeginMap(UT_JSONParser& parser) {
+    /*virtual*/ bool jsonBeginMap(JSONParser& parser) {
         return true;
     }
 
-    /*virtual*/ bool jsonEndMap(UT_JSONParser& parser) {
+    /*virtual*/ bool jsonEndMap(JSONParser& parser) {
         return true;
     }
 
@@ -79,7 +76,7 @@ Mesh* Mesh::clone() const {
     return new Mesh(*this);
 }
 
-/*virtual*/ void Mesh::loadData(UT_JSONParser &parser) {
+/*virtual*/ void Mesh::loadData(JSONParser &parser) {
     parseBeginArray(parser);
     {
         /*
@@ -96,7 +93,7 @@ Mesh* Mesh::clone() const {
     parseEndArray(parser);
 }
 
-/*virtual*/ void Mesh::loadVaryingData(UT_JSONParser& parser, const StringList& fields) {
+/*virtual*/ void Mesh::loadVaryingData(JSONParser& parser, const StringList& fields) {
     // NOTE: for now just support only the vertex field
     if (fields.size() != 1 || fields[0] != "vertex") {
         throw ReadError("Mesh primitive supports only varying vertex");
@@ -108,7 +105,7 @@ Mesh* Mesh::clone() const {
     }
 }
 
-/*virtual*/ void Mesh::loadUniformData(UT_JSONParser& parser) {
+/*virtual*/ void Mesh::loadUniformData(JSONParser& parser) {
     UniformDataHandle uniformHandle(*this);
     BGEO_CHECK(parser.parseObject(uniformHandle));
 }
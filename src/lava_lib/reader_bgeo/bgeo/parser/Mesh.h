@@ -31,10 +31,10 @@ class Mesh : public Primitive {
         return MeshRunMode;
     }
 
-    /*virtual*/ void loadData(UT_JSONParser &parser);
+    /*virtual*/ void loadData(JSONParser &parser);
 
-    /*virtual*/ void loadVaryingData(UT_JSONParser& parser, const StringList& fields);
-    /*virtual*/ void loadUniformData(UT_JSONParser& parser);
+    /*virtual*/ void loadVaryingData(JSONParser& parser, const StringList& fields);
+    /*virtual*/ void loadUniformData(JSONParser& parser);
 
     /*virtual*/ std::ostream& encode(std::ostream& co) const;
 
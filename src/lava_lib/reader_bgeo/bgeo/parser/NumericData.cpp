@@ -11,9 +11,7 @@
 
 #include <memory>
 #include <iostream>
-
-#include <UT/UT_String.h>
-#include <UT/UT_JSONHandle.h>
+#include <string>
 
 #include "util.h"
 
@@ -28,7 +26,7 @@ namespace
 {
 
 template <typename T>
-class TupleFlattener : public UT_JSONHandleError
+class TupleFlattener : public JSONHandle
 {
 public:
     TupleFlattener(ByteBuffer& buffer)
@@ -38,33 +36,32 @@ public:
     {
     }
 
-    /*virtual*/ bool jsonInt(UT_JSONParser& parser, int64 value)
+    /*virtual*/ bool jsonInt(JSONParser& parser, int64 value)
     {
         setCurrentElement(static_cast<T>(value));
         return true;
     }
 
-    /*virtual*/ bool jsonReal(UT_JSONParser& parser, fpreal64 value)
+    /*virtual*/ bool jsonReal(JSONParser& parser, fpreal64 value)
     {
         setCurrentElement(static_cast<T>(value));
         return true;
     }
 
-    /*virtual*/ bool jsonBeginArray(UT_JSONParser& parser)
+    /*virtual*/ bool jsonBeginArray(JSONParser& parser)
     {
         m_stack++;
         return true;
     }
 
-    /*virtual*/ bool jsonEndArray(UT_JSONParser& parser)
+    /*virtual*/ bool jsonEndArray(JSONParser& parser)
     {
         m_stack--;
         // verify that we read all the elements we need
         if (m_stack == 0 && m_index != m_buffer.sizeAs<T>())
         {
-            UT_String message;
-            message.sprintf("Expected %ld point attribute values, but only read %ld",
-                            m_buffer.sizeAs<T>(), m_index);
+            std::string message = formatMessage("Expected %ld point attribute values, but only read %ld",
+                                                m_buffer.sizeAs<T>(), m_index);
             throw ReadError(message);
         }
         return true;
@@ -79,8 +76,7 @@ private:
     {
         if (m_index > m_buffer.sizeAs<T>())
         {
-            UT_String message;
-            message.sprintf("Tuple array expecting total of %ld elements", m_buffer.sizeAs<T>());
+            std::string message = formatMessage("Tuple array expecting total of %ld elements", m_buffer.sizeAs<T>());
             throw ReadError(message);
         }
 
@@ -89,7 +85,7 @@ private:
     }
 };
 
-class BoolTupleFlattener : public UT_JSONHandleError
+class BoolTupleFlattener : public JSONHandle
 {
 public:
     BoolTupleFlattener(std::vector<bool>& flags, int pageCount)
@@ -106,32 +102,32 @@ public:
         return "ConstantPageFlags";
     }
 
-    /*virtual*/ bool jsonBool(UT_JSONParser& parser, bool value)
+    /*virtual*/ bool jsonBool(JSONParser& parser, bool value)
     {
         setCurrentElement(value);
         return true;
     }
 
-    /*virtual*/ bool jsonInt(UT_JSONParser& parser, int64 value)
+    /*virtual*/ bool jsonInt(JSONParser& parser, int64 value)
     {
         setCurrentElement(value);
         return true;
     }
 
-    /*virtual*/ bool jsonReal(UT_JSONParser& parser, fpreal64 value)
+    /*virtual*/ bool jsonReal(JSONParser& parser, fpreal64 value)
     {
         setCurrentElement(value);
         return true;
     }
 
-    /*virtual*/ bool jsonBeginArray(UT_JSONParser& parser)
+    /*virtual*/ bool jsonBeginArray(JSONParser& parser)
     {
         m_stack++;
         m_currentPageCount = 0;
         return true;
     }
 
-    /*virtual*/ bool jsonEndArray(UT_JSONParser& parser)
+    /*virtual*/ bool jsonEndArray(JSONParser& parser)
     {
         m_stack--;
 
@@ -144,9 +140,8 @@ public:
         // verify that we read all the elements we need
         if (m_stack == 0 && m_index != m_flags.size())
         {
-            UT_String message;
-            message.sprintf("Expected %ld bool tuple values, but read %ld",
-                            m_flags.size(), m_index);
+            std::string message = formatMessage("Expected %ld bool tuple values, but read %ld",
+                                                m_flags.size(), m_index);
             throw ReadError(message);
         }
         return true;
@@ -163,8 +158,7 @@ private:
     {
         if (m_index >= m_flags.size())
         {
-            UT_String message;
-            message.sprintf("Bool tuple array expecting total of %ld elements", m_flags.size());
+            std::string message = formatMessage("Bool tuple array expecting total of %ld elements", m_flags.size());
             throw ReadError(message);
         }
 
@@ -193,14 +187,14 @@ bool NumericData::operator == (const NumericData& numeric) const
            constantPageFlags == numeric.constantPageFlags;
 }
 
-void NumericData::load(UT_JSONParser &parser)
+void NumericData::load(JSONParser &parser)
 {
-    UT_WorkBuffer buffer;
-    UT_String key;
+    std::string buffer;
+    std::string key;
     for (auto it = parser.beginArray(); !it.atEnd(); ++it)
     {
         it.getLowerKey(buffer);
-        key = buffer.buffer();
+        key = buffer;
         if (key == "size")
         {
             int64 size;
@@ -211,14 +205,14 @@ void NumericData::load(UT_JSONParser &parser)
         else if (key == "storage")
         {
             BGEO_CHECK(parser.parseString(buffer));
-            storage = storage::toStorage(buffer.buffer());
+            storage = storage::toStorage(buffer.c_str());
         }
         else if (key == "tuples" || key == "arrays")
         {
             assert(storage != storage::UnknownStorage);
 
             data.resize(sizeInBytes(storage) * elementCount * tupleSize);
-            std::unique_ptr<UT_JSONHandle> handle;
+            std::unique_ptr<JSONHandle> handle;
             if (storage == storage::Fpreal32)
             {
                 handle.reset(new TupleFlattener<fpreal32>(data));
@@ -272,7 +266,7 @@ void NumericData::load(UT_JSONParser &parser)
             }
 
             data.resize(sizeInBytes(storage) * numFloats);
-            std::unique_ptr<UT_JSONHandle> handle;
+            std::unique_ptr<JSONHandle> handle;
             if (storage == storage::Fpreal32)
             {
                 handle.reset(new TupleFlattener<fpreal32>(data));
@@ -320,7 +314,7 @@ void NumericData::load(UT_JSONParser &parser)
     }
 }
 
-void NumericData::loadArray(UT_JSONParser& parser, storage::Storage storage_,
+void NumericData::loadArray(JSONParser& parser, storage::Storage storage_,
                             int32 count)
 {
     storage = storage_;
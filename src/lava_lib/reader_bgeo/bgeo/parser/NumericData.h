@@ -10,9 +10,10 @@
 #ifndef BGEO_PARSER_NUMERICDATA_H
 #define BGEO_PARSER_NUMERICDATA_H
 
+#include <cstring>
 #include <iosfwd>
 
-#include <UT/UT_JSONParser.h>
+#include "JSONParser.h"
 
 #include "storage.h"
 #include "StorageTraits.h"
@@ -49,8 +50,8 @@ public:
 
     void swap(NumericData& data);
 
-    void load(UT_JSONParser& parser);
-    void loadArray(UT_JSONParser& parser, storage::Storage storage,
+    void load(JSONParser& parser);
+    void loadArray(JSONParser& parser, storage::Storage storage,
                    int32 count);
 
     int64 elementCount;
@@ -104,19 +105,21 @@ public:
                 }
             }
         }
-//        else if (storage == storage::Fpreal64)
-//        {
-//            assert(sourceIndex * tupleSize < data.sizeAs<fpreal64>());
-//            // can copy directly
-//            const fpreal64* source = this->data.dataAs<fpreal64>();
-//        }
-
-//        else if (storage == RealStorage64)
-//        {
-//            assert(sourceIndex * tupleSize < data.sizeAs<fpreal64>());
-//            // can copy directly
-//            fpreal64* source = this->data.dataAs<fpreal64>();
-//        }
+        else if (storage == storage::Fpreal64)
+        {
+            std::vector<fpreal64> unpacked;
+            getUnpackedData(unpacked);
+
+            assert(sourceIndex * tupleSize < unpacked.size());
+            const fpreal64* source = unpacked.data();
+
+            for (int64 i = 0; i < elementCopyCount; ++i)
+            {
+                memcpy(&target[i * targetTupleSize],
+                       &source[(sourceIndex + i) * tupleSize],
+                       sizeof(fpreal64) * targetTupleSize);
+            }
+        }
     }
 
     void copyTo(fpreal32* target, int32 targetTupleSize, int64 targetElementCount,
@@ -130,12 +133,12 @@ public:
         assert(targetTupleSize <= tupleSize);
         assert(elementCopyCount <= targetElementCount);
 
-        // FIXME: this is inefficient - it should be unpacked directly into target.
-        std::vector<fpreal32> unpacked;
-        getUnpackedData(unpacked);
-
         if (storage == storage::Fpreal32)
         {
+            // FIXME: this is inefficient - it should be unpacked directly into target.
+            std::vector<fpreal32> unpacked;
+            getUnpackedData(unpacked);
+
             assert(sourceIndex * tupleSize < unpacked.size());
             // have to cast
             //const fpreal32* source = data.data.dataAs<fpreal32>();
@@ -148,19 +151,24 @@ public:
                        sizeof(fpreal32) * targetTupleSize);
             }
         }
-//        else if (storage == storage::Fpreal64)
-//        {
-//            assert(sourceIndex * tupleSize < data.sizeAs<fpreal64>());
-//            // can copy directly
-//            const fpreal64* source = this->data.dataAs<fpreal64>();
-//        }
-
-//        else if (storage == RealStorage64)
-//        {
-//            assert(sourceIndex * tupleSize < data.sizeAs<fpreal64>());
-//            // can copy directly
-//            fpreal64* source = this->data.dataAs<fpreal64>();
-//        }
+        else if (storage == storage::Fpreal64)
+        {
+            // double precision attributes (e.g. 64 bit P) are narrowed to float
+            std::vector<fpreal64> unpacked;
+            getUnpackedData(unpacked);
+
+            assert(sourceIndex * tupleSize < unpacked.size());
+            const fpreal64* source = unpacked.data();
+
+            for (int64 i = 0; i < elementCopyCount; ++i)
+            {
+                for (int j = 0; j < targetTupleSize; ++j)
+                {
+                    target[i * targetTupleSize + j] =
+                            static_cast<fpreal32>(source[(sourceIndex + i) * tupleSize + j]);
+                }
+            }
+        }
     }
 
     friend std::ostream& operator << (std::ostream& co, const NumericData& data);
@@ -11,41 +11,51 @@
 
 #include <cassert>
 
-#include <UT/UT_JSONHandle.h>
-
 #include "Attribute.h"
 #include "Detail.h"
 #include "ReadError.h"
 #include "util.h"
 #include "PackedGeometry.h"
 
-
 namespace ika {
 namespace bgeo {
 namespace parser {
 
 namespace {
 
+// replace all occurrences of pattern in text
+bool substitute(std::string& text, const std::string& pattern, const std::string& value)
+{
+    bool substituted = false;
+    for (size_t position = text.find(pattern); position != std::string::npos;
+         position = text.find(pattern, position + value.size()))
+    {
+        text.replace(position, pattern.size(), value);
+        substituted = true;
+    }
+    return substituted;
+}
+
 // FIXME: move this into PackedGeometry
-class UniformDataHandle : public UT_JSONHandleError {
+class UniformDataHandle : public JSONHandle {
 public:
     UniformDataHandle(PackedDisk& packed)
         : packed(packed)
     {
     }
 
-    /*virtual*/ bool jsonKey(UT_JSONParser& parser, const char *v, int64 len)
+    /*virtual*/ bool jsonKey(JSONParser& parser, const char *v, int64 len)
     {
-        UT_String key(v);
+        std::string key(v);
         return packed.parseDataWithKey(parser, key);
     }
 
-    /*virtual*/ bool jsonBeginMap(UT_JSONParser& parser)
+    /*virtual*/ bool jsonBeginMap(JSONParser& parser)
     {
         return true;
     }
 
-    /*virtual*/ bool jsonEndMap(UT_JSONParser& parser)
+    /*virtual*/ bool jsonEndMap(JSONParser& parser)
     {
         return true;
     }
@@ -68,8 +78,6 @@ PackedDisk::PackedDisk(const PackedDisk& disk)
       expand(disk.expand),
       frame(disk.frame)
 {
-    filename.harden(); // harden here to prevent referencing stale data
-                       // if the original primitive goes away.
 }
 
 PackedDisk* PackedDisk::clone() const
@@ -77,8 +85,8 @@ PackedDisk* PackedDisk::clone() const
     return new PackedDisk(*this);
 }
 
-bool PackedDisk::parseParametersWithKey(UT_JSONParser& parser,
-                                        const UT_String& key)
+bool PackedDisk::parseParametersWithKey(JSONParser& parser,
+                                        const std::string& key)
 {
     if (PackedGeometry::parseParametersWithKey(parser, key))
     {
@@ -95,9 +103,9 @@ bool PackedDisk::parseParametersWithKey(UT_JSONParser& parser,
     }
     else if (key == "filename")
     {
-        UT_WorkBuffer buffer;
+        std::string buffer;
         BGEO_CHECK(parser.parseValue(buffer));
-        filename.harden(buffer.buffer());
+        filename = buffer;
     }
     else
     {
@@ -121,25 +129,21 @@ std::ostream& PackedDisk::encode(std::ostream& co) const
 
 std::string PackedDisk::getFilename() const {
     if (!expand) {
-        return std::string(filename.c_str());
+        return filename;
     }
 
-    UT_String fmt(filename);
-    fmt.harden();
+    std::string result(filename);
 
-    bool substituted = fmt.substitute("$F4", "%04d") > 0;
+    bool substituted = substitute(result, "$F4", formatMessage("%04d", frame));
     if (!substituted) {
-        substituted = fmt.substitute("$F", "%d") > 0;
+        substituted = substitute(result, "$F", formatMessage("%d", frame));
     }
 
     if (!substituted) {
-        return std::string(filename.c_str());
+        return filename;
     }
 
-    UT_String result;
-    result.sprintf(fmt, frame);
-
-    return std::string(result.c_str());
+    return result;
 }
 
 } // namespace parser
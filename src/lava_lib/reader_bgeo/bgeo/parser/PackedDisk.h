@@ -12,7 +12,6 @@
 
 #include <string>
 
-#include <UT/UT_String.h>
 
 #include "PackedGeometry.h"
 
@@ -31,8 +30,8 @@ class PackedDisk : public PackedGeometry {
         return PackedDiskType;
     }
 
-    /*virtual*/ bool parseParametersWithKey(UT_JSONParser& parser,
-                                            const UT_String& key);
+    /*virtual*/ bool parseParametersWithKey(JSONParser& parser,
+                                            const std::string& key);
 
     /*virtual*/ std::ostream& encode(std::ostream& co) const;
 
@@ -43,7 +42,7 @@ private:
     // avoid accessing it.
     void getBounds(double bounds[6]) const;
 
-    UT_String filename;
+    std::string filename;
     bool expand;
     int frame;
 };
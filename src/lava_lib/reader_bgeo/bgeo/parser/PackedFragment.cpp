@@ -11,15 +11,12 @@
 
 #include <cassert>
 
-#include <UT/UT_JSONHandle.h>
-
 #include "Attribute.h"
 #include "Detail.h"
 #include "ReadError.h"
 #include "util.h"
 #include "PackedGeometry.h"
 
-
 namespace ika {
 namespace bgeo {
 namespace parser {
@@ -28,7 +25,7 @@ namespace
 {
 
 // FIXME: move this to PackedGeometry
-class UniformDataHandle : public UT_JSONHandleError
+class UniformDataHandle : public JSONHandle
 {
 public:
     UniformDataHandle(PackedFragment& packed)
@@ -36,18 +33,18 @@ public:
     {
     }
 
-    /*virtual*/ bool jsonKey(UT_JSONParser& parser, const char *v, int64 len)
+    /*virtual*/ bool jsonKey(JSONParser& parser, const char *v, int64 len)
     {
-        UT_String key(v);
+        std::string key(v);
         return packed.parseDataWithKey(parser, key);
     }
 
-    /*virtual*/ bool jsonBeginMap(UT_JSONParser& parser)
+    /*virtual*/ bool jsonBeginMap(JSONParser& parser)
     {
         return true;
     }
 
-    /*virtual*/ bool jsonEndMap(UT_JSONParser& parser)
+    /*virtual*/ bool jsonEndMap(JSONParser& parser)
     {
         return true;
     }
@@ -73,8 +70,8 @@ PackedFragment* PackedFragment::clone() const
     return new PackedFragment(*this);
 }
 
-bool PackedFragment::parseParametersWithKey(UT_JSONParser& parser,
-                                        const UT_String& key)
+bool PackedFragment::parseParametersWithKey(JSONParser& parser,
+                                        const std::string& key)
 {
     if (PackedGeometry::parseParametersWithKey(parser, key))
     {
@@ -83,9 +80,9 @@ bool PackedFragment::parseParametersWithKey(UT_JSONParser& parser,
 
     if (key == "attribute")
     {
-        UT_WorkBuffer buffer;
+        std::string buffer;
         BGEO_CHECK(parser.parseValue(buffer));
-        attribute.harden(buffer.buffer());
+        attribute = buffer;
     }
     else if (key == "bounds")
     {
@@ -93,9 +90,9 @@ bool PackedFragment::parseParametersWithKey(UT_JSONParser& parser,
     }
     else if (key == "name")
     {
-        UT_WorkBuffer buffer;
+        std::string buffer;
         BGEO_CHECK(parser.parseValue(buffer));
-        name.harden(buffer.buffer());
+        name = buffer;
     }
     else
     {
@@ -12,7 +12,6 @@
 
 #include <string>
 
-#include <UT/UT_String.h>
 
 #include "PackedGeometry.h"
 
@@ -36,13 +35,13 @@ public:
         return PackedFragmentType;
     }
 
-    /*virtual*/ bool parseParametersWithKey(UT_JSONParser& parser,
-                                            const UT_String& key);
+    /*virtual*/ bool parseParametersWithKey(JSONParser& parser,
+                                            const std::string& key);
 
     /*virtual*/ std::ostream& encode(std::ostream& co) const;
 
-    UT_String attribute;
-    UT_String name;
+    std::string attribute;
+    std::string name;
 };
 
 } // namespace parser
@@ -12,8 +12,6 @@
 #include <cassert>
 #include <limits>
 
-#include <UT/UT_JSONHandle.h>
-
 #include "Attribute.h"
 #include "Detail.h"
 #include "ReadError.h"
@@ -25,7 +23,7 @@ namespace parser {
 
 namespace {
 
-class UniformDataHandle : public UT_JSONHandleError
+class UniformDataHandle : public JSONHandle
 {
 public:
     UniformDataHandle(PackedGeometry& packed)
@@ -33,18 +31,18 @@ public:
     {
     }
 
-    /*virtual*/ bool jsonKey(UT_JSONParser& parser, const char *v, int64 len)
+    /*virtual*/ bool jsonKey(JSONParser& parser, const char *v, int64 len)
     {
-        UT_String key(v);
+        std::string key(v);
         return packed.parseDataWithKey(parser, key);
     }
 
-    /*virtual*/ bool jsonBeginMap(UT_JSONParser& parser)
+    /*virtual*/ bool jsonBeginMap(JSONParser& parser)
     {
         return true;
     }
 
-    /*virtual*/ bool jsonEndMap(UT_JSONParser& parser)
+    /*virtual*/ bool jsonEndMap(JSONParser& parser)
     {
         return true;
     }
@@ -67,9 +65,9 @@ PackedGeometry::PackedGeometry(const PackedGeometry& packed)
     : Primitive(packed.detail),
       boundsValid(packed.boundsValid),
       embeddedKey(packed.embeddedKey),
-      transform(packed.transform),
       vertex(packed.vertex)
 {
+    memcpy(transform, packed.transform, sizeof(double) * 16);
     memcpy(bounds, packed.bounds, sizeof(double) * 6);
     memcpy(pivot, packed.pivot, sizeof(double) * 3);
 }
@@ -79,53 +77,51 @@ PackedGeometry* PackedGeometry::clone() const
     return new PackedGeometry(*this);
 }
 
-/*virtual*/ void PackedGeometry::loadData(UT_JSONParser& parser)
+/*virtual*/ void PackedGeometry::loadData(JSONParser& parser)
 {
-    UT_WorkBuffer buffer;
-    UT_String key;
+    std::string buffer;
+    std::string key;
 
     for (auto geoit = parser.beginArray(); !geoit.atEnd(); ++geoit)
     {
         geoit.getLowerKey(buffer);
-        key = buffer.buffer();
+        key = buffer;
         if (!parseDataWithKey(parser, key))
         {
-            UT_String message;
-            message.sprintf("Invalid packed geometry data: \"%s\"",
-                            key.c_str());
-            throw ReadError(message.buffer());
+            std::string message = formatMessage("Invalid packed geometry data: \"%s\"",
+                                                key.c_str());
+            throw ReadError(message);
         }
     }
 }
 
-/*virtual*/ void PackedGeometry::loadVaryingData(UT_JSONParser& parser,
+/*virtual*/ void PackedGeometry::loadVaryingData(JSONParser& parser,
                                            const Primitive::StringList& fields)
 {
     parseBeginArray(parser);
     {
         for (auto& field : fields)
         {
-            if (!parseDataWithKey(parser, UT_String(field)))
+            if (!parseDataWithKey(parser, std::string(field)))
             {
-                UT_String message;
-                message.sprintf("Invalid packed geometry varying field: \"%s\"",
-                                field.c_str());
-                throw ReadError(message.buffer());
+                std::string message = formatMessage("Invalid packed geometry varying field: \"%s\"",
+                                                    field.c_str());
+                throw ReadError(message);
             }
         }
     }
     parseEndArray(parser);
 }
 
-/*virtual*/ void PackedGeometry::loadUniformData(UT_JSONParser& parser)
+/*virtual*/ void PackedGeometry::loadUniformData(JSONParser& parser)
 {
     UniformDataHandle uniformHandle(*this);
     BGEO_CHECK(parser.parseObject(uniformHandle));
 }
 
-/*virtual*/ bool PackedGeometry::loadSharedData(UT_JSONParser& parser,
-                                                UT_String& dataType,
-                                                UT_String& dataKey)
+/*virtual*/ bool PackedGeometry::loadSharedData(JSONParser& parser,
+                                                std::string& dataType,
+                                                std::string& dataKey)
 {
     if (dataType == "gu:embeddedgeo" && dataKey == embeddedKey)
     {
@@ -138,8 +134,8 @@ PackedGeometry* PackedGeometry::clone() const
 }
 
 /*virtual*/ void PackedGeometry::loadSharedData(const Primitive& source,
-                                                const UT_String& dataType,
-                                                const UT_String& dataKey)
+                                                const std::string& dataType,
+                                                const std::string& dataKey)
 {
     if (dataType != "gu:embeddedgeo" || dataKey != embeddedKey)
     {
@@ -183,7 +179,14 @@ PackedGeometry* PackedGeometry::clone() const
     }
 
     co << "]\n"
-       << "    transform = [" << transform << "]\n"
+       << "    transform = [";
+
+    for (int i = 0; i < 16; ++i)
+    {
+        co << transform[i] << " ";
+    }
+
+    co << "]\n"
        << "    vertex = " << vertex;
 
     return co;
@@ -214,8 +217,7 @@ void PackedGeometry::getTranslate(fpreal64 translate[3]) const
 
 void PackedGeometry::getTransform(double matrix[16]) const
 {
-    assert(sizeof(transform) == 16 * sizeof(double));
-    memcpy(matrix, transform.data(), 16 * sizeof(double));
+    memcpy(matrix, transform, 16 * sizeof(double));
 }
 
 const std::shared_ptr<Detail> PackedGeometry::getEmbeddedGeo() const
@@ -223,22 +225,22 @@ const std::shared_ptr<Detail> PackedGeometry::getEmbeddedGeo() const
     return embeddedGeo;
 }
 
-UT_String PackedGeometry::getEmbeddedKey() const
+std::string PackedGeometry::getEmbeddedKey() const
 {
     return embeddedKey;
 }
 
 /*virtual*/
-bool PackedGeometry::parseDataWithKey(UT_JSONParser& parser, const UT_String& key)
+bool PackedGeometry::parseDataWithKey(JSONParser& parser, const std::string& key)
 {
     if (key == "parameters")
     {
-        UT_WorkBuffer buffer;
-        UT_String parmkey;
+        std::string buffer;
+        std::string parmkey;
         for (auto it = parser.beginMap(); !it.atEnd(); ++it)
         {
             it.getLowerKey(buffer);
-            parmkey = buffer.buffer();
+            parmkey = buffer;
             if (!parseParametersWithKey(parser, parmkey))
             {
                 return false;
@@ -251,9 +253,7 @@ bool PackedGeometry::parseDataWithKey(UT_JSONParser& parser, const UT_String& ke
     }
     else if (key == "transform")
     {
-        UT_Matrix3D m3;
-        BGEO_CHECK(m3.load(parser));
-        transform = m3;
+        parseMatrix3(parser, transform);
     }
     else if (key == "vertex")
     {
@@ -272,8 +272,8 @@ bool PackedGeometry::parseDataWithKey(UT_JSONParser& parser, const UT_String& ke
 }
 
 /*virtual*/
-bool PackedGeometry::parseParametersWithKey(UT_JSONParser& parser,
-                                            const UT_String& key)
+bool PackedGeometry::parseParametersWithKey(JSONParser& parser,
+                                            const std::string& key)
 {
     if (key == "cachedbounds")
     {
@@ -282,9 +282,9 @@ bool PackedGeometry::parseParametersWithKey(UT_JSONParser& parser,
     }
     else if (key == "embedded")
     {
-        UT_WorkBuffer buffer;
+        std::string buffer;
         BGEO_CHECK(parser.parseValue(buffer));
-        embeddedKey.harden(buffer.buffer());
+        embeddedKey = buffer;
     }
     else if (key == "pointinstancetransform")
     {
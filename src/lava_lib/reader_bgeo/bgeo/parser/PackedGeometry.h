@@ -13,8 +13,6 @@
 #include <vector>
 #include <memory>
 
-#include <UT/UT_Matrix4.h>
-
 #include "Primitive.h"
 
 namespace ika
@@ -42,16 +40,16 @@ public:
         return SplitRunMode;
     }
 
-    /*virtual*/ void loadData(UT_JSONParser &parser);
+    /*virtual*/ void loadData(JSONParser &parser);
 
-    /*virtual*/ void loadVaryingData(UT_JSONParser& parser, const StringList& fields);
-    /*virtual*/ void loadUniformData(UT_JSONParser& parser);
+    /*virtual*/ void loadVaryingData(JSONParser& parser, const StringList& fields);
+    /*virtual*/ void loadUniformData(JSONParser& parser);
 
-    /*virtual*/ bool loadSharedData(UT_JSONParser& parser,
-                                    UT_String& dataType, UT_String& dataKey);
+    /*virtual*/ bool loadSharedData(JSONParser& parser,
+                                    std::string& dataType, std::string& dataKey);
     /*virtual*/ void loadSharedData(const Primitive& source,
-                                    const UT_String& dataType,
-                                    const UT_String& dataKey);
+                                    const std::string& dataType,
+                                    const std::string& dataKey);
 
     /*virtual*/ std::ostream& encode(std::ostream& co) const;
 
@@ -62,17 +60,17 @@ public:
     void getTransform(double matrix[3]) const;
 
     const std::shared_ptr<Detail> getEmbeddedGeo() const;
-    UT_String getEmbeddedKey() const;
+    std::string getEmbeddedKey() const;
 
-    virtual bool parseDataWithKey(UT_JSONParser& parser, const UT_String& key);
-    virtual bool parseParametersWithKey(UT_JSONParser& parser, const UT_String& key);
+    virtual bool parseDataWithKey(JSONParser& parser, const std::string& key);
+    virtual bool parseParametersWithKey(JSONParser& parser, const std::string& key);
 
 private:
     bool boundsValid;
     double bounds[6];
-    UT_String embeddedKey;
+    std::string embeddedKey;
     double pivot[3];
-    UT_Matrix4D transform;
+    fpreal64 transform[16];
     int32 vertex;
 
     std::shared_ptr<Detail> embeddedGeo;
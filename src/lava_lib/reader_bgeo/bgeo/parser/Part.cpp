@@ -27,7 +27,7 @@ Part::Part(const Detail& detail)
 {
 }
 
-/*virtual*/ void Part::loadData(UT_JSONParser &parser)
+/*virtual*/ void Part::loadData(JSONParser &parser)
 {
     parseBeginArray(parser);
     {
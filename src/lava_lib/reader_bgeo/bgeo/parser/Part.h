@@ -32,7 +32,7 @@ public:
         return PartType;
     }
 
-    /*virtual*/ void loadData(UT_JSONParser &parser);
+    /*virtual*/ void loadData(JSONParser &parser);
 
     /*virtual*/ std::ostream& encode(std::ostream& co) const;
 
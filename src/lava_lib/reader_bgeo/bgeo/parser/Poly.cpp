@@ -11,8 +11,6 @@
 
 #include <cassert>
 
-#include <UT/UT_JSONHandle.h>
-
 #include "Detail.h"
 #include "ReadError.h"
 #include "VertexArrayBuilder.h"
@@ -24,13 +22,13 @@ namespace parser {
 
 namespace {
 
-class UniformDataHandle : public UT_JSONHandleError {
+class UniformDataHandle : public JSONHandle {
  public:
     UniformDataHandle(Poly& poly): poly(poly) { }
 
-    /*virtual*/ bool jsonKey(UT_JSONParser& parser, const char *v, int64 len)
+    /*virtual*/ bool jsonKey(JSONParser& parser, const char *v, int64 len)
     {
-        UT_String key(v);
+        std::string key(v);
         if (key == "closed")
         {
             poly.closed.resize(1);
@@ -43,12 +41,12 @@ class UniformDataHandle : public UT_JSONHandleError {
         return false;
     }
 
-    /*virtual*/ bool jsonBeginMap(UT_JSONParser& parser)
+    /*virtual*/ bool jsonBeginMap(JSONParser& parser)
     {
         return true;
     }
 
-    /*virtual*/ bool jsonEndMap(UT_JSONParser& parser)
+    /*virtual*/ bool jsonEndMap(JSONParser& parser)
     {
         return true;
     }
@@ -69,7 +67,7 @@ Poly* Poly::clone() const
     return new Poly(*this);
 }
 
-/*virtual*/ void Poly::loadData(UT_JSONParser &parser)
+/*virtual*/ void Poly::loadData(JSONParser &parser)
 {
     parseBeginArray(parser);
     {
@@ -85,7 +83,7 @@ Poly* Poly::clone() const
     parseEndArray(parser);
 }
 
-/*virtual*/ void Poly::loadVaryingData(UT_JSONParser& parser, const StringList& fields)
+/*virtual*/ void Poly::loadVaryingData(JSONParser& parser, const StringList& fields)
 {
     // NOTE: for now just support only the vertex field
     if (fields.size() != 1 || fields[0] != "vertex")
@@ -100,7 +98,7 @@ Poly* Poly::clone() const
     }
 }
 
-/*virtual*/ void Poly::loadUniformData(UT_JSONParser& parser)
+/*virtual*/ void Poly::loadUniformData(JSONParser& parser)
 {
     UniformDataHandle uniformHandle(*this);
     BGEO_CHECK(parser.parseObject(uniformHandle));
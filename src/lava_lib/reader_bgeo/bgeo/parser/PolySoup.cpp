@@ -11,8 +11,6 @@
 
 #include <cassert>
 
-#include <UT/UT_JSONHandle.h>
-
 #include "Detail.h"
 #include "ReadError.h"
 #include "util.h"
@@ -27,7 +25,7 @@ namespace parser
 namespace
 {
 
-class UniformDataHandle : public UT_JSONHandleError
+class UniformDataHandle : public JSONHandle
 {
 public:
     UniformDataHandle(PolySoup& soup)
@@ -35,18 +33,18 @@ public:
     {
     }
 
-    /*virtual*/ bool jsonKey(UT_JSONParser& parser, const char *v, int64 len)
+    /*virtual*/ bool jsonKey(JSONParser& parser, const char *v, int64 len)
     {
-        UT_String key(v);
+        std::string key(v);
         return soup.parseDataWithKey(parser, key);
     }
 
-    /*virtual*/ bool jsonBeginMap(UT_JSONParser& parser)
+    /*virtual*/ bool jsonBeginMap(JSONParser& parser)
     {
         return true;
     }
 
-    /*virtual*/ bool jsonEndMap(UT_JSONParser& parser)
+    /*virtual*/ bool jsonEndMap(JSONParser& parser)
     {
         return true;
     }
@@ -56,7 +54,7 @@ private:
 };
 
 template <typename T>
-void parseArray(UT_JSONParser& parser, std::vector<T>& data, size_t startBlockSize)
+void parseArray(JSONParser& parser, std::vector<T>& data, size_t startBlockSize)
 {
     auto iterator = parser.beginArray();
     size_t currentBlockSize = startBlockSize;
@@ -91,52 +89,50 @@ PolySoup* PolySoup::clone() const
     return new PolySoup(*this);
 }
 
-void PolySoup::loadData(UT_JSONParser& parser)
+void PolySoup::loadData(JSONParser& parser)
 {
-    UT_WorkBuffer buffer;
-    UT_String key;
+    std::string buffer;
+    std::string key;
 
     for (auto geoit = parser.beginArray(); !geoit.atEnd(); ++geoit)
     {
         geoit.getLowerKey(buffer);
-        key = buffer.buffer();
+        key = buffer;
         if (!parseDataWithKey(parser, key))
         {
-            UT_String message;
-            message.sprintf("Invalid PolySoup data: \"%s\"",
-                            key.c_str());
-            throw ReadError(message.buffer());
+            std::string message = formatMessage("Invalid PolySoup data: \"%s\"",
+                                                key.c_str());
+            throw ReadError(message);
         }
     }
 }
 
-void PolySoup::loadVaryingData(UT_JSONParser& parser,
+void PolySoup::loadVaryingData(JSONParser& parser,
                                const Primitive::StringList& fields)
 {
     parseBeginArray(parser);
     {
         for (auto& field : fields)
         {
-            if (!parseDataWithKey(parser, UT_String(field)))
+            if (!parseDataWithKey(parser, std::string(field)))
             {
-                UT_String message;
-                message.sprintf("Invalid packed geometry varying field: \"%s\"",
-                                field.c_str());
-                throw ReadError(message.buffer());
+                std::string message = formatMessage("Invalid packed geometry varying field: \"%s\"",
+                                                    field.c_str());
+                throw ReadError(message);
             }
         }
     }
     parseEndArray(parser);
 }
 
-void PolySoup::loadUniformData(UT_JSONParser& parser)
+void PolySoup::loadUniformData(JSONParser& parser)
 {
     UniformDataHandle uniformHandle(*this);
     BGEO_CHECK(parser.parseObject(uniformHandle));
 }
 
-bool PolySoup::parseDataWithKey(UT_JSONParser& parser,
-                                const UT_String& key)
+bool PolySoup::parseDataWithKey(JSONParser& parser,
+                                const std::string& key)
 {
     if (key == "vertex")
     {
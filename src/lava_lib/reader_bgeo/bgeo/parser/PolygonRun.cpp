@@ -11,8 +11,6 @@
 
 #include <cassert>
 
-#include <UT/UT_JSONHandle.h>
-
 #include "Detail.h"
 #include "ReadError.h"
 #include "util.h"
@@ -23,20 +21,20 @@ namespace parser {
 
 namespace {
 
-class UniformDataHandle : public UT_JSONHandleError {
+class UniformDataHandle : public JSONHandle {
  public:
     UniformDataHandle(PolygonRun& run): run(run) { }
 
-    /*virtual*/ bool jsonKey(UT_JSONParser& parser, const char *v, int64 len) {
-        UT_String key(v);
+    /*virtual*/ bool jsonKey(JSONParser& parser, const char *v, int64 len) {
+        std::string key(v);
         return run.parseDataWithKey(parser, key);
     }
 
-    /*virtual*/ bool jsonBeginMap(UT_JSONParser& parser) {
+    /*virtual*/ bool jsonBeginMap(JSONParser& parser) {
         return true;
     }
 
-    /*virtual*/ bool jsonEndMap(UT_JSONParser& parser) {
+    /*virtual*/ bool jsonEndMap(JSONParser& parser) {
         return true;
     }
 
@@ -45,7 +43,7 @@ private:
 };
 
 template <typename T>
-void parseArray(UT_JSONParser& parser, std::vector<T>& data, size_t startBlockSize) {
+void parseArray(JSONParser& parser, std::vector<T>& data, size_t startBlockSize) {
     auto iterator = parser.beginArray();
     size_t currentBlockSize = startBlockSize;
     size_t currentSize = 0;
@@ -73,43 +71,41 @@ PolygonRun* PolygonRun::clone() const {
     return new PolygonRun(*this);
 }
 
-void PolygonRun::loadData(UT_JSONParser& parser) {
-    UT_WorkBuffer buffer;
-    UT_String key;
+void PolygonRun::loadData(JSONParser& parser) {
+    std::string buffer;
+    std::string key;
 
     for (auto geoit = parser.beginArray(); !geoit.atEnd(); ++geoit) {
         geoit.getLowerKey(buffer);
-        key = buffer.buffer();
+        key = buffer;
         if (!parseDataWithKey(parser, key)) {
-            UT_String message;
-            message.sprintf("Invalid Polygon_run data: \"%s\"",
-                            key.c_str());
-            throw ReadError(message.buffer());
+            std::string message = formatMessage("Invalid Polygon_run data: \"%s\"",
+                                                key.c_str());
+            throw ReadError(message);
         }
     }
 }
 
-void PolygonRun::loadVaryingData(UT_JSONParser& parser, const Primitive::StringList& fields) {
+void PolygonRun::loadVaryingData(JSONParser& parser, const Primitive::StringList& fields) {
     parseBeginArray(parser);
     {
         for (auto& field : fields) {
-            if (!parseDataWithKey(parser, UT_String(field))) {
-                UT_String message;
-                message.sprintf("Invalid Polygon_run varying field: \"%s\"",
-                                field.c_str());
-                throw ReadError(message.buffer());
+            if (!parseDataWithKey(parser, std::string(field))) {
+                std::string message = formatMessage("Invalid Polygon_run varying field: \"%s\"",
+                                                    field.c_str());
+                throw ReadError(message);
             }
         }
     }
     parseEndArray(parser);
 }
 
-void PolygonRun::loadUniformData(UT_JSONParser& parser) {
+void PolygonRun::loadUniformData(JSONParser& parser) {
     UniformDataHandle uniformHandle(*this);
     BGEO_CHECK(parser.parseObject(uniformHandle));
 }
 
-bool PolygonRun::parseDataWithKey(UT_JSONParser& parser, const UT_String& key) {
+bool PolygonRun::parseDataWithKey(JSONParser& parser, const std::string& key) {
     if (key == "startvertex" || key == "s_v") {
         BGEO_CHECK(parser.parseValue(startVertex));
     }
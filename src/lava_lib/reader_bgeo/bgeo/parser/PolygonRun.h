@@ -38,12 +38,12 @@ public:
         return MergeRunMode;
     }
 
-    /*virtual*/ void loadData(UT_JSONParser &parser);
+    /*virtual*/ void loadData(JSONParser &parser);
 
-    /*virtual*/ void loadVaryingData(UT_JSONParser& parser, const StringList& fields);
-    /*virtual*/ void loadUniformData(UT_JSONParser& parser);
+    /*virtual*/ void loadVaryingData(JSONParser& parser, const StringList& fields);
+    /*virtual*/ void loadUniformData(JSONParser& parser);
 
-    bool parseDataWithKey(UT_JSONParser& parser, const UT_String& key);
+    bool parseDataWithKey(JSONParser& parser, const std::string& key);
 
 private:
     int64 startVertex;
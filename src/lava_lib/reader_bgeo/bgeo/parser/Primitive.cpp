@@ -49,7 +49,7 @@ const char* Primitive::toString(PrimType type) {
     return typeStringMap[type];
 }
 
-Primitive::PrimType Primitive::toPrimType(const UT_String& type) {
+Primitive::PrimType Primitive::toPrimType(const std::string& type) {
     for (int i = 0; i < (sizeof(typeStringMap) / sizeof(const char*)); i++) {
         if (type == typeStringMap[i]) {
             return static_cast<Primitive::PrimType>(i);
@@ -58,7 +58,7 @@ Primitive::PrimType Primitive::toPrimType(const UT_String& type) {
     return Primitive::UnknownType;
 }
 
-Primitive* Primitive::create(const UT_String& type, const Detail& detail) {
+Primitive* Primitive::create(const std::string& type, const Detail& detail) {
     if (type == "Poly")
     {
         return new Poly(detail);
@@ -103,10 +103,10 @@ Primitive* Primitive::create(const UT_String& type, const Detail& detail) {
     {
         return new Mesh(detail);
     }
-    //else if (type == "AlembicRef")
-    //{
-    //    return new AlembicRef(detail);
-    //}
+    else if (type == "AlembicRef")
+    {
+        return new AlembicRef(detail);
+    }
 
     std::cerr << "Warning: unsupported primitive type: " << type << std::endl;
     return new Primitive(detail);
@@ -131,12 +131,12 @@ Primitive* Primitive::clone() const
     return UnknownType;
 }
 
-/*virtual*/ void Primitive::loadType(UT_JSONParser& parser)
+/*virtual*/ void Primitive::loadType(JSONParser& parser)
 {
     // unknown type - rely on Primitives to eat rest of data
 }
 
-/*virtual*/ void Primitive::loadData(UT_JSONParser& parser)
+/*virtual*/ void Primitive::loadData(JSONParser& parser)
 {
     // unknown type - skip data
     BGEO_CHECK(parser.skipNextObject());
@@ -147,29 +147,29 @@ Primitive* Primitive::clone() const
     return NoRunMode;
 }
 
-/*virtual*/ void Primitive::loadVaryingData(UT_JSONParser& parser, const StringList& /*fields*/)
+/*virtual*/ void Primitive::loadVaryingData(JSONParser& parser, const StringList& /*fields*/)
 {
     // unknown type - skip data
     BGEO_CHECK(parser.skipNextObject());
 }
 
-/*virtual*/ void Primitive::loadUniformData(UT_JSONParser& parser)
+/*virtual*/ void Primitive::loadUniformData(JSONParser& parser)
 {
     // unknown type - skip data
     BGEO_CHECK(parser.skipNextObject());
 }
 
-/*virtual*/ bool Primitive::loadSharedData(UT_JSONParser& parser,
-                                           UT_String& dataType,
-                                           UT_String& dataKey)
+/*virtual*/ bool Primitive::loadSharedData(JSONParser& parser,
+                                           std::string& dataType,
+                                           std::string& dataKey)
 {
     // unknown type - don't handle it
     return false;
 }
 
 void Primitive::loadSharedData(const Primitive& source,
-                               const UT_String& dataType,
-                               const UT_String& dataKey)
+                               const std::string& dataType,
+                               const std::string& dataKey)
 {
 }
 
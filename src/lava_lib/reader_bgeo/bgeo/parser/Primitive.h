@@ -10,8 +10,8 @@
 #ifndef BGEO_PARSER_PRIMITIVE_H
 #define BGEO_PARSER_PRIMITIVE_H
 
-#include <UT/UT_JSONParser.h>
-#include <UT/UT_String.h>
+#include "JSONParser.h"
+#include <string>
 
 namespace ika {
 namespace bgeo {
@@ -36,7 +36,7 @@ class Primitive {
         MeshType
     };
     static const char* toString(PrimType type);
-    static PrimType toPrimType(const UT_String& type);
+    static PrimType toPrimType(const std::string& type);
 
     enum RunMode {
         NoRunMode = 0,
@@ -45,7 +45,7 @@ class Primitive {
         MeshRunMode
     };
 
-    static Primitive* create(const UT_String& type, const Detail& detail);
+    static Primitive* create(const std::string& type, const Detail& detail);
 
     Primitive(const Detail& detail);
     virtual ~Primitive();
@@ -56,21 +56,21 @@ class Primitive {
     virtual PrimType getType() const;
 
     // normal primitive parsing
-    virtual void loadType(UT_JSONParser& parser);
-    virtual void loadData(UT_JSONParser& parser);
+    virtual void loadType(JSONParser& parser);
+    virtual void loadData(JSONParser& parser);
 
     // for parsing within run context
     virtual RunMode getRunMode() const;
     typedef std::vector<std::string> StringList;
-    virtual void loadVaryingData(UT_JSONParser& parser, const StringList& fields);
-    virtual void loadUniformData(UT_JSONParser& parser);
+    virtual void loadVaryingData(JSONParser& parser, const StringList& fields);
+    virtual void loadUniformData(JSONParser& parser);
 
     // for parsing shared data context
-    virtual bool loadSharedData(UT_JSONParser& parser,
-                                UT_String& dataType, UT_String& dataKey);
+    virtual bool loadSharedData(JSONParser& parser,
+                                std::string& dataType, std::string& dataKey);
     virtual void loadSharedData(const Primitive& source,
-                                const UT_String& dataType,
-                                const UT_String& dataKey);
+                                const std::string& dataType,
+                                const std::string& dataKey);
 
     virtual std::ostream& encode(std::ostream& co) const;
 
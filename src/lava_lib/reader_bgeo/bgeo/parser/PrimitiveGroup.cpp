@@ -11,8 +11,6 @@
 
 #include <cassert>
 
-#include <UT/UT_JSONHandle.h>
-
 #include "util.h"
 #include "Detail.h"
 
@@ -26,7 +24,7 @@ namespace parser
 namespace
 {
 
-class BoolArrayHandle : public UT_JSONHandleError
+class BoolArrayHandle : public JSONHandle
 {
 public:
     BoolArrayHandle(std::vector<bool>& flags)
@@ -35,39 +33,37 @@ public:
     {
     }
 
-    /*virtual*/ bool jsonBool(UT_JSONParser& parser, bool value)
+    /*virtual*/ bool jsonBool(JSONParser& parser, bool value)
     {
         m_flags.push_back(value);
         return true;
     }
 
-    /*virtual*/ bool jsonInt(UT_JSONParser& parser, int64 value)
+    /*virtual*/ bool jsonInt(JSONParser& parser, int64 value)
     {
         m_flags.push_back(value);
         return true;
     }
 
-    /*virtual*/ bool jsonBeginArray(UT_JSONParser& parser)
+    /*virtual*/ bool jsonBeginArray(JSONParser& parser)
     {
         if (m_stack > 0)
         {
-            UT_String message;
-            message.sprintf("Unexpected [ at byte 0x%04lx",
-                            parser.getStreamPosition());
+            std::string message = formatMessage("Unexpected [ at byte 0x%04lx",
+                                                parser.getStreamPosition());
             throw ReadError(message);
         }
         m_stack++;
         return true;
     }
 
-    /*virtual*/ bool jsonEndArray(UT_JSONParser& parser)
+    /*virtual*/ bool jsonEndArray(JSONParser& parser)
     {
         m_stack--;
         if (m_stack < 0)
         {
-            UT_String message;
-            message.sprintf("Unexpected ] at byte 0x%04lx",
-                            parser.getStreamPosition());
+            std::string message = formatMessage("Unexpected ] at byte 0x%04lx",
+                                                parser.getStreamPosition());
             throw ReadError(message);
         }
         return true;
@@ -78,7 +74,7 @@ private:
     int m_stack;
 };
 
-class BoolRleHandle : public UT_JSONHandleError
+class BoolRleHandle : public JSONHandle
 {
 public:
     BoolRleHandle(RleVector& rle)
@@ -89,13 +85,12 @@ public:
     {
     }
 
-    /*virtual*/ bool jsonBool(UT_JSONParser& parser, bool value)
+    /*virtual*/ bool jsonBool(JSONParser& parser, bool value)
     {
         if (!m_countIsValid)
         {
-            UT_String message;
-            message.sprintf("Invalid RLE unknown count at byte 0x%04lx",
-                            parser.getStreamPosition());
+            std::string message = formatMessage("Invalid RLE unknown count at byte 0x%04lx",
+                                                parser.getStreamPosition());
             throw ReadError(message);
         }
         m_rle.push_back(std::make_pair(m_count, value));
@@ -103,7 +98,7 @@ public:
         return true;
     }
 
-    /*virtual*/ bool jsonInt(UT_JSONParser& parser, int64 value)
+    /*virtual*/ bool jsonInt(JSONParser& parser, int64 value)
     {
         if (m_countIsValid)
         {
@@ -118,27 +113,25 @@ public:
         return true;
     }
 
-    /*virtual*/ bool jsonBeginArray(UT_JSONParser& parser)
+    /*virtual*/ bool jsonBeginArray(JSONParser& parser)
     {
         if (m_stack > 0)
         {
-            UT_String message;
-            message.sprintf("Unexpected [ at byte 0x%04lx",
-                            parser.getStreamPosition());
+            std::string message = formatMessage("Unexpected [ at byte 0x%04lx",
+                                                parser.getStreamPosition());
             throw ReadError(message);
         }
         m_stack++;
         return true;
     }
 
-    /*virtual*/ bool jsonEndArray(UT_JSONParser& parser)
+    /*virtual*/ bool jsonEndArray(JSONParser& parser)
     {
         m_stack--;
         if (m_stack < 0)
         {
-            UT_String message;
-            message.sprintf("Unexpected ] at byte 0x%04lx",
-                            parser.getStreamPosition());
+            std::string message = formatMessage("Unexpected ] at byte 0x%04lx",
+                                                parser.getStreamPosition());
             throw ReadError(message);
         }
         return true;
@@ -158,7 +151,7 @@ PrimitiveGroup::PrimitiveGroup(const Detail& detail)
 {
 }
 
-void PrimitiveGroup::load(UT_JSONParser& parser)
+void PrimitiveGroup::load(JSONParser& parser)
 {
     parseBeginArray(parser);
     {
@@ -168,7 +161,7 @@ void PrimitiveGroup::load(UT_JSONParser& parser)
 
             if (detail.fileVersion.major == 13)
             {
-                UT_String type;
+                std::string type;
                 parseArrayValueForKey(parser, "type", type);
                 assert(type == "primitive");
             }
@@ -190,10 +183,10 @@ void PrimitiveGroup::load(UT_JSONParser& parser)
 
                 parseBeginArray(parser);
                 {
-                    UT_WorkBuffer buffer;
-                    UT_String type;
+                    std::string buffer;
+                    std::string type;
                     BGEO_CHECK(parser.parseValue(buffer));
-                    type = buffer.buffer();
+                    type = buffer;
 
                     if (type == "i8")
                     {
@@ -10,8 +10,8 @@
 #ifndef BGEO_PARSER_PRIMITIVE_GROUP_H
 #define BGEO_PARSER_PRIMITIVE_GROUP_H
 
-#include <UT/UT_JSONParser.h>
-#include <UT/UT_String.h>
+#include "JSONParser.h"
+#include <string>
 
 namespace ika
 {
@@ -28,9 +28,9 @@ class PrimitiveGroup
 public:
     PrimitiveGroup(const Detail& detail);
 
-    void load(UT_JSONParser& parser);
+    void load(JSONParser& parser);
 
-    UT_String name;
+    std::string name;
 
     void expandGroup(std::vector<int32_t>& indices) const;
 
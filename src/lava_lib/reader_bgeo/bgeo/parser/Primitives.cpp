@@ -12,8 +12,6 @@
 #include <iostream>
 #include <cassert>
 
-#include <UT/UT_JSONParser.h>
-
 #include "Primitive.h"
 #include "Detail.h"
 #include "Run.h"
@@ -39,10 +37,10 @@ Primitives::~Primitives()
     }
 }
 
-void Primitives::load(UT_JSONParser& parser)
+void Primitives::load(JSONParser& parser)
 {
-    UT_String type;
-    UT_JSONParser::iterator it;
+    std::string type;
+    JSONParser::iterator it;
     for (it = parser.beginArray(); !it.atEnd(); ++it)
     {
         Primitive* primitive = nullptr;
@@ -101,25 +99,25 @@ void Primitives::load(UT_JSONParser& parser)
 // ["Volume", ["geo:voxels", "voxels:0x7fd40c63a280", <voxel data> ]
 //  prim type   data type     data key
 //
-void Primitives::loadSharedData(UT_JSONParser &parser)
+void Primitives::loadSharedData(JSONParser &parser)
 {
-    UT_WorkBuffer buffer;
+    std::string buffer;
     Primitive::PrimType type;
-    UT_String dataType;
-    UT_String dataKey;
+    std::string dataType;
+    std::string dataKey;
 
     for (auto it = parser.beginArray(); !it .atEnd(); ++it)
     {
         it.getKey(buffer);
-        type = Primitive::toPrimType(buffer.buffer());
+        type = Primitive::toPrimType(buffer);
 
         parseBeginArray(parser);
         {
             BGEO_CHECK(parser.parseString(buffer));
-            dataType.harden(buffer.buffer());
+            dataType = buffer;
 
             BGEO_CHECK(parser.parseString(buffer));
-            dataKey.harden(buffer.buffer());
+            dataKey = buffer;
 
             Primitive* source = nullptr;
 
@@ -14,12 +14,11 @@
 
 #include "types.h"
 
-class UT_JSONParser;
-
 namespace ika {
 namespace bgeo {
 namespace parser {
 
+class JSONParser;
 class Detail;
 class Primitive;
 
@@ -28,8 +27,8 @@ class Primitives {
     Primitives(const Detail& detail);
     ~Primitives();
 
-    void load(UT_JSONParser& parser);
-    void loadSharedData(UT_JSONParser& parser);
+    void load(JSONParser& parser);
+    void loadSharedData(JSONParser& parser);
 
     friend std::ostream& operator << (std::ostream& co, const Primitives& primitives);
 
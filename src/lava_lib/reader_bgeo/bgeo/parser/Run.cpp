@@ -12,8 +12,6 @@
 #include <iostream>
 #include <cassert>
 
-#include <UT/UT_JSONHandle.h>
-
 #include "util.h"
 
 namespace ika {
@@ -34,20 +32,20 @@ Run::~Run() {
 
 namespace {
 
-class StringListHandle : public UT_JSONHandleError {
+class StringListHandle : public JSONHandle {
  public:
     StringListHandle(std::vector<std::string>& strings) : strings(strings) { }
 
-    /*virtual*/ bool jsonString(UT_JSONParser &p, const char *value, int64 len) {
+    /*virtual*/ bool jsonString(JSONParser &p, const char *value, int64 len) {
         strings.push_back(value);
         return true;
     }
 
-    /*virtual*/ bool jsonBeginArray(UT_JSONParser &p) {
+    /*virtual*/ bool jsonBeginArray(JSONParser &p) {
         return true;
     }
 
-    /*virtual*/ bool jsonEndArray(UT_JSONParser &p) {
+    /*virtual*/ bool jsonEndArray(JSONParser &p) {
         return true;
     }
 
@@ -57,8 +55,8 @@ private:
 
 } // namespace
 
-void Run::loadType(UT_JSONParser& parser) {
-    UT_String runTypeString;
+void Run::loadType(JSONParser& parser) {
+    std::string runTypeString;
     parseArrayValueForKey(parser, "runtype", runTypeString);
     runPrimitive = create(runTypeString, detail);
     assert(runPrimitive);
@@ -71,7 +69,7 @@ void Run::loadType(UT_JSONParser& parser) {
     runPrimitive->loadUniformData(parser);
 }
 
-void Run::loadData(UT_JSONParser &parser) {
+void Run::loadData(JSONParser &parser) {
     assert(runPrimitive);
     if (runPrimitive->getRunMode() == Primitive::MergeRunMode)
     {
@@ -12,7 +12,7 @@
 
 #include <vector>
 
-#include <UT/UT_StringArray.h>
+#include <string>
 
 #include "Primitive.h"
 #include "Primitives.h"
@@ -31,8 +31,8 @@ public:
         return RunType;
     }
 
-    /*virtual*/ void loadType(UT_JSONParser& parser);
-    /*virtual*/ void loadData(UT_JSONParser& parser);
+    /*virtual*/ void loadType(JSONParser& parser);
+    /*virtual*/ void loadData(JSONParser& parser);
     /*virtual*/ std::ostream& encode(std::ostream& co) const;
 
     Primitive* runPrimitive;
@@ -9,6 +9,8 @@
 
 #include "Sphere.h"
 
+#include <cstring>
+
 #include "util.h"
 
 #include "Attribute.h"
@@ -27,7 +29,7 @@ Sphere::Sphere(const Detail& detail)
     memset(transform, 0, sizeof(transform));
 }
 
-/*virtual*/ void Sphere::loadData(UT_JSONParser &parser)
+/*virtual*/ void Sphere::loadData(JSONParser &parser)
 {
     parseBeginArray(parser);
     {
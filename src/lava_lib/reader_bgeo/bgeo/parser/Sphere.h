@@ -29,7 +29,7 @@ public:
         return SphereType;
     }
 
-    /*virtual*/ void loadData(UT_JSONParser &parser);
+    /*virtual*/ void loadData(JSONParser &parser);
 
     /*virtual*/ std::ostream& encode(std::ostream& co) const;
 
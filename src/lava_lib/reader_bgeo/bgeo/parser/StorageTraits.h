@@ -10,7 +10,9 @@
 #ifndef PARSER_STORAGE_TRAITS_H
 #define PARSER_STORAGE_TRAITS_H
 
-#include <SYS/SYS_Types.h>
+#include <cstddef>
+
+#include "types.h"
 
 #include "storage.h"
 
@@ -11,9 +11,8 @@
 #define BGEO_PARSER_VERSION_ERROR_H
 
 #include <stdexcept>
-
-#include <UT/UT_StringArray.h>
-#include <UT/UT_WorkBuffer.h>
+#include <string>
+#include <vector>
 
 namespace ika
 {
@@ -25,31 +24,30 @@ namespace parser
 class VersionError : public std::runtime_error
 {
 public:
-    explicit VersionError(const char* message)
-        : std::runtime_error("")
-    {
-        errorString.harden(message);
-    }
-
-    explicit VersionError(UT_StringArray errors)
-        : std::runtime_error("")
+    explicit VersionError(const std::string& message)
+        : std::runtime_error(message)
     {
-        errors.join(" ", errorString);
-        errorString.insert(0, "Bgeo reader error: ");
-        errorString.hardenIfNeeded();
     }
 
-    ~VersionError() noexcept(true)
+    explicit VersionError(const std::vector<std::string>& errors)
+        : std::runtime_error(join(errors))
     {
     }
 
-    /*virtual*/ const char* what() const noexcept(true)
+private:
+    static std::string join(const std::vector<std::string>& errors)
     {
-        return errorString.buffer();
+        std::string message("Bgeo reader error: ");
+        for (size_t i = 0; i < errors.size(); ++i)
+        {
+            if (i > 0)
+            {
+                message += " ";
+            }
+            message += errors[i];
+        }
+        return message;
     }
-
-private:
-    UT_String errorString;
 };
 
 } // namespace parser
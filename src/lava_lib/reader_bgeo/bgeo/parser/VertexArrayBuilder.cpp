@@ -21,19 +21,19 @@ VertexArrayBuilder::VertexArrayBuilder(VertexArray&vertices, VertexArray& sides)
 {
 }
 
-/*virtual*/ bool VertexArrayBuilder::jsonInt(UT_JSONParser &parser, int64 value) {
+/*virtual*/ bool VertexArrayBuilder::jsonInt(JSONParser &parser, int64 value) {
     sideCount++;
     vertices.push_back(value);
     return true;
 }
 
-/*virtual*/ bool VertexArrayBuilder::jsonBeginArray(UT_JSONParser &parser) {
+/*virtual*/ bool VertexArrayBuilder::jsonBeginArray(JSONParser &parser) {
     sideCount = 0;
     stack++;
     return true;
 }
 
-/*virtual*/ bool VertexArrayBuilder::jsonEndArray(UT_JSONParser &parser) {
+/*virtual*/ bool VertexArrayBuilder::jsonEndArray(JSONParser &parser) {
     stack--;
     if (stack == 0) {
         sides.push_back(sideCount);
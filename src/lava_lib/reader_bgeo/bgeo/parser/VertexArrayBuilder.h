@@ -13,23 +13,20 @@
 #include <vector>
 
 #include "types.h"
-#include <UT/UT_JSONHandle.h>
-
-class UT_JSONHandleError;
-class UT_JSONParser;
+#include "JSONParser.h"
 
 namespace ika {
 namespace bgeo {
 namespace parser {
 
-class VertexArrayBuilder : public UT_JSONHandleError {
+class VertexArrayBuilder : public JSONHandle {
  public:
     typedef std::vector<int32> VertexArray;
     VertexArrayBuilder(VertexArray& vertices, VertexArray& sides);
 
-    /*virtual*/ bool jsonInt(UT_JSONParser& parser, int64 value);
-    /*virtual*/ bool jsonBeginArray(UT_JSONParser& parser);
-    /*virtual*/ bool jsonEndArray(UT_JSONParser& parser);
+    /*virtual*/ bool jsonInt(JSONParser& parser, int64 value);
+    /*virtual*/ bool jsonBeginArray(JSONParser& parser);
+    /*virtual*/ bool jsonEndArray(JSONParser& parser);
 
  private:
     int stack;
@@ -7,8 +7,6 @@
  *  copied, modified, or distributed except according to those terms.
  */
 
-#include <UT/UT_JSONParser.h>
-
 #include "VertexMap.h"
 
 #include "util.h"
@@ -23,7 +21,7 @@ VertexMap::~VertexMap() {
     delete[] vertices;
 }
 
-void VertexMap::load(UT_JSONParser &parser, int64 vertexCount_) {
+void VertexMap::load(JSONParser &parser, int64 vertexCount_) {
     vertexCount = vertexCount_;
     vertices = new int32[vertexCount];
 
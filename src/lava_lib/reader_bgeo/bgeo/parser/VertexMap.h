@@ -13,19 +13,18 @@
 #include <iostream>
 #include "types.h"
 
-
-class UT_JSONParser;
-
 namespace ika {
 namespace bgeo {
 namespace parser {
 
+class JSONParser;
+
 class VertexMap {
  public:    
     VertexMap();
     ~VertexMap();
 
-    void load(UT_JSONParser& parser, int64 vertexCount);
+    void load(JSONParser& parser, int64 vertexCount);
 
     const int32* getVertices() const { return vertices; };
     const int64  getVertexCount() const { return vertexCount; };
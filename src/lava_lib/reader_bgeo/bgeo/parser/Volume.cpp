@@ -9,8 +9,6 @@
 
 #include "Volume.h"
 
-#include <UT/UT_JSONHandle.h>
-
 #include "util.h"
 #include "Detail.h"
 #include "Attribute.h"
@@ -21,25 +19,25 @@ namespace parser {
 
 namespace {
 
-class UniformDataHandle : public UT_JSONHandleError {
+class UniformDataHandle : public JSONHandle {
  public:
     UniformDataHandle(Volume& volume)
         : volume(volume)
     {
     }
 
-    /*virtual*/ bool jsonKey(UT_JSONParser& parser, const char *v, int64 len)
+    /*virtual*/ bool jsonKey(JSONParser& parser, const char *v, int64 len)
     {
-        UT_String key(v);
+        std::string key(v);
         return volume.parseDataWithKey(parser, key);
     }
 
-    /*virtual*/ bool jsonBeginMap(UT_JSONParser& parser)
+    /*virtual*/ bool jsonBeginMap(JSONParser& parser)
     {
         return true;
     }
 
-    /*virtual*/ bool jsonEndMap(UT_JSONParser& parser)
+    /*virtual*/ bool jsonEndMap(JSONParser& parser)
     {
         return true;
     }
@@ -61,12 +59,10 @@ Volume::Volume(const Detail& detail)
 Volume::Volume(const Volume& volume)
     : Primitive(volume.detail),
       vertex(volume.vertex),
-      transform(volume.transform),
       compressionTolerance(volume.compressionTolerance),
       sharedVoxelKey(volume.sharedVoxelKey)
 {
-    sharedVoxelKey.harden(); // harden here to prevent referencing stale data
-                             // if the original volume goes away.
+    memcpy(transform, volume.transform, sizeof(double) * 16);
     res[0] = volume.res[0];
     res[1] = volume.res[1];
     res[2] = volume.res[2];
@@ -77,52 +73,50 @@ Volume* Volume::clone() const
     return new Volume(*this);
 }
 
-/*virtual*/ void Volume::loadData(UT_JSONParser &parser)
+/*virtual*/ void Volume::loadData(JSONParser &parser)
 {
-    UT_WorkBuffer buffer;
-    UT_String key;
+    std::string buffer;
+    std::string key;
 
     for (auto geoit = parser.beginArray(); !geoit.atEnd(); ++geoit)
     {
         geoit.getLowerKey(buffer);
-        key = buffer.buffer();
+        key = buffer;
         if (!parseDataWithKey(parser, key))
         {
-            UT_String message;
-            message.sprintf("Invalid volume data: \"%s\"",
-                            key.c_str());
-            throw ReadError(message.buffer());
+            std::string message = formatMessage("Invalid volume data: \"%s\"",
+                                                key.c_str());
+            throw ReadError(message);
         }
     }
 }
 
-void Volume::loadVaryingData(UT_JSONParser& parser,
+void Volume::loadVaryingData(JSONParser& parser,
                              const Primitive::StringList &fields)
 {
     parseBeginArray(parser);
     {
         for (auto& field : fields)
         {
-            if (!parseDataWithKey(parser, UT_String(field)))
+            if (!parseDataWithKey(parser, std::string(field)))
             {
-                UT_String message;
-                message.sprintf("Invalid volume varying field: \"%s\"",
-                                field.c_str());
-                throw ReadError(message.buffer());
+                std::string message = formatMessage("Invalid volume varying field: \"%s\"",
+                                                    field.c_str());
+                throw ReadError(message);
             }
         }
     }
     parseEndArray(parser);
 }
 
-void Volume::loadUniformData(UT_JSONParser& parser)
+void Volume::loadUniformData(JSONParser& parser)
 {
     UniformDataHandle uniformHandle(*this);
     BGEO_CHECK(parser.parseObject(uniformHandle));
 }
 
-/*virtual*/ bool Volume::loadSharedData(UT_JSONParser& parser,
-                                        UT_String& dataType, UT_String& dataKey)
+/*virtual*/ bool Volume::loadSharedData(JSONParser& parser,
+                                        std::string& dataType, std::string& dataKey)
 {
     if (dataType == "geo:voxels" && dataKey == sharedVoxelKey)
     {
@@ -135,8 +129,8 @@ void Volume::loadUniformData(UT_JSONParser& parser)
 }
 
 void Volume::loadSharedData(const Primitive& source,
-                            const UT_String& dataType,
-                            const UT_String& dataKey)
+                            const std::string& dataType,
+                            const std::string& dataKey)
 {
     if (dataType != "geo:voxels" || dataKey != sharedVoxelKey)
     {
@@ -154,20 +148,17 @@ void Volume::loadSharedData(const Primitive& source,
     voxels.copyData(sourceVolume.voxels);
 }
 
-std::ostream& operator << (std::ostream& co, const UT_VoxelArrayF& voxels)
-{
-    co << "      num tiles = " << voxels.numTiles() << "\n"
-       << "      num voxels = " << voxels.numVoxels() << "\n"
-       << "      memory usage = " << voxels.getMemoryUsage(true);
-    return co;
-}
-
 /*virtual*/ std::ostream& Volume::encode(std::ostream& co) const
 {
     Primitive::encode(co);
     co << "\n"
        << "    vertex = " << vertex << "\n"
-       << "    transform = [" << transform << "]\n"
+       << "    transform = [";
+    for (int i = 0; i < 16; ++i)
+    {
+        co << transform[i] << " ";
+    }
+    co << "]\n"
        << "    res = [" << res[0] << " " << res[1] << " " << res[2] << "]\n"
        << "    compression tolerance = " << compressionTolerance << "\n"
        << "    voxels = {\n"
@@ -199,8 +190,7 @@ void Volume::getTranslate(fpreal64 translate[3]) const
 
 void Volume::getMatrix(double matrix[16]) const
 {
-    assert(sizeof(transform) == 16 * sizeof(double));
-    memcpy(matrix, transform.data(), 16 * sizeof(double));
+    memcpy(matrix, transform, 16 * sizeof(double));
 }
 
 void Volume::getBound(double bound[6]) const
@@ -221,8 +211,8 @@ int64 Volume::getNumVoxels() const
 void Volume::flattenVoxelData(fpreal32* target, int64 targetSize) const
 {
     assert(targetSize == voxels.numVoxels());
-    voxels.flattenNoThread(target, voxels.getRes(0),
-                           voxels.getRes(0)*voxels.getRes(1));
+    voxels.flatten(target, voxels.getRes(0),
+                   voxels.getRes(0)*voxels.getRes(1));
 }
 
 void Volume::extractVoxelData(const Volume& volume, std::vector<float>& voxels)
@@ -230,10 +220,10 @@ void Volume::extractVoxelData(const Volume& volume, std::vector<float>& voxels)
     voxels.resize(volume.getNumVoxels());
     int32_t ystride = volume.res[0];
     int32_t zstride = volume.res[0] * volume.res[1];
-    volume.voxels.flattenNoThread(voxels.data(), ystride, zstride);
+    volume.voxels.flatten(voxels.data(), ystride, zstride);
 }
 
-bool Volume::parseDataWithKey(UT_JSONParser& parser, const UT_String& key)
+bool Volume::parseDataWithKey(JSONParser& parser, const std::string& key)
 {
     if (key == "vertex")
     {
@@ -241,9 +231,7 @@ bool Volume::parseDataWithKey(UT_JSONParser& parser, const UT_String& key)
     }
     else if (key == "transform")
     {
-        UT_Matrix3D m3;
-        BGEO_CHECK(m3.load(parser));
-        transform = m3;
+        parseMatrix3(parser, transform);
     }
     else if (key == "res")
     {
@@ -266,9 +254,9 @@ bool Volume::parseDataWithKey(UT_JSONParser& parser, const UT_String& key)
     }
     else if (key == "sharedvoxels")
     {
-        UT_WorkBuffer buffer;
+        std::string buffer;
         BGEO_CHECK(parser.parseValue(buffer));
-        sharedVoxelKey.harden(buffer.buffer());
+        sharedVoxelKey = buffer;
     }
     else if (key == "visualization")
     {
@@ -293,7 +281,6 @@ bool Volume::parseDataWithKey(UT_JSONParser& parser, const UT_String& key)
 void Volume::setupVoxels()
 {
     voxels.size(res[0], res[1], res[2]);
-    voxels.setCompressionTolerance(compressionTolerance);
 }
 
 } // namespace parser
@@ -11,8 +11,7 @@
 #define BGEO_PARSER_VOLUME_H
 
 #include "Primitive.h"
-#include <UT/UT_VoxelArray.h>
-#include <UT/UT_Matrix4.h>
+#include "VoxelArray.h"
 
 namespace ika
 {
@@ -39,16 +38,16 @@ public:
         return SplitRunMode;
     }
 
-    /*virtual*/ void loadData(UT_JSONParser &parser);
+    /*virtual*/ void loadData(JSONParser &parser);
 
-    /*virtual*/ void loadVaryingData(UT_JSONParser& parser, const StringList& fields);
-    /*virtual*/ void loadUniformData(UT_JSONParser& parser);
+    /*virtual*/ void loadVaryingData(JSONParser& parser, const StringList& fields);
+    /*virtual*/ void loadUniformData(JSONParser& parser);
 
-    /*virtual*/ bool loadSharedData(UT_JSONParser& parser,
-                                    UT_String& dataType, UT_String& dataKey);
+    /*virtual*/ bool loadSharedData(JSONParser& parser,
+                                    std::string& dataType, std::string& dataKey);
     /*virtual*/ void loadSharedData(const Primitive& source,
-                                    const UT_String& dataType,
-                                    const UT_String& dataKey);
+                                    const std::string& dataType,
+                                    const std::string& dataKey);
 
     /*virtual*/ std::ostream& encode(std::ostream& co) const;
 
@@ -60,17 +59,17 @@ public:
     void flattenVoxelData(fpreal32* target, int64 targetSize) const;
 
     int32 vertex;
-    UT_Matrix4D transform;
+    fpreal64 transform[16];
 
     int32 res[3];
     fpreal compressionTolerance;
-    UT_VoxelArrayF voxels; // FIXME: use a shared voxels reference for multiple volumes
-    UT_String sharedVoxelKey;
+    VoxelArray voxels; // FIXME: use a shared voxels reference for multiple volumes
+    std::string sharedVoxelKey;
 
     static void extractVoxelData(const Volume& volume, std::vector<float>& voxels);
 
     // private:
-    bool parseDataWithKey(UT_JSONParser& parser, const UT_String& key);
+    bool parseDataWithKey(JSONParser& parser, const std::string& key);
     void setupVoxels();
 };
 
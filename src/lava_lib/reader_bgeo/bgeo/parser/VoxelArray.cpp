@@ -0,0 +1,249 @@
+/*
+ *  Copyright 2018 Laika, LLC. Authored by Peter Stuart
+ *
+ *  Licensed under the Apache License, Version 2.0, <LICENSE-APACHE or
+ *  http://apache.org/licenses/LICENSE-2.0> or the MIT license <LICENSE-MIT or
+ *  http://opensource.org/licenses/MIT>, at your option. This file may not be
+ *  copied, modified, or distributed except according to those terms.
+ */
+
+#include "VoxelArray.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "JSONParser.h"
+#include "util.h"
+
+namespace ika {
+namespace bgeo {
+namespace parser {
+
+namespace {
+
+int32 tileCount(int32 res)
+{
+    return (res + VoxelArray::TileSize - 1) / VoxelArray::TileSize;
+}
+
+} // namespace
+
+VoxelArray::VoxelArray()
+{
+    res[0] = res[1] = res[2] = 0;
+}
+
+void VoxelArray::size(int32 xres, int32 yres, int32 zres)
+{
+    res[0] = std::max(xres, 0);
+    res[1] = std::max(yres, 0);
+    res[2] = std::max(zres, 0);
+    voxels.assign(numVoxels(), 0.0f);
+}
+
+int64 VoxelArray::numVoxels() const
+{
+    return static_cast<int64>(res[0]) * res[1] * res[2];
+}
+
+int64 VoxelArray::numTiles() const
+{
+    return static_cast<int64>(tileCount(res[0])) * tileCount(res[1]) * tileCount(res[2]);
+}
+
+// ["constantarray", value] or
+// ["tiledarray", ["version", 1, "compressiontypes", [...], "tiles", [...]]]
+bool VoxelArray::loadData(JSONParser& parser)
+{
+    parseBeginArray(parser);
+    {
+        std::string type;
+        BGEO_CHECK(parser.parseString(type));
+
+        if (type == "constantarray")
+        {
+            fpreal32 value;
+            BGEO_CHECK(parser.parseValue(value));
+            std::fill(voxels.begin(), voxels.end(), value);
+        }
+        else if (type == "tiledarray")
+        {
+            std::string key;
+            std::vector<std::string> compressionTypes;
+            for (auto it = parser.beginArray(); !it.atEnd(); ++it)
+            {
+                BGEO_CHECK(it.getLowerKey(key));
+                if (key == "compressiontypes")
+                {
+                    std::string compression;
+                    for (auto typeit = parser.beginArray(); !typeit.atEnd(); ++typeit)
+                    {
+                        BGEO_CHECK(parser.parseString(compression));
+                        compressionTypes.push_back(compression);
+                    }
+                }
+                else if (key == "tiles")
+                {
+                    if (!loadTiles(parser, compressionTypes))
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    BGEO_CHECK(parser.skipNextObject());
+                }
+            }
+        }
+        else
+        {
+            parser.addError("Unsupported voxel array type: " + type);
+            return false;
+        }
+    }
+    parseEndArray(parser);
+
+    return true;
+}
+
+bool VoxelArray::loadTiles(JSONParser& parser,
+                           const std::vector<std::string>& compressionTypes)
+{
+    int64 tile = 0;
+    for (auto it = parser.beginArray(); !it.atEnd(); ++it, ++tile)
+    {
+        if (tile >= numTiles())
+        {
+            parser.addError(formatMessage("Voxel array has more than %lld tiles",
+                                          static_cast<long long>(numTiles())));
+            return false;
+        }
+
+        // tiles without a compression key are raw
+        std::string compression = "raw";
+        std::string key;
+        for (auto tileit = parser.beginArray(); !tileit.atEnd(); ++tileit)
+        {
+            BGEO_CHECK(tileit.getLowerKey(key));
+            if (key == "compression")
+            {
+                int32 index;
+                BGEO_CHECK(parser.parseValue(index));
+                if (index < 0 || index >= static_cast<int32>(compressionTypes.size()))
+                {
+                    parser.addError(formatMessage("Invalid voxel tile compression %d", index));
+                    return false;
+                }
+                compression = compressionTypes[index];
+            }
+            else if (key == "data")
+            {
+                if (!loadTile(parser, tile, compression))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                BGEO_CHECK(parser.skipNextObject());
+            }
+        }
+    }
+
+    return true;
+}
+
+bool VoxelArray::loadTile(JSONParser& parser, int64 tile, const std::string& compression)
+{
+    // tiles are ordered x fastest, the last tile of each axis may be partial
+    int32 tiles[3] = { tileCount(res[0]), tileCount(res[1]), tileCount(res[2]) };
+    int32 origin[3] = {
+        static_cast<int32>(tile % tiles[0]) * TileSize,
+        static_cast<int32>((tile / tiles[0]) % tiles[1]) * TileSize,
+        static_cast<int32>(tile / (static_cast<int64>(tiles[0]) * tiles[1])) * TileSize
+    };
+    int32 tileRes[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        tileRes[axis] = std::min(TileSize, res[axis] - origin[axis]);
+    }
+
+    int64 count = static_cast<int64>(tileRes[0]) * tileRes[1] * tileRes[2];
+    int64 stride[2] = { tileRes[0], static_cast<int64>(tileRes[0]) * tileRes[1] };
+    std::vector<fpreal32> values;
+
+    if (compression == "constant")
+    {
+        values.resize(1);
+        BGEO_CHECK(parser.parseValue(values[0]));
+        stride[0] = stride[1] = 0;
+    }
+    else if (compression == "raw" || compression == "fpreal16")
+    {
+        values.resize(count);
+        BGEO_CHECK(count == parser.parseUniformArray(values.data(), count));
+    }
+    else if (compression == "rawfull")
+    {
+        const int64 fullCount = TileSize * TileSize * TileSize;
+        values.resize(fullCount);
+        BGEO_CHECK(fullCount == parser.parseUniformArray(values.data(), fullCount));
+        stride[0] = TileSize;
+        stride[1] = TileSize * TileSize;
+    }
+    else
+    {
+        parser.addError("Unsupported voxel tile compression: " + compression);
+        return false;
+    }
+
+    for (int32 z = 0; z < tileRes[2]; ++z)
+    {
+        for (int32 y = 0; y < tileRes[1]; ++y)
+        {
+            fpreal32* target = &voxels[origin[0] +
+                                       res[0] * (static_cast<int64>(origin[1] + y) +
+                                                 static_cast<int64>(res[1]) * (origin[2] + z))];
+            const fpreal32* source = &values[y * stride[0] + z * stride[1]];
+            for (int32 x = 0; x < tileRes[0]; ++x)
+            {
+                target[x] = source[stride[0] ? x : 0];
+            }
+        }
+    }
+
+    return true;
+}
+
+void VoxelArray::copyData(const VoxelArray& source)
+{
+    res[0] = source.res[0];
+    res[1] = source.res[1];
+    res[2] = source.res[2];
+    voxels = source.voxels;
+}
+
+void VoxelArray::flatten(fpreal32* target, int64 ystride, int64 zstride) const
+{
+    const fpreal32* source = voxels.data();
+    for (int32 z = 0; z < res[2]; ++z)
+    {
+        for (int32 y = 0; y < res[1]; ++y)
+        {
+            std::copy_n(source, res[0], target + y * ystride + z * zstride);
+            source += res[0];
+        }
+    }
+}
+
+std::ostream& operator << (std::ostream& co, const VoxelArray& voxels)
+{
+    co << "      num tiles = " << voxels.numTiles() << "\n"
+       << "      num voxels = " << voxels.numVoxels() << "\n"
+       << "      memory usage = " << voxels.voxels.size() * sizeof(fpreal32);
+    return co;
+}
+
+} // namespace parser
+} // namespace bgeo
+} // namespace ika
@@ -0,0 +1,65 @@
+/*
+ *  Copyright 2018 Laika, LLC. Authored by Peter Stuart
+ *
+ *  Licensed under the Apache License, Version 2.0, <LICENSE-APACHE or
+ *  http://apache.org/licenses/LICENSE-2.0> or the MIT license <LICENSE-MIT or
+ *  http://opensource.org/licenses/MIT>, at your option. This file may not be
+ *  copied, modified, or distributed except according to those terms.
+ */
+
+#ifndef BGEO_PARSER_VOXEL_ARRAY_H
+#define BGEO_PARSER_VOXEL_ARRAY_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "types.h"
+
+namespace ika
+{
+namespace bgeo
+{
+namespace parser
+{
+
+class JSONParser;
+
+// Dense float voxels loaded from the "tiledarray" and "constantarray" JSON
+// layouts Houdini volumes are saved with. Tiles are 16^3 voxels. Raw,
+// rawfull, constant and fpreal16 tiles are supported, tiles compressed with
+// a compression engine (e.g. FP32Range) fail to load.
+class VoxelArray
+{
+public:
+    static const int TileSize = 16;
+
+    VoxelArray();
+
+    void size(int32 xres, int32 yres, int32 zres);
+    int32 getRes(int axis) const { return res[axis]; }
+
+    int64 numVoxels() const;
+    int64 numTiles() const;
+
+    bool loadData(JSONParser& parser);
+    void copyData(const VoxelArray& source);
+
+    // copy voxels x fastest into target with the given y and z strides
+    void flatten(fpreal32* target, int64 ystride, int64 zstride) const;
+
+    friend std::ostream& operator << (std::ostream& co, const VoxelArray& voxels);
+
+private:
+    bool loadTiles(JSONParser& parser, const std::vector<std::string>& compressionTypes);
+    bool loadTile(JSONParser& parser, int64 tile, const std::string& compression);
+
+    int32 res[3];
+    std::vector<fpreal32> voxels;
+};
+
+} // namespace parser
+} // namespace bgeo
+} // namespace ika
+
+#endif // BGEO_PARSER_VOXEL_ARRAY_H
@@ -10,36 +10,260 @@
 #include "compression.h"
 #include "ReadError.h"
 
-#define HVERSION_MAJOR 17
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+#include "blosc.h"
+#include <zlib.h>
 
 namespace ika {
 namespace bgeo {
 namespace parser {
 
-std::unique_ptr<UT_IStream>
-getDecompressionStream(const std::string& filename, UT_IStream& stream) {
+namespace {
+
+std::string getExtension(const std::string& filename) {
     auto extpos = filename.find_last_of('.');
     if (extpos == std::string::npos) {
-        return nullptr;
+        return std::string();
+    }
+    return filename.substr(extpos + 1);
+}
+
+// Decoded data is expected to be binary or ascii json.
+bool isJSON(const std::vector<char>& data) {
+    for (char c : data) {
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            continue;
+        }
+        return c == '\x7f' || c == '[' || c == '{';
+    }
+    return false;
+}
+
+bool readBloscChunk(const char* data, size_t size, size_t offset, BloscChunk& chunk) {
+    if (size - offset < BLOSC_MIN_HEADER_LENGTH) {
+        return false;
+    }
+
+    const uint8_t* header = reinterpret_cast<const uint8_t*>(data + offset);
+    uint8_t version = header[0];
+    uint8_t typesize = header[3];
+    if (version == 0 || version > BLOSC_VERSION_FORMAT || typesize == 0) {
+        return false;
+    }
+
+    size_t nbytes = 0, cbytes = 0, blocksize = 0;
+    blosc_cbuffer_sizes(header, &nbytes, &cbytes, &blocksize);
+    if (cbytes < BLOSC_MIN_HEADER_LENGTH || cbytes > size - offset ||
+        nbytes > BLOSC_MAX_BUFFERSIZE || blocksize > std::max(nbytes, size_t(BLOSC_MIN_BUFFERSIZE)))
+    {
+        return false;
+    }
+    if (blosc_cbuffer_validate(header, cbytes, &nbytes) != 0) {
+        return false;
+    }
+
+    chunk.source = offset;
+    chunk.cbytes = cbytes;
+    chunk.nbytes = nbytes;
+    return true;
+}
+
+// Scan chunk headers up to the first invalid one. With a non zero maxBytes
+// scanning stops once that many bytes would be decoded.
+void scanBloscChunks(const char* data, size_t size, std::vector<BloscChunk>& chunks,
+                     size_t maxBytes = 0) {
+    size_t offset = 0;
+    size_t outputSize = 0;
+    BloscChunk chunk;
+    while (offset < size && readBloscChunk(data, size, offset, chunk)) {
+        chunk.destination = outputSize;
+        chunks.push_back(chunk);
+        offset += chunk.cbytes;
+        outputSize += chunk.nbytes;
+
+        if (maxBytes > 0 && outputSize >= maxBytes) {
+            break;
+        }
+    }
+}
+
+// Decode chunks [first, last) in parallel. Output must already hold them.
+void decodeBloscChunks(const char* data, const std::vector<BloscChunk>& chunks,
+                       size_t first, size_t last, std::vector<char>& output,
+                       unsigned int threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = static_cast<unsigned int>(std::min<size_t>(threadCount, last - first));
+
+    std::atomic<size_t> nextChunk(first);
+    std::atomic<bool> failed(false);
+    auto decodeChunks = [&]() {
+        for (size_t i = nextChunk++; i < last && !failed; i = nextChunk++) {
+            const BloscChunk& c = chunks[i];
+            int decoded = blosc_decompress_ctx(data + c.source, output.data() + c.destination, c.nbytes, 1);
+            if (decoded < 0 || static_cast<size_t>(decoded) != c.nbytes) {
+                failed = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < threadCount; ++i) {
+        threads.emplace_back(decodeChunks);
+    }
+    decodeChunks();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (failed) {
+        throw ReadError("Unable to decompress blosc data");
     }
+}
+
+} // anonymous namespace
+
+bool decompressBlosc(const char* data, size_t size, std::vector<char>& output,
+                     size_t maxBytes, unsigned int threadCount) {
+    std::vector<BloscChunk> chunks;
+    scanBloscChunks(data, size, chunks, maxBytes);
+    if (chunks.empty()) {
+        return false;
+    }
+
+    output.resize(chunks.back().destination + chunks.back().nbytes);
+    decodeBloscChunks(data, chunks, 0, chunks.size(), output, threadCount);
+    return true;
+}
+
+// zlib inflate state of a .gz file, compressed data is read from the file
+// as content grows.
+struct ContentReader::GzipStream {
+    z_stream stream;
+    std::vector<char> input;
+    bool initialized = false;
+    bool done = false;
+
+    GzipStream() : input(1 << 20) {
+        std::memset(&stream, 0, sizeof(stream));
+    }
+
+    ~GzipStream() {
+        if (initialized) {
+            inflateEnd(&stream);
+        }
+    }
+
+    // Inflate until content holds minBytes (everything if 0). Returns false
+    // for corrupt or truncated data.
+    bool inflateTo(std::ifstream& file, std::vector<char>& content, size_t minBytes) {
+        while (!done && (minBytes == 0 || content.size() < minBytes)) {
+            if (stream.avail_in == 0) {
+                file.read(input.data(), input.size());
+                stream.next_in = reinterpret_cast<Bytef*>(input.data());
+                stream.avail_in = static_cast<uInt>(file.gcount());
+                if (stream.avail_in == 0) {
+                    return false;
+                }
+            }
+
+            // grow geometrically to keep the number of reallocations low
+            size_t offset = content.size();
+            size_t chunk = std::min<size_t>(std::max<size_t>(offset, 1 << 20), 1u << 30);
+            content.resize(offset + chunk);
+            stream.next_out = reinterpret_cast<Bytef*>(content.data() + offset);
+            stream.avail_out = static_cast<uInt>(chunk);
+
+            int result = inflate(&stream, Z_NO_FLUSH);
+            content.resize(offset + chunk - stream.avail_out);
+            if (result == Z_STREAM_END) {
+                done = true;
+            } else if (result != Z_OK && result != Z_BUF_ERROR) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+ContentReader::ContentReader() = default;
+ContentReader::~ContentReader() = default;
+
+bool ContentReader::open(const std::string& filename) {
+    std::string extension = getExtension(filename);
+
+    m_file.open(filename, std::ios::binary | std::ios::ate);
+    if (!m_file) {
+        return false;
+    }
+    m_fileSize = static_cast<size_t>(m_file.tellg());
+    m_file.seekg(0);
 
-    std::string extension = filename.substr(extpos + 1);
     if (extension == "sc") {
-#if HVERSION_MAJOR >= 15
-        return std::unique_ptr<UT_IStream>(stream.getSCStream());
-#else // HVERSION_MAJOR < 15
-        UT_String message;
-        message.sprintf("blosc compressed files are not supported: %s", filename.c_str());
-        throw parser::ReadError(message);
-#endif // HVERSION_MAJOR > 15
+        // compressed data is read once, chunks get decoded as content grows
+        m_blosc = true;
+        m_compressed.resize(m_fileSize);
+        if (!m_file.read(m_compressed.data(), m_fileSize)) {
+            return false;
+        }
+        m_file.close();
+
+        scanBloscChunks(m_compressed.data(), m_compressed.size(), m_chunks);
+        return !m_chunks.empty();
     }
-    else if (extension == "gz") {
-        return std::unique_ptr<UT_IStream>(stream.getGzipStream());
+
+    if (extension == "gz") {
+        // 32 added to the window bits detects the gzip header
+        m_gzip.reset(new GzipStream());
+        m_gzip->initialized = inflateInit2(&m_gzip->stream, 15 + 32) == Z_OK;
+        return m_gzip->initialized;
     }
 
-    return nullptr;
+    return true;
 }
 
+bool ContentReader::grow(size_t minBytes) {
+    if (m_blosc) {
+        size_t last = m_decodedChunks;
+        while (last < m_chunks.size() &&
+               (minBytes == 0 || m_chunks[last].destination < minBytes))
+        {
+            ++last;
+        }
+        if (last > m_decodedChunks) {
+            m_content.resize(m_chunks[last - 1].destination + m_chunks[last - 1].nbytes);
+            decodeBloscChunks(m_compressed.data(), m_chunks, m_decodedChunks, last, m_content, 0);
+            m_decodedChunks = last;
+        }
+        m_complete = m_decodedChunks == m_chunks.size();
+        return isJSON(m_content);
+    }
+
+    if (m_gzip) {
+        if (!m_gzip->inflateTo(m_file, m_content, minBytes)) {
+            return false;
+        }
+        m_complete = m_gzip->done;
+        return isJSON(m_content);
+    }
+
+    size_t size = (minBytes == 0) ? m_fileSize : std::min(m_fileSize, minBytes);
+    if (size > m_content.size()) {
+        size_t offset = m_content.size();
+        m_content.resize(size);
+        if (!m_file.read(m_content.data() + offset, size - offset)) {
+            return false;
+        }
+    }
+    m_complete = m_content.size() == m_fileSize;
+    return true;
+}
 
 } // namespace parser
 } // namespace bgeo
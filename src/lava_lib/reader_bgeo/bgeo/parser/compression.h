@@ -10,10 +10,10 @@
 #ifndef BGEO_PARSER_COMPRESSION_H
 #define BGEO_PARSER_COMPRESSION_H
 
+#include <fstream>
 #include <string>
 #include <memory>
-
-#include <UT/UT_IStream.h>
+#include <vector>
 
 namespace ika
 {
@@ -22,8 +22,54 @@ namespace bgeo
 namespace parser
 {
 
-std::unique_ptr<UT_IStream> getDecompressionStream(const std::string& filename,
-                                                   UT_IStream& stream);
+// Decompress the independent blosc chunks of a .sc file in parallel.
+// Chunks are scanned up to the first invalid chunk header, so a trailing
+// seek index is ignored. With a non zero maxBytes decoding stops once that
+// many bytes are available. Returns false if data doesn't start with a
+// blosc chunk.
+bool decompressBlosc(const char* data, size_t size, std::vector<char>& output,
+                     size_t maxBytes = 0, unsigned int threadCount = 0);
+
+struct BloscChunk {
+    size_t source;
+    size_t cbytes;
+    size_t destination;
+    size_t nbytes;
+};
+
+// Decompressed file content read incrementally. The file is read once and
+// content grows on demand, blosc chunks are only decoded when they are
+// needed and gzip (.gz) data is inflated up to the requested size.
+class ContentReader {
+ public:
+    ContentReader();
+    ~ContentReader();
+
+    // Returns false for unreadable, non blosc .sc or non gzip .gz files.
+    bool open(const std::string& filename);
+
+    // Grow content to at least minBytes (whole content if 0). Returns false
+    // if the file can't be read or decoded data isn't json.
+    bool grow(size_t minBytes);
+
+    const std::vector<char>& content() const { return m_content; }
+
+    // Set when the whole content was read.
+    bool complete() const { return m_complete; }
+
+ private:
+    std::ifstream m_file;
+    size_t m_fileSize = 0;
+    bool m_blosc = false;
+    std::vector<char> m_compressed;
+    std::vector<BloscChunk> m_chunks;
+    size_t m_decodedChunks = 0;
+    std::vector<char> m_content;
+    bool m_complete = false;
+
+    struct GzipStream;
+    std::unique_ptr<GzipStream> m_gzip;
+};
 
 } // namespace parser
 } // namespace bgeo
@@ -9,7 +9,7 @@
 
 #include "storage.h"
 
-#include <UT/UT_String.h>
+#include <string>
 
 #include "StorageTraits.h"
 
@@ -43,7 +43,7 @@ uint8_t storageSizeTable[] = {
 
 Storage toStorage(const char* string)
 {
-    UT_String storage(string);
+    std::string storage(string);
     if (storage == Traits<fpreal32>::Name)
     {
         return Traits<fpreal32>::StorageId;
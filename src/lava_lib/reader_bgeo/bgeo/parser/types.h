@@ -16,6 +16,7 @@ namespace parser {
 /*
  * Integer types
  */
+typedef unsigned char   uint8;
 typedef int             int32;
 typedef unsigned int    uint32;
 
@@ -36,6 +37,13 @@ typedef unsigned int    uint32;
     typedef unsigned long long  uint64;
 #endif
 
+/*
+ * Floating point types
+ */
+typedef float           fpreal32;
+typedef double          fpreal64;
+typedef double          fpreal;
+
 } // namespace parser
 } // namespace bgeo
 } // namespace ika
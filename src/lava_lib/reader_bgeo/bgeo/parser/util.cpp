@@ -9,6 +9,9 @@
 
 #include "util.h"
 
+#include <cstdarg>
+#include <cstdio>
+
 namespace ika
 {
 namespace bgeo
@@ -16,87 +19,82 @@ namespace bgeo
 namespace parser
 {
 
-void parseMapKey(UT_JSONParser& parser, const char* key)
+std::string formatMessage(const char* format, ...)
 {
-    UT_WorkBuffer keybuffer;
-    int64 position = parser.getStreamPosition();
-    BGEO_CHECK(parser.parseKey(keybuffer));
-
-    if (keybuffer != key)
+    va_list args;
+    va_start(args, format);
+    va_list argsCopy;
+    va_copy(argsCopy, args);
+    int size = std::vsnprintf(nullptr, 0, format, argsCopy);
+    va_end(argsCopy);
+
+    std::string message(size > 0 ? size : 0, '\0');
+    if (size > 0)
     {
-        UT_String message;
-        message.sprintf("Expecting key \"%s\" at byte 0x%08lx found \"%s\"",
-                        key, position, keybuffer.buffer());
-        throw ReadError(message.buffer());
+        std::vsnprintf(&message[0], size + 1, format, args);
     }
+    va_end(args);
+    return message;
 }
 
-template <>
-void parseMapValueForKey(UT_JSONParser& parser, const char* key, UT_String& value)
+void parseMapKey(JSONParser& parser, const char* key)
 {
-    parseMapKey(parser, key);
-    UT_WorkBuffer buffer;
-    BGEO_CHECK(parser.parseValue(buffer));
-    value.harden(buffer.buffer());
-}
+    std::string keybuffer;
+    int64 position = parser.getStreamPosition();
+    BGEO_CHECK(parser.parseKey(keybuffer));
 
-template <>
-void parseMapValueForKey(UT_JSONParser& parser, const char* key, std::string& value)
-{
-    parseMapKey(parser, key);
-    UT_WorkBuffer buffer;
-    BGEO_CHECK(parser.parseValue(buffer));
-    value = buffer.toStdString();
+    if (keybuffer != key)
+    {
+        std::string message = formatMessage("Expecting key \"%s\" at byte 0x%08llx found \"%s\"",
+                                            key, static_cast<long long>(position), keybuffer.c_str());
+        throw ReadError(message);
+    }
 }
 
-void parseArrayKey(UT_JSONParser& parser, const char* key)
+void parseArrayKey(JSONParser& parser, const char* key)
 {
-    UT_WorkBuffer keybuffer;
+    std::string keybuffer;
     int64 position = parser.getStreamPosition();
     BGEO_CHECK(parser.parseString(keybuffer));
 
     if (keybuffer != key)
     {
-        UT_String message;
-        message.sprintf("Expecting key \"%s\" at byte 0x%08lx found \"%s\"",
-                        key, position, keybuffer.buffer());
-        throw ReadError(message.buffer());
+        std::string message = formatMessage("Expecting key \"%s\" at byte 0x%08llx found \"%s\"",
+                                            key, static_cast<long long>(position), keybuffer.c_str());
+        throw ReadError(message);
     }
 }
 
-template <>
-void parseArrayValueForKey(UT_JSONParser& parser, const char* key, UT_String& value)
+void parseMatrix3(JSONParser& parser, fpreal64 matrix[16])
 {
-    parseArrayKey(parser, key);
-    UT_WorkBuffer buffer;
-    BGEO_CHECK(parser.parseValue(buffer));
-    value.harden(buffer.buffer());
-}
+    fpreal64 matrix3[9];
+    BGEO_CHECK(9 == parser.parseUniformArray(matrix3, 9));
 
-template <>
-void parseArrayValueForKey(UT_JSONParser& parser, const char* key, std::string& value)
-{
-    parseArrayKey(parser, key);
-    UT_WorkBuffer buffer;
-    BGEO_CHECK(parser.parseValue(buffer));
-    value = buffer.toStdString();
+    for (int row = 0; row < 4; ++row)
+    {
+        for (int column = 0; column < 4; ++column)
+        {
+            matrix[row * 4 + column] = row < 3 && column < 3 ?
+                                       matrix3[row * 3 + column] :
+                                       row == column ? 1.0 : 0.0;
+        }
+    }
 }
 
-void parseSkipKeyAndValue(UT_JSONParser &parser)
+void parseSkipKeyAndValue(JSONParser &parser)
 {
     BGEO_CHECK(parser.skipNextObject());
     BGEO_CHECK(parser.skipNextObject());
 }
 
-void parseBeginMap(UT_JSONParser& parser)
+void parseBeginMap(JSONParser& parser)
 {
     bool error = false;
     int64 position = parser.getStreamPosition();
     if (!parser.parseBeginMap(error))
     {
-        UT_String message;
-        message.sprintf("Expecting '{' at byte 0x%08lx", position);
-        throw ReadError(message.buffer());
+        std::string message = formatMessage("Expecting '{' at byte 0x%08llx", static_cast<long long>(position));
+        throw ReadError(message);
     }
     if (error)
     {
@@ -104,15 +102,14 @@ void parseBeginMap(UT_JSONParser& parser)
     }
 }
 
-void parseEndMap(UT_JSONParser& parser)
+void parseEndMap(JSONParser& parser)
 {
     int64 position = parser.getStreamPosition();
     bool error = false;
     if (!parser.parseEndMap(error))
     {
-        UT_String message;
-        message.sprintf("Expecting '}' at byte 0x%08lx", position);
-        throw ReadError(message.buffer());
+        std::string message = formatMessage("Expecting '}' at byte 0x%08llx", static_cast<long long>(position));
+        throw ReadError(message);
     }
     if (error)
     {
@@ -120,15 +117,14 @@ void parseEndMap(UT_JSONParser& parser)
     }
 }
 
-void parseBeginArray(UT_JSONParser& parser)
+void parseBeginArray(JSONParser& parser)
 {
     int64 position = parser.getStreamPosition();
     bool error = false;
     if (!parser.parseBeginArray(error))
     {
-        UT_String message;
-        message.sprintf("Expecting '[' at byte 0x%08lx", position);
-        throw ReadError(message.buffer());
+        std::string message = formatMessage("Expecting '[' at byte 0x%08llx", static_cast<long long>(position));
+        throw ReadError(message);
     }
     if (error)
     {
@@ -136,15 +132,14 @@ void parseBeginArray(UT_JSONParser& parser)
     }
 }
 
-void parseEndArray(UT_JSONParser& parser)
+void parseEndArray(JSONParser& parser)
 {
     int64 position = parser.getStreamPosition();
     bool error = false;
     if (!parser.parseEndArray(error))
     {
-        UT_String message;
-        message.sprintf("Expecting ']' at byte 0x%08lx", position);
-        throw ReadError(message.buffer());
+        std::string message = formatMessage("Expecting ']' at byte 0x%08llx", static_cast<long long>(position));
+        throw ReadError(message);
     }
     if (error)
     {
@@ -12,7 +12,7 @@
 
 #include <string>
 
-#include <UT/UT_JSONParser.h>
+#include "JSONParser.h"
 
 #include "ReadError.h"
 
@@ -29,56 +29,55 @@ namespace parser
         throw ReadError(parser.getErrors()); \
     }
 
-void parseMapKey(UT_JSONParser& parser, const char* key);
+// printf style message for ReadError
+std::string formatMessage(const char* format, ...)
+#if defined(__GNUC__)
+    __attribute__((format(printf, 1, 2)))
+#endif
+    ;
+
+void parseMapKey(JSONParser& parser, const char* key);
 
 template <typename T>
-void parseMapValueForKey(UT_JSONParser& parser, const char* key, T& value)
+void parseMapValueForKey(JSONParser& parser, const char* key, T& value)
 {
     parseMapKey(parser, key);
     BGEO_CHECK(parser.parseValue(value));
 }
 
-template <>
-void parseMapValueForKey(UT_JSONParser& parser, const char* key, UT_String& value);
-
-template <>
-void parseMapValueForKey(UT_JSONParser& parser, const char* key, std::string& value);
-
 template <typename T>
-void parseMapValueForKey(UT_JSONParser& parser, const char* key, T* data, int64 len)
+void parseMapValueForKey(JSONParser& parser, const char* key, T* data, int64 len)
 {
     parseMapKey(parser, key);
     BGEO_CHECK(len == parser.parseUniformArray(data, len));
 }
 
-void parseArrayKey(UT_JSONParser& parser, const char* key);
+void parseArrayKey(JSONParser& parser, const char* key);
 
 template <typename T>
-void parseArrayValueForKey(UT_JSONParser& parser, const char* key, T& value)
+void parseArrayValueForKey(JSONParser& parser, const char* key, T& value)
 {
     parseArrayKey(parser, key);
     BGEO_CHECK(parser.parseValue(value));
 }
 
-template <>
-void parseArrayValueForKey(UT_JSONParser& parser, const char* key, UT_String& value);
-
-template <>
-void parseArrayValueForKey(UT_JSONParser& parser, const char* key, std::string& value);
-
 template <typename T>
-void parseArrayValueForKey(UT_JSONParser& parser, const char* key, T* data, int64 len)
+void parseArrayValueForKey(JSONParser& parser, const char* key, T* data, int64 len)
 {
     parseArrayKey(parser, key);
     BGEO_CHECK(len == parser.parseUniformArray(data, len));
 }
 
-void parseSkipKeyAndValue(UT_JSONParser& parser);
+// Read a 3x3 transform into the upper left of a row major 4x4 matrix, the
+// rest is identity.
+void parseMatrix3(JSONParser& parser, fpreal64 matrix[16]);
+
+void parseSkipKeyAndValue(JSONParser& parser);
 
-void parseBeginMap(UT_JSONParser& parser);
-void parseEndMap(UT_JSONParser& parser);
-void parseBeginArray(UT_JSONParser& parser);
-void parseEndArray(UT_JSONParser& parser);
+void parseBeginMap(JSONParser& parser);
+void parseEndMap(JSONParser& parser);
+void parseBeginArray(JSONParser& parser);
+void parseEndArray(JSONParser& parser);
 
 } // namespace parser
 } // namespace bgeo
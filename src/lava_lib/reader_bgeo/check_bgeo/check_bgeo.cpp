@@ -14,14 +14,13 @@
 #include <cmath>
 #include <vector>
 
-#include <UT/UT_JSONParser.h>
-#include <UT/UT_IStream.h>
-
 #include "bgeo/parser/Detail.h"
+#include "bgeo/parser/JSONParser.h"
 #include "bgeo/parser/ReadError.h"
 #include "bgeo/parser/Primitive.h"
 #include "bgeo/parser/Run.h"
 #include "bgeo/parser/Volume.h"
+#include "bgeo/parser/compression.h"
 namespace parser = ika::bgeo::parser;
 
 int check_filename(const std::string& filename)
@@ -35,10 +34,7 @@ int check_filename(const std::string& filename)
 
     std::string extension = filename.substr(pos + 1);
     if (extension != "bgeo" && extension != "geo" &&
-        #if HVERSION_MAJOR >= 15
-            extension != "sc" &&
-        #endif // HVERSION_MAJOR > 15
-            extension != "gz")
+        extension != "sc" && extension != "gz")
     {
         std::cerr << "Unsupported file extension [" << extension << "]\n";
         return 1;
@@ -129,14 +125,13 @@ int main(int argc, char* argv[])
     }
 
     {
-        UT_IFStream stream(argv[1], UT_ISTREAM_BINARY);
-        if (stream.isError())
+        parser::ContentReader reader;
+        if (!reader.open(argv[1]) || !reader.grow(0))
         {
             std::cerr << "Unable to read file: " << argv[1] << "\n";
             return 1;
         }
-        UT_AutoJSONParser parserLoader(stream);
-        UT_JSONParser parser = parserLoader.parser();
+        parser::JSONParser parser(reader.content().data(), reader.content().size());
         try
         {
             detail.loadGeometry(parser);
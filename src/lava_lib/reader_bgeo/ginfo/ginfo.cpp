@@ -16,10 +16,8 @@
 
 #include <hboost/timer.hpp>
 
-#include <UT/UT_JSONParser.h>
-#include <UT/UT_IStream.h>
-
 #include "bgeo/parser/Detail.h"
+#include "bgeo/parser/JSONParser.h"
 #include "bgeo/parser/compression.h"
 
 int main(int argc, char* argv[])
@@ -35,34 +33,28 @@ int main(int argc, char* argv[])
 
     // NOTE: this is split into to to mimic what the SGG does.
     {
-        UT_IFStream stream(argv[1], UT_ISTREAM_BINARY);
-        if (stream.isError())
+        ika::bgeo::parser::ContentReader reader;
+        if (!reader.open(argv[1]) || !reader.grow(0))
         {
             std::cerr << "Unable to read file: " << argv[1] << std::endl;
             return 1;
         }
 
-        auto decompStream = ika::bgeo::parser::getDecompressionStream(argv[1], stream);
-        UT_IStream* thestream = decompStream ? decompStream.get() : &stream;
-
-        UT_AutoJSONParser parserLoader(*thestream);
-        UT_JSONParser parser = parserLoader.parser();
+        ika::bgeo::parser::JSONParser parser(reader.content().data(),
+                                             reader.content().size());
         detail.loadHeaderAndInfo(parser);
     }
     {
         hboost::timer t;
-        UT_IFStream stream(argv[1], UT_ISTREAM_BINARY);
-        if (stream.isError())
+        ika::bgeo::parser::ContentReader reader;
+        if (!reader.open(argv[1]) || !reader.grow(0))
         {
             std::cerr << "Unable to read file: " << argv[1] << std::endl;
             return 1;
         }
 
-        auto decompStream = ika::bgeo::parser::getDecompressionStream(argv[1], stream);
-        UT_IStream* thestream = decompStream ? decompStream.get() : &stream;
-
-        UT_AutoJSONParser parserLoader(*thestream);
-        UT_JSONParser parser = parserLoader.parser();
+        ika::bgeo::parser::JSONParser parser(reader.content().data(),
+                                             reader.content().size());
         detail.loadGeometry(parser);
         elapsed = t.elapsed();
     }
@@ -47,6 +47,21 @@ HBOOST_AUTO_TEST_CASE(test_poly)
     HBOOST_CHECK_CLOSE(0.5, bound[5], 0.001);
 }
 
+HBOOST_AUTO_TEST_CASE(test_poly_binary)
+{
+    BgeoHeader header("geo/grid.bgeo");
+    HBOOST_CHECK_EQUAL("13.0.343", header.getFileVersion());
+    HBOOST_CHECK_EQUAL("Houdini 13.0.343", header.getSoftware());
+    HBOOST_CHECK_EQUAL("2014-08-19 10:56:57", header.getDate());
+    HBOOST_CHECK_EQUAL("     2 point attributes:\tuv, P\n", header.getAttributeSummary());
+
+    double bound[6] = { 0 };
+    header.getBoundingBox(bound);
+
+    HBOOST_CHECK_CLOSE(-0.5, bound[0], 0.001);
+    HBOOST_CHECK_CLOSE(0.5, bound[5], 0.001);
+}
+
 HBOOST_AUTO_TEST_CASE(test_bad_header)
 {
     HBOOST_CHECK_THROW(BgeoHeader("geo/badheader.geo"), parser::ReadError);
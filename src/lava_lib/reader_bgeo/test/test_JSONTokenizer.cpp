@@ -0,0 +1,159 @@
+/*
+ *  Copyright 2018 Laika, LLC. Authored by Peter Stuart
+ *
+ *  Licensed under the Apache License, Version 2.0, <LICENSE-APACHE or
+ *  http://apache.org/licenses/LICENSE-2.0> or the MIT license <LICENSE-MIT or
+ *  http://opensource.org/licenses/MIT>, at your option. This file may not be
+ *  copied, modified, or distributed except according to those terms.
+ */
+
+#include <hboost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "bgeo/parser/JSONTokenizer.h"
+
+namespace ika
+{
+namespace bgeo
+{
+namespace test_JSONTokenizer
+{
+
+using parser::JSONTokenizer;
+
+std::vector<char> readFile(const char* filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file),
+                             std::istreambuf_iterator<char>());
+}
+
+// flatten tokens to strings, uniform arrays are expanded to plain arrays so
+// that ascii and binary encodings compare equal
+std::vector<std::string> tokenize(const char* filename)
+{
+    std::vector<char> data = readFile(filename);
+    JSONTokenizer tokenizer(data.data(), data.size());
+
+    std::vector<std::string> tokens;
+    JSONTokenizer::Token token;
+    while (tokenizer.next(token))
+    {
+        switch (token.type)
+        {
+        case JSONTokenizer::BeginMapToken: tokens.push_back("{"); break;
+        case JSONTokenizer::EndMapToken: tokens.push_back("}"); break;
+        case JSONTokenizer::BeginArrayToken: tokens.push_back("["); break;
+        case JSONTokenizer::EndArrayToken: tokens.push_back("]"); break;
+        case JSONTokenizer::StringToken: tokens.push_back(token.stringValue); break;
+        case JSONTokenizer::BoolToken: tokens.push_back(token.boolValue ? "true" : "false"); break;
+        case JSONTokenizer::IntToken:
+        case JSONTokenizer::RealToken:
+            tokens.push_back(std::to_string(static_cast<float>(token.numberValue())));
+            break;
+        case JSONTokenizer::UniformArrayToken:
+        {
+            std::vector<double> values;
+            tokenizer.readNumberArray(token, values);
+            tokens.push_back("[");
+            for (double value : values)
+            {
+                tokens.push_back(std::to_string(static_cast<float>(value)));
+            }
+            tokens.push_back("]");
+            break;
+        }
+        default:
+            tokens.push_back("null");
+            break;
+        }
+    }
+    return tokens;
+}
+
+HBOOST_AUTO_TEST_CASE(test_detect_encoding)
+{
+    std::vector<char> ascii = readFile("geo/grid.geo");
+    std::vector<char> binary = readFile("geo/grid.bgeo");
+
+    HBOOST_CHECK(!JSONTokenizer(ascii.data(), ascii.size()).isBinary());
+    HBOOST_CHECK(JSONTokenizer(binary.data(), binary.size()).isBinary());
+}
+
+HBOOST_AUTO_TEST_CASE(test_grid_header)
+{
+    std::vector<std::string> tokens = tokenize("geo/grid.bgeo");
+
+    HBOOST_REQUIRE(tokens.size() > 9);
+    HBOOST_CHECK_EQUAL("[", tokens[0]);
+    HBOOST_CHECK_EQUAL("fileversion", tokens[1]);
+    HBOOST_CHECK_EQUAL("13.0.343", tokens[2]);
+    HBOOST_CHECK_EQUAL("pointcount", tokens[3]);
+    HBOOST_CHECK_EQUAL(std::to_string(4.0f), tokens[4]);
+    HBOOST_CHECK_EQUAL("]", tokens.back());
+}
+
+HBOOST_AUTO_TEST_CASE(test_ascii_and_binary_header_match)
+{
+    // attribute storage layout differs between the encodings, compare
+    // everything up to the topology
+    std::vector<std::string> ascii = tokenize("geo/grid.geo");
+    std::vector<std::string> binary = tokenize("geo/grid.bgeo");
+
+    auto asciiEnd = std::find(ascii.begin(), ascii.end(), "topology");
+    auto binaryEnd = std::find(binary.begin(), binary.end(), "topology");
+    HBOOST_REQUIRE(asciiEnd != ascii.end());
+    HBOOST_REQUIRE_EQUAL(asciiEnd - ascii.begin(), binaryEnd - binary.begin());
+
+    for (auto it = ascii.begin(), bit = binary.begin(); it != asciiEnd; ++it, ++bit)
+    {
+        // only save dates differ between the two files
+        if (it != ascii.begin() && *(it - 1) == "date")
+        {
+            continue;
+        }
+        HBOOST_CHECK_EQUAL(*it, *bit);
+    }
+}
+
+HBOOST_AUTO_TEST_CASE(test_skip_value)
+{
+    const std::string json = "[\"a\", {\"b\": [1, 2, {\"c\": 3}]}, \"d\", 4.5e1]";
+    JSONTokenizer tokenizer(json.data(), json.size());
+
+    JSONTokenizer::Token token;
+    HBOOST_REQUIRE(tokenizer.next(token));
+    HBOOST_REQUIRE(tokenizer.next(token));
+    HBOOST_CHECK_EQUAL("a", token.stringValue);
+
+    HBOOST_REQUIRE(tokenizer.next(token));
+    HBOOST_CHECK_EQUAL(JSONTokenizer::BeginMapToken, token.type);
+    tokenizer.skipValue(token);
+
+    HBOOST_REQUIRE(tokenizer.next(token));
+    HBOOST_CHECK_EQUAL("d", token.stringValue);
+    HBOOST_REQUIRE(tokenizer.next(token));
+    HBOOST_CHECK_EQUAL(JSONTokenizer::RealToken, token.type);
+    HBOOST_CHECK_CLOSE(45.0, token.realValue, 0.001);
+}
+
+HBOOST_AUTO_TEST_CASE(test_truncated_binary_should_throw)
+{
+    // cut in the middle of the "fileversion" string definition
+    std::vector<char> binary = readFile("geo/grid.bgeo");
+    binary.resize(12);
+
+    JSONTokenizer tokenizer(binary.data(), binary.size());
+    JSONTokenizer::Token token;
+    HBOOST_REQUIRE(tokenizer.next(token));
+    HBOOST_CHECK_THROW(tokenizer.next(token), JSONTokenizer::Error);
+}
+
+} // namespace test_JSONTokenizer
+} // namespace bgeo
+} // namespace ika
@@ -9,9 +9,9 @@
 
 #include <hboost/test/unit_test.hpp>
 
-#include <UT/UT_JSONParser.h>
-#include <UT/UT_IStream.h>
+#include <cstring>
 
+#include "bgeo/parser/JSONParser.h"
 #include "bgeo/parser/storage.h"
 #include "bgeo/parser/NumericData.h"
 #include "bgeo/parser/util.h"
@@ -394,9 +394,7 @@ HBOOST_AUTO_TEST_CASE(parse_one_fpreal32_tuple4)
     ] \
     ";
 
-    UT_IStream stream(one_fpreal32_tuple4, strlen(one_fpreal32_tuple4), UT_ISTREAM_ASCII);
-    UT_AutoJSONParser parserSetup(stream);
-    UT_JSONParser parser = parserSetup.parser();
+    JSONParser parser(one_fpreal32_tuple4, strlen(one_fpreal32_tuple4));
 
     NumericData nd(1);
     nd.load(parser);
@@ -415,11 +413,7 @@ HBOOST_AUTO_TEST_CASE(parse_multiple_fpreal32_tuple4)
     ] \
     ";
 
-    UT_IStream stream(multiple_fpreal32_tuple4,
-                      strlen(multiple_fpreal32_tuple4),
-                      UT_ISTREAM_ASCII);
-    UT_AutoJSONParser parserSetup(stream);
-    UT_JSONParser parser = parserSetup.parser();
+    JSONParser parser(multiple_fpreal32_tuple4, strlen(multiple_fpreal32_tuple4));
 
     NumericData nd(2);
     nd.load(parser);
@@ -441,11 +435,8 @@ HBOOST_AUTO_TEST_CASE(parse_fpreal32_packed_4_page_size_2)
     ] \
     ";
 
-    UT_IStream stream(fpreal32_packed_4_page_size_2,
-                      strlen(fpreal32_packed_4_page_size_2),
-                      UT_ISTREAM_ASCII);
-    UT_AutoJSONParser parserSetup(stream);
-    UT_JSONParser parser = parserSetup.parser();
+    JSONParser parser(fpreal32_packed_4_page_size_2,
+                      strlen(fpreal32_packed_4_page_size_2));
 
     NumericData nd(2);
     nd.load(parser);
@@ -468,11 +459,8 @@ HBOOST_AUTO_TEST_CASE(parse_fpreal32_packed_3_1_page_size_2)
     ] \
     ";
 
-    UT_IStream stream(fpreal32_packed_3_1_page_size_2,
-                      strlen(fpreal32_packed_3_1_page_size_2),
-                      UT_ISTREAM_ASCII);
-    UT_AutoJSONParser parserSetup(stream);
-    UT_JSONParser parser = parserSetup.parser();
+    JSONParser parser(fpreal32_packed_3_1_page_size_2,
+                      strlen(fpreal32_packed_3_1_page_size_2));
 
     NumericData nd(3);
     nd.load(parser);
@@ -500,11 +488,8 @@ HBOOST_AUTO_TEST_CASE(read_fpreal32_packed_1_1_1_1_page_size_2)
     ] \
     ";
 
-    UT_IStream stream(fpreal32_packed_1_1_1_1_page_size_2,
-                      strlen(fpreal32_packed_1_1_1_1_page_size_2),
-                      UT_ISTREAM_ASCII);
-    UT_AutoJSONParser parserSetup(stream);
-    UT_JSONParser parser = parserSetup.parser();
+    JSONParser parser(fpreal32_packed_1_1_1_1_page_size_2,
+                      strlen(fpreal32_packed_1_1_1_1_page_size_2));
 
     NumericData nd(3);
     nd.load(parser);
@@ -533,11 +518,8 @@ HBOOST_AUTO_TEST_CASE(read_fpreal32_packed_3_1_page_size_2_constant)
     ] \
     ";
 
-    UT_IStream stream(fpreal32_packed_3_1_page_size_2,
-                      strlen(fpreal32_packed_3_1_page_size_2),
-                      UT_ISTREAM_ASCII);
-    UT_AutoJSONParser parserSetup(stream);
-    UT_JSONParser parser = parserSetup.parser();
+    JSONParser parser(fpreal32_packed_3_1_page_size_2,
+                      strlen(fpreal32_packed_3_1_page_size_2));
 
     NumericData nd(3);
     nd.load(parser);
@@ -564,9 +546,7 @@ HBOOST_AUTO_TEST_CASE(parse_unspecified_packing_is_tuple_size)
     ] \
     ";
 
-    UT_IStream stream(json, strlen(json), UT_ISTREAM_ASCII);
-    UT_AutoJSONParser parserSetup(stream);
-    UT_JSONParser parser = parserSetup.parser();
+    JSONParser parser(json, strlen(json));
 
     NumericData nd(2);
     nd.load(parser);
@@ -603,9 +583,7 @@ HBOOST_AUTO_TEST_CASE(parse_int32_page_size_4_constant_page_1)
     ] \
     ";
 
-    UT_IStream stream(json, strlen(json), UT_ISTREAM_ASCII);
-    UT_AutoJSONParser parserSetup(stream);
-    UT_JSONParser parser = parserSetup.parser();
+    JSONParser parser(json, strlen(json));
 
     NumericData nd(10);
     nd.load(parser);
@@ -0,0 +1,113 @@
+/*
+ *  Copyright 2018 Laika, LLC. Authored by Peter Stuart
+ *
+ *  Licensed under the Apache License, Version 2.0, <LICENSE-APACHE or
+ *  http://apache.org/licenses/LICENSE-2.0> or the MIT license <LICENSE-MIT or
+ *  http://opensource.org/licenses/MIT>, at your option. This file may not be
+ *  copied, modified, or distributed except according to those terms.
+ */
+
+#include <hboost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "blosc.h"
+
+#include "bgeo/parser/compression.h"
+
+namespace ika
+{
+namespace bgeo
+{
+namespace test_compression
+{
+
+// compress data into independent blosc chunks followed by a fake seek index
+std::vector<char> compressChunks(const std::string& data, size_t chunkSize)
+{
+    std::vector<char> compressed;
+    for (size_t offset = 0; offset < data.size(); offset += chunkSize)
+    {
+        size_t size = std::min(chunkSize, data.size() - offset);
+        std::vector<char> chunk(size + BLOSC_MAX_OVERHEAD);
+        int cbytes = blosc_compress_ctx(5, BLOSC_SHUFFLE, 1, size, data.data() + offset,
+                                        chunk.data(), chunk.size(), "lz4", 0, 1);
+        HBOOST_REQUIRE(cbytes > 0);
+        compressed.insert(compressed.end(), chunk.begin(), chunk.begin() + cbytes);
+    }
+
+    const char index[] = { 0, 0, 0, 0, 'i', 'n', 'd', 'x' };
+    compressed.insert(compressed.end(), index, index + sizeof(index));
+    return compressed;
+}
+
+std::string makeData()
+{
+    std::string data = "[\"fileversion\",\"18.0.0\"";
+    for (int i = 0; data.size() < 1000000; ++i)
+    {
+        data += ",\"key" + std::to_string(i) + "\"," + std::to_string(i * 0.5);
+    }
+    return data + "]";
+}
+
+HBOOST_AUTO_TEST_CASE(test_blosc_chunks)
+{
+    std::string data = makeData();
+    std::vector<char> compressed = compressChunks(data, 65536);
+
+    std::vector<char> output;
+    HBOOST_REQUIRE(parser::decompressBlosc(compressed.data(), compressed.size(), output, 0, 4));
+    HBOOST_CHECK(std::string(output.begin(), output.end()) == data);
+}
+
+HBOOST_AUTO_TEST_CASE(test_blosc_chunks_prefix)
+{
+    std::string data = makeData();
+    std::vector<char> compressed = compressChunks(data, 65536);
+
+    std::vector<char> output;
+    HBOOST_REQUIRE(parser::decompressBlosc(compressed.data(), compressed.size(), output, 100000));
+    HBOOST_CHECK_EQUAL(size_t(2 * 65536), output.size());
+    HBOOST_CHECK(std::string(output.begin(), output.end()) == data.substr(0, output.size()));
+}
+
+HBOOST_AUTO_TEST_CASE(test_not_blosc)
+{
+    std::string data = makeData();
+
+    std::vector<char> output;
+    HBOOST_CHECK(!parser::decompressBlosc(data.data(), data.size(), output));
+}
+
+HBOOST_AUTO_TEST_CASE(test_content_reader_grows)
+{
+    std::string data = makeData();
+    std::vector<char> compressed = compressChunks(data, 65536);
+
+    const char* filename = "test_content_reader.bgeo.sc";
+    {
+        std::ofstream file(filename, std::ios::binary);
+        file.write(compressed.data(), compressed.size());
+    }
+
+    parser::ContentReader reader;
+    HBOOST_REQUIRE(reader.open(filename));
+    HBOOST_REQUIRE(reader.grow(100000));
+    HBOOST_CHECK_EQUAL(size_t(2 * 65536), reader.content().size());
+    HBOOST_CHECK(!reader.complete());
+
+    HBOOST_REQUIRE(reader.grow(0));
+    HBOOST_CHECK(reader.complete());
+    HBOOST_CHECK(std::string(reader.content().begin(), reader.content().end()) == data);
+
+    std::remove(filename);
+}
+
+} // namespace test_compression
+} // namespace bgeo
+} // namespace ika
@@ -86,7 +86,7 @@ HBOOST_AUTO_TEST_CASE(test_pack1_path)
 
     HBOOST_CHECK_EQUAL(bgeo::parser::storage::Int32,
                       attribute->getFundamentalType());
-    std::vector<int32> indices;
+    std::vector<bgeo::parser::int32> indices;
     attribute->getData(indices);
     HBOOST_CHECK_EQUAL(1, indices.size());
     HBOOST_CHECK_EQUAL(0, indices[0]);
@@ -88,7 +88,7 @@ HBOOST_AUTO_TEST_CASE(test_pack_fragments2_name)
 
     HBOOST_CHECK_EQUAL(bgeo::parser::storage::Int32,
                       attribute->getFundamentalType());
-    std::vector<int32> indices;
+    std::vector<bgeo::parser::int32> indices;
     attribute->getData(indices);
     HBOOST_CHECK_EQUAL(2, indices.size());
     HBOOST_CHECK_EQUAL(0, indices[0]);
@@ -108,7 +108,7 @@ HBOOST_AUTO_TEST_CASE(test_pack_fragments2_path)
 
     HBOOST_CHECK_EQUAL(bgeo::parser::storage::Int32,
                       attribute->getFundamentalType());
-    std::vector<int32> indices;
+    std::vector<bgeo::parser::int32> indices;
     attribute->getData(indices);
     HBOOST_CHECK_EQUAL(2, indices.size());
     HBOOST_CHECK_EQUAL(0, indices[0]);
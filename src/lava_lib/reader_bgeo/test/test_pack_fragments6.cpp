@@ -96,10 +96,10 @@ HBOOST_AUTO_TEST_CASE(test_pack_fragments6_name)
 
     HBOOST_CHECK_EQUAL(bgeo::parser::storage::Int32,
                       attribute->getFundamentalType());
-    std::vector<int32> indices;
+    std::vector<bgeo::parser::int32> indices;
     attribute->getData(indices);
 
-    std::vector<int32> expected_indices = {
+    std::vector<bgeo::parser::int32> expected_indices = {
         0, 1, 2, 3, 4, 5
     };
     HBOOST_CHECK_EQUAL_COLLECTIONS(expected_indices.begin(),
@@ -128,10 +128,10 @@ HBOOST_AUTO_TEST_CASE(test_pack_fragments6_path)
 
     HBOOST_CHECK_EQUAL(bgeo::parser::storage::Int32,
                       attribute->getFundamentalType());
-    std::vector<int32> indices;
+    std::vector<bgeo::parser::int32> indices;
     attribute->getData(indices);
 
-    std::vector<int32> expected_indices = {
+    std::vector<bgeo::parser::int32> expected_indices = {
         0, 1, 2, 3, 4, 5
     };
     HBOOST_CHECK_EQUAL_COLLECTIONS(expected_indices.begin(),
@@ -3,6 +3,7 @@
 
 #include <array>
 #include <memory>
+#include <cstring>
 #include <string>
 #include <algorithm>
 #include <iostream>
@@ -39,6 +40,7 @@
 
 #include "grammar_bgeo.h"
 #include "grammar_lsd_expr.h"
+#include "grammar_lsd_numeric.h"
 
 #include "../display.h"
 
@@ -125,7 +127,7 @@ namespace ast {
     enum class Type { FLOAT, BOOL, INT, INT2, INT3, INT4, VECTOR2, VECTOR3, VECTOR4, MATRIX3, MATRIX4, STRING, UNKNOWN };
     enum class Style { GLOBAL, MATERIAL, NODE, GEO, GEOMETRY, SEGMENT, CAMERA, LIGHT, FOG, OBJECT, INSTANCE, PLANE, IMAGE, RENDERER, UNKNOWN };
     enum class EmbedDataType { TEXTURE, UNKNOWN };
-    enum class EmbedDataEncoding { UUENCODED, UNKNOWN };
+    enum class EmbedDataEncoding { UUENCODED, BASE64, UNKNOWN };
     enum class IPRMode { GENERATE, UPDATE };
 
     typedef lava::Display::DisplayType DisplayType;
@@ -591,35 +593,35 @@ namespace parser {
     BOOST_SPIRIT_DEFINE(any_filename)
 
     x3::rule<class int2_, Int2> const int2 = "int2";
-    auto const int2_def = repeat(2) [ int_ ];
+    auto const int2_def = numeric::fixed_array<Int2, 2>() | repeat(2) [ int_ ];
     BOOST_SPIRIT_DEFINE(int2)
 
     x3::rule<class int3_, Int3> const int3 = "int3";
-    auto const int3_def = repeat(3) [ int_ ];
+    auto const int3_def = numeric::fixed_array<Int3, 3>() | repeat(3) [ int_ ];
     BOOST_SPIRIT_DEFINE(int3)
 
     x3::rule<class int4_, Int4> const int4 = "int4";
-    auto const int4_def = repeat(4) [ int_ ];
+    auto const int4_def = numeric::fixed_array<Int4, 4>() | repeat(4) [ int_ ];
     BOOST_SPIRIT_DEFINE(int4)
 
     x3::rule<class vector2_, Vector2> const vector2 = "vector2";
-    auto const vector2_def = repeat(2) [ double_ | int_ ];
+    auto const vector2_def = numeric::fixed_array<Vector2, 2>() | repeat(2) [ double_ | int_ ];
     BOOST_SPIRIT_DEFINE(vector2)
 
     x3::rule<class vector3_, Vector3> const vector3 = "vector3";
-    auto const vector3_def = repeat(3) [ double_ | int_ ];
+    auto const vector3_def = numeric::fixed_array<Vector3, 3>() | repeat(3) [ double_ | int_ ];
     BOOST_SPIRIT_DEFINE(vector3)
 
     x3::rule<class vector4_, Vector4> const vector4 = "vector4";
-    auto const vector4_def = repeat(4) [ double_ | int_ ];
+    auto const vector4_def = numeric::fixed_array<Vector4, 4>() | repeat(4) [ double_ | int_ ];
     BOOST_SPIRIT_DEFINE(vector4)
 
     x3::rule<class matrix3_, Matrix3> const matrix3 = "matrix3";
-    auto const matrix3_def = repeat(9) [ double_ | int_ ];
+    auto const matrix3_def = numeric::fixed_array<Matrix3, 9>() | repeat(9) [ double_ | int_ ];
     BOOST_SPIRIT_DEFINE(matrix3)
 
     x3::rule<class matrix4_, Matrix4> const matrix4 = "matrix4";
-    auto const matrix4_def = repeat(16) [ double_ | int_ ];
+    auto const matrix4_def = numeric::fixed_array<Matrix4, 16>() | repeat(16) [ double_ | int_ ];
     BOOST_SPIRIT_DEFINE(matrix4)
 
     x3::rule<class version_, Version> const version = "version";
@@ -652,8 +654,86 @@ namespace parser {
         | lit("cmd_version") | lit("cmd_defaults") | lit("cmd_declare") | lit("cmd_config") | lit("cmd_mtransform") | lit("cmd_reset") | lit("cmd_iprmode") | lit("ray_embeddedfile")
         | lit("cmd_edge") | lit("cmd_procedural");
 
+    /** Property values list. Runs of plain numbers are read in bulk and grouped exactly like repeated prop_value would
+     *  group them (vector4 as long as there are 4 numbers left, then vector3, vector2, double or int), everything else
+     *  goes through 'subject'. A run followed by something that still may parse as a number (or a comment) only takes
+     *  it's complete vector4 groups and leaves the rest to 'subject'.
+     */
+    template <typename Subject>
+    struct prop_values_parser : x3::parser<prop_values_parser<Subject>> {
+        using attribute_type = std::vector<PropValue>;
+        static bool const has_attribute = true;
+
+        prop_values_parser(Subject const& subject): subject(subject) {}
+
+        template <typename Iterator, typename Context, typename RContext, typename Attribute>
+        bool parse(Iterator& first, Iterator const& last, Context const& context, RContext const& rcontext, Attribute& attr) const {
+            while (true) {
+                if (parseNumbers(first, last, context, attr)) continue;
+
+                Iterator save = first;
+                PropValue value;
+                if (!subject.parse(first, last, context, rcontext, value)) {
+                    first = save;
+                    break;
+                }
+                attr.push_back(std::move(value));
+            }
+            return true;
+        }
+
+        template <typename Iterator, typename Context, typename Attribute>
+        bool parseNumbers(Iterator& first, Iterator const& last, Context const& context, Attribute& attr) const {
+            Iterator it = first;
+            x3::skip_over(it, last, context);
+
+            const char* pBegin = numeric::rangeBegin(it, last);
+            const char* pEnd = pBegin + std::distance(it, last);
+            const char* p = pBegin;
+            const char* pGroupEnd = pBegin;
+
+            numeric::Token tokens[4];
+            size_t count = 0;
+            size_t groupsCount = 0;
+            while (p != pEnd) {
+                const char* pNext = numeric::scanToken(p, pEnd, tokens[count]);
+                if (!pNext) break;
+                p = numeric::skipBlanks(pNext, pEnd);
+                if (++count == 4) {
+                    attr.push_back(PropValue(Vector4{tokens[0].value, tokens[1].value, tokens[2].value, tokens[3].value}));
+                    pGroupEnd = pNext;
+                    groupsCount++;
+                    count = 0;
+                }
+            }
+
+            const bool mayContinue = (p != pEnd) && (numeric::isDigit(*p) || std::strchr("+-.iInN/#", *p));
+            if (count > 0 && !mayContinue) {
+                switch (count) {
+                    case 3: attr.push_back(PropValue(Vector3{tokens[0].value, tokens[1].value, tokens[2].value})); break;
+                    case 2: attr.push_back(PropValue(Vector2{tokens[0].value, tokens[1].value})); break;
+                    default: 
+                        if (tokens[0].kind == numeric::TokenKind::REAL) {
+                            attr.push_back(PropValue(tokens[0].value));
+                        } else {
+                            attr.push_back(PropValue(tokens[0].intValue));
+                        }
+                        break;
+                }
+                first = it + (p - pBegin);
+                return true;
+            }
+
+            if (groupsCount == 0) return false;
+            first = it + (pGroupEnd - pBegin);
+            return true;
+        }
+
+        Subject subject;
+    };
+
     x3::rule<class prop_values_, std::vector<PropValue>> const prop_values = "prop_values";
-    auto const prop_values_def = *(prop_value - keyword);
+    auto const prop_values_def = prop_values_parser<decltype(prop_value - keyword)>(prop_value - keyword);
     BOOST_SPIRIT_DEFINE(prop_values)
 
     x3::rule<class prop_values_array_, std::vector<std::pair<std::string, PropValue>>> const prop_values_array = "prop_values_array";
@@ -800,6 +880,7 @@ namespace parser {
     struct EmbeddedDataEncodingTable : x3::symbols<ast::EmbedDataEncoding> {
         EmbeddedDataEncodingTable() {
             add ("binary-uu"   , ast::EmbedDataEncoding::UUENCODED);
+            add ("binary-base64"   , ast::EmbedDataEncoding::BASE64);
         }
     } const embedded_data_encoding;
 
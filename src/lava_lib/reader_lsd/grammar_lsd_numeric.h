@@ -0,0 +1,135 @@
+#ifndef SRC_LAVA_LIB_GRAMMAR_LSD_NUMERIC_H_
+#define SRC_LAVA_LIB_GRAMMAR_LSD_NUMERIC_H_
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+#include "boost/spirit/home/x3.hpp"
+
+namespace x3 = boost::spirit::x3;
+
+namespace lava {
+
+namespace lsd {
+
+namespace numeric {
+
+    enum class TokenKind { NONE, INT, REAL };
+
+    struct Token {
+        TokenKind   kind = TokenKind::NONE;
+        int         intValue = 0;
+        double      value = 0.0;
+    };
+
+    static inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+    static inline bool isBlank(char c) { return c == ' ' || c == '\t'; }
+    static inline bool isTokenEnd(char c) { return isBlank(c) || c == '\r' || c == '\n'; }
+
+    /** Scan single numeric token starting at 'first'. Only plain tokens that generic 'double_ | int_' rules read the same
+     *  way are accepted: sign and digits fitting an int, or sign, digits with a dot and optional exponent for reals.
+     *  Token has to be followed by a blank, line end or end of input. The scanned span is converted with the same X3 parsers
+     *  the generic rules use, so values are bit identical to theirs.
+     *  \return Pointer past the token or nullptr if it's not a plain number.
+     */
+    static inline const char* scanToken(const char* first, const char* last, Token& token) {
+        const char* p = first;
+        if (p != last && (*p == '+' || *p == '-')) p++;
+
+        const char* pDigits = p;
+        while (p != last && isDigit(*p)) p++;
+        size_t digitsCount = p - pDigits;
+
+        bool hasDot = false;
+        if (p != last && *p == '.') {
+            hasDot = true;
+            const char* pFraction = ++p;
+            while (p != last && isDigit(*p)) p++;
+            digitsCount += p - pFraction;
+        }
+        if (digitsCount == 0) return nullptr;
+
+        if (p != last && (*p == 'e' || *p == 'E')) {
+            // Strict real parser expects a dot, while int parser stops right before the exponent
+            if (!hasDot) return nullptr;
+            p++;
+            if (p != last && (*p == '+' || *p == '-')) p++;
+            const char* pExponent = p;
+            while (p != last && isDigit(*p)) p++;
+            if (p == pExponent) return nullptr;
+        }
+
+        if (p != last && !isTokenEnd(*p)) return nullptr;
+
+        const char* pSpan = first;
+        if (hasDot) {
+            static x3::real_parser<double, x3::strict_real_policies<double>> const strict_double = {};
+            if (!x3::parse(pSpan, p, strict_double, token.value) || pSpan != p) return nullptr;
+            token.kind = TokenKind::REAL;
+        } else {
+            if (!x3::parse(pSpan, p, x3::int_, token.intValue) || pSpan != p) return nullptr;
+            token.kind = TokenKind::INT;
+            token.value = static_cast<double>(token.intValue);
+        }
+        return p;
+    }
+
+    static inline const char* skipBlanks(const char* p, const char* last) {
+        while (p != last && isBlank(*p)) p++;
+        return p;
+    }
+
+    /** Contiguous character range of [first, last). LSD lines are parsed from std::string, so input is always contiguous.
+     */
+    template <typename Iterator>
+    static inline const char* rangeBegin(Iterator const& first, Iterator const& last) {
+        static_assert(std::is_same<typename std::iterator_traits<Iterator>::iterator_category, std::random_access_iterator_tag>::value,
+            "Bulk numeric parsers need contiguous input");
+        return (first == last) ? nullptr : std::addressof(*first);
+    }
+
+    /** Fixed size array of N plain numbers read straight into the container attribute. Fails without consuming input if any
+     *  of the N tokens is not a plain number (or not an int for int containers), so it is meant to be followed by the generic
+     *  rule as an alternative, e.g. 'numeric::fixed_array<Vector3, 3>() | repeat(3) [ double_ | int_ ]'.
+     */
+    template <typename Container, size_t N>
+    struct fixed_array : x3::parser<fixed_array<Container, N>> {
+        using attribute_type = Container;
+        using value_type = typename Container::value_type;
+        static bool const has_attribute = true;
+
+        template <typename Iterator, typename Context, typename RContext, typename Attribute>
+        bool parse(Iterator& first, Iterator const& last, Context const& context, RContext const&, Attribute& attr) const {
+            Iterator it = first;
+            x3::skip_over(it, last, context);
+
+            const char* pBegin = rangeBegin(it, last);
+            const char* pEnd = pBegin + std::distance(it, last);
+            const char* p = pBegin;
+
+            value_type values[N];
+            for (size_t i = 0; i < N; i++) {
+                if (i > 0) p = skipBlanks(p, pEnd);
+                Token token;
+                const char* pNext = (p == pEnd) ? nullptr : scanToken(p, pEnd, token);
+                if (!pNext) return false;
+                if (std::is_integral<value_type>::value && token.kind != TokenKind::INT) return false;
+                values[i] = std::is_integral<value_type>::value ? static_cast<value_type>(token.intValue) : static_cast<value_type>(token.value);
+                p = pNext;
+            }
+
+            for (size_t i = 0; i < N; i++) x3::traits::push_back(attr, values[i]);
+            first = it + (p - pBegin);
+            return true;
+        }
+    };
+
+}  // namespace numeric
+
+}  // namespace lsd
+
+}  // namespace lava
+
+#endif  // SRC_LAVA_LIB_GRAMMAR_LSD_NUMERIC_H_
@@ -1,6 +1,11 @@
 #include <variant>
 #include <map>
 #include <string>
+#include <deque>
+#include <algorithm>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 
 #include "Falcor/Utils/Math/Vector.h"
 
@@ -13,6 +18,68 @@ namespace lava {
 
 namespace lsd {
 
+namespace {
+
+struct PropertyAtomTable {
+    std::shared_mutex                                   mutex;
+    std::unordered_map<std::string, PropertyAtom::Id>   ids;
+    std::deque<std::string>                             names{ std::string() }; // index 0 reserved for invalid atom
+};
+
+PropertyAtomTable& atomTable() {
+    static PropertyAtomTable table;
+    return table;
+}
+
+}  // namespace
+
+PropertyAtom::PropertyAtom(const std::string& name) {
+    auto& table = atomTable();
+    {
+        std::shared_lock<std::shared_mutex> lock(table.mutex);
+        auto it = table.ids.find(name);
+        if (it != table.ids.end()) {
+            mId = it->second;
+            mpName = &table.names[mId];
+            return;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(table.mutex);
+    auto it = table.ids.emplace(name, static_cast<Id>(table.names.size())).first;
+    if (it->second == table.names.size()) {
+        table.names.push_back(name);
+    }
+    mId = it->second;
+    mpName = &table.names[mId];
+}
+
+PropertyAtom PropertyAtom::find(const std::string& name) {
+    auto& table = atomTable();
+    std::shared_lock<std::shared_mutex> lock(table.mutex);
+    auto it = table.ids.find(name);
+    return (it != table.ids.end()) ? PropertyAtom(it->second, &table.names[it->second]) : PropertyAtom();
+}
+
+const std::string& PropertyAtom::name() const {
+    // deque never relocates it's elements on push_back so the cached name pointer stays valid
+    static const std::string kInvalidName;
+    return mpName ? *mpName : kInvalidName;
+}
+
+Property::Property(const Property &prop): mType(prop.mType), mValue(prop.mValue), mOwner(prop.mOwner) {
+    if (prop.mpSubContainer) mpSubContainer = std::make_shared<PropertiesContainer>(*prop.mpSubContainer);
+}
+
+Property& Property::operator=(const Property& prop) {
+    if (this == &prop) return *this;
+    mType = prop.mType;
+    mValue = prop.mValue;
+    mOwner = prop.mOwner;
+    mpSubContainer = prop.mpSubContainer ? std::make_shared<PropertiesContainer>(*prop.mpSubContainer) : nullptr;
+    return *this;
+}
+
 std::shared_ptr<PropertiesContainer> Property::createSubContainer() {
     if(mpSubContainer) {
         LLOG_WRN << "Sub-container already exist for property !"; 
@@ -201,10 +268,28 @@ bool Property::set(const Value& value) {
     return false;
 }
 
+PropertiesContainer::PropertiesMap::iterator PropertiesContainer::findLocal(const PropertyKey& key) {
+    auto it = std::lower_bound(mPropertiesMap.begin(), mPropertiesMap.end(), key, [](const auto& item, const PropertyKey& k) { return item.first < k; });
+    return (it != mPropertiesMap.end() && it->first == key) ? it : mPropertiesMap.end();
+}
+
+PropertiesContainer::PropertiesMap::const_iterator PropertiesContainer::findLocal(const PropertyKey& key) const {
+    auto it = std::lower_bound(mPropertiesMap.begin(), mPropertiesMap.end(), key, [](const auto& item, const PropertyKey& k) { return item.first < k; });
+    return (it != mPropertiesMap.end() && it->first == key) ? it : mPropertiesMap.end();
+}
+
+PropertiesContainer::PropertiesMap::iterator PropertiesContainer::insertLocal(PropertyKey key, Property&& prop) {
+    auto it = std::lower_bound(mPropertiesMap.begin(), mPropertiesMap.end(), key, [](const auto& item, const PropertyKey& k) { return item.first < k; });
+    return mPropertiesMap.emplace(it, std::move(key), std::move(prop));
+}
+
 bool PropertiesContainer::declareProperty(ast::Style style, Property::Type type, const std::string& name, const Property::Value& value, Property::Owner owner) {
-    auto propKey = PropertyKey(style, name);
-    const PropertiesMap::iterator it = mPropertiesMap.find(propKey);
-    if (it != mPropertiesMap.end()) {
+    return declareProperty(style, type, PropertyAtom(name), value, owner);
+}
+
+bool PropertiesContainer::declareProperty(ast::Style style, Property::Type type, PropertyAtom atom, const Property::Value& value, Property::Owner owner) {
+    auto propKey = PropertyKey(style, atom);
+    if (findLocal(propKey) != mPropertiesMap.end()) {
         LLOG_ERR << "Property \"" << to_string(propKey) << "\" declared already!!!";
         return false;
     }
@@ -215,21 +300,26 @@ bool PropertiesContainer::declareProperty(ast::Style style, Property::Type type,
         return false;
     }
 
-    mPropertiesMap.insert(std::pair<PropertyKey, Property>(std::move(propKey), std::move(prop)));
+    insertLocal(propKey, std::move(prop));
     return true;
 }
 
 bool PropertiesContainer::setProperty(ast::Style style, const std::string& name, const Property::Value& value) {
-    auto propKey = PropertyKey(style, name);
-    PropertiesMap::iterator it = mPropertiesMap.find(propKey);
+    return setProperty(style, PropertyAtom(name), value);
+}
+
+bool PropertiesContainer::setProperty(ast::Style style, PropertyAtom atom, const Property::Value& value) {
+    auto propKey = PropertyKey(style, atom);
+    auto it = findLocal(propKey);
     if (it == mPropertiesMap.end()) {
         // property does not exist. declare it here as a user property
-        if(!declareProperty(style, valueType(value), name, value, Property::Owner::USER)) {
+        Property prop;
+        if (!Property::create(valueType(value), value, prop, Property::Owner::USER)) {
             LLOG_WRN << "Error declaring user property \"" << to_string(propKey) << "\" !!!";
             return false;
         }
 
-        it = mPropertiesMap.find(propKey);
+        it = insertLocal(propKey, std::move(prop));
     }
 
     if (!it->second.set(value)) {
@@ -241,137 +331,145 @@ bool PropertiesContainer::setProperty(ast::Style style, const std::string& name,
 }
 
 Property* PropertiesContainer::getProperty(ast::Style style, const std::string& name) {
-    auto it = mPropertiesMap.find(PropertyKey(style, name));
-    if (it == mPropertiesMap.end()) {
-        if( mpParent ) {
-            return mpParent->getProperty(style, name);
-        }
-        return nullptr;
-    }
-    return &it->second;
+    // names that were never interned can't be declared anywhere in the scope chain
+    return getProperty(style, PropertyAtom::find(name));
 }
 
 const Property* PropertiesContainer::getProperty(ast::Style style, const std::string& name) const {
-    auto it = mPropertiesMap.find(PropertyKey(style, name));
-    if (it == mPropertiesMap.end()) {
-        if( mpParent ) {
-            return mpParent->getProperty(style, name);
-        }
-        return nullptr;
+    return getProperty(style, PropertyAtom::find(name));
+}
+
+Property* PropertiesContainer::getProperty(ast::Style style, PropertyAtom atom) {
+    if (!atom.isValid()) return nullptr;
+
+    const PropertyKey propKey(style, atom);
+    for (PropertiesContainer* pContainer = this; pContainer; pContainer = pContainer->mpParent.get()) {
+        auto it = pContainer->findLocal(propKey);
+        if (it != pContainer->mPropertiesMap.end()) return &it->second;
     }
-    return &it->second;
+    return nullptr;
+}
+
+const Property* PropertiesContainer::getProperty(ast::Style style, PropertyAtom atom) const {
+    if (!atom.isValid()) return nullptr;
+
+    const PropertyKey propKey(style, atom);
+    for (const PropertiesContainer* pContainer = this; pContainer; pContainer = pContainer->mpParent.get()) {
+        auto it = pContainer->findLocal(propKey);
+        if (it != pContainer->mPropertiesMap.end()) return &it->second;
+    }
+    return nullptr;
 }
 
 const Property::Value& PropertiesContainer::_getPropertyValue(ast::Style style, const std::string& name, const  Property::Value& default_value) const {
     auto pProperty = getProperty(style, name);
     
     if(!pProperty)
-        LLOG_DBG << "Can't find property " << to_string(PropertyKey(style, name)) << " ! Returning default value...";
+        LLOG_DBG << "Can't find property " << name << " ! Returning default value...";
         return default_value;
 
     if(!checkValueTypeStrict(pProperty->type(), default_value)) {
-        LLOG_WRN << "Property " << to_string(PropertyKey(style, name)) << " type and default_value type does not match !!!";
+        LLOG_WRN << "Property " << name << " type and default_value type does not match !!!";
     }
 
     return pProperty->value();
 }
 
 template<>
-const Int2 PropertiesContainer::getPropertyValue(ast::Style style, const std::string& name, const Int2& default_value) const {
-    auto pProperty = getProperty(style, name);
+const Int2 PropertiesContainer::getPropertyValue(ast::Style style, PropertyAtom atom, const Int2& default_value) const {
+    auto pProperty = getProperty(style, atom);
     if(pProperty) return pProperty->get<Int2>();
-    LLOG_TRC << "Property '" << name << "' of style '" << to_string(style) << "'' doesn't exist. Returning default value "<< to_string(default_value);
+    LLOG_TRC << "Property '" << atom.name() << "' of style '" << to_string(style) << "'' doesn't exist. Returning default value "<< to_string(default_value);
     return default_value;
 }
 
 template<>
-const Int3 PropertiesContainer::getPropertyValue(ast::Style style, const std::string& name, const Int3& default_value) const {
-    auto pProperty = getProperty(style, name);
+const Int3 PropertiesContainer::getPropertyValue(ast::Style style, PropertyAtom atom, const Int3& default_value) const {
+    auto pProperty = getProperty(style, atom);
     if(pProperty) return pProperty->get<Int3>();
-    LLOG_TRC << "Property '" << name << "' of style '" << to_string(style) << "'' doesn't exist. Returning default value "<< to_string(default_value);
+    LLOG_TRC << "Property '" << atom.name() << "' of style '" << to_string(style) << "'' doesn't exist. Returning default value "<< to_string(default_value);
     return default_value;
 }
 
 template<>
-const Int4 PropertiesContainer::getPropertyValue(ast::Style style, const std::string& name, const Int4& default_value) const {
-    auto pProperty = getProperty(style, name);
+const Int4 PropertiesContainer::getPropertyValue(ast::Style style, PropertyAtom atom, const Int4& default_value) const {
+    auto pProperty = getProperty(style, atom);
     if(pProperty) return pProperty->get<Int4>();
-    LLOG_TRC << "Property '" << name << "' of style '" << to_string(style) << "'' doesn't exist. Returning default value "<< to_string(default_value);
+    LLOG_TRC << "Property '" << atom.name() << "' of style '" << to_string(style) << "'' doesn't exist. Returning default value "<< to_string(default_value);
     return default_value;
 }
 
 template<>
-const Vector2 PropertiesContainer::getPropertyValue(ast::Style style, const std::string& name, const Vector2& default_value) const {
-    auto pProperty = getProperty(style, name);
+const Vector2 PropertiesContainer::getPropertyValue(ast::Style style, PropertyAtom atom, const Vector2& default_value) const {
+    auto pProperty = getProperty(style, atom);
     if(pProperty) return pProperty->get<Vector2>();
-    LLOG_TRC << "Property '" << name << "' of style '" << to_string(style) << "'' doesn't exist. Returning default value "<< to_string(default_value);
+    LLOG_TRC << "Property '" << atom.name() << "' of style '" << to_string(style) << "'' doesn't exist. Returning default value "<< to_string(default_value);
     return default_value;
 }
 
 template<>
-const Vector3 PropertiesContainer::getPropertyValue(ast::Style style, const std::string& name, const Vector3& default_value) const {
-    auto pProperty = getProperty(style, name);
+const Vector3 PropertiesContainer::getPropertyValue(ast::Style style, PropertyAtom atom, const Vector3& default_value) const {
+    auto pProperty = getProperty(style, atom);
     if(pProperty) return pProperty->get<Vector3>();
-    LLOG_TRC << "Property '" << name << "' of style '" << to_string(style) << "'' doesn't exist. Returning default value "<< to_string(default_value);
+    LLOG_TRC << "Property '" << atom.name() << "' of style '" << to_string(style) << "'' doesn't exist. Returning default value "<< to_string(default_value);
     return default_value;
 }
 
 template<>
-const Vector4 PropertiesContainer::getPropertyValue(ast::Style style, const std::string& name, const Vector4& default_value) const {
-    auto pProperty = getProperty(style, name);
+const Vector4 PropertiesContainer::getPropertyValue(ast::Style style, PropertyAtom atom, const Vector4& default_value) const {
+    auto pProperty = getProperty(style, atom);
     if(pProperty) return pProperty->get<Vector4>();
-    LLOG_TRC << "Property '" << name << "' of style '" << to_string(style) << "'' doesn't exist. Returning default value "<< to_string(default_value);
+    LLOG_TRC << "Property '" << atom.name() << "' of style '" << to_string(style) << "'' doesn't exist. Returning default value "<< to_string(default_value);
     return default_value;
 }
 
 template<>
-const std::string PropertiesContainer::getPropertyValue(ast::Style style, const std::string& name, const std::string& default_value) const {
-    auto pProperty = getProperty(style, name);
+const std::string PropertiesContainer::getPropertyValue(ast::Style style, PropertyAtom atom, const std::string& default_value) const {
+    auto pProperty = getProperty(style, atom);
     if(pProperty) return pProperty->get<std::string>();
-    LLOG_TRC << "Property '" << name << "' of style '" << to_string(style) << "'' doesn't exist. Returning default value "<< to_string(default_value);
+    LLOG_TRC << "Property '" << atom.name() << "' of style '" << to_string(style) << "'' doesn't exist. Returning default value "<< to_string(default_value);
     return default_value;
 }
 
 template<>
-const double PropertiesContainer::getPropertyValue(ast::Style style, const std::string& name, const double& default_value) const {
-    auto pProperty = getProperty(style, name);
+const double PropertiesContainer::getPropertyValue(ast::Style style, PropertyAtom atom, const double& default_value) const {
+    auto pProperty = getProperty(style, atom);
     if(pProperty) return pProperty->get<double>();
-    LLOG_TRC << "Property '" << name << "' of style '" << to_string(style) << "'' doesn't exist. Returning default value "<< to_string(default_value);
+    LLOG_TRC << "Property '" << atom.name() << "' of style '" << to_string(style) << "'' doesn't exist. Returning default value "<< to_string(default_value);
     return default_value;
 }
 
 template<>
-const float PropertiesContainer::getPropertyValue(ast::Style style, const std::string& name, const float& default_value) const {
-    auto pProperty = getProperty(style, name);
+const float PropertiesContainer::getPropertyValue(ast::Style style, PropertyAtom atom, const float& default_value) const {
+    auto pProperty = getProperty(style, atom);
     if(pProperty) return pProperty->get<float>();
-    LLOG_TRC << "Property '" << name << "' of style '" << to_string(style) << "'' doesn't exist. Returning default value "<< to_string(default_value);
+    LLOG_TRC << "Property '" << atom.name() << "' of style '" << to_string(style) << "'' doesn't exist. Returning default value "<< to_string(default_value);
     return default_value;
 }
 
 template<>
-const int PropertiesContainer::getPropertyValue(ast::Style style, const std::string& name, const int& default_value) const {
-    auto pProperty = getProperty(style, name);
+const int PropertiesContainer::getPropertyValue(ast::Style style, PropertyAtom atom, const int& default_value) const {
+    auto pProperty = getProperty(style, atom);
     if(pProperty) return pProperty->get<int>();
-    LLOG_TRC << "Property '" << name << "' of style '" << to_string(style) << "'' doesn't exist. Returning default value "<< to_string(default_value);
+    LLOG_TRC << "Property '" << atom.name() << "' of style '" << to_string(style) << "'' doesn't exist. Returning default value "<< to_string(default_value);
     return default_value;
 }
 
 template<>
-const bool PropertiesContainer::getPropertyValue(ast::Style style, const std::string& name, const bool& default_value) const {
-    auto pProperty = getProperty(style, name);
+const bool PropertiesContainer::getPropertyValue(ast::Style style, PropertyAtom atom, const bool& default_value) const {
+    auto pProperty = getProperty(style, atom);
     if(pProperty) return pProperty->get<bool>();
-    LLOG_TRC << "Property '" << name << "' of style '" << to_string(style) << "'' doesn't exist. Returning default value "<< (default_value ? "True" : "False");
+    LLOG_TRC << "Property '" << atom.name() << "' of style '" << to_string(style) << "'' doesn't exist. Returning default value "<< (default_value ? "True" : "False");
     return default_value;
 }
 
 bool PropertiesContainer::propertyExist(ast::Style style, const std::string& name) const {
-    auto propKey = PropertiesContainer::PropertyKey(style, name);
-    if ( mPropertiesMap.find(propKey) != mPropertiesMap.end() ) {
-        // found
-        return true;
-    }
-    // not found
-    return false;
+    return propertyExist(style, PropertyAtom::find(name));
+}
+
+bool PropertiesContainer::propertyExist(ast::Style style, PropertyAtom atom) const {
+    if (!atom.isValid()) return false;
+    return findLocal(PropertyKey(style, atom)) != mPropertiesMap.end();
 }
 
 const PropertiesContainer PropertiesContainer::filterProperties(ast::Style style, const std::regex& re) const {
@@ -379,8 +477,9 @@ const PropertiesContainer PropertiesContainer::filterProperties(ast::Style style
 
     for(auto const& item: mPropertiesMap) {
         auto const& key = item.first;
-        if ((key.first == style) && std::regex_match(key.second, re)) {
-            container.mPropertiesMap.insert(item);
+        if ((key.style == style) && std::regex_match(key.name(), re)) {
+            // source is sorted already so appending keeps the order
+            container.mPropertiesMap.push_back(item);
         }
     }
 
@@ -392,8 +491,8 @@ const PropertiesContainer PropertiesContainer::filterProperties(ast::Style style
 
     for(auto const& item: mPropertiesMap) {
         auto const& key = item.first;
-        if (key.first == style) {
-            container.mPropertiesMap.insert(item);
+        if (key.style == style) {
+            container.mPropertiesMap.push_back(item);
         }
     }
 
@@ -406,64 +505,65 @@ Falcor::Dictionary PropertiesContainer::to_dict(ast::Style style, bool recursive
     for(auto const& item: mPropertiesMap) {
         auto const& key = item.first;
         auto const& prop = item.second;
-        if (key.first == style) {
+        if (key.style == style) {
+            const std::string& name = key.name();
             switch (valueType(prop.value())) {
                 case Property::Type::BOOL:
-                    dict[key.second] = static_cast<bool>(prop.get<bool>());
+                    dict[name] = static_cast<bool>(prop.get<bool>());
                     break;
                 
                 case Property::Type::INT:
-                    dict[key.second] = static_cast<int32_t>(prop.get<int>());
+                    dict[name] = static_cast<int32_t>(prop.get<int>());
                     break;
                 
                 case Property::Type::FLOAT:
-                    dict[key.second] = static_cast<float>(prop.get<double>());
+                    dict[name] = static_cast<float>(prop.get<double>());
                     break;
 
                 case Property::Type::INT2:
                     {
                         auto tmp = prop.get<Int2>();
-                        dict[key.second] = Falcor::int2({tmp[0], tmp[1]});
+                        dict[name] = Falcor::int2({tmp[0], tmp[1]});
                     }
                     break;
                 
                 case Property::Type::INT3:
                     {
                         auto tmp = prop.get<Int3>();
-                        dict[key.second] = Falcor::int3({tmp[0], tmp[1], tmp[2]});
+                        dict[name] = Falcor::int3({tmp[0], tmp[1], tmp[2]});
                     }
                     break;
                 
                 case Property::Type::INT4:
                     {
                         auto tmp = prop.get<Int4>();
-                        dict[key.second] = Falcor::int4({tmp[0], tmp[1], tmp[2], tmp[3]});
+                        dict[name] = Falcor::int4({tmp[0], tmp[1], tmp[2], tmp[3]});
                     }
                     break;
                 
                 case Property::Type::VECTOR2:
                     {
                         auto tmp = prop.get<Vector2>();
-                        dict[key.second] = Falcor::float2({tmp[0], tmp[1]});
+                        dict[name] = Falcor::float2({tmp[0], tmp[1]});
                     }
                     break;
                 
                 case Property::Type::VECTOR3:
                     {
                         auto tmp = prop.get<Vector3>();
-                        dict[key.second] = Falcor::float3({tmp[0], tmp[1], tmp[2]});
+                        dict[name] = Falcor::float3({tmp[0], tmp[1], tmp[2]});
                     }
                     break;
                 
                 case Property::Type::VECTOR4:
                     {
                         auto tmp = prop.get<Vector4>();
-                        dict[key.second] = Falcor::float4({tmp[0], tmp[1], tmp[2], tmp[3]});
+                        dict[name] = Falcor::float4({tmp[0], tmp[1], tmp[2], tmp[3]});
                     }
                     break;
 
                 case Property::Type::STRING:
-                    dict[key.second] = static_cast<std::string>(prop.get<std::string>());
+                    dict[name] = static_cast<std::string>(prop.get<std::string>());
                     break;
                 
                 case Property::Type::MATRIX3:
@@ -497,7 +597,7 @@ const void PropertiesContainer::printSummary(std::ostream& os, uint indent) cons
 
 
 std::string to_string(const PropertiesContainer::PropertyKey& key) {
-    return "style: " + to_string(key.first) + " name: \"" + key.second + "\"";
+    return "style: " + to_string(key.style) + " name: \"" + key.name() + "\"";
 };
 
 using Value = lava::lsd::Property::Value;
@@ -6,6 +6,7 @@
 #include <memory>
 #include <variant>
 #include <string>
+#include <vector>
 #include <regex>
 
 #include "Falcor/Utils/Scripting/Dictionary.h"
@@ -45,23 +46,19 @@ class Property {
         enum class Owner{ SYS, USER };
 
     public:
-        // Copy constructor 
-        Property(const Property &prop): mType(prop.mType), mValue(prop.mValue), mOwner(prop.mOwner) { }
+        // Copy constructor. Sub-container is copied too so copies never share it
+        Property(const Property &prop);
 
         // Move constructor
-        Property(Property&& prop) noexcept : mType(std::move(prop.mType)), mValue(std::move(prop.mValue)), mOwner(std::move(prop.mOwner)) { }
+        Property(Property&& prop) noexcept : mType(std::move(prop.mType)), mValue(std::move(prop.mValue)), mOwner(std::move(prop.mOwner)), mpSubContainer(std::move(prop.mpSubContainer)) { }
 
-        Property& operator=(Property& prop) {
-            mType = prop.mType;
-            mValue = prop.mValue;
-            mOwner = prop.mOwner;
-            return *this;
-        }
+        Property& operator=(const Property& prop);
 
-        Property& operator=(Property&& prop) {
+        Property& operator=(Property&& prop) noexcept {
             mType = std::move(prop.mType);
             mValue = std::move(prop.mValue);
             mOwner = std::move(prop.mOwner);
+            mpSubContainer = std::move(prop.mpSubContainer);
             return *this;
         }
 
@@ -154,26 +151,93 @@ static inline bool checkValueTypeLoose(Property::Type type, const Property::Valu
     return true;
 }
 
+/**
+ * Interned property name. Every distinct name is stored once in a process wide table and identified
+ * by a small integer, so property keys compare for equality as integers instead of strings. Atoms still
+ * order alphabetically by name so properties iterate (and echo) sorted.
+ * Atoms of hot names are meant to be created once, e.g. as function local statics at the call sites.
+ */
+class PropertyAtom {
+  public:
+    using Id = uint32_t;
+    static constexpr Id kInvalidId = 0;
+
+    PropertyAtom(): mId(kInvalidId), mpName(nullptr) {};
+
+    /** Interns name (if not interned already) and returns it's atom.
+     */
+    explicit PropertyAtom(const std::string& name);
+
+    /** Returns atom of an already interned name or invalid atom. Never modifies the table.
+     */
+    static PropertyAtom find(const std::string& name);
+
+    const std::string& name() const;
+    inline Id id() const { return mId; };
+    inline bool isValid() const { return mId != kInvalidId; };
+
+    inline bool operator==(const PropertyAtom& other) const { return mId == other.mId; };
+    inline bool operator!=(const PropertyAtom& other) const { return mId != other.mId; };
+    inline bool operator<(const PropertyAtom& other) const { return mId != other.mId && name() < other.name(); };
+
+  private:
+    PropertyAtom(Id id, const std::string* pName): mId(id), mpName(pName) {};
+
+    Id mId;
+    const std::string* mpName; // Interned name. Table never relocates names so no lock is needed to read it
+};
+
 class PropertiesContainer: public std::enable_shared_from_this<PropertiesContainer> {
  public:
     using SharedPtr = std::shared_ptr<PropertiesContainer>;
-    using PropertyKey = std::pair<ast::Style, std::string>;
-    using PropertiesMap = std::map<PropertyKey, Property>;
+
+    struct PropertyKey {
+        ast::Style      style;
+        PropertyAtom    atom;
+
+        PropertyKey(ast::Style style, PropertyAtom atom): style(style), atom(atom) {};
+
+        inline const std::string& name() const { return atom.name(); };
+        inline bool operator==(const PropertyKey& other) const { return style == other.style && atom == other.atom; };
+        inline bool operator<(const PropertyKey& other) const { return (style == other.style) ? atom < other.atom : style < other.style; };
+    };
+
+    /** Properties are kept in a contiguous vector sorted by style and name. Pointers returned by getProperty() stay valid
+     *  only until next property gets declared in the same container.
+     */
+    using PropertiesMap = std::vector<std::pair<PropertyKey, Property>>;
 
  public:
     PropertiesContainer(): mpParent(nullptr) {};
     PropertiesContainer(PropertiesContainer::SharedPtr pParent): mpParent(pParent) {};
 
     bool declareProperty(ast::Style style, Property::Type type, const std::string& name, const Property::Value& value, Property::Owner owner = Property::Owner::SYS);
+    bool declareProperty(ast::Style style, Property::Type type, PropertyAtom atom, const Property::Value& value, Property::Owner owner = Property::Owner::SYS);
     bool setProperty(ast::Style style, const std::string& name, const Property::Value& value);
+    bool setProperty(ast::Style style, PropertyAtom atom, const Property::Value& value);
 
     Property* getProperty(ast::Style style, const std::string& name);
     const Property* getProperty(ast::Style style, const std::string& name) const;
 
+    Property* getProperty(ast::Style style, PropertyAtom atom);
+    const Property* getProperty(ast::Style style, PropertyAtom atom) const;
+
+    template<typename T>
+    const T getPropertyValue(ast::Style style, PropertyAtom atom, const T& default_value) const;
+
     template<typename T>
-    const T getPropertyValue(ast::Style style, const std::string& name, const T& default_value) const;
+    const T getPropertyValue(ast::Style style, const std::string& name, const T& default_value) const {
+        // names that were never interned can't be declared anywhere in the scope chain
+        const PropertyAtom atom = PropertyAtom::find(name);
+        if(!atom.isValid()) {
+            LLOG_TRC << "Property '" << name << "' of style '" << to_string(style) << "'' was never declared. Returning default value";
+            return default_value;
+        }
+        return getPropertyValue(style, atom, default_value);
+    }
 
     bool propertyExist(ast::Style style, const std::string& name) const;
+    bool propertyExist(ast::Style style, PropertyAtom atom) const;
 
     const PropertiesContainer filterProperties(ast::Style style, const std::regex& re) const;
     const PropertiesContainer filterProperties(ast::Style style) const;
@@ -188,6 +252,10 @@ class PropertiesContainer: public std::enable_shared_from_this<PropertiesContain
  private:
     const Property::Value& _getPropertyValue(ast::Style style, const std::string& name, const Property::Value& default_value) const;
 
+    PropertiesMap::iterator findLocal(const PropertyKey& key);
+    PropertiesMap::const_iterator findLocal(const PropertyKey& key) const;
+    PropertiesMap::iterator insertLocal(PropertyKey key, Property&& prop);
+
  protected:
     PropertiesMap mPropertiesMap;
     SharedPtr mpParent = nullptr;
@@ -14,6 +14,8 @@
 #include "grammar_lsd.h"
 #include "../reader_bgeo/bgeo/Bgeo.h"
 
+#include "Falcor/Utils/Timing/TraceRecorder.h"
+
 #include "lava_utils_lib/logging.h"
 
 namespace x3 = boost::spirit::x3;
@@ -67,6 +69,8 @@ bool ReaderLSD::parseStream(std::istream& in) {
         return false;
     }
 
+    TRACE_SCOPE("ReaderLSD::parseStream");
+
     mpVisitor->setParserStream(in);
 
     in.unsetf(std::ios_base::skipws);
@@ -86,7 +90,11 @@ bool ReaderLSD::parseStream(std::istream& in) {
         begin = str.begin(); end = str.end();
         
         std::vector<lsd::ast::Command> commands; // ast tree
-        bool result = x3::phrase_parse(begin, end, lsd::parser::input, lsd::parser::skipper, commands); 
+        bool result;
+        {
+            TRACE_SCOPE("LSD parse");
+            result = x3::phrase_parse(begin, end, lsd::parser::input, lsd::parser::skipper, commands); 
+        }
 
         if (!result) {
             LLOG_ERR << "Parsing LSD scene failed !!!" << std::endl;
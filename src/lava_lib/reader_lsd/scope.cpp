@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "scope.h"
 #include "grammar_lsd.h"
 
@@ -161,6 +163,25 @@ std::shared_ptr<Material> Global::addMaterial() {
 }
 
 
+void Global::resetObjects() {
+	mChildren.erase(std::remove_if(mChildren.begin(), mChildren.end(), [](const ScopeBase::SharedPtr& pChild) {
+		const ast::Style type = pChild->type();
+		return type == Style::GEO || type == Style::OBJECT || type == Style::MATERIAL;
+	}), mChildren.end());
+
+	mGeos.clear();
+	mObjects.clear();
+	mMaterials.clear();
+}
+
+void Global::resetLights() {
+	mChildren.erase(std::remove_if(mChildren.begin(), mChildren.end(), [](const ScopeBase::SharedPtr& pChild) {
+		return pChild->type() == Style::LIGHT;
+	}), mChildren.end());
+
+	mLights.clear();
+}
+
 /* Geo */
 
 ika::bgeo::Bgeo::SharedPtr Geo::bgeo() { 
@@ -199,33 +220,49 @@ void Geo::cleanUpGeometry() {
 /* Object */
 
 Object::SharedPtr Object::create(ScopeBase::SharedPtr pParent) {
+	static const PropertyAtom kName("name");
+	static const PropertyAtom kMatte("matte");
+	static const PropertyAtom kSurface("surface");
+	static const PropertyAtom kBasecolorUseTexture("basecolor_useTexture");
+	static const PropertyAtom kBasecolorTexture("basecolor_texture");
+	static const PropertyAtom kBaseBumpAndNormalEnable("baseBumpAndNormal_enable");
+	static const PropertyAtom kBaseNormalScale("baseNormal_scale");
+	static const PropertyAtom kBaseNormalTexture("baseNormal_texture");
+	static const PropertyAtom kMetallicUseTexture("metallic_useTexture");
+	static const PropertyAtom kMetallicTexture("metallic_texture");
+	static const PropertyAtom kRoughUseTexture("rough_useTexture");
+	static const PropertyAtom kRoughTexture("rough_texture");
+	static const PropertyAtom kRough("rough");
+	static const PropertyAtom kIor("ior");
+	static const PropertyAtom kMetallic("metallic");
+
 	auto pObject = std::make_shared<Object>(pParent);
-	if(!pObject->declareProperty(Style::OBJECT, Type::STRING, "name", std::string(), Property::Owner::SYS)) return nullptr;
-	if(!pObject->declareProperty(Style::OBJECT, Type::BOOL, "matte", bool(false), Property::Owner::SYS)) return nullptr;
-	if(!pObject->declareProperty(Style::OBJECT, Type::STRING, "surface", std::string(), Property::Owner::SYS)) return nullptr;	
+	if(!pObject->declareProperty(Style::OBJECT, Type::STRING, kName, std::string(), Property::Owner::SYS)) return nullptr;
+	if(!pObject->declareProperty(Style::OBJECT, Type::BOOL, kMatte, bool(false), Property::Owner::SYS)) return nullptr;
+	if(!pObject->declareProperty(Style::OBJECT, Type::STRING, kSurface, std::string(), Property::Owner::SYS)) return nullptr;	
 
-	auto pProp = pObject->getProperty(Style::OBJECT, "surface");
+	auto pProp = pObject->getProperty(Style::OBJECT, kSurface);
 	if(!pProp) return nullptr;
 	
 	auto pSubContainer = pProp->createSubContainer();
 	if(!pSubContainer) return nullptr;
 
-	pSubContainer->declareProperty(Style::OBJECT, Type::BOOL, 	"basecolor_useTexture", bool(false), Property::Owner::SYS);
-	pSubContainer->declareProperty(Style::OBJECT, Type::STRING, "basecolor_texture", std::string(), Property::Owner::SYS);
+	pSubContainer->declareProperty(Style::OBJECT, Type::BOOL, 	kBasecolorUseTexture, bool(false), Property::Owner::SYS);
+	pSubContainer->declareProperty(Style::OBJECT, Type::STRING, kBasecolorTexture, std::string(), Property::Owner::SYS);
 
-	pSubContainer->declareProperty(Style::OBJECT, Type::BOOL, 	"baseBumpAndNormal_enable", bool(false), Property::Owner::SYS);
-	pSubContainer->declareProperty(Style::OBJECT, Type::FLOAT,  "baseNormal_scale", 0.5, Property::Owner::SYS);
-	pSubContainer->declareProperty(Style::OBJECT, Type::STRING, "baseNormal_texture", std::string(), Property::Owner::SYS);
+	pSubContainer->declareProperty(Style::OBJECT, Type::BOOL, 	kBaseBumpAndNormalEnable, bool(false), Property::Owner::SYS);
+	pSubContainer->declareProperty(Style::OBJECT, Type::FLOAT,  kBaseNormalScale, 0.5, Property::Owner::SYS);
+	pSubContainer->declareProperty(Style::OBJECT, Type::STRING, kBaseNormalTexture, std::string(), Property::Owner::SYS);
 
-	pSubContainer->declareProperty(Style::OBJECT, Type::BOOL, 	"metallic_useTexture", bool(false), Property::Owner::SYS);
-	pSubContainer->declareProperty(Style::OBJECT, Type::STRING, "metallic_texture", std::string(), Property::Owner::SYS);
+	pSubContainer->declareProperty(Style::OBJECT, Type::BOOL, 	kMetallicUseTexture, bool(false), Property::Owner::SYS);
+	pSubContainer->declareProperty(Style::OBJECT, Type::STRING, kMetallicTexture, std::string(), Property::Owner::SYS);
 
-	pSubContainer->declareProperty(Style::OBJECT, Type::BOOL, 	"rough_useTexture", bool(false), Property::Owner::SYS);
-	pSubContainer->declareProperty(Style::OBJECT, Type::STRING, "rough_texture", std::string(), Property::Owner::SYS);
+	pSubContainer->declareProperty(Style::OBJECT, Type::BOOL, 	kRoughUseTexture, bool(false), Property::Owner::SYS);
+	pSubContainer->declareProperty(Style::OBJECT, Type::STRING, kRoughTexture, std::string(), Property::Owner::SYS);
 	
-	pSubContainer->declareProperty(Style::OBJECT, Type::FLOAT, 	"rough", 0.3, Property::Owner::SYS);
-	pSubContainer->declareProperty(Style::OBJECT, Type::FLOAT, 	"ior", 1.5, Property::Owner::SYS);
-	pSubContainer->declareProperty(Style::OBJECT, Type::FLOAT, 	"metallic", 0.0, Property::Owner::SYS);
+	pSubContainer->declareProperty(Style::OBJECT, Type::FLOAT, 	kRough, 0.3, Property::Owner::SYS);
+	pSubContainer->declareProperty(Style::OBJECT, Type::FLOAT, 	kIor, 1.5, Property::Owner::SYS);
+	pSubContainer->declareProperty(Style::OBJECT, Type::FLOAT, 	kMetallic, 0.0, Property::Owner::SYS);
 
 	return pObject;
 }
@@ -248,18 +285,28 @@ Plane::SharedPtr Plane::create(ScopeBase::SharedPtr pParent) {
 /* Light */
 
 Light::SharedPtr Light::create(ScopeBase::SharedPtr pParent) {
+	static const PropertyAtom kName("name");
+	static const PropertyAtom kProjection("projection");
+	static const PropertyAtom kZoom("zoom");
+	static const PropertyAtom kShader("shader");
+	static const PropertyAtom kShadow("shadow");
+	static const PropertyAtom kLightcolor("lightcolor");
+	static const PropertyAtom kType("type");
+	static const PropertyAtom kShadowtype("shadowtype");
+	static const PropertyAtom kShadowColor("shadow_color");
+
 	auto pLight = std::make_shared<Light>(pParent);
-	if(!pLight->declareProperty(Style::OBJECT, Type::STRING, "name", std::string(), Property::Owner::SYS)) return nullptr;
-	if(!pLight->declareProperty(Style::LIGHT, Type::STRING, "projection", std::string("perspective"), Property::Owner::SYS)) return nullptr;
-	if(!pLight->declareProperty(Style::LIGHT, Type::VECTOR2, "zoom", lsd::Vector2{0.01, 1000.0}, Property::Owner::SYS)) return nullptr;
+	if(!pLight->declareProperty(Style::OBJECT, Type::STRING, kName, std::string(), Property::Owner::SYS)) return nullptr;
+	if(!pLight->declareProperty(Style::LIGHT, Type::STRING, kProjection, std::string("perspective"), Property::Owner::SYS)) return nullptr;
+	if(!pLight->declareProperty(Style::LIGHT, Type::VECTOR2, kZoom, lsd::Vector2{0.01, 1000.0}, Property::Owner::SYS)) return nullptr;
 
-	if(!pLight->declareProperty(Style::LIGHT, Type::STRING, "shader", std::string(), Property::Owner::SYS)) return nullptr;	
-	if(!pLight->declareProperty(Style::LIGHT, Type::STRING, "shadow", std::string(), Property::Owner::SYS)) return nullptr;	
+	if(!pLight->declareProperty(Style::LIGHT, Type::STRING, kShader, std::string(), Property::Owner::SYS)) return nullptr;	
+	if(!pLight->declareProperty(Style::LIGHT, Type::STRING, kShadow, std::string(), Property::Owner::SYS)) return nullptr;	
 	
-	auto pShaderProp = pLight->getProperty(Style::LIGHT, "shader");
+	auto pShaderProp = pLight->getProperty(Style::LIGHT, kShader);
 	if(!pShaderProp) return nullptr;
 
-	auto pShadowProp = pLight->getProperty(Style::LIGHT, "shadow");
+	auto pShadowProp = pLight->getProperty(Style::LIGHT, kShadow);
 	if(!pShadowProp) return nullptr;
 	
 	auto pShaderSubContainer = pShaderProp->createSubContainer();
@@ -268,11 +315,11 @@ Light::SharedPtr Light::create(ScopeBase::SharedPtr pParent) {
 	auto pShadowSubContainer = pShadowProp->createSubContainer();
 	if(!pShadowSubContainer) return nullptr;
 
-	pShaderSubContainer->declareProperty(Style::LIGHT, Type::VECTOR3, "lightcolor", lsd::Vector3{1.0, 1.0, 1.0}, Property::Owner::SYS);
-	pShaderSubContainer->declareProperty(Style::LIGHT, Type::STRING, "type", std::string("point"), Property::Owner::SYS);
+	pShaderSubContainer->declareProperty(Style::LIGHT, Type::VECTOR3, kLightcolor, lsd::Vector3{1.0, 1.0, 1.0}, Property::Owner::SYS);
+	pShaderSubContainer->declareProperty(Style::LIGHT, Type::STRING, kType, std::string("point"), Property::Owner::SYS);
 
-	pShadowSubContainer->declareProperty(Style::LIGHT, Type::STRING, "shadowtype", std::string(""), Property::Owner::SYS);
-	pShadowSubContainer->declareProperty(Style::LIGHT, Type::VECTOR3, "shadow_color", lsd::Vector3{0.0, 0.0, 0.0}, Property::Owner::SYS);
+	pShadowSubContainer->declareProperty(Style::LIGHT, Type::STRING, kShadowtype, std::string(""), Property::Owner::SYS);
+	pShadowSubContainer->declareProperty(Style::LIGHT, Type::VECTOR3, kShadowColor, lsd::Vector3{0.0, 0.0, 0.0}, Property::Owner::SYS);
 
 	return pLight;
 }
@@ -291,12 +338,15 @@ Segment::SharedPtr Segment::create(ScopeBase::SharedPtr pParent) {
 /* Material */
 
 Material::SharedPtr Material::create(ScopeBase::SharedPtr pParent) {
+	static const PropertyAtom kMaterialname("materialname");
+	static const PropertyAtom kSurface("surface");
+
 	auto pMat = std::make_shared<Material>(pParent);
 
-	if(!pMat->declareProperty(Style::OBJECT, Type::STRING, "materialname", std::string(""), Property::Owner::SYS)) return nullptr;
-	if(!pMat->declareProperty(Style::OBJECT, Type::STRING, "surface", std::string(), Property::Owner::SYS)) return nullptr;	
+	if(!pMat->declareProperty(Style::OBJECT, Type::STRING, kMaterialname, std::string(""), Property::Owner::SYS)) return nullptr;
+	if(!pMat->declareProperty(Style::OBJECT, Type::STRING, kSurface, std::string(), Property::Owner::SYS)) return nullptr;	
 	
-	auto pProp = pMat->getProperty(Style::OBJECT, "surface");
+	auto pProp = pMat->getProperty(Style::OBJECT, kSurface);
 	if(!pProp) return nullptr;
 	
 	auto pSubContainer = pProp->createSubContainer();
@@ -98,6 +98,14 @@ class Global: public Transformable {
     const std::vector<std::shared_ptr<Segment>>&    segments() { return mSegments; };
     const std::vector<std::shared_ptr<Material>>&   materials() { return mMaterials; };
 
+    /** Remove geometries, materials and objects (ray_reset -o) declared so far.
+     */
+    void resetObjects();
+
+    /** Remove lights (ray_reset -l) declared so far.
+     */
+    void resetLights();
+
   public:
     Global():Transformable(nullptr) {};
 
@@ -216,14 +224,22 @@ class Object: public Transformable {
 
     inline ast::Style type() const override { return ast::Style::OBJECT; };
 
+    using ProceduralArguments = std::map<std::string, Property::Value>;
+
     inline const std::string& geometryName() const { return mGeometryName; };
     inline void setGeometryName(const std::string& name) { mGeometryName = name; };
 
+    inline const std::string& procedural() const { return mProcedural; };
+    inline const ProceduralArguments& proceduralArguments() const { return mProceduralArguments; };
+    inline void setProcedural(const std::string& procedural, const ProceduralArguments& arguments) { mProcedural = procedural; mProceduralArguments = arguments; };
+
  public:
     Object(ScopeBase::SharedPtr pParent): Transformable(pParent), mGeometryName() {};
 
  private:
     std::string mGeometryName;
+    std::string mProcedural;
+    ProceduralArguments mProceduralArguments;
 };
 
 class Plane: public ScopeBase {
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include <utility>
 #include <mutex>
 #include <limits>
@@ -58,6 +60,87 @@ static std::string random_string( size_t length ) {
   return str;
 }
 
+namespace {
+
+// Scope signature helpers. Sizes and variant type indices are hashed along with the data, so different
+// property sets never produce the same byte stream.
+
+void hashString(Falcor::SHA1& sha1, const std::string& str) {
+	const uint64_t size = str.size();
+	sha1.update(&size, sizeof(size));
+	sha1.update(str.data(), str.size());
+}
+
+void hashValue(Falcor::SHA1& sha1, const Property::Value& value) {
+	const int32_t typeIndex = value.which();
+	sha1.update(&typeIndex, sizeof(typeIndex));
+	boost::apply_visitor([&sha1](auto const& v) {
+		using T = std::decay_t<decltype(v)>;
+		if constexpr (std::is_same_v<T, std::string>) {
+			hashString(sha1, v);
+		} else if constexpr (std::is_arithmetic_v<T>) {
+			sha1.update(&v, sizeof(v));
+		} else {
+			sha1.update(v.data(), v.size() * sizeof(typename T::value_type));
+		}
+	}, value);
+}
+
+void hashProperties(Falcor::SHA1& sha1, const PropertiesContainer& container) {
+	const uint64_t count = container.size();
+	sha1.update(&count, sizeof(count));
+	for(const auto& [key, prop]: container.properties()) {
+		const int32_t style = static_cast<int32_t>(key.style);
+		sha1.update(&style, sizeof(style));
+		hashString(sha1, key.name());
+		hashValue(sha1, prop.value());
+
+		auto pSubContainer = prop.subContainer();
+		const bool hasSubContainer = pSubContainer != nullptr;
+		sha1.update(&hasSubContainer, sizeof(hasSubContainer));
+		if(pSubContainer) hashProperties(sha1, *pSubContainer);
+	}
+}
+
+void hashTransforms(Falcor::SHA1& sha1, const scope::Transformable::TransformList& transforms) {
+	for(const auto& transform: transforms) sha1.update(&transform[0][0], sizeof(transform));
+}
+
+// File is identified by it's path, size and modification time. Content itself is never read, as this runs every frame
+bool hashFileStamp(Falcor::SHA1& sha1, const fs::path& path) {
+	boost::system::error_code ec;
+	const uint64_t size = fs::file_size(path, ec);
+	if(ec) return false;
+	const int64_t mtime = static_cast<int64_t>(fs::last_write_time(path, ec));
+	if(ec) return false;
+
+	hashString(sha1, path.string());
+	sha1.update(&size, sizeof(size));
+	sha1.update(&mtime, sizeof(mtime));
+	return true;
+}
+
+// Same light placement as used on light creation. Position and direction are taken from transform translation and -Z axis
+void setLightTransform(const Falcor::Light::SharedPtr& pLight, const glm::mat4& transform) {
+	const Falcor::float3 light_pos = {transform[3][0], transform[3][1], transform[3][2]};
+	const Falcor::float3 light_dir = {-transform[2][0], -transform[2][1], -transform[2][2]};
+
+	if(auto pPointLight = std::dynamic_pointer_cast<Falcor::PointLight>(pLight)) {
+		pPointLight->setWorldPosition(light_pos);
+		pPointLight->setWorldDirection(light_dir);
+	} else if(auto pDirectionalLight = std::dynamic_pointer_cast<Falcor::DirectionalLight>(pLight)) {
+		pDirectionalLight->setWorldDirection(light_dir);
+	} else if(auto pDistantLight = std::dynamic_pointer_cast<Falcor::DistantLight>(pLight)) {
+		pDistantLight->setWorldDirection(light_dir);
+	} else if(auto pAreaLight = std::dynamic_pointer_cast<Falcor::AnalyticAreaLight>(pLight)) {
+		pAreaLight->setTransformMatrix(transform);
+	} else if(auto pEnvLight = std::dynamic_pointer_cast<Falcor::EnvironmentLight>(pLight)) {
+		pEnvLight->setTransformMatrix(transform);
+	}
+}
+
+}  // namespace
+
 Session::UniquePtr Session::create(std::shared_ptr<Renderer> pRenderer) {
 	assert(pRenderer);
 
@@ -110,7 +193,7 @@ void Session::setEnvVariable(const std::string& key, const std::string& value){
 	mEnvmap[key] = value;
 }
 
-std::string Session::getExpandedString(const std::string& s) {
+std::string Session::getExpandedString(const std::string& s) const {
 		std::string result = s;
 
 	for( auto const& [key, val] : mEnvmap )
@@ -138,7 +221,7 @@ bool Session::prepareDisplayData() {
 	for( auto const& item: props_container.properties()) {
 		LLOG_DBG << "Display property: " << to_string(item.first);
 
-		const std::string& parm_name = item.first.second.substr(6); // remove leading "IPlay."
+		const std::string& parm_name = item.first.name().substr(6); // remove leading "IPlay."
 		const Property& prop = item.second;
 		switch(item.second.type()) {
 			case ast::Type::FLOAT:
@@ -178,6 +261,7 @@ void Session::setUpCamera(Falcor::Camera::SharedPtr pCamera, Falcor::float4 crop
 	
 	pCamera->setAspectRatio(aspect_ratio);
 	pCamera->setViewMatrix(mpGlobal->getTransformList()[0]);
+	mpRenderer->setCameraViewMatrixSamples(mpGlobal->getTransformList());
 	pCamera->setNearPlane(camera_clip[0]);
 	pCamera->setFarPlane(camera_clip[1]);
 	pCamera->setCropRegion(cropRegion);
@@ -214,6 +298,48 @@ void Session::cmdQuit() {
 bool Session::cmdRaytrace() {
 	PROFILE(mpDevice, "cmdRaytrace");
 
+	// Point instancers bake in transforms of the objects they instance. Those objects may be declared after the instancer,
+	// so they are compared to the previous frame only once the frame is complete
+	bool instancedObjectsChanged = false;
+	if(isSceneReuseEnabled()) {
+		Falcor::SHA1 sha1;
+		for(const auto& pObject: mpGlobal->objects()) hashTransforms(sha1, pObject->getTransformList());
+		const Falcor::SHA1::MD instancedSignature = sha1.final();
+
+		// Signature covers all the objects, so it's the same for every point instancer of a frame
+		Falcor::SHA1::MD previousInstancedSignature = {};
+		for(const auto& record: mObjectRecords.previous) {
+			if(record.instancedSignature != Falcor::SHA1::MD{}) {
+				previousInstancedSignature = record.instancedSignature;
+				break;
+			}
+		}
+
+		for(size_t i = 0; i < mObjectRecords.scopes.size(); i++) {
+			auto pObj = std::dynamic_pointer_cast<scope::Object>(mObjectRecords.scopes[i]);
+			if(!pObj || pObj->procedural() != "ptinstance") continue;
+
+			mObjectRecords.current[i].instancedSignature = instancedSignature;
+			if(previousInstancedSignature != instancedSignature) instancedObjectsChanged = true;
+		}
+	}
+
+	// Objects or lights might be removed since the previous frame
+	if(mReusingScene && (instancedObjectsChanged || !mObjectRecords.unmatched.empty() || !mLightRecords.unmatched.empty())) {
+		LLOG_INF << "Frame differs from the previous one. Rebuilding scene...";
+		if(!rebuildScene()) {
+			LLOG_ERR << "Error rebuilding scene !!!";
+			return false;
+		}
+	}
+	mReusingScene = false;
+
+	// All the objects are known now, so point instancers can resolve the objects they instance
+	if(!pushPendingPointInstances()) {
+		mFailed = true;
+		return false;
+	}
+
 	// Set up image sampling
 	const int imageSamples = mCurrentFrameInfo.imageSamples = mpGlobal->getPropertyValue(ast::Style::IMAGE, "samples", 1);
 	int  sampleUpdateInterval = mpGlobal->getPropertyValue(ast::Style::IMAGE, "sampleupdate", 0);
@@ -255,6 +381,9 @@ bool Session::cmdRaytrace() {
 	passDict["MAIN.OpenDenoisePass.enable"] = mpGlobal->getPropertyValue(ast::Style::IMAGE, "OpenDenoisePass.enable", bool(false));
 	passDict["MAIN.OpenDenoisePass.useAlbedo"] = mpGlobal->getPropertyValue(ast::Style::IMAGE, "OpenDenoisePass.useAlbedo", bool(true));
 	passDict["MAIN.OpenDenoisePass.useNormal"] = mpGlobal->getPropertyValue(ast::Style::IMAGE, "OpenDenoisePass.useNormal", bool(true));
+	passDict["MAIN.OpenDenoisePass.async"] = mpGlobal->getPropertyValue(ast::Style::IMAGE, "OpenDenoisePass.async", bool(false));
+	passDict["MAIN.OpenDenoisePass.tileSize"] = (uint32_t)mpGlobal->getPropertyValue(ast::Style::IMAGE, "OpenDenoisePass.tileSize", int(0));
+	passDict["MAIN.OpenDenoisePass.tileOverlap"] = (uint32_t)mpGlobal->getPropertyValue(ast::Style::IMAGE, "OpenDenoisePass.tileOverlap", int(32));
 
 	auto pMainOutputPlane = mpRenderer->getAOVPlane("MAIN");
 
@@ -542,6 +671,7 @@ bool Session::cmdRaytrace() {
 //    auto profiler = Falcor::Profiler::instance(mpDevice);
 //    profiler.endFrame();
 //#endif
+	mFirstRun = false;
 	return true;
 }
 
@@ -557,7 +687,10 @@ void Session::pushBgeo(const std::string& name, lsd::scope::Geo::SharedPtr pGeo)
  	// immediate mesh add
  	ika::bgeo::Bgeo::SharedPtr pBgeo = pGeo->bgeo();
  	std::string fullpath = pGeo->detailFilePath().string();
-  pBgeo->readGeoFromFile(fullpath.c_str(), false); // FIXME: don't check version for now
+  {
+    TRACE_SCOPE("bgeo read");
+    pBgeo->readGeoFromFile(fullpath.c_str(), false); // FIXME: don't check version for now
+  }
 
  	if(!pBgeo) {
  		LLOG_ERR << "Can't load geometry (bgeo) !!!";
@@ -571,7 +704,7 @@ void Session::pushBgeo(const std::string& name, lsd::scope::Geo::SharedPtr pGeo)
    mMeshMap[name] = pSceneBuilder->addGeometry(pBgeo, name);
 }
 
-void Session::pushBgeoAsync(const std::string& name, lsd::scope::Geo::SharedPtr pGeo) {
+void Session::pushBgeoAsync(const std::string& name, lsd::scope::Geo::SharedPtr pGeo, ika::bgeo::Bgeo::SharedPtr pBgeo) {
 	assert(pGeo);
 
 	auto pSceneBuilder = mpRenderer->sceneBuilder();
@@ -581,43 +714,67 @@ void Session::pushBgeoAsync(const std::string& name, lsd::scope::Geo::SharedPtr
 	}
 
 	// async mesh add 
-   	mMeshMap[name] = pSceneBuilder->addGeometryAsync(pGeo, name);
+   	mMeshMap[name] = pSceneBuilder->addGeometryAsync(pGeo, name, pBgeo);
 }
 
-void Session::pushLight(const scope::Light::SharedPtr pLightScope) {
+Falcor::Light::SharedPtr Session::pushLight(const scope::Light::SharedPtr pLightScope) {
+	static const PropertyAtom kType("type");
+	static const PropertyAtom kName("name");
+	static const PropertyAtom kShader("shader");
+	static const PropertyAtom kLightcolor("lightcolor");
+	static const PropertyAtom kDiffuseColor("diffuse_color");
+	static const PropertyAtom kSpecularColor("specular_color");
+	static const PropertyAtom kIndirectDiffuseColor("indirect_diffuse_color");
+	static const PropertyAtom kIndirectSpecularColor("indirect_specular_color");
+	static const PropertyAtom kVisiblePrimary("visible_primary");
+	static const PropertyAtom kEnvangle("envangle");
+	static const PropertyAtom kLightradius("lightradius");
+	static const PropertyAtom kDocone("docone");
+	static const PropertyAtom kConeangle("coneangle");
+	static const PropertyAtom kConedelta("conedelta");
+	static const PropertyAtom kSinglesided("singlesided");
+	static const PropertyAtom kAreasize("areasize");
+	static const PropertyAtom kAreanormalize("areanormalize");
+	static const PropertyAtom kReverse("reverse");
+	static const PropertyAtom kAreamap("areamap");
+	static const PropertyAtom kPhysicalSky("physical_sky");
+	static const PropertyAtom kVtoff("vtoff");
+	static const PropertyAtom kEnvmaxres("envmaxres");
+	static const PropertyAtom kShadow("shadow");
+	static const PropertyAtom kShadowtype("shadowtype");
+	static const PropertyAtom kShadowColor("shadow_color");
+
 	assert(pLightScope);
 
 	auto pSceneBuilder = mpRenderer->sceneBuilder();
 
     if (!pSceneBuilder) {
 		LLOG_ERR << "Unable to push light. SceneBuilder not ready !!!";
-		return;
+		return nullptr;
 	}
 
-	const std::string& light_type = pLightScope->getPropertyValue(ast::Style::LIGHT, "type", std::string("point"));
-	const std::string& light_name = pLightScope->getPropertyValue(ast::Style::OBJECT, "name", std::string(""));
+	const std::string& light_type = pLightScope->getPropertyValue(ast::Style::LIGHT, kType, std::string("point"));
+	const std::string& light_name = pLightScope->getPropertyValue(ast::Style::OBJECT, kName, std::string(""));
 	glm::mat4 transform = pLightScope->getTransformList()[0];
 
 	lsd::Vector3 light_color = lsd::Vector3{1.0, 1.0, 1.0}; // defualt light color
-	Falcor::float3 light_pos = {transform[3][0], transform[3][1], transform[3][2]}; // light position
-	Falcor::float3 light_dir = {-transform[2][0], -transform[2][1], -transform[2][2]};
 	
-	Property* pShaderProp = pLightScope->getProperty(ast::Style::LIGHT, "shader");
+	Property* pShaderProp = pLightScope->getProperty(ast::Style::LIGHT, kShader);
 	std::shared_ptr<PropertiesContainer> pShaderProps;
 
 	if(pShaderProp) {
 		pShaderProps = pShaderProp->subContainer();
-		light_color = pShaderProps->getPropertyValue(ast::Style::LIGHT, "lightcolor", lsd::Vector3{1.0, 1.0, 1.0});
+		light_color = pShaderProps->getPropertyValue(ast::Style::LIGHT, kLightcolor, lsd::Vector3{1.0, 1.0, 1.0});
 	} else {
 		LLOG_ERR << "No shader property set for light " << light_name;
 	}
 
-	lsd::Vector3 light_diffuse_color = pLightScope->getPropertyValue(ast::Style::LIGHT, "diffuse_color", light_color);
-	lsd::Vector3 light_specular_color = pLightScope->getPropertyValue(ast::Style::LIGHT, "specular_color", light_diffuse_color);
-	lsd::Vector3 light_indirect_diffuse_color = pLightScope->getPropertyValue(ast::Style::LIGHT, "indirect_diffuse_color", light_diffuse_color);
-	lsd::Vector3 light_indirect_specular_color = pLightScope->getPropertyValue(ast::Style::LIGHT, "indirect_specular_color", light_specular_color);
+	lsd::Vector3 light_diffuse_color = pLightScope->getPropertyValue(ast::Style::LIGHT, kDiffuseColor, light_color);
+	lsd::Vector3 light_specular_color = pLightScope->getPropertyValue(ast::Style::LIGHT, kSpecularColor, light_diffuse_color);
+	lsd::Vector3 light_indirect_diffuse_color = pLightScope->getPropertyValue(ast::Style::LIGHT, kIndirectDiffuseColor, light_diffuse_color);
+	lsd::Vector3 light_indirect_specular_color = pLightScope->getPropertyValue(ast::Style::LIGHT, kIndirectSpecularColor, light_specular_color);
 
-	const bool visible_primary = pLightScope->getPropertyValue(ast::Style::LIGHT, "visible_primary", bool(false));
+	const bool visible_primary = pLightScope->getPropertyValue(ast::Style::LIGHT, kVisiblePrimary, bool(false));
 
 	Falcor::Light::SharedPtr pLight = nullptr;
 
@@ -625,16 +782,14 @@ void Session::pushLight(const scope::Light::SharedPtr pLightScope) {
 		// Directional light
 
 		auto pDirectionalLight = Falcor::DirectionalLight::create("noname_distant");
-		pDirectionalLight->setWorldDirection(light_dir);
 
 		pLight = std::dynamic_pointer_cast<Falcor::Light>(pDirectionalLight);
 	} else if (light_type == "sun") {
 		// Distant/Sun light
 
 		auto pDistantLight = Falcor::DistantLight::create("noname_sun");
-		pDistantLight->setWorldDirection(light_dir);
 
-		const float env_angle = pLightScope->getPropertyValue(ast::Style::LIGHT, "envangle", float(5.0));
+		const float env_angle = pLightScope->getPropertyValue(ast::Style::LIGHT, kEnvangle, float(5.0));
 		pDistantLight->setAngleDegrees(env_angle);
 
 		pLight = std::dynamic_pointer_cast<Falcor::Light>(pDistantLight);
@@ -642,11 +797,9 @@ void Session::pushLight(const scope::Light::SharedPtr pLightScope) {
 		// Point/Spot light
 
 
-		float light_radius = pLightScope->getPropertyValue(ast::Style::LIGHT, "lightradius", (float)0.0f);
+		float light_radius = pLightScope->getPropertyValue(ast::Style::LIGHT, kLightradius, (float)0.0f);
 
 		auto pPointLight = Falcor::PointLight::create("noname_point");
-		pPointLight->setWorldPosition(light_pos);
-		pPointLight->setWorldDirection(light_dir);
 
 		if(light_radius > 0.0f) pPointLight->setLightRadius(light_radius);
 
@@ -655,9 +808,9 @@ void Session::pushLight(const scope::Light::SharedPtr pLightScope) {
 		float conedelta_degrees = 0.0f;
 
 		if(pShaderProps) {
-			do_cone = pShaderProps->getPropertyValue(ast::Style::LIGHT, "docone", bool(false));
-			coneangle_degrees = pShaderProps->getPropertyValue(ast::Style::LIGHT, "coneangle", (float)360.0f);
-			conedelta_degrees = pShaderProps->getPropertyValue(ast::Style::LIGHT, "conedelta", (float)0.0f);
+			do_cone = pShaderProps->getPropertyValue(ast::Style::LIGHT, kDocone, bool(false));
+			coneangle_degrees = pShaderProps->getPropertyValue(ast::Style::LIGHT, kConeangle, (float)360.0f);
+			conedelta_degrees = pShaderProps->getPropertyValue(ast::Style::LIGHT, kConedelta, (float)0.0f);
 		}
 
 		// Spot light case
@@ -671,15 +824,15 @@ void Session::pushLight(const scope::Light::SharedPtr pLightScope) {
 		// Area lights
 		Falcor::AnalyticAreaLight::SharedPtr pAreaLight = nullptr;
 
-		bool singleSidedLight = pLightScope->getPropertyValue(ast::Style::LIGHT, "singlesided", bool(false));
+		bool singleSidedLight = pLightScope->getPropertyValue(ast::Style::LIGHT, kSinglesided, bool(false));
 		bool reverseLight = false;
 
-		lsd::Vector2 area_size = pLightScope->getPropertyValue(ast::Style::LIGHT, "areasize", lsd::Vector2{1.0, 1.0});
-		bool area_normalize = pLightScope->getPropertyValue(ast::Style::LIGHT, "areanormalize", bool(true));
+		lsd::Vector2 area_size = pLightScope->getPropertyValue(ast::Style::LIGHT, kAreasize, lsd::Vector2{1.0, 1.0});
+		bool area_normalize = pLightScope->getPropertyValue(ast::Style::LIGHT, kAreanormalize, bool(true));
 
 		if(pShaderProp) {
 			pShaderProps = pShaderProp->subContainer();
-			reverseLight = pShaderProps->getPropertyValue(ast::Style::LIGHT, "reverse", bool(false));
+			reverseLight = pShaderProps->getPropertyValue(ast::Style::LIGHT, kReverse, bool(false));
 		}
 
 		if( light_type == "grid") {
@@ -695,10 +848,9 @@ void Session::pushLight(const scope::Light::SharedPtr pLightScope) {
 
 		if (!pAreaLight) {
 			LLOG_ERR << "Error creating AnalyticAreaLight !!! Skipping...";
-			return;
+			return nullptr;
 		}
 
-		pAreaLight->setTransformMatrix(transform);
 		pAreaLight->setSingleSided(singleSidedLight);
 		pAreaLight->setNormalizeArea(area_normalize);
 
@@ -706,19 +858,33 @@ void Session::pushLight(const scope::Light::SharedPtr pLightScope) {
 	} else if( light_type == "env") {
 		// Environment light probe is not a classid light source. It should be created later by scene builder or renderer
 
-		std::string texture_file_name = pLightScope->getPropertyValue(ast::Style::LIGHT, "areamap", std::string(""));
-		bool is_physical_sky = pLightScope->getPropertyValue(ast::Style::LIGHT, "physical_sky", bool(false));
+		std::string texture_file_name = pLightScope->getPropertyValue(ast::Style::LIGHT, kAreamap, std::string(""));
+		bool is_physical_sky = pLightScope->getPropertyValue(ast::Style::LIGHT, kPhysicalSky, bool(false));
 
 		auto pDevice = pSceneBuilder->device();
 		
 		Texture::SharedPtr pEnvMapTexture;
 		if (!is_physical_sky && texture_file_name.size() > 0) {
 			bool loadAsSRGB = false;
-			bool loadAsSparse = false;
+			bool loadAsSparse = !mpGlobal->getPropertyValue(ast::Style::GLOBAL, kVtoff, bool(false));
 			bool generateMipLevels = true;
 			Resource::BindFlags bindFlags = Resource::BindFlags::ShaderResource;
-			std::string udimMask = "<UDIM>";	
-    	pEnvMapTexture = pDevice->textureManager()->loadTexture(texture_file_name, generateMipLevels, loadAsSRGB, bindFlags, udimMask, loadAsSparse);
+			std::string udimMask = "<UDIM>";
+			auto pTextureManager = pDevice->textureManager();
+    	pEnvMapTexture = pTextureManager->loadTexture(texture_file_name, generateMipLevels, loadAsSRGB, bindFlags, udimMask, loadAsSparse);
+    	if(!pEnvMapTexture && loadAsSparse) {
+    		LLOG_WRN << "Unable to load environment map " << texture_file_name << " as virtual texture. Loading it as a regular texture.";
+    		pEnvMapTexture = pTextureManager->loadTexture(texture_file_name, generateMipLevels, loadAsSRGB, bindFlags, udimMask, false);
+    	}
+
+    	// Environment maps are not seen by the sparse textures resolve pass. Stream in mip levels up to the resolution limit
+    	// once, importance map and radiance evaluation stick to them.
+    	if(pEnvMapTexture && pEnvMapTexture->isSparse()) {
+    		const uint32_t maxResolution = static_cast<uint32_t>(std::max(1, pLightScope->getPropertyValue(ast::Style::LIGHT, kEnvmaxres, int(8192))));
+    		uint32_t mostDetailedMip = 0;
+    		while(mostDetailedMip + 1 < pEnvMapTexture->getMipCount() && pEnvMapTexture->getWidth(mostDetailedMip) > maxResolution) mostDetailedMip++;
+    		pTextureManager->loadMipLevels(pEnvMapTexture, mostDetailedMip);
+    	}
     }
     	
   	// New EnvironmentLight test
@@ -730,7 +896,6 @@ void Session::pushLight(const scope::Light::SharedPtr pLightScope) {
   		pLight = std::dynamic_pointer_cast<Falcor::Light>(pEnvLight);
   	} else {
   		auto pEnvLight = EnvironmentLight::create(light_name, pEnvMapTexture);
-  		pEnvLight->setTransformMatrix(transform);
 			
   		if(pEnvMapTexture) pEnvLight->setTexture(pEnvMapTexture);
   		pLight = std::dynamic_pointer_cast<Falcor::Light>(pEnvLight);
@@ -738,12 +903,14 @@ void Session::pushLight(const scope::Light::SharedPtr pLightScope) {
 
 	} else { 
 		LLOG_WRN << "Unsupported light type " << light_type << ". Skipping...";
-		return;
+		return nullptr;
 	}
 
 	if(pLight) {
 		LLOG_DBG << "Light " << light_name << "  type " << Falcor::to_string(pLight->getData().getLightType());
 
+		setLightTransform(pLight, transform);
+
 		if (light_name != "") {
 			pLight->setName(light_name);
 		}
@@ -751,13 +918,13 @@ void Session::pushLight(const scope::Light::SharedPtr pLightScope) {
 		pLight->setHasAnimation(false);
 		pLight->setCameraVisibility(visible_primary);
 
-		Property* pShadowProp = pLightScope->getProperty(ast::Style::LIGHT, "shadow");
+		Property* pShadowProp = pLightScope->getProperty(ast::Style::LIGHT, kShadow);
 		
 		// set shadow parameters
 		if (pShadowProp) {
 			auto pShadowProps = pShadowProp->subContainer();
 			if (pShadowProps) {
-				const std::string shadow_type_name = pShadowProps->getPropertyValue(ast::Style::LIGHT, "shadowtype", std::string(""));
+				const std::string shadow_type_name = pShadowProps->getPropertyValue(ast::Style::LIGHT, kShadowtype, std::string(""));
 				if (shadow_type_name == "filter") {
 					// alpha aware ray traced shadows
 					pLight->setShadowType(LightShadowType::RayTraced);
@@ -767,7 +934,7 @@ void Session::pushLight(const scope::Light::SharedPtr pLightScope) {
 				} else if (shadow_type_name == "deep") {
 					pLight->setShadowType(LightShadowType::ShadowMap);
 				}
-				const Falcor::float3 shadow_color = to_float3(pShadowProps->getPropertyValue(ast::Style::LIGHT, "shadow_color", lsd::Vector3{0.0, 0.0, 0.0}));
+				const Falcor::float3 shadow_color = to_float3(pShadowProps->getPropertyValue(ast::Style::LIGHT, kShadowColor, lsd::Vector3{0.0, 0.0, 0.0}));
 				pLight->setShadowColor(shadow_color);
 			}
 		}
@@ -779,6 +946,7 @@ void Session::pushLight(const scope::Light::SharedPtr pLightScope) {
 		uint32_t light_id = pSceneBuilder->addLight(pLight);
 		mLightsMap[light_name] = light_id;
 	}
+	return pLight;
 }
 
 void Session::cmdProperty(lsd::ast::Style style, const std::string& token, const Property::Value& value) {
@@ -825,9 +993,18 @@ void Session::cmdPropertyV(lsd::ast::Style style, const std::vector<std::pair<st
 }
 
 void Session::cmdProcedural(const std::string& procedural, const Vector3& bbox_min, const Vector3& bbox_max, const std::map<std::string, Property::Value>& arguments) {
-	if(procedural == "ptinstance") {
-
+	if(procedural == "ptinstance" || procedural == "volume") {
+		// Instances are expanded and volume files loaded when object scope ends
+		auto pObj = std::dynamic_pointer_cast<scope::Object>(mpCurrentScope);
+		if(!pObj) {
+			LLOG_ERR << "Procedural " << procedural << " declared outside of object scope !!!";
+			return;
+		}
+		pObj->setProcedural(procedural, arguments);
+		return;
 	}
+
+	LLOG_WRN << "Unsupported procedural " << procedural << " !!!";
 }
 
 
@@ -983,39 +1160,22 @@ bool Session::cmdEnd() {
 
 	switch(mpCurrentScope->type()) {
 		case ast::Style::GEO:
-			{
-				scope::Geo::SharedPtr pScopeGeo = std::dynamic_pointer_cast<scope::Geo>(mpCurrentScope);
-				if(!pScopeGeo) {
-					LLOG_ERR << "Error ending scope of type \"geometry\"!!!";
-					return false;
-				}
-
-				bool pushGeoAsync = mpGlobal->getPropertyValue(ast::Style::GLOBAL, "async_geo", bool(true));
-				if( pScopeGeo->isInline() || !pushGeoAsync) {
-					pushBgeo(pScopeGeo->detailName(), pScopeGeo);
-				} else {
-					pushBgeoAsync(pScopeGeo->detailName(), pScopeGeo);
-				}
-			}
-			break;
 		case ast::Style::OBJECT:
-			{
-				scope::Object::SharedPtr pScopeObj = std::dynamic_pointer_cast<scope::Object>(mpCurrentScope);
-				if(!pScopeObj) {
-					LLOG_ERR << "Error ending scope of type \"object\"!!!";
-					return false;
-				}
-
-				if(!pushGeometryInstance(pScopeObj)) {
-					mFailed = true;
-					return false;
-				}
-			}
+		case ast::Style::LIGHT:
+		case ast::Style::MATERIAL:
+			if(!submitScope(mpCurrentScope)) return false;
 			break;
 		case ast::Style::PLANE:
 			{
 				scope::Plane::SharedPtr pScopePlane = std::dynamic_pointer_cast<scope::Plane>(mpCurrentScope);
-				auto pPlane = mpRenderer->addAOVPlane(aovInfoFromLSD(pScopePlane));
+				const AOVPlaneInfo aovInfo = aovInfoFromLSD(pScopePlane);
+
+				// Multi-frame streams declare the same planes for every frame
+				auto pPlane = mpRenderer->hasAOVPlane(aovInfo.name) ? mpRenderer->getAOVPlane(aovInfo.name) : mpRenderer->addAOVPlane(aovInfo);
+				if (!pPlane) {
+					LLOG_FTL << "Error creating output plane " << std::string(aovInfo.name);
+					return false;
+				}
 				
 				// Check if output plane wants own display for image output
 				const std::string& display_filename = pPlane->filename();
@@ -1035,71 +1195,340 @@ bool Session::cmdEnd() {
 					pPlane->setDisplay(pDisplay);
 				}
 				
-				if (!pPlane) {
-					LLOG_FTL << "Error creating output plane " << pPlane->name();
-					return false;
-				}
 				translateLSDPlanePropertiesToLavaDict(pScopePlane, pPlane->getRenderPassesDict());
 			}
 			break;
+		case ast::Style::NODE:
+			{
+				scope::Node::SharedPtr pScopeNode = std::dynamic_pointer_cast<scope::Node>(mpCurrentScope);
+			}
+			break;
+		case ast::Style::SEGMENT:
+		case ast::Style::GLOBAL:
+			break;
+		default:
+			LLOG_ERR << "cmd_end makes no sense. Current scope type is " << to_string(mpCurrentScope->type()) << " !!!";
+			break;
+	}
+
+	mpCurrentScope = pParentScope;
+	return result;
+}
+
+bool Session::isSceneReuseEnabled() const {
+	return mpGlobal->getPropertyValue(ast::Style::GLOBAL, "scene_reuse", bool(false));
+}
+
+Session::ScopeRecord Session::makeScopeRecord(scope::ScopeBase::SharedPtr pScope) const {
+	ScopeRecord record;
+	record.type = pScope->type();
+
+	if(auto pTransformable = std::dynamic_pointer_cast<scope::Transformable>(pScope)) {
+		record.transform = pTransformable->getTransformList()[0];
+	}
+
+	// Signatures are only needed to compare frames
+	if(!isSceneReuseEnabled()) return record;
+
+	static const PropertyAtom kName("name");
+	static const PropertyAtom kMaterialname("materialname");
+
+	switch(record.type) {
+		case ast::Style::GEO:
+			record.key = std::dynamic_pointer_cast<scope::Geo>(pScope)->detailName();
+			break;
+		case ast::Style::MATERIAL:
+			record.key = pScope->getPropertyValue(ast::Style::OBJECT, kMaterialname, std::string());
+			break;
+		default:
+			record.key = pScope->getPropertyValue(ast::Style::OBJECT, kName, std::string());
+			break;
+	}
+	record.key = to_string(record.type) + ":" + record.key;
+
+	Falcor::SHA1 sha1;
+	hashProperties(sha1, *pScope);
+	record.comparable = true;
+
+	switch(record.type) {
+		case ast::Style::GEO:
+			{
+				// Inline geometry is parsed straight from the stream and has no content to compare with
+				auto pGeo = std::dynamic_pointer_cast<scope::Geo>(pScope);
+				hashString(sha1, pGeo->detailName());
+				record.comparable = !pGeo->isInline() && hashFileStamp(sha1, pGeo->detailFilePath());
+			}
+			break;
+		case ast::Style::OBJECT:
+			{
+				auto pObj = std::dynamic_pointer_cast<scope::Object>(pScope);
+				hashString(sha1, pObj->geometryName());
+				hashString(sha1, pObj->procedural());
+				for(const auto& [name, value]: pObj->proceduralArguments()) {
+					hashString(sha1, name);
+					hashValue(sha1, value);
+				}
+
+				// Only a single transform of a regular instance can be changed in place. Motion samples become node animation and
+				// point instances have instancer transform baked in. Instanced objects transforms are compared in cmdRaytrace()
+				const auto& transformList = pObj->getTransformList();
+				const uint64_t transformSamples = transformList.size();
+				sha1.update(&transformSamples, sizeof(transformSamples));
+				if(transformSamples > 1) hashTransforms(sha1, transformList);
+				if(pObj->procedural() == "ptinstance") {
+					hashTransforms(sha1, transformList);
+				} else if(pObj->procedural() == "volume") {
+					const auto& arguments = pObj->proceduralArguments();
+					auto it = arguments.find("file");
+					const std::string* pFilename = (it != arguments.end()) ? boost::get<std::string>(&it->second) : nullptr;
+					record.comparable = pFilename && hashFileStamp(sha1, fs::path(getExpandedString(*pFilename)));
+				}
+			}
+			break;
+		default:
+			break;
+	}
+
+	record.signature = sha1.final();
+	return record;
+}
+
+const Session::ScopeRecord* Session::matchPreviousRecord(FrameRecords& records, const ScopeRecord& record) const {
+	auto range = records.unmatched.equal_range(record.key);
+	for(auto it = range.first; it != range.second; ++it) {
+		const ScopeRecord& previous = records.previous[it->second];
+		if(!record.matches(previous)) continue;
+
+		records.unmatched.erase(it);
+		return &previous;
+	}
+	return nullptr;
+}
+
+bool Session::submitScope(scope::ScopeBase::SharedPtr pScope) {
+	FrameRecords& records = frameRecords(pScope->type());
+	records.scopes.push_back(pScope);
+	records.current.push_back(makeScopeRecord(pScope));
+
+	ScopeRecord& record = records.current.back();
+	const ScopeRecord* pPrevious = matchPreviousRecord(records, record);
+
+	// Unchanged geometry is kept loaded, so it's never read again even if the scene gets rebuilt
+	if(pPrevious) record.pBgeo = pPrevious->pBgeo;
+
+	if(mReusingScene) {
+		if(pPrevious) {
+			reuseScope(pScope, *pPrevious, record);
+			return true;
+		}
+
+		LLOG_INF << "Scope " << record.key << " differs from the previous frame. Rebuilding scene...";
+		return rebuildScene(); // Pushes all recorded scopes including this one
+	}
+
+	return pushScope(pScope, record);
+}
+
+bool Session::pushScope(scope::ScopeBase::SharedPtr pScope, ScopeRecord& record) {
+	static const PropertyAtom kAsyncGeo("async_geo");
+	static const PropertyAtom kMaterialname("materialname");
+	static const PropertyAtom kSurface("surface");
+
+	switch(pScope->type()) {
+		case ast::Style::GEO:
+			{
+				scope::Geo::SharedPtr pScopeGeo = std::dynamic_pointer_cast<scope::Geo>(pScope);
+				if(!pScopeGeo) {
+					LLOG_ERR << "Error ending scope of type \"geometry\"!!!";
+					return false;
+				}
+
+				bool pushGeoAsync = mpGlobal->getPropertyValue(ast::Style::GLOBAL, kAsyncGeo, bool(true));
+				if(record.pBgeo) {
+					// Geometry loaded by the previous frame
+					auto pSceneBuilder = mpRenderer->sceneBuilder();
+					if(pushGeoAsync) {
+						mMeshMap[pScopeGeo->detailName()] = pSceneBuilder->addGeometryAsync(record.pBgeo, pScopeGeo->detailName());
+					} else {
+						mMeshMap[pScopeGeo->detailName()] = pSceneBuilder->addGeometry(record.pBgeo, pScopeGeo->detailName());
+					}
+					if(pScopeGeo->isTemporary()) pSceneBuilder->addTemporaryGeometry(pScopeGeo->detailFilePath().string());
+				} else if( pScopeGeo->isInline() || !pushGeoAsync) {
+					pushBgeo(pScopeGeo->detailName(), pScopeGeo);
+					if(record.comparable) record.pBgeo = pScopeGeo->bgeo();
+				} else {
+					// Detail is only kept when it might be used by the next frame
+					if(record.comparable) record.pBgeo = ika::bgeo::Bgeo::create();
+					pushBgeoAsync(pScopeGeo->detailName(), pScopeGeo, record.pBgeo);
+				}
+			}
+			return true;
+		case ast::Style::OBJECT:
+			{
+				scope::Object::SharedPtr pScopeObj = std::dynamic_pointer_cast<scope::Object>(pScope);
+				if(!pScopeObj) {
+					LLOG_ERR << "Error ending scope of type \"object\"!!!";
+					return false;
+				}
+
+				record.nodeIDs.clear();
+				if(pScopeObj->procedural() == "ptinstance") {
+					// Instanced objects may still follow, so point instancers are pushed by cmdRaytrace()
+					mPendingPointInstancers.push_back(pScopeObj);
+					return true;
+				}
+
+				const bool pushed = pushGeometryInstance(pScopeObj, &record.nodeIDs);
+				if(!pushed) mFailed = true;
+				return pushed;
+			}
 		case ast::Style::LIGHT:
 			{
-				scope::Light::SharedPtr pScopeLight = std::dynamic_pointer_cast<scope::Light>(mpCurrentScope);
+				scope::Light::SharedPtr pScopeLight = std::dynamic_pointer_cast<scope::Light>(pScope);
 				if(!pScopeLight) {
 					LLOG_ERR << "Error ending scope of type \"light\"!!!";
 					return false;
 				}
-				pushLight(pScopeLight);
+				record.pLight = pushLight(pScopeLight);
 			}
-			break;
+			return true;
 		case ast::Style::MATERIAL:
 			{
-				scope::Material::SharedPtr pMaterialScope = std::dynamic_pointer_cast<scope::Material>(mpCurrentScope);
-				if(pMaterialScope) {
-					//auto pMaterialX = createMaterialXFromLSD(pMaterialScope);
-					//if (pMaterialX) {
-						//mpRenderer->addMaterialX(std::move(pMaterialX));
-					//}
+				scope::Material::SharedPtr pMaterialScope = std::dynamic_pointer_cast<scope::Material>(pScope);
+				if(!pMaterialScope) return false;
 
-					// Standard (fixed) material
-					std::string material_name = pMaterialScope->getPropertyValue(ast::Style::OBJECT, "materialname", std::string(random_string(8) + "_material"));
-					const Property* pShaderProp = pMaterialScope->getProperty(ast::Style::OBJECT, "surface");
+				//auto pMaterialX = createMaterialXFromLSD(pMaterialScope);
+				//if (pMaterialX) {
+					//mpRenderer->addMaterialX(std::move(pMaterialX));
+				//}
 
-					auto pMaterial = createStandardMaterialFromLSD(material_name, pShaderProp);
+				// Standard (fixed) material
+				std::string material_name = pMaterialScope->getPropertyValue(ast::Style::OBJECT, kMaterialname, std::string(random_string(8) + "_material"));
+				const Property* pShaderProp = pMaterialScope->getProperty(ast::Style::OBJECT, kSurface);
 
-					if(pMaterial) mpRenderer->addStandardMaterial(pMaterial);
-					
-				} else {
-					result = false;
-				}
+				auto pMaterial = createStandardMaterialFromLSD(material_name, pShaderProp);
+
+				if(pMaterial) mpRenderer->addStandardMaterial(pMaterial);
+			}
+			return true;
+		default:
+			LLOG_ERR << "Unable to push scope of type " << to_string(pScope->type()) << " !!!";
+			return false;
+	}
+}
+
+void Session::reuseScope(scope::ScopeBase::SharedPtr pScope, const ScopeRecord& previous, ScopeRecord& record) {
+	record.nodeIDs = previous.nodeIDs;
+	record.pLight = previous.pLight;
+
+	switch(pScope->type()) {
+		case ast::Style::GEO:
+			{
+				// Geometry stays loaded, but it's temporary file still has to be removed along with the scene builder
+				auto pGeo = std::dynamic_pointer_cast<scope::Geo>(pScope);
+				if(pGeo->isTemporary()) mpRenderer->sceneBuilder()->addTemporaryGeometry(pGeo->detailFilePath().string());
 			}
 			break;
-		case ast::Style::NODE:
+		case ast::Style::OBJECT:
 			{
-				scope::Node::SharedPtr pScopeNode = std::dynamic_pointer_cast<scope::Node>(mpCurrentScope);
+				if((record.transform == previous.transform) || record.nodeIDs.empty()) break;
+
+				auto pScene = mpRenderer->sceneBuilder()->getScene();
+				for(uint32_t nodeID: record.nodeIDs) pScene->updateNodeTransform(nodeID, record.transform);
 			}
 			break;
-		case ast::Style::SEGMENT:
-		case ast::Style::GLOBAL:
+		case ast::Style::LIGHT:
+			if(record.pLight && (record.transform != previous.transform)) setLightTransform(record.pLight, record.transform);
 			break;
 		default:
-			LLOG_ERR << "cmd_end makes no sense. Current scope type is " << to_string(mpCurrentScope->type()) << " !!!";
 			break;
 	}
+}
 
-	mpCurrentScope = pParentScope;
+bool Session::rebuildScene() {
+	mReusingScene = false;
+
+	mpRenderer->resetScene();
+	mMeshMap.clear();
+	mLightsMap.clear();
+	mPendingPointInstancers.clear();
+
+	bool result = true;
+	for(FrameRecords* pRecords: {&mObjectRecords, &mLightRecords}) {
+		for(size_t i = 0; i < pRecords->scopes.size(); i++) {
+			result = pushScope(pRecords->scopes[i], pRecords->current[i]) && result;
+		}
+	}
 	return result;
 }
 
+void Session::cmdReset(bool lights, bool objects, bool fogs) {
+	// Plain ray_reset resets everything
+	if(!lights && !objects && !fogs) lights = objects = fogs = true;
+
+	LLOG_DBG << "cmdReset lights " << lights << " objects " << objects << " fogs " << fogs;
+
+	// Only successfully loaded geometry is worth keeping for the next frame
+	for(size_t i = 0; i < mObjectRecords.current.size(); i++) {
+		ScopeRecord& record = mObjectRecords.current[i];
+		if(!record.pBgeo) continue;
+
+		auto it = mMeshMap.find(std::dynamic_pointer_cast<scope::Geo>(mObjectRecords.scopes[i])->detailName());
+		uint32_t mesh_id = SceneBuilder::kInvalidGeometryID;
+		if(it != mMeshMap.end()) {
+			if(const uint32_t* pMeshID = std::get_if<uint32_t>(&it->second)) {
+				mesh_id = *pMeshID;
+			} else {
+				try {
+					mesh_id = std::get<Falcor::TaskScheduler::Future<uint32_t>>(it->second).get();
+				} catch(const std::exception&) {}
+			}
+		}
+		if(mesh_id == SceneBuilder::kInvalidGeometryID) record.pBgeo.reset();
+	}
+
+	auto resetRecords = [](FrameRecords& records, bool reset) {
+		records.previous = records.current;
+		records.unmatched.clear();
+		if(!reset) return;
+
+		// Scopes of the new frame are matched to these by their keys
+		for(size_t i = 0; i < records.previous.size(); i++) records.unmatched.emplace(records.previous[i].key, i);
+		records.current.clear();
+		records.scopes.clear();
+	};
+
+	resetRecords(mObjectRecords, objects);
+	resetRecords(mLightRecords, lights);
+
+	if(objects) mpGlobal->resetObjects();
+	if(lights) mpGlobal->resetLights();
+
+	// Fog scopes are not supported, so there is nothing to reset for them
+
+	if(isSceneReuseEnabled()) {
+		// Rendered scene stays until the new frame differs from the previous one
+		mReusingScene = !mFirstRun;
+	} else {
+		rebuildScene();
+	}
+}
+
 void Session::addMxNode(Falcor::MxNode::SharedPtr pParent, scope::Node::SharedConstPtr pNodeLSD) {
+	static const PropertyAtom kIsSubnet("is_subnet");
+	static const PropertyAtom kNodeName("node_name");
+	static const PropertyAtom kNodeType("node_type");
+	static const PropertyAtom kNodeUuid("node_uuid");
+	static const PropertyAtom kNodeNamespace("node_namespace");
+
 	return;
 	assert(pParent);
 
-	bool is_subnet = pNodeLSD->getPropertyValue(ast::Style::OBJECT, "is_subnet", bool(false));
-	std::string node_name = pNodeLSD->getPropertyValue(ast::Style::OBJECT, "node_name", std::string(""));
-	std::string node_type = pNodeLSD->getPropertyValue(ast::Style::OBJECT, "node_type", std::string(""));
-	std::string node_uuid = pNodeLSD->getPropertyValue(ast::Style::OBJECT, "node_uuid", std::string(""));
-	std::string node_namespace = pNodeLSD->getPropertyValue(ast::Style::OBJECT, "node_namespace", std::string("houdini"));
+	bool is_subnet = pNodeLSD->getPropertyValue(ast::Style::OBJECT, kIsSubnet, bool(false));
+	std::string node_name = pNodeLSD->getPropertyValue(ast::Style::OBJECT, kNodeName, std::string(""));
+	std::string node_type = pNodeLSD->getPropertyValue(ast::Style::OBJECT, kNodeType, std::string(""));
+	std::string node_uuid = pNodeLSD->getPropertyValue(ast::Style::OBJECT, kNodeUuid, std::string(""));
+	std::string node_namespace = pNodeLSD->getPropertyValue(ast::Style::OBJECT, kNodeNamespace, std::string("houdini"));
 
 	MxNode::TypeCreateInfo info = {};
     info.nameSpace = node_namespace;
@@ -1152,8 +1581,10 @@ void Session::addMxNode(Falcor::MxNode::SharedPtr pParent, scope::Node::SharedCo
 }
 
 Falcor::MaterialX::UniquePtr Session::createMaterialXFromLSD(scope::Material::SharedConstPtr pMaterialLSD) {
+	static const PropertyAtom kMaterialName("material_name");
+
 	
-	std::string material_name = pMaterialLSD->getPropertyValue(ast::Style::OBJECT, "material_name", std::string(""));
+	std::string material_name = pMaterialLSD->getPropertyValue(ast::Style::OBJECT, kMaterialName, std::string(""));
 
 	// We create material without device at this stage. Actual device would be set up for this material later by the
 	// renderer itself.
@@ -1167,6 +1598,35 @@ Falcor::MaterialX::UniquePtr Session::createMaterialXFromLSD(scope::Material::Sh
 }
 
 Falcor::StandardMaterial::SharedPtr Session::createStandardMaterialFromLSD(const std::string& material_name, const Property* pShaderProp) {
+	static const PropertyAtom kBasecolor("basecolor");
+	static const PropertyAtom kBasecolorTexture("basecolor_texture");
+	static const PropertyAtom kBaseNormalTexture("baseNormal_texture");
+	static const PropertyAtom kBaseBumpBumpTexture("baseBump_bumpTexture");
+	static const PropertyAtom kMetallicTexture("metallic_texture");
+	static const PropertyAtom kRoughTexture("rough_texture");
+	static const PropertyAtom kEmitcolorTexture("emitcolor_texture");
+	static const PropertyAtom kBasecolorUseTexture("basecolor_useTexture");
+	static const PropertyAtom kMetallicUseTexture("metallic_useTexture");
+	static const PropertyAtom kRoughUseTexture("rough_useTexture");
+	static const PropertyAtom kEmitcolorUseTexture("emitcolor_useTexture");
+	static const PropertyAtom kBaseBumpAndNormalEnable("baseBumpAndNormal_enable");
+	static const PropertyAtom kIor("ior");
+	static const PropertyAtom kMetallic("metallic");
+	static const PropertyAtom kRough("rough");
+	static const PropertyAtom kReflect("reflect");
+	static const PropertyAtom kEmitcolor("emitcolor");
+	static const PropertyAtom kEmitint("emitint");
+	static const PropertyAtom kTranscolor("transcolor");
+	static const PropertyAtom kTransparency("transparency");
+	static const PropertyAtom kBaseNormalFlipX("baseNormal_flipX");
+	static const PropertyAtom kBaseNormalFlipY("baseNormal_flipY");
+	static const PropertyAtom kBaseNormalScale("baseNormal_scale");
+	static const PropertyAtom kBaseBumpBumpScale("baseBump_bumpScale");
+	static const PropertyAtom kBaseBumpAndNormalType("baseBumpAndNormal_type");
+	static const PropertyAtom kAoDistance("ao_distance");
+	static const PropertyAtom kFrontface("frontface");
+	static const PropertyAtom kVtoff("vtoff");
+
 	auto pSceneBuilder = mpRenderer->sceneBuilder();
 	if (!pSceneBuilder) {
 		LLOG_ERR << "Unable to create standard material \"" << material_name << "\". SceneBuilder not ready !!!";
@@ -1212,42 +1672,42 @@ Falcor::StandardMaterial::SharedPtr Session::createStandardMaterialFromLSD(const
 
   if(pShaderProp) {
   	auto pShaderProps = pShaderProp->subContainer();
-  	surface_base_color = to_float3(pShaderProps->getPropertyValue(ast::Style::OBJECT, "basecolor", lsd::Vector3{0.2, 0.2, 0.2}));
-  	surface_base_color_texture_path = pShaderProps->getPropertyValue(ast::Style::OBJECT, "basecolor_texture", std::string());
-  	surface_base_normal_texture_path = pShaderProps->getPropertyValue(ast::Style::OBJECT, "baseNormal_texture", std::string());
-  	surface_base_bump_texture_path = pShaderProps->getPropertyValue(ast::Style::OBJECT, "baseBump_bumpTexture", std::string());
-  	surface_metallic_texture_path = pShaderProps->getPropertyValue(ast::Style::OBJECT, "metallic_texture", std::string());
-  	surface_roughness_texture_path = pShaderProps->getPropertyValue(ast::Style::OBJECT, "rough_texture", std::string());
-  	surface_emission_texture_path = pShaderProps->getPropertyValue(ast::Style::OBJECT, "emitcolor_texture", std::string());
+  	surface_base_color = to_float3(pShaderProps->getPropertyValue(ast::Style::OBJECT, kBasecolor, lsd::Vector3{0.2, 0.2, 0.2}));
+  	surface_base_color_texture_path = pShaderProps->getPropertyValue(ast::Style::OBJECT, kBasecolorTexture, std::string());
+  	surface_base_normal_texture_path = pShaderProps->getPropertyValue(ast::Style::OBJECT, kBaseNormalTexture, std::string());
+  	surface_base_bump_texture_path = pShaderProps->getPropertyValue(ast::Style::OBJECT, kBaseBumpBumpTexture, std::string());
+  	surface_metallic_texture_path = pShaderProps->getPropertyValue(ast::Style::OBJECT, kMetallicTexture, std::string());
+  	surface_roughness_texture_path = pShaderProps->getPropertyValue(ast::Style::OBJECT, kRoughTexture, std::string());
+  	surface_emission_texture_path = pShaderProps->getPropertyValue(ast::Style::OBJECT, kEmitcolorTexture, std::string());
 
-  	surface_use_basecolor_texture = pShaderProps->getPropertyValue(ast::Style::OBJECT, "basecolor_useTexture", false);
-  	surface_use_metallic_texture = pShaderProps->getPropertyValue(ast::Style::OBJECT, "metallic_useTexture", false);
-  	surface_use_roughness_texture = pShaderProps->getPropertyValue(ast::Style::OBJECT, "rough_useTexture", false);
-  	surface_use_emission_texture = pShaderProps->getPropertyValue(ast::Style::OBJECT, "emitcolor_useTexture", false);
-  	surface_use_basenormal_texture = pShaderProps->getPropertyValue(ast::Style::OBJECT, "baseBumpAndNormal_enable", false);
+  	surface_use_basecolor_texture = pShaderProps->getPropertyValue(ast::Style::OBJECT, kBasecolorUseTexture, false);
+  	surface_use_metallic_texture = pShaderProps->getPropertyValue(ast::Style::OBJECT, kMetallicUseTexture, false);
+  	surface_use_roughness_texture = pShaderProps->getPropertyValue(ast::Style::OBJECT, kRoughUseTexture, false);
+  	surface_use_emission_texture = pShaderProps->getPropertyValue(ast::Style::OBJECT, kEmitcolorUseTexture, false);
+  	surface_use_basenormal_texture = pShaderProps->getPropertyValue(ast::Style::OBJECT, kBaseBumpAndNormalEnable, false);
 
-  	surface_ior = pShaderProps->getPropertyValue(ast::Style::OBJECT, "ior", 1.5f);
-  	surface_metallic = pShaderProps->getPropertyValue(ast::Style::OBJECT, "metallic", 0.0f);
-  	surface_roughness = pShaderProps->getPropertyValue(ast::Style::OBJECT, "rough", 0.3f);
-  	surface_reflectivity = pShaderProps->getPropertyValue(ast::Style::OBJECT, "reflect", 1.0f);
+  	surface_ior = pShaderProps->getPropertyValue(ast::Style::OBJECT, kIor, 1.5f);
+  	surface_metallic = pShaderProps->getPropertyValue(ast::Style::OBJECT, kMetallic, 0.0f);
+  	surface_roughness = pShaderProps->getPropertyValue(ast::Style::OBJECT, kRough, 0.3f);
+  	surface_reflectivity = pShaderProps->getPropertyValue(ast::Style::OBJECT, kReflect, 1.0f);
 
-  	emissive_color = to_float3(pShaderProps->getPropertyValue(ast::Style::OBJECT, "emitcolor", lsd::Vector3{1.0, 1.0, 1.0}));
-  	emissive_factor = pShaderProps->getPropertyValue(ast::Style::OBJECT, "emitint", 0.0f);
+  	emissive_color = to_float3(pShaderProps->getPropertyValue(ast::Style::OBJECT, kEmitcolor, lsd::Vector3{1.0, 1.0, 1.0}));
+  	emissive_factor = pShaderProps->getPropertyValue(ast::Style::OBJECT, kEmitint, 0.0f);
 
-  	trans_color = to_float3(pShaderProps->getPropertyValue(ast::Style::OBJECT, "transcolor", lsd::Vector3{1.0, 1.0, 1.0}));
-  	transmission = pShaderProps->getPropertyValue(ast::Style::OBJECT, "transparency", 0.0f);
+  	trans_color = to_float3(pShaderProps->getPropertyValue(ast::Style::OBJECT, kTranscolor, lsd::Vector3{1.0, 1.0, 1.0}));
+  	transmission = pShaderProps->getPropertyValue(ast::Style::OBJECT, kTransparency, 0.0f);
 
-  	basenormal_flip_x = pShaderProps->getPropertyValue(ast::Style::OBJECT, "baseNormal_flipX", false);
-  	basenormal_flip_y = pShaderProps->getPropertyValue(ast::Style::OBJECT, "baseNormal_flipY", false);
+  	basenormal_flip_x = pShaderProps->getPropertyValue(ast::Style::OBJECT, kBaseNormalFlipX, false);
+  	basenormal_flip_y = pShaderProps->getPropertyValue(ast::Style::OBJECT, kBaseNormalFlipY, false);
 
-  	basenormal_scale = pShaderProps->getPropertyValue(ast::Style::OBJECT, "baseNormal_scale", 1.0f);
-  	basebump_scale = pShaderProps->getPropertyValue(ast::Style::OBJECT, "baseBump_bumpScale", 0.05f);
+  	basenormal_scale = pShaderProps->getPropertyValue(ast::Style::OBJECT, kBaseNormalScale, 1.0f);
+  	basebump_scale = pShaderProps->getPropertyValue(ast::Style::OBJECT, kBaseBumpBumpScale, 0.05f);
 
-  	basenormal_mode = pShaderProps->getPropertyValue(ast::Style::OBJECT, "baseBumpAndNormal_type", std::string("normal"));
+  	basenormal_mode = pShaderProps->getPropertyValue(ast::Style::OBJECT, kBaseBumpAndNormalType, std::string("normal"));
 
-  	ao_distance = pShaderProps->getPropertyValue(ast::Style::OBJECT, "ao_distance", 1.0f);
+  	ao_distance = pShaderProps->getPropertyValue(ast::Style::OBJECT, kAoDistance, 1.0f);
 
-  	front_face = pShaderProps->getPropertyValue(ast::Style::OBJECT, "frontface", false);
+  	front_face = pShaderProps->getPropertyValue(ast::Style::OBJECT, kFrontface, false);
   } else {
   	LLOG_ERR << "No surface property set for materialname " << material_name;
   }
@@ -1283,7 +1743,7 @@ Falcor::StandardMaterial::SharedPtr Session::createStandardMaterialFromLSD(const
     pMaterial->setNormalBumpMapFactor(_normal_bump_scale);
 
   	//bool loadAsSrgb = true;
-    bool loadTexturesAsSparse = !mpGlobal->getPropertyValue(ast::Style::GLOBAL, "vtoff", bool(false));
+    bool loadTexturesAsSparse = !mpGlobal->getPropertyValue(ast::Style::GLOBAL, kVtoff, bool(false));
 
     LLOG_TRC << "Setting " << (loadTexturesAsSparse ? "sparse" : "simple") << " textures for material: " << pMaterial->getName();
 
@@ -1337,10 +1797,41 @@ bool Session::cmdSocket(Falcor::MxSocketDirection direction, Falcor::MxSocketDat
 	return true;
 }
 
-bool Session::pushGeometryInstance(scope::Object::SharedConstPtr pObj) {
+bool Session::pushGeometryInstance(scope::Object::SharedConstPtr pObj, std::vector<uint32_t>* pNodeIDs) {
 	assert(pObj);
 
-	LLOG_DBG << "pushGeometryInstance for geometry (mesh) name: " << pObj->geometryName();
+	// Transform motion blur. All ray_mtransform samples span the object shutter interval
+	const auto& transformList = pObj->getTransformList();
+	return pushGeometryInstances(pObj, transformList, transformList.size(), pNodeIDs);
+}
+
+bool Session::pushGeometryInstances(scope::Object::SharedConstPtr pObj, const std::vector<glm::mat4>& transforms, size_t samplesCount, std::vector<uint32_t>* pNodeIDs) {
+	static const PropertyAtom kId("id");
+	static const PropertyAtom kName("name");
+	static const PropertyAtom kSurface("surface");
+	static const PropertyAtom kMaterialname("materialname");
+	static const PropertyAtom kMatte("matte");
+	static const PropertyAtom kFixShadow("fix_shadow");
+	static const PropertyAtom kBiasnormal("biasnormal");
+	static const PropertyAtom kDoubleSided("double_sided");
+	static const PropertyAtom kVisiblePrimary("visible_primary");
+	static const PropertyAtom kVisibleShadows("visible_shadows");
+	static const PropertyAtom kVisibleDiffuse("visible_diffuse");
+	static const PropertyAtom kVisibleReflect("visible_reflect");
+	static const PropertyAtom kVisibleRefract("visible_refract");
+	static const PropertyAtom kReceiveShadows("receive_shadows");
+	static const PropertyAtom kReceiveSelfShadows("receive_self_shadows");
+	static const PropertyAtom kVolumeDensityscale("volume_densityscale");
+	static const PropertyAtom kVolumeEmissionscale("volume_emissionscale");
+	static const PropertyAtom kVolumeTemperature("volume_temperature");
+	static const PropertyAtom kVolumeAlbedo("volume_albedo");
+	static const PropertyAtom kVolumeAnisotropy("volume_anisotropy");
+
+	assert(pObj);
+
+	assert(samplesCount > 0 && transforms.size() % samplesCount == 0);
+
+	LLOG_DBG << "pushGeometryInstances for geometry (mesh) name: " << pObj->geometryName() << " instances count: " << transforms.size() / samplesCount;
 	
 	auto pSceneBuilder = mpRenderer->sceneBuilder();
 	if (!pSceneBuilder) {
@@ -1348,26 +1839,30 @@ bool Session::pushGeometryInstance(scope::Object::SharedConstPtr pObj) {
 		return false;
 	}
 
-	auto it = mMeshMap.find(pObj->geometryName());
+	// Volume procedural geometry comes from a VDB file instead of a geometry scope
+	const std::string geometry_name = (pObj->procedural() == "volume") ? pushVolumeGeometry(pObj) : pObj->geometryName();
+	if(geometry_name.empty()) return false;
+
+	auto it = mMeshMap.find(geometry_name);
 	if(it == mMeshMap.end()) {
-		LLOG_ERR << "No geometry found for name " << pObj->geometryName();
+		LLOG_ERR << "No geometry found for name " << geometry_name;
 		return false;
 	}
 
 	uint32_t exportedInstanceID = SceneBuilder::kInvalidExportedID;
-	const Property* pIDProperty = pObj->getProperty(ast::Style::OBJECT, "id");
+	const Property* pIDProperty = pObj->getProperty(ast::Style::OBJECT, kId);
 	if(pIDProperty) {
 		exportedInstanceID = pIDProperty->get<uint32_t>();
 	}
-	std::string obj_name = pObj->getPropertyValue(ast::Style::OBJECT, "name", std::string());
+	std::string obj_name = pObj->getPropertyValue(ast::Style::OBJECT, kName, std::string());
 
 	uint32_t mesh_id = std::numeric_limits<uint32_t>::max();
 
 	try {
 		mesh_id = std::get<uint32_t>(it->second);	
-		LLOG_DBG << "Getting sync mesh_id for obj name instance: "  << obj_name << " geo name: " << pObj->geometryName();
+		LLOG_DBG << "Getting sync mesh_id for obj name instance: "  << obj_name << " geo name: " << geometry_name;
 	} catch (const std::bad_variant_access&) {
-		auto& f = std::get<std::shared_future<uint32_t>>(it->second);
+		auto& f = std::get<Falcor::TaskScheduler::Future<uint32_t>>(it->second);
 		try {
 			mesh_id = f.get();
 			LLOG_DBG << "Getting async mesh_id for obj_name " << obj_name;	
@@ -1386,22 +1881,8 @@ bool Session::pushGeometryInstance(scope::Object::SharedConstPtr pObj) {
 
 	LLOG_TRC << "mesh_id " << mesh_id;
 
-	Falcor::SceneBuilder::Node node = {};
-	node.name = it->first;
-	node.transform = pObj->getTransformList()[0];
-	node.meshBind = glm::mat4(1);          // For skinned meshes. World transform at bind time.
-    node.localToBindPose = glm::mat4(1);   // For bones. Inverse bind transform.
-	/*
-		glm::mat4(1), // For skinned meshes. World transform at bind time.
-		glm::mat4(1), // For bones. Inverse bind transform.
-		Falcor::SceneBuilder::kInvalidNode // just a node with no parent
-	};
-	*/
-
-	uint32_t node_id = pSceneBuilder->addNode(node);
-
-	const Property* pShaderProp = pObj->getProperty(ast::Style::OBJECT, "surface");
-  std::string material_name = pObj->getPropertyValue(ast::Style::OBJECT, "materialname", std::string(obj_name + "_material"));
+	const Property* pShaderProp = pObj->getProperty(ast::Style::OBJECT, kSurface);
+  std::string material_name = pObj->getPropertyValue(ast::Style::OBJECT, kMaterialname, std::string(obj_name + "_material"));
     
 	Falcor::StandardMaterial::SharedPtr pMaterial = std::dynamic_pointer_cast<Falcor::StandardMaterial>(pSceneBuilder->getMaterial(material_name));
 	
@@ -1417,29 +1898,251 @@ bool Session::pushGeometryInstance(scope::Object::SharedConstPtr pObj) {
 
   // Instance shading spec
   SceneBuilder::InstanceShadingSpec shadingSpec;
-  shadingSpec.isMatte = pObj->getPropertyValue(ast::Style::OBJECT, "matte", false);
-  shadingSpec.fixShadowTerminator = pObj->getPropertyValue(ast::Style::OBJECT, "fix_shadow", true);
-  shadingSpec.biasAlongNormal = pObj->getPropertyValue(ast::Style::OBJECT, "biasnormal", false);
-  shadingSpec.doubleSided = pObj->getPropertyValue(ast::Style::OBJECT, "double_sided", true);
+  shadingSpec.isMatte = pObj->getPropertyValue(ast::Style::OBJECT, kMatte, false);
+  shadingSpec.fixShadowTerminator = pObj->getPropertyValue(ast::Style::OBJECT, kFixShadow, true);
+  shadingSpec.biasAlongNormal = pObj->getPropertyValue(ast::Style::OBJECT, kBiasnormal, false);
+  shadingSpec.doubleSided = pObj->getPropertyValue(ast::Style::OBJECT, kDoubleSided, true);
 
   // Instance visibility spec
   SceneBuilder::InstanceVisibilitySpec visibilitySpec;
-  visibilitySpec.visibleToPrimaryRays = pObj->getPropertyValue(ast::Style::OBJECT, "visible_primary", true);
-  visibilitySpec.visibleToShadowRays = pObj->getPropertyValue(ast::Style::OBJECT, "visible_shadows", true);
-  visibilitySpec.visibleToDiffuseRays = pObj->getPropertyValue(ast::Style::OBJECT, "visible_diffuse", true);
-  visibilitySpec.visibleToReflectionRays = pObj->getPropertyValue(ast::Style::OBJECT, "visible_reflect", true);
-  visibilitySpec.visibleToRefractionRays = pObj->getPropertyValue(ast::Style::OBJECT, "visible_refract", true);
-  visibilitySpec.receiveShadows = pObj->getPropertyValue(ast::Style::OBJECT, "receive_shadows", true);
-  visibilitySpec.receiveSelfShadows = pObj->getPropertyValue(ast::Style::OBJECT, "receive_self_shadows", true);
+  visibilitySpec.visibleToPrimaryRays = pObj->getPropertyValue(ast::Style::OBJECT, kVisiblePrimary, true);
+  visibilitySpec.visibleToShadowRays = pObj->getPropertyValue(ast::Style::OBJECT, kVisibleShadows, true);
+  visibilitySpec.visibleToDiffuseRays = pObj->getPropertyValue(ast::Style::OBJECT, kVisibleDiffuse, true);
+  visibilitySpec.visibleToReflectionRays = pObj->getPropertyValue(ast::Style::OBJECT, kVisibleReflect, true);
+  visibilitySpec.visibleToRefractionRays = pObj->getPropertyValue(ast::Style::OBJECT, kVisibleRefract, true);
+  visibilitySpec.receiveShadows = pObj->getPropertyValue(ast::Style::OBJECT, kReceiveShadows, true);
+  visibilitySpec.receiveSelfShadows = pObj->getPropertyValue(ast::Style::OBJECT, kReceiveSelfShadows, true);
   
+  // Grid volume parameters for volume geometries
+  SceneBuilder::VolumeShadingSpec volumeSpec;
+  volumeSpec.densityScale = pObj->getPropertyValue(ast::Style::OBJECT, kVolumeDensityscale, 1.0f);
+  volumeSpec.emissionScale = pObj->getPropertyValue(ast::Style::OBJECT, kVolumeEmissionscale, 1.0f);
+  volumeSpec.emissionTemperature = pObj->getPropertyValue(ast::Style::OBJECT, kVolumeTemperature, 0.0f);
+  volumeSpec.albedo = to_float3(pObj->getPropertyValue(ast::Style::OBJECT, kVolumeAlbedo, lsd::Vector3{1.0, 1.0, 1.0}));
+  volumeSpec.anisotropy = pObj->getPropertyValue(ast::Style::OBJECT, kVolumeAnisotropy, 0.0f);
+
   SceneBuilder::MeshInstanceCreationSpec creationSpec;
   creationSpec.pExportedDataSpec = &exportedSpec;
   creationSpec.pVisibilitySpec = &visibilitySpec;
   creationSpec.pShadingSpec = &shadingSpec;
   creationSpec.pMaterialOverride = pMaterial;
 
-  // Add a mesh instance to a node
-  return pSceneBuilder->addMeshInstance(node_id, mesh_id, &creationSpec);
+  bool result = true;
+  for(size_t i = 0; i < transforms.size(); i += samplesCount) {
+	Falcor::SceneBuilder::Node node = {};
+	node.name = it->first;
+	node.transform = transforms[i];
+	node.meshBind = glm::mat4(1);          // For skinned meshes. World transform at bind time.
+    node.localToBindPose = glm::mat4(1);   // For bones. Inverse bind transform.
+
+	uint32_t node_id = pSceneBuilder->addNode(node);
+	if(pNodeIDs) {
+		pNodeIDs->push_back(node_id);
+		// Node transform might be updated in place in the following frames
+		if(isSceneReuseEnabled()) pSceneBuilder->setNodeDontOptimize(node_id);
+	}
+
+	if(samplesCount > 1) {
+		const std::vector<glm::mat4> samples(transforms.begin() + i, transforms.begin() + i + samplesCount);
+		pSceneBuilder->addNodeTransformMotion(node_id, samples);
+	}
+
+	// Add a geometry (mesh, it's packed primitives and volumes) instance to a node
+	result = pSceneBuilder->addGeometryInstance(node_id, mesh_id, &creationSpec, &volumeSpec) && result;
+  }
+  return result;
+}
+
+namespace {
+
+// Houdini point instancing transform: translate(P + trans) * rotation * scale(pscale * scale) * translate(-pivot)
+// where rotation comes from orient or, if missing, from N/up frame
+struct PointInstanceAttributes {
+	std::vector<float> P, orient, N, up, pscale, scale, trans, pivot;
+
+	glm::mat4 transform(size_t i) const {
+		glm::mat4 rotation(1.f);
+		if(!orient.empty()) {
+			rotation = glm::mat4_cast(glm::quat(orient[i*4+3], orient[i*4], orient[i*4+1], orient[i*4+2]));
+		} else if(!N.empty()) {
+			const glm::vec3 z = glm::normalize(glm::vec3(N[i*3], N[i*3+1], N[i*3+2]));
+			glm::vec3 y = up.empty() ? glm::vec3(0.f, 1.f, 0.f) : glm::vec3(up[i*3], up[i*3+1], up[i*3+2]);
+			glm::vec3 x = glm::cross(y, z);
+			if(glm::dot(x, x) < 1e-12f) x = glm::cross(glm::vec3(1.f, 0.f, 0.f), z);
+			x = glm::normalize(x);
+			y = glm::cross(z, x);
+			rotation = glm::mat4(glm::vec4(x, 0.f), glm::vec4(y, 0.f), glm::vec4(z, 0.f), glm::vec4(0.f, 0.f, 0.f, 1.f));
+		}
+
+		glm::vec3 s(pscale.empty() ? 1.f : pscale[i]);
+		if(!scale.empty()) s *= glm::vec3(scale[i*3], scale[i*3+1], scale[i*3+2]);
+
+		glm::vec3 t(P[i*3], P[i*3+1], P[i*3+2]);
+		if(!trans.empty()) t += glm::vec3(trans[i*3], trans[i*3+1], trans[i*3+2]);
+
+		glm::mat4 m = glm::translate(glm::mat4(1.f), t) * rotation * glm::scale(glm::mat4(1.f), s);
+		if(!pivot.empty()) m = m * glm::translate(glm::mat4(1.f), -glm::vec3(pivot[i*3], pivot[i*3+1], pivot[i*3+2]));
+		return m;
+	}
+};
+
+template<typename T>
+T proceduralArgument(const scope::Object::ProceduralArguments& arguments, const std::string& name, const T& default_value) {
+	auto it = arguments.find(name);
+	if(it == arguments.end()) return default_value;
+	if(const T* pValue = boost::get<T>(&it->second)) return *pValue;
+	LLOG_WRN << "Procedural argument " << name << " type mismatch !";
+	return default_value;
+}
+
+}  // namespace
+
+std::string Session::pushVolumeGeometry(scope::Object::SharedConstPtr pObj) {
+	assert(pObj);
+
+	const auto& arguments = pObj->proceduralArguments();
+	const std::string filename = getExpandedString(proceduralArgument(arguments, "file", std::string()));
+	if(filename.empty()) {
+		LLOG_ERR << "Volume procedural requires \"file\" argument !!!";
+		return {};
+	}
+
+	// Explicit emission grid takes precedence over temperature (blackbody) one
+	const std::string density_grid = proceduralArgument(arguments, "density", std::string("density"));
+	const std::string emission_grid = proceduralArgument(arguments, "emission", std::string());
+	const std::string temperature_grid = proceduralArgument(arguments, "temperature", std::string());
+	const bool blackbody = emission_grid.empty() && !temperature_grid.empty();
+
+	const std::string geometry_name = "volume:" + filename + ":" + density_grid + ":" + (blackbody ? temperature_grid : emission_grid);
+	if(mMeshMap.find(geometry_name) != mMeshMap.end()) return geometry_name;
+
+	const uint32_t geometry_id = mpRenderer->sceneBuilder()->addVolumeGeometry(filename, density_grid, blackbody ? temperature_grid : emission_grid, blackbody);
+	if(geometry_id == SceneBuilder::kInvalidGeometryID) return {};
+
+	mMeshMap[geometry_name] = geometry_id;
+	return geometry_name;
+}
+
+bool Session::pushPointInstances(scope::Object::SharedConstPtr pObj) {
+	static const PropertyAtom kName("name");
+
+	assert(pObj);
+
+	const auto& arguments = pObj->proceduralArguments();
+	const std::string default_instance_path = proceduralArgument(arguments, "instancepath", std::string());
+	const bool instance_xform = proceduralArgument(arguments, "instancexform", int(1)) != 0;
+
+	// Point cloud detail
+	scope::Geo::SharedPtr pPointsGeo;
+	for(const auto& pGeo: mpGlobal->geos()) {
+		if(pGeo->detailName() == pObj->geometryName()) {
+			pPointsGeo = pGeo;
+			break;
+		}
+	}
+	if(!pPointsGeo) {
+		LLOG_ERR << "No point instancing geometry found for name " << pObj->geometryName();
+		return false;
+	}
+
+	ika::bgeo::Bgeo::SharedPtr pBgeo;
+	if(pPointsGeo->isInline()) {
+		pBgeo = pPointsGeo->bgeo();
+	} else {
+		pBgeo = ika::bgeo::Bgeo::create();
+		try {
+			pBgeo->readGeoFromFile(pPointsGeo->detailFilePath().string().c_str(), false); // FIXME: don't check version for now
+		} catch (const std::exception& e) {
+			LLOG_ERR << "Error loading point instancing geometry " << pPointsGeo->detailFilePath() << " : " << e.what();
+			return false;
+		}
+	}
+
+	const size_t point_count = static_cast<size_t>(pBgeo->getPointCount());
+	if(point_count == 0) return true;
+
+	PointInstanceAttributes attribs;
+	pBgeo->getP(attribs.P);
+	if(!pBgeo->getPointFloatAttribute("orient", 4, attribs.orient)) {
+		pBgeo->getPointFloatAttribute("N", 3, attribs.N);
+		pBgeo->getPointFloatAttribute("up", 3, attribs.up);
+	}
+	pBgeo->getPointFloatAttribute("pscale", 1, attribs.pscale);
+	pBgeo->getPointFloatAttribute("scale", 3, attribs.scale);
+	pBgeo->getPointFloatAttribute("trans", 3, attribs.trans);
+	pBgeo->getPointFloatAttribute("pivot", 3, attribs.pivot);
+
+	// Per-point instance object names
+	std::vector<std::string> instance_names;
+	std::vector<int32_t> instance_name_indices;
+	if(auto pInstanceAttrib = pBgeo->getPointAttributeByName("instance")) {
+		pInstanceAttrib->getStrings(instance_names);
+		pInstanceAttrib->getData(instance_name_indices);
+	}
+	if(instance_name_indices.empty() && default_instance_path.empty()) {
+		LLOG_WRN << "No instance path and no instance attribute on " << pObj->getPropertyValue(ast::Style::OBJECT, kName, std::string());
+		return true;
+	}
+
+	// Group point transforms by instanced object
+	std::unordered_map<std::string, scope::Object::SharedConstPtr> objects;
+	for(const auto& pObject: mpGlobal->objects()) {
+		objects[pObject->getPropertyValue(ast::Style::OBJECT, kName, std::string())] = pObject;
+	}
+
+	// Point transforms grouped by instanced object, motion samples get applied once the object is known
+	const auto& instancer_transforms = pObj->getTransformList();
+	std::unordered_map<std::string, std::vector<glm::mat4>> instance_transforms;
+
+	for(size_t i = 0; i < point_count; ++i) {
+		const int32_t name_index = instance_name_indices.empty() ? -1 : instance_name_indices[i];
+		const std::string& instance_name = (name_index >= 0 && name_index < static_cast<int32_t>(instance_names.size())) ? instance_names[name_index] : default_instance_path;
+		if(instance_name.empty()) continue;
+
+		instance_transforms[instance_name].push_back(attribs.transform(i));
+	}
+
+	// Nearest of 'samples' to the i-th of 'count' shutter samples. Both instancer and instanced object motion span the same interval
+	auto shutterSample = [](const std::vector<glm::mat4>& samples, size_t i, size_t count) -> const glm::mat4& {
+		if(samples.size() == 1 || count == 1) return samples[0];
+		return samples[static_cast<size_t>(std::lround(static_cast<double>(i) * (samples.size() - 1) / (count - 1)))];
+	};
+
+	bool result = true;
+	for(const auto& [instance_name, point_transforms]: instance_transforms) {
+		auto it = objects.find(instance_name);
+		if(it == objects.end()) {
+			// Missing object only loses it's own instances
+			LLOG_ERR << "Point instancing object " << instance_name << " not found. Skipping " << point_transforms.size() << " instances !!!";
+			continue;
+		}
+
+		const auto& object_transforms = it->second->getTransformList();
+		const size_t samples_count = instance_xform ? std::max(instancer_transforms.size(), object_transforms.size()) : instancer_transforms.size();
+
+		std::vector<glm::mat4> transforms;
+		transforms.reserve(point_transforms.size() * samples_count);
+		for(const auto& point_transform: point_transforms) {
+			for(size_t s = 0; s < samples_count; ++s) {
+				glm::mat4 transform = shutterSample(instancer_transforms, s, samples_count) * point_transform;
+				if(instance_xform) transform = transform * shutterSample(object_transforms, s, samples_count);
+				transforms.push_back(transform);
+			}
+		}
+
+		result = pushGeometryInstances(it->second, transforms, samples_count) && result;
+	}
+
+	return result;
+}
+
+bool Session::pushPendingPointInstances() {
+	bool result = true;
+	for(const auto& pObj: mPendingPointInstancers) {
+		result = pushPointInstances(pObj) && result;
+	}
+	mPendingPointInstancers.clear();
+	return result;
 }
 
 
@@ -14,7 +14,10 @@
 #include "../display.h"
 
 #include "Falcor/Utils/Math/Vector.h"
+#include "Falcor/Utils/CryptoUtils.h"
+#include "Falcor/Utils/TaskScheduler.h"
 #include "Falcor/Utils/Timing/Profiler.h"
+#include "Falcor/Utils/Timing/TraceRecorder.h"
 #include "Falcor/Scene/MaterialX/MaterialX.h"
 #include "Falcor/Scene/MaterialX/MxTypes.h"
 
@@ -67,7 +70,7 @@ class Session {
 
     /** get string expanded with local env variables
      */
-    std::string getExpandedString(const std::string& s);
+    std::string getExpandedString(const std::string& s) const;
 
     bool cmdStart(lsd::ast::Style object_type);
     bool cmdEnd();
@@ -87,13 +90,41 @@ class Session {
     bool cmdGeometry(const std::string& name);
     void cmdTime(double time);
     void cmdQuit();
+    void cmdReset(bool lights, bool objects, bool fogs);
 
-    void pushLight(const scope::Light::SharedPtr pLight);
+    Falcor::Light::SharedPtr pushLight(const scope::Light::SharedPtr pLight);
     void pushBgeo(const std::string& name, lsd::scope::Geo::SharedPtr pGeo);
-    void pushBgeoAsync(const std::string& name, lsd::scope::Geo::SharedPtr pGeo);
+    void pushBgeoAsync(const std::string& name, lsd::scope::Geo::SharedPtr pGeo, ika::bgeo::Bgeo::SharedPtr pBgeo = nullptr);
 
     bool failed() const { return mFailed; }
 
+  private:
+    /** Frame to frame scene reuse. Geometry, material, object and light scopes are recorded with a signature of their
+     *  content (transforms excluded) and matched to the previous frame scopes by their type and name. While a frame repeats
+     *  the previous one nothing gets pushed to the scene builder again, existing objects and lights only receive their new
+     *  transforms. Once a scope differs the scene is rebuilt from recorded scopes, but only changed geometry is read again.
+     */
+    struct ScopeRecord {
+      ast::Style                type;
+      std::string               key;                 // scope type and name. pairs scopes of subsequent frames
+      Falcor::SHA1::MD          signature = {};
+      glm::mat4                 transform = glm::mat4(1.0f);  // object or light transform. not a part of signature
+      bool                      comparable = false;  // false when scope content can't be compared to other frames
+      Falcor::SHA1::MD          instancedSignature = {};  // point instancer instanced objects transforms. set once the frame is complete
+      std::vector<uint32_t>     nodeIDs;             // object instances scene graph nodes
+      Falcor::Light::SharedPtr  pLight;              // light created for the scope
+      ika::bgeo::Bgeo::SharedPtr pBgeo;              // loaded geometry detail. added again as is on scene rebuild
+
+      bool matches(const ScopeRecord& other) const { return comparable && other.comparable && type == other.type && signature == other.signature; }
+    };
+
+    struct FrameRecords {
+      std::vector<ScopeRecord>                  previous;   // previous frame records
+      std::vector<ScopeRecord>                  current;    // current frame records
+      std::vector<scope::ScopeBase::SharedPtr>  scopes;     // current frame scopes in declaration order
+      std::unordered_multimap<std::string, size_t> unmatched;  // previous records indices by key not matched by current frame yet
+    };
+
   private:
  	  Session(std::shared_ptr<Renderer> pRenderer);
  	
@@ -107,9 +138,25 @@ class Session {
     Falcor::StandardMaterial::SharedPtr createStandardMaterialFromLSD(const std::string& material_name, const Property* pShaderProp);
     Falcor::MaterialX::UniquePtr createMaterialXFromLSD(lsd::scope::Material::SharedConstPtr pMaterialLSD);
 
- 	  bool pushGeometryInstance(lsd::scope::Object::SharedConstPtr pObj);
+ 	  bool pushGeometryInstance(lsd::scope::Object::SharedConstPtr pObj, std::vector<uint32_t>* pNodeIDs = nullptr);
+    /** Push 'transforms.size() / samplesCount' instances of the object geometry. Each instance takes 'samplesCount' consecutive
+     *  transform motion samples, first one being the node transform.
+     */
+    bool pushGeometryInstances(lsd::scope::Object::SharedConstPtr pObj, const std::vector<glm::mat4>& transforms, size_t samplesCount = 1, std::vector<uint32_t>* pNodeIDs = nullptr);
+    bool pushPointInstances(lsd::scope::Object::SharedConstPtr pObj);
+    bool pushPendingPointInstances();
+    std::string pushVolumeGeometry(lsd::scope::Object::SharedConstPtr pObj);
     void addMxNode(Falcor::MxNode::SharedPtr pParent, scope::Node::SharedConstPtr pNodeLSD);
 
+    bool isSceneReuseEnabled() const;
+    FrameRecords& frameRecords(ast::Style type) { return (type == ast::Style::LIGHT) ? mLightRecords : mObjectRecords; };
+    ScopeRecord makeScopeRecord(scope::ScopeBase::SharedPtr pScope) const;
+    const ScopeRecord* matchPreviousRecord(FrameRecords& records, const ScopeRecord& record) const;
+    bool submitScope(scope::ScopeBase::SharedPtr pScope);
+    bool pushScope(scope::ScopeBase::SharedPtr pScope, ScopeRecord& record);
+    void reuseScope(scope::ScopeBase::SharedPtr pScope, const ScopeRecord& previous, ScopeRecord& record);
+    bool rebuildScene();
+
   private:
     bool mFailed = false;
     bool  mIPR = false;
@@ -138,8 +185,13 @@ class Session {
 
     Renderer::Config                mRendererConfig;
 
-    std::unordered_map<std::string, std::variant<uint32_t, std::shared_future<uint32_t>>>	mMeshMap;     // maps detail(mesh) name to SceneBuilder mesh id	or it's async future
+    std::unordered_map<std::string, std::variant<uint32_t, Falcor::TaskScheduler::Future<uint32_t>>>	mMeshMap;     // maps detail(mesh) name to SceneBuilder geometry id or it's async future
     std::unordered_map<std::string, uint32_t> mLightsMap;     // maps detail(mesh) name to SceneBuilder mesh id 
+
+    bool                            mReusingScene = false;  // current frame matches previous one so far and it's scene is reused
+    FrameRecords                    mObjectRecords;         // geometry, material and object scopes
+    FrameRecords                    mLightRecords;          // light scopes
+    std::vector<scope::Object::SharedConstPtr> mPendingPointInstancers;  // point instancers waiting for the frame to complete
 };
 
 static inline std::string to_string(const Session::TileInfo& tileInfo) {
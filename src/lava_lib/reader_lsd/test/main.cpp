@@ -0,0 +1,2 @@
+#define BOOST_TEST_MODULE reader_lsd_tests
+#include <boost/test/included/unit_test.hpp>
@@ -0,0 +1,125 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "grammar_lsd_numeric.h"
+
+namespace lava {
+
+namespace lsd {
+
+namespace test_grammar_lsd_numeric {
+
+namespace x3 = boost::spirit::x3;
+
+// Same strict real parser the LSD grammar uses for generic values
+x3::real_parser<double, x3::strict_real_policies<double>> const double_ = {};
+
+// Random numeric token. Reals get long mantissas and exponents to exercise rounding
+std::string randomToken(std::mt19937& rng) {
+    std::uniform_int_distribution<int> kind(0, 5);
+    std::uniform_int_distribution<int> digit(0, 9);
+    std::uniform_int_distribution<int> length(1, 24);
+
+    std::string token;
+    switch (kind(rng) % 3) {
+        case 1: token = "-"; break;
+        case 2: token = "+"; break;
+        default: break;
+    }
+
+    const int k = kind(rng);
+    for (int i = 0, n = (k == 0) ? 1 + length(rng) % 9 : length(rng); i < n; i++) token += char('0' + digit(rng));
+    if (k == 0) return token;
+
+    token += ".";
+    for (int i = 0, n = length(rng); i < n; i++) token += char('0' + digit(rng));
+    if (k >= 4) token += "e" + std::to_string(std::uniform_int_distribution<int>(-300, 300)(rng));
+    return token;
+}
+
+template <size_t N>
+void checkRealArray(const std::string& line) {
+    std::vector<double> fast, generic;
+
+    auto first = line.begin();
+    const bool fastParsed = x3::phrase_parse(first, line.end(), numeric::fixed_array<std::vector<double>, N>(), x3::blank, fast);
+    const bool fastConsumed = first == line.end();
+
+    first = line.begin();
+    const bool genericParsed = x3::phrase_parse(first, line.end(), x3::repeat(N) [ double_ | x3::int_ ], x3::blank, generic);
+
+    BOOST_REQUIRE(genericParsed);
+    BOOST_REQUIRE_MESSAGE(fastParsed && fastConsumed, "fast path rejected: " << line);
+    BOOST_REQUIRE_EQUAL(fast.size(), generic.size());
+    BOOST_CHECK_MESSAGE(std::memcmp(fast.data(), generic.data(), N * sizeof(double)) == 0, "values differ: " << line);
+}
+
+BOOST_AUTO_TEST_CASE(test_real_arrays_match_generic_rule) {
+    std::mt19937 rng(1234);
+    for (int i = 0; i < 20000; i++) {
+        std::string line;
+        for (size_t j = 0; j < 16; j++) line += (j ? " " : "") + randomToken(rng);
+        checkRealArray<16>(line);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_real_round_trip) {
+    std::mt19937 rng(4321);
+    std::uniform_real_distribution<double> value(-1.0e6, 1.0e6);
+    for (int i = 0; i < 20000; i++) {
+        double values[3] = { value(rng), value(rng) * 1.0e-200, value(rng) * 1.0e200 };
+        char line[256];
+        std::snprintf(line, sizeof(line), "%.17e %.17e %.17e", values[0], values[1], values[2]);
+
+        std::vector<double> parsed;
+        std::string s(line);
+        auto first = s.begin();
+        BOOST_REQUIRE(x3::phrase_parse(first, s.end(), numeric::fixed_array<std::vector<double>, 3>(), x3::blank, parsed));
+        for (size_t j = 0; j < 3; j++) {
+            // X3 isn't correctly rounded, so printed values come back within a couple of ulps rather than exactly
+            BOOST_CHECK_MESSAGE(std::fabs(parsed[j] - values[j]) <= 4 * std::numeric_limits<double>::epsilon() * std::fabs(values[j]), line);
+        }
+        checkRealArray<3>(s);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_edge_reals_match_generic_rule) {
+    checkRealArray<4>(".5 -.5 5. +5.e3");
+    checkRealArray<3>("0.1000000000000000055511151231257827021181583404541015625 1.7976931348623157e308 4.9406564584124654e-324");
+    checkRealArray<3>("123456789012345678901234567890.5 -0.0 2.2250738585072011e-308");
+}
+
+BOOST_AUTO_TEST_CASE(test_int_arrays_match_generic_rule) {
+    const std::vector<std::string> lines = { "1 -2 +3", "2147483647 -2147483648 0", "007 +0 -0" };
+    for (const auto& line: lines) {
+        std::vector<int> fast, generic;
+        auto first = line.begin();
+        BOOST_REQUIRE(x3::phrase_parse(first, line.end(), numeric::fixed_array<std::vector<int>, 3>(), x3::blank, fast));
+        first = line.begin();
+        BOOST_REQUIRE(x3::phrase_parse(first, line.end(), x3::repeat(3) [ x3::int_ ], x3::blank, generic));
+        BOOST_CHECK(fast == generic);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_unusual_tokens_fall_back) {
+    // Tokens the fast path leaves to the generic rule: no dot exponent, int overflow, glued tokens and specials
+    const std::vector<std::string> lines = { "1e5 2 3", "2147483648 1 2", "1.0,2.0 3", "inf 1.0 2.0", "1.0 nan 2.0" };
+    for (const auto& line: lines) {
+        std::vector<double> fast;
+        auto first = line.begin();
+        BOOST_CHECK_MESSAGE(!x3::phrase_parse(first, line.end(), numeric::fixed_array<std::vector<double>, 3>(), x3::blank, fast), line);
+    }
+}
+
+}  // namespace test_grammar_lsd_numeric
+
+}  // namespace lsd
+
+}  // namespace lava
@@ -0,0 +1,263 @@
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "uudecode.h"
+
+namespace lava { namespace lsd { namespace test_uudecode {
+
+using Bytes = std::vector<unsigned char>;
+
+static Bytes randomBytes(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> dist(0, 255);
+    Bytes bytes(count);
+    for(auto& b: bytes) b = static_cast<unsigned char>(dist(rng));
+    return bytes;
+}
+
+struct UUOptions {
+    bool backtickZero = true;   // encode zero as '`' instead of ' '
+    bool substitutes = false;   // use ebcdic safe substitutes decodeUU understands
+    bool stripTrailing = false; // strip trailing spaces of each line
+};
+
+static char encodeUUChar(unsigned char value, const UUOptions& options) {
+    char c = static_cast<char>(value + ' ');
+    if(value == 0 && options.backtickZero) return '`';
+    if(options.substitutes) {
+        switch(c) {
+            case ' ': return 'm';
+            case '[': return 'd';
+            case '\\': return 'e';
+            case ']': return 'f';
+            case '^': return 'g';
+            case '\'': return 'h';
+            default: break;
+        }
+    }
+    return c;
+}
+
+// Reference encoder writing 45 byte lines, as uuencode does
+static std::string encodeUU(const Bytes& bytes, const UUOptions& options = UUOptions()) {
+    std::string text = "begin 644 embedded.bin\n";
+    for(size_t offset = 0; offset < bytes.size(); offset += 45) {
+        const size_t count = std::min<size_t>(45, bytes.size() - offset);
+        std::string line(1, encodeUUChar(static_cast<unsigned char>(count), options));
+        for(size_t i = 0; i < count; i += 3) {
+            unsigned char group[3] = {0, 0, 0};
+            for(size_t j = 0; j < 3 && i + j < count; j++) group[j] = bytes[offset + i + j];
+            line += encodeUUChar(group[0] >> 2, options);
+            line += encodeUUChar(((group[0] << 4) | (group[1] >> 4)) & 0x3F, options);
+            line += encodeUUChar(((group[1] << 2) | (group[2] >> 6)) & 0x3F, options);
+            line += encodeUUChar(group[2] & 0x3F, options);
+        }
+        if(options.stripTrailing) line.erase(line.find_last_not_of(' ') + 1);
+        text += line + "\n";
+    }
+    text += std::string(1, encodeUUChar(0, options)) + "\nend\n";
+    return text;
+}
+
+// Reference encoder writing 76 character lines, as MIME does
+static std::string encodeBase64(const Bytes& bytes, bool pad = true, size_t lineLength = 76) {
+    const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string text;
+    for(size_t i = 0; i < bytes.size(); i += 3) {
+        const size_t count = std::min<size_t>(3, bytes.size() - i);
+        const unsigned value = bytes[i] << 16 | (count > 1 ? bytes[i + 1] << 8 : 0) | (count > 2 ? bytes[i + 2] : 0);
+        for(size_t j = 0; j < 4; j++) {
+            if(j <= count) text += alphabet[(value >> (18 - 6 * j)) & 0x3F];
+            else if(pad) text += '=';
+        }
+    }
+    std::string lines;
+    for(size_t i = 0; i < text.size(); i += lineLength) lines += text.substr(i, lineLength) + "\n";
+    return lines;
+}
+
+// Scalar reference decoding through uu::decodeUU
+static Bytes decodeUUScalar(const std::string& text) {
+    FILE* pIn = tmpfile();
+    FILE* pOut = tmpfile();
+    BOOST_REQUIRE(pIn && pOut);
+    fwrite(text.data(), 1, text.size(), pIn);
+    rewind(pIn);
+    BOOST_REQUIRE(uu::decodeUU(pIn, pOut));
+
+    Bytes bytes(static_cast<size_t>(ftell(pOut)));
+    rewind(pOut);
+    BOOST_REQUIRE_EQUAL(fread(bytes.data(), 1, bytes.size(), pOut), bytes.size());
+    fclose(pIn);
+    fclose(pOut);
+    return bytes;
+}
+
+static Bytes decodeUUChunked(const std::string& text, size_t chunkSize) {
+    Bytes bytes;
+    uu::Decoder decoder(bytes, text.size());
+    std::istringstream in(text);
+    BOOST_REQUIRE(readEmbeddedFile(in, text.size(), decoder, chunkSize));
+    BOOST_REQUIRE(decoder.isDone());
+    return bytes;
+}
+
+static bool decodeBase64Chunked(const std::string& text, size_t chunkSize, Bytes& bytes) {
+    base64::Decoder decoder(bytes, text.size());
+    std::istringstream in(text);
+    return readEmbeddedFile(in, text.size(), decoder, chunkSize) && decoder.finish();
+}
+
+static const size_t kChunkSizes[] = {1, 7, 62, 4096, 1 << 20};
+
+BOOST_AUTO_TEST_CASE(test_uu_matches_scalar_decoder) {
+    for(size_t size: {0, 1, 2, 3, 44, 45, 46, 1000, 65537}) {
+        const Bytes bytes = randomBytes(size, static_cast<unsigned>(size));
+        for(const bool backtickZero: {true, false}) {
+            UUOptions options;
+            options.backtickZero = backtickZero;
+            const std::string text = encodeUU(bytes, options);
+
+            BOOST_CHECK(decodeUUScalar(text) == bytes);
+            for(size_t chunkSize: kChunkSizes) BOOST_CHECK(decodeUUChunked(text, chunkSize) == bytes);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_uu_substitutes) {
+    // Zero and substitute heavy data keeps the vector path falling back to the table
+    Bytes bytes(4000, 0);
+    for(size_t i = 0; i < bytes.size(); i += 7) bytes[i] = static_cast<unsigned char>(i);
+    UUOptions options;
+    options.substitutes = true;
+    const std::string text = encodeUU(bytes, options);
+    BOOST_REQUIRE(text.find('m') != std::string::npos);
+
+    BOOST_CHECK(decodeUUScalar(text) == bytes);
+    for(size_t chunkSize: kChunkSizes) BOOST_CHECK(decodeUUChunked(text, chunkSize) == bytes);
+}
+
+BOOST_AUTO_TEST_CASE(test_uu_stripped_trailing_spaces) {
+    // Trailing zero bytes encode as trailing spaces that some encoders strip
+    Bytes bytes = randomBytes(450, 7);
+    for(size_t i = 30; i < 45; i++) bytes[i] = 0;
+    bytes.resize(bytes.size() + 4, 0);
+
+    UUOptions options;
+    options.backtickZero = false;
+    options.stripTrailing = true;
+    const std::string strippedText = encodeUU(bytes, options);
+    options.stripTrailing = false;
+    const std::string fullText = encodeUU(bytes, options);
+    BOOST_REQUIRE(strippedText.size() < fullText.size());
+
+    // Scalar decoder needs all the characters, so it decodes the unstripped text
+    BOOST_CHECK(decodeUUScalar(fullText) == bytes);
+    for(size_t chunkSize: kChunkSizes) BOOST_CHECK(decodeUUChunked(strippedText, chunkSize) == bytes);
+}
+
+BOOST_AUTO_TEST_CASE(test_uu_crc_and_errors) {
+    const Bytes bytes = randomBytes(100, 11);
+    std::string text = encodeUU(bytes);
+    text.insert(text.size() - 4, "CRC= 1234\n");
+    BOOST_CHECK(decodeUUChunked(text, 16) == bytes);
+
+    // Truncated stream
+    {
+        Bytes decoded;
+        uu::Decoder decoder(decoded);
+        std::istringstream in(text.substr(0, 50));
+        BOOST_CHECK(!readEmbeddedFile(in, text.size(), decoder, 16));
+    }
+
+    // Garbage instead of "end"
+    {
+        Bytes decoded;
+        uu::Decoder decoder(decoded);
+        std::string badText = encodeUU(bytes);
+        badText.replace(badText.size() - 4, 4, "bogus\n");
+        std::istringstream in(badText);
+        readEmbeddedFile(in, badText.size(), decoder);
+        BOOST_CHECK(!decoder.isDone());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_uu_lines_across_1mb_chunks) {
+    // Encoded text spans a few default sized chunks, and 62 character lines never end on a chunk boundary
+    const Bytes bytes = randomBytes(2000000, 3);
+    const std::string text = encodeUU(bytes);
+    BOOST_REQUIRE(text.size() > 2 << 20);
+
+    BOOST_CHECK(decodeUUScalar(text) == bytes);
+    BOOST_CHECK(decodeUUChunked(text, 1 << 20) == bytes);
+}
+
+BOOST_AUTO_TEST_CASE(test_base64_known_vectors) {
+    // RFC 4648 test vectors
+    const std::pair<const char*, const char*> vectors[] = {
+        {"", ""}, {"f", "Zg=="}, {"fo", "Zm8="}, {"foo", "Zm9v"}, {"foob", "Zm9vYg=="}, {"fooba", "Zm9vYmE="}, {"foobar", "Zm9vYmFy"},
+    };
+    for(const auto& vector: vectors) {
+        const std::string expected = vector.first;
+        for(size_t chunkSize: {1, 3, 64}) {
+            Bytes bytes;
+            const std::string text = std::string(vector.second) + "\n";
+            BOOST_CHECK(decodeBase64Chunked(text, chunkSize, bytes));
+            BOOST_CHECK_EQUAL(std::string(bytes.begin(), bytes.end()), expected);
+        }
+    }
+
+    // Longer vector exercising '+' and '/' on the vector path
+    Bytes bytes;
+    BOOST_CHECK(decodeBase64Chunked("+/+/+/+/+/+/+/+/+/+/+/+/+/+/+/+/\n", 8, bytes));
+    BOOST_CHECK_EQUAL(bytes.size(), 24u);
+    for(size_t i = 0; i < bytes.size(); i += 3) {
+        BOOST_CHECK_EQUAL(bytes[i], 0xFB);
+        BOOST_CHECK_EQUAL(bytes[i + 1], 0xFF);
+        BOOST_CHECK_EQUAL(bytes[i + 2], 0xBF);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_base64_padding_and_chunks) {
+    for(size_t size: {1, 2, 3, 56, 57, 58, 1000, 65537}) {
+        const Bytes bytes = randomBytes(size, static_cast<unsigned>(size) + 100);
+        for(const bool pad: {true, false}) {
+            for(size_t lineLength: {4, 63, 76}) {
+                const std::string text = encodeBase64(bytes, pad, lineLength);
+                for(size_t chunkSize: kChunkSizes) {
+                    Bytes decoded;
+                    BOOST_CHECK(decodeBase64Chunked(text, chunkSize, decoded));
+                    BOOST_CHECK(decoded == bytes);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_base64_lines_across_1mb_chunks) {
+    const Bytes bytes = randomBytes(2000000, 5);
+    const std::string text = encodeBase64(bytes);
+    BOOST_REQUIRE(text.size() > 2 << 20);
+
+    Bytes decoded;
+    BOOST_CHECK(decodeBase64Chunked(text, 1 << 20, decoded));
+    BOOST_CHECK(decoded == bytes);
+}
+
+BOOST_AUTO_TEST_CASE(test_base64_errors) {
+    Bytes bytes;
+    BOOST_CHECK(!decodeBase64Chunked("Zm9v!mFy\n", 64, bytes));
+
+    bytes.clear();
+    BOOST_CHECK(!decodeBase64Chunked("Zm9vY\n", 64, bytes));
+
+    bytes.clear();
+    BOOST_CHECK(!decodeBase64Chunked("Zg==Zm9v\n", 64, bytes));
+}
+
+}}}  // namespace lava::lsd::test_uudecode
@@ -8,12 +8,47 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <array>
+
+#if defined(__SSSE3__) || defined(__AVX__)
+#define LAVA_UUDECODE_SIMD 1
+#include <tmmintrin.h>
+#endif
+
 #include "uudecode.h"
 
 namespace lava { 
 
 namespace lsd {
 
+namespace {
+
+// Both uuencode and base64 pack 4 big endian 6-bit values into 3 bytes
+inline void packGroup(unsigned char a, unsigned char b, unsigned char c, unsigned char d, unsigned char* pDst) {
+    pDst[0] = static_cast<unsigned char>(a << 2 | b >> 4);
+    pDst[1] = static_cast<unsigned char>(b << 4 | c >> 2);
+    pDst[2] = static_cast<unsigned char>(c << 6 | d);
+}
+
+#ifdef LAVA_UUDECODE_SIMD
+// Pack 16 6-bit values (4 groups) into 12 bytes stored in the low lanes of the result
+inline __m128i packGroups(__m128i values) {
+    const __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));  // a * 64 + b, c * 64 + d
+    const __m128i packed = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));     // (a * 64 + b) * 4096 + c * 64 + d
+    return _mm_shuffle_epi8(packed, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+// Vector loop writes 16 bytes for every 4 groups, so it stops while there is still room for that
+static constexpr size_t kSimdMinGroups = 6;
+#endif
+
+inline size_t stripLineEnd(const char* pLine, size_t length) {
+    while(length > 0 && (pLine[length - 1] == '\n' || pLine[length - 1] == '\r')) length--;
+    return length;
+}
+
+}  // namespace
+
 namespace uu {
 
 unsigned short CRC = 0x0000; /* CRC-16 Accumulator */
@@ -252,8 +287,225 @@ int fr ( FILE *fd, char *buf, int cnt )
   return cnt;
 }
 
+/******************************************************************************/
+
+static const std::array<unsigned char, 256> kDecodeTable = [] {
+    std::array<unsigned char, 256> table;
+    for(size_t i = 0; i < table.size(); i++) table[i] = static_cast<unsigned char>(DECN(static_cast<char>(i)));
+    return table;
+}();
+
+// Longest line holds 63 bytes in 21 groups
+static constexpr size_t kMaxLineGroups = 21;
+
+void decodeBlock(const char* pSrc, size_t groupCount, unsigned char* pDst) {
+    const unsigned char* pChars = reinterpret_cast<const unsigned char*>(pSrc);
+    size_t i = 0;
+
+#ifdef LAVA_UUDECODE_SIMD
+    const __m128i space = _mm_set1_epi8(0x20);
+    const __m128i maxValue = _mm_set1_epi8(0x40);
+    const __m128i mask = _mm_set1_epi8(0x3F);
+    while(groupCount - i >= kSimdMinGroups) {
+        const __m128i shifted = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pChars + i * 4)), space);
+        // Only standard ' ' to '`' characters are decoded here. Ebcdic safe substitutes are left to the table
+        if(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(shifted, maxValue), shifted)) != 0xFFFF) {
+            for(size_t end = i + 4; i < end; i++) {
+                const unsigned char* p = pChars + i * 4;
+                packGroup(kDecodeTable[p[0]], kDecodeTable[p[1]], kDecodeTable[p[2]], kDecodeTable[p[3]], pDst + i * 3);
+            }
+            continue;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i * 3), packGroups(_mm_and_si128(shifted, mask)));
+        i += 4;
+    }
+#endif
+
+    for(; i < groupCount; i++) {
+        const unsigned char* p = pChars + i * 4;
+        packGroup(kDecodeTable[p[0]], kDecodeTable[p[1]], kDecodeTable[p[2]], kDecodeTable[p[3]], pDst + i * 3);
+    }
+}
+
+Decoder::Decoder(std::vector<unsigned char>& output, size_t encodedSize): mOutput(output) {
+    mOutput.reserve(mOutput.size() + encodedSize / 4 * 3);
+}
+
+bool Decoder::feedLine(const char* pLine, size_t length) {
+    length = stripLineEnd(pLine, length);
+
+    switch(mState) {
+        case State::HEADER:
+            if(length >= 6 && strncmp(pLine, "begin ", 6) == 0) mState = State::DATA;
+            return true;
+
+        case State::DATA: {
+            // Empty line is a zero length line with it's trailing space stripped
+            const size_t byteCount = (length == 0) ? 0 : kDecodeTable[static_cast<unsigned char>(pLine[0])];
+            if(byteCount == 0) {
+                mState = State::TRAILER;
+                return true;
+            }
+
+            const size_t groupCount = (byteCount + 2) / 3;
+            const char* pGroups = pLine + 1;
+
+            // Some encoders strip trailing spaces, so missing characters decode as zeroes
+            char paddedLine[kMaxLineGroups * 4];
+            if(length - 1 < groupCount * 4) {
+                memset(paddedLine, ' ', sizeof(paddedLine));
+                memcpy(paddedLine, pLine + 1, length - 1);
+                pGroups = paddedLine;
+            }
+
+            const size_t offset = mOutput.size();
+            mOutput.resize(offset + byteCount);
+            const size_t fullGroupCount = byteCount / 3;
+            decodeBlock(pGroups, fullGroupCount, mOutput.data() + offset);
+            if(fullGroupCount < groupCount) {
+                unsigned char tail[3];
+                decodeBlock(pGroups + fullGroupCount * 4, 1, tail);
+                memcpy(mOutput.data() + offset + fullGroupCount * 3, tail, byteCount - fullGroupCount * 3);
+            }
+            return true;
+        }
+
+        case State::TRAILER:
+            if(length >= 5 && strncmp(pLine, "CRC= ", 5) == 0) return true;
+            if(length == 3 && strncmp(pLine, "end", 3) == 0) {
+                mState = State::DONE;
+                return true;
+            }
+            mState = State::ERROR;
+            return false;
+
+        case State::DONE:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
 }  // namespace uu
 
+namespace base64 {
+
+static constexpr unsigned char kInvalid = 0xFF;
+
+static const std::array<unsigned char, 256> kDecodeTable = [] {
+    const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::array<unsigned char, 256> table;
+    table.fill(kInvalid);
+    for(unsigned char i = 0; i < 64; i++) table[static_cast<unsigned char>(alphabet[i])] = i;
+    return table;
+}();
+
+static inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+size_t decodeBlock(const char* pSrc, size_t quadCount, unsigned char* pDst) {
+    const unsigned char* pChars = reinterpret_cast<const unsigned char*>(pSrc);
+    size_t i = 0;
+
+#ifdef LAVA_UUDECODE_SIMD
+    // Character class lookups by low and high nibble. Classes match only for alphabet characters, then per high nibble
+    // offset (with '/' singled out) maps characters to values
+    const __m128i lutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+    const __m128i slash = _mm_set1_epi8('/');
+    while(quadCount - i >= kSimdMinGroups) {
+        const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pChars + i * 4));
+        const __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(chars, 4), nibbleMask);
+        const __m128i loNibbles = _mm_and_si128(chars, nibbleMask);
+        const __m128i classes = _mm_and_si128(_mm_shuffle_epi8(lutLo, loNibbles), _mm_shuffle_epi8(lutHi, hiNibbles));
+        if(_mm_movemask_epi8(_mm_cmpgt_epi8(classes, _mm_setzero_si128())) != 0) break;
+
+        const __m128i roll = _mm_shuffle_epi8(lutRoll, _mm_add_epi8(_mm_cmpeq_epi8(chars, slash), hiNibbles));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i * 3), packGroups(_mm_add_epi8(chars, roll)));
+        i += 4;
+    }
+#endif
+
+    for(; i < quadCount; i++) {
+        const unsigned char* p = pChars + i * 4;
+        const unsigned char a = kDecodeTable[p[0]], b = kDecodeTable[p[1]], c = kDecodeTable[p[2]], d = kDecodeTable[p[3]];
+        if((a | b | c | d) == kInvalid) break;
+        packGroup(a, b, c, d, pDst + i * 3);
+    }
+    return i;
+}
+
+Decoder::Decoder(std::vector<unsigned char>& output, size_t encodedSize): mOutput(output) {
+    mOutput.reserve(mOutput.size() + encodedSize / 4 * 3);
+}
+
+void Decoder::flushCarry() {
+    unsigned char group[3];
+    packGroup(mCarry[0], mCarry[1], mCarryCount > 2 ? mCarry[2] : 0, mCarryCount > 3 ? mCarry[3] : 0, group);
+    mOutput.insert(mOutput.end(), group, group + mCarryCount - 1);
+    mCarryCount = 0;
+}
+
+bool Decoder::feedLine(const char* pLine, size_t length) {
+    const char* p = pLine;
+    const char* pEnd = pLine + length;
+    while(p != pEnd) {
+        if(mState == State::ERROR) return false;
+
+        // Whole groups are decoded in bulk, characters are handled one by one only around whitespace, padding and line ends
+        if(mState == State::DATA && mCarryCount == 0 && static_cast<size_t>(pEnd - p) >= 4) {
+            const size_t quadCount = (pEnd - p) / 4;
+            const size_t offset = mOutput.size();
+            mOutput.resize(offset + quadCount * 3);
+            const size_t decodedCount = decodeBlock(p, quadCount, mOutput.data() + offset);
+            mOutput.resize(offset + decodedCount * 3);
+            p += decodedCount * 4;
+            if(p == pEnd) break;
+        }
+
+        const char c = *p++;
+        if(isSpace(c)) continue;
+
+        if(c == '=') {
+            if(mState == State::DATA) {
+                if(mCarryCount < 2) {
+                    mState = State::ERROR;
+                    continue;
+                }
+                flushCarry();
+                mState = State::DONE;
+            }
+            continue;
+        }
+
+        const unsigned char value = kDecodeTable[static_cast<unsigned char>(c)];
+        if(value == kInvalid || mState == State::DONE) {
+            mState = State::ERROR;
+            continue;
+        }
+
+        mCarry[mCarryCount++] = value;
+        if(mCarryCount == 4) flushCarry();
+    }
+    return mState != State::ERROR;
+}
+
+bool Decoder::finish() {
+    if(mState == State::DATA) {
+        if(mCarryCount == 1) {
+            mState = State::ERROR;
+            return false;
+        }
+        if(mCarryCount > 0) flushCarry();
+        mState = State::DONE;
+    }
+    return mState == State::DONE;
+}
+
+}  // namespace base64
+
 }  // namespace lsd
 
 }  // namespace lava
@@ -1,24 +1,147 @@
+#ifndef SRC_LAVA_LIB_READER_LSD_UUDECODE_H_
+#define SRC_LAVA_LIB_READER_LSD_UUDECODE_H_
+
 /*
  * txt2bin [input]
  *
- * decode the specified text file and recreate the original binary file 
+ * decode the specified text file and recreate the original binary file
  * encoded with encode.
  */
 # include <stdlib.h>
 # include <stdio.h>
 # include <string.h>
 
-namespace lava { 
+#include <algorithm>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace lava {
 
 namespace lsd {
 
 namespace uu {
- 
+
 bool decodeUU ( FILE *in, FILE *out, bool checkCRC = false );
 
+/** Decode 'groupCount' groups of 4 uuencoded characters into 3 bytes each. Uses SSSE3 when available.
+ *  Characters are mapped the same way decodeUU does it, including it's ebcdic safe substitutes.
+ */
+void decodeBlock(const char* pSrc, size_t groupCount, unsigned char* pDst);
+
+/** Streaming uudecoder. Encoded text is fed one line at a time and decoded bytes are appended straight to the output
+ *  buffer, so nothing but the decoded data is kept in memory. Lines before "begin" header are skipped, optional "CRC= "
+ *  line is ignored and decoding is done once "end" line is fed.
+ */
+class Decoder {
+    public:
+        /** \param[out] output Buffer decoded bytes are appended to.
+         *  \param[in] encodedSize Expected encoded size used to preallocate the output, or 0 if not known.
+         */
+        Decoder(std::vector<unsigned char>& output, size_t encodedSize = 0);
+
+        /** Decode single line. Line terminator is optional.
+         *  \return False if line is malformed. Decoder stays in error state afterwards.
+         */
+        bool feedLine(const char* pLine, size_t length);
+
+        bool isDone() const { return mState == State::DONE; }
+        bool hasError() const { return mState == State::ERROR; }
+
+    private:
+        enum class State { HEADER, DATA, TRAILER, DONE, ERROR };
+
+        std::vector<unsigned char>& mOutput;
+        State mState = State::HEADER;
+};
 
 }  // namespace uu
 
+namespace base64 {
+
+/** Decode up to 'quadCount' groups of 4 base64 characters (standard alphabet) into 3 bytes each. Uses SSSE3 when available.
+ *  Decoding stops at the first group holding anything but alphabet characters, e.g. padding or whitespace.
+ *  \return Number of groups decoded.
+ */
+size_t decodeBlock(const char* pSrc, size_t quadCount, unsigned char* pDst);
+
+/** Streaming base64 decoder. Encoded text is fed one line (or any chunk) at a time and decoded bytes are appended straight
+ *  to the output buffer. Groups may span lines, whitespace is skipped and decoding is done at '=' padding or finish().
+ */
+class Decoder {
+    public:
+        /** \param[out] output Buffer decoded bytes are appended to.
+         *  \param[in] encodedSize Expected encoded size used to preallocate the output, or 0 if not known.
+         */
+        Decoder(std::vector<unsigned char>& output, size_t encodedSize = 0);
+
+        /** Decode single line. Line terminator is optional.
+         *  \return False if line holds invalid characters. Decoder stays in error state afterwards.
+         */
+        bool feedLine(const char* pLine, size_t length);
+
+        /** Flush unpadded tail group.
+         *  \return True if all the data fed was decoded.
+         */
+        bool finish();
+
+        bool isDone() const { return mState == State::DONE; }
+        bool hasError() const { return mState == State::ERROR; }
+
+    private:
+        enum class State { DATA, DONE, ERROR };
+
+        void flushCarry();
+
+        std::vector<unsigned char>& mOutput;
+        State mState = State::DATA;
+        unsigned char mCarry[4];
+        size_t mCarryCount = 0;
+};
+
+}  // namespace base64
+
+/** Feed 'size' bytes of encoded data following ray_embeddedfile command to the decoder line by line. Data is read in
+ *  chunks of 'chunkSize' bytes, so only the decoded output is kept in memory. Lines split between chunks are joined.
+ *  \return False if stream holds less than 'size' bytes or decoder failed.
+ */
+template<typename Decoder>
+bool readEmbeddedFile(std::istream& in, size_t size, Decoder& decoder, size_t chunkSize = 1 << 20) {
+    std::vector<char> buff(std::min(size, chunkSize));
+    std::string line; // line split between chunks
+
+    size_t remaining = size;
+    while(remaining > 0 && !decoder.hasError()) {
+        const size_t readSize = std::min(remaining, buff.size());
+        in.read(buff.data(), readSize);
+        if(static_cast<size_t>(in.gcount()) != readSize) return false;
+        remaining -= readSize;
+
+        const char* p = buff.data();
+        const char* pEnd = p + readSize;
+        while(p != pEnd) {
+            const char* pNewline = static_cast<const char*>(memchr(p, '\n', pEnd - p));
+            if(!pNewline) {
+                line.append(p, pEnd);
+                break;
+            }
+            if(line.empty()) {
+                decoder.feedLine(p, pNewline - p);
+            } else {
+                line.append(p, pNewline);
+                decoder.feedLine(line.data(), line.size());
+                line.clear();
+            }
+            p = pNewline + 1;
+        }
+    }
+
+    if(!line.empty()) decoder.feedLine(line.data(), line.size());
+    return !decoder.hasError();
+}
+
 }  // namespace lsd
 
 }  // namespace lava
+
+#endif  // SRC_LAVA_LIB_READER_LSD_UUDECODE_H_
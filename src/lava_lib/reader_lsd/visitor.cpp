@@ -1,5 +1,6 @@
 #include <chrono>
 #include <exception>
+#include <cstring>
 
 #include "visitor.h"
 #include "session.h"
@@ -15,41 +16,25 @@ namespace lava {
 namespace lsd {
 
 bool readEmbeddedFileUU(std::istream* pParserStream, size_t size, std::vector<unsigned char>& decoded_data) {
-    LLOG_DBG << "Reading " << size << " bytes of embedded data";
+    LLOG_DBG << "Reading " << size << " bytes of uuencoded embedded data";
 
-    bool result = true;
-    std::istream &in = *pParserStream;
+    uu::Decoder decoder(decoded_data, size);
+    if(!readEmbeddedFile(*pParserStream, size, decoder) || !decoder.isDone()) {
+        LLOG_ERR << "Error decoding uuencoded embedded data !!!";
+        return false;
+    }
+    return true;
+}
 
-    std::vector<char> buff(size);
- 
-    // read size amount of bytes from stream into buff
-    in.unsetf(std::ios::skipws);
-    in.read((char *)buff.data(), size);
-    in.setf(std::ios::skipws);
-
-    // decode data
-    #ifdef _WIN32
-        // not implemented
-    #else
-    FILE* inMemFile = fmemopen((void *)buff.data(), size, "rw");
-    
-    FILE* outTestFile = fopen("/home/max/Desktop/mistery_file_decoded", "w");
+bool readEmbeddedFileBase64(std::istream* pParserStream, size_t size, std::vector<unsigned char>& decoded_data) {
+    LLOG_DBG << "Reading " << size << " bytes of base64 embedded data";
 
-    if(!uu::decodeUU(inMemFile, outTestFile)) {
-        LLOG_DBG << "Error decoding embedded data !!!";
+    base64::Decoder decoder(decoded_data, size);
+    if(!readEmbeddedFile(*pParserStream, size, decoder) || !decoder.finish()) {
+        LLOG_ERR << "Error decoding base64 embedded data !!!";
+        return false;
     }
-
-    fclose(inMemFile);
-    
-    if(outTestFile)
-        fclose(outTestFile);
-    // test write
-    //std::ofstream fout("/home/max/Desktop/mistery_file", std::ios::out | std::ios::binary);
-    //fout.write((char*)&buff[0], buff.size() * sizeof(unsigned char));
-    //fout.close();
-    #endif
-
-    return result;
+    return true;
 }
 
 bool readInlineBGEO(std::istream* pParserStream, ika::bgeo::Bgeo::SharedPtr pBgeo) {
@@ -260,7 +245,7 @@ void Visitor::operator()(ast::cmd_raytrace const& c) const {
 }
 
 void Visitor::operator()(ast::cmd_reset const& c) const {
-
+    mpSession->cmdReset(c.lights, c.objects, c.fogs);
 }
 
 void Visitor::operator()(ast::ray_embeddedfile const& c) const {
@@ -268,14 +253,28 @@ void Visitor::operator()(ast::ray_embeddedfile const& c) const {
     if(!pScope)
         return;
 
+    auto& embeddedData = pScope->getEmbeddedData(c.name);
+    embeddedData.clear();
+
+    bool result = false;
+    auto t1 = std::chrono::high_resolution_clock::now();
     if(c.encoding == ast::EmbedDataEncoding::UUENCODED) {
-        if(readEmbeddedFileUU(mpParserStream, c.size, pScope->getEmbeddedData(c.name))) {
-            LLOG_DBG << "Read embedded data size: " << pScope->getEmbeddedData(c.name).size();
-        }
+        result = readEmbeddedFileUU(mpParserStream, c.size, embeddedData);
+    } else if(c.encoding == ast::EmbedDataEncoding::BASE64) {
+        result = readEmbeddedFileBase64(mpParserStream, c.size, embeddedData);
     } else {
         LLOG_WRN << "Unknown embedded data encoding !!!";
         return;
     }
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    if(result) {
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count();
+        LLOG_DBG << "Read embedded data size: " << embeddedData.size() << " in: " << duration << " milsec.";
+    } else {
+        embeddedData.clear();
+        embeddedData.shrink_to_fit();
+    }
 }
 
 }  // namespace lsd
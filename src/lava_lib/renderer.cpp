@@ -10,6 +10,7 @@
 #include "Falcor/Utils/SampleGenerators/HaltonSamplePattern.h"
 
 #include "Falcor/Utils/Timing/Profiler.h"
+#include "Falcor/Utils/Timing/TraceRecorder.h"
 #include "Falcor/Utils/Scripting/Scripting.h"
 #include "Falcor/Utils/Scripting/Dictionary.h"
 #include "Falcor/Utils/Scripting/ScriptBindings.h"
@@ -32,6 +33,9 @@
 
 #include "lava_utils_lib/logging.h"
 
+#include "glm/gtx/matrix_decompose.hpp"
+#include "glm/gtx/quaternion.hpp"
+
 //#define USE_FORWARD_LIGHTING_PASS
 
 namespace Falcor {  
@@ -44,6 +48,40 @@ static bool isInVector(const std::vector<std::string>& strVec, const std::string
 	return std::find(strVec.begin(), strVec.end(), str) != strVec.end();
 }
 
+namespace {
+
+// Base-2 radical inverse. Gives well distributed shutter times for any number of accumulated samples
+inline double shutterSampleTime(uint32_t sampleNumber) {
+	sampleNumber = (sampleNumber << 16u) | (sampleNumber >> 16u);
+	sampleNumber = ((sampleNumber & 0x55555555u) << 1u) | ((sampleNumber & 0xAAAAAAAAu) >> 1u);
+	sampleNumber = ((sampleNumber & 0x33333333u) << 2u) | ((sampleNumber & 0xCCCCCCCCu) >> 2u);
+	sampleNumber = ((sampleNumber & 0x0F0F0F0Fu) << 4u) | ((sampleNumber & 0xF0F0F0F0u) >> 4u);
+	sampleNumber = ((sampleNumber & 0x00FF00FFu) << 8u) | ((sampleNumber & 0xFF00FF00u) >> 8u);
+	return static_cast<double>(sampleNumber) * 2.3283064365386963e-10; // / 2^32
+}
+
+glm::mat4 interpolateTransformSamples(const std::vector<glm::mat4>& samples, double time) {
+	assert(!samples.empty());
+	if (samples.size() == 1) return samples[0];
+
+	const double t = glm::clamp(time, 0.0, 1.0) * static_cast<double>(samples.size() - 1);
+	const size_t i = std::min(static_cast<size_t>(t), samples.size() - 2);
+	const float f = static_cast<float>(t - static_cast<double>(i));
+
+	glm::vec3 scale[2], translation[2], skew;
+	glm::quat rotation[2];
+	glm::vec4 perspective;
+	for (size_t j = 0; j < 2; ++j) {
+		if (!glm::decompose(samples[i + j], scale[j], rotation[j], translation[j], skew, perspective)) return samples[i];
+	}
+
+	return glm::translate(glm::mat4(1.f), glm::mix(translation[0], translation[1], f)) *
+		glm::mat4_cast(glm::slerp(rotation[0], rotation[1], f)) *
+		glm::scale(glm::mat4(1.f), glm::mix(scale[0], scale[1], f));
+}
+
+}  // namespace
+
 
 Renderer::SharedPtr Renderer::create(Device::SharedPtr pDevice) {
 	assert(pDevice);
@@ -86,7 +124,8 @@ bool Renderer::init(const Config& config) {
 
 	sceneBuilderFlags != SceneBuilder::Flags::AssumeLinearSpaceTextures;
 
-	mpSceneBuilder = lava::SceneBuilder::create(mpDevice, sceneBuilderFlags);
+	mSceneBuilderFlags = sceneBuilderFlags;
+	mpSceneBuilder = lava::SceneBuilder::create(mpDevice, mSceneBuilderFlags);
 	mpCamera = Falcor::Camera::create();
 	mpCamera->setName("main");
 	mpSceneBuilder->addCamera(mpCamera);
@@ -95,6 +134,21 @@ bool Renderer::init(const Config& config) {
 	return true;
 }
 
+void Renderer::resetScene() {
+	if(!mInited) return;
+
+	mpDevice->getRenderContext()->flush(true);
+	_mpScene = nullptr;
+
+	auto pSceneBuilder = lava::SceneBuilder::create(mpDevice, mSceneBuilderFlags);
+	pSceneBuilder->takeTemporaryGeometries(*mpSceneBuilder); // Geometry files might be loaded again by the new scene builder
+	pSceneBuilder->addCamera(mpCamera);
+	mpSceneBuilder = pSceneBuilder;
+
+	mSceneChanged = true;
+	mDirty = true;
+}
+
 Renderer::~Renderer() {
 	if(!mInited)
 		return;
@@ -341,6 +395,7 @@ void Renderer::createRenderGraph(const FrameInfo& frame_info) {
 		Falcor::Dictionary texturesResolvePassDictionary(mRenderPassesDict);
 		mpTexturesResolvePass = TexturesResolvePass::create(pRenderContext, texturesResolvePassDictionary);
 		mpTexturesResolvePass->setRasterizerState(Falcor::RasterizerState::create(rsDesc));
+		mpTexturesResolvePass->setFeedbackLatency(0); // resolve runs once before first frame sample, so requested pages are needed right away
 		mpTexturesResolvePass->setScene(pRenderContext, pScene);
 
 		mpTexturesResolvePassGraph->addPass(mpTexturesResolvePass, "SparseTexturesResolvePrePass");
@@ -629,7 +684,18 @@ void Renderer::createRenderGraph(const FrameInfo& frame_info) {
 	}
 
 	if(mRenderPassesDict.getValue<bool>("MAIN.OpenDenoisePass.enable", false) == true) {
-		auto pDenoisingPass = pMainAOV->createOpenDenoisePass(pRenderContext, {});
+		Falcor::Dictionary denoisingPassDictionary({});
+
+		if(mRenderPassesDict.keyExists("MAIN.OpenDenoisePass.async"))
+			denoisingPassDictionary["async"] = mRenderPassesDict["MAIN.OpenDenoisePass.async"];
+
+		if(mRenderPassesDict.keyExists("MAIN.OpenDenoisePass.tileSize"))
+			denoisingPassDictionary["tileSize"] = mRenderPassesDict["MAIN.OpenDenoisePass.tileSize"];
+
+		if(mRenderPassesDict.keyExists("MAIN.OpenDenoisePass.tileOverlap"))
+			denoisingPassDictionary["tileOverlap"] = mRenderPassesDict["MAIN.OpenDenoisePass.tileOverlap"];
+
+		auto pDenoisingPass = pMainAOV->createOpenDenoisePass(pRenderContext, denoisingPassDictionary);
 		if (pDenoisingPass) {
 			//Set denoiser parameters here
 			const auto pToneMapperPass = pMainAOV->tonemappingPass();
@@ -782,9 +848,20 @@ bool Renderer::prepareFrame(const FrameInfo& frame_info) {
 		return false;
 	}
 
+	Falcor::TraceRecorder::instance().markFrame(frame_info.frameNumber);
+	TRACE_SCOPE("Renderer::prepareFrame");
+
 	auto renderRegionDims = frame_info.renderRegionDims();
 	finalizeScene(frame_info);
 
+	if (mSceneChanged && mpRenderGraph) {
+		// Existing render graphs passes get rebound to the rebuilt scene
+		auto pScene = mpSceneBuilder->getScene();
+		mpRenderGraph->setScene(pScene);
+		if(mpTexturesResolvePassGraph) mpTexturesResolvePassGraph->setScene(pScene);
+	}
+	mSceneChanged = false;
+
 	if (!mpRenderGraph) {
 		createRenderGraph(frame_info);
 	} else if (
@@ -823,6 +900,8 @@ bool Renderer::prepareFrame(const FrameInfo& frame_info) {
 }
 
 void Renderer::renderSample() {
+	TRACE_SCOPE("Renderer::renderSample");
+
 	if (mDirty) {
 		prepareFrame(mCurrentFrameInfo);
 	}
@@ -853,6 +932,16 @@ void Renderer::renderSample() {
 		}
 	}
 
+	// Motion blur. Each accumulated sample is rendered at it's own normalized shutter time
+	double currentTime = 0;
+	const bool hasCameraMotion = mCameraViewMatrixSamples.size() > 1;
+	if (hasCameraMotion || mpSceneBuilder->hasTransformMotion()) {
+		currentTime = shutterSampleTime(mCurrentSampleNumber);
+		// View matrix translation is -R^T*p so it can't be interpolated directly. Blend camera-to-world samples instead
+		if (hasCameraMotion) mpCamera->setViewMatrix(glm::inverse(interpolateTransformSamples(mCameraToWorldSamples, currentTime)));
+	}
+	_mpScene->update(pRenderContext, currentTime);
+
 	mpRenderGraph->execute(pRenderContext, mCurrentFrameInfo.frameNumber, mCurrentSampleNumber);
 	
 	// Hard sync every 16 samples. TODO: this is UGLY !
@@ -860,11 +949,17 @@ void Renderer::renderSample() {
 		//pRenderContext->flush(true);
 	}
 
-	double currentTime = 0;
-	_mpScene->update(pRenderContext, currentTime);
-
 	mCurrentSampleNumber++;
 
+	if ((mCurrentFrameInfo.imageSamples > 0) && (mCurrentSampleNumber == mCurrentFrameInfo.imageSamples)) {
+		// Last sample. Async denoisers are still busy with an earlier accumulation, so final image gets one synchronous denoise
+		for(auto &pair: mAOVPlanes) {
+			auto pDenoiserPass = pair.second->denoisingPass();
+			if (!pDenoiserPass || !pDenoiserPass->isAsync()) continue;
+			pDenoiserPass->waitForPendingTask();
+			pDenoiserPass->requestSyncDenoise();
+		}
+	}
 }
 
 const uint8_t* Renderer::getAOVPlaneImageData(const AOVName& name) {
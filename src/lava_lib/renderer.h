@@ -107,6 +107,11 @@ class LAVA_API Renderer: public std::enable_shared_from_this<Renderer> {
     bool init(const Config& config);
     bool isInited() const { return mInited; }
 
+    /** Replace scene builder with an empty one. Camera, render graph and AOV planes are kept and get bound
+        to the new scene when the next frame gets prepared.
+    */
+    void resetScene();
+
     const std::map<std::string, AOVPlane::SharedPtr>& aovPlanes() const { return mAOVPlanes; }
 
     AOVPlane::SharedPtr addAOVPlane(const AOVPlaneInfo& info);
@@ -122,6 +127,14 @@ class LAVA_API Renderer: public std::enable_shared_from_this<Renderer> {
 
     Falcor::Camera::SharedPtr currentCamera() { return mpCamera; };
 
+    /** Set camera view matrix samples evenly distributed over the shutter interval. Single sample disables camera motion blur.
+    */
+    void setCameraViewMatrixSamples(const std::vector<glm::mat4>& viewMatrixSamples) {
+        mCameraViewMatrixSamples = viewMatrixSamples;
+        mCameraToWorldSamples.resize(viewMatrixSamples.size());
+        for(size_t i = 0; i < viewMatrixSamples.size(); ++i) mCameraToWorldSamples[i] = glm::inverse(viewMatrixSamples[i]);
+    };
+
     /** Query AOV output (if exist) geometry
       \param[in] AOV name/path. Example: "AccumulatePass.output"
       \param[out] AOV geometry information.
@@ -189,6 +202,7 @@ class LAVA_API Renderer: public std::enable_shared_from_this<Renderer> {
     Falcor::ArgList 			          mArgList;
 
     lava::SceneBuilder::SharedPtr   mpSceneBuilder;
+    SceneBuilder::Flags             mSceneBuilderFlags = SceneBuilder::Flags::Default;
     Falcor::Sampler::SharedPtr      mpSampler;
     std::vector<GraphData>          mGraphs;
     uint32_t mActiveGraph = 0;
@@ -196,6 +210,8 @@ class LAVA_API Renderer: public std::enable_shared_from_this<Renderer> {
     Config                          mCurrentConfig;
     FrameInfo                       mCurrentFrameInfo;
     std::uint32_t                   mCurrentSampleNumber = 0;
+    std::vector<glm::mat4>          mCameraViewMatrixSamples;
+    std::vector<glm::mat4>          mCameraToWorldSamples;
 
     ///
     float2 mInvFrameDim;
@@ -221,6 +237,7 @@ class LAVA_API Renderer: public std::enable_shared_from_this<Renderer> {
     bool mMainAOVPlaneExist = false;
     bool mInited = false;
     bool mDirty = true;
+    bool mSceneChanged = false;
 
   private:
     // RenderFrame private
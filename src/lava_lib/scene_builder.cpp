@@ -26,19 +26,31 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include <array>
+#include <algorithm>
 #include <thread>
 #include <cmath>
 #include <limits>
 #include <numeric>
+#include <cstring>
+
+#include "glm/gtc/type_ptr.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtx/matrix_decompose.hpp"
 
 #include "Falcor/Core/API/Texture.h"
 #include "Falcor/Scene/Material/StandardMaterial.h"
+#include "Falcor/Scene/Volume/GridVolume.h"
+#include "Falcor/Utils/Timing/TraceRecorder.h"
 
 #include "scene_builder.h"
 #include "lava_utils_lib/logging.h"
 
 #include "reader_bgeo/bgeo/Run.h"
 #include "reader_bgeo/bgeo/Poly.h"
+#include "reader_bgeo/bgeo/PackedGeometry.h"
+#include "reader_bgeo/bgeo/PackedDisk.h"
+#include "reader_bgeo/bgeo/AlembicRef.h"
+#include "reader_bgeo/bgeo/Volume.h"
 #include "reader_bgeo/bgeo/PrimType.h"
 #include "reader_bgeo/bgeo/parser/types.h"
 #include "reader_bgeo/bgeo/parser/Attribute.h"
@@ -49,6 +61,132 @@ namespace lava {
 
 #define FIX_BGEO_UV
 
+namespace {
+
+// Streaming 64-bit hash (MurmurHash3 style mixing, 8 bytes per step) used to identify geometry content.
+// A second independent hash and the hashed byte count are kept to verify cache hits, so a collision of the primary
+// hash alone doesn't merge two different geometries.
+class GeometryHasher {
+  public:
+    inline void update(uint64_t value) { mix(value); }
+
+    void update(const void* pData, size_t size) {
+        const uint8_t* pBytes = reinterpret_cast<const uint8_t*>(pData);
+        update(static_cast<uint64_t>(size));
+        for (; size >= 8; size -= 8, pBytes += 8) {
+            uint64_t k;
+            std::memcpy(&k, pBytes, 8);
+            mix(k);
+        }
+        if (size > 0) {
+            uint64_t k = 0;
+            std::memcpy(&k, pBytes, size);
+            mix(k);
+        }
+    }
+
+    template<typename T>
+    inline void update(const std::vector<T>& data) { update(data.data(), data.size() * sizeof(T)); }
+
+    uint64_t digest() const {
+        uint64_t h = mHash ^ mLength;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    uint64_t secondaryDigest() const {
+        uint64_t h = mSecondaryHash ^ mLength;
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return h;
+    }
+
+    inline uint64_t length() const { return mLength; }
+
+  private:
+    static inline uint64_t rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+    inline void mix(uint64_t k) {
+        k *= 0x87c37b91114253d5ULL;
+        k = rotl64(k, 31);
+        k *= 0x4cf5ad432745937fULL;
+        mHash ^= k;
+        mHash = rotl64(mHash, 27) * 5 + 0x52dce729;
+
+        uint64_t k2 = rotl64(k, 17) * 0xa0761d6478bd642fULL;
+        mSecondaryHash ^= k2;
+        mSecondaryHash = rotl64(mSecondaryHash, 31) * 9 + 0x38495ab5;
+        mLength += 8;
+    }
+
+    uint64_t mHash = 0x9e3779b97f4a7c15ULL;
+    uint64_t mSecondaryHash = 0x2545f4914f6cdd1dULL;
+    uint64_t mLength = 0;
+};
+
+// Packed primitive resolved to the geometry it instances
+struct PackedPrimitive {
+    uint32_t geometryID;
+    float4x4 transform;
+    std::string materialName; // Primitive shop_materialpath or empty to inherit the instance material
+};
+
+// Number of Houdini primitives a parsed primitive stands for. Primitive attributes hold a value per Houdini primitive,
+// while polygons are parsed as runs.
+int64_t houdiniPrimitiveCount(const ika::bgeo::Bgeo::PrimitivePtr& pPrim) {
+    if(pPrim && pPrim->getType() == ika::bgeo::PrimType::PolyPrimType) return pPrim->cast<ika::bgeo::Poly>()->getFaceCount();
+    return 1;
+}
+
+// Packed primitive transform is (P - pivot) * transform + point P in Houdini row-vector convention
+float4x4 packedPrimitiveTransform(const ika::bgeo::PackedGeometry& packed) {
+    double translate[3], pivot[3], transform[16];
+    packed.getTranslate(translate);
+    packed.getPivot(pivot);
+    packed.getExtraTransform(transform);
+
+    // Row-major row-vector matrix reads as column-major column-vector one
+    const float4x4 m = glm::mat4(glm::make_mat4(transform));
+    return glm::translate(float4x4(1.f), float3(translate[0], translate[1], translate[2])) * m * glm::translate(float4x4(1.f), -float3(pivot[0], pivot[1], pivot[2]));
+}
+
+// Houdini volume voxels fill [-1, 1] box transformed by the primitive transform and moved to it's point P. Grids keep
+// voxel (i, j, k) at index space position (i, j, k), so index space is mapped onto voxel centers of that box.
+float4x4 volumePrimitiveTransform(const ika::bgeo::Volume& volume, const int3& resolution) {
+    double translate[3], transform[16];
+    volume.getTranslate(translate);
+    volume.getExtraTransform(transform);
+
+    // Row-major row-vector matrix reads as column-major column-vector one
+    const float4x4 m = glm::mat4(glm::make_mat4(transform));
+    const float3 voxelSize = float3(2.f) / float3(resolution);
+    return glm::translate(float4x4(1.f), float3(translate[0], translate[1], translate[2])) * m *
+        glm::translate(float4x4(1.f), float3(-1.f) + voxelSize * 0.5f) * glm::scale(float4x4(1.f), voxelSize);
+}
+
+enum class VolumeField {
+    Density,
+    DirectEmission,
+    BlackbodyEmission,
+    Unsupported,
+};
+
+VolumeField volumeField(const std::string& name) {
+    if(name.empty() || name == "density") return VolumeField::Density;
+    if(name == "emission" || name == "heat") return VolumeField::DirectEmission;
+    if(name == "temperature") return VolumeField::BlackbodyEmission;
+    return VolumeField::Unsupported;
+}
+
+}  // namespace
+
 SceneBuilder::SceneBuilder(Falcor::Device::SharedPtr pDevice, Flags buildFlags): Falcor::SceneBuilder(pDevice, buildFlags), mUniqueTrianglesCount(0) {
     mpDefaultMaterial = StandardMaterial::create(pDevice, "default");
     mpDefaultMaterial->setBaseColor({0.4, 0.4, 0.4});
@@ -56,6 +194,8 @@ SceneBuilder::SceneBuilder(Falcor::Device::SharedPtr pDevice, Flags buildFlags):
     mpDefaultMaterial->setIndexOfRefraction(1.5);
     mpDefaultMaterial->setEmissiveFactor(0.0);
     mpDefaultMaterial->setReflectivity(1.0);
+
+    mpAlembicSource = AlembicSource::create();
 }
 
 SceneBuilder::~SceneBuilder() {
@@ -69,6 +209,8 @@ SceneBuilder::~SceneBuilder() {
     
     LLOG_INF << "\nSceneBuilder stats:";
     LLOG_INF << "\t Unique triangles count: " << std::to_string(mUniqueTrianglesCount);
+    LLOG_INF << "\t Deduplicated geometries count: " << std::to_string(mDeduplicatedGeometriesCount);
+    LLOG_INF << "\t Deduplicated geometries bytes saved: " << std::to_string(mDeduplicatedBytesCount);
     LLOG_INF << std::endl;
 }
 
@@ -122,24 +264,23 @@ static inline uint32_t tesselatePolySimple(const std::vector<float3>& positions,
 
 uint32_t SceneBuilder::addGeometry(ika::bgeo::Bgeo::SharedConstPtr pBgeo, const std::string& name) {
     assert(pBgeo);
+    TRACE_SCOPE("SceneBuilder::addGeometry");
 
     const auto pDetail = pBgeo->getDetail();
     const int64_t bgeo_point_count = pBgeo->getPointCount();
     const int64_t bgeo_vertex_count = pBgeo->getTotalVertexCount();
 
-    auto pPrimitiveMatrialAttribute =  pBgeo->getPrimitiveAttributeByName("shop_materialpath");
-    const bool hasPerPrimitiveMaterial = pPrimitiveMatrialAttribute != nullptr;
+    BgeoMeshData data;
 
-    std::vector<std::string> bgeoPerPrimitiveMaterialNames;
-    std::vector<int32_t> bgeoPerPrimitiveMaterialIDs;       // id's in bgeoPerPrimitiveMaterialNames list. where -1 means global mesh material 
-    std::vector<int32_t> meshPerPrimitiveMaterialIDs;
+    auto pPrimitiveMatrialAttribute =  pBgeo->getPrimitiveAttributeByName("shop_materialpath");
+    data.hasPerPrimitiveMaterial = pPrimitiveMatrialAttribute != nullptr;
 
-    if (hasPerPrimitiveMaterial) {
+    if (data.hasPerPrimitiveMaterial) {
         LLOG_TRC << "Mesh " << name << " has per-primitive materials assigned !";
-        pPrimitiveMatrialAttribute->getStrings(bgeoPerPrimitiveMaterialNames);
-        pPrimitiveMatrialAttribute->getData(bgeoPerPrimitiveMaterialIDs);
+        pPrimitiveMatrialAttribute->getStrings(data.perPrimitiveMaterialNames);
+        pPrimitiveMatrialAttribute->getData(data.perPrimitiveMaterialIDs);
 
-        LLOG_WRN << "Per primitive material indices count:" << bgeoPerPrimitiveMaterialIDs.size();
+        LLOG_WRN << "Per primitive material indices count:" << data.perPrimitiveMaterialIDs.size();
         LLOG_WRN << "Primitive count:" << pBgeo->getPrimitiveCount();
     }
 
@@ -150,26 +291,246 @@ uint32_t SceneBuilder::addGeometry(ika::bgeo::Bgeo::SharedConstPtr pBgeo, const
 
     // get basic bgeo data P, N, UV
 
-    std::vector<float> P;
-    pBgeo->getP(P);
-    assert(P.size() / 3 == bgeo_point_count && "P positions count not equal to the bgeo points count !!!");
-    LLOG_TRC << "P<float> size: " << P.size();
+    pBgeo->getP(data.P);
+    assert(data.P.size() / 3 == bgeo_point_count && "P positions count not equal to the bgeo points count !!!");
+    LLOG_TRC << "P<float> size: " << data.P.size();
 
-    std::vector<float> N;
-    pBgeo->getPointN(N);
-    LLOG_TRC << "N<float> size: " << N.size();
+    pBgeo->getPointN(data.N);
+    LLOG_TRC << "N<float> size: " << data.N.size();
     
-    std::vector<float> UV;
-    pBgeo->getPointUV(UV);
-    LLOG_TRC << "UV<float> size: " << UV.size();
+    pBgeo->getPointUV(data.UV);
+    LLOG_TRC << "UV<float> size: " << data.UV.size();
 
-    std::vector<float> vN;
-    pBgeo->getVertexN(vN);
-    LLOG_TRC << "vN<float> size: " << vN.size();
+    pBgeo->getVertexN(data.vN);
+    LLOG_TRC << "vN<float> size: " << data.vN.size();
     
-    std::vector<float> vUV;
-    pBgeo->getVertexUV(vUV);
-    LLOG_TRC << "vUV<float> size: " << vUV.size();
+    pBgeo->getVertexUV(data.vUV);
+    LLOG_TRC << "vUV<float> size: " << data.vUV.size();
+
+    // Resolve packed primitives first. Embedded and disk geometries are added (and deduplicated) as separate geometries
+    // so their ids identify the packed content in this geometry hash.
+    std::vector<PackedPrimitive> packedInstances;
+    bool hasPolyPrimitives = false;
+    bool hasVolumePrimitives = false;
+
+    // Material assigned to Houdini primitive, or empty if there is none
+    const auto primitiveMaterialName = [&data](int64_t houdiniPrimIndex) {
+        if(!data.hasPerPrimitiveMaterial || houdiniPrimIndex >= static_cast<int64_t>(data.perPrimitiveMaterialIDs.size())) return std::string();
+        const int32_t materialID = data.perPrimitiveMaterialIDs[houdiniPrimIndex];
+        if(materialID < 0 || materialID >= static_cast<int32_t>(data.perPrimitiveMaterialNames.size())) return std::string();
+        return data.perPrimitiveMaterialNames[materialID];
+    };
+
+    int64_t houdiniPrimIndex = 0;
+    for(uint32_t p_i=0; p_i < pBgeo->getPrimitiveCount(); houdiniPrimIndex += houdiniPrimitiveCount(pBgeo->getPrimitive(p_i)), p_i++) {
+        const auto& pPrim = pBgeo->getPrimitive(p_i);
+        if(!pPrim) continue;
+
+        switch (pPrim->getType()) {
+            case ika::bgeo::PrimType::PolyPrimType:
+                hasPolyPrimitives = true;
+                break;
+            case ika::bgeo::PrimType::PackedGeometryPrimType:
+            case ika::bgeo::PrimType::PackedDiskPrimType:
+                {
+                    const ika::bgeo::PackedGeometry* pPacked = pPrim->cast<ika::bgeo::PackedGeometry>();
+                    uint32_t packedGeometryID = kInvalidGeometryID;
+                    if(pPrim->getType() == ika::bgeo::PrimType::PackedDiskPrimType) {
+                        packedGeometryID = addPackedDiskGeometry(pPrim->cast<ika::bgeo::PackedDisk>()->getFilename());
+                    } else if (pPacked->getEmbeddedGeo()) {
+                        packedGeometryID = addGeometry(pPacked->getEmbeddedGeo(), name + "_packed");
+                    }
+                    if(packedGeometryID == kInvalidGeometryID) {
+                        LLOG_WRN << "Unable to resolve packed primitive " << p_i << " geometry in " << name;
+                        break;
+                    }
+                    packedInstances.push_back({packedGeometryID, packedPrimitiveTransform(*pPacked), primitiveMaterialName(houdiniPrimIndex)});
+                }
+                break;
+            case ika::bgeo::PrimType::AlembicPrimType:
+                {
+                    const ika::bgeo::AlembicRef* pRef = pPrim->cast<ika::bgeo::AlembicRef>();
+                    const AlembicGeometry abcGeometry = addAlembicGeometry(pRef->getFilename(), pRef->getObjectPath(), pRef->getFrame());
+                    if(abcGeometry.geometryID == kInvalidGeometryID) {
+                        LLOG_WRN << "Unable to resolve Alembic primitive " << p_i << " geometry in " << name;
+                        break;
+                    }
+                    const float4x4 transform = packedPrimitiveTransform(*pRef);
+                    packedInstances.push_back({abcGeometry.geometryID, pRef->getUseTransform() ? transform * abcGeometry.transform : transform, primitiveMaterialName(houdiniPrimIndex)});
+                }
+                break;
+            case ika::bgeo::PrimType::PackedFragmentPrimType:
+                LLOG_WRN << "Packed fragment primitives are not supported yet. Skipping primitive " << p_i << " in " << name;
+                break;
+            case ika::bgeo::PrimType::VolumePrimType:
+                hasVolumePrimitives = true;
+                break;
+            default:
+                break;
+        }
+    }
+
+    std::vector<VolumeInstance> volumes;
+    if(hasVolumePrimitives) addBgeoVolumes(pBgeo, name, volumes);
+
+    // Hash geometry content so identical details exported under different names share the same geometry
+    std::promise<uint32_t> geometryIDPromise;
+    std::shared_ptr<GeometryCacheEntry> pCacheEntry;
+    uint64_t geometryHash = 0;
+    {
+        GeometryHasher hasher;
+        hasher.update(static_cast<uint64_t>(bgeo_point_count));
+        hasher.update(static_cast<uint64_t>(bgeo_vertex_count));
+        hasher.update(data.P);
+        hasher.update(data.N);
+        hasher.update(data.UV);
+        hasher.update(data.vN);
+        hasher.update(data.vUV);
+
+        if(pDetail) {
+            auto const& vt_map = pDetail->getVertexMap();
+            hasher.update(vt_map.getVertices(), vt_map.getVertexCount() * sizeof(ika::bgeo::parser::int32));
+        }
+
+        std::vector<int32_t> start_indices;
+        for(uint32_t p_i=0; p_i < pBgeo->getPrimitiveCount(); p_i++) {
+            const auto& pPrim = pBgeo->getPrimitive(p_i);
+            if(!pPrim) continue;
+            hasher.update(static_cast<uint64_t>(pPrim->getType()));
+            if(pPrim->getType() == ika::bgeo::PrimType::PolyPrimType) {
+                std::dynamic_pointer_cast<ika::bgeo::Poly>(pPrim)->getStartIndices(start_indices);
+                hasher.update(start_indices);
+            }
+        }
+
+        for(const auto& packedInstance: packedInstances) {
+            hasher.update(static_cast<uint64_t>(packedInstance.geometryID));
+            hasher.update(&packedInstance.transform, sizeof(packedInstance.transform));
+            hasher.update(packedInstance.materialName.data(), packedInstance.materialName.size());
+        }
+
+        for(const auto& volume: volumes) {
+            const auto& grids = *volume.pGrids;
+            hasher.update(grids.name.data(), grids.name.size());
+            hasher.update(&grids.resolution, sizeof(grids.resolution));
+            hasher.update(static_cast<uint64_t>(grids.emissionMode));
+            hasher.update(grids.densityVoxels);
+            hasher.update(grids.emissionVoxels);
+            hasher.update(&volume.transform, sizeof(volume.transform));
+        }
+
+        hasher.update(data.perPrimitiveMaterialIDs);
+        for(const auto& material_name: data.perPrimitiveMaterialNames) {
+            hasher.update(material_name.data(), material_name.size());
+        }
+
+        geometryHash = hasher.digest();
+        std::shared_ptr<GeometryCacheEntry> pDuplicateEntry;
+        {
+            std::scoped_lock lock(mGeometryCacheMutex);
+            auto it = mGeometryCache.find(geometryHash);
+            if(it == mGeometryCache.end()) {
+                pCacheEntry = std::make_shared<GeometryCacheEntry>();
+                pCacheEntry->geometryID = geometryIDPromise.get_future().share();
+                pCacheEntry->secondaryHash = hasher.secondaryDigest();
+                pCacheEntry->hashedLength = hasher.length();
+                mGeometryCache[geometryHash] = pCacheEntry;
+            } else if(it->second->secondaryHash == hasher.secondaryDigest() && it->second->hashedLength == hasher.length()) {
+                pDuplicateEntry = it->second;
+            } else {
+                // Primary hash collision. Load this geometry on it's own and leave the cache entry to the original.
+                LLOG_WRN << "Geometry " << name << " content hash collides with different geometry. Not deduplicating it.";
+            }
+        }
+
+        if(pDuplicateEntry) {
+            uint32_t geometryID = kInvalidGeometryID;
+            try {
+                // The original may still be loading on another thread. Run pending work meanwhile instead of idling.
+                const auto& future = pDuplicateEntry->geometryID;
+                TaskScheduler::instance().helpWhileWaiting([&future](std::chrono::microseconds timeout) {
+                    return future.wait_for(timeout) == std::future_status::ready;
+                });
+                geometryID = future.get();
+            } catch (const std::exception& e) {
+                // The original failed to load. It's cache entry is already gone, so just load this one on it's own.
+                LLOG_WRN << "Error getting deduplicated geometry for " << name << " : " << e.what() << ". Loading it separately.";
+            }
+            if(geometryID != kInvalidGeometryID) {
+                mDeduplicatedGeometriesCount++;
+                mDeduplicatedBytesCount += pDuplicateEntry->byteSize;
+                LLOG_DBG << "Geometry " << name << " is identical to already loaded geometry " << std::to_string(geometryID) << ". Reusing it.";
+                return geometryID;
+            }
+        }
+    }
+
+    // Drops the cache entry and breaks it's promise if loading fails, so that duplicates waiting for it (or arriving later)
+    // load their own copy instead of failing too.
+    const auto failCacheEntry = [&](std::exception_ptr pException) {
+        if(!pCacheEntry) return;
+        {
+            std::scoped_lock lock(mGeometryCacheMutex);
+            auto it = mGeometryCache.find(geometryHash);
+            if(it != mGeometryCache.end() && it->second == pCacheEntry) mGeometryCache.erase(it);
+        }
+        geometryIDPromise.set_exception(pException);
+    };
+
+    Geometry geometry;
+    size_t byteSize = 0;
+
+    try {
+        if(hasPolyPrimitives || (packedInstances.empty() && volumes.empty())) {
+            geometry.meshID = addPolyMesh(pBgeo, name, data, byteSize);
+        }
+    } catch (...) {
+        failCacheEntry(std::current_exception());
+        throw;
+    }
+
+    geometry.volumes = std::move(volumes);
+
+    // Flatten nested packed geometries so each instance references a mesh (or volume grids) directly
+    for(const auto& packedInstance: packedInstances) {
+        const Geometry& packedGeometry = getGeometry(packedInstance.geometryID);
+        if(packedGeometry.meshID != kInvalidMeshID) {
+            geometry.packedInstances.push_back({packedGeometry.meshID, packedInstance.transform, packedInstance.materialName});
+        }
+        // Nested packed primitive material wins over the one of the packed primitive containing it
+        for(const auto& nestedInstance: packedGeometry.packedInstances) {
+            const std::string& materialName = nestedInstance.materialName.empty() ? packedInstance.materialName : nestedInstance.materialName;
+            geometry.packedInstances.push_back({nestedInstance.meshID, packedInstance.transform * nestedInstance.transform, materialName});
+        }
+        for(const auto& nestedVolume: packedGeometry.volumes) {
+            geometry.volumes.push_back({nestedVolume.pGrids, packedInstance.transform * nestedVolume.transform});
+        }
+    }
+
+    const uint32_t geometryID = registerGeometry(std::move(geometry));
+
+    if(pCacheEntry) {
+        pCacheEntry->byteSize = byteSize;
+        geometryIDPromise.set_value(geometryID);
+    }
+
+    return geometryID;
+}
+
+uint32_t SceneBuilder::addPolyMesh(ika::bgeo::Bgeo::SharedConstPtr pBgeo, const std::string& name, const BgeoMeshData& data, size_t& byteSize) {
+    const auto pDetail = pBgeo->getDetail();
+    const int64_t bgeo_vertex_count = pBgeo->getTotalVertexCount();
+
+    const auto& P = data.P;
+    const auto& N = data.N;
+    const auto& UV = data.UV;
+    const auto& vN = data.vN;
+    const auto& vUV = data.vUV;
+
+    const bool hasPerPrimitiveMaterial = data.hasPerPrimitiveMaterial;
+    const auto& bgeoPerPrimitiveMaterialNames = data.perPrimitiveMaterialNames;
+    const auto& bgeoPerPrimitiveMaterialIDs = data.perPrimitiveMaterialIDs;   // id's in bgeoPerPrimitiveMaterialNames list. where -1 means global mesh material 
+    std::vector<int32_t> meshPerPrimitiveMaterialIDs;
 
     bool unique_points = false; // separate points only if we have any vertex data present
     if(vN.size() || vUV.size()) unique_points = true; 
@@ -252,11 +613,13 @@ uint32_t SceneBuilder::addGeometry(ika::bgeo::Bgeo::SharedConstPtr pBgeo, const
     // process primitives and build indices
 
     uint32_t mesh_face_count = 0;
-    uint32_t polygon_id = 0;
     std::vector<uint32_t> indices;
     std::vector<int32_t> prim_start_indices;
 
-    for(uint32_t p_i=0; p_i < pBgeo->getPrimitiveCount(); p_i++) {
+    // Primitive attributes are indexed by Houdini primitive, so faces of poly runs are offset by all the preceding
+    // primitives, packed ones included.
+    int64_t houdiniPrimIndex = 0;
+    for(uint32_t p_i=0; p_i < pBgeo->getPrimitiveCount(); houdiniPrimIndex += houdiniPrimitiveCount(pBgeo->getPrimitive(p_i)), p_i++) {
         const auto& pPrim = pBgeo->getPrimitive(p_i);
         if(!pPrim) {
             LLOG_WRN << "Unable to get primitive number: " << p_i;
@@ -299,10 +662,11 @@ uint32_t SceneBuilder::addGeometry(ika::bgeo::Bgeo::SharedConstPtr pBgeo, const
                                 break;
                         }
                         if(hasPerPrimitiveMaterial && (face_count > 0)) {
+                            const int64_t polygon_id = houdiniPrimIndex + i;
+                            const int32_t materialID = polygon_id < static_cast<int64_t>(bgeoPerPrimitiveMaterialIDs.size()) ? bgeoPerPrimitiveMaterialIDs[polygon_id] : -1;
                             for(uint32_t ti = 0; ti < face_count; ++ti) {
-                                meshPerPrimitiveMaterialIDs.push_back(bgeoPerPrimitiveMaterialIDs[polygon_id]);
+                                meshPerPrimitiveMaterialIDs.push_back(materialID);
                             }
-                            polygon_id++;
                         }
                         mesh_face_count += face_count;
                     }
@@ -312,6 +676,12 @@ uint32_t SceneBuilder::addGeometry(ika::bgeo::Bgeo::SharedConstPtr pBgeo, const
 
                 }
 
+                break;
+            case ika::bgeo::PrimType::PackedGeometryPrimType:
+            case ika::bgeo::PrimType::PackedDiskPrimType:
+            case ika::bgeo::PrimType::PackedFragmentPrimType:
+            case ika::bgeo::PrimType::AlembicPrimType:
+                // packed primitives are instanced by addGeometry()
                 break;
             default:
                 LLOG_WRN << "Unsupported prim type \"" + std::string(pPrim->getStrType()) + "\" !!!";
@@ -377,21 +747,371 @@ uint32_t SceneBuilder::addGeometry(ika::bgeo::Bgeo::SharedConstPtr pBgeo, const
 
     mUniqueTrianglesCount += mesh_face_count;
 
+    byteSize = mesh.vertexCount * (sizeof(float3) * 2 + sizeof(float2)) + mesh.indexCount * sizeof(uint32_t);
+
     return Falcor::SceneBuilder::addMesh(mesh);
 }
 
-std::shared_future<uint32_t> SceneBuilder::addGeometryAsync(lsd::scope::Geo::SharedConstPtr pGeo, const std::string& name) {
+uint32_t SceneBuilder::addPackedDiskGeometry(const std::string& filename) {
+    std::promise<uint32_t> geometryIDPromise;
+    std::shared_future<uint32_t> geometryIDFuture;
+    bool isDuplicate = false;
+    {
+        std::scoped_lock lock(mGeometryCacheMutex);
+        auto it = mPackedDiskGeometries.find(filename);
+        if(it != mPackedDiskGeometries.end()) {
+            geometryIDFuture = it->second;
+            isDuplicate = true;
+        } else {
+            geometryIDFuture = geometryIDPromise.get_future().share();
+            mPackedDiskGeometries[filename] = geometryIDFuture;
+        }
+    }
+
+    if(isDuplicate) {
+        // The same file may still be loading on another thread. Run pending work meanwhile instead of idling.
+        TaskScheduler::instance().helpWhileWaiting([&geometryIDFuture](std::chrono::microseconds timeout) {
+            return geometryIDFuture.wait_for(timeout) == std::future_status::ready;
+        });
+        return geometryIDFuture.get();
+    }
+
+    // Failed loads are cached too, so broken references are reported once
+    uint32_t geometryID = kInvalidGeometryID;
+    ika::bgeo::Bgeo::SharedPtr pBgeo = ika::bgeo::Bgeo::create();
+    try {
+        pBgeo->readGeoFromFile(filename.c_str(), false); // FIXME: don't check version for now
+        pBgeo->preCachePrimitives();
+        geometryID = addGeometry(pBgeo, fs::path(filename).stem().string());
+    } catch (const std::exception& e) {
+        LLOG_ERR << "Error loading packed disk geometry " << filename << " : " << e.what();
+    }
+
+    geometryIDPromise.set_value(geometryID);
+    return geometryID;
+}
+
+SceneBuilder::AlembicGeometry SceneBuilder::addAlembicGeometry(const std::string& filename, const std::string& objectPath, double time) {
+    uint64_t timeBits;
+    std::memcpy(&timeBits, &time, sizeof(timeBits));
+    const std::string key = filename + ":" + objectPath + ":" + std::to_string(timeBits);
+
+    std::promise<AlembicGeometry> geometryPromise;
+    std::shared_future<AlembicGeometry> geometryFuture;
+    bool isDuplicate = false;
+    {
+        std::scoped_lock lock(mGeometryCacheMutex);
+        auto it = mAlembicGeometries.find(key);
+        if(it != mAlembicGeometries.end()) {
+            geometryFuture = it->second;
+            isDuplicate = true;
+        } else {
+            geometryFuture = geometryPromise.get_future().share();
+            mAlembicGeometries[key] = geometryFuture;
+        }
+    }
+
+    if(isDuplicate) {
+        // The same object sample may still be loading on another thread. Run pending work meanwhile instead of idling.
+        TaskScheduler::instance().helpWhileWaiting([&geometryFuture](std::chrono::microseconds timeout) {
+            return geometryFuture.wait_for(timeout) == std::future_status::ready;
+        });
+        return geometryFuture.get();
+    }
+
+    TRACE_SCOPE("SceneBuilder::addAlembicGeometry");
+
+    AlembicGeometry abcGeometry;
+    AlembicSource::MeshData data;
+    if(mpAlembicSource->readMesh(filename, objectPath, time, data)) {
+        Mesh mesh;
+        mesh.name = fs::path(filename).stem().string() + objectPath;
+        mesh.faceCount = data.faceCount;
+        mesh.vertexCount = static_cast<uint32_t>(data.positions.size());
+        mesh.indexCount = static_cast<uint32_t>(data.indices.size());
+        mesh.pIndices = data.indices.data();
+        mesh.positions.frequency = Mesh::AttributeFrequency::Vertex;
+        mesh.positions.pData = data.positions.data();
+        mesh.normals.frequency = Mesh::AttributeFrequency::Vertex;
+        mesh.normals.pData = data.normals.data();
+        mesh.texCrds.frequency = Mesh::AttributeFrequency::Vertex;
+        mesh.texCrds.pData = data.texCrds.data();
+        mesh.topology = Falcor::Vao::Topology::TriangleList;
+        mesh.pMaterial = mpDefaultMaterial;
+
+        mUniqueTrianglesCount += data.faceCount;
+
+        Geometry geometry;
+        geometry.meshID = Falcor::SceneBuilder::addMesh(mesh);
+        abcGeometry.geometryID = registerGeometry(std::move(geometry));
+        abcGeometry.transform = data.transform;
+    }
+
+    // Failed reads are cached too, so broken references are reported once
+    geometryPromise.set_value(abcGeometry);
+    return abcGeometry;
+}
+
+void SceneBuilder::addBgeoVolumes(ika::bgeo::Bgeo::SharedConstPtr pBgeo, const std::string& name, std::vector<VolumeInstance>& volumes) {
+    std::vector<std::string> fieldNames;
+    std::vector<int32_t> fieldNameIDs;
+    auto pNameAttribute = pBgeo->getPrimitiveAttributeByName("name");
+    if(pNameAttribute) {
+        pNameAttribute->getStrings(fieldNames);
+        pNameAttribute->getData(fieldNameIDs);
+    }
+
+    struct EmissionField {
+        VolumeField field;
+        int3 resolution;
+        float4x4 transform;
+        std::vector<float> voxels;
+    };
+    std::vector<EmissionField> emissionFields;
+
+    // Densities become volumes right away, emissions wait for all densities to find the one they belong to
+    for(uint32_t p_i=0; p_i < pBgeo->getPrimitiveCount(); p_i++) {
+        const auto& pPrim = pBgeo->getPrimitive(p_i);
+        if(!pPrim || pPrim->getType() != ika::bgeo::PrimType::VolumePrimType) continue;
+
+        const ika::bgeo::Volume* pVolume = pPrim->cast<ika::bgeo::Volume>();
+        const int32_t nameID = (p_i < fieldNameIDs.size()) ? fieldNameIDs[p_i] : -1;
+        const std::string fieldName = (nameID >= 0 && nameID < static_cast<int32_t>(fieldNames.size())) ? fieldNames[nameID] : std::string();
+
+        const VolumeField field = volumeField(fieldName);
+        if(field == VolumeField::Unsupported) {
+            LLOG_DBG << "Volume field " << fieldName << " is not used for rendering. Skipping primitive " << p_i << " in " << name;
+            continue;
+        }
+
+        int32_t res[3];
+        pVolume->getResolution(res);
+        const int3 resolution = {res[0], res[1], res[2]};
+
+        std::vector<float> voxels;
+        pVolume->getVoxels(voxels);
+        if(resolution.x <= 0 || resolution.y <= 0 || resolution.z <= 0 || voxels.size() != static_cast<size_t>(resolution.x) * resolution.y * resolution.z) {
+            LLOG_WRN << "Volume primitive " << p_i << " in " << name << " has inconsistent voxel data. Skipping.";
+            continue;
+        }
+
+        const float4x4 transform = volumePrimitiveTransform(*pVolume, resolution);
+
+        if(field == VolumeField::Density) {
+            auto pGrids = std::make_shared<VolumeGrids>();
+            pGrids->name = name + "_" + (fieldName.empty() ? std::string("density") : fieldName);
+            pGrids->resolution = resolution;
+            pGrids->densityVoxels = std::move(voxels);
+            volumes.push_back({pGrids, transform});
+        } else {
+            emissionFields.push_back({field, resolution, transform, std::move(voxels)});
+        }
+    }
+
+    for(auto& emission: emissionFields) {
+        auto it = std::find_if(volumes.begin(), volumes.end(), [&emission](const VolumeInstance& volume) {
+            return volume.pGrids->emissionVoxels.empty() && volume.pGrids->resolution == emission.resolution && volume.transform == emission.transform;
+        });
+
+        if(it == volumes.end()) {
+            // Emission only volume
+            auto pGrids = std::make_shared<VolumeGrids>();
+            pGrids->name = name + "_emission";
+            pGrids->resolution = emission.resolution;
+            volumes.push_back({pGrids, emission.transform});
+            it = volumes.end() - 1;
+        }
+
+        it->pGrids->emissionVoxels = std::move(emission.voxels);
+        it->pGrids->emissionMode = (emission.field == VolumeField::BlackbodyEmission) ? GridVolume::EmissionMode::Blackbody : GridVolume::EmissionMode::Direct;
+    }
+
+    LLOG_DBG << "Bgeo " << name << " has " << volumes.size() << " volumes";
+}
+
+bool SceneBuilder::createVolumeGrids(VolumeGrids& grids) {
+    if(grids.pDensityGrid || grids.pEmissionGrid) return true;
+
+    if(!grids.densityVoxels.empty()) {
+        grids.pDensityGrid = Grid::createFromDenseData(device(), grids.resolution, grids.densityVoxels.data(), "density");
+    }
+    if(!grids.emissionVoxels.empty()) {
+        const std::string gridName = (grids.emissionMode == GridVolume::EmissionMode::Blackbody) ? "temperature" : "emission";
+        grids.pEmissionGrid = Grid::createFromDenseData(device(), grids.resolution, grids.emissionVoxels.data(), gridName);
+    }
+
+    // Dense voxel data is not needed anymore
+    std::vector<float>().swap(grids.densityVoxels);
+    std::vector<float>().swap(grids.emissionVoxels);
+
+    if(!grids.pDensityGrid && !grids.pEmissionGrid) {
+        LLOG_WRN << "Volume " << grids.name << " has no active voxels. No grid volume created.";
+        return false;
+    }
+    return true;
+}
+
+uint32_t SceneBuilder::addVolumeGeometry(const std::string& filename, const std::string& densityGridName, const std::string& emissionGridName, bool blackbodyEmission) {
+    const std::string key = filename + ":" + densityGridName + ":" + emissionGridName + (blackbodyEmission ? ":blackbody" : "");
+    {
+        std::scoped_lock lock(mGeometryCacheMutex);
+        auto it = mVolumeGeometries.find(key);
+        if(it != mVolumeGeometries.end()) return it->second;
+    }
+
+    auto pGrids = std::make_shared<VolumeGrids>();
+    pGrids->name = fs::path(filename).stem().string();
+    pGrids->emissionMode = blackbodyEmission ? GridVolume::EmissionMode::Blackbody : GridVolume::EmissionMode::Direct;
+    if(!densityGridName.empty()) pGrids->pDensityGrid = Grid::createFromFile(device(), filename, densityGridName);
+    if(!emissionGridName.empty()) pGrids->pEmissionGrid = Grid::createFromFile(device(), filename, emissionGridName);
+
+    if(!pGrids->pDensityGrid && !pGrids->pEmissionGrid) {
+        LLOG_ERR << "Unable to load any grid from volume file " << filename;
+        return kInvalidGeometryID;
+    }
+
+    // VDB grids carry their own index to world transform
+    Geometry geometry;
+    geometry.volumes.push_back({pGrids, float4x4(1.f)});
+    const uint32_t geometryID = registerGeometry(std::move(geometry));
+
+    std::scoped_lock lock(mGeometryCacheMutex);
+    mVolumeGeometries[key] = geometryID;
+    return geometryID;
+}
+
+uint32_t SceneBuilder::registerGeometry(Geometry&& geometry) {
+    std::scoped_lock lock(mGeometriesMutex);
+    mGeometries.push_back(std::move(geometry));
+    return static_cast<uint32_t>(mGeometries.size() - 1);
+}
+
+const SceneBuilder::Geometry& SceneBuilder::getGeometry(uint32_t geometryID) const {
+    // deque never relocates it's elements, so reference stays valid after the lock is released
+    std::scoped_lock lock(mGeometriesMutex);
+    return mGeometries[geometryID];
+}
+
+bool SceneBuilder::addGeometryInstance(uint32_t nodeID, uint32_t geometryID, const MeshInstanceCreationSpec* creationSpec, const VolumeShadingSpec* pVolumeSpec) {
+    {
+        std::scoped_lock lock(mGeometriesMutex);
+        if (geometryID >= mGeometries.size()) {
+            LLOG_ERR << "SceneBuilder::addGeometryInstance() - geometryID " << std::to_string(geometryID) << " is out of range. No instance created !!!";
+            return false;
+        }
+    }
+
+    const Geometry& geometry = getGeometry(geometryID);
+
+    bool result = true;
+    if(geometry.meshID != kInvalidMeshID) {
+        result = addMeshInstance(nodeID, geometry.meshID, creationSpec);
+    }
+
+    // Packed primitives become child nodes of the instance node sharing their meshes (and BLASes)
+    for(size_t i = 0; i < geometry.packedInstances.size(); ++i) {
+        const auto& packedInstance = geometry.packedInstances[i];
+
+        Falcor::SceneBuilder::Node node = {};
+        node.name = "packed_" + std::to_string(i);
+        node.transform = packedInstance.transform;
+        node.meshBind = glm::mat4(1);
+        node.localToBindPose = glm::mat4(1);
+        node.parent = nodeID;
+
+        // Packed primitive material overrides the instance one
+        MeshInstanceCreationSpec packedCreationSpec = creationSpec ? *creationSpec : MeshInstanceCreationSpec();
+        if(!packedInstance.materialName.empty()) {
+            auto pMaterial = getMaterial(packedInstance.materialName);
+            if(pMaterial) {
+                packedCreationSpec.pMaterialOverride = pMaterial;
+            } else {
+                LLOG_WRN << "Unable to get packed primitive material " << packedInstance.materialName << ". Using instance material.";
+            }
+        }
+
+        const uint32_t packedNodeID = addNode(node);
+        result = addMeshInstance(packedNodeID, packedInstance.meshID, &packedCreationSpec) && result;
+    }
+
+    // Volumes share grids between instances, but every instance gets it's own grid volume
+    const VolumeShadingSpec volumeSpec = pVolumeSpec ? *pVolumeSpec : VolumeShadingSpec();
+    for(size_t i = 0; i < geometry.volumes.size(); ++i) {
+        const auto& volume = geometry.volumes[i];
+        if(!createVolumeGrids(*volume.pGrids)) continue;
+
+        Falcor::SceneBuilder::Node node = {};
+        node.name = "volume_" + std::to_string(i);
+        node.transform = volume.transform;
+        node.meshBind = glm::mat4(1);
+        node.localToBindPose = glm::mat4(1);
+        node.parent = nodeID;
+
+        auto pGridVolume = GridVolume::create(device(), volume.pGrids->name);
+        pGridVolume->setDensityGrid(volume.pGrids->pDensityGrid);
+        pGridVolume->setEmissionGrid(volume.pGrids->pEmissionGrid);
+        pGridVolume->setEmissionMode(volume.pGrids->emissionMode);
+        pGridVolume->setDensityScale(volumeSpec.densityScale);
+        pGridVolume->setEmissionScale(volumeSpec.emissionScale);
+        pGridVolume->setEmissionTemperature(volumeSpec.emissionTemperature);
+        pGridVolume->setAlbedo(volumeSpec.albedo);
+        pGridVolume->setAnisotropy(volumeSpec.anisotropy);
+
+        addGridVolume(pGridVolume, addNode(node));
+    }
+
+    return result;
+}
+
+bool SceneBuilder::addNodeTransformMotion(uint32_t nodeID, const std::vector<float4x4>& transformSamples) {
+    if (transformSamples.size() < 2) return false;
+
+    auto pAnimation = Animation::create("motion_" + std::to_string(nodeID), nodeID, 1.0);
+    for (size_t i = 0; i < transformSamples.size(); ++i) {
+        Animation::Keyframe keyframe;
+        keyframe.time = static_cast<double>(i) / static_cast<double>(transformSamples.size() - 1);
+
+        float3 skew;
+        float4 perspective;
+        if (!glm::decompose(transformSamples[i], keyframe.scaling, keyframe.rotation, keyframe.translation, skew, perspective)) {
+            LLOG_WRN << "Unable to decompose motion sample " << i << " of node " << std::to_string(nodeID) << ". Motion blur ignored.";
+            return false;
+        }
+        pAnimation->addKeyframe(keyframe);
+    }
+
+    addAnimation(pAnimation);
+    mHasTransformMotion = true;
+    return true;
+}
+
+void SceneBuilder::setNodeDontOptimize(uint32_t nodeID) {
+    assert(nodeID < mSceneGraph.size());
+    mSceneGraph[nodeID].dontOptimize = true;
+}
+
+void SceneBuilder::addTemporaryGeometry(const std::string& fullpath) {
+    mTemporaryGeometriesPaths.insert(fullpath);
+}
+
+void SceneBuilder::takeTemporaryGeometries(SceneBuilder& other) {
+    mTemporaryGeometriesPaths.merge(other.mTemporaryGeometriesPaths);
+    other.mTemporaryGeometriesPaths.clear();
+}
+
+TaskScheduler::Future<uint32_t> SceneBuilder::addGeometryAsync(lsd::scope::Geo::SharedConstPtr pGeo, const std::string& name, ika::bgeo::Bgeo::SharedPtr pBgeo) {
     assert(pGeo);
 
-    // Pass the task to thread pool to run asynchronously
-    ThreadPool& pool = ThreadPool::instance();
-    mAddGeoTasks.push_back(pool.submit([this, pGeo, &name]
+    if (!pBgeo) pBgeo = ika::bgeo::Bgeo::create();
+
+    // Pass the task to the scheduler to run asynchronously
+    mAddGeoTasks.push_back(TaskScheduler::instance().submit([this, pGeo, pBgeo, name]
     {
         uint32_t result = std::numeric_limits<uint32_t>::max();
-        ika::bgeo::Bgeo::SharedPtr pBgeo = ika::bgeo::Bgeo::create();
 
         std::string fullpath = pGeo->detailFilePath().string();
         try {
+            TRACE_SCOPE("bgeo read");
             pBgeo->readGeoFromFile(fullpath.c_str(), false); // FIXME: don't check version for now
             pBgeo->preCachePrimitives();
         } catch (const ika::bgeo::parser::ReadError& e) {
@@ -414,7 +1134,18 @@ std::shared_future<uint32_t> SceneBuilder::addGeometryAsync(lsd::scope::Geo::Sha
         }
         
         return result;
-    }));
+    }, TaskScheduler::Lane::CPU, TaskScheduler::Priority::Normal));
+
+    return mAddGeoTasks.back();
+}
+
+TaskScheduler::Future<uint32_t> SceneBuilder::addGeometryAsync(ika::bgeo::Bgeo::SharedConstPtr pBgeo, const std::string& name) {
+    assert(pBgeo);
+
+    mAddGeoTasks.push_back(TaskScheduler::instance().submit([this, pBgeo, name]
+    {
+        return this->addGeometry(pBgeo, name);
+    }, TaskScheduler::Lane::CPU, TaskScheduler::Priority::Normal));
 
     return mAddGeoTasks.back();
 }
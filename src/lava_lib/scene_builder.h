@@ -4,18 +4,23 @@
 #include "lava_dll.h"
 
 #include <map>
+#include <deque>
+#include <limits>
+#include <unordered_map>
 #include <future>
 #include <atomic>
+#include <mutex>
 
 #include "Falcor/Core/API/Device.h"
 #include "Falcor/Scene/SceneBuilder.h" 
 #include "Falcor/Scene/Material/StandardMaterial.h" 
-#include "Falcor/Utils/ThreadPool.h"
+#include "Falcor/Utils/TaskScheduler.h"
 
 #include "Falcor/Core/API/Texture.h"
 
 #include "reader_bgeo/bgeo/Bgeo.h"
 #include "reader_lsd/scope.h"
+#include "alembic_source.h"
 
 
 using namespace Falcor;
@@ -27,13 +32,70 @@ class LAVA_API SceneBuilder: public Falcor::SceneBuilder {
 		using SharedPtr = std::shared_ptr<lava::SceneBuilder>;
 		using Flags = Falcor::SceneBuilder::Flags;
 
+		static constexpr uint32_t kInvalidGeometryID = std::numeric_limits<uint32_t>::max();
+		static constexpr uint32_t kInvalidMeshID = std::numeric_limits<uint32_t>::max();
+
+		/** Grid volume parameters applied to every volume created for a geometry instance.
+		 */
+		struct VolumeShadingSpec {
+			float  densityScale = 1.f;
+			float  emissionScale = 1.f;
+			float  emissionTemperature = 0.f;	// Base temperature (K) of blackbody emission
+			float3 albedo = float3(1.f);
+			float  anisotropy = 0.f;
+		};
+
 		static SharedPtr create(Falcor::Device::SharedPtr pDevice, Flags buildFlags = Flags::Default);
 
 		Falcor::Scene::SharedPtr getScene();
 
-
+		/** Add bgeo detail. Poly primitives are converted into a single mesh, packed primitives are translated into
+		 *  instances of their (shared) embedded, disk or Alembic geometries. Volume primitives are matched by their "name" attribute
+		 *  into grid volumes: "density" (or unnamed) primitives are densities, "emission"/"heat" and "temperature" ones are
+		 *  direct and blackbody emission of a density with the same resolution and transform.
+		 *  \return Geometry id to be used with addGeometryInstance() or kInvalidGeometryID.
+		 */
 		uint32_t addGeometry(ika::bgeo::Bgeo::SharedConstPtr pBgeo, const std::string& name = "");
-		std::shared_future<uint32_t> addGeometryAsync(lsd::scope::Geo::SharedConstPtr pGeo, const std::string& name = "");
+
+		/** Load bgeo detail from disk and add it on the scheduler CPU lane. Waiting on the returned future runs the load on the
+		 *  waiting thread if no worker has picked it up yet.
+		 *  \param[in] pBgeo Optional detail to load into, so the caller can keep it. Otherwise a temporary one is used.
+		 */
+		TaskScheduler::Future<uint32_t> addGeometryAsync(lsd::scope::Geo::SharedConstPtr pGeo, const std::string& name = "", ika::bgeo::Bgeo::SharedPtr pBgeo = nullptr);
+
+		/** Add already loaded bgeo detail on the scheduler CPU lane.
+		 */
+		TaskScheduler::Future<uint32_t> addGeometryAsync(ika::bgeo::Bgeo::SharedConstPtr pBgeo, const std::string& name = "");
+
+		/** Add volume geometry made of grids loaded from an OpenVDB (.vdb) or NanoVDB (.nvdb) file. Empty emission grid name
+		 *  means no emission.
+		 *  \return Geometry id to be used with addGeometryInstance() or kInvalidGeometryID.
+		 */
+		uint32_t addVolumeGeometry(const std::string& filename, const std::string& densityGridName, const std::string& emissionGridName, bool blackbodyEmission);
+
+		/** Instance geometry at the given node. Packed primitive instances are added as child nodes, each volume becomes
+		 *  a grid volume attached to it's own child node.
+		 */
+		bool addGeometryInstance(uint32_t nodeID, uint32_t geometryID, const MeshInstanceCreationSpec* creationSpec = nullptr, const VolumeShadingSpec* pVolumeSpec = nullptr);
+
+		/** Add transform motion to the node. Samples are evenly distributed over the normalized [0, 1] shutter interval
+		 *  and turned into node animation keyframes, so scene time selects the shutter position.
+		 */
+		bool addNodeTransformMotion(uint32_t nodeID, const std::vector<float4x4>& transformSamples);
+		inline bool hasTransformMotion() const { return mHasTransformMotion; };
+
+		/** Exclude node from scene graph optimizations so it keeps it's ID and transform in the built scene.
+		 *  Needed for nodes that are going to be moved with Scene::updateNodeTransform().
+		 */
+		void setNodeDontOptimize(uint32_t nodeID);
+
+		/** Temporary geometry files are removed from filesystem when scene builder gets destroyed.
+		 */
+		void addTemporaryGeometry(const std::string& fullpath);
+
+		/** Take over temporary geometry files of another scene builder, so they outlive it.
+		 */
+		void takeTemporaryGeometries(SceneBuilder& other);
 
 		void finalize();
 
@@ -42,10 +104,86 @@ class LAVA_API SceneBuilder: public Falcor::SceneBuilder {
 	private:
 		SceneBuilder(Falcor::Device::SharedPtr pDevice, Flags buildFlags = Flags::Default);
 
+		struct PackedMeshInstance {
+			uint32_t meshID;
+			float4x4 transform;
+			std::string materialName;	// Packed primitive material or empty to inherit the instance material
+		};
+
+		/** Grids shared by all instances of a volume. Dense voxel data of bgeo volumes is kept until the first instance
+		 *  creates grids, so device resources are only created on the thread adding instances.
+		 */
+		struct VolumeGrids {
+			std::string name;
+			int3 resolution = int3(0);
+			std::vector<float> densityVoxels;
+			std::vector<float> emissionVoxels;
+			GridVolume::EmissionMode emissionMode = GridVolume::EmissionMode::Direct;
+			Grid::SharedPtr pDensityGrid;
+			Grid::SharedPtr pEmissionGrid;
+		};
+
+		struct VolumeInstance {
+			std::shared_ptr<VolumeGrids> pGrids;
+			float4x4 transform;		// Grids index space to geometry space
+		};
+
+		struct Geometry {
+			uint32_t meshID = kInvalidMeshID;					// Mesh made of poly primitives
+			std::vector<PackedMeshInstance> packedInstances;	// Flattened packed primitives
+			std::vector<VolumeInstance> volumes;				// Flattened volume primitives
+		};
+
+		/** Geometry content cache entry. Identical geometries (same topology and attributes) loaded under different
+		 *  names resolve to the single geometry and become it's instances.
+		 */
+		struct GeometryCacheEntry {
+			std::shared_future<uint32_t> geometryID;
+			size_t byteSize = 0;	// Size of mesh vertex and index data. Written before geometryID becomes ready.
+			uint64_t secondaryHash = 0;	// Independent content hash checked on cache hits
+			uint64_t hashedLength = 0;	// Number of content bytes hashed
+		};
+
+		/** Geometry made of Alembic object mesh sample. Shared by all references to the same object at the same time.
+		 */
+		struct AlembicGeometry {
+			uint32_t geometryID = kInvalidGeometryID;
+			float4x4 transform = float4x4(1.f);		// Object to archive space transform at the sample time
+		};
+
+		struct BgeoMeshData {
+			std::vector<float> P, N, UV, vN, vUV;
+			bool hasPerPrimitiveMaterial = false;
+			std::vector<std::string> perPrimitiveMaterialNames;
+			std::vector<int32_t> perPrimitiveMaterialIDs;
+		};
+
+		uint32_t addPolyMesh(ika::bgeo::Bgeo::SharedConstPtr pBgeo, const std::string& name, const BgeoMeshData& data, size_t& byteSize);
+		uint32_t addPackedDiskGeometry(const std::string& filename);
+		AlembicGeometry addAlembicGeometry(const std::string& filename, const std::string& objectPath, double time);
+		void addBgeoVolumes(ika::bgeo::Bgeo::SharedConstPtr pBgeo, const std::string& name, std::vector<VolumeInstance>& volumes);
+		bool createVolumeGrids(VolumeGrids& grids);
+		uint32_t registerGeometry(Geometry&& geometry);
+		const Geometry& getGeometry(uint32_t geometryID) const;
+
 	private:
 		StandardMaterial::SharedPtr mpDefaultMaterial = nullptr;
 
 		std::atomic<uint32_t> mUniqueTrianglesCount = 0;
+		bool mHasTransformMotion = false;
+		std::atomic<uint32_t> mDeduplicatedGeometriesCount = 0;
+		std::atomic<size_t>   mDeduplicatedBytesCount = 0;
+
+		std::mutex mGeometryCacheMutex;
+		std::unordered_map<uint64_t, std::shared_ptr<GeometryCacheEntry>> mGeometryCache; // geometry content hash to geometry id
+		std::unordered_map<std::string, std::shared_future<uint32_t>> mPackedDiskGeometries; // packed disk primitive file path to geometry id
+		std::unordered_map<std::string, uint32_t> mVolumeGeometries; // volume file path and grid names to geometry id
+		std::unordered_map<std::string, std::shared_future<AlembicGeometry>> mAlembicGeometries; // archive path, object path and time to geometry
+
+		AlembicSource::SharedPtr mpAlembicSource;
+
+		mutable std::mutex mGeometriesMutex;
+		std::deque<Geometry> mGeometries;
 
 		std::set<std::string> mTemporaryGeometriesPaths;
 };
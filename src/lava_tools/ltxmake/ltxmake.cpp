@@ -124,7 +124,7 @@ int main(int argc, char** argv){
     lava::ut::log::init_log();
     if(logFilename != "") lava::ut::log::init_file_log(logFilename);
     
-    boost::log::core::get()->set_filter(  boost::log::trivial::severity >= logSeverity );
+    lava::ut::log::set_severity_threshold(logSeverity);
 
     /** --help option 
      */ 
@@ -235,7 +235,7 @@ int main(int argc, char** argv){
     // Set up logging 
     lava::ut::log::init_log();
     if(logFilename != "") lava::ut::log::init_file_log(logFilename);
-    boost::log::core::get()->set_filter(  boost::log::trivial::severity >= logSeverity );
+    lava::ut::log::set_severity_threshold(logSeverity);
 
     /** --help option 
      */ 
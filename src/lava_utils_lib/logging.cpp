@@ -1,6 +1,14 @@
 #include <fstream>
 #include <ostream>
 #include <iomanip>
+#include <array>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <condition_variable>
 
 #include <boost/filesystem.hpp>
 #include <boost/log/sources/severity_logger.hpp>
@@ -8,6 +16,8 @@
 #include <boost/log/expressions/attr_fwd.hpp>
 #include <boost/log/expressions/attr.hpp>
 #include <boost/log/expressions/formatters/date_time.hpp>
+#include <boost/log/attributes/attribute_value_impl.hpp>
+#include <boost/date_time/c_local_time_adjustor.hpp>
 
 // Supporting headers
 #include <boost/log/support/date_time.hpp>
@@ -26,6 +36,213 @@ BOOST_LOG_ATTRIBUTE_KEYWORD(line_id,    "LineID",       unsigned int)
 BOOST_LOG_ATTRIBUTE_KEYWORD(timestamp,  "TimeStamp",    boost::posix_time::ptime)
 BOOST_LOG_ATTRIBUTE_KEYWORD(severity,   "Severity",     boost::log::trivial::severity_level)
 
+std::atomic<int> g_severity_threshold(boost::log::trivial::trace);
+
+namespace {
+
+struct log_entry {
+    boost::log::trivial::severity_level level;
+    uint64_t sequence;                                  // global statement order
+    std::chrono::system_clock::time_point time;
+    const char* function;
+    std::string message;
+};
+
+// Single producer (owning thread) single consumer (writer) ring of queued statements
+struct thread_ring {
+    static constexpr size_t kCapacity = 1024;
+
+    std::array<log_entry, kCapacity> entries;
+    std::atomic<size_t> head{0};    // next entry to write
+    std::atomic<size_t> tail{0};    // next entry to read
+    std::atomic<bool> retired{false};
+
+    bool push(log_entry& entry) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == kCapacity) return false;
+        entries[h % kCapacity] = std::move(entry);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    void pop_all(std::vector<log_entry>& out) {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        const size_t h = head.load(std::memory_order_acquire);
+        for (size_t i = t; i < h; i++) out.push_back(std::move(entries[i % kCapacity]));
+        tail.store(h, std::memory_order_release);
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+};
+
+boost::posix_time::ptime to_local_time(std::chrono::system_clock::time_point time) {
+    const int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+    const boost::posix_time::ptime utc = boost::posix_time::from_time_t(static_cast<std::time_t>(us / 1000000)) + boost::posix_time::microseconds(us % 1000000);
+    return boost::date_time::c_local_adjustor<boost::posix_time::ptime>::utc_to_local(utc);
+}
+
+// Background writer draining thread rings into boost::log core
+class async_writer {
+    public:
+        static async_writer& instance() {
+            static async_writer writer;
+            return writer;
+        }
+
+        std::shared_ptr<thread_ring> register_thread() {
+            auto pRing = std::make_shared<thread_ring>();
+            std::scoped_lock lock(mRingsMutex);
+            mRings.push_back(pRing);
+            return pRing;
+        }
+
+        void submit(thread_ring& ring, log_entry& entry) {
+            // Full ring is drained right on the calling thread, so no statement is ever dropped
+            while (!ring.push(entry)) drain();
+
+            if (entry.level >= boost::log::trivial::fatal || mStopped.load(std::memory_order_acquire)) {
+                drain();
+                boost::log::core::get()->flush();
+            } else if (entry.level >= boost::log::trivial::warning) {
+                wake();
+            }
+        }
+
+        void drain() {
+            std::scoped_lock drainLock(mDrainMutex);
+
+            mBatch.clear();
+            {
+                std::scoped_lock lock(mRingsMutex);
+                for (auto& pRing : mRings) pRing->pop_all(mBatch);
+                mRings.erase(std::remove_if(mRings.begin(), mRings.end(), [](const auto& pRing) {
+                    return pRing->retired.load(std::memory_order_acquire) && pRing->empty();
+                }), mRings.end());
+            }
+
+            // Each ring is ordered already, merge them back into statement order
+            std::sort(mBatch.begin(), mBatch.end(), [](const log_entry& a, const log_entry& b) { return a.sequence < b.sequence; });
+
+            auto& logger = global_logger::get();
+            for (auto& entry : mBatch) {
+                boost::log::record rec = logger.open_record(boost::log::keywords::severity = entry.level);
+                if (!rec) continue;
+
+                rec.attribute_values().insert("TimeStamp", boost::log::attributes::make_attribute_value(to_local_time(entry.time)));
+                if (entry.function) rec.attribute_values().insert("Function", boost::log::attributes::make_attribute_value(std::string(entry.function)));
+
+                boost::log::record_ostream strm(rec);
+                strm << entry.message;
+                strm.flush();
+                logger.push_record(std::move(rec));
+            }
+            mBatch.clear();
+        }
+
+        // Write remaining statements and stop the writer. Statements issued afterwards are written synchronously
+        void stop() {
+            if (mStopped.exchange(true)) return;
+            wake();
+            if (mThread.joinable()) mThread.join();
+            drain();
+        }
+
+        uint64_t next_sequence() { return mSequence.fetch_add(1, std::memory_order_relaxed); }
+
+    private:
+        async_writer() {
+            // Make sure boost::log singletons outlive the writer
+            boost::log::core::get();
+            global_logger::get();
+            mThread = std::thread([this] { run(); });
+        }
+
+        ~async_writer() { stop(); }
+
+        void wake() {
+            {
+                std::scoped_lock lock(mWakeMutex);
+                mWakeRequested = true;
+            }
+            mWakeCondition.notify_one();
+        }
+
+        void run() {
+            while (!mStopped.load(std::memory_order_acquire)) {
+                {
+                    std::unique_lock lock(mWakeMutex);
+                    mWakeCondition.wait_for(lock, std::chrono::milliseconds(5), [this] { return mWakeRequested || mStopped.load(std::memory_order_acquire); });
+                    mWakeRequested = false;
+                }
+                drain();
+            }
+        }
+
+    private:
+        std::mutex mRingsMutex;
+        std::vector<std::shared_ptr<thread_ring>> mRings;
+
+        std::mutex mDrainMutex;
+        std::vector<log_entry> mBatch;
+
+        std::mutex mWakeMutex;
+        std::condition_variable mWakeCondition;
+        bool mWakeRequested = false;
+
+        std::atomic<bool> mStopped{false};
+        std::atomic<uint64_t> mSequence{0};
+        std::thread mThread;
+};
+
+// Per thread ring and formatting streams. Streams are reused, nested statements (logging from within operator<<) get their own
+struct thread_state {
+    std::shared_ptr<thread_ring> pRing;
+    std::vector<std::unique_ptr<std::ostringstream>> streams;
+    size_t depth = 0;
+
+    ~thread_state() {
+        if (pRing) pRing->retired.store(true, std::memory_order_release);
+    }
+};
+
+thread_local thread_state t_state;
+
+}  // namespace
+
+record_stream::record_stream(boost::log::trivial::severity_level level, const char* function): mLevel(level), mFunction(function) {
+    if (t_state.streams.size() <= t_state.depth) t_state.streams.push_back(std::make_unique<std::ostringstream>());
+    mpStream = t_state.streams[t_state.depth++].get();
+
+    // Reused stream starts as a fresh one
+    mpStream->str(std::string());
+    mpStream->clear();
+    mpStream->flags(std::ios_base::skipws | std::ios_base::dec);
+    mpStream->precision(6);
+    mpStream->width(0);
+    mpStream->fill(' ');
+}
+
+record_stream::~record_stream() {
+    auto& writer = async_writer::instance();
+    log_entry entry { mLevel, writer.next_sequence(), std::chrono::system_clock::now(), mFunction, mpStream->str() };
+    t_state.depth--;
+
+    if (!t_state.pRing) t_state.pRing = writer.register_thread();
+    writer.submit(*t_state.pRing, entry);
+}
+
+void set_severity_threshold(boost::log::trivial::severity_level level) {
+    g_severity_threshold.store(level, std::memory_order_relaxed);
+    boost::log::core::get()->set_filter(boost::log::trivial::severity >= level);
+}
+
+void flush_log() {
+    async_writer::instance().drain();
+    boost::log::core::get()->flush();
+}
+
 static void init_log_common() {
     if (g_logger_initialized) return;
     g_log_stop_functions.clear();
@@ -102,6 +319,9 @@ void init_log() {
 void shutdown_log() {
     if (g_logger_shutted_down) return;
 
+    // Queued statements go to sinks before they are stopped
+    async_writer::instance().stop();
+
     if (g_log_stop_functions.size() > 0) {
         for (auto& stop : g_log_stop_functions) {
             stop();
@@ -6,6 +6,8 @@
 #include <fstream>
 #include <cstring>
 #include <string>
+#include <atomic>
+#include <sstream>
 
 #include <boost/log/core.hpp>
 #include <boost/log/trivial.hpp>
@@ -25,26 +27,34 @@
 
 #define USE_ASYNCRONOUS_CONSOLE_SINK 1
 
-// Logging macro or static inline to stay within namespace boundaries
+// Logging macros. Statements are formatted on the calling thread and queued to a lock-free per thread ring buffer
+// that is drained to boost::log sinks by a background writer. Statements below LAVA_LOG_MIN_SEVERITY compile to nothing
+// and statements below runtime threshold (see set_severity_threshold) cost a single branch.
 
+#ifndef LAVA_LOG_MIN_SEVERITY
 #ifdef _DEPLOY_BUILD
-#define LLOG_TRC if (false) BOOST_LOG_SEV(lava::ut::log::global_logger::get(), boost::log::trivial::trace)
+#define LAVA_LOG_MIN_SEVERITY 1 // boost::log::trivial::debug
 #else
-#define LLOG_TRC BOOST_LOG_SEV(lava::ut::log::global_logger::get(), boost::log::trivial::trace)
+#define LAVA_LOG_MIN_SEVERITY 0 // boost::log::trivial::trace
 #endif
+#endif
+
+#define LLOG_SEV(level, function) \
+    if (!lava::ut::log::is_enabled(level)) {} else lava::ut::log::record_stream(level, function).stream()
 
-#define LLOG_DBG BOOST_LOG_SEV(lava::ut::log::global_logger::get(), boost::log::trivial::debug)
-#define LLOG_INF BOOST_LOG_SEV(lava::ut::log::global_logger::get(), boost::log::trivial::info)
-#define LLOG_WRN BOOST_LOG_SEV(lava::ut::log::global_logger::get(), boost::log::trivial::warning)
-#define LLOG_ERR BOOST_LOG_SEV(lava::ut::log::global_logger::get(), boost::log::trivial::error)
-#define LLOG_FTL BOOST_LOG_SEV(lava::ut::log::global_logger::get(), boost::log::trivial::fatal)
+#define LLOG_TRC LLOG_SEV(boost::log::trivial::trace, nullptr)
+#define LLOG_DBG LLOG_SEV(boost::log::trivial::debug, nullptr)
+#define LLOG_INF LLOG_SEV(boost::log::trivial::info, nullptr)
+#define LLOG_WRN LLOG_SEV(boost::log::trivial::warning, nullptr)
+#define LLOG_ERR LLOG_SEV(boost::log::trivial::error, nullptr)
+#define LLOG_FTL LLOG_SEV(boost::log::trivial::fatal, nullptr)
 
-#define LLOG_FN_DBG LLOG_DBG << boost::log::add_value("Function", __FUNCTION__)
-#define LLOG_FN_INF LLOG_INF << boost::log::add_value("Function", __FUNCTION__)
-#define LLOG_FN_WRN LLOG_WRN << boost::log::add_value("Function", __FUNCTION__)
-#define LLOG_FN_ERR LLOG_ERR << boost::log::add_value("Function", __FUNCTION__)
-#define LLOG_FN_FTL LLOG_FTL << boost::log::add_value("Function", __FUNCTION__)
-#define LLOG_FN_TRC LLOG_TRC << boost::log::add_value("Function", __FUNCTION__)
+#define LLOG_FN_DBG LLOG_SEV(boost::log::trivial::debug, __FUNCTION__)
+#define LLOG_FN_INF LLOG_SEV(boost::log::trivial::info, __FUNCTION__)
+#define LLOG_FN_WRN LLOG_SEV(boost::log::trivial::warning, __FUNCTION__)
+#define LLOG_FN_ERR LLOG_SEV(boost::log::trivial::error, __FUNCTION__)
+#define LLOG_FN_FTL LLOG_SEV(boost::log::trivial::fatal, __FUNCTION__)
+#define LLOG_FN_TRC LLOG_SEV(boost::log::trivial::trace, __FUNCTION__)
 
 namespace lava { 
 
@@ -66,18 +76,47 @@ typedef boost::log::sinks::asynchronous_sink<boost::log::sinks::text_ostream_bac
 BOOST_LOG_INLINE_GLOBAL_LOGGER_INIT(global_logger, global_logger_type) {
 	global_logger_type logger = global_logger_type(boost::log::keywords::channel = "global_logger");
 
-	// add attributes
+	// add attributes. TimeStamp is added to each record by the writer as the time statement was issued
     logger.add_attribute("LineID", boost::log::attributes::counter<unsigned int>(1));     // lines are sequentially numbered
-    logger.add_attribute("TimeStamp", boost::log::attributes::local_clock());             // each log line gets a timestamp
 
     return logger;
 }
 
+// Runtime severity threshold. Use set_severity_threshold() to change it
+extern std::atomic<int> g_severity_threshold;
+
+static inline bool is_enabled(boost::log::trivial::severity_level level) {
+    return level >= LAVA_LOG_MIN_SEVERITY && level >= g_severity_threshold.load(std::memory_order_relaxed);
+}
+
+// Single log statement. Message is formatted into thread local stream and queued when the statement ends
+class record_stream {
+    public:
+        record_stream(boost::log::trivial::severity_level level, const char* function);
+        ~record_stream();
+
+        record_stream(const record_stream&) = delete;
+        record_stream& operator=(const record_stream&) = delete;
+
+        std::ostream& stream() { return *mpStream; }
+
+    private:
+        boost::log::trivial::severity_level mLevel;
+        const char* mFunction;
+        std::ostringstream* mpStream;
+};
+
 // Initialize/add file logger sink
 void init_log();
 void init_file_log(const std::string& logfilename, bool autoFlush = false);
 void shutdown_log();
 
+// Statements below the threshold are skipped at runtime. Also sets boost::log core filter, so use it instead of set_filter()
+void set_severity_threshold(boost::log::trivial::severity_level level);
+
+// Write all queued statements to sinks
+void flush_log();
+
 }}} // namespace lava::ut::log
 
 #endif // LAVA_UTILS_LOGGING_H_
\ No newline at end of file